@@ -13,27 +13,286 @@ void helpMessages() {
 
 	//printf();
 	printf("-p: <mode>		Processing mode, options listed below (default: 0)\n");
+	printf("-e: <file>		File of events to extract, one '<timeStr>[.fraction] <numSec>' pair per line, written to separate outputs using [[iter]] as the event number (default: '')\n");
+	printf("-K: <file>		Checkpoint file used to record and resume progress (default: '')\n");
+	printf("-k: <iters>		Write a checkpoint to -K every N iterations (default: infinite, never checkpoint)\n");
+	printf("-R:		        Resume from the checkpoint at -K, continuing the existing output files (default: False)\n");
+	printf("-D:		        Process directly into the blocks of PSRDADA outputs, rather than copying the output into them (default: False)\n");
+	printf("-A:		        Write outputs from a background thread while the next iteration is processed (default: False)\n");
 
 
 	processingModes();
 
 }
 
-static void CLICleanup(lofar_udp_config *config, lofar_udp_io_write_config *outConfig, int8_t *headerBuffer) {
-	FREE_NOT_NULL(config);
+/**
+ * @brief      Point each of the reader's outputs at the next block of their output ringbuffer (direct writes), or the next
+ * 				free buffer of the background writer, so the next step is processed straight into it
+ *
+ * @param      reader       The reader
+ * @param      outConfig    The output configuration
+ * @param[in]  directWrite  Use the output's ringbuffer blocks rather than the background writer's buffers
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t CLIRedirectOutputs(lofar_udp_reader *reader, lofar_udp_io_write_config *outConfig, int8_t directWrite) {
+	for (int8_t out = 0; out < reader->meta->numOutputs; out++) {
+		int8_t *block = NULL;
+		if (directWrite) {
+			if (lofar_udp_io_write_acquire(outConfig, out, &block, reader->meta->packetsPerIteration * reader->meta->packetOutputLength[out]) < 0) {
+				return -1;
+			}
+		} else if ((block = lofar_udp_io_write_async_buffer(outConfig, out)) == NULL) {
+			return -1;
+		}
+
+		if (lofar_udp_reader_output_redirect(reader, out, block) < 0) {
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+static void CLICleanup(lofar_udp_config *config, lofar_udp_io_write_config *outConfig, int8_t *headerBuffer, lofar_udp_checkpoint *checkpoint, lofar_udp_shard *shard) {
+	lofar_udp_checkpoint_free_arrays(checkpoint);
+	lofar_udp_shard_free_outputs(shard);
+	lofar_udp_config_cleanup(config);
+	if (outConfig != NULL) {
+		_lofar_udp_io_write_free_outputs(outConfig);
+	}
 	FREE_NOT_NULL(outConfig);
 	FREE_NOT_NULL(headerBuffer);
 }
 
 
+// State shared with the event callback when extracting events
+typedef struct extractor_events {
+	lofar_udp_io_write_config *outConfig;
+	lofar_udp_io_write_config **eventOutputs;
+	int8_t *headerBuffer;
+	int64_t packetsWritten;
+} extractor_events;
+
+/**
+ * @brief Parse an events file into an array of packet windows
+ *
+ * @param eventsFile Path to a file containing '<ISOT start time> <duration (seconds)>' pairs, one per line, '#' comments are ignored
+ * @param clock200MHz Clock bit used to convert times to packet numbers
+ * @param[out] events Allocated array of events, must be freed by the caller
+ *
+ * @return >0: Number of events, <=0: Failure
+ */
+static int64_t parseEventsFile(const char eventsFile[], const int8_t clock200MHz, lofar_udp_event **events) {
+	FILE *eventsRef = fopen(eventsFile, "r");
+	if (eventsRef == NULL) {
+		fprintf(stderr, "ERROR: Failed to open events file '%s' (errno %d: %s), exiting.\n", eventsFile, errno, strerror(errno));
+		return -1;
+	}
+
+	char line[2 * DEF_STR_LEN], eventTime[256];
+	double duration;
+	int64_t numEvents = 0, allocatedEvents = 0, lineNum = 0;
+	*events = NULL;
+	while (fgets(line, sizeof(line) / sizeof(line[0]), eventsRef) != NULL) {
+		lineNum++;
+		const char *lineStart = line + strspn(line, " \t");
+		if (*lineStart == '#' || *lineStart == '\n' || *lineStart == '\0') {
+			continue;
+		}
+
+		if (sscanf(lineStart, "%255s %lf", eventTime, &duration) != 2 || duration <= 0) {
+			fprintf(stderr, "ERROR: Failed to parse line %ld of events file '%s' (%s), exiting.\n", lineNum, eventsFile, lineStart);
+			numEvents = -1;
+			break;
+		}
+
+		if (numEvents == allocatedEvents) {
+			allocatedEvents = allocatedEvents ? 2 * allocatedEvents : 16;
+			lofar_udp_event *tmpEvents = realloc(*events, allocatedEvents * sizeof(lofar_udp_event));
+			if (tmpEvents == NULL) {
+				fprintf(stderr, "ERROR: Failed to allocate memory for events, exiting.\n");
+				numEvents = -1;
+				break;
+			}
+			*events = tmpEvents;
+		}
+
+		// Fractional seconds are not parsed by the library, handle them separately
+		double fractionalSeconds = 0.0;
+		char *fraction = strchr(eventTime, '.');
+		if (fraction != NULL) {
+			fractionalSeconds = strtod(fraction, NULL);
+			*fraction = '\0';
+		}
+		(*events)[numEvents].startingPacket = lofar_udp_time_get_packet_from_isot(eventTime, clock200MHz);
+		if ((*events)[numEvents].startingPacket >= 0) {
+			(*events)[numEvents].startingPacket += lofar_udp_time_get_packets_from_seconds(fractionalSeconds, clock200MHz);
+		}
+		(*events)[numEvents].packetsReadMax = lofar_udp_time_get_packets_from_seconds(duration, clock200MHz);
+		if ((*events)[numEvents].startingPacket < 0 || (*events)[numEvents].packetsReadMax < 1) {
+			fprintf(stderr, "ERROR: Failed to convert event on line %ld of events file '%s' (%s, %lf), exiting.\n", lineNum, eventsFile, eventTime, duration);
+			numEvents = -1;
+			break;
+		}
+		numEvents++;
+	}
+	fclose(eventsRef);
+
+	if (numEvents == 0) {
+		fprintf(stderr, "ERROR: No events found in events file '%s', exiting.\n", eventsFile);
+	}
+	if (numEvents < 1) {
+		FREE_NOT_NULL(*events);
+	}
+	return numEvents;
+}
+
+/**
+ * @brief Write a slice of an event to its outputs, opening them on the first slice and closing them after the last
+ *
+ * @param reader The reader, holding the processed gulp
+ * @param slice The packets of the gulp belonging to the event
+ * @param userData An extractor_events struct
+ *
+ * @return 0: Success, <0: Failure
+ */
+static int32_t writeEventSlice(lofar_udp_reader *reader, const lofar_udp_event_slice *slice, void *userData) {
+	extractor_events *state = (extractor_events *) userData;
+
+	if (slice->firstSlice) {
+		lofar_udp_io_write_config *eventOutput = lofar_udp_io_write_alloc_copy(state->outConfig);
+		if (eventOutput == NULL) {
+			return -1;
+		}
+		for (int8_t out = 0; out < reader->meta->numOutputs; out++) {
+			eventOutput->writeBufSize[out] = reader->meta->packetsPerIteration * reader->meta->packetOutputLength[out];
+		}
+
+		int64_t outputLength[1] = { LONG_MIN };
+		state->eventOutputs[slice->eventIdx] = eventOutput;
+		if (lofar_udp_io_write_setup_helper(eventOutput, outputLength, reader->meta->numOutputs, (int32_t) slice->eventIdx, slice->packetNumber) < 0) {
+			fprintf(stderr, "ERROR: Failed to open outputs for event %ld (errno %d: %s), exiting.\n", slice->eventIdx, errno, strerror(errno));
+			return -1;
+		}
+	}
+
+	lofar_udp_io_write_config *eventOutput = state->eventOutputs[slice->eventIdx];
+	if (slice->numPackets > 0) {
+		for (int8_t out = 0; out < reader->meta->numOutputs; out++) {
+			if (lofar_udp_metadata_write_file(reader, eventOutput, out, reader->metadata, state->headerBuffer, 4096 * 8, slice->firstSlice) < 0) {
+				fprintf(stderr, "ERROR: Failed to write header to output %d of event %ld (errno %d: %s), exiting.\n", out, slice->eventIdx, errno, strerror(errno));
+				return -1;
+			}
+
+			const int64_t outputLength = slice->numPackets * reader->meta->packetOutputLength[out];
+			const int64_t outputWritten = lofar_udp_io_write(eventOutput, out, &(reader->meta->outputData[out][slice->outputPacketOffset * reader->meta->packetOutputLength[out]]), outputLength);
+			if (outputWritten != outputLength) {
+				fprintf(stderr, "ERROR: Failed to write data to output %d of event %ld (%ld bytes/%ld bytes written, errno %d: %s), exiting.\n", out, slice->eventIdx, outputWritten, outputLength, errno, strerror(errno));
+				return -1;
+			}
+		}
+		state->packetsWritten += slice->numPackets;
+	}
+
+	if (slice->lastSlice) {
+		lofar_udp_io_write_cleanup(eventOutput, 1);
+		state->eventOutputs[slice->eventIdx] = NULL;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Extract every event in an events file from the input in a single pass
+ *
+ * @param config Reader configuration
+ * @param outConfig Output configuration, used as a template for each event's outputs
+ * @param headerBuffer Metadata header buffer
+ * @param eventsFile Events file location
+ * @param clock200MHz Clock bit
+ * @param silent Silent mode flag
+ *
+ * @return 0: Success, 1: Failure
+ */
+static int32_t extractEvents(lofar_udp_config *config, lofar_udp_io_write_config *outConfig, int8_t *headerBuffer, const char eventsFile[], const int8_t clock200MHz, const int8_t silent) {
+	lofar_udp_event *events = NULL;
+	const int64_t numEvents = parseEventsFile(eventsFile, clock200MHz, &events);
+	if (numEvents < 1) {
+		return 1;
+	}
+
+	extractor_events state = {
+		.outConfig = outConfig,
+		.eventOutputs = calloc(numEvents, sizeof(lofar_udp_io_write_config *)),
+		.headerBuffer = headerBuffer,
+		.packetsWritten = 0
+	};
+	if (state.eventOutputs == NULL) {
+		fprintf(stderr, "ERROR: Failed to allocate memory for event outputs, exiting.\n");
+		free(events);
+		return 1;
+	}
+
+	// Start the reader at the earliest event, the library handles seeking between the remaining events
+	config->startingPacket = events[0].startingPacket;
+	for (int64_t event = 1; event < numEvents; event++) {
+		if (events[event].startingPacket < config->startingPacket) {
+			config->startingPacket = events[event].startingPacket;
+		}
+	}
+	config->packetsReadMax = LONG_MAX;
+
+	if (silent == 0) { printf("Extracting %ld events from %s...\n", numEvents, eventsFile); }
+
+	struct timespec tick, tock;
+	CLICK(tick);
+	int32_t returnVal = 0;
+	int64_t eventsProcessed = -1;
+	lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+	if (reader == NULL) {
+		fprintf(stderr, "Failed to generate reader. Exiting.\n");
+		returnVal = 1;
+	} else if (((lofar_source_bytes *) &(reader->meta->inputData[0][1]))->clockBit != (uint32_t) clock200MHz) {
+		fprintf(stderr, "ERROR: The clock bit of the first packet does not match the clock state given when starting the CLI. Add or remove -c from your command. Exiting.\n");
+		returnVal = 1;
+	} else if ((eventsProcessed = lofar_udp_reader_events_process(reader, events, numEvents, writeEventSlice, &state)) < 0) {
+		fprintf(stderr, "ERROR: Failed to extract events (%ld), exiting.\n", eventsProcessed);
+		returnVal = 1;
+	}
+	CLICK(tock);
+
+	if (silent == 0 && eventsProcessed >= 0) {
+		printf("Extracted %ld/%ld events (%ld packets) in %f seconds.\n", eventsProcessed, numEvents, state.packetsWritten, TICKTOCK(tick, tock));
+	}
+
+	// Close any outputs left open by a failure
+	for (int64_t event = 0; event < numEvents; event++) {
+		if (state.eventOutputs[event] != NULL) {
+			lofar_udp_io_write_cleanup(state.eventOutputs[event], 1);
+		}
+	}
+	if (reader != NULL) {
+		lofar_udp_reader_cleanup(reader);
+	}
+	free(state.eventOutputs);
+	free(events);
+
+	return returnVal;
+}
+
+
 int main(int argc, char *argv[]) {
 
 	// Set up input local variables
 	int32_t inputOpt, input = 0;
 	float seconds = 0.0f;
-	char inputTime[256] = "", stringBuff[128] = "", inputFormat[DEF_STR_LEN] = "";
-	int8_t silent = 0, inputProvided = 0, outputProvided = 0;
-	int64_t maxPackets = LONG_MAX, startingPacket = -1, splitEvery = LONG_MAX;
+	char inputTime[256] = "", stringBuff[128] = "", inputFormat[DEF_STR_LEN] = "", eventsFile[DEF_STR_LEN] = "", checkpointFile[DEF_STR_LEN] = "";
+	int8_t silent = 0, inputProvided = 0, outputProvided = 0, autoTune = 0, resume = 0, directWrite = 0, asyncWrite = 0;
+	int64_t maxPackets = LONG_MAX, startingPacket = -1, splitEvery = LONG_MAX, checkpointEvery = LONG_MAX;
+	lofar_udp_checkpoint resumeCheckpoint = lofar_udp_checkpoint_default;
+	int32_t shardIdx = -1, numShards = 0;
+	lofar_udp_shard shard = lofar_udp_shard_default;
 	int8_t clock200MHz = 1;
 
 	lofar_udp_config *config = lofar_udp_config_alloc();
@@ -42,7 +301,7 @@ int main(int argc, char *argv[]) {
 
 	if (config == NULL || outConfig == NULL) {
 		fprintf(stderr, "ERROR: Failed to allocate memory for configuration structs (something has gone very wrong...), exiting.\n");
-		FREE_NOT_NULL(config); FREE_NOT_NULL(outConfig);
+		CLICleanup(config, outConfig, NULL, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
@@ -53,14 +312,20 @@ int main(int argc, char *argv[]) {
 
 	// Timing variables
 	double timing[TIMEARRLEN] = { 0. }, totalReadTime = 0., totalOpsTime = 0., totalWriteTime = 0., totalMetadataTime = 0.;
+	// Outputs are indexed with int8_t, so INT8_MAX entries cover any writer
+	double outputTiming[INT8_MAX] = { 0. };
 	struct timespec tick, tick0, tick1, tock, tock0, tock1;
 
+	// Data for the outputs written in parallel once their headers are out
+	int8_t *writeData[INT8_MAX] = { NULL };
+	int64_t writeLength[INT8_MAX] = { 0 };
+
 	// strtol / option checks
 	char *endPtr;
 	int8_t flagged = 0;
 
 	// Standard ugly input flags parser
-	while ((inputOpt = getopt(argc, argv, "hzrqfvVi:o:m:M:I:u:t:s:S:e:p:a:n:b:ck:T:")) != -1) {
+	while ((inputOpt = getopt(argc, argv, "hzrqfvVRDAi:o:m:M:I:u:t:s:S:e:p:a:n:b:ck:K:T:X:F:Z:Y:")) != -1) {
 		input = 1;
 		switch (inputOpt) {
 
@@ -73,7 +338,7 @@ int main(int argc, char *argv[]) {
 			case 'o':
 				if (lofar_udp_io_write_parse_optarg(outConfig, optarg) < 0) {
 					helpMessages();
-					CLICleanup(config, outConfig, headerBuffer);
+					CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 					return 1;
 				}
 				// If the metadata is not yet set, see if we can parse a requested type from the output filename
@@ -82,6 +347,10 @@ int main(int argc, char *argv[]) {
 				break;
 
 			case 'm':
+				if (strcmp(optarg, "auto") == 0) {
+					autoTune = 1;
+					break;
+				}
 				config->packetsPerIteration = strtol(optarg, &endPtr, 10);
 				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
 				break;
@@ -93,7 +362,7 @@ int main(int argc, char *argv[]) {
 			case 'I':
 				if (strncpy(config->metadata_config.metadataLocation, optarg, DEF_STR_LEN) != config->metadata_config.metadataLocation) {
 					fprintf(stderr, "ERROR: Failed to copy metadata file location to config, exiting.\n");
-					CLICleanup(config, outConfig, headerBuffer);
+					CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 					return 1;
 				}
 				break;
@@ -117,6 +386,38 @@ int main(int argc, char *argv[]) {
 				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
 				break;
 
+			case 'e':
+				strncpy(eventsFile, optarg, DEF_STR_LEN - 1);
+				break;
+
+			case 'k':
+				checkpointEvery = internal_strtoi(optarg, &endPtr);
+				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
+				break;
+
+			case 'K':
+				strncpy(checkpointFile, optarg, DEF_STR_LEN - 1);
+				break;
+
+			case 'R':
+				resume = 1;
+				break;
+
+			case 'D':
+				directWrite = 1;
+				break;
+
+			case 'A':
+				asyncWrite = 1;
+				break;
+
+			case 'X':
+				if (sscanf(optarg, "%d,%d", &shardIdx, &numShards) != 2) {
+					fprintf(stderr, "ERROR: Failed to parse shard (%s), expected <k>,<N>.\n", optarg);
+					flagged = 1;
+				}
+				break;
+
 			case 'p':
 				config->processingMode = internal_strtoi(optarg, &endPtr);
 				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
@@ -159,6 +460,19 @@ int main(int argc, char *argv[]) {
 				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
 				break;
 
+			case 'F':
+				config->followTimeout = strtof(optarg, &endPtr);
+				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
+				break;
+
+			case 'Z':
+				if (parseAdaptiveCompression(outConfig, optarg)) { flagged = 1; }
+				break;
+
+			case 'Y':
+				if (parseCompressionFilter(outConfig, optarg)) { flagged = 1; }
+				break;
+
 
 
 				// Silence GCC warnings, fall-through is the desired behaviour
@@ -169,7 +483,7 @@ int main(int argc, char *argv[]) {
 			case '?':
 				if ((optopt == 'i') || (optopt == 'o') || (optopt == 'm') || (optopt == 'u') || (optopt == 't') ||
 					(optopt == 's') || (optopt == 'e') || (optopt == 'p') || (optopt == 'a') || (optopt == 'c') ||
-					(optopt == 'd')) {
+					(optopt == 'd') || (optopt == 'k') || (optopt == 'K') || (optopt == 'X') || (optopt == 'F') || (optopt == 'Z') || (optopt == 'Y')) {
 					fprintf(stderr, "Option '%c' requires an argument.\n", optopt);
 				} else {
 					fprintf(stderr, "Option '%c' is unknown or encountered an error.\n", optopt);
@@ -179,51 +493,51 @@ int main(int argc, char *argv[]) {
 			default:
 #pragma GCC diagnostic pop
 				helpMessages();
-				CLICleanup(config, outConfig, headerBuffer);
+				CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 				return 1;
 
 		}
 	}
 
 	if (flagged) {
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
 	if (!input) {
 		fprintf(stderr, "ERROR: No inputs provided, exiting.\n");
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
 	if (!inputProvided) {
 		fprintf(stderr, "ERROR: An input was not provided, exiting.\n");
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
 	if (lofar_udp_io_read_parse_optarg(config, inputFormat) < 0) {
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
 	if (!outputProvided) {
 		fprintf(stderr, "ERROR: An output was not provided, exiting.\n");
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
 	if (config->calibrateData != NO_CALIBRATION && !strnlen(config->metadata_config.metadataLocation, DEF_STR_LEN)) {
 		fprintf(stderr, "ERROR: Data calibration was enabled, but metadata was not provided. Exiting.\n");
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
 	// Sanity check a few inputs
-	if ((config->numPorts <= 0 || config->numPorts > MAX_NUM_PORTS) || // We are processing a sane number of ports
+	if ((config->numPorts <= 0 || config->numPorts > config->allocatedPorts) || // We are processing a sane number of ports
 		(config->packetsPerIteration < 2) || // We are processing a sane number of packets
 		(config->replayDroppedPackets > 1 || config->replayDroppedPackets < 0) || // Replay key was not malformed
 		(config->processingMode > 1000 || config->processingMode < 0) ||
@@ -234,10 +548,75 @@ int main(int argc, char *argv[]) {
 
 		fprintf(stderr, "One or more inputs invalid or not fully initialised, exiting.\n");
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+		return 1;
+	}
+
+
+	if (checkpointEvery != LONG_MAX || resume) {
+		if (!strnlen(checkpointFile, DEF_STR_LEN) || checkpointEvery < 1) {
+			fprintf(stderr, "ERROR: Checkpoints (-k/-R) require a checkpoint file (-K) and a positive interval (%ld), exiting.\n", checkpointEvery);
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+
+		// Only a single, plain output file per output can be truncated back to a checkpoint and continued
+		if (strnlen(eventsFile, DEF_STR_LEN) || splitEvery != LONG_MAX || outConfig->readerType != NORMAL) {
+			fprintf(stderr, "ERROR: Checkpoints cannot be combined with events (-e), output splitting (-S) or non-file outputs, exiting.\n");
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+	}
+
+	if (numShards != 0) {
+		if (numShards < 1 || shardIdx < 0 || shardIdx >= numShards) {
+			fprintf(stderr, "ERROR: Invalid shard %d of %d requested, exiting.\n", shardIdx, numShards);
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+
+		// Every shard must derive the same range and gulp boundaries from the command line alone
+		if (!strnlen(inputTime, 256) || seconds == 0.0 || autoTune) {
+			fprintf(stderr, "ERROR: Sharding (-X) requires a start time (-t), a duration (-s) and a fixed number of packets per iteration (-m), exiting.\n");
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+
+		// The stitch step reads the part files back, so they must be plain files
+		if (strnlen(eventsFile, DEF_STR_LEN) || splitEvery != LONG_MAX || strnlen(checkpointFile, DEF_STR_LEN) || outConfig->readerType != NORMAL) {
+			fprintf(stderr, "ERROR: Sharding cannot be combined with events (-e), output splitting (-S), checkpoints (-K) or non-file outputs, exiting.\n");
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+
+		if (lofar_udp_shard_output_format(outConfig, shardIdx) < 0) {
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+	}
+
+	// Blocks are only handed out by PSRDADA outputs, and event outputs are written from slices of the processed data
+	if (directWrite && (outConfig->readerType != DADA_ACTIVE || strnlen(eventsFile, DEF_STR_LEN))) {
+		fprintf(stderr, "ERROR: Direct writes (-D) require PSRDADA outputs and cannot be combined with events (-e), exiting.\n");
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+		return 1;
+	}
+
+	if (asyncWrite && (directWrite || strnlen(eventsFile, DEF_STR_LEN))) {
+		fprintf(stderr, "ERROR: Background writes (-A) cannot be combined with direct writes (-D) or events (-e), exiting.\n");
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
+	if (resume) {
+		if (lofar_udp_checkpoint_load(&resumeCheckpoint, checkpointFile) < 0) {
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+		config->resumeCheckpoint = &resumeCheckpoint;
+		outConfig->resumeCheckpoint = &resumeCheckpoint;
+		outConfig->progressWithExisting = 1;
+	}
 
 	if (silent == 0) {
 		printf("LOFAR UDP Data extractor (v%s, lib v%s)\n\n", UPM_CLI_VERSION, UPM_VERSION);
@@ -251,15 +630,52 @@ int main(int argc, char *argv[]) {
 		VERBOSE(printf("Verbose:\t%d\n", config->verbose););
 		printf("Proc Mode:\t%03d\t\t\tReader:\t%d\n\n", config->processingMode, config->readerType);
 		printf("Beamlet limits:\t%d, %d\n\n", config->beamletLimits[0], config->beamletLimits[1]);
+		if (strnlen(checkpointFile, DEF_STR_LEN)) {
+			printf("Checkpoint:\t%s\tEvery:\t%ld\tResume:\t%d\n\n", checkpointFile, checkpointEvery, resume);
+		}
 	}
 
 	headerBuffer = calloc(DEF_HDR_LEN, sizeof(char));
 
+	if (autoTune) {
+		if (silent == 0) { printf("Tuning packets per iteration...\n"); }
+		const int64_t tunedPackets = lofar_udp_reader_tune_packets_per_iteration(config);
+		if (tunedPackets < 1) {
+			fprintf(stderr, "ERROR: Failed to tune the number of packets per iteration, exiting.\n");
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+		config->packetsPerIteration = tunedPackets;
+		if (silent == 0) { printf("Tuned packets per iteration: %ld (use -m %ld to skip tuning on this node)\n\n", tunedPackets, tunedPackets); }
+	}
+
+	if (strnlen(eventsFile, DEF_STR_LEN)) {
+		if (strnlen(inputTime, 256) || seconds != 0.0 || splitEvery != LONG_MAX) {
+			fprintf(stderr, "ERROR: Events (-e) cannot be combined with a start time (-t), duration (-s) or output splitting (-S), exiting.\n");
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+
+		if (strstr(outConfig->outputFormat, "[[iter]]") == NULL) {
+			fprintf(stderr, "ERROR: The output format must contain [[iter]] when extracting events, exiting.\n");
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+
+		if (silent == 0) { printf("Events File:\t%s\t200MHz Clock:\t%d\n", eventsFile, clock200MHz); }
+		if (silent == 0) { printf("============ End configuration ============\n\n"); }
+
+		returnVal = extractEvents(config, outConfig, headerBuffer, eventsFile, clock200MHz, silent);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+		if (silent == 0 && returnVal == 0) { printf("CLI memory cleaned up successfully. Exiting.\n"); }
+		return (int) returnVal;
+	}
+
 	if (strnlen(inputTime, 256)) {
 		startingPacket = lofar_udp_time_get_packet_from_isot(inputTime, clock200MHz);
 		if (startingPacket == 1) {
 			helpMessages();
-			CLICleanup(config, outConfig, headerBuffer);
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 			return 1;
 		}
 	}
@@ -268,6 +684,14 @@ int main(int argc, char *argv[]) {
 		maxPackets = lofar_udp_time_get_packets_from_seconds(seconds, clock200MHz);
 	}
 
+	if (numShards != 0) {
+		if (lofar_udp_shard_range(startingPacket, maxPackets, config->packetsPerIteration, shardIdx, numShards, &startingPacket, &maxPackets) < 0) {
+			CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+			return 1;
+		}
+		if (silent == 0) { printf("Shard:\t\t%d/%d\n", shardIdx, numShards); }
+	}
+
 	if (silent == 0) { printf("Start Time:\t%s\t200MHz Clock:\t%d\n", inputTime, clock200MHz); }
 	if (silent == 0) {
 		printf("Initial Packet:\t%ld\t\tFinal Packet:\t%ld\n", startingPacket, startingPacket + maxPackets);
@@ -294,12 +718,16 @@ int main(int argc, char *argv[]) {
 	// Generate the lofar_udp_reader, this also performs I/O to seeks to the required packet and gulps the first input
 	config->startingPacket = startingPacket;
 	config->packetsReadMax = maxPackets;
+	// Shards stop at the start of the next shard, even if their first packet was lost and the reader starts late
+	if (numShards != 0) {
+		config->endPacket = startingPacket + maxPackets;
+	}
 	lofar_udp_reader *reader = lofar_udp_reader_setup(config);
 
 	// Returns null on error, check
 	if (reader == NULL) {
 		fprintf(stderr, "Failed to generate reader. Exiting.\n");
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
@@ -307,7 +735,7 @@ int main(int argc, char *argv[]) {
 	if (((lofar_source_bytes *) &(reader->meta->inputData[0][1]))->clockBit != (uint32_t) clock200MHz) {
 		fprintf(stderr,
 				"ERROR: The clock bit of the first packet does not match the clock state given when starting the CLI. Add or remove -c from your command. Exiting.\n");
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
@@ -338,7 +766,21 @@ int main(int argc, char *argv[]) {
 	startingPacket = reader->meta->leadingPacket;
 	if ((returnVal = _lofar_udp_io_write_internal_lib_setup_helper(outConfig, reader, 0)) < 0) {
 		fprintf(stderr, "ERROR: Failed to open an output file (%ld, errno %d: %s), exiting.\n", returnVal, errno, strerror(errno));
-		CLICleanup(config, outConfig, headerBuffer);
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+		return 1;
+	}
+
+	if (numShards != 0 && lofar_udp_shard_setup(&shard, reader, outConfig, shardIdx, numShards) < 0) {
+		CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
+		return 1;
+	}
+
+	if ((asyncWrite && lofar_udp_io_write_async_setup(outConfig, ASYNC_WRITE_BUFFERS) < 0) ||
+		((directWrite || asyncWrite) && CLIRedirectOutputs(reader, outConfig, directWrite) < 0)) {
+		fprintf(stderr, "ERROR: Failed to get output buffers for direct or background writes, exiting.\n");
+		lofar_udp_reader_cleanup(reader);
+		lofar_udp_io_write_cleanup(outConfig, 1);
+		CLICleanup(config, NULL, headerBuffer, &resumeCheckpoint, &shard);
 		return 1;
 	}
 
@@ -370,11 +812,21 @@ int main(int argc, char *argv[]) {
 			packetsToWrite = maxPackets;
 		}
 
+		// Headers are written synchronously, so the previous iteration's data must be out before one is written
+		const int8_t newObs = localLoops == 0 && !resume;
+		if (asyncWrite && lofar_udp_metadata_write_pending(reader->metadata, newObs) && lofar_udp_io_write_async_wait(outConfig) < 0) {
+			fprintf(stderr, "ERROR: Background write to output failed, breaking.\n");
+			returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+			break;
+		}
+
+		int8_t headerFailed = 0;
 		for (int8_t out = 0; out < reader->meta->numOutputs; out++) {
 			CLICK(tick1);
-			if ((returnVal = lofar_udp_metadata_write_file(reader, outConfig, out, reader->metadata, headerBuffer, 4096 * 8, localLoops == 0)) < 0) {
+			if ((returnVal = lofar_udp_metadata_write_file(reader, outConfig, out, reader->metadata, headerBuffer, 4096 * 8, newObs)) < 0) {
 				fprintf(stderr, "ERROR: Failed to write header to output (%ld, errno %d: %s), breaking.\n", returnVal, errno, strerror(errno));
 				returnValMeta = (returnValMeta < 0 && returnValMeta > -4) ? returnValMeta : -4;
+				headerFailed = 1;
 				break;
 			}
 			CLICK(tock1);
@@ -385,20 +837,57 @@ int main(int argc, char *argv[]) {
 			               packetsToWrite * reader->meta->packetOutputLength[out], packetsToWrite, out));
 			size_t outputLength = packetsToWrite * reader->meta->packetOutputLength[out];
 			size_t outputWritten;
-			if ((outputWritten = lofar_udp_io_write(outConfig, out, reader->meta->outputData[out],
-								   outputLength)) != outputLength) {
+			// Direct writes were processed into the output's block, so it only needs to be handed over
+			if (directWrite) {
+				outputWritten = lofar_udp_io_write_commit(outConfig, out, (int64_t) outputLength);
+			} else if (asyncWrite) {
+				outputWritten = (lofar_udp_io_write_async_submit(outConfig, out, reader->meta->outputData[out], (int64_t) outputLength, NULL, NULL) < 0) ? 0 : outputLength;
+			} else {
+				writeData[out] = reader->meta->outputData[out];
+				writeLength[out] = (int64_t) outputLength;
+				continue;
+			}
+			if (outputWritten != outputLength) {
 				fprintf(stderr, "ERROR: Failed to write data to output (%ld bytes/%ld bytes writen, errno %d: %s)), breaking.\n", outputWritten, outputLength,  errno, strerror(errno));
 				returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
 				break;
 			}
+			shard.outputBytes[out] += (int64_t) outputLength;
 			CLICK(tock0);
 			timing[3] += TICKTOCK(tick0, tock0);
 
 		}
 
+		// Data must not be written behind a missing header
+		if (headerFailed) {
+			break;
+		}
+
+		// Every output is compressed and written at the same time, rather than one after another
+		if (!directWrite && !asyncWrite && returnValMeta > -4) {
+			CLICK(tick0);
+			if (lofar_udp_io_write_all(outConfig, writeData, writeLength, outputTiming) < 0) {
+				fprintf(stderr, "ERROR: Failed to write data to outputs (errno %d: %s), breaking.\n", errno, strerror(errno));
+				returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+				break;
+			}
+			for (int8_t out = 0; out < reader->meta->numOutputs; out++) {
+				shard.outputBytes[out] += writeLength[out];
+			}
+			CLICK(tock0);
+			timing[3] += TICKTOCK(tick0, tock0);
+		}
+
 		if (splitEvery != LONG_MAX && returnValMeta > -2) {
 			if (!((localLoops + 1) % splitEvery)) {
 
+				// Background writes must complete before their files are closed
+				if (asyncWrite && lofar_udp_io_write_async_wait(outConfig) < 0) {
+					fprintf(stderr, "ERROR: Background write to output failed, breaking.\n");
+					returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+					break;
+				}
+
 				// Close existing files
 				lofar_udp_io_write_cleanup(outConfig, 0);
 
@@ -411,6 +900,19 @@ int main(int argc, char *argv[]) {
 			}
 		}
 
+		// Record the progress once this iteration's output is complete, a restarted job will resume from here
+		if (checkpointEvery != LONG_MAX && returnValMeta > -2 && !((localLoops + 1) % checkpointEvery)) {
+			if (asyncWrite && lofar_udp_io_write_async_wait(outConfig) < 0) {
+				returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+				break;
+			}
+			if ((returnVal = lofar_udp_reader_checkpoint_write(reader, outConfig, checkpointFile)) < 0) {
+				fprintf(stderr, "ERROR: Failed to write checkpoint to %s (%ld), breaking.\n", checkpointFile, returnVal);
+				returnValMeta = (returnValMeta < 0 && returnValMeta > -8) ? returnValMeta : -8;
+				break;
+			}
+		}
+
 		totalMetadataTime += timing[2];
 		totalWriteTime += timing[3];
 
@@ -420,6 +922,11 @@ int main(int argc, char *argv[]) {
 		if (silent == 0) {
 			printf("Metadata processing for operation %ld after %f seconds.\n", loops, timing[2]);
 			printf("Disk writes completed for operation %ld after %f seconds.\n", loops, timing[3]);
+			if (!directWrite && !asyncWrite) {
+				for (int8_t out = 0; out < reader->meta->numOutputs; out++) {
+					printf("\tOutput %d: %f seconds (%.01lf MB/s)\n", out, outputTiming[out], (double) writeLength[out] / 1e+6 / outputTiming[out]);
+				}
+			}
 
 			for (int idx = 0; idx < TIMEARRLEN; idx++) {
 				timing[idx] = 0.;
@@ -455,10 +962,36 @@ int main(int argc, char *argv[]) {
 			break;
 		}
 
+		// Buffers left unused when the reader finishes are returned when the outputs are cleaned up
+		if ((directWrite || asyncWrite) && CLIRedirectOutputs(reader, outConfig, directWrite) < 0) {
+			fprintf(stderr, "ERROR: Failed to get output buffers for direct or background writes, breaking.\n");
+			returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+			break;
+		}
+
 	}
 
+	// Make sure the outputs are complete before they are described or closed
+	if (asyncWrite && lofar_udp_io_write_async_wait(outConfig) < 0) {
+		fprintf(stderr, "ERROR: Background write to output failed.\n");
+		returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+	}
 	CLICK(tock);
 
+	// Describe the shard for the stitch step, unless the outputs are incomplete
+	if (numShards != 0 && returnValMeta > -4) {
+		char shardLocation[DEF_STR_LEN];
+		shard.packetsWritten = packetsWritten;
+		for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+			shard.droppedPackets += reader->meta->portTotalDroppedPackets[port];
+		}
+		if (lofar_udp_shard_get_location(shardLocation, outConfig->outputLocations[0]) < 0 || lofar_udp_shard_write(&shard, shardLocation) < 0) {
+			fprintf(stderr, "ERROR: Failed to write the shard manifest, the part files cannot be stitched.\n");
+		} else if (silent == 0) {
+			printf("Shard %d/%d manifest written to %s\n", shardIdx, numShards, shardLocation);
+		}
+	}
+
 	int64_t droppedPackets = 0, totalPacketLength = 0, totalOutLength = 0;
 
 	// Print out a summary of the operations performed, this does not contain data read for seek operations
@@ -485,6 +1018,7 @@ int main(int argc, char *argv[]) {
 		       (double) (packetsWritten * totalOutLength) / 1e+6 / totalWriteTime);
 		printf("Approximate Throughput:\t%3.01lf GB/s\n", (double) (reader->meta->numPorts * packetsProcessed * (totalPacketLength + totalOutLength)) / 1e+9 / totalOpsTime);
 		printf("A total of %ld packets were missed during the observation.\n", droppedPackets);
+		printCompressionLevels(outConfig);
 		printf("\n\nData processing finished. Cleaning up file and memory objects...\n");
 	}
 
@@ -499,7 +1033,7 @@ int main(int argc, char *argv[]) {
 	outConfig = NULL;
 
 	// Free our malloc'd objects
-	CLICleanup(config, outConfig, headerBuffer);
+	CLICleanup(config, outConfig, headerBuffer, &resumeCheckpoint, &shard);
 
 	if (silent == 0) { printf("CLI memory cleaned up successfully. Exiting.\n"); }
 	return 0;
@@ -0,0 +1,171 @@
+#include "lofar_cli_meta.h"
+
+void helpMessages() {
+	printf("LOFAR UDP Packet Indexer (CLI v%s, lib v%s)\n\n", UPM_CLI_VERSION, UPM_VERSION);
+	printf("Usage: lofar_udp_index <flags>");
+
+	printf("\n\n");
+
+	printf("Generate packet index sidecar files (<input>%s) for a set of captures, allowing the reader to seek directly to a given starting packet.\n\n", UPM_INDEX_SUFFIX);
+
+	printf("-i: <format>	Input file name format (normal or zstandard compressed files)\n");
+	printf("-u: <numPort>	Number of ports to index (default: 4)\n");
+	printf("-s: <stride>	Number of packets between index entries (default: %d)\n", UPM_INDEX_DEFAULT_STRIDE);
+	printf("-f:		        Overwrite existing index files (default: skip inputs that are already indexed)\n");
+	printf("-q:		        Enable silent mode for the CLI, don't print any information outside of library error messages (default: False)\n");
+	printf("-h:		        Print this help message\n");
+}
+
+int main(int argc, char *argv[]) {
+
+	int32_t inputOpt, stride = UPM_INDEX_DEFAULT_STRIDE;
+	char inputFormat[DEF_STR_LEN] = "", indexLocation[DEF_STR_LEN] = "";
+	int8_t silent = 0, overwrite = 0, inputProvided = 0, flagged = 0;
+	char *endPtr;
+
+	lofar_udp_config *config = lofar_udp_config_alloc();
+	if (config == NULL) {
+		fprintf(stderr, "ERROR: Failed to allocate memory for configuration struct, exiting.\n");
+		return 1;
+	}
+
+	while ((inputOpt = getopt(argc, argv, "hfqi:u:s:")) != -1) {
+		switch (inputOpt) {
+
+			case 'i':
+				strncpy(inputFormat, optarg, DEF_STR_LEN - 1);
+				inputProvided = 1;
+				break;
+
+			case 'u':
+				config->numPorts = internal_strtoc(optarg, &endPtr);
+				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
+				break;
+
+			case 's':
+				stride = internal_strtoi(optarg, &endPtr);
+				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
+				break;
+
+			case 'f':
+				overwrite = 1;
+				break;
+
+			case 'q':
+				silent = 1;
+				break;
+
+				// Silence GCC warnings, fall-through is the desired behaviour
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+#pragma GCC diagnostic push
+			case '?':
+				if ((optopt == 'i') || (optopt == 'u') || (optopt == 's')) {
+					fprintf(stderr, "Option '%c' requires an argument.\n", optopt);
+				} else {
+					fprintf(stderr, "Option '%c' is unknown or encountered an error.\n", optopt);
+				}
+
+			case 'h':
+			default:
+#pragma GCC diagnostic pop
+				helpMessages();
+				lofar_udp_config_cleanup(config);
+				return 1;
+		}
+	}
+
+	if (flagged) {
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	if (!inputProvided) {
+		fprintf(stderr, "ERROR: An input was not provided, exiting.\n");
+		helpMessages();
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	if (lofar_udp_io_read_parse_optarg(config, inputFormat) < 0) {
+		helpMessages();
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	if (config->numPorts < 1 || (config->numPorts + config->offsetPortCount) > INT8_MAX || stride < 1) {
+		fprintf(stderr, "One or more inputs invalid (ports: %d, stride: %d), exiting.\n", config->numPorts, stride);
+		helpMessages();
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	if (config->readerType != NORMAL && config->readerType != NORMAL_MMAP && config->readerType != URING && config->readerType != ZSTDCOMPRESSED && config->readerType != ZSTDCOMPRESSED_INDIRECT) {
+		fprintf(stderr, "ERROR: Only normal and zstandard compressed files can be indexed (reader %d), exiting.\n", config->readerType);
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	if (!silent) {
+		printf("LOFAR UDP Packet Indexer (v%s, lib v%s)\n\n", UPM_CLI_VERSION, UPM_VERSION);
+	}
+
+	int32_t returnVal = 0;
+	struct timespec tick, tock;
+	for (int8_t port = 0; port < config->numPorts; port++) {
+		if (lofar_udp_index_get_location(indexLocation, config->inputLocations[port]) < 0) {
+			returnVal = 1;
+			break;
+		}
+
+		if (!overwrite && access(indexLocation, F_OK) == 0) {
+			if (!silent) printf("Port %d: %s already exists, skipping (use -f to overwrite).\n", port, indexLocation);
+			continue;
+		}
+
+		CLICK(tick);
+		lofar_udp_index *packetIndex = lofar_udp_index_generate(config->inputLocations[port], config->readerType, stride);
+		if (packetIndex == NULL) {
+			fprintf(stderr, "ERROR: Failed to generate index for %s, exiting.\n", config->inputLocations[port]);
+			returnVal = 1;
+			break;
+		}
+
+		if (lofar_udp_index_write(packetIndex, indexLocation) < 0) {
+			lofar_udp_index_cleanup(packetIndex);
+			returnVal = 1;
+			break;
+		}
+		CLICK(tock);
+
+		if (!silent) {
+			printf("Port %d: %s\n", port, config->inputLocations[port]);
+			printf("\tPackets: %ld (%ld -> %ld), %ld dropped (%.3f%%)\n", packetIndex->totalPackets, packetIndex->firstPacket, packetIndex->lastPacket,
+			       packetIndex->totalDropped, 100.0 * (double) packetIndex->totalDropped / (double) (packetIndex->totalPackets + packetIndex->totalDropped));
+			printf("\tWrote %ld entries (stride %d) to %s in %.2fs\n\n", packetIndex->numEntries, packetIndex->stride, indexLocation, TICKTOCK(tick, tock));
+		}
+
+		lofar_udp_index_cleanup(packetIndex);
+	}
+
+	lofar_udp_config_cleanup(config);
+	return returnVal;
+}
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
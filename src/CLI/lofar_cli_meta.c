@@ -1,13 +1,14 @@
 #include "lofar_cli_meta.h"
 
 
-const char exitReasons[8][DEF_STR_LEN] = { "", "",
+const char exitReasons[9][DEF_STR_LEN] = { "", "",
 									"Reached the packet limit set at start-up",
 									"Read less data than requested from file (near EOF or disk error)",
 									"Metadata failed to write",
 									"Output data failed to write",
 									"Failed to re-initialise reader for new event",
 									"Failed to open new file",
+									"Failed to write a checkpoint",
 };
 
 void sharedFlags(void) {
@@ -18,15 +19,19 @@ void sharedFlags(void) {
 	printf("-I: <str>		Input metadata file (default: '')\n");
 	printf("-c:		        Calibrate the data using the provided metadata.\n");
 	printf("-M: <str>		Override output metadata format\n");
-	printf("-m: <numPack>	Number of packets to process in each read request (default: 65536)\n");
+	printf("-m: <numPack>	Number of packets to process in each read request (default: 65536, 'auto' to tune on the input in lofar_udp_extractor)\n");
 	printf("-u: <numPort>	Number of ports to combine (default: 4)\n");
 	printf("-n: <baseNum>	Base value to iterate when choosing ports (default: 0)\n");
 	printf("-b: <lo>,<hi>	Beamlets to extract from the input dataset. Lo is inclusive, hi is exclusive ( eg. 0,300 will return 300 beamlets, 0:299). (default: 0,0 === all)\n");
 	printf("-t: <timeStr>	String of the time of the first requested packet, format YYYY-MM-DDTHH:mm:ss (default: '')\n");
 	printf("-s: <numSec>	Maximum number of seconds of raw data to extract/process (default: all)\n");
 	printf("-S: <iters>     Break into a new file every N given iterations (default: infinite, never break)\n");
+	printf("-X: <k>,<N>     Process shard k of N of the time range given by -t/-s, writing part files and a manifest for lofar_udp_stitch (default: disabled)\n");
 	printf("-r:		        Replay the previous packet when a dropped packet is detected (default: pad with 0 values)\n");
 	printf("-T: <threads>	OpenMP Threads to use during processing (8+ highly recommended, default: %d)\n", OMP_THREADS);
+	printf("-F: <numSec>	Follow normal/zstandard inputs that are still being written, ending after N seconds without new data (default: 0, disabled)\n");
+	printf("-Z: <lo>,<hi>	Adapt the zstandard output compression level between lo and hi to keep up with the incoming data (default: disabled, fixed level)\n");
+	printf("-Y: <byte|bit>[,size]	Byte or bit shuffle zstandard outputs before compression, in elements of size bytes (default: disabled, %d byte elements)\n", ZSTD_FILTER_ELEMENT_SIZE);
 
 	printf("-q:		        Enable silent mode for the CLI, don't print any information outside of library error messages (default: False)\n");
 	VERBOSE(printf("-v:		Enable verbose output (default: False)\n");
@@ -74,6 +79,56 @@ int checkOpt(int opt, char* inp, char* endPtr) {
 	return 1;
 }
 
+int parseAdaptiveCompression(lofar_udp_io_write_config *outConfig, char *inp) {
+	int32_t minLevel, maxLevel;
+	if (sscanf(inp, "%d,%d", &minLevel, &maxLevel) != 2 || minLevel < 1 || minLevel > maxLevel) {
+		fprintf(stderr, "ERROR: Failed to parse compression levels from %s (expected <lo>,<hi>, 1 <= lo <= hi), exiting.\n", inp);
+		return 1;
+	}
+
+	outConfig->zstdConfig.adaptive = 1;
+	outConfig->zstdConfig.minLevel = minLevel;
+	outConfig->zstdConfig.maxLevel = maxLevel;
+	return 0;
+}
+
+int parseCompressionFilter(lofar_udp_io_write_config *outConfig, char *inp) {
+	char filterName[64] = "";
+	int32_t elementSize = ZSTD_FILTER_ELEMENT_SIZE;
+	const int32_t parsed = sscanf(inp, "%63[^,],%d", filterName, &elementSize);
+	zstd_filter_t filter = ZSTD_FILTER_NONE;
+	if (parsed >= 1 && strcmp(filterName, "byte") == 0) {
+		filter = ZSTD_FILTER_BYTESHUFFLE;
+	} else if (parsed >= 1 && strcmp(filterName, "bit") == 0) {
+		filter = ZSTD_FILTER_BITSHUFFLE;
+	}
+
+	if (filter == ZSTD_FILTER_NONE || (strchr(inp, ',') != NULL && parsed != 2) || elementSize < 1 || 8 * elementSize > ZSTD_FILTER_BLOCK_SIZE) {
+		fprintf(stderr, "ERROR: Failed to parse compression filter from %s (expected <byte|bit>[,elementSize]), exiting.\n", inp);
+		return 1;
+	}
+
+	outConfig->zstdConfig.filter = filter;
+	outConfig->zstdConfig.filterElementSize = elementSize;
+	return 0;
+}
+
+void printCompressionLevels(const lofar_udp_io_write_config *outConfig) {
+	if (outConfig == NULL || !outConfig->zstdConfig.adaptive || (outConfig->readerType != ZSTDCOMPRESSED && outConfig->readerType != ZSTDCOMPRESSED_INDIRECT)) {
+		return;
+	}
+
+	for (int8_t out = 0; out < outConfig->numOutputs; out++) {
+		printf("Output %d compression levels (%ld frames, MB input):", out, outConfig->zstdWriter[out].frames);
+		for (int32_t level = 0; level <= ZSTD_ADAPT_MAX_LEVEL; level++) {
+			if (outConfig->zstdWriter[out].levelBytes[level] > 0) {
+				printf(" L%d: %.01lf", level, (double) outConfig->zstdWriter[out].levelBytes[level] / 1e+6);
+			}
+		}
+		printf("\n");
+	}
+}
+
 /**
  * Copyright (C) 2023 David McKenna
  * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
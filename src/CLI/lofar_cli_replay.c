@@ -0,0 +1,343 @@
+#include "lofar_cli_meta.h"
+
+#include <sys/socket.h>
+#include <netdb.h>
+
+// Number of packets sent per port before moving to the next port
+#define REPLAY_BATCH_SIZE 16
+
+void helpMessages() {
+	printf("LOFAR UDP Packet Replayer (CLI v%s, lib v%s)\n\n", UPM_CLI_VERSION, UPM_VERSION);
+	printf("Usage: lofar_udp_replay <flags>");
+
+	printf("\n\n");
+
+	printf("Replay recorded CEP packets over UDP, sending each port's packets to (base port + port offset), to test live (UDP:) readers without a station.\n\n");
+
+	printf("-i: <format>	Input file name format (uncompressed files only)\n");
+	printf("-u: <numPort>	Number of ports to replay (default: 4)\n");
+	printf("-d: <[host:]port>	Destination host and base port (default: 127.0.0.1:16130)\n");
+	printf("-r: <rate>	    Packets per second per port, 0 for no pacing (default: 0)\n");
+	printf("-n: <packets>	Maximum number of packets to send per port (default: all)\n");
+	printf("-q:		        Enable silent mode for the CLI, don't print any information outside of library error messages (default: False)\n");
+	printf("-h:		        Print this help message\n");
+}
+
+/**
+ * @brief      Open a UDP socket connected to a destination port
+ *
+ * @param[in]  host  The destination host
+ * @param[in]  port  The destination port
+ *
+ * @return     >=0: Socket file descriptor, <0: Failure
+ */
+static int32_t openSocket(const char host[], const int32_t port) {
+	char service[16];
+	snprintf(service, 16, "%d", port);
+
+	struct addrinfo hints, *addresses;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_flags = AI_NUMERICSERV;
+	const int32_t lookupReturn = getaddrinfo(host, service, &hints, &addresses);
+	if (lookupReturn != 0) {
+		fprintf(stderr, "ERROR: Failed to resolve %s:%s (%s), exiting.\n", host, service, gai_strerror(lookupReturn));
+		return -1;
+	}
+
+	int32_t fd = -1;
+	for (const struct addrinfo *address = addresses; address != NULL; address = address->ai_next) {
+		if ((fd = socket(address->ai_family, address->ai_socktype, address->ai_protocol)) < 0) {
+			continue;
+		}
+		if (connect(fd, address->ai_addr, address->ai_addrlen) == 0) {
+			break;
+		}
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(addresses);
+
+	if (fd < 0) {
+		fprintf(stderr, "ERROR: Failed to open a socket to %s:%s (errno %d: %s), exiting.\n", host, service, errno, strerror(errno));
+	}
+	return fd;
+}
+
+int main(int argc, char *argv[]) {
+
+	int32_t inputOpt, basePort = 16130;
+	double rate = 0.0;
+	int64_t packetsMax = LONG_MAX;
+	char inputFormat[DEF_STR_LEN] = "", destination[DEF_STR_LEN] = "127.0.0.1:16130", host[DEF_STR_LEN] = "";
+	int8_t silent = 0, inputProvided = 0, flagged = 0;
+	char *endPtr;
+
+	lofar_udp_config *config = lofar_udp_config_alloc();
+	if (config == NULL) {
+		fprintf(stderr, "ERROR: Failed to allocate memory for configuration struct, exiting.\n");
+		return 1;
+	}
+
+	while ((inputOpt = getopt(argc, argv, "hqi:u:d:r:n:")) != -1) {
+		switch (inputOpt) {
+
+			case 'i':
+				strncpy(inputFormat, optarg, DEF_STR_LEN - 1);
+				inputProvided = 1;
+				break;
+
+			case 'u':
+				config->numPorts = internal_strtoc(optarg, &endPtr);
+				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
+				break;
+
+			case 'd':
+				strncpy(destination, optarg, DEF_STR_LEN - 1);
+				break;
+
+			case 'r':
+				rate = strtod(optarg, &endPtr);
+				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
+				break;
+
+			case 'n':
+				packetsMax = internal_strtoi(optarg, &endPtr);
+				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
+				break;
+
+			case 'q':
+				silent = 1;
+				break;
+
+				// Silence GCC warnings, fall-through is the desired behaviour
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+#pragma GCC diagnostic push
+			case '?':
+				if ((optopt == 'i') || (optopt == 'u') || (optopt == 'd') || (optopt == 'r') || (optopt == 'n')) {
+					fprintf(stderr, "Option '%c' requires an argument.\n", optopt);
+				} else {
+					fprintf(stderr, "Option '%c' is unknown or encountered an error.\n", optopt);
+				}
+
+			case 'h':
+			default:
+#pragma GCC diagnostic pop
+				helpMessages();
+				lofar_udp_config_cleanup(config);
+				return 1;
+		}
+	}
+
+	if (flagged) {
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	if (!inputProvided) {
+		fprintf(stderr, "ERROR: An input was not provided, exiting.\n");
+		helpMessages();
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	if (lofar_udp_io_read_parse_optarg(config, inputFormat) < 0) {
+		helpMessages();
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	// Split the destination into the host and base port, stripping the brackets around IPv6 addresses
+	char *separator = strrchr(destination, ':');
+	if (separator != NULL) {
+		const char *hostStart = destination;
+		int64_t hostLength = separator - destination;
+		if (hostLength > 1 && hostStart[0] == '[' && hostStart[hostLength - 1] == ']') {
+			hostStart++;
+			hostLength -= 2;
+		}
+		memcpy(host, hostStart, hostLength);
+		host[hostLength] = '\0';
+		basePort = internal_strtoi(separator + 1, &endPtr);
+	} else {
+		strcpy(host, "127.0.0.1");
+		basePort = internal_strtoi(destination, &endPtr);
+	}
+
+	if (config->numPorts < 1 || (config->numPorts + config->offsetPortCount) > INT8_MAX || basePort < 1 || (basePort + config->numPorts) > 65536 || rate < 0.0 || packetsMax < 1) {
+		fprintf(stderr, "One or more inputs invalid (ports: %d, base port: %d, rate: %lf, packets: %ld), exiting.\n", config->numPorts, basePort, rate, packetsMax);
+		helpMessages();
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	if (config->readerType != NORMAL && config->readerType != FIFO && config->readerType != NORMAL_MMAP && config->readerType != URING) {
+		fprintf(stderr, "ERROR: Only uncompressed files can be replayed (reader %d), exiting.\n", config->readerType);
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	if (input == NULL) {
+		fprintf(stderr, "ERROR: Failed to allocate memory for reader struct, exiting.\n");
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+	input->readerType = config->readerType;
+	if (lofar_udp_io_read_alloc_ports(input, config->numPorts) < 0) {
+		lofar_udp_io_read_cleanup(input);
+		lofar_udp_config_cleanup(config);
+		return 1;
+	}
+
+	int8_t *buffers[config->numPorts];
+	int32_t sockets[config->numPorts], packetLength[config->numPorts];
+	int64_t packetsSent[config->numPorts];
+	int8_t portActive[config->numPorts];
+	ARR_INIT(buffers, config->numPorts, NULL);
+	ARR_INIT(sockets, config->numPorts, -1);
+	ARR_INIT(packetLength, config->numPorts, 0);
+	ARR_INIT(packetsSent, config->numPorts, 0);
+	ARR_INIT(portActive, config->numPorts, 0);
+
+	int32_t returnVal = 0;
+	for (int8_t port = 0; port < config->numPorts && !returnVal; port++) {
+		// Determine the packet length from the first header, as the reader would
+		int8_t header[UDPHDRLEN];
+		if (lofar_udp_io_read_temp(config, port, header, 1, UDPHDRLEN, 1) != UDPHDRLEN) {
+			fprintf(stderr, "ERROR: Failed to read the first header from %s, exiting.\n", config->inputLocations[port]);
+			returnVal = 1;
+			break;
+		}
+		const lofar_source_bytes *source = (const lofar_source_bytes *) &(header[CEP_HDR_SRC_OFFSET]);
+		const float bitMul = 1.0f + (-0.5f * (float) (source->bitMode == 2)) + (float) (source->bitMode == 0);
+		packetLength[port] = UDPHDRLEN + (int32_t) ((uint8_t) header[CEP_HDR_NBEAM_OFFSET]) * ((int32_t) (bitMul * UDPNTIMESLICE * UDPNPOL));
+		if (packetLength[port] > MAXPKTLEN) {
+			fprintf(stderr, "ERROR: Packet length %d on %s is longer than maximum packet length %d, exiting.\n", packetLength[port], config->inputLocations[port], MAXPKTLEN);
+			returnVal = 1;
+			break;
+		}
+
+		strncpy(input->inputLocations[port], config->inputLocations[port], DEF_STR_LEN);
+		if ((buffers[port] = calloc(REPLAY_BATCH_SIZE * packetLength[port], sizeof(int8_t))) == NULL
+			|| lofar_udp_io_read_setup_helper(input, buffers, REPLAY_BATCH_SIZE * packetLength[port], port) < 0
+			|| (sockets[port] = openSocket(host, basePort + port)) < 0) {
+			returnVal = 1;
+			break;
+		}
+		portActive[port] = 1;
+	}
+
+	if (!silent && !returnVal) {
+		printf("LOFAR UDP Packet Replayer (v%s, lib v%s)\n\n", UPM_CLI_VERSION, UPM_VERSION);
+		printf("Replaying %d port(s) to %s:%d-%d", config->numPorts, host, basePort, basePort + config->numPorts - 1);
+		if (rate > 0.0) {
+			printf(" at %.1lf packets/s per port", rate);
+		}
+		printf("\n\n");
+	}
+
+	// Interleave the ports in batches, pacing each round against the requested packet rate
+	struct mmsghdr msgs[REPLAY_BATCH_SIZE];
+	struct iovec iovecs[REPLAY_BATCH_SIZE];
+	memset(msgs, 0, sizeof(msgs));
+	struct timespec tick, tock, start, target;
+	CLICK(tick);
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	int8_t anyActive = !returnVal;
+	int64_t rounds = 0;
+	while (anyActive && !returnVal) {
+		anyActive = 0;
+		for (int8_t port = 0; port < config->numPorts; port++) {
+			if (!portActive[port]) {
+				continue;
+			}
+
+			int64_t packets = (packetsMax - packetsSent[port]) < REPLAY_BATCH_SIZE ? (packetsMax - packetsSent[port]) : REPLAY_BATCH_SIZE;
+			packets = lofar_udp_io_read(input, port, buffers[port], packets * packetLength[port]) / packetLength[port];
+			if (packets < 1) {
+				portActive[port] = 0;
+				continue;
+			}
+
+			for (int32_t msg = 0; msg < packets; msg++) {
+				iovecs[msg].iov_base = &(buffers[port][msg * packetLength[port]]);
+				iovecs[msg].iov_len = packetLength[port];
+				msgs[msg].msg_hdr.msg_iov = &(iovecs[msg]);
+				msgs[msg].msg_hdr.msg_iovlen = 1;
+			}
+
+			int32_t sent = 0;
+			while (sent < packets) {
+				const uint32_t batchLength = (uint32_t) ((packets - sent) < REPLAY_BATCH_SIZE ? (packets - sent) : REPLAY_BATCH_SIZE);
+				const int32_t batchSent = sendmmsg(sockets[port], &(msgs[sent]), batchLength, 0);
+				if (batchSent < 0) {
+					// Loopback destinations without a listener report the ICMP rejection on the next send, keep going
+					if (errno == ECONNREFUSED || errno == EINTR) {
+						continue;
+					}
+					fprintf(stderr, "ERROR: Failed to send packets on port %d (errno %d: %s), exiting.\n", port, errno, strerror(errno));
+					returnVal = 1;
+					break;
+				}
+				sent += batchSent;
+			}
+			packetsSent[port] += sent;
+
+			portActive[port] = packetsSent[port] < packetsMax;
+			anyActive |= portActive[port];
+		}
+		rounds++;
+
+		if (rate > 0.0 && anyActive) {
+			const double elapsed = (double) (rounds * REPLAY_BATCH_SIZE) / rate;
+			target.tv_sec = start.tv_sec + (time_t) elapsed;
+			target.tv_nsec = start.tv_nsec + (long) ((elapsed - (double) ((time_t) elapsed)) * 1e9);
+			if (target.tv_nsec >= 1000000000L) {
+				target.tv_sec++;
+				target.tv_nsec -= 1000000000L;
+			}
+			clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, NULL);
+		}
+	}
+	CLICK(tock);
+
+	if (!silent && !returnVal) {
+		for (int8_t port = 0; port < config->numPorts; port++) {
+			printf("Port %d: sent %ld packets from %s to %s:%d\n", port, packetsSent[port], config->inputLocations[port], host, basePort + port);
+		}
+		printf("\nReplay completed in %.2fs.\n", TICKTOCK(tick, tock));
+	}
+
+	for (int8_t port = 0; port < config->numPorts; port++) {
+		if (sockets[port] > -1) {
+			close(sockets[port]);
+		}
+	}
+	lofar_udp_io_read_cleanup(input);
+	for (int8_t port = 0; port < config->numPorts; port++) {
+		FREE_NOT_NULL(buffers[port]);
+	}
+	lofar_udp_config_cleanup(config);
+	return returnVal;
+}
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
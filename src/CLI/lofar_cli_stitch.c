@@ -0,0 +1,149 @@
+#include "lofar_cli_meta.h"
+
+void helpMessages() {
+	printf("LOFAR UDP Shard Stitcher (CLI v%s, lib v%s)\n\n", UPM_CLI_VERSION, UPM_VERSION);
+	printf("Usage: lofar_udp_stitch <flags> <shard manifest> [<shard manifest> ...]");
+
+	printf("\n\n");
+
+	printf("Concatenate the part files written by the shards (-X) of a time-sharded extraction into a single set of outputs, using the manifests (<part file>%s) written by each shard.\n\n", UPM_SHARD_SUFFIX);
+
+	printf("-o: <format>	Output file name format (normal, FIFO or zstandard compressed outputs)\n");
+	printf("-f:		        Append output files if they already exist (default: Exit if exists)\n");
+	printf("-q:		        Enable silent mode for the CLI, don't print any information outside of library error messages (default: False)\n");
+	printf("-h:		        Print this help message\n");
+}
+
+static void CLICleanup(lofar_udp_io_write_config *outConfig, lofar_udp_shard *shards, int32_t numShards) {
+	if (shards != NULL) {
+		for (int32_t shard = 0; shard < numShards; shard++) {
+			lofar_udp_shard_free_outputs(&(shards[shard]));
+		}
+		free(shards);
+	}
+	lofar_udp_io_write_cleanup(outConfig, 1);
+}
+
+int main(int argc, char *argv[]) {
+
+	int32_t inputOpt;
+	int8_t silent = 0, outputProvided = 0;
+
+	lofar_udp_io_write_config *outConfig = lofar_udp_io_write_alloc();
+	if (outConfig == NULL) {
+		fprintf(stderr, "ERROR: Failed to allocate memory for configuration struct, exiting.\n");
+		return 1;
+	}
+
+	while ((inputOpt = getopt(argc, argv, "hfqo:")) != -1) {
+		switch (inputOpt) {
+
+			case 'o':
+				if (lofar_udp_io_write_parse_optarg(outConfig, optarg) < 0) {
+					helpMessages();
+					lofar_udp_io_write_cleanup(outConfig, 1);
+					return 1;
+				}
+				outputProvided = 1;
+				break;
+
+			case 'f':
+				outConfig->progressWithExisting = 1;
+				break;
+
+			case 'q':
+				silent = 1;
+				break;
+
+				// Silence GCC warnings, fall-through is the desired behaviour
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
+#pragma GCC diagnostic push
+			case '?':
+				if (optopt == 'o') {
+					fprintf(stderr, "Option '%c' requires an argument.\n", optopt);
+				} else {
+					fprintf(stderr, "Option '%c' is unknown or encountered an error.\n", optopt);
+				}
+
+			case 'h':
+			default:
+#pragma GCC diagnostic pop
+				helpMessages();
+				lofar_udp_io_write_cleanup(outConfig, 1);
+				return 1;
+		}
+	}
+
+	const int32_t numShards = argc - optind;
+	if (!outputProvided || numShards < 1) {
+		fprintf(stderr, "ERROR: An output and at least one shard manifest must be provided, exiting.\n");
+		helpMessages();
+		lofar_udp_io_write_cleanup(outConfig, 1);
+		return 1;
+	}
+
+	lofar_udp_shard *shards = calloc(numShards, sizeof(lofar_udp_shard));
+	if (shards == NULL) {
+		fprintf(stderr, "ERROR: Failed to allocate memory for shard manifests, exiting.\n");
+		lofar_udp_io_write_cleanup(outConfig, 1);
+		return 1;
+	}
+
+	for (int32_t shard = 0; shard < numShards; shard++) {
+		shards[shard] = lofar_udp_shard_default;
+	}
+
+	for (int32_t shard = 0; shard < numShards; shard++) {
+		if (lofar_udp_shard_load(&(shards[shard]), argv[optind + shard]) < 0) {
+			CLICleanup(outConfig, shards, numShards);
+			return 1;
+		}
+	}
+
+	if (!silent) {
+		printf("LOFAR UDP Shard Stitcher (v%s, lib v%s)\n\n", UPM_CLI_VERSION, UPM_VERSION);
+		printf("Stitching %d shards into %s...\n", numShards, outConfig->outputFormat);
+	}
+
+	struct timespec tick, tock;
+	CLICK(tick);
+	const int64_t droppedPackets = lofar_udp_shard_stitch(shards, numShards, outConfig);
+	CLICK(tock);
+
+	int32_t returnVal = 0;
+	if (droppedPackets < 0) {
+		fprintf(stderr, "ERROR: Failed to stitch shards (%ld), exiting.\n", droppedPackets);
+		returnVal = 1;
+	} else if (!silent) {
+		const lofar_udp_shard *lastShard = &(shards[numShards - 1]);
+		printf("Stitched packets %ld to %ld in %f seconds, a total of %ld packets were missed during the observation.\n", shards[0].firstPacket,
+		       lastShard->firstPacket + lastShard->packetsWritten, TICKTOCK(tick, tock), droppedPackets);
+		for (int8_t out = 0; out < outConfig->numOutputs; out++) {
+			printf("Output %d:\t%s\n", out, outConfig->outputLocations[out]);
+		}
+	}
+
+	CLICleanup(outConfig, shards, numShards);
+
+	return returnVal;
+}
+
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
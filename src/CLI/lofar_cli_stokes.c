@@ -27,13 +27,22 @@ void helpMessages() {
 	printf("-C: <factor>    Channelisation factor to apply when processing data (default: disabled == 1)\n");
 	printf("-d <factor>     Temporal downsampling to apply when processing data (default: disabled == 1)\n");
 	printf("-D              Apply temporal downsampling to spectral data (slower, but higher quality (default: disabled)\n");
+	printf("-X: <k>,<N>     Process shard k of N of the time range given by -t/-s, writing part files and a manifest for lofar_udp_stitch (default: disabled)\n");
+	printf("-A              Write outputs from a background thread while the next iteration is processed (default: False)\n");
+	printf("-F: <numSec>    Follow normal/zstandard inputs that are still being written, ending after N seconds without new data (default: 0, disabled)\n");
+	printf("-Z: <lo>,<hi>   Adapt the zstandard output compression level between lo and hi to keep up with the incoming data (default: disabled, fixed level)\n");
+	printf("-Y: <byte|bit>[,size] Byte or bit shuffle zstandard outputs before compression, in elements of size bytes (default: disabled, %d byte elements)\n", ZSTD_FILTER_ELEMENT_SIZE);
 
 }
 
-static void CLICleanup(lofar_udp_config *config, lofar_udp_io_write_config *outConfig, int8_t *header, fftwf_complex *X, fftwf_complex *Y) {
+static void CLICleanup(lofar_udp_config *config, lofar_udp_io_write_config *outConfig, int8_t *header, fftwf_complex *X, fftwf_complex *Y, lofar_udp_shard *shard) {
 
+	lofar_udp_shard_free_outputs(shard);
+	if (outConfig != NULL) {
+		_lofar_udp_io_write_free_outputs(outConfig);
+	}
 	FREE_NOT_NULL(outConfig);
-	FREE_NOT_NULL(config);
+	lofar_udp_config_cleanup(config);
 	FREE_NOT_NULL(header);
 
 
@@ -193,7 +202,10 @@ int main(int argc, char *argv[]) {
 	float seconds = 0.0f;
 	char inputTime[256] = "", stringBuff[128] = "", inputFormat[DEF_STR_LEN] = "";
 	int32_t silent = 0, inputProvided = 0, outputProvided = 0;
+	int8_t asyncWrite = 0;
 	int64_t maxPackets = LONG_MAX, startingPacket = -1, splitEvery = LONG_MAX;
+	int32_t shardIdx = -1, numShards = 0;
+	lofar_udp_shard shard = lofar_udp_shard_default;
 	int8_t clock200MHz = 1;
 
 	lofar_udp_config *config = lofar_udp_config_alloc();
@@ -203,7 +215,7 @@ int main(int argc, char *argv[]) {
 
 	if (config == NULL || outConfig == NULL) {
 		fprintf(stderr, "ERROR: Failed to allocate memory for configuration structs (something has gone very wrong...), exiting.\n");
-		FREE_NOT_NULL(config); FREE_NOT_NULL(outConfig);
+		CLICleanup(config, outConfig, NULL, NULL, NULL, &shard);
 		return 1;
 	}
 
@@ -216,6 +228,12 @@ int main(int argc, char *argv[]) {
 	double timing[TIMEARRLEN] = { 0.0 }, totalReadTime = 0., totalOpsTime = 0., totalWriteTime = 0., totalMetadataTime = 0., totalChanTime = 0., totalDetectTime = 0., totalDownsampleTime = 0.;
 	ARR_INIT(timing, TIMEARRLEN, 0.0);
 	struct timespec tick, tick0, tick1, tock, tock0, tock1, tickChan, tockChan, tickDown, tockDown, tickDetect, tockDetect;
+	// Outputs are indexed with int8_t, so INT8_MAX entries cover any writer
+	double outputTiming[INT8_MAX] = { 0. };
+
+	// Data for the Stokes outputs, written in parallel once their headers are out
+	int8_t *writeData[INT8_MAX] = { NULL };
+	int64_t writeLength[INT8_MAX] = { 0 };
 
 	// strtol / option checks
 	char *endPtr;
@@ -232,14 +250,14 @@ int main(int argc, char *argv[]) {
 	int8_t stokesParameters = 0, numStokes = 0;
 
 	// Standard ugly input flags parser
-	while ((inputOpt = getopt(argc, argv, "rzqfvVDhi:o:m:M:I:u:t:s:S:b:C:d:P:T:")) != -1) {
+	while ((inputOpt = getopt(argc, argv, "rzqfvVDAhi:o:m:M:I:u:t:s:S:b:C:d:P:T:X:F:Z:Y:")) != -1) {
 		input = 1;
 		switch (inputOpt) {
 
 			case 'i':
 				if (strncpy(inputFormat, optarg, DEF_STR_LEN - 1) != inputFormat) {
 					fprintf(stderr, "ERROR: Failed to store input data file format, exiting.\n");
-					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 					return 1;
 				}
 				inputProvided = 1;
@@ -249,7 +267,7 @@ int main(int argc, char *argv[]) {
 			case 'o':
 				if (lofar_udp_io_write_parse_optarg(outConfig, optarg) < 0) {
 					helpMessages();
-					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 					return 1;
 				}
 				if (config->metadata_config.metadataType == NO_META) config->metadata_config.metadataType = lofar_udp_metadata_parse_type_output(optarg);
@@ -268,7 +286,7 @@ int main(int argc, char *argv[]) {
 			case 'I':
 				if (strncpy(config->metadata_config.metadataLocation, optarg, DEF_STR_LEN) != config->metadata_config.metadataLocation) {
 					fprintf(stderr, "ERROR: Failed to copy metadata file location to config, exiting.\n");
-					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 					return 1;
 				}
 				break;
@@ -281,7 +299,7 @@ int main(int argc, char *argv[]) {
 			case 't':
 				if (strncpy(inputTime, optarg, 255) != inputTime) {
 					fprintf(stderr, "ERROR: Failed to copy start time from input, exiting.\n");
-					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 					return 1;
 				}
 				break;
@@ -296,10 +314,17 @@ int main(int argc, char *argv[]) {
 				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
 				break;
 
+			case 'X':
+				if (sscanf(optarg, "%d,%d", &shardIdx, &numShards) != 2) {
+					fprintf(stderr, "ERROR: Failed to parse shard (%s), expected <k>,<N>.\n", optarg);
+					flagged = 1;
+				}
+				break;
+
 			case 'b':
 				if (sscanf(optarg, "%hd,%hd", &(config->beamletLimits[0]), &(config->beamletLimits[1])) < 0) {
 					fprintf(stderr, "ERROR: Failed to scan input beamlets, exiting.\n");
-					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 					return 1;
 				}
 				break;
@@ -343,14 +368,31 @@ int main(int argc, char *argv[]) {
 				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
 				break;
 
+			case 'F':
+				config->followTimeout = strtof(optarg, &endPtr);
+				if (checkOpt(inputOpt, optarg, endPtr)) { flagged = 1; }
+				break;
+
+			case 'Z':
+				if (parseAdaptiveCompression(outConfig, optarg)) { flagged = 1; }
+				break;
+
+			case 'Y':
+				if (parseCompressionFilter(outConfig, optarg)) { flagged = 1; }
+				break;
+
 			case 'D':
 				spectralDownsample = 1;
 				break;
 
+			case 'A':
+				asyncWrite = 1;
+				break;
+
 			case 'P':
 				if (numStokes > 0) {
 					fprintf(stderr, "ERROR: -P flag has been parsed more than once. Exiting.\n");
-					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+					CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 					return -1;
 				}
 				if (strchr(optarg, 'I') != NULL) {
@@ -382,7 +424,7 @@ int main(int argc, char *argv[]) {
 			case '?':
 				if ((optopt == 'i') || (optopt == 'o') || (optopt == 'm') || (optopt == 'u') || (optopt == 't') ||
 				    (optopt == 's') || (optopt == 'e') || (optopt == 'p') || (optopt == 'a') || (optopt == 'c') ||
-				    (optopt == 'd') || (optopt == 'P')) {
+				    (optopt == 'd') || (optopt == 'P') || (optopt == 'X') || (optopt == 'F') || (optopt == 'Z') || (optopt == 'Y')) {
 					fprintf(stderr, "Option '%c' requires an argument.\n", optopt);
 				} else {
 					fprintf(stderr, "Option '%c' is unknown or encountered an error.\n", optopt);
@@ -394,7 +436,7 @@ int main(int argc, char *argv[]) {
 #pragma GCC diagnostic pop
 
 				helpMessages();
-				CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+				CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 				return 1;
 
 		}
@@ -405,21 +447,21 @@ int main(int argc, char *argv[]) {
 	config->processingMode = TIME_MAJOR_ANT_POL_FLOAT;
 
 	if (flagged) {
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
 	if (!input) {
 		fprintf(stderr, "ERROR: No inputs provided, exiting.\n");
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
 	if (!inputProvided) {
 		fprintf(stderr, "ERROR: An input was not provided, exiting.\n");
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
@@ -442,7 +484,7 @@ int main(int argc, char *argv[]) {
 	if ((config->packetsPerIteration * UDPNTIMESLICE) % (512 > channelisation ? 512 : channelisation)) {
 		fprintf(stderr, "ERROR: Number of samples needed per iterations for channelisation factor %d and downsampling factor %d (%d) is not a multiple of number of the set number of timesamples/packets per iteration (%ld), exiting.\n", channelisation, downsampling, (512 > channelisation ? 512 : channelisation), UDPNTIMESLICE * config->packetsPerIteration);
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
@@ -450,7 +492,7 @@ int main(int argc, char *argv[]) {
 	if (((long long) (channelisation * downsampling)) % config->packetsPerIteration != 0) {
 		fprintf(stderr, "ERROR: Number of packets per iteration is not evenly divisible by the number of samples needed to process at the given channelisation factor %ld and downsampling factor %ld (%ld, %ld remainder), exiting.\n", channelisation, downsampling, channelisation * downsampling, (channelisation * downsampling) % config->packetsPerIteration);
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 	*/
@@ -458,37 +500,37 @@ int main(int argc, char *argv[]) {
 	if (channelisation < 1 || ( channelisation > 1 && channelisation % 2) != 0) {
 		fprintf(stderr, "ERROR: Invalid channelisation factor (less than 1, non-factor of 2)\n");
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
 	if (downsampling < 1) {
 		fprintf(stderr, "ERROR: Invalid downsampling factor (less than 1)\n");
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
 	if (lofar_udp_io_read_parse_optarg(config, inputFormat) < 0) {
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
 	if (!outputProvided) {
 		fprintf(stderr, "ERROR: An output was not provided, exiting.\n");
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
 	if (config->calibrateData != NO_CALIBRATION && strcmp(config->metadata_config.metadataLocation, "") == 0) {
 		fprintf(stderr, "ERROR: Data calibration was enabled, but metadata was not provided. Exiting.\n");
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
 	// Sanity check a few inputs
-	if ((config->numPorts <= 0 || config->numPorts > MAX_NUM_PORTS) || // We are processing a sane number of ports
+	if ((config->numPorts <= 0 || config->numPorts > config->allocatedPorts) || // We are processing a sane number of ports
 	    (config->packetsPerIteration < 2) || // We are processing a sane number of packets
 	    (config->replayDroppedPackets > 1 || config->replayDroppedPackets < 0) || // Replay key was not malformed
 	    (config->processingMode > 1000 || config->processingMode < 0) ||
@@ -499,10 +541,37 @@ int main(int argc, char *argv[]) {
 
 		fprintf(stderr, "One or more inputs invalid or not fully initialised, exiting.\n");
 		helpMessages();
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
+	if (numShards != 0) {
+		if (numShards < 1 || shardIdx < 0 || shardIdx >= numShards) {
+			fprintf(stderr, "ERROR: Invalid shard %d of %d requested, exiting.\n", shardIdx, numShards);
+			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
+			return 1;
+		}
+
+		// Every shard must derive the same range and gulp boundaries from the command line alone
+		if (!strnlen(inputTime, 256) || seconds == 0.0) {
+			fprintf(stderr, "ERROR: Sharding (-X) requires a start time (-t) and a duration (-s), exiting.\n");
+			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
+			return 1;
+		}
+
+		// The stitch step reads the part files back, so they must be plain files
+		if (splitEvery != LONG_MAX || outConfig->readerType != NORMAL) {
+			fprintf(stderr, "ERROR: Sharding cannot be combined with output splitting (-S) or non-file outputs, exiting.\n");
+			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
+			return 1;
+		}
+
+		if (lofar_udp_shard_output_format(outConfig, shardIdx) < 0) {
+			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
+			return 1;
+		}
+	}
+
 
 	if (silent == 0) {
 		printf("LOFAR Stokes Data extractor (v%s, lib v%s)\n\n", UPM_CLI_VERSION, UPM_VERSION);
@@ -522,7 +591,7 @@ int main(int argc, char *argv[]) {
 		startingPacket = lofar_udp_time_get_packet_from_isot(inputTime, clock200MHz);
 		if (startingPacket == 1) {
 			helpMessages();
-			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 			return 1;
 		}
 	}
@@ -531,6 +600,14 @@ int main(int argc, char *argv[]) {
 		maxPackets = lofar_udp_time_get_packets_from_seconds(seconds, clock200MHz);
 	}
 
+	if (numShards != 0) {
+		if (lofar_udp_shard_range(startingPacket, maxPackets, config->packetsPerIteration, shardIdx, numShards, &startingPacket, &maxPackets) < 0) {
+			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
+			return 1;
+		}
+		if (silent == 0) { printf("Shard:\t\t%d/%d\n", shardIdx, numShards); }
+	}
+
 	if (silent == 0) { printf("Start Time:\t%s\t200MHz Clock:\t%d\n", inputTime, clock200MHz); }
 	if (silent == 0) {
 		printf("Initial Packet:\t%ld\t\tFinal Packet:\t%ld\n", startingPacket, startingPacket + maxPackets);
@@ -570,7 +647,7 @@ int main(int argc, char *argv[]) {
 	// Returns null on error, check
 	if (reader == NULL) {
 		fprintf(stderr, "Failed to generate reader. Exiting.\n");
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
@@ -578,13 +655,13 @@ int main(int argc, char *argv[]) {
 	if (((lofar_source_bytes *) &(reader->meta->inputData[0][1]))->clockBit != (unsigned int) clock200MHz) {
 		fprintf(stderr,
 		        "ERROR: The clock bit of the first packet does not match the clock state given when starting the CLI. Add or remove -c from your command. Exiting.\n");
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
 	if (reader->packetsPerIteration * UDPNTIMESLICE > INT32_MAX) {
 		fprintf(stderr, "ERROR: Input FFT bins are too long (%ld vs %d), exiting.\n", reader->packetsPerIteration * UDPNTIMESLICE, INT32_MAX);
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
@@ -600,7 +677,7 @@ int main(int argc, char *argv[]) {
 	fftwf_complex * in2 = NULL;
 	//printf("%d, %d, %d, %d\n", nbin, mbin, nsub, nchan);
 
-	float *outputStokes[MAX_OUTPUT_DIMS];
+	float *outputStokes[numStokes];
 
 	if (channelisation > 0) {
 		in1 = fftwf_alloc_complex(nbin * nsub * nfft);
@@ -610,7 +687,7 @@ int main(int argc, char *argv[]) {
 		intermediateY = fftwf_alloc_complex(nbin * nsub * nfft);
 		if (intermediateX == NULL || intermediateY == NULL) {
 			fprintf(stderr, "ERROR: Failed to allocate output FFTW buffers, exiting.\n");
-			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 			return -1;
 		}
 
@@ -651,7 +728,7 @@ int main(int argc, char *argv[]) {
 
 	// Get the starting packet for output file names, fix the packets per iteration if we dropped packets on the last iter
 	startingPacket = reader->meta->leadingPacket;
-	int64_t expectedWriteSize[MAX_OUTPUT_DIMS];
+	int64_t expectedWriteSize[numStokes];
 	// lofar_udp_io_write_setup_helper(lofar_udp_io_write_config *config, int64_t outputLength[], int8_t numOutputs, int32_t iter, int64_t firstPacket)
 	for (int8_t i = 0; i < numStokes; i++) {
 		expectedWriteSize[i] = reader->packetsPerIteration * UDPNTIMESLICE * reader->meta->totalProcBeamlets / downsampling * sizeof(float);
@@ -660,7 +737,24 @@ int main(int argc, char *argv[]) {
 	if ((returnVal = lofar_udp_io_write_setup_helper(outConfig, expectedWriteSize, numStokes, 0, startingPacket)) < 0) {
 		fprintf(stderr, "ERROR: Failed to open an output file (%ld, errno %d: %s), breaking.\n", returnVal, errno, strerror(errno));
 		returnValMeta = (returnValMeta < 0 && returnValMeta > -7) ? returnValMeta : -7;
-		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
+		return 1;
+	}
+
+	if (numShards != 0) {
+		if (lofar_udp_shard_setup(&shard, reader, outConfig, shardIdx, numShards) < 0) {
+			CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
+			return 1;
+		}
+		// The Stokes outputs are formed here rather than by the library
+		for (int8_t i = 0; i < numStokes; i++) {
+			shard.packetOutputLength[i] = UDPNTIMESLICE * reader->meta->totalProcBeamlets * (int64_t) sizeof(float) / downsampling;
+		}
+	}
+
+	if (asyncWrite && lofar_udp_io_write_async_setup(outConfig, ASYNC_WRITE_BUFFERS) < 0) {
+		fprintf(stderr, "ERROR: Failed to start the background writer, exiting.\n");
+		CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 		return 1;
 	}
 
@@ -740,6 +834,14 @@ int main(int argc, char *argv[]) {
 		}
 		printf("Finish downsampling %d\n", numStokes);
 
+		// Headers are written synchronously, so the previous iteration's data must be out before one is written
+		if (asyncWrite && lofar_udp_metadata_write_pending(reader->metadata, localLoops == 0) && lofar_udp_io_write_async_wait(outConfig) < 0) {
+			fprintf(stderr, "ERROR: Background write to output failed, breaking.\n");
+			returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+			break;
+		}
+
+		int8_t headerFailed = 0;
 		for (int8_t out = 0; out < numStokes; out++) {
 			printf("Enter loop\n");
 			if (reader->metadata != NULL) {
@@ -749,6 +851,7 @@ int main(int argc, char *argv[]) {
 					    0) {
 						fprintf(stderr, "ERROR: Failed to write header to output (%ld, errno %d: %s), breaking.\n", returnVal, errno, strerror(errno));
 						returnValMeta = (returnValMeta < 0 && returnValMeta > -4) ? returnValMeta : -4;
+						headerFailed = 1;
 						break;
 					}
 					CLICK(tock1);
@@ -757,26 +860,62 @@ int main(int argc, char *argv[]) {
 			}
 			printf("Sizing\n");
 
-			CLICK(tick0);
-			size_t outputLength = packetsToWrite * UDPNTIMESLICE * reader->meta->totalProcBeamlets / downsampling * sizeof(float);
+			writeData[out] = (int8_t *) outputStokes[out];
+			writeLength[out] = (int64_t) (packetsToWrite * UDPNTIMESLICE * reader->meta->totalProcBeamlets / downsampling * sizeof(float));
 			VERBOSE(printf("Writing %ld bytes (%ld packets) to disk for output %d...\n",
-			               outputLength, packetsToWrite, out));
-			size_t outputWritten;
-			printf("Writing...\n");
-			if ((outputWritten = lofar_udp_io_write(outConfig, out, (int8_t *) outputStokes[out],
-			                                        outputLength)) != outputLength) {
-				fprintf(stderr, "ERROR: Failed to write data to output (%ld bytes/%ld bytes writen, errno %d: %s)), breaking.\n", outputWritten, outputLength,  errno, strerror(errno));
+			               writeLength[out], packetsToWrite, out));
+		}
+
+		// Data must not be written behind a missing header
+		if (headerFailed) {
+			break;
+		}
+
+		// Every Stokes parameter is compressed and written at the same time, rather than one after another. Background writes
+		// are handed over in a pool buffer, as the working arrays are re-used by the next iteration.
+		if (returnValMeta > -4 && asyncWrite) {
+			CLICK(tick0);
+			for (int8_t out = 0; out < numStokes; out++) {
+				int8_t *buffer = lofar_udp_io_write_async_buffer(outConfig, out);
+				if (buffer == NULL) {
+					fprintf(stderr, "ERROR: Failed to get a buffer for output %d, breaking.\n", out);
+					returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+					break;
+				}
+				memcpy(buffer, writeData[out], writeLength[out]);
+				if (lofar_udp_io_write_async_submit(outConfig, out, buffer, writeLength[out], NULL, NULL) < 0) {
+					fprintf(stderr, "ERROR: Background write to output %d failed, breaking.\n", out);
+					returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+					break;
+				}
+				shard.outputBytes[out] += writeLength[out];
+			}
+			CLICK(tock0);
+			timing[3] += TICKTOCK(tick0, tock0);
+		} else if (returnValMeta > -4) {
+			CLICK(tick0);
+			if (lofar_udp_io_write_all(outConfig, writeData, writeLength, outputTiming) < 0) {
+				fprintf(stderr, "ERROR: Failed to write data to outputs (errno %d: %s), breaking.\n", errno, strerror(errno));
 				returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
 				break;
 			}
+			for (int8_t out = 0; out < numStokes; out++) {
+				shard.outputBytes[out] += writeLength[out];
+			}
 			CLICK(tock0);
 			timing[3] += TICKTOCK(tick0, tock0);
-
 		}
 
 		if (splitEvery != LONG_MAX && returnValMeta > -2) {
 			if (!((localLoops + 1) % splitEvery)) {
 				if (!silent) printf("Hit splitting condition; closing writers and re-opening for iteration %ld.\n", localLoops / splitEvery);
+				// Background writes must complete before their files are closed
+				if (asyncWrite && lofar_udp_io_write_async_wait(outConfig) < 0) {
+					fprintf(stderr, "ERROR: Background write to output failed, breaking.\n");
+					returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+					break;
+				}
+
 				// Close existing files
 				lofar_udp_io_write_cleanup(outConfig, 0);
 
@@ -799,6 +938,9 @@ int main(int argc, char *argv[]) {
 		if (silent == 0) {
 			if (reader->metadata != NULL) if (reader->metadata->type != NO_META) printf("Metadata processing for operation %d after %f seconds.\n", loops, timing[2]);
 			printf("Disk writes completed for operation %d (%d) after %f seconds.\n", loops, localLoops, timing[3]);
+			for (int8_t out = 0; out < numStokes && !asyncWrite; out++) {
+				printf("\tOutput %d: %f seconds (%.01lf MB/s)\n", out, outputTiming[out], (double) writeLength[out] / 1e+6 / outputTiming[out]);
+			}
 			printf("Detection completed for operation %d after %f seconds.\n", loops, timing[5]);
 			if (channelisation) printf("Channelisation completed for operation %d after %f seconds.\n", loops, timing[4]);
 			if (downsampling) printf("Temporal downsampling completed for operation %d after %f seconds.\n", loops, timing[6]);
@@ -837,6 +979,12 @@ int main(int argc, char *argv[]) {
 
 	}
 
+	// Make sure the outputs are complete before they are described or closed
+	if (asyncWrite && lofar_udp_io_write_async_wait(outConfig) < 0) {
+		fprintf(stderr, "ERROR: Background write to output failed.\n");
+		returnValMeta = (returnValMeta < 0 && returnValMeta > -5) ? returnValMeta : -5;
+	}
+
 	fftwf_destroy_plan(fftForwardX);
 	fftwf_destroy_plan(fftForwardY);
 	fftwf_destroy_plan(fftBackwardX);
@@ -846,6 +994,20 @@ int main(int argc, char *argv[]) {
 
 	CLICK(tock);
 
+	// Describe the shard for the stitch step, unless the outputs are incomplete
+	if (numShards != 0 && returnValMeta > -4) {
+		char shardLocation[DEF_STR_LEN];
+		shard.packetsWritten = packetsWritten;
+		for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+			shard.droppedPackets += reader->meta->portTotalDroppedPackets[port];
+		}
+		if (lofar_udp_shard_get_location(shardLocation, outConfig->outputLocations[0]) < 0 || lofar_udp_shard_write(&shard, shardLocation) < 0) {
+			fprintf(stderr, "ERROR: Failed to write the shard manifest, the part files cannot be stitched.\n");
+		} else if (silent == 0) {
+			printf("Shard %d/%d manifest written to %s\n", shardIdx, numShards, shardLocation);
+		}
+	}
+
 	int64_t droppedPackets = 0, totalPacketLength = 0, totalOutLength = 0;
 
 	// Print out a summary of the operations performed, this does not contain data read for seek operations
@@ -873,6 +1035,7 @@ int main(int argc, char *argv[]) {
 		       (double) (packetsWritten * totalOutLength) / 1e+6 / totalWriteTime);
 		printf("Approximate Throughput:\t%3.01lf GB/s\n", (double) (reader->meta->numPorts * packetsProcessed * (totalPacketLength + totalOutLength)) / 1e+9 / totalOpsTime);
 		printf("A total of %ld packets were missed during the observation.\n", droppedPackets);
+		printCompressionLevels(outConfig);
 		printf("\n\nData processing finished. Cleaning up file and memory objects...\n");
 	}
 
@@ -887,7 +1050,7 @@ int main(int argc, char *argv[]) {
 	outConfig = NULL;
 
 	// Free our malloc'd objects
-	CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY);
+	CLICleanup(config, outConfig, headerBuffer, intermediateX, intermediateY, &shard);
 
 	if (silent == 0) { printf("CLI memory cleaned up successfully. Exiting.\n"); }
 	return 0;
@@ -39,19 +39,11 @@ _lofar_udp_io_read_setup_DADA(lofar_udp_io_read_config *const input, const key_t
 		return -3;
 	}
 
-	// Register ourselfs as the active reader
+	// Register ourselfs as the active reader, this is held until cleanup so that reads can access the data blocks directly
 	if (dada_hdu_lock_read(input->dadaReader[port])) {
 		return -4;
 	}
 
-	// If we are restarting, align to the expected packet length
-	if ((ipcio_tell(input->dadaReader[port]->data_block) % input->portPacketLength[port]) != 0) {
-		if (ipcio_seek(input->dadaReader[port]->data_block,
-		               input->portPacketLength[port] - (int64_t) (ipcio_tell(input->dadaReader[port]->data_block) % input->portPacketLength[port]), SEEK_CUR) < 0) {
-			return -5;
-		}
-	}
-
 	input->dadaPageSize[port] = (int64_t) ipcbuf_get_bufsz((ipcbuf_t *) input->dadaReader[port]->data_block);
 	if (input->dadaPageSize[port] < 1) {
 		fprintf(stderr, "ERROR: Failed to get PSRDADA buffer size on ringbuffer %d for port %d, exiting.\n", dadaKey,
@@ -59,9 +51,13 @@ _lofar_udp_io_read_setup_DADA(lofar_udp_io_read_config *const input, const key_t
 		return -6;
 	}
 
-	// Remove our reader status until we need to perform a read
-	if (dada_hdu_unlock_read(input->dadaReader[port])) {
-		return -7;
+	// If we are restarting, align to the expected packet length by skipping the start of the first block
+	input->dadaBlock[port] = NULL;
+	input->dadaBlockSize[port] = 0;
+	input->dadaBlockOffset[port] = 0;
+	const int64_t packetOffset = (int64_t) (ipcio_tell(input->dadaReader[port]->data_block) % input->portPacketLength[port]);
+	if (packetOffset != 0) {
+		input->dadaBlockOffset[port] = input->portPacketLength[port] - packetOffset;
 	}
 
 	return 0;
@@ -73,7 +69,162 @@ _lofar_udp_io_read_setup_DADA(lofar_udp_io_read_config *const input, const key_t
 }
 
 /**
- * @brief      Perform a data read for a ringbuffer
+ * @brief      Make sure the reader holds a data block with unread data, releasing the current block back to the writer once
+ * 				it has been fully consumed
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base file
+ *
+ * @return     >0: Bytes remaining in the current block, 0: End of data, <0: Failure
+ */
+static int64_t _lofar_udp_io_read_DADA_next_block(lofar_udp_io_read_config *const input, const int8_t port) {
+#ifndef NODADA
+	ipcio_t *dataBlock = input->dadaReader[port]->data_block;
+
+	if (input->dadaBlock[port] != NULL) {
+		if (input->dadaBlockOffset[port] < input->dadaBlockSize[port]) {
+			return input->dadaBlockSize[port] - input->dadaBlockOffset[port];
+		}
+
+		if (ipcio_close_block_read(dataBlock, input->dadaBlockSize[port]) < 0) {
+			fprintf(stderr, "ERROR: Failed to release PSRDADA block on port %d, exiting.\n", port);
+			return -1;
+		}
+		input->dadaBlock[port] = NULL;
+		input->dadaBlockOffset[port] = 0;
+	}
+
+	if (ipcbuf_eod((ipcbuf_t *) dataBlock)) {
+		return 0;
+	}
+
+	// Any offset left over from setup is the packet alignment, and applies to the first block
+	uint64_t blockSize = 0, blockId = 0;
+	input->dadaBlock[port] = (int8_t *) ipcio_open_block_read(dataBlock, &blockSize, &blockId);
+	if (input->dadaBlock[port] == NULL) {
+		// An unavailable block after the end of data has been marked is the end of the stream rather than a failure
+		return ipcbuf_eod((ipcbuf_t *) dataBlock) ? 0 : -1;
+	}
+	input->dadaBlockSize[port] = (int64_t) blockSize;
+
+	// Blocks too short to reach the alignment offset are skipped entirely
+	if (input->dadaBlockOffset[port] >= input->dadaBlockSize[port]) {
+		input->dadaBlockOffset[port] -= input->dadaBlockSize[port];
+		input->dadaBlockSize[port] = 0;
+		return _lofar_udp_io_read_DADA_next_block(input, port);
+	}
+
+	return input->dadaBlockSize[port] - input->dadaBlockOffset[port];
+#else
+	fprintf(stderr, "ERROR %s: PSRDADA was disable at compile time, exiting.\n", __func__);
+	return -1;
+#endif
+}
+
+/**
+ * @brief      Attempt to attach the next data block over the input buffer, rather than copying it in
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     >0: Bytes attached, 0: The read must be copied instead, <0: Failure
+ */
+static int64_t _lofar_udp_io_read_DADA_attach(lofar_udp_io_read_config *const input, const int8_t port, int8_t *const targetArray, const int64_t nchars) {
+#ifndef NODADA
+	ipcio_t *dataBlock = input->dadaReader[port]->data_block;
+	ipcbuf_t *ringbuffer = (ipcbuf_t *) dataBlock;
+
+	// ipcio only lends a reader one block at a time, so only gulps of exactly one page aligned block read to the head of
+	// the buffer can be attached. The block is modified in place by the processing kernels, so we must be the only reader.
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	if (targetArray != input->inputWindow[port] || nchars != input->dadaPageSize[port] || nchars > input->inputWindowSize[port] ||
+		pageSize < 1 || nchars % pageSize != 0 || input->dadaCarryLength[port] > 0 || ipcbuf_get_nreaders(ringbuffer) != 1) {
+		return 0;
+	}
+
+	// The next block must start at the head of the gulp: the current block is fully consumed, and no alignment offset is pending
+	if ((input->dadaBlock[port] != NULL && input->dadaBlockOffset[port] < input->dadaBlockSize[port]) ||
+		(input->dadaBlock[port] == NULL && input->dadaBlockOffset[port] != 0)) {
+		return 0;
+	}
+
+	// Releases the previous block; nothing before the head of the buffer is kept, so it is safe to drop it here
+	const int64_t available = _lofar_udp_io_read_DADA_next_block(input, port);
+	if (available != nchars) {
+		return (available < 0) ? -1 : 0;
+	}
+
+	int32_t shmid = -1;
+	const uint64_t nbufs = ipcbuf_get_nbufs(ringbuffer);
+	for (uint64_t i = 0; i < nbufs; i++) {
+		if (ringbuffer->buffer[i] == (char *) input->dadaBlock[port]) {
+			shmid = ringbuffer->shmid[i];
+			break;
+		}
+	}
+
+	// Anything we fail to attach is still held open, and will be copied instead
+	if (shmid < 0 || shmat(shmid, input->inputWindow[port], SHM_REMAP) == (void *) -1) {
+		VERBOSE(printf("%s: Failed to attach block on port %d (shmid %d, errno %d), falling back to copies.\n", __func__, port, shmid, errno));
+		return 0;
+	}
+	input->inputWindowMapStart[port] = input->inputWindow[port];
+	input->inputWindowMapLength[port] = nchars;
+
+	// The block is now consumed, it is returned to the writer when the next block is needed (after it has been processed)
+	input->dadaBlockOffset[port] = input->dadaBlockSize[port];
+	return nchars;
+#else
+	return -1;
+#endif
+}
+
+/**
+ * @brief      Copy data out of the ringbuffer, starting with any data held in the carry-over buffer
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     >=0: Bytes read, <0: Failure before any data was read
+ */
+static int64_t _lofar_udp_io_read_DADA_copy(lofar_udp_io_read_config *const input, const int8_t port, int8_t *const targetArray, const int64_t nchars) {
+	int64_t dataRead = 0;
+
+	if (input->dadaCarryLength[port] > 0) {
+		dataRead = (input->dadaCarryLength[port] < nchars) ? input->dadaCarryLength[port] : nchars;
+		memcpy(targetArray, &(input->dadaCarry[port][input->dadaCarryOffset[port]]), dataRead);
+		input->dadaCarryOffset[port] += dataRead;
+		input->dadaCarryLength[port] -= dataRead;
+	}
+
+	while (dataRead < nchars) {
+		const int64_t available = _lofar_udp_io_read_DADA_next_block(input, port);
+		if (available < 1) {
+			if (available < 0) {
+				fprintf(stderr, "ERROR: Failed to complete DADA read on port %d (%ld / %ld), returning partial data.\n", port, dataRead, nchars);
+				if (dataRead == 0) {
+					return -1;
+				}
+			}
+			break;
+		}
+
+		const int64_t readLength = (available < (nchars - dataRead)) ? available : (nchars - dataRead);
+		memcpy(&(targetArray[dataRead]), &(input->dadaBlock[port][input->dadaBlockOffset[port]]), readLength);
+		input->dadaBlockOffset[port] += readLength;
+		dataRead += readLength;
+	}
+
+	return dataRead;
+}
+
+/**
+ * @brief      Perform a data read for a ringbuffer, attaching whole data blocks to the reader's input buffer when the gulp
+ * 				matches the block size, and copying directly out of the shared memory data blocks otherwise
  *
  * @param      input        The input
  * @param[in]  port         The index offset from the base file
@@ -87,46 +238,127 @@ int64_t _lofar_udp_io_read_DADA(lofar_udp_io_read_config *const input, const int
 
 	VERBOSE(printf("reader_nchars: Entering read request (dada): %d, %d, %ld\n", port, input->inputDadaKeys[port], nchars));
 
-	int64_t dataRead = 0, currentRead;
+	if (input->inputWindow[port] != NULL) {
+		const int64_t attached = _lofar_udp_io_read_DADA_attach(input, port, targetArray, nchars);
+		if (attached != 0) {
+			return attached;
+		}
 
-	// To prevent a lock-up when we call ipcio_stop, read the data in gulps
-	int64_t readChars = ((dataRead + input->dadaPageSize[port]) > nchars) ? (nchars - dataRead)
-																	   : input->dadaPageSize[port];
-	// Register as the active reader
-	if (dada_hdu_lock_read(input->dadaReader[port])) {
+		// Copies must not land in an attached block, so swap it back out for private memory, keeping any carried packets
+		if (_lofar_udp_io_read_window_detach(input, port, targetArray) < 0) {
+			return -1;
+		}
+	}
+
+	return _lofar_udp_io_read_DADA_copy(input, port, targetArray, nchars);
+
+#else
+	// Raise an error if PSRDADA wasn't available at compile time
+	fprintf(stderr, "ERROR %s: PSRDADA was disable at compile time, exiting.\n", __func__);
+	return -1;
+
+#endif
+}
+
+/**
+ * @brief      Wait for data in a ringbuffer and return a pointer to it. Requests that fit in the current data block point
+ * 				straight into the shared memory block, requests that span the edge of a block are assembled in the carry-over
+ * 				buffer.
+ *
+ * @param      input   The input
+ * @param[in]  port    The index offset from the base file
+ * @param      data    The start of the data (read-only, valid until it is released)
+ * @param[in]  nchars  The number of bytes to wait for
+ *
+ * @return     >=0: bytes available at data (less than nchars at the end of the data), <0: Failure
+ */
+int64_t _lofar_udp_io_read_acquire_DADA(lofar_udp_io_read_config *const input, const int8_t port, const int8_t **data, const int64_t nchars) {
+#ifndef NODADA
+	if (input->dadaReader[port] == NULL) {
+		fprintf(stderr, "ERROR %s: Ringbuffer on port %d has not been setup, exiting.\n", __func__, port);
 		return -1;
 	}
-	// Loop until we read the requested amount of data
-	while (dataRead < nchars) {
-		if ((currentRead = ipcio_read(input->dadaReader[port]->data_block, (char *) &(targetArray[dataRead]), readChars)) < 1) {
-			fprintf(stderr, "ERROR: Failed to complete DADA read on port %d (%ld / %ld), returning partial data.\n",
-					port, dataRead, nchars);
-			// Return -1 if we haven't read anything
-			//return (dataRead > 0) ? dataRead : -1;
-			// If this read fails at the start of a read, return the error, otherwise return the data read so far.
-			if (dataRead == 0) {
-				dada_hdu_unlock_read(input->dadaReader[port]);
-				return -1;
-			} else {
-				break;
-			}
+
+	if (input->dadaCarryLength[port] == 0) {
+		const int64_t available = _lofar_udp_io_read_DADA_next_block(input, port);
+		if (available < 0) {
+			return -1;
+		}
+
+		if (available >= nchars || available == 0) {
+			*data = (available == 0) ? NULL : &(input->dadaBlock[port][input->dadaBlockOffset[port]]);
+			return available;
+		}
+	}
+
+	// Move any data still held to the start of the carry-over buffer, then fill the rest from the blocks
+	if (input->dadaCarrySize[port] < nchars) {
+		int8_t *tmp = realloc(input->dadaCarry[port], nchars);
+		if (tmp == NULL) {
+			fprintf(stderr, "ERROR %s: Failed to allocate %ld byte carry-over buffer on port %d, exiting.\n", __func__, nchars, port);
+			return -1;
+		}
+		input->dadaCarry[port] = tmp;
+		input->dadaCarrySize[port] = nchars;
+	}
+	if (input->dadaCarryOffset[port] > 0 && input->dadaCarryLength[port] > 0) {
+		memmove(input->dadaCarry[port], &(input->dadaCarry[port][input->dadaCarryOffset[port]]), input->dadaCarryLength[port]);
+	}
+	input->dadaCarryOffset[port] = 0;
+
+	if (input->dadaCarryLength[port] < nchars) {
+		// The copy always starts with the carry-over data, which is moved back in place below
+		const int64_t held = input->dadaCarryLength[port];
+		input->dadaCarryLength[port] = 0;
+		const int64_t readLength = _lofar_udp_io_read_DADA_copy(input, port, &(input->dadaCarry[port][held]), nchars - held);
+		if (readLength < 0 && held == 0) {
+			return -1;
 		}
-		dataRead += currentRead;
-		readChars = ((dataRead + input->dadaPageSize[port]) > nchars) ? (nchars - dataRead) : input->dadaPageSize[port];
+		input->dadaCarryLength[port] = held + ((readLength > 0) ? readLength : 0);
+	}
+
+	*data = input->dadaCarry[port];
+	return (input->dadaCarryLength[port] < nchars) ? input->dadaCarryLength[port] : nchars;
+#else
+	fprintf(stderr, "ERROR %s: PSRDADA was disable at compile time, exiting.\n", __func__);
+	return -1;
+#endif
+}
+
+/**
+ * @brief      Release data acquired in place from a ringbuffer
+ *
+ * @param      input   The input
+ * @param[in]  port    The index offset from the base file
+ * @param[in]  nchars  The number of bytes consumed (at most the length of the last acquire)
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_release_DADA(lofar_udp_io_read_config *const input, const int8_t port, const int64_t nchars) {
+#ifndef NODADA
+	if (input->dadaReader[port] == NULL) {
+		fprintf(stderr, "ERROR %s: Ringbuffer on port %d has not been setup, exiting.\n", __func__, port);
+		return -1;
 	}
 
-	// Unlock the ringbuffer
-	if (dada_hdu_unlock_read(input->dadaReader[port])) {
+	const int64_t held = (input->dadaCarryLength[port] > 0) ? input->dadaCarryLength[port] : (input->dadaBlock[port] != NULL ? input->dadaBlockSize[port] - input->dadaBlockOffset[port] : 0);
+	if (nchars < 0 || nchars > held) {
+		fprintf(stderr, "ERROR %s: Cannot release %ld bytes on port %d, only %ld are held, exiting.\n", __func__, nchars, port, held);
 		return -1;
 	}
 
-	return dataRead;
+	if (input->dadaCarryLength[port] > 0) {
+		input->dadaCarryOffset[port] += nchars;
+		input->dadaCarryLength[port] -= nchars;
+		return 0;
+	}
 
+	// Blocks are only returned to the writer once the next one is needed, so that a release never waits on the writer
+	input->dadaBlockOffset[port] += nchars;
+	return 0;
 #else
-	// Raise an error if PSRDADA wasn't available at compile time
 	fprintf(stderr, "ERROR %s: PSRDADA was disable at compile time, exiting.\n", __func__);
 	return -1;
-
 #endif
 }
 
@@ -142,6 +374,17 @@ void _lofar_udp_io_read_cleanup_DADA(lofar_udp_io_read_config *const input, cons
 		return;
 	}
 	if (input->dadaReader[port] != NULL) {
+		// Return the block we are holding and give up our reader status
+		if (input->dadaBlock[port] != NULL) {
+			if (ipcio_close_block_read(input->dadaReader[port]->data_block, input->dadaBlockSize[port]) < 0) {
+				fprintf(stderr, "ERROR: Failed to release PSRDADA block on port %d.\n", port);
+			}
+			input->dadaBlock[port] = NULL;
+		}
+		if (dada_hdu_unlock_read(input->dadaReader[port]) < 0) {
+			fprintf(stderr, "ERROR: Failed to unlock PSRDADA buffer %d on port %d.\n", input->inputDadaKeys[port], port);
+		}
+
 		// Cleanup PSRDADA leaks
 		FREE_NOT_NULL(input->dadaReader[port]->data_block->buf_ptrs);
 		FREE_NOT_NULL(input->dadaReader[port]->data_block->buf.shm_addr);
@@ -160,6 +403,10 @@ void _lofar_udp_io_read_cleanup_DADA(lofar_udp_io_read_config *const input, cons
 		input->multilog[port] = NULL; // multilog_close frees the ptr;
 	}
 	input->dadaPageSize[port] = -1;
+	FREE_NOT_NULL(input->dadaCarry[port]);
+	input->dadaCarrySize[port] = 0;
+	input->dadaCarryOffset[port] = 0;
+	input->dadaCarryLength[port] = 0;
 #endif
 }
 
@@ -442,6 +689,92 @@ int64_t _lofar_udp_io_write_DADA(ipcio_t *const ringbuffer, const int8_t *src, c
 }
 
 
+/**
+ * @brief      Open the next data block of a ringbuffer as the active writer, so that data can be generated in place
+ *
+ * @param      config  The configuration
+ * @param[in]  outp    The output index
+ * @param      data    The start of the data block
+ * @param[in]  nchars  The number of bytes that will be written
+ *
+ * @return     >=nchars: Size of the block at data, <0: Failure
+ */
+int64_t _lofar_udp_io_write_acquire_DADA(lofar_udp_io_write_config *const config, const int8_t outp, int8_t **data, const int64_t nchars) {
+#ifndef NODADA
+	if (config->dadaWriter[outp].hdu == NULL) {
+		fprintf(stderr, "ERROR %s: Ringbuffer on output %d has not been setup, exiting.\n", __func__, outp);
+		return -1;
+	}
+
+	ipcio_t *ringbuffer = config->dadaWriter[outp].hdu->data_block;
+	if (config->dadaWriter[outp].block == NULL) {
+		// Open as the active writer, this is held until the block is committed
+		if (ipcio_open(ringbuffer, 'W') < 0) {
+			return -1;
+		}
+
+		uint64_t blockId = 0;
+		config->dadaWriter[outp].block = (int8_t *) ipcio_open_block_write(ringbuffer, &blockId);
+		if (config->dadaWriter[outp].block == NULL) {
+			fprintf(stderr, "ERROR %s: Failed to open a data block on output %d, exiting.\n", __func__, outp);
+			ipcio_close(ringbuffer);
+			return -1;
+		}
+		config->dadaWriter[outp].blockSize = (int64_t) ipcbuf_get_bufsz((ipcbuf_t *) ringbuffer);
+	}
+
+	if (config->dadaWriter[outp].blockSize < nchars) {
+		fprintf(stderr, "ERROR %s: Requested %ld bytes on output %d, but blocks only hold %ld bytes, exiting.\n", __func__, nchars, outp, config->dadaWriter[outp].blockSize);
+		return -1;
+	}
+
+	*data = config->dadaWriter[outp].block;
+	return config->dadaWriter[outp].blockSize;
+#else
+	fprintf(stderr, "ERROR %s: PSRDADA was disable at compile time, exiting.\n", __func__);
+	return -1;
+#endif
+}
+
+/**
+ * @brief      Mark the data block opened by _lofar_udp_io_write_acquire_DADA() as filled and release the writer
+ *
+ * @param      config  The configuration
+ * @param[in]  outp    The output index
+ * @param[in]  nchars  The number of bytes written to the block
+ *
+ * @return     >=0: Number of bytes written, <0: Failure
+ */
+int64_t _lofar_udp_io_write_commit_DADA(lofar_udp_io_write_config *const config, const int8_t outp, const int64_t nchars) {
+#ifndef NODADA
+	if (config->dadaWriter[outp].hdu == NULL || config->dadaWriter[outp].block == NULL) {
+		fprintf(stderr, "ERROR %s: No data block is held on output %d, exiting.\n", __func__, outp);
+		return -1;
+	}
+
+	if (nchars > config->dadaWriter[outp].blockSize) {
+		fprintf(stderr, "ERROR %s: Cannot commit %ld bytes on output %d, only %ld are held, exiting.\n", __func__, nchars, outp, config->dadaWriter[outp].blockSize);
+		return -1;
+	}
+
+	ipcio_t *ringbuffer = config->dadaWriter[outp].hdu->data_block;
+	const int32_t closeBlock = (int32_t) ipcio_close_block_write(ringbuffer, (uint64_t) nchars);
+	config->dadaWriter[outp].block = NULL;
+	config->dadaWriter[outp].blockSize = 0;
+
+	// Unlock the buffer and continue
+	if (ipcio_close(ringbuffer) < 0 || closeBlock < 0) {
+		return -1;
+	}
+
+	return nchars;
+#else
+	fprintf(stderr, "ERROR %s: PSRDADA was disable at compile time, exiting.\n", __func__);
+	return -1;
+#endif
+}
+
+
 /**
  * @brief      Cleanup ringbuffer references for the write I/O struct
  *
@@ -458,6 +791,11 @@ void _lofar_udp_io_write_cleanup_DADA(lofar_udp_io_write_config *const config, c
 	// PSRDADA assumes we still have the header open for writing, doing this will silence an error
 	// ... but doing this causes the ringbuffer to not exist for the reader???
 	if (config->dadaWriter[outp].hdu != NULL) {
+		// Return a block still held by an in-place writer without any data
+		if (config->dadaWriter[outp].block != NULL) {
+			_lofar_udp_io_write_commit_DADA(config, outp, 0);
+		}
+
 		if (!ipcbuf_is_writer(config->dadaWriter[outp].hdu->header_block)) {
 			ipcbuf_lock_write(config->dadaWriter[outp].hdu->header_block);
 		}
@@ -1,4 +1,18 @@
 
+// Multi-file NORMAL inputs: the files matching a pattern, read back to back as a single stream
+struct lofar_udp_io_file_list {
+	int32_t numFiles;
+	int32_t currentFile;
+	char (*files)[DEF_STR_LEN + 1];
+
+	// Offset of each file in the concatenated stream, and the number of bytes used from each file (whole packets)
+	int64_t *fileStart;
+	int64_t *fileLength;
+
+	// The following file, opened and requested from the disk before the reader reaches the end of the current file
+	FILE *nextFileRef;
+};
+
 // Read interface
 
 /**
@@ -11,6 +25,14 @@
  * @return     0: Success, <0: Failure
  */
 int32_t _lofar_udp_io_read_setup_FILE(lofar_udp_io_read_config *const input, const char *inputLocation, const int8_t port) {
+	// Patterns are expanded to a list of files, which are read back to back from the first match
+	if (input->readerType == NORMAL && _lofar_udp_io_read_FILE_is_list(inputLocation)) {
+		if (_lofar_udp_io_read_setup_FILE_list(input, inputLocation, port) < 0) {
+			return -1;
+		}
+		inputLocation = input->fileList[port]->files[0];
+	}
+
 	VERBOSE(printf("Opening file at %s for port %d\n", inputLocation, port));
 
 	input->fileRef[port] = fopen(inputLocation, "rb");
@@ -19,6 +41,458 @@ int32_t _lofar_udp_io_read_setup_FILE(lofar_udp_io_read_config *const input, con
 		return -1;
 	}
 
+	// Only regular files can be advised on, pipes are left to the kernel
+	struct stat fileStat;
+	input->inputAdvised[port] = -1;
+	input->inputEvicted[port] = 0;
+	if (input->readerType != FIFO && fstat(fileno(input->fileRef[port]), &fileStat) == 0 && S_ISREG(fileStat.st_mode)) {
+		input->inputAdvised[port] = 0;
+		// Doubles the kernel's read-ahead for the file, our own window is requested on top of this as data are read
+		posix_fadvise(fileno(input->fileRef[port]), 0, 0, POSIX_FADV_SEQUENTIAL);
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief      Manage the page cache around the read head of a file: request the window ahead of the reader, and evict
+ *             the data behind it, so that long runs do not fill the page cache with data that will not be read again.
+ *             Both operations are only performed once the reader has moved a full FILE_EVICT_BLOCK_SIZE, so that the
+ *             cost of each call does not grow with the length of the run.
+ *
+ * @param      input     The input
+ * @param[in]  port      The index offset from the base file
+ * @param      mapping   A memory mapping of the file, NULL if the file is not mapped
+ * @param[in]  position  The current byte offset of the read head
+ */
+void _lofar_udp_io_read_advise_FILE(lofar_udp_io_read_config *const input, const int8_t port, void *mapping, const int64_t position) {
+	if (input->inputAdvised[port] < 0 || input->fileRef[port] == NULL || position < 0) {
+		return;
+	}
+	const int32_t fd = fileno(input->fileRef[port]);
+	int32_t returnVal;
+
+	// Top up the read-ahead window once a block of it has been consumed
+	if ((position + FILE_READ_AHEAD_SIZE - FILE_EVICT_BLOCK_SIZE) >= input->inputAdvised[port]) {
+		const int64_t adviseStart = position > input->inputAdvised[port] ? position : input->inputAdvised[port];
+		const int64_t adviseEnd = position + FILE_READ_AHEAD_SIZE;
+		if ((returnVal = posix_fadvise(fd, (off_t) adviseStart, (off_t) (adviseEnd - adviseStart), POSIX_FADV_WILLNEED)) != 0) {
+			fprintf(stderr, "WARNING: Failed to request read-ahead on port %d (errno %d: %s), continuing.\n", port, returnVal, strerror(returnVal));
+		}
+		input->inputAdvised[port] = adviseEnd;
+	}
+
+	// Evict whole blocks, keeping the block behind the read head for short seeks / re-reads
+	const int64_t evictLimit = ((position - FILE_EVICT_BLOCK_SIZE) / FILE_EVICT_BLOCK_SIZE) * FILE_EVICT_BLOCK_SIZE;
+	if (evictLimit > input->inputEvicted[port]) {
+		const int64_t evictLength = evictLimit - input->inputEvicted[port];
+		// Mapped pages are not dropped from the page cache while they are still mapped, release our references first
+		if (mapping != NULL && madvise((int8_t *) mapping + input->inputEvicted[port], evictLength, MADV_DONTNEED) < 0) {
+			fprintf(stderr, "WARNING: Failed to release mapped input on port %d (errno %d: %s), continuing.\n", port, errno, strerror(errno));
+		}
+		if ((returnVal = posix_fadvise(fd, (off_t) input->inputEvicted[port], (off_t) evictLength, POSIX_FADV_DONTNEED)) != 0) {
+			fprintf(stderr, "WARNING: Failed to evict read input on port %d (errno %d: %s), continuing.\n", port, returnVal, strerror(returnVal));
+		}
+		input->inputEvicted[port] = evictLimit;
+	}
+}
+
+/**
+ * @brief      Restart page cache management after the read head of a file has been moved
+ *
+ * @param      input     The input
+ * @param[in]  port      The index offset from the base file
+ * @param[in]  position  The new byte offset of the read head
+ */
+void _lofar_udp_io_read_advise_reset_FILE(lofar_udp_io_read_config *const input, const int8_t port, const int64_t position) {
+	if (input->inputAdvised[port] < 0 || position < 0) {
+		return;
+	}
+
+	// Data skipped over were never read, so eviction restarts from the block containing the new position
+	input->inputAdvised[port] = position;
+	input->inputEvicted[port] = (position / FILE_EVICT_BLOCK_SIZE) * FILE_EVICT_BLOCK_SIZE;
+}
+
+
+/**
+ * @brief      Follow mode: wait for a file that is still being written to grow past a given size. The wait between
+ *             checks starts at FILE_FOLLOW_POLL_MIN ms and doubles up to FILE_FOLLOW_POLL_MAX ms, while an inotify watch
+ *             on the file wakes the reader as soon as data are appended (where the file system supports it).
+ *
+ * @param      input      The input
+ * @param[in]  port       The index offset from the base file
+ * @param[in]  knownSize  The size of the file that has already been consumed
+ *
+ * @return     >knownSize: The new file size, 0: No new data within the follow timeout (or follow mode is disabled), <0: Failure
+ */
+int64_t _lofar_udp_io_read_follow_FILE(lofar_udp_io_read_config *const input, const int8_t port, const int64_t knownSize) {
+	if (input->followTimeout <= 0.0f || input->fileRef[port] == NULL) {
+		return 0;
+	}
+	const int32_t fd = fileno(input->fileRef[port]);
+
+	if (input->followNotify[port] < 0) {
+		// Watch the open file through its descriptor, so that renames/file lists do not need the path
+		char fdLocation[DEF_STR_LEN];
+		snprintf(fdLocation, DEF_STR_LEN, "/proc/self/fd/%d", fd);
+		int32_t notifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+		if (notifyFd >= 0 && inotify_add_watch(notifyFd, fdLocation, IN_MODIFY | IN_CLOSE_WRITE) < 0) {
+			close(notifyFd);
+			notifyFd = -1;
+		}
+		input->followNotify[port] = notifyFd;
+	}
+
+	struct timespec tick, tock;
+	CLICK(tick);
+	int32_t waitTime = FILE_FOLLOW_POLL_MIN;
+	struct stat fileStat;
+	while (1) {
+		if (fstat(fd, &fileStat) != 0) {
+			fprintf(stderr, "ERROR %s: Failed to check size of input on port %d (errno %d: %s), exiting.\n", __func__, port, errno, strerror(errno));
+			return -1;
+		}
+		if (fileStat.st_size > knownSize) {
+			return fileStat.st_size;
+		}
+
+		CLICK(tock);
+		const int64_t remainingTime = (int64_t) ((input->followTimeout - TICKTOCK(tick, tock)) * 1000.0);
+		if (remainingTime <= 0) {
+			VERBOSE(printf("%s: No new data on port %d within %f seconds, treating the input as finished.\n", __func__, port, input->followTimeout));
+			return 0;
+		}
+		if (waitTime > remainingTime) {
+			waitTime = (int32_t) remainingTime;
+		}
+
+		if (input->followNotify[port] >= 0) {
+			struct pollfd notifyPoll = { .fd = input->followNotify[port], .events = POLLIN, .revents = 0 };
+			if (poll(&notifyPoll, 1, waitTime) > 0) {
+				// Drain the queued events, the file size is checked directly
+				int8_t events[4096];
+				while (read(input->followNotify[port], events, sizeof(events)) > 0);
+			}
+		} else {
+			const struct timespec sleepTime = { .tv_sec = waitTime / 1000, .tv_nsec = (waitTime % 1000) * 1000000L };
+			nanosleep(&sleepTime, NULL);
+		}
+
+		waitTime = (2 * waitTime) < FILE_FOLLOW_POLL_MAX ? (2 * waitTime) : FILE_FOLLOW_POLL_MAX;
+	}
+}
+
+/**
+ * @brief      Check if a NORMAL input location is a pattern describing a list of files
+ *
+ * @param[in]  inputLocation  The input location
+ *
+ * @return     1: Pattern, 0: Single file
+ */
+int32_t _lofar_udp_io_read_FILE_is_list(const char inputLocation[]) {
+	return strpbrk(inputLocation, "*?[") != NULL;
+}
+
+/**
+ * @brief      Expand a file pattern, matches are sorted, so time-stamped file names are returned in time order
+ *
+ * @param[in]  inputLocation  The input pattern
+ * @param      matches        Output glob struct, must be released with globfree on success
+ *
+ * @return     >0: Number of matching files, <0: Failure
+ */
+int32_t _lofar_udp_io_read_FILE_glob(const char inputLocation[], glob_t *matches) {
+	const int32_t returnVal = glob(inputLocation, GLOB_ERR, NULL, matches);
+	if (returnVal != 0) {
+		fprintf(stderr, "ERROR: Failed to find any files matching %s (%s), exiting.\n", inputLocation,
+		        returnVal == GLOB_NOMATCH ? "no matches" : "read error");
+		if (returnVal != GLOB_NOMATCH) {
+			globfree(matches);
+		}
+		return -1;
+	}
+
+	if (matches->gl_pathc > INT32_MAX) {
+		fprintf(stderr, "ERROR: Pattern %s matches too many files (%ld), exiting.\n", inputLocation, matches->gl_pathc);
+		globfree(matches);
+		return -1;
+	}
+
+	return (int32_t) matches->gl_pathc;
+}
+
+/**
+ * @brief      Get the file a NORMAL input starts from: the first match for a file pattern, otherwise the input location
+ *
+ * @param      dest           The output location (DEF_STR_LEN + 1 long)
+ * @param[in]  inputLocation  The input location
+ * @param[in]  readerType     The reader type, only NORMAL inputs accept patterns
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_FILE_list_first(char *dest, const char inputLocation[], const reader_t readerType) {
+	if (readerType != NORMAL || !_lofar_udp_io_read_FILE_is_list(inputLocation)) {
+		if (strncpy(dest, inputLocation, DEF_STR_LEN) != dest) {
+			fprintf(stderr, "ERROR %s: Failed to copy input location %s, exiting.\n", __func__, inputLocation);
+			return -1;
+		}
+		dest[DEF_STR_LEN] = '\0';
+		return 0;
+	}
+
+	glob_t matches;
+	if (_lofar_udp_io_read_FILE_glob(inputLocation, &matches) < 1) {
+		return -1;
+	}
+
+	int32_t returnVal = 0;
+	if (strlen(matches.gl_pathv[0]) > DEF_STR_LEN || strncpy(dest, matches.gl_pathv[0], DEF_STR_LEN) != dest) {
+		fprintf(stderr, "ERROR %s: Failed to copy file name %s, exiting.\n", __func__, matches.gl_pathv[0]);
+		returnVal = -1;
+	}
+	dest[DEF_STR_LEN] = '\0';
+	globfree(&matches);
+
+	return returnVal;
+}
+
+/**
+ * @brief      Build the list of files for a NORMAL input pattern, recording where each file sits in the concatenated
+ *             stream. Only whole packets are used from each file, so that a packet cut short at the end of a file
+ *             does not shift the packets in the files that follow it.
+ *
+ * @param      input          The input
+ * @param[in]  inputLocation  The input pattern
+ * @param[in]  port           The index offset from the base file
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_setup_FILE_list(lofar_udp_io_read_config *const input, const char inputLocation[], const int8_t port) {
+	glob_t matches;
+	const int32_t numFiles = _lofar_udp_io_read_FILE_glob(inputLocation, &matches);
+	if (numFiles < 1) {
+		return -1;
+	}
+
+	lofar_udp_io_file_list *list = calloc(1, sizeof(lofar_udp_io_file_list));
+	if (list == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to allocate file list for port %d, exiting.\n", __func__, port);
+		globfree(&matches);
+		return -1;
+	}
+	input->fileList[port] = list;
+	list->numFiles = numFiles;
+	list->files = calloc(numFiles, sizeof(*(list->files)));
+	list->fileStart = calloc(numFiles, sizeof(int64_t));
+	list->fileLength = calloc(numFiles, sizeof(int64_t));
+	if (list->files == NULL || list->fileStart == NULL || list->fileLength == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to allocate file list for port %d, exiting.\n", __func__, port);
+		globfree(&matches);
+		return -1;
+	}
+
+	const int64_t packetLength = input->portPacketLength[port] > 0 ? input->portPacketLength[port] : 1;
+	int64_t streamOffset = 0;
+	for (int32_t file = 0; file < numFiles; file++) {
+		struct stat fileStat;
+		if (strlen(matches.gl_pathv[file]) > DEF_STR_LEN || stat(matches.gl_pathv[file], &fileStat) != 0 || !S_ISREG(fileStat.st_mode)) {
+			fprintf(stderr, "ERROR: %s (matched by %s) is not a usable regular file, exiting.\n", matches.gl_pathv[file], inputLocation);
+			globfree(&matches);
+			return -1;
+		}
+		strncpy(list->files[file], matches.gl_pathv[file], DEF_STR_LEN);
+
+		list->fileStart[file] = streamOffset;
+		list->fileLength[file] = fileStat.st_size - (fileStat.st_size % packetLength);
+		if (list->fileLength[file] != fileStat.st_size) {
+			fprintf(stderr, "WARNING: %s ends with a partial packet, the last %ld bytes will be ignored.\n", list->files[file],
+			        fileStat.st_size - list->fileLength[file]);
+		}
+		streamOffset += list->fileLength[file];
+
+		VERBOSE(printf("Port %d file %d: %s (%ld bytes at stream offset %ld)\n", port, file, list->files[file], list->fileLength[file], list->fileStart[file]));
+	}
+	globfree(&matches);
+
+	list->currentFile = 0;
+	list->nextFileRef = NULL;
+	return 0;
+}
+
+/**
+ * @brief      Open a file from the list of a multi-file input, and ask for the start of it to be read into the page cache
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base file
+ * @param[in]  file   The index of the file in the list
+ *
+ * @return     Non-NULL: File pointer, NULL: Failure
+ */
+FILE* _lofar_udp_io_read_FILE_list_open(lofar_udp_io_read_config *const input, const int8_t port, const int32_t file) {
+	const lofar_udp_io_file_list *list = input->fileList[port];
+	FILE *fileRef = fopen(list->files[file], "rb");
+	if (fileRef == NULL) {
+		fprintf(stderr, "ERROR: Failed to open file at %s: errno %d, %s.\n", list->files[file], errno, strerror(errno));
+		return NULL;
+	}
+
+	posix_fadvise(fileno(fileRef), 0, 0, POSIX_FADV_SEQUENTIAL);
+	const int64_t adviseLength = list->fileLength[file] < FILE_READ_AHEAD_SIZE ? list->fileLength[file] : FILE_READ_AHEAD_SIZE;
+	int32_t returnVal;
+	if (adviseLength > 0 && (returnVal = posix_fadvise(fileno(fileRef), 0, (off_t) adviseLength, POSIX_FADV_WILLNEED)) != 0) {
+		fprintf(stderr, "WARNING: Failed to request read-ahead for %s (errno %d: %s), continuing.\n", list->files[file], returnVal, strerror(returnVal));
+	}
+
+	return fileRef;
+}
+
+/**
+ * @brief      Move a multi-file input on to a file in its list, evicting the remainder of the current file
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base file
+ * @param[in]  file   The index of the file in the list
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_FILE_list_switch(lofar_udp_io_read_config *const input, const int8_t port, const int32_t file) {
+	lofar_udp_io_file_list *list = input->fileList[port];
+	if (file < 0 || file >= list->numFiles) {
+		fprintf(stderr, "ERROR %s: Invalid file %d for port %d (%d files), exiting.\n", __func__, file, port, list->numFiles);
+		return -1;
+	}
+
+	// Only the file directly after the current one is ever prefetched
+	FILE *nextFile = NULL;
+	if (file == list->currentFile + 1) {
+		nextFile = list->nextFileRef;
+	} else if (list->nextFileRef != NULL) {
+		fclose(list->nextFileRef);
+	}
+	list->nextFileRef = NULL;
+
+	if (nextFile == NULL && (nextFile = _lofar_udp_io_read_FILE_list_open(input, port, file)) == NULL) {
+		return -1;
+	}
+
+	if (input->fileRef[port] != NULL) {
+		posix_fadvise(fileno(input->fileRef[port]), (off_t) input->inputEvicted[port], 0, POSIX_FADV_DONTNEED);
+		fclose(input->fileRef[port]);
+	}
+	input->fileRef[port] = nextFile;
+	list->currentFile = file;
+
+	// Follow mode watches the open file, restart the watch on the next wait
+	if (input->followNotify[port] >= 0) {
+		close(input->followNotify[port]);
+		input->followNotify[port] = -1;
+	}
+
+	// The start of the new file has already been requested from the disk
+	input->inputAdvised[port] = list->fileLength[file] < FILE_READ_AHEAD_SIZE ? list->fileLength[file] : FILE_READ_AHEAD_SIZE;
+	input->inputEvicted[port] = 0;
+	return 0;
+}
+
+/**
+ * @brief      Perform a data read for a multi-file input, continuing into the following files as each one is
+ *             exhausted. Gaps between files are left to the reader's packet loss handling, only the end of the
+ *             last file results in a short read.
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     <0: Failure, >=0 Characters read
+ */
+int64_t _lofar_udp_io_read_FILE_list(lofar_udp_io_read_config *const input, const int8_t port, int8_t *const targetArray, const int64_t nchars) {
+	lofar_udp_io_file_list *list = input->fileList[port];
+	int64_t charsRead = 0;
+
+	while (charsRead < nchars && input->fileRef[port] != NULL) {
+		const int64_t position = (int64_t) ftello(input->fileRef[port]);
+		const int64_t remaining = list->fileLength[list->currentFile] - position;
+
+		if (remaining > 0) {
+			const int64_t request = (nchars - charsRead) < remaining ? (nchars - charsRead) : remaining;
+			const int64_t fileRead = (int64_t) fread(targetArray + charsRead, sizeof(int8_t), request, input->fileRef[port]);
+			charsRead += fileRead;
+			_lofar_udp_io_read_advise_FILE(input, port, NULL, position + fileRead);
+
+			// Open the next file once the read-ahead window reaches the end of this one
+			if (list->nextFileRef == NULL && (list->currentFile + 1) < list->numFiles &&
+			    (position + fileRead + FILE_READ_AHEAD_SIZE) >= list->fileLength[list->currentFile]) {
+				list->nextFileRef = _lofar_udp_io_read_FILE_list_open(input, port, list->currentFile + 1);
+			}
+
+			if (fileRead == request) {
+				continue;
+			}
+			if (ferror(input->fileRef[port])) {
+				fprintf(stderr, "ERROR %s: Failed to read %s on port %d, exiting.\n", __func__, list->files[list->currentFile], port);
+				return charsRead > 0 ? charsRead : -1;
+			}
+			fprintf(stderr, "WARNING: %s is shorter than expected (%ld < %ld bytes), continuing with the next file.\n",
+			        list->files[list->currentFile], position + fileRead, list->fileLength[list->currentFile]);
+		}
+
+		if ((list->currentFile + 1) >= list->numFiles) {
+			// Follow mode: the last file may still be being written, wait for at least one more packet
+			const int64_t packetLength = input->portPacketLength[port] > 0 ? input->portPacketLength[port] : 1;
+			const int64_t fileSize = _lofar_udp_io_read_follow_FILE(input, port, list->fileLength[list->currentFile] + packetLength - 1);
+			if (fileSize <= 0) {
+				break;
+			}
+			clearerr(input->fileRef[port]);
+			list->fileLength[list->currentFile] = fileSize - (fileSize % packetLength);
+			continue;
+		}
+
+		VERBOSE(printf("Port %d moving on to file %s\n", port, list->files[list->currentFile + 1]));
+		if (_lofar_udp_io_read_FILE_list_switch(input, port, list->currentFile + 1) < 0) {
+			return charsRead > 0 ? charsRead : -1;
+		}
+	}
+
+	return charsRead;
+}
+
+/**
+ * @brief      Seek a multi-file input to a given offset in the concatenated stream
+ *
+ * @param      input       The input
+ * @param[in]  port        The index offset from the base file
+ * @param[in]  byteOffset  The target offset
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_seek_FILE_list(lofar_udp_io_read_config *const input, const int8_t port, const int64_t byteOffset) {
+	const lofar_udp_io_file_list *list = input->fileList[port];
+
+	int32_t file = list->numFiles - 1;
+	while (file > 0 && list->fileStart[file] > byteOffset) {
+		file--;
+	}
+	const int64_t fileOffset = byteOffset - list->fileStart[file];
+	if (fileOffset > list->fileLength[file]) {
+		fprintf(stderr, "ERROR %s: Offset %ld is past the end of the input on port %d, exiting.\n", __func__, byteOffset, port);
+		return -1;
+	}
+
+	if (file != list->currentFile && _lofar_udp_io_read_FILE_list_switch(input, port, file) < 0) {
+		return -1;
+	}
+
+	if (fseeko(input->fileRef[port], (off_t) fileOffset, SEEK_SET) != 0) {
+		fprintf(stderr, "ERROR %s: Failed to seek to byte %ld of %s on port %d (errno %d: %s), exiting.\n", __func__, fileOffset,
+		        list->files[file], port, errno, strerror(errno));
+		return -1;
+	}
+	_lofar_udp_io_read_advise_reset_FILE(input, port, fileOffset);
+
 	return 0;
 }
 
@@ -36,13 +510,54 @@ int32_t _lofar_udp_io_read_setup_FILE(lofar_udp_io_read_config *const input, con
 int64_t _lofar_udp_io_read_FILE(lofar_udp_io_read_config *const input, const int8_t port, int8_t *const targetArray, const int64_t nchars) {
 	// Decompressed file: Read and return the data as needed
 	VERBOSE(printf("reader_nchars: Entering read request (normal): %d, %ld\n", port, nchars));
+	if (input->fileList[port] != NULL) {
+		return _lofar_udp_io_read_FILE_list(input, port, targetArray, nchars);
+	}
 	if (input->fileRef[port] != NULL) {
-		return (int64_t) fread(targetArray, sizeof(int8_t), nchars, input->fileRef[port]);
+		int64_t charsRead = (int64_t) fread(targetArray, sizeof(int8_t), nchars, input->fileRef[port]);
+		// Follow mode: wait for the writer to append the remainder of the request
+		while (charsRead < nchars && input->followTimeout > 0.0f && !ferror(input->fileRef[port]) &&
+		       _lofar_udp_io_read_follow_FILE(input, port, (int64_t) ftello(input->fileRef[port])) > 0) {
+			clearerr(input->fileRef[port]);
+			charsRead += (int64_t) fread(targetArray + charsRead, sizeof(int8_t), nchars - charsRead, input->fileRef[port]);
+		}
+		if (input->inputAdvised[port] >= 0) {
+			_lofar_udp_io_read_advise_FILE(input, port, NULL, (int64_t) ftello(input->fileRef[port]));
+		}
+		return charsRead;
 	}
 	fprintf(stderr, "ERROR %s: Input file pointer is null on portp %d, exiting.\n", __func__, port);
 	return -1;
 }
 
+/**
+ * @brief      Seek a normal file to a given byte offset
+ *
+ * @param      input       The input
+ * @param[in]  port        The index offset from the base file
+ * @param[in]  byteOffset  The target offset
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_seek_FILE(lofar_udp_io_read_config *const input, const int8_t port, const int64_t byteOffset) {
+	if (input->readerType == FIFO || input->fileRef[port] == NULL) {
+		fprintf(stderr, "ERROR %s: Cannot seek port %d (reader %d, file %p), exiting.\n", __func__, port, input->readerType, input->fileRef[port]);
+		return -1;
+	}
+
+	if (input->fileList[port] != NULL) {
+		return _lofar_udp_io_read_seek_FILE_list(input, port, byteOffset);
+	}
+
+	if (fseeko(input->fileRef[port], (off_t) byteOffset, SEEK_SET) != 0) {
+		fprintf(stderr, "ERROR %s: Failed to seek to byte %ld on port %d (errno %d: %s), exiting.\n", __func__, byteOffset, port, errno, strerror(errno));
+		return -1;
+	}
+	_lofar_udp_io_read_advise_reset_FILE(input, port, byteOffset);
+
+	return 0;
+}
+
 /**
  * @brief      Cleanup file references for the read I/O struct
  *
@@ -59,6 +574,206 @@ void _lofar_udp_io_read_cleanup_FILE(lofar_udp_io_read_config *const input, cons
 		fclose(input->fileRef[port]);
 		input->fileRef[port] = NULL;
 	}
+
+	if (input->followNotify[port] >= 0) {
+		close(input->followNotify[port]);
+		input->followNotify[port] = -1;
+	}
+
+	lofar_udp_io_file_list *list = input->fileList[port];
+	if (list != NULL) {
+		if (list->nextFileRef != NULL) {
+			fclose(list->nextFileRef);
+		}
+		FREE_NOT_NULL(list->files);
+		FREE_NOT_NULL(list->fileStart);
+		FREE_NOT_NULL(list->fileLength);
+		FREE_NOT_NULL(input->fileList[port]);
+	}
+}
+
+
+/**
+ * @brief      Setup the read I/O struct to handle normal data through a memory mapping of the file, so that
+ *             data can be processed directly from the page cache
+ *
+ * @param      input   The input
+ * @param[in]  inputLocation    The input file location
+ * @param[in]  port    The index offset from the base file
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_setup_MMAP(lofar_udp_io_read_config *const input, const char *inputLocation, const int8_t port) {
+	int32_t returnVal = _lofar_udp_io_read_setup_FILE(input, inputLocation, port);
+	if (returnVal < 0) {
+		return returnVal;
+	}
+
+	const int64_t fileSize = _FILE_file_size(input->fileRef[port]);
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	if (fileSize < 0 || pageSize < 1) {
+		fprintf(stderr, "ERROR: Failed to get size of file at %s, exiting.\n", inputLocation);
+		return -1;
+	}
+
+	// The file is surrounded by anonymous zeroed pages: the space before it holds the padding packets and any
+	// packets kept between reads, while the space after it lets a full read overrun the end of the file
+	const int64_t readSize = input->readBufSize[port] > 0 ? input->readBufSize[port] : 0;
+	const int64_t guardSize = ((readSize + input->preBufferSpace[port] + pageSize - 1) / pageSize + 1) * pageSize;
+	const int64_t dataSize = ((fileSize + pageSize - 1) / pageSize) * pageSize;
+	const int64_t mapSize = guardSize + dataSize + guardSize;
+
+	int8_t *mapping = mmap(NULL, mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (mapping == MAP_FAILED) {
+		fprintf(stderr, "ERROR: Failed to reserve memory mapping for file on port %d. Errno: %d (%s). Exiting.\n", port,
+		        errno, strerror(errno));
+		return -2;
+	}
+
+	// The kernels modify headers in place, a private mapping keeps those changes out of the file
+	if (fileSize > 0 && mmap(mapping + guardSize, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED | MAP_NORESERVE,
+	                         fileno(input->fileRef[port]), 0) == MAP_FAILED) {
+		fprintf(stderr, "ERROR: Failed to create memory mapping for file on port %d (use FILE: for pipes). Errno: %d (%s). Exiting.\n", port,
+		        errno, strerror(errno));
+		munmap(mapping, mapSize);
+		return -2;
+	}
+
+	input->inputMap[port] = mapping;
+	input->inputMapSize[port] = mapSize;
+	input->inputMapReleased[port] = 0;
+	input->readingTracker[port].src = mapping + guardSize;
+	input->readingTracker[port].size = fileSize;
+	input->readingTracker[port].pos = 0;
+
+	if (fileSize > 0 && madvise(mapping + guardSize, fileSize, MADV_SEQUENTIAL) == -1) {
+		fprintf(stderr, "ERROR: Failed to advise the kernel on mmap read strategy on port %d. Errno: %d. Exiting.\n",
+		        port, errno);
+		return -3;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Perform a data read for a memory mapped file; reads targeting the cursor in the mapping only advance the
+ *             cursor, other targets are copied from the mapping
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     <=0: Failure, >0 Characters read
+ */
+int64_t _lofar_udp_io_read_MMAP(lofar_udp_io_read_config *const input, const int8_t port, int8_t *const targetArray, int64_t nchars) {
+	VERBOSE(printf("reader_nchars: Entering read request (mmap): %d, %ld\n", port, nchars));
+	if (input->inputMap[port] == NULL) {
+		fprintf(stderr, "ERROR %s: Input mapping is null on port %d, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	const int64_t startPos = (int64_t) input->readingTracker[port].pos;
+	const int8_t *cursor = (const int8_t *) input->readingTracker[port].src + startPos;
+	if (nchars > (int64_t) input->readingTracker[port].size - startPos) {
+		nchars = (int64_t) input->readingTracker[port].size - startPos;
+	}
+
+	if (targetArray != cursor && nchars > 0) {
+		memmove(targetArray, cursor, nchars);
+	}
+	input->readingTracker[port].pos += nchars;
+
+	// Release the pages that have fallen behind the reader's window (the previous buffer and its padding packets),
+	// rather than the full range behind the cursor, so the cost of each call stays proportional to the read
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	const int64_t releaseLimit = ((startPos - input->readBufSize[port] - input->preBufferSpace[port]) / pageSize) * pageSize;
+	if (releaseLimit > input->inputMapReleased[port]) {
+		if (madvise((void *) ((const int8_t *) input->readingTracker[port].src + input->inputMapReleased[port]), releaseLimit - input->inputMapReleased[port], MADV_DONTNEED) < 0) {
+			fprintf(stderr, "WARNING: Failed to release mapped input on port %d (errno %d: %s), continuing.\n", port, errno, strerror(errno));
+		}
+		input->inputMapReleased[port] = releaseLimit;
+	}
+
+	return nchars;
+}
+
+/**
+ * @brief      Seek a memory mapped file to a given byte offset
+ *
+ * @param      input       The input
+ * @param[in]  port        The index offset from the base file
+ * @param[in]  byteOffset  The target offset
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_seek_MMAP(lofar_udp_io_read_config *const input, const int8_t port, const int64_t byteOffset) {
+	if (input->inputMap[port] == NULL || byteOffset < 0 || byteOffset > (int64_t) input->readingTracker[port].size) {
+		fprintf(stderr, "ERROR %s: Cannot seek port %d to byte %ld (mapping %p, size %ld), exiting.\n", __func__, port, byteOffset, input->inputMap[port], input->readingTracker[port].size);
+		return -1;
+	}
+
+	// Drop any pages modified while processing, so that data read again matches the file
+	if (input->readingTracker[port].size > 0 && madvise((void *) input->readingTracker[port].src, input->readingTracker[port].size, MADV_DONTNEED) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to reset mapped input on port %d (errno %d: %s), exiting.\n", __func__, port, errno, strerror(errno));
+		return -1;
+	}
+
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	const int64_t releaseLimit = ((byteOffset - input->readBufSize[port] - input->preBufferSpace[port]) / pageSize) * pageSize;
+	input->inputMapReleased[port] = releaseLimit > 0 ? releaseLimit : 0;
+	input->readingTracker[port].pos = byteOffset;
+
+	return 0;
+}
+
+/**
+ * @brief      Move the head of a memory mapped input so that the next read lands on the mapping's cursor (and is
+ *             performed in place), carrying over any data kept from the current buffer
+ *
+ * @param      input       The input
+ * @param[in]  port        The index offset from the base file
+ * @param      head        The current head of the input buffer
+ * @param[in]  keepOffset  Offset of the data to keep, relative to the head
+ * @param[in]  keepLength  Length of the data to keep; the next read targets head + keepOffset + keepLength
+ *
+ * @return     The new head of the input buffer
+ */
+int8_t* _lofar_udp_io_read_MMAP_rebase(lofar_udp_io_read_config *const input, const int8_t port, int8_t *head, const int64_t keepOffset, const int64_t keepLength) {
+	int8_t *cursor = (int8_t *) input->readingTracker[port].src + input->readingTracker[port].pos;
+	if (head + keepOffset + keepLength == cursor) {
+		return head;
+	}
+
+	// Fall back to copying reads if the padding space would leave the mapping (data remains correct, just not zero-copy)
+	int8_t *newHead = cursor - keepOffset - keepLength;
+	if (newHead - input->preBufferSpace[port] < input->inputMap[port]) {
+		return head;
+	}
+
+	memmove(newHead + keepOffset, head + keepOffset, keepLength);
+	return newHead;
+}
+
+/**
+ * @brief      Cleanup the mapping and file references for a memory mapped input
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base file
+ */
+void _lofar_udp_io_read_cleanup_MMAP(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input == NULL) {
+		return;
+	}
+
+	if (input->inputMap[port] != NULL) {
+		munmap(input->inputMap[port], input->inputMapSize[port]);
+		input->inputMap[port] = NULL;
+		input->inputMapSize[port] = 0;
+		input->readingTracker[port].src = NULL;
+	}
+
+	_lofar_udp_io_read_cleanup_FILE(input, port);
 }
 
 
@@ -166,8 +881,8 @@ int32_t _lofar_udp_io_write_setup_FILE(lofar_udp_io_write_config *const config,
 		return -1;
 	}
 
-	// Check if it exists, and if it if we can continue
-	if (_lofar_udp_io_write_FILE_setup_check_exists(outputLocation, config->progressWithExisting)) {
+	// Check if it exists, and if it if we can continue (a resumed output is expected to exist)
+	if (_lofar_udp_io_write_FILE_setup_check_exists(outputLocation, config->progressWithExisting || config->resumeCheckpoint != NULL)) {
 		return -1;
 	}
 
@@ -199,6 +914,12 @@ int32_t _lofar_udp_io_write_setup_FILE(lofar_udp_io_write_config *const config,
 		}
 	}
 
+	// Continuing from a checkpoint: keep the data written before it, discard anything written after it
+	if (config->resumeCheckpoint != NULL && config->readerType == NORMAL && outp < config->resumeCheckpoint->numOutputs
+		&& config->resumeCheckpoint->outputOffset[outp] >= 0) {
+		return _lofar_udp_io_write_setup_FILE_resume(config, outp, outputLocation, config->resumeCheckpoint->outputOffset[outp]);
+	}
+
 	// Open a buffered file pointer
 	FILE *tmpPtr = fopen(outputLocation, "wb");
 	if (tmpPtr == NULL) {
@@ -211,6 +932,42 @@ int32_t _lofar_udp_io_write_setup_FILE(lofar_udp_io_write_config *const config,
 	return 0;
 }
 
+/**
+ * @brief      Re-open an existing output at the length recorded by a checkpoint, so that writes continue from it
+ *
+ * @param      config          The configuration
+ * @param[in]  outp            The output index
+ * @param[in]  outputLocation  The output file location
+ * @param[in]  outputOffset    The length of the output at the checkpoint
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_write_setup_FILE_resume(lofar_udp_io_write_config *const config, const int8_t outp, const char outputLocation[], const int64_t outputOffset) {
+	FILE *tmpPtr = fopen(outputLocation, "r+b");
+	if (tmpPtr == NULL) {
+		fprintf(stderr, "ERROR: Failed to re-open output to resume (location %s, errno %d, (%s)), exiting.\n", outputLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	const int64_t fileSize = _FILE_file_size(tmpPtr);
+	if (fileSize < outputOffset) {
+		fprintf(stderr, "ERROR: Output %s is shorter than its checkpoint (%ld < %ld bytes), exiting.\n", outputLocation, fileSize, outputOffset);
+		fclose(tmpPtr);
+		return -1;
+	}
+
+	if (ftruncate(fileno(tmpPtr), (off_t) outputOffset) != 0 || fseeko(tmpPtr, (off_t) outputOffset, SEEK_SET) != 0) {
+		fprintf(stderr, "ERROR: Failed to reset output %s to %ld bytes (errno %d, (%s)), exiting.\n", outputLocation, outputOffset, errno, strerror(errno));
+		fclose(tmpPtr);
+		return -1;
+	}
+
+	VERBOSE(printf("%s: Continuing output %d (%s) from byte %ld\n", __func__, outp, outputLocation, outputOffset));
+	config->outputFiles[outp] = tmpPtr;
+
+	return 0;
+}
+
 /**
  * @brief      Perform a data write for a normal file
  *
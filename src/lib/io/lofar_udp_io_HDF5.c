@@ -109,8 +109,274 @@ __attribute__((unused)) typedef struct strKeyBoolArrVal {
 } strKeyBoolArrVal;
 
 
+// HDF5 reader state for a single port (one STOKES_* dataset)
+struct lofar_udp_io_hdf5_reader {
+	hid_t file;
+	hid_t dset;
+	hid_t dtype;
+	size_t elementSize;
+
+	// Dataset shape (samples, channels), chunk shape and the bytes in a sample
+	hsize_t dims[2];
+	hsize_t chunkDims[2];
+	int64_t rowBytes;
+
+	// Next sample to be read from the dataset
+	hsize_t nextRow;
+
+	// Read-ahead of whole chunk rows, for requests that do not cover a full set of chunks
+	int8_t *staging;
+	int64_t stagingSize;
+	int64_t stagingOffset;
+	int64_t stagingLength;
+};
+
+/**
+ * @brief      Find the smallest prime at or above a value, for sizing the chunk cache hash table
+ *
+ * @param[in]  value  The lower bound
+ *
+ * @return     The prime
+ */
+static size_t _lofar_udp_io_HDF5_next_prime(size_t value) {
+	if (value < 3) {
+		return 3;
+	}
+	value |= 1;
+	for (;; value += 2) {
+		int8_t prime = 1;
+		for (size_t divisor = 3; divisor * divisor <= value; divisor += 2) {
+			if (value % divisor == 0) {
+				prime = 0;
+				break;
+			}
+		}
+		if (prime) {
+			return value;
+		}
+	}
+}
+
+/**
+ * @brief      Close the HDF5 handles of a reader and free it
+ *
+ * @param      hdf5  The reader
+ */
+static void _lofar_udp_io_HDF5_close(lofar_udp_io_hdf5_reader *hdf5) {
+	if (hdf5 == NULL) {
+		return;
+	}
+
+	#pragma omp critical (lofar_udp_io_hdf5)
+	{
+		if (hdf5->dtype > 0) H5Tclose(hdf5->dtype);
+		if (hdf5->dset > 0) H5Dclose(hdf5->dset);
+		if (hdf5->file > 0) H5Fclose(hdf5->file);
+	}
+	FREE_NOT_NULL(hdf5->staging);
+	free(hdf5);
+}
+
+/**
+ * @brief      Open the port'th STOKES_* dataset in a file written by the HDF5 writer, and configure a chunk cache
+ *             that holds a read-ahead block of whole chunk rows
+ *
+ * @param[in]  inputLocation  The HDF5 file location
+ * @param[in]  port           The index of the dataset amongst the STOKES_* datasets in the file
+ *
+ * @return     Reader pointer: Success, NULL: Failure
+ */
+static lofar_udp_io_hdf5_reader* _lofar_udp_io_HDF5_open(const char inputLocation[], const int8_t port) {
+	lofar_udp_io_hdf5_reader *hdf5 = calloc(1, sizeof(lofar_udp_io_hdf5_reader));
+	CHECK_ALLOC_NOCLEAN(hdf5, NULL);
+	hdf5->file = -1;
+	hdf5->dset = -1;
+	hdf5->dtype = -1;
+
+	int32_t returnVal = 0;
+	#pragma omp critical (lofar_udp_io_hdf5)
+	{
+		// The writer's default compression is bitshuffle/zstd, make sure the filter is available
+		if (bshuf_register_h5filter() < 0) {
+			fprintf(stderr, "WARNING %s: Failed to register Bitshuffle HDF5 plugin, compressed datasets will fail to read.\n", __func__);
+		}
+
+		if ((hdf5->file = H5Fopen(inputLocation, H5F_ACC_RDONLY, H5P_DEFAULT)) < 0) {
+			fprintf(stderr, "ERROR %s: Failed to open HDF5 file %s, exiting.\n", __func__, inputLocation);
+			returnVal = -1;
+		}
+
+		// Outputs are numbered by processing mode, so find the port'th dataset that is present
+		char dsetName[DEF_STR_LEN] = "";
+		int8_t found = -1;
+		if (returnVal == 0 && H5Lexists(hdf5->file, "/SUB_ARRAY_POINTING_000", H5P_DEFAULT) > 0
+			&& H5Lexists(hdf5->file, "/SUB_ARRAY_POINTING_000/BEAM_000", H5P_DEFAULT) > 0) {
+			for (int8_t dsetIdx = 0; dsetIdx < INT8_MAX && found < port; dsetIdx++) {
+				snprintf(dsetName, DEF_STR_LEN - 1, "/SUB_ARRAY_POINTING_000/BEAM_000/STOKES_%d", dsetIdx);
+				if (H5Lexists(hdf5->file, dsetName, H5P_DEFAULT) > 0) {
+					found++;
+				}
+			}
+		}
+		if (returnVal == 0 && found != port) {
+			fprintf(stderr, "ERROR %s: Failed to find STOKES dataset %d in %s, exiting.\n", __func__, port, inputLocation);
+			returnVal = -1;
+		}
+
+		hid_t dcpl = -1, dapl = -1, space = -1, fileType = -1;
+		if (returnVal == 0 && (hdf5->dset = H5Dopen(hdf5->file, dsetName, H5P_DEFAULT)) < 0) {
+			fprintf(stderr, "ERROR %s: Failed to open dataset %s, exiting.\n", __func__, dsetName);
+			returnVal = -1;
+		}
+
+		if (returnVal == 0) {
+			space = H5Dget_space(hdf5->dset);
+			fileType = H5Dget_type(hdf5->dset);
+			dcpl = H5Dget_create_plist(hdf5->dset);
+			if (space < 0 || fileType < 0 || dcpl < 0 || H5Sget_simple_extent_ndims(space) != 2
+				|| H5Sget_simple_extent_dims(space, hdf5->dims, NULL) < 0 || (hdf5->dtype = H5Tget_native_type(fileType, H5T_DIR_ASCEND)) < 0) {
+				fprintf(stderr, "ERROR %s: Dataset %s is not a 2D (samples, channels) dataset, exiting.\n", __func__, dsetName);
+				returnVal = -1;
+			}
+		}
+
+		if (returnVal == 0) {
+			hdf5->elementSize = H5Tget_size(hdf5->dtype);
+			hdf5->rowBytes = (int64_t) (hdf5->dims[1] * hdf5->elementSize);
+
+			// Contiguous datasets are read in blocks matching the writer's default chunking
+			if (H5Pget_layout(dcpl) != H5D_CHUNKED || H5Pget_chunk(dcpl, 2, hdf5->chunkDims) != 2) {
+				hdf5->chunkDims[0] = HDF5_READ_DEFAULT_ROWS;
+				hdf5->chunkDims[1] = hdf5->dims[1];
+			}
+			if (hdf5->chunkDims[1] < 1 || hdf5->chunkDims[1] > hdf5->dims[1]) {
+				hdf5->chunkDims[1] = hdf5->dims[1] > 0 ? hdf5->dims[1] : 1;
+			}
+
+			// Re-open the dataset with a chunk cache large enough for a full read-ahead block, so that chunks are
+			// only decompressed once even when requests split them. Fully read chunks are evicted first (w0 = 1).
+			const size_t chunksPerRow = (hdf5->dims[1] + hdf5->chunkDims[1] - 1) / hdf5->chunkDims[1];
+			const size_t cacheChunks = chunksPerRow * HDF5_READ_AHEAD_CHUNKS;
+			const size_t cacheBytes = cacheChunks * hdf5->chunkDims[0] * hdf5->chunkDims[1] * hdf5->elementSize;
+			if ((dapl = H5Pcreate(H5P_DATASET_ACCESS)) < 0
+				|| H5Pset_chunk_cache(dapl, _lofar_udp_io_HDF5_next_prime(100 * cacheChunks), cacheBytes, 1.0) < 0) {
+				fprintf(stderr, "WARNING %s: Failed to configure the chunk cache for %s, continuing with the defaults.\n", __func__, dsetName);
+			} else {
+				H5Dclose(hdf5->dset);
+				if ((hdf5->dset = H5Dopen(hdf5->file, dsetName, dapl)) < 0) {
+					fprintf(stderr, "ERROR %s: Failed to re-open dataset %s, exiting.\n", __func__, dsetName);
+					returnVal = -1;
+				}
+			}
+
+			VERBOSE(printf("%s: %s (%lld, %lld), chunks (%lld, %lld), %zu byte elements, %zu byte cache\n", __func__, dsetName,
+						   hdf5->dims[0], hdf5->dims[1], hdf5->chunkDims[0], hdf5->chunkDims[1], hdf5->elementSize, cacheBytes));
+		}
+
+		if (dapl > 0) H5Pclose(dapl);
+		if (dcpl > 0) H5Pclose(dcpl);
+		if (fileType > 0) H5Tclose(fileType);
+		if (space > 0) H5Sclose(space);
+	}
+
+	if (returnVal < 0 || hdf5->rowBytes < 1) {
+		_lofar_udp_io_HDF5_close(hdf5);
+		return NULL;
+	}
+
+	hdf5->stagingSize = (int64_t) (hdf5->chunkDims[0] * HDF5_READ_AHEAD_CHUNKS) * hdf5->rowBytes;
+	hdf5->staging = calloc(hdf5->stagingSize, sizeof(int8_t));
+	CHECK_ALLOC(hdf5->staging, NULL, _lofar_udp_io_HDF5_close(hdf5););
+
+	return hdf5;
+}
+
 /**
- * @brief      (NOT IMPLEMENTED) Setup the read I/O struct to handle HDF5 data
+ * @brief      Read whole samples from the dataset, starting at the next unread sample
+ *
+ * @param      hdf5    The reader
+ * @param      dest    The output buffer
+ * @param[in]  rows    The number of samples to read
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_HDF5_read_rows(lofar_udp_io_hdf5_reader *hdf5, int8_t *dest, const hsize_t rows) {
+	int32_t returnVal = 0;
+	#pragma omp critical (lofar_udp_io_hdf5)
+	{
+		const hsize_t offset[2] = { hdf5->nextRow, 0 };
+		const hsize_t count[2] = { rows, hdf5->dims[1] };
+		hid_t filespace = H5Dget_space(hdf5->dset);
+		hid_t memspace = H5Screate_simple(2, count, NULL);
+		herr_t status;
+		if (filespace < 0 || memspace < 0
+			|| (status = H5Sselect_hyperslab(filespace, H5S_SELECT_SET, offset, NULL, count, NULL)) < 0
+			|| (status = H5Dread(hdf5->dset, hdf5->dtype, memspace, filespace, H5P_DEFAULT, dest)) < 0) {
+			fprintf(stderr, "ERROR %s: Failed to read %lld samples from offset %lld, exiting.\n", __func__, rows, hdf5->nextRow);
+			returnVal = -1;
+		}
+		if (memspace > 0) H5Sclose(memspace);
+		if (filespace > 0) H5Sclose(filespace);
+	}
+
+	if (returnVal == 0) {
+		hdf5->nextRow += rows;
+	}
+	return returnVal;
+}
+
+/**
+ * @brief      Copy up to nchars of the dataset into a buffer. Requests covering whole chunk rows are read directly into
+ *             the output, the remainder is served from a read-ahead block of chunk rows.
+ *
+ * @param      hdf5         The reader
+ * @param      targetArray  The output buffer
+ * @param[in]  nchars       The number of bytes to copy
+ *
+ * @return     >=0: Bytes copied, <0: Failure
+ */
+static int64_t _lofar_udp_io_HDF5_copy(lofar_udp_io_hdf5_reader *hdf5, int8_t *const targetArray, const int64_t nchars) {
+	int64_t copied = 0;
+	while (copied < nchars) {
+		if (hdf5->stagingLength > hdf5->stagingOffset) {
+			const int64_t available = hdf5->stagingLength - hdf5->stagingOffset;
+			const int64_t toCopy = (nchars - copied) < available ? (nchars - copied) : available;
+			memcpy(&(targetArray[copied]), &(hdf5->staging[hdf5->stagingOffset]), toCopy);
+			hdf5->stagingOffset += toCopy;
+			copied += toCopy;
+			continue;
+		}
+
+		const hsize_t rowsRemaining = hdf5->dims[0] - hdf5->nextRow;
+		if (rowsRemaining == 0) {
+			break;
+		}
+
+		// Large requests skip the staging buffer, reading as many whole chunk rows as fit in the output
+		const hsize_t directRows = (((nchars - copied) / hdf5->rowBytes) / hdf5->chunkDims[0]) * hdf5->chunkDims[0];
+		if (directRows > 0) {
+			const hsize_t rows = directRows < rowsRemaining ? directRows : rowsRemaining;
+			if (_lofar_udp_io_HDF5_read_rows(hdf5, &(targetArray[copied]), rows) < 0) {
+				return -1;
+			}
+			copied += (int64_t) rows * hdf5->rowBytes;
+			continue;
+		}
+
+		const hsize_t stagingRows = (hsize_t) (hdf5->stagingSize / hdf5->rowBytes);
+		const hsize_t rows = stagingRows < rowsRemaining ? stagingRows : rowsRemaining;
+		if (_lofar_udp_io_HDF5_read_rows(hdf5, hdf5->staging, rows) < 0) {
+			return -1;
+		}
+		hdf5->stagingOffset = 0;
+		hdf5->stagingLength = (int64_t) rows * hdf5->rowBytes;
+	}
+
+	return copied;
+}
+
+/**
+ * @brief      Setup the read I/O struct to handle HDF5 data, each port reads one STOKES_* dataset of the file
  *
  * @param      input   The input
  * @param[in]  inputLocation    The input file location
@@ -118,20 +384,33 @@ __attribute__((unused)) typedef struct strKeyBoolArrVal {
  *
  * @return     0: Success, <0: Failure
  */
-__attribute__((unused)) int32_t _lofar_udp_io_read_setup_HDF5(__attribute__((unused)) lofar_udp_io_read_config *const input, __attribute__((unused)) const char *inputLocation,
-                                                              __attribute__((unused)) int8_t port) {
-	return -1;
+int32_t _lofar_udp_io_read_setup_HDF5(lofar_udp_io_read_config *const input, const char *inputLocation, const int8_t port) {
+	if ((input->hdf5Reader[port] = _lofar_udp_io_HDF5_open(inputLocation, port)) == NULL) {
+		return -1;
+	}
+
+	return 0;
 }
 
 
 /**
- * @brief      (NOT IMPLEMENTED) Cleanup HDF5 file references for the read I/O struct
+ * @brief      Perform a data read for a HDF5 dataset
  *
- * @param      input  The input
- * @param[in]  port   The index offset from the base file
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     <0: Failure, >=0 Characters read
  */
-__attribute__((unused)) int64_t _lofar_udp_io_read_HDF5(__attribute__((unused)) lofar_udp_io_read_config *const input, __attribute__((unused)) int8_t port, __attribute__((unused)) int8_t *targetArray, __attribute__((unused)) int64_t nchars) {
-	return -1;
+int64_t _lofar_udp_io_read_HDF5(lofar_udp_io_read_config *const input, const int8_t port, int8_t *targetArray, const int64_t nchars) {
+	VERBOSE(printf("reader_nchars: Entering read request (hdf5): %d, %ld\n", port, nchars));
+	if (input->hdf5Reader[port] == NULL) {
+		fprintf(stderr, "ERROR %s: HDF5 reader is null on port %d, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	return _lofar_udp_io_HDF5_copy(input->hdf5Reader[port], targetArray, nchars);
 }
 
 /**
@@ -140,27 +419,48 @@ __attribute__((unused)) int64_t _lofar_udp_io_read_HDF5(__attribute__((unused))
  * @param      input  The input
  * @param[in]  port   The index offset from the base file
  */
-__attribute__((unused)) void _lofar_udp_io_read_cleanup_HDF5(__attribute__((unused)) lofar_udp_io_read_config *const input, __attribute__((unused)) int8_t port) {
-	return; // NOLINT(readability-redundant-control-flow)
+void _lofar_udp_io_read_cleanup_HDF5(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input == NULL) {
+		return;
+	}
+
+	_lofar_udp_io_HDF5_close(input->hdf5Reader[port]);
+	input->hdf5Reader[port] = NULL;
 }
 
 /**
- * @brief      (NOT IMPLEMENTED) Temporarily read in num bytes from a HDF5 file
+ * @brief      Temporarily read in num bytes from the start of a HDF5 dataset
  *
  * @param      outbuf     The output buffer pointer
  * @param[in]  size       The size of words to read
  * @param[in]  num        The number of words to read
  * @param[in]  inputFile  The input file
- * @param[in]  resetSeek  Do (1) / Don't (0) reset back to the original location
- *                        in FILE* after performing a read operation
+ * @param[in]  port       The index of the dataset amongst the STOKES_* datasets in the file
+ * @param[in]  resetSeek  Do (1) / Don't (0) reset back to the original location (ignored, the file is re-opened)
  *
  * @return     >0: bytes read, <=-1: Failure
  */
-__attribute__((unused)) int64_t
-_lofar_udp_io_read_temp_HDF5(__attribute__((unused)) void *outbuf, __attribute__((unused)) const int64_t size, __attribute__((unused)) const int8_t num, __attribute__((unused)) const char inputFile[],
-                             __attribute__((unused)) const int8_t resetSeek) {
-	//int64_t readlen = -1;
-	return -1;
+int64_t _lofar_udp_io_read_temp_HDF5(void *outbuf, const int64_t size, const int64_t num, const char inputFile[], const int8_t port,
+                                     __attribute__((unused)) const int8_t resetSeek) {
+	if (outbuf == NULL || inputFile == NULL) {
+		fprintf(stderr, "ERROR %s: Passed nullptr (outbuf: %p, inputFile %p), exiting.\n", __func__, outbuf, inputFile);
+		return -1;
+	}
+
+	lofar_udp_io_hdf5_reader *hdf5 = _lofar_udp_io_HDF5_open(inputFile, port);
+	if (hdf5 == NULL) {
+		return -1;
+	}
+
+	const int64_t readlen = _lofar_udp_io_HDF5_copy(hdf5, outbuf, size * num);
+	_lofar_udp_io_HDF5_close(hdf5);
+
+	if (readlen != size * num) {
+		fprintf(stderr, "Unable to read %ld elements from HDF5 file %s, exiting.\n", size * num, inputFile);
+		return -1;
+	}
+
+	return readlen;
 }
 
 
@@ -613,6 +913,239 @@ static int32_t hdf5SetupBoolAttrs(hid_t group, const strKeyBoolVal attrs[], size
 	return 0;
 }
 
+// The thread safety of the linked HDF5 build cannot be assumed, and every output shares a file, so calls into HDF5 from concurrent
+// outputs take turns. The direct chunk writer only holds the lock to commit chunks, compression happens outside of it.
+static pthread_mutex_t hdf5WriteLock = PTHREAD_MUTEX_INITIALIZER;
+
+// Bitshuffle filter chunks start with the big endian uncompressed length (uint64) and block size in bytes (uint32)
+#define BSHUF_CHUNK_HEADER_SIZE 12
+
+/**
+ * @brief      Get the largest possible size of a compressed chunk, including the bitshuffle header
+ *
+ * @param[in]  config  The configuration
+ *
+ * @return     The size in bytes
+ */
+static size_t _lofar_udp_io_write_HDF5_chunk_bound(const lofar_udp_io_write_config *const config) {
+	const size_t elementSize = config->hdf5Writer.elementSize;
+	return BSHUF_CHUNK_HEADER_SIZE + bshuf_compress_zstd_bound(HDF5_WRITE_CHUNK_ROWS * HDF5_WRITE_CHUNK_CHANNELS, elementSize, bshuf_default_block_size(elementSize));
+}
+
+/**
+ * @brief      Allocate the buffers used by the direct chunk writer for an output, once its dataset shape is known
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_write_HDF5_direct_setup(lofar_udp_io_write_config *const config, const int8_t outp) {
+	const size_t elementSize = config->hdf5Writer.elementSize;
+	const size_t rowBytes = config->hdf5Writer.hdf5DSetWriter[outp].dims[1] * elementSize;
+
+	FREE_NOT_NULL(config->hdf5Writer.hdf5DSetWriter[outp].staging);
+	FREE_NOT_NULL(config->hdf5Writer.hdf5DSetWriter[outp].chunkBuffer);
+	FREE_NOT_NULL(config->hdf5Writer.hdf5DSetWriter[outp].compressedBuffer);
+	FREE_NOT_NULL(config->hdf5Writer.hdf5DSetWriter[outp].compressedSizes);
+	config->hdf5Writer.hdf5DSetWriter[outp].staging = calloc(HDF5_WRITE_CHUNK_ROWS * rowBytes, sizeof(int8_t));
+	config->hdf5Writer.hdf5DSetWriter[outp].chunkBuffer = calloc(HDF5_WRITE_CHUNK_BATCH * HDF5_WRITE_CHUNK_ROWS * HDF5_WRITE_CHUNK_CHANNELS * elementSize, sizeof(int8_t));
+	config->hdf5Writer.hdf5DSetWriter[outp].compressedBuffer = calloc(HDF5_WRITE_CHUNK_BATCH * _lofar_udp_io_write_HDF5_chunk_bound(config), sizeof(int8_t));
+	config->hdf5Writer.hdf5DSetWriter[outp].compressedSizes = calloc(HDF5_WRITE_CHUNK_BATCH, sizeof(int64_t));
+	config->hdf5Writer.hdf5DSetWriter[outp].stagedRows = 0;
+	config->hdf5Writer.hdf5DSetWriter[outp].writtenRows = 0;
+
+	if (config->hdf5Writer.hdf5DSetWriter[outp].staging == NULL || config->hdf5Writer.hdf5DSetWriter[outp].chunkBuffer == NULL
+		|| config->hdf5Writer.hdf5DSetWriter[outp].compressedBuffer == NULL || config->hdf5Writer.hdf5DSetWriter[outp].compressedSizes == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to allocate chunk buffers for HDF5 output %d, exiting.\n", __func__, outp);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Release the buffers used by the direct chunk writer for an output
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ */
+static void _lofar_udp_io_write_HDF5_direct_cleanup(lofar_udp_io_write_config *const config, const int8_t outp) {
+	FREE_NOT_NULL(config->hdf5Writer.hdf5DSetWriter[outp].staging);
+	FREE_NOT_NULL(config->hdf5Writer.hdf5DSetWriter[outp].chunkBuffer);
+	FREE_NOT_NULL(config->hdf5Writer.hdf5DSetWriter[outp].compressedBuffer);
+	FREE_NOT_NULL(config->hdf5Writer.hdf5DSetWriter[outp].compressedSizes);
+	config->hdf5Writer.hdf5DSetWriter[outp].stagedRows = 0;
+}
+
+/**
+ * @brief      Compress rows of an output's data into bitshuffle + zstandard chunks, in parallel batches, then commit them to the dataset
+ * 				after the rows already written. Chunks at the edges of the data are padded to the full chunk shape.
+ *
+ * @param[in]  config   The configuration
+ * @param[in]  outp     The outp
+ * @param[in]  src      The rows of data
+ * @param[in]  numRows  The number of rows, a multiple of HDF5_WRITE_CHUNK_ROWS unless this is the final write
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_write_HDF5_chunks(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const hsize_t numRows) {
+	const size_t elementSize = config->hdf5Writer.elementSize;
+	const hsize_t channels = config->hdf5Writer.hdf5DSetWriter[outp].dims[1];
+	const size_t rowBytes = channels * elementSize;
+	const size_t chunkElements = HDF5_WRITE_CHUNK_ROWS * HDF5_WRITE_CHUNK_CHANNELS;
+	const size_t chunkBytes = chunkElements * elementSize;
+	const size_t chunkBound = _lofar_udp_io_write_HDF5_chunk_bound(config);
+	const size_t blockSize = bshuf_default_block_size(elementSize);
+	const int64_t chunkRows = (int64_t) ((numRows + HDF5_WRITE_CHUNK_ROWS - 1) / HDF5_WRITE_CHUNK_ROWS);
+	const int64_t chunksPerRow = (int64_t) ((channels + HDF5_WRITE_CHUNK_CHANNELS - 1) / HDF5_WRITE_CHUNK_CHANNELS);
+	const int64_t numChunks = chunkRows * chunksPerRow;
+	int8_t *chunkBuffer = config->hdf5Writer.hdf5DSetWriter[outp].chunkBuffer;
+	int8_t *compressedBuffer = config->hdf5Writer.hdf5DSetWriter[outp].compressedBuffer;
+	int64_t *compressedSizes = config->hdf5Writer.hdf5DSetWriter[outp].compressedSizes;
+
+	for (int64_t batchStart = 0; batchStart < numChunks; batchStart += HDF5_WRITE_CHUNK_BATCH) {
+		const int64_t batchLength = (numChunks - batchStart) < HDF5_WRITE_CHUNK_BATCH ? (numChunks - batchStart) : HDF5_WRITE_CHUNK_BATCH;
+
+		// The library does not enable nested parallelism (the OMP_NESTED define is not applied), so under lofar_udp_io_write_all() this
+		// is a team of one and the outputs are compressed in parallel instead. Individual (and background) writes use the full team.
+		#pragma omp parallel for default(shared) schedule(dynamic)
+		for (int64_t slot = 0; slot < batchLength; slot++) {
+			const int64_t chunk = batchStart + slot;
+			const hsize_t firstRow = (hsize_t) (chunk / chunksPerRow) * HDF5_WRITE_CHUNK_ROWS;
+			const hsize_t firstChannel = (hsize_t) (chunk % chunksPerRow) * HDF5_WRITE_CHUNK_CHANNELS;
+			const hsize_t rows = (numRows - firstRow) < HDF5_WRITE_CHUNK_ROWS ? (numRows - firstRow) : HDF5_WRITE_CHUNK_ROWS;
+			const size_t channelBytes = ((channels - firstChannel) < HDF5_WRITE_CHUNK_CHANNELS ? (channels - firstChannel) : HDF5_WRITE_CHUNK_CHANNELS) * elementSize;
+			int8_t *gathered = &(chunkBuffer[slot * chunkBytes]);
+			uint8_t *compressed = (uint8_t *) &(compressedBuffer[slot * chunkBound]);
+
+			if (rows < HDF5_WRITE_CHUNK_ROWS || channelBytes < HDF5_WRITE_CHUNK_CHANNELS * elementSize) {
+				memset(gathered, 0, chunkBytes);
+			}
+			for (hsize_t row = 0; row < rows; row++) {
+				memcpy(&(gathered[row * HDF5_WRITE_CHUNK_CHANNELS * elementSize]), &(src[(firstRow + row) * rowBytes + firstChannel * elementSize]), channelBytes);
+			}
+
+			for (int32_t byte = 0; byte < 8; byte++) {
+				compressed[byte] = (uint8_t) (((uint64_t) chunkBytes >> (8 * (7 - byte))) & 0xFF);
+			}
+			for (int32_t byte = 0; byte < 4; byte++) {
+				compressed[8 + byte] = (uint8_t) (((uint32_t) (blockSize * elementSize) >> (8 * (3 - byte))) & 0xFF);
+			}
+			const int64_t compressedLength = bshuf_compress_zstd(gathered, &(compressed[BSHUF_CHUNK_HEADER_SIZE]), chunkElements, elementSize, blockSize, config->zstdConfig.compressionLevel);
+			compressedSizes[slot] = compressedLength < 0 ? compressedLength : compressedLength + BSHUF_CHUNK_HEADER_SIZE;
+		}
+
+		pthread_mutex_lock(&hdf5WriteLock);
+		for (int64_t slot = 0; slot < batchLength; slot++) {
+			const int64_t chunk = batchStart + slot;
+			const hsize_t offset[2] = { config->hdf5Writer.hdf5DSetWriter[outp].writtenRows + (hsize_t) (chunk / chunksPerRow) * HDF5_WRITE_CHUNK_ROWS,
+			                            (hsize_t) (chunk % chunksPerRow) * HDF5_WRITE_CHUNK_CHANNELS };
+			if (compressedSizes[slot] < 0) {
+				pthread_mutex_unlock(&hdf5WriteLock);
+				fprintf(stderr, "ERROR %s: Failed to compress chunk (%llu, %llu) of HDF5 output %d (%ld), exiting.\n", __func__, offset[0], offset[1], outp, compressedSizes[slot]);
+				return -1;
+			}
+
+			herr_t status;
+			if ((status = H5Dwrite_chunk(config->hdf5Writer.hdf5DSetWriter[outp].dset, H5P_DEFAULT, 0, offset, compressedSizes[slot], &(compressedBuffer[slot * chunkBound]))) < 0) {
+				pthread_mutex_unlock(&hdf5WriteLock);
+				H5Eprint(status, stderr);
+				fprintf(stderr, "ERROR %s: Failed to write chunk (%llu, %llu) to HDF5 output %d, exiting.\n", __func__, offset[0], offset[1], outp);
+				return -1;
+			}
+		}
+		pthread_mutex_unlock(&hdf5WriteLock);
+	}
+
+	config->hdf5Writer.hdf5DSetWriter[outp].writtenRows += (hsize_t) chunkRows * HDF5_WRITE_CHUNK_ROWS;
+	return 0;
+}
+
+/**
+ * @brief      Extend an output's dataset, then write its data as whole chunks. Rows that do not fill a chunk row are held until they
+ * 				do, or the output is closed. Only whole rows (channels) can be written, trailing bytes of a partial row are dropped.
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ * @param[in]  src     The source
+ * @param[in]  nchars  The nchars
+ *
+ * @return  >=0: Number of bytes written (short of nchars if the data ended in a partial row), <0: Failure
+ */
+static int64_t _lofar_udp_io_write_HDF5_direct(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
+	const size_t rowBytes = config->hdf5Writer.hdf5DSetWriter[outp].dims[1] * config->hdf5Writer.elementSize;
+	const hsize_t rows = nchars / rowBytes;
+	int8_t *staging = config->hdf5Writer.hdf5DSetWriter[outp].staging;
+
+	if ((hsize_t) nchars != rows * rowBytes) {
+		fprintf(stderr, "ERROR %s: Write of %ld bytes to HDF5 output %d is not a whole number of %ld byte rows, dropping the final %ld bytes.\n", __func__, nchars, outp, rowBytes, nchars - (int64_t) (rows * rowBytes));
+	}
+
+	// Chunks can only be written inside the dataset's extent
+	pthread_mutex_lock(&hdf5WriteLock);
+	config->hdf5Writer.hdf5DSetWriter[outp].dims[0] += rows;
+	const herr_t status = H5Dset_extent(config->hdf5Writer.hdf5DSetWriter[outp].dset, config->hdf5Writer.hdf5DSetWriter[outp].dims);
+	pthread_mutex_unlock(&hdf5WriteLock);
+	if (status < 0) {
+		H5Eprint(status, stderr);
+		fprintf(stderr, "ERROR %s: Failed to extend HDF5 output %d by %llu rows, exiting.\n", __func__, outp, rows);
+		return -1;
+	}
+
+	// Complete a partially filled chunk row first
+	hsize_t consumed = 0;
+	if (config->hdf5Writer.hdf5DSetWriter[outp].stagedRows > 0) {
+		const hsize_t space = HDF5_WRITE_CHUNK_ROWS - config->hdf5Writer.hdf5DSetWriter[outp].stagedRows;
+		consumed = rows < space ? rows : space;
+		memcpy(&(staging[config->hdf5Writer.hdf5DSetWriter[outp].stagedRows * rowBytes]), src, consumed * rowBytes);
+		config->hdf5Writer.hdf5DSetWriter[outp].stagedRows += consumed;
+
+		if (config->hdf5Writer.hdf5DSetWriter[outp].stagedRows == HDF5_WRITE_CHUNK_ROWS) {
+			if (_lofar_udp_io_write_HDF5_chunks(config, outp, staging, HDF5_WRITE_CHUNK_ROWS) < 0) {
+				return -1;
+			}
+			config->hdf5Writer.hdf5DSetWriter[outp].stagedRows = 0;
+		}
+	}
+
+	// Whole chunk rows are compressed straight from the input
+	const hsize_t wholeRows = ((rows - consumed) / HDF5_WRITE_CHUNK_ROWS) * HDF5_WRITE_CHUNK_ROWS;
+	if (wholeRows > 0 && _lofar_udp_io_write_HDF5_chunks(config, outp, &(src[consumed * rowBytes]), wholeRows) < 0) {
+		return -1;
+	}
+	consumed += wholeRows;
+
+	// Hold the remainder for the next write
+	if (consumed < rows) {
+		memcpy(&(staging[config->hdf5Writer.hdf5DSetWriter[outp].stagedRows * rowBytes]), &(src[consumed * rowBytes]), (rows - consumed) * rowBytes);
+		config->hdf5Writer.hdf5DSetWriter[outp].stagedRows += rows - consumed;
+	}
+
+	return (int64_t) (rows * rowBytes);
+}
+
+/**
+ * @brief      Write any rows held by the direct chunk writer for an output, as a final partial chunk row
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_write_HDF5_direct_flush(lofar_udp_io_write_config *const config, const int8_t outp) {
+	if (config->hdf5Writer.hdf5DSetWriter[outp].stagedRows == 0 || config->hdf5Writer.hdf5DSetWriter[outp].staging == NULL) {
+		return 0;
+	}
+
+	if (_lofar_udp_io_write_HDF5_chunks(config, outp, config->hdf5Writer.hdf5DSetWriter[outp].staging, config->hdf5Writer.hdf5DSetWriter[outp].stagedRows) < 0) {
+		return -1;
+	}
+	config->hdf5Writer.hdf5DSetWriter[outp].stagedRows = 0;
+
+	return 0;
+}
+
 int64_t _lofar_udp_io_write_metadata_HDF5(lofar_udp_io_write_config *const config, const lofar_udp_metadata *metadata) {
 	hid_t group;
 	hsize_t dims[2] = { 1 };
@@ -1126,7 +1659,7 @@ int64_t _lofar_udp_io_write_metadata_HDF5(lofar_udp_io_write_config *const confi
 		hid_t dataspace;
 		int32_t rank = 2;
 		hsize_t maxdims[2] = { H5S_UNLIMITED, H5S_UNLIMITED };
-		hsize_t chunk_dims[2] = { 4096, 32 };
+		hsize_t chunk_dims[2] = { HDF5_WRITE_CHUNK_ROWS, HDF5_WRITE_CHUNK_CHANNELS };
 		H5_ERR_CHECK(status, H5Pset_chunk(prop, rank, chunk_dims));
 		char dsetName[DEF_STR_LEN], componentStr[16] = "";
 		const char delim = '-';
@@ -1146,6 +1679,9 @@ int64_t _lofar_udp_io_write_metadata_HDF5(lofar_udp_io_write_config *const confi
 			if ((status = H5Pset_filter(prop, BSHUF_H5FILTER, H5Z_FLAG_OPTIONAL, numFlags, (const uint32_t *) bitshuffleFlags)) < 0) {
 				H5Eprint(status, stderr);
 				fprintf(stderr, "ERROR: Failed to find default HDF5 compression plugin (BitShuffle, %d), falling back to no compression.\n", BSHUF_H5FILTER);
+			} else {
+				// We can produce the filter's chunks ourselves, in parallel
+				config->hdf5Writer.directChunks = 1;
 			}
 		}
 
@@ -1160,7 +1696,7 @@ int64_t _lofar_udp_io_write_metadata_HDF5(lofar_udp_io_write_config *const confi
 		}
 		int8_t outputs = 0;
 		VERBOSE(printf("Loop\n"));
-		for (int8_t i = 0; i < MAX_OUTPUT_DIMS; i++) {
+		for (int8_t i = 0; i < metadata->allocatedOutputs && outputs < config->allocatedOutputs; i++) {
 			if (metadata->upm_rel_outputs[i]) {
 				config->hdf5Writer.hdf5DSetWriter[outputs].dims[0] = 0;
 				config->hdf5Writer.hdf5DSetWriter[outputs].dims[1] = metadata->nchan;
@@ -1199,6 +1735,10 @@ int64_t _lofar_udp_io_write_metadata_HDF5(lofar_udp_io_write_config *const confi
 				};
 				H5D_SET_ATTRS(config->hdf5Writer.hdf5DSetWriter[outputs].dset, dsetLongAttrs, hdf5SetupLongAttrs);
 
+				if (config->hdf5Writer.directChunks && _lofar_udp_io_write_HDF5_direct_setup(config, outputs) < 0) {
+					return -1;
+				}
+
 				outputs++;
 			}
 		}
@@ -1251,7 +1791,7 @@ int64_t _lofar_udp_io_write_metadata_HDF5(lofar_udp_io_write_config *const confi
 }
 
 /**
- * @brief      Perform a data write for a HDF5 file
+ * @brief      Extend an output's dataset and write a block of data to it
  *
  * @param[in]  config  The configuration
  * @param[in]  outp    The outp
@@ -1260,7 +1800,7 @@ int64_t _lofar_udp_io_write_metadata_HDF5(lofar_udp_io_write_config *const confi
  *
  * @return  >=0: Number of bytes written, <0: Failure
  */
-int64_t _lofar_udp_io_write_HDF5(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
+static int64_t _lofar_udp_io_write_HDF5_dataset(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
 	if (!config->hdf5Writer.initialised || !config->hdf5Writer.metadataInitialised) {
 		fprintf(stderr, "ERROR %s: HDF5 writer not fully initialised (writer: %d, metadata: %d), exiting.\n", __func__, config->hdf5Writer.initialised, config->hdf5Writer.metadataInitialised);
 		return -1;
@@ -1302,6 +1842,28 @@ int64_t _lofar_udp_io_write_HDF5(lofar_udp_io_write_config *const config, const
 	return nchars;
 }
 
+/**
+ * @brief      Perform a data write for a HDF5 file
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ * @param[in]  src     The source
+ * @param[in]  nchars  The nchars
+ *
+ * @return  >=0: Number of bytes written, <0: Failure
+ */
+int64_t _lofar_udp_io_write_HDF5(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
+	if (config->hdf5Writer.directChunks && config->hdf5Writer.initialised && config->hdf5Writer.metadataInitialised) {
+		return _lofar_udp_io_write_HDF5_direct(config, outp, src, nchars);
+	}
+
+	pthread_mutex_lock(&hdf5WriteLock);
+	const int64_t returnVal = _lofar_udp_io_write_HDF5_dataset(config, outp, src, nchars);
+	pthread_mutex_unlock(&hdf5WriteLock);
+
+	return returnVal;
+}
+
 /**
  * @brief      Cleanup HDF5 file references for the write I/O struct
  *
@@ -1314,6 +1876,14 @@ void _lofar_udp_io_write_cleanup_HDF5(lofar_udp_io_write_config *const config, c
 		return;
 	}
 
+	// Rows held by the direct chunk writer must be written before the dataset is closed
+	for (int8_t out = (fullClean ? 0 : outp); out < (fullClean ? config->numOutputs : outp + 1); out++) {
+		if (_lofar_udp_io_write_HDF5_direct_flush(config, out) < 0) {
+			fprintf(stderr, "WARNING %s: Failed to write the final rows of HDF5 output %d, the output may be truncated.\n", __func__, out);
+		}
+		_lofar_udp_io_write_HDF5_direct_cleanup(config, out);
+	}
+
 	if (!fullClean) {
 		H5Dclose(config->hdf5Writer.hdf5DSetWriter[outp].dset);
 		config->hdf5Writer.hdf5DSetWriter[outp].dset = -1;
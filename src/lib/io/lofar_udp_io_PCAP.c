@@ -0,0 +1,657 @@
+
+// pcap/pcapng reader state for a single port
+struct lofar_udp_io_pcap_reader {
+	// Regular files are memory mapped, other sources (FIFOs) are streamed through fileRef
+	FILE *fileRef;
+	const uint8_t *map;
+	int64_t mapSize;
+	int64_t mapPos;
+	int64_t mapReleased;
+
+	// Stream sources copy each record into this buffer
+	uint8_t *recordBuffer;
+	int64_t recordBufferSize;
+
+	// Capture format
+	int8_t pcapng;
+	int8_t swapped;
+	int32_t numInterfaces;
+	uint16_t linkTypes[PCAP_MAX_INTERFACES];
+
+	// UDP destination port to keep, -1 to keep every UDP datagram
+	int32_t udpPort;
+
+	// Remainder of the payload currently being copied out, and the start of that payload
+	const uint8_t *payload;
+	int64_t payloadLength;
+	const uint8_t *payloadStart;
+
+	// Matching datagrams dropped as they were truncated or fragmented in the capture
+	int64_t packetsSkipped;
+
+	char inputLocation[DEF_STR_LEN + 1];
+};
+
+// Stream readers opened by temporary reads, kept with the first payload unconsumed so that the reader can adopt them
+// (grown as needed, slots are cleared when adopted)
+static lofar_udp_io_pcap_reader **pcapPendingReaders = NULL;
+static int32_t pcapPendingCount = 0;
+
+// Capture file constants
+#define PCAP_MAGIC_USEC 0xa1b2c3d4u
+#define PCAP_MAGIC_NSEC 0xa1b23c4du
+#define PCAP_GLOBAL_HDR_LEN 24
+#define PCAP_RECORD_HDR_LEN 16
+#define PCAPNG_BLOCK_SHB 0x0a0d0d0au
+#define PCAPNG_BLOCK_IDB 0x00000001u
+#define PCAPNG_BLOCK_SPB 0x00000003u
+#define PCAPNG_BLOCK_EPB 0x00000006u
+#define PCAPNG_BYTE_ORDER_MAGIC 0x1a2b3c4du
+
+// Link layer types
+#define PCAP_LINKTYPE_NULL 0
+#define PCAP_LINKTYPE_ETHERNET 1
+#define PCAP_LINKTYPE_RAW_OPENBSD 12
+#define PCAP_LINKTYPE_RAW 101
+#define PCAP_LINKTYPE_LINUX_SLL 113
+#define PCAP_LINKTYPE_LINUX_SLL2 276
+
+
+static inline uint16_t _lofar_udp_io_PCAP_u16(const lofar_udp_io_pcap_reader *pcap, const uint8_t *src) {
+	uint16_t val;
+	memcpy(&val, src, sizeof(val));
+	return pcap->swapped ? __builtin_bswap16(val) : val;
+}
+
+static inline uint32_t _lofar_udp_io_PCAP_u32(const lofar_udp_io_pcap_reader *pcap, const uint8_t *src) {
+	uint32_t val;
+	memcpy(&val, src, sizeof(val));
+	return pcap->swapped ? __builtin_bswap32(val) : val;
+}
+
+// Network (big endian) fields in the packet headers
+static inline uint16_t _lofar_udp_io_PCAP_net16(const uint8_t *src) {
+	return (uint16_t) ((src[0] << 8) | src[1]);
+}
+
+/**
+ * @brief      Get the next bytes of a capture, either in place from the mapping or copied into the record buffer
+ *             (valid until the next call) for stream sources
+ *
+ * @param      pcap    The pcap reader
+ * @param[in]  nbytes  The number of bytes to consume
+ *
+ * @return     Pointer to the bytes, NULL at the end of the capture or on failure
+ */
+static const uint8_t* _lofar_udp_io_PCAP_consume(lofar_udp_io_pcap_reader *pcap, const int64_t nbytes) {
+	if (nbytes < 0) {
+		return NULL;
+	}
+
+	if (pcap->map != NULL) {
+		if (nbytes > pcap->mapSize - pcap->mapPos) {
+			return NULL;
+		}
+		const uint8_t *bytes = pcap->map + pcap->mapPos;
+		pcap->mapPos += nbytes;
+		return bytes;
+	}
+
+	if (nbytes > pcap->recordBufferSize) {
+		uint8_t *tmp = realloc(pcap->recordBuffer, nbytes);
+		CHECK_ALLOC_NOCLEAN(tmp, NULL);
+		pcap->recordBuffer = tmp;
+		pcap->recordBufferSize = nbytes;
+	}
+	if (nbytes > 0 && (int64_t) fread(pcap->recordBuffer, sizeof(uint8_t), nbytes, pcap->fileRef) != nbytes) {
+		return NULL;
+	}
+	return pcap->recordBuffer;
+}
+
+/**
+ * @brief      Parse the byte order and version of a pcapng section header block
+ *
+ * @param      pcap    The pcap reader
+ * @param[in]  header  The first 12 bytes of the block (type, length, byte order magic)
+ *
+ * @return     >0: Remaining block length, <0: Failure
+ */
+static int64_t _lofar_udp_io_PCAP_section_header(lofar_udp_io_pcap_reader *pcap, const uint8_t *header) {
+	uint32_t magic;
+	memcpy(&magic, &(header[8]), sizeof(magic));
+	if (magic == PCAPNG_BYTE_ORDER_MAGIC) {
+		pcap->swapped = 0;
+	} else if (magic == __builtin_bswap32(PCAPNG_BYTE_ORDER_MAGIC)) {
+		pcap->swapped = 1;
+	} else {
+		fprintf(stderr, "ERROR %s: Invalid pcapng byte order magic (0x%08x), exiting.\n", __func__, magic);
+		return -1;
+	}
+
+	// Interfaces are defined per section
+	pcap->numInterfaces = 0;
+	const int64_t blockLength = _lofar_udp_io_PCAP_u32(pcap, &(header[4]));
+	if (blockLength < 28 || blockLength % 4) {
+		fprintf(stderr, "ERROR %s: Invalid pcapng section header length (%ld), exiting.\n", __func__, blockLength);
+		return -1;
+	}
+	return blockLength - 12;
+}
+
+/**
+ * @brief      Release the resources held by a capture reader
+ *
+ * @param      pcap  The pcap reader
+ */
+static void _lofar_udp_io_PCAP_close(lofar_udp_io_pcap_reader *pcap) {
+	if (pcap == NULL) {
+		return;
+	}
+
+	if (pcap->map != NULL) {
+		munmap((void *) pcap->map, pcap->mapSize);
+	}
+	if (pcap->fileRef != NULL) {
+		fclose(pcap->fileRef);
+	}
+	FREE_NOT_NULL(pcap->recordBuffer);
+	free(pcap);
+}
+
+/**
+ * @brief      Open a capture and parse its file header
+ *
+ * @param[in]  inputLocation  "file[@udpPort]"
+ *
+ * @return     Reader pointer: Success, NULL: Failure
+ */
+static lofar_udp_io_pcap_reader* _lofar_udp_io_PCAP_open(const char inputLocation[]) {
+	char fileName[DEF_STR_LEN + 1];
+	strncpy(fileName, inputLocation, DEF_STR_LEN);
+	fileName[DEF_STR_LEN] = '\0';
+
+	int32_t udpPort = -1;
+	char *separator = strrchr(fileName, '@');
+	if (separator != NULL) {
+		char *endPtr;
+		errno = 0;
+		const long parsedPort = strtol(separator + 1, &endPtr, 10);
+		if (errno != 0 || endPtr == (separator + 1) || *endPtr != '\0' || parsedPort < 0 || parsedPort > 65535) {
+			fprintf(stderr, "ERROR %s: Failed to parse UDP port from %s, exiting.\n", __func__, inputLocation);
+			return NULL;
+		}
+		udpPort = (int32_t) parsedPort;
+		*separator = '\0';
+	}
+
+	lofar_udp_io_pcap_reader *pcap = calloc(1, sizeof(lofar_udp_io_pcap_reader));
+	CHECK_ALLOC_NOCLEAN(pcap, NULL);
+	pcap->udpPort = udpPort;
+	strncpy(pcap->inputLocation, inputLocation, DEF_STR_LEN);
+
+	VERBOSE(printf("Opening pcap capture at %s (UDP port %d)\n", fileName, udpPort));
+	if ((pcap->fileRef = fopen(fileName, "rb")) == NULL) {
+		fprintf(stderr, "ERROR: Failed to open capture at %s: errno %d, %s.\n", fileName, errno, strerror(errno));
+		FREE_NOT_NULL(pcap);
+		return NULL;
+	}
+
+	// Regular files are mapped and parsed in place, following the zstandard reader
+	struct stat fileStat;
+	if (fstat(fileno(pcap->fileRef), &fileStat) == 0 && S_ISREG(fileStat.st_mode) && fileStat.st_size > 0) {
+		void *tmpPtr = mmap(NULL, fileStat.st_size, PROT_READ, MAP_PRIVATE, fileno(pcap->fileRef), 0);
+		if (tmpPtr == MAP_FAILED) {
+			fprintf(stderr, "ERROR: Failed to create memory mapping for capture %s. Errno: %d (%s). Exiting.\n", fileName, errno, strerror(errno));
+			fclose(pcap->fileRef);
+			FREE_NOT_NULL(pcap);
+			return NULL;
+		}
+		if (madvise(tmpPtr, fileStat.st_size, MADV_SEQUENTIAL) == -1) {
+			fprintf(stderr, "WARNING: Failed to advise the kernel on mmap read strategy for %s (errno %d: %s), continuing.\n", fileName, errno, strerror(errno));
+		}
+		pcap->map = tmpPtr;
+		pcap->mapSize = fileStat.st_size;
+	}
+
+	const uint8_t *header = _lofar_udp_io_PCAP_consume(pcap, 12);
+	if (header == NULL) {
+		fprintf(stderr, "ERROR %s: Capture %s is too short to contain a header, exiting.\n", __func__, fileName);
+		_lofar_udp_io_PCAP_close(pcap);
+		return NULL;
+	}
+
+	uint32_t magic;
+	memcpy(&magic, header, sizeof(magic));
+	if (magic == PCAPNG_BLOCK_SHB) {
+		// The remainder of the section header (options) is not needed
+		const int64_t remaining = _lofar_udp_io_PCAP_section_header(pcap, header);
+		pcap->pcapng = 1;
+		if (remaining < 0 || _lofar_udp_io_PCAP_consume(pcap, remaining) == NULL) {
+			_lofar_udp_io_PCAP_close(pcap);
+			return NULL;
+		}
+	} else if (magic == PCAP_MAGIC_USEC || magic == PCAP_MAGIC_NSEC || magic == __builtin_bswap32(PCAP_MAGIC_USEC) || magic == __builtin_bswap32(PCAP_MAGIC_NSEC)) {
+		pcap->swapped = (magic != PCAP_MAGIC_USEC && magic != PCAP_MAGIC_NSEC);
+		const uint8_t *remaining = _lofar_udp_io_PCAP_consume(pcap, PCAP_GLOBAL_HDR_LEN - 12);
+		if (remaining == NULL) {
+			fprintf(stderr, "ERROR %s: Capture %s is too short to contain a header, exiting.\n", __func__, fileName);
+			_lofar_udp_io_PCAP_close(pcap);
+			return NULL;
+		}
+		// Link type is the last field of the global header
+		pcap->linkTypes[0] = (uint16_t) _lofar_udp_io_PCAP_u32(pcap, &(remaining[8]));
+		pcap->numInterfaces = 1;
+	} else {
+		fprintf(stderr, "ERROR %s: %s is not a pcap or pcapng capture (magic 0x%08x), exiting.\n", __func__, fileName, magic);
+		_lofar_udp_io_PCAP_close(pcap);
+		return NULL;
+	}
+
+	return pcap;
+}
+
+/**
+ * @brief      Strip the link, network and transport layers from a captured frame, finding the UDP payload
+ *
+ * @param      pcap      The pcap reader
+ * @param[in]  linkType  The link layer type of the frame
+ * @param[in]  frame     The captured frame
+ * @param[in]  capLen    The captured length of the frame
+ *
+ * @return     1: Payload found, 0: Frame not selected
+ */
+static int32_t _lofar_udp_io_PCAP_frame(lofar_udp_io_pcap_reader *pcap, const uint16_t linkType, const uint8_t *frame, const int64_t capLen) {
+	int64_t offset;
+	uint16_t etherType;
+	switch (linkType) {
+		case PCAP_LINKTYPE_ETHERNET:
+			offset = 14;
+			if (capLen < offset) return 0;
+			etherType = _lofar_udp_io_PCAP_net16(&(frame[12]));
+			// Skip over any 802.1Q/802.1ad VLAN tags
+			while ((etherType == 0x8100 || etherType == 0x88a8) && capLen >= offset + 4) {
+				etherType = _lofar_udp_io_PCAP_net16(&(frame[offset + 2]));
+				offset += 4;
+			}
+			break;
+
+		case PCAP_LINKTYPE_LINUX_SLL:
+			offset = 16;
+			if (capLen < offset) return 0;
+			etherType = _lofar_udp_io_PCAP_net16(&(frame[14]));
+			break;
+
+		case PCAP_LINKTYPE_LINUX_SLL2:
+			offset = 20;
+			if (capLen < offset) return 0;
+			etherType = _lofar_udp_io_PCAP_net16(&(frame[0]));
+			break;
+
+		case PCAP_LINKTYPE_NULL:
+		case PCAP_LINKTYPE_RAW:
+		case PCAP_LINKTYPE_RAW_OPENBSD:
+			offset = (linkType == PCAP_LINKTYPE_NULL) ? 4 : 0;
+			if (capLen < offset + 1) return 0;
+			// Determine the protocol from the IP version
+			etherType = ((frame[offset] >> 4) == 4) ? 0x0800 : (((frame[offset] >> 4) == 6) ? 0x86dd : 0);
+			break;
+
+		default:
+			return 0;
+	}
+
+	if (etherType == 0x0800) {
+		if (capLen < offset + 20 || (frame[offset] >> 4) != 4 || frame[offset + 9] != IPPROTO_UDP) return 0;
+		// Fragmented datagrams cannot be rebuilt from a single record
+		if (_lofar_udp_io_PCAP_net16(&(frame[offset + 6])) & 0x3fff) {
+			pcap->packetsSkipped++;
+			return 0;
+		}
+		offset += (frame[offset] & 0x0f) * 4;
+	} else if (etherType == 0x86dd) {
+		if (capLen < offset + 40 || frame[offset + 6] != IPPROTO_UDP) return 0;
+		offset += 40;
+	} else {
+		return 0;
+	}
+
+	if (capLen < offset + 8) return 0;
+	const uint16_t destPort = _lofar_udp_io_PCAP_net16(&(frame[offset + 2]));
+	if (pcap->udpPort > -1 && destPort != pcap->udpPort) return 0;
+
+	const int64_t payloadLength = (int64_t) _lofar_udp_io_PCAP_net16(&(frame[offset + 4])) - 8;
+	if (payloadLength < 1) return 0;
+	// Records truncated by the capture snap length cannot be used
+	if (offset + 8 + payloadLength > capLen) {
+		pcap->packetsSkipped++;
+		return 0;
+	}
+
+	pcap->payload = &(frame[offset + 8]);
+	pcap->payloadStart = pcap->payload;
+	pcap->payloadLength = payloadLength;
+	return 1;
+}
+
+/**
+ * @brief      Advance through the capture to the next UDP payload for the reader's port
+ *
+ * @param      pcap  The pcap reader
+ *
+ * @return     1: Payload found, 0: End of capture, <0: Failure
+ */
+static int32_t _lofar_udp_io_PCAP_next_payload(lofar_udp_io_pcap_reader *pcap) {
+	while (1) {
+		if (!pcap->pcapng) {
+			const uint8_t *record = _lofar_udp_io_PCAP_consume(pcap, PCAP_RECORD_HDR_LEN);
+			if (record == NULL) {
+				return 0;
+			}
+			const int64_t capLen = _lofar_udp_io_PCAP_u32(pcap, &(record[8]));
+			const uint8_t *frame = _lofar_udp_io_PCAP_consume(pcap, capLen);
+			if (frame == NULL) {
+				return 0;
+			}
+			if (_lofar_udp_io_PCAP_frame(pcap, pcap->linkTypes[0], frame, capLen)) {
+				return 1;
+			}
+			continue;
+		}
+
+		const uint8_t *header = _lofar_udp_io_PCAP_consume(pcap, 8);
+		if (header == NULL) {
+			return 0;
+		}
+		uint32_t blockType;
+		memcpy(&blockType, header, sizeof(blockType));
+
+		// Section headers may change the byte order, so the length can only be parsed after the byte order magic
+		if (blockType == PCAPNG_BLOCK_SHB) {
+			uint8_t sectionHeader[12];
+			memcpy(sectionHeader, header, 8);
+			const uint8_t *magic = _lofar_udp_io_PCAP_consume(pcap, 4);
+			if (magic == NULL) {
+				return 0;
+			}
+			memcpy(&(sectionHeader[8]), magic, 4);
+			const int64_t remaining = _lofar_udp_io_PCAP_section_header(pcap, sectionHeader);
+			if (remaining < 0) {
+				return -1;
+			}
+			if (_lofar_udp_io_PCAP_consume(pcap, remaining) == NULL) {
+				return 0;
+			}
+			continue;
+		}
+
+		blockType = _lofar_udp_io_PCAP_u32(pcap, header);
+		const int64_t blockLength = _lofar_udp_io_PCAP_u32(pcap, &(header[4]));
+		if (blockLength < 12 || blockLength % 4) {
+			fprintf(stderr, "ERROR %s: Invalid pcapng block length (%ld) in %s, exiting.\n", __func__, blockLength, pcap->inputLocation);
+			return -1;
+		}
+		const uint8_t *body = _lofar_udp_io_PCAP_consume(pcap, blockLength - 8);
+		if (body == NULL) {
+			return 0;
+		}
+		// Body excludes the trailing copy of the block length
+		const int64_t bodyLength = blockLength - 12;
+
+		switch (blockType) {
+			case PCAPNG_BLOCK_IDB:
+				if (pcap->numInterfaces < PCAP_MAX_INTERFACES) {
+					pcap->linkTypes[pcap->numInterfaces] = _lofar_udp_io_PCAP_u16(pcap, body);
+				}
+				pcap->numInterfaces++;
+				break;
+
+			case PCAPNG_BLOCK_EPB: {
+				if (bodyLength < 20) break;
+				const uint32_t interface = _lofar_udp_io_PCAP_u32(pcap, body);
+				int64_t capLen = _lofar_udp_io_PCAP_u32(pcap, &(body[12]));
+				if (interface >= (uint32_t) pcap->numInterfaces || interface >= PCAP_MAX_INTERFACES) break;
+				if (capLen > bodyLength - 20) capLen = bodyLength - 20;
+				if (_lofar_udp_io_PCAP_frame(pcap, pcap->linkTypes[interface], &(body[20]), capLen)) {
+					return 1;
+				}
+				break;
+			}
+
+			case PCAPNG_BLOCK_SPB: {
+				if (bodyLength < 4 || pcap->numInterfaces < 1) break;
+				int64_t capLen = _lofar_udp_io_PCAP_u32(pcap, body);
+				if (capLen > bodyLength - 4) capLen = bodyLength - 4;
+				if (_lofar_udp_io_PCAP_frame(pcap, pcap->linkTypes[0], &(body[4]), capLen)) {
+					return 1;
+				}
+				break;
+			}
+
+			default:
+				// Statistics, name resolution and custom blocks do not contain packets
+				break;
+		}
+	}
+}
+
+/**
+ * @brief      Copy the UDP payloads of the capture into a buffer as a continuous stream
+ *
+ * @param      pcap         The pcap reader
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to copy
+ *
+ * @return     <0: Failure, >=0 Characters copied
+ */
+static int64_t _lofar_udp_io_PCAP_copy(lofar_udp_io_pcap_reader *pcap, int8_t *const targetArray, const int64_t nchars) {
+	int64_t copied = 0;
+	while (copied < nchars) {
+		if (pcap->payloadLength < 1) {
+			const int32_t found = _lofar_udp_io_PCAP_next_payload(pcap);
+			if (found < 0) {
+				return -1;
+			} else if (found == 0) {
+				break;
+			}
+		}
+
+		const int64_t copyLength = (nchars - copied) < pcap->payloadLength ? (nchars - copied) : pcap->payloadLength;
+		memcpy(&(targetArray[copied]), pcap->payload, copyLength);
+		pcap->payload += copyLength;
+		pcap->payloadLength -= copyLength;
+		copied += copyLength;
+	}
+
+	return copied;
+}
+
+
+// Read Interface
+
+/**
+ * @brief      Setup the read I/O struct to extract UDP payloads from a pcap/pcapng capture
+ *
+ * @param      input          The input
+ * @param[in]  inputLocation  The capture location, "file[@udpPort]"
+ * @param[in]  port           The index offset from the base file
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_setup_PCAP(lofar_udp_io_read_config *const input, const char *inputLocation, const int8_t port) {
+	// Adopt the stream from the header scan if there is one, as it cannot be re-opened at the start
+	for (int32_t idx = 0; idx < pcapPendingCount; idx++) {
+		if (pcapPendingReaders[idx] != NULL && strncmp(pcapPendingReaders[idx]->inputLocation, inputLocation, DEF_STR_LEN) == 0) {
+			input->pcapReader[port] = pcapPendingReaders[idx];
+			pcapPendingReaders[idx] = NULL;
+			return 0;
+		}
+	}
+
+	if ((input->pcapReader[port] = _lofar_udp_io_PCAP_open(inputLocation)) == NULL) {
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Perform a data read from a capture, copying the UDP payloads into the output array
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     <0: Failure, >=0 Characters read
+ */
+int64_t _lofar_udp_io_read_PCAP(lofar_udp_io_read_config *const input, const int8_t port, int8_t *const targetArray, const int64_t nchars) {
+	VERBOSE(printf("reader_nchars: Entering read request (pcap): %d, %ld\n", port, nchars));
+	lofar_udp_io_pcap_reader *pcap = input->pcapReader[port];
+	if (pcap == NULL) {
+		fprintf(stderr, "ERROR %s: pcap reader is null on port %d, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	const int64_t copied = _lofar_udp_io_PCAP_copy(pcap, targetArray, nchars);
+
+	// Release the pages of the mapping that have already been parsed
+	if (pcap->map != NULL) {
+		const int64_t pageSize = sysconf(_SC_PAGESIZE);
+		const int64_t parsed = (pcap->payloadLength > 0) ? (pcap->payload - pcap->map) : pcap->mapPos;
+		const int64_t releaseLimit = ((parsed - input->readBufSize[port]) / pageSize) * pageSize;
+		if (releaseLimit > pcap->mapReleased) {
+			if (madvise((void *) (pcap->map + pcap->mapReleased), releaseLimit - pcap->mapReleased, MADV_DONTNEED) < 0) {
+				fprintf(stderr, "WARNING: Failed to release mapped capture on port %d (errno %d: %s), continuing.\n", port, errno, strerror(errno));
+			}
+			pcap->mapReleased = releaseLimit;
+		}
+	}
+
+	return copied;
+}
+
+/**
+ * @brief      Temporarily read the start of the UDP payloads in a capture. Stream sources cannot be re-opened, so they
+ *             are kept open for the reader to adopt, with the data left unconsumed when resetSeek is set.
+ *
+ * @param      outbuf         The output buffer
+ * @param[in]  size           The size of each element
+ * @param[in]  num            The number of elements
+ * @param[in]  inputLocation  The capture location, "file[@udpPort]"
+ * @param[in]  resetSeek      bool: leave the data unconsumed for the next reader
+ *
+ * @return     >0: Success, bytes read, <=0: Failure
+ */
+int64_t _lofar_udp_io_read_temp_PCAP(void *outbuf, const int64_t size, const int64_t num, const char inputLocation[], const int8_t resetSeek) {
+	if (outbuf == NULL || inputLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed nullptr (outbuf: %p, inputLocation %p), exiting.\n", __func__, outbuf, inputLocation);
+		return -1;
+	}
+
+	int32_t pendingIdx = -1;
+	lofar_udp_io_pcap_reader *pcap = NULL;
+	for (int32_t idx = 0; idx < pcapPendingCount; idx++) {
+		if (pcapPendingReaders[idx] != NULL && strncmp(pcapPendingReaders[idx]->inputLocation, inputLocation, DEF_STR_LEN) == 0) {
+			pcap = pcapPendingReaders[idx];
+			pendingIdx = idx;
+			break;
+		}
+	}
+	if (pcap == NULL && (pcap = _lofar_udp_io_PCAP_open(inputLocation)) == NULL) {
+		return -1;
+	}
+
+	const int64_t readlen = _lofar_udp_io_PCAP_copy(pcap, outbuf, size * num);
+	if (readlen != size * num) {
+		fprintf(stderr, "Unable to read %ld elements from capture %s, exiting.\n", size * num, inputLocation);
+		if (pendingIdx > -1) {
+			pcapPendingReaders[pendingIdx] = NULL;
+		}
+		_lofar_udp_io_PCAP_close(pcap);
+		return -1;
+	}
+
+	// Mapped captures are re-opened by the reader
+	if (pcap->map != NULL) {
+		_lofar_udp_io_PCAP_close(pcap);
+		return readlen;
+	}
+
+	if (resetSeek) {
+		// Data can only be returned to the stream if it all came from the current payload
+		if (pcap->payload - readlen < pcap->payloadStart) {
+			fprintf(stderr, "ERROR %s: Cannot perform a temporary read spanning multiple packets on a streamed capture and reset the pointer location, exiting.\n", __func__);
+			if (pendingIdx > -1) {
+				pcapPendingReaders[pendingIdx] = NULL;
+			}
+			_lofar_udp_io_PCAP_close(pcap);
+			return -1;
+		}
+		pcap->payload -= readlen;
+		pcap->payloadLength += readlen;
+	}
+
+	if (pendingIdx < 0) {
+		for (int32_t idx = 0; idx < pcapPendingCount && pendingIdx < 0; idx++) {
+			if (pcapPendingReaders[idx] == NULL) {
+				pendingIdx = idx;
+			}
+		}
+		if (pendingIdx < 0) {
+			lofar_udp_io_pcap_reader **grown = realloc(pcapPendingReaders, (pcapPendingCount + 1) * sizeof(lofar_udp_io_pcap_reader *));
+			if (grown != NULL) {
+				pcapPendingReaders = grown;
+				pendingIdx = pcapPendingCount++;
+			}
+		}
+		if (pendingIdx >= 0) {
+			pcapPendingReaders[pendingIdx] = pcap;
+		} else {
+			fprintf(stderr, "WARNING %s: Failed to track the pending pcap stream, closing %s; the reader will not be able to re-open it.\n", __func__, inputLocation);
+			_lofar_udp_io_PCAP_close(pcap);
+		}
+	}
+
+	return readlen;
+}
+
+/**
+ * @brief      Close a capture and release its mapping
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base file
+ */
+void _lofar_udp_io_read_cleanup_PCAP(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input == NULL) {
+		return;
+	}
+
+	lofar_udp_io_pcap_reader *pcap = input->pcapReader[port];
+	if (pcap != NULL) {
+		if (pcap->packetsSkipped > 0) {
+			fprintf(stderr, "WARNING: Skipped %ld truncated or fragmented datagrams in %s (port %d).\n", pcap->packetsSkipped, pcap->inputLocation, port);
+		}
+		_lofar_udp_io_PCAP_close(pcap);
+		input->pcapReader[port] = NULL;
+	}
+}
+
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
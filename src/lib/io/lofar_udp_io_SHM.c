@@ -0,0 +1,1006 @@
+
+// Shared memory ring constants
+#define SHM_RING_MAGIC "UPMSHMR"
+#define SHM_RING_MAGIC_LEN 8
+#define SHM_RING_VERSION 1
+
+// Position of a consumer attached to a ring, each is kept on its own cache line so that consumers do not contend with each other
+typedef struct lofar_udp_io_shm_consumer {
+	_Alignas(64) int32_t active;
+	int32_t pid;
+	int64_t readPosition;
+} lofar_udp_io_shm_consumer;
+
+// Header at the start of a shared memory ring. Positions count bytes from the start of the stream and never wrap, the
+// offset of a position in the data region is (position % dataSize).
+typedef struct lofar_udp_io_shm_header {
+	char magic[SHM_RING_MAGIC_LEN];
+	int32_t version;
+	int32_t writerPid;
+	int64_t headerSize;
+	int64_t dataSize;
+
+	// Packet-count metadata (packetLength is 0 if the writer did not describe its packets)
+	int32_t packetLength;
+	int32_t writerFinished;
+	int64_t firstPacket;
+	int64_t packetsWritten;
+
+	// End of the published data, and the oldest data that has not been overwritten
+	_Alignas(64) int64_t writePosition;
+	int64_t tailPosition;
+
+	// Futex words, bumped after every write (writeSequence) and every consumer release (readSequence), and the number of
+	// processes waiting on each of them, so that wake-ups are only issued when someone is waiting
+	uint32_t writeSequence;
+	uint32_t readSequence;
+	uint32_t readersWaiting;
+	uint32_t writerWaiting;
+
+	// Spinlock serialising consumer registration and removal, the writer never takes it
+	uint32_t registerLock;
+
+	lofar_udp_io_shm_consumer consumers[SHM_RING_MAX_CONSUMERS];
+} lofar_udp_io_shm_header;
+
+// Process-local view of a shared memory ring
+struct lofar_udp_io_shm_ring {
+	lofar_udp_io_shm_header *header;
+	// The data region is mapped twice, back to back, so that any window of up to dataSize bytes is contiguous
+	int8_t *data;
+	int64_t headerSize;
+	int64_t dataSize;
+
+	// Consumer slot in the header (-1 for the writer), the length of the last in-place acquire, and whether that acquire is
+	// mapped into the reader's input buffer
+	int32_t slot;
+	int64_t acquired;
+	int8_t lent;
+
+	// Consumers keep the shared memory object open to map data into the reader's input buffer (-1 for the writer)
+	int32_t fd;
+
+	char name[DEF_STR_LEN + 1];
+};
+
+
+// Ring helpers
+
+/**
+ * @brief      Wait on a futex word in shared memory
+ *
+ * @param      word      The futex word
+ * @param[in]  expected  The value the word is expected to hold
+ * @param[in]  waitMs    Longest wait (ms)
+ *
+ * @return     0: Woken, <0: Timed out / the word did not hold the expected value (see errno)
+ */
+static inline int32_t _lofar_udp_io_SHM_futex_wait(uint32_t *word, const uint32_t expected, const int32_t waitMs) {
+	const struct timespec timeout = { .tv_sec = waitMs / 1000, .tv_nsec = (waitMs % 1000) * 1000000L };
+	return (int32_t) syscall(SYS_futex, word, FUTEX_WAIT, expected, &timeout, NULL, 0);
+}
+
+/**
+ * @brief      Wake every process waiting on a futex word in shared memory
+ *
+ * @param      word  The futex word
+ */
+static inline void _lofar_udp_io_SHM_futex_wake(uint32_t *word) {
+	syscall(SYS_futex, word, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+static inline void _lofar_udp_io_SHM_lock(lofar_udp_io_shm_header *header) {
+	while (__atomic_exchange_n(&(header->registerLock), 1, __ATOMIC_ACQUIRE)) {
+		while (__atomic_load_n(&(header->registerLock), __ATOMIC_RELAXED)) {
+			sched_yield();
+		}
+	}
+}
+
+static inline void _lofar_udp_io_SHM_unlock(lofar_udp_io_shm_header *header) {
+	__atomic_store_n(&(header->registerLock), 0, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief      Find the read position of the slowest active consumer of a ring
+ *
+ * @param      header         The ring header
+ * @param[in]  writePosition  The writer's position, returned if no consumers are active
+ *
+ * @return     The oldest position that is still needed
+ */
+static int64_t _lofar_udp_io_SHM_oldest(lofar_udp_io_shm_header *header, const int64_t writePosition) {
+	int64_t oldestRead = writePosition;
+	for (int32_t slot = 0; slot < SHM_RING_MAX_CONSUMERS; slot++) {
+		if (__atomic_load_n(&(header->consumers[slot].active), __ATOMIC_SEQ_CST)) {
+			const int64_t readPosition = __atomic_load_n(&(header->consumers[slot].readPosition), __ATOMIC_SEQ_CST);
+			oldestRead = (readPosition < oldestRead) ? readPosition : oldestRead;
+		}
+	}
+	return oldestRead;
+}
+
+/**
+ * @brief      Check if the process on the other side of a ring may still be running
+ *
+ * @param[in]  pid   The process ID
+ *
+ * @return     1: Running (or unknown), 0: Exited
+ */
+static inline int8_t _lofar_udp_io_SHM_alive(const int32_t pid) {
+	return !(pid > 0 && kill(pid, 0) < 0 && errno == ESRCH);
+}
+
+/**
+ * @brief      Size of the ring header, rounded up to a page so that the data region can be mapped separately
+ *
+ * @return     >0: Header size in bytes, <0: Failure
+ */
+static int64_t _lofar_udp_io_SHM_header_size(void) {
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	if (pageSize < 1) {
+		return -1;
+	}
+	return (((int64_t) sizeof(lofar_udp_io_shm_header) + pageSize - 1) / pageSize) * pageSize;
+}
+
+/**
+ * @brief      Convert a ring name to a shm_open name (a single leading '/', no other '/' characters)
+ *
+ * @param      dest      The output name (DEF_STR_LEN + 1 chars)
+ * @param[in]  location  The ring name
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_SHM_name(char *dest, const char location[]) {
+	const char *name = location;
+	while (*name == '/') {
+		name++;
+	}
+
+	const size_t nameLength = strnlen(name, DEF_STR_LEN);
+	if (nameLength == 0 || nameLength >= NAME_MAX || strchr(name, '/') != NULL) {
+		fprintf(stderr, "ERROR %s: Invalid shared memory ring name '%s' (must be non-empty, shorter than %d characters and not contain '/'), exiting.\n", __func__, location, NAME_MAX);
+		return -1;
+	}
+
+	snprintf(dest, DEF_STR_LEN + 1, "/%s", name);
+	return 0;
+}
+
+/**
+ * @brief      Map the header and mirrored data region of a ring
+ *
+ * @param[in]  name        The shm_open name of the ring
+ * @param[in]  fd          The shared memory object
+ * @param[in]  headerSize  The header size
+ * @param[in]  dataSize    The data region size
+ * @param[in]  writer      bool: map the data region writable
+ *
+ * @return     ptr: Ring, NULL: Failure
+ */
+static lofar_udp_io_shm_ring* _lofar_udp_io_SHM_map(const char name[], const int32_t fd, const int64_t headerSize, const int64_t dataSize, const int8_t writer) {
+	lofar_udp_io_shm_ring *ring = calloc(1, sizeof(lofar_udp_io_shm_ring));
+	if (ring == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to allocate memory for shared memory ring %s, exiting.\n", __func__, name);
+		return NULL;
+	}
+
+	ring->header = mmap(NULL, headerSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (ring->header == MAP_FAILED) {
+		fprintf(stderr, "ERROR %s: Failed to map the header of shared memory ring %s (errno %d: %s), exiting.\n", __func__, name, errno, strerror(errno));
+		free(ring);
+		return NULL;
+	}
+
+	// Reserve the full address range first, then place both views of the data over it
+	const int32_t protection = writer ? (PROT_READ | PROT_WRITE) : PROT_READ;
+	ring->data = mmap(NULL, 2 * dataSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ring->data == MAP_FAILED ||
+		mmap(ring->data, dataSize, protection, MAP_SHARED | MAP_FIXED, fd, headerSize) == MAP_FAILED ||
+		mmap(ring->data + dataSize, dataSize, protection, MAP_SHARED | MAP_FIXED, fd, headerSize) == MAP_FAILED) {
+		fprintf(stderr, "ERROR %s: Failed to map the data of shared memory ring %s (errno %d: %s), exiting.\n", __func__, name, errno, strerror(errno));
+		if (ring->data != MAP_FAILED) {
+			munmap(ring->data, 2 * dataSize);
+		}
+		munmap(ring->header, headerSize);
+		free(ring);
+		return NULL;
+	}
+
+	ring->headerSize = headerSize;
+	ring->dataSize = dataSize;
+	ring->slot = -1;
+	ring->acquired = 0;
+	ring->lent = 0;
+	ring->fd = -1;
+	strncpy(ring->name, name, DEF_STR_LEN);
+
+	return ring;
+}
+
+/**
+ * @brief      Unmap a ring and free the process-local state
+ *
+ * @param      ring  The ring
+ */
+static void _lofar_udp_io_SHM_unmap(lofar_udp_io_shm_ring *ring) {
+	if (ring == NULL) {
+		return;
+	}
+
+	munmap(ring->data, 2 * ring->dataSize);
+	munmap(ring->header, ring->headerSize);
+	if (ring->fd >= 0) {
+		close(ring->fd);
+	}
+	free(ring);
+}
+
+/**
+ * @brief      Attach to an existing ring
+ *
+ * @param[in]  name    The shm_open name of the ring
+ * @param[in]  writer  bool: map the data region writable
+ *
+ * @return     ptr: Ring, NULL: Failure
+ */
+static lofar_udp_io_shm_ring* _lofar_udp_io_SHM_attach(const char name[], const int8_t writer) {
+	const int64_t headerSize = _lofar_udp_io_SHM_header_size();
+	if (headerSize < 0) {
+		return NULL;
+	}
+
+	const int32_t fd = shm_open(name, O_RDWR, 0);
+	if (fd < 0) {
+		fprintf(stderr, "ERROR %s: Failed to open shared memory ring %s (errno %d: %s), exiting.\n", __func__, name, errno, strerror(errno));
+		return NULL;
+	}
+
+	// Check the header before mapping the data region
+	lofar_udp_io_shm_header header;
+	const int64_t objectSize = _fd_file_size(fd);
+	if (objectSize < headerSize || pread(fd, &header, sizeof(lofar_udp_io_shm_header), 0) != (ssize_t) sizeof(lofar_udp_io_shm_header)) {
+		fprintf(stderr, "ERROR %s: Shared memory ring %s is too small to hold a header, exiting.\n", __func__, name);
+		close(fd);
+		return NULL;
+	}
+
+	if (strncmp(header.magic, SHM_RING_MAGIC, SHM_RING_MAGIC_LEN) != 0 || header.version != SHM_RING_VERSION) {
+		fprintf(stderr, "ERROR %s: Shared memory ring %s has not been initialised or is not a udpPacketManager ring (version %d vs %d), exiting.\n", __func__, name, header.version, SHM_RING_VERSION);
+		close(fd);
+		return NULL;
+	}
+
+	if (header.headerSize != headerSize || header.dataSize < 1 || objectSize != header.headerSize + header.dataSize) {
+		fprintf(stderr, "ERROR %s: Shared memory ring %s has an unexpected layout (%ld + %ld vs %ld bytes), exiting.\n", __func__, name, header.headerSize, header.dataSize, objectSize);
+		close(fd);
+		return NULL;
+	}
+
+	lofar_udp_io_shm_ring *ring = _lofar_udp_io_SHM_map(name, fd, header.headerSize, header.dataSize, writer);
+	// The mappings hold their own reference to the object, consumers keep the descriptor to map data into their input buffers
+	if (ring != NULL && !writer) {
+		ring->fd = fd;
+	} else {
+		close(fd);
+	}
+	return ring;
+}
+
+/**
+ * @brief      Attach to an existing ring as a consumer
+ *
+ * @param[in]  location  The ring name
+ *
+ * @return     ptr: Ring, NULL: Failure
+ */
+lofar_udp_io_shm_ring* _lofar_udp_io_SHM_open(const char location[]) {
+	char name[DEF_STR_LEN + 1];
+	if (_lofar_udp_io_SHM_name(name, location) < 0) {
+		return NULL;
+	}
+
+	return _lofar_udp_io_SHM_attach(name, 0);
+}
+
+/**
+ * @brief      Create a ring, or continue an existing ring whose writer has exited
+ *
+ * @param[in]  location       The ring name
+ * @param[in]  dataSize       Minimum size of the data region (rounded up to the page size)
+ * @param[in]  packetLength   Length of the packets that will be written (0: unknown)
+ * @param[in]  firstPacket    Packet number of the first packet that will be written
+ * @param[in]  reuseExisting  bool: continue an existing ring rather than failing
+ *
+ * @return     ptr: Ring, NULL: Failure
+ */
+lofar_udp_io_shm_ring* _lofar_udp_io_SHM_create(const char location[], const int64_t dataSize, const int32_t packetLength, const int64_t firstPacket, const int8_t reuseExisting) {
+	char name[DEF_STR_LEN + 1];
+	const int64_t headerSize = _lofar_udp_io_SHM_header_size();
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	if (_lofar_udp_io_SHM_name(name, location) < 0 || headerSize < 0 || pageSize < 1) {
+		return NULL;
+	}
+
+	if (dataSize < 1 || packetLength < 0) {
+		fprintf(stderr, "ERROR %s: Invalid ring size or packet length for %s (%ld, %d), exiting.\n", __func__, name, dataSize, packetLength);
+		return NULL;
+	}
+	const int64_t ringSize = ((dataSize + pageSize - 1) / pageSize) * pageSize;
+
+	lofar_udp_io_shm_ring *ring;
+	const int32_t fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0664);
+	if (fd < 0) {
+		if (errno != EEXIST || !reuseExisting) {
+			fprintf(stderr, "ERROR %s: Failed to create shared memory ring %s (errno %d: %s), exiting.\n", __func__, name, errno, strerror(errno));
+			return NULL;
+		}
+
+		// Continue an existing ring, keeping its stream position so that attached consumers can carry on reading
+		if ((ring = _lofar_udp_io_SHM_attach(name, 1)) == NULL) {
+			return NULL;
+		}
+		lofar_udp_io_shm_header *header = ring->header;
+		if (!__atomic_load_n(&(header->writerFinished), __ATOMIC_ACQUIRE) && _lofar_udp_io_SHM_alive(header->writerPid)) {
+			fprintf(stderr, "ERROR %s: Shared memory ring %s is still being written by process %d, exiting.\n", __func__, name, header->writerPid);
+			_lofar_udp_io_SHM_unmap(ring);
+			return NULL;
+		}
+		if (header->packetLength != 0 && packetLength != 0 && header->packetLength != packetLength) {
+			fprintf(stderr, "ERROR %s: Shared memory ring %s holds packets of a different length (%d vs %d), exiting.\n", __func__, name, header->packetLength, packetLength);
+			_lofar_udp_io_SHM_unmap(ring);
+			return NULL;
+		}
+
+		if (ring->dataSize != ringSize) {
+			fprintf(stderr, "WARNING: Continuing shared memory ring %s with its existing size (%ld bytes, %ld requested).\n", name, ring->dataSize, ringSize);
+		}
+		if (packetLength != 0) {
+			ring->header->packetLength = packetLength;
+		}
+		__atomic_store_n(&(ring->header->writerPid), (int32_t) getpid(), __ATOMIC_RELAXED);
+		__atomic_store_n(&(ring->header->writerFinished), 0, __ATOMIC_RELEASE);
+		return ring;
+	}
+
+	// A new object is zero-filled, so only the non-zero fields need to be set
+	if (ftruncate(fd, headerSize + ringSize) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to resize shared memory ring %s to %ld bytes (errno %d: %s), exiting.\n", __func__, name, headerSize + ringSize, errno, strerror(errno));
+		close(fd);
+		shm_unlink(name);
+		return NULL;
+	}
+
+	ring = _lofar_udp_io_SHM_map(name, fd, headerSize, ringSize, 1);
+	close(fd);
+	if (ring == NULL) {
+		shm_unlink(name);
+		return NULL;
+	}
+
+	lofar_udp_io_shm_header *header = ring->header;
+	header->version = SHM_RING_VERSION;
+	header->writerPid = (int32_t) getpid();
+	header->headerSize = headerSize;
+	header->dataSize = ringSize;
+	header->packetLength = packetLength;
+	header->firstPacket = firstPacket;
+
+	// Publish the magic last, consumers treat the ring as uninitialised until it is present
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	memcpy(header->magic, SHM_RING_MAGIC, SHM_RING_MAGIC_LEN);
+
+	return ring;
+}
+
+/**
+ * @brief      Register a consumer on a ring, starting from the oldest whole packet still held in the ring
+ *
+ * @param      ring          The ring
+ * @param[in]  packetLength  Packet length used to align the start if the writer did not provide one (<1: unaligned)
+ *
+ * @return     >=0: Consumer slot, <0: Failure
+ */
+static int32_t _lofar_udp_io_SHM_register(lofar_udp_io_shm_ring *ring, const int32_t packetLength) {
+	lofar_udp_io_shm_header *header = ring->header;
+	const int32_t alignment = header->packetLength > 0 ? header->packetLength : packetLength;
+
+	_lofar_udp_io_SHM_lock(header);
+	for (int32_t slot = 0; slot < SHM_RING_MAX_CONSUMERS; slot++) {
+		lofar_udp_io_shm_consumer *consumer = &(header->consumers[slot]);
+		if (__atomic_load_n(&(consumer->active), __ATOMIC_ACQUIRE)) {
+			continue;
+		}
+
+		int64_t readPosition = __atomic_load_n(&(header->tailPosition), __ATOMIC_ACQUIRE);
+		if (alignment > 1 && (readPosition % alignment) != 0) {
+			readPosition += alignment - (readPosition % alignment);
+		}
+
+		consumer->pid = (int32_t) getpid();
+		__atomic_store_n(&(consumer->readPosition), readPosition, __ATOMIC_SEQ_CST);
+		__atomic_store_n(&(consumer->active), 1, __ATOMIC_SEQ_CST);
+		_lofar_udp_io_SHM_unlock(header);
+
+		// The writer does not take the lock, so it may have moved the tail past our start before it saw us. It publishes the
+		// tail before checking the consumers, so either it sees us, or we see the new tail here and start after it.
+		int64_t tailPosition;
+		while ((tailPosition = __atomic_load_n(&(header->tailPosition), __ATOMIC_SEQ_CST)) > readPosition) {
+			readPosition = tailPosition;
+			if (alignment > 1 && (readPosition % alignment) != 0) {
+				readPosition += alignment - (readPosition % alignment);
+			}
+			__atomic_store_n(&(consumer->readPosition), readPosition, __ATOMIC_SEQ_CST);
+		}
+
+		ring->slot = slot;
+		return slot;
+	}
+	_lofar_udp_io_SHM_unlock(header);
+
+	fprintf(stderr, "ERROR %s: All %d consumer slots of shared memory ring %s are in use, exiting.\n", __func__, SHM_RING_MAX_CONSUMERS, ring->name);
+	return -1;
+}
+
+/**
+ * @brief      Mark the data before a position as consumed, and wake the writer if it is waiting for space
+ *
+ * @param      ring          The ring
+ * @param[in]  readPosition  The new read position of the consumer
+ */
+static void _lofar_udp_io_SHM_release(lofar_udp_io_shm_ring *ring, const int64_t readPosition) {
+	lofar_udp_io_shm_header *header = ring->header;
+	__atomic_store_n(&(header->consumers[ring->slot].readPosition), readPosition, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&(header->readSequence), 1, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&(header->writerWaiting), __ATOMIC_SEQ_CST)) {
+		_lofar_udp_io_SHM_futex_wake(&(header->readSequence));
+	}
+}
+
+/**
+ * @brief      Remove a consumer from a ring
+ *
+ * @param      ring  The ring
+ */
+static void _lofar_udp_io_SHM_deregister(lofar_udp_io_shm_ring *ring) {
+	if (ring->slot < 0) {
+		return;
+	}
+
+	lofar_udp_io_shm_header *header = ring->header;
+	_lofar_udp_io_SHM_lock(header);
+	__atomic_store_n(&(header->consumers[ring->slot].active), 0, __ATOMIC_RELEASE);
+	_lofar_udp_io_SHM_unlock(header);
+
+	// The writer may have been waiting on this consumer
+	_lofar_udp_io_SHM_release(ring, __atomic_load_n(&(header->consumers[ring->slot].readPosition), __ATOMIC_RELAXED));
+	ring->slot = -1;
+}
+
+/**
+ * @brief      Wait until a number of bytes are available to a consumer, or the stream ends
+ *
+ * @param      ring          The ring
+ * @param[in]  readPosition  The consumer's read position
+ * @param[in]  target        Number of bytes to wait for
+ * @param[in]  timeout       Seconds without new data before the stream is treated as finished (<= 0: wait for the writer)
+ *
+ * @return     >=0: Bytes available (less than target once the stream has ended)
+ */
+static int64_t _lofar_udp_io_SHM_wait(lofar_udp_io_shm_ring *ring, const int64_t readPosition, const int64_t target, const float timeout) {
+	lofar_udp_io_shm_header *header = ring->header;
+	struct timespec tick, tock;
+	CLICK(tick);
+	int64_t lastAvailable = 0;
+
+	while (1) {
+		// Sample the sequence before the position, so that a write between the two will not be slept through
+		const uint32_t sequence = __atomic_load_n(&(header->writeSequence), __ATOMIC_SEQ_CST);
+		const int64_t available = __atomic_load_n(&(header->writePosition), __ATOMIC_ACQUIRE) - readPosition;
+		if (available >= target) {
+			return available;
+		}
+
+		if (__atomic_load_n(&(header->writerFinished), __ATOMIC_ACQUIRE)) {
+			const int64_t remaining = __atomic_load_n(&(header->writePosition), __ATOMIC_ACQUIRE) - readPosition;
+			return remaining > 0 ? remaining : 0;
+		}
+
+		if (available > lastAvailable) {
+			lastAvailable = available;
+			CLICK(tick);
+		}
+
+		__atomic_fetch_add(&(header->readersWaiting), 1, __ATOMIC_SEQ_CST);
+		const int32_t waitReturn = _lofar_udp_io_SHM_futex_wait(&(header->writeSequence), sequence, SHM_RING_WAIT_MS);
+		const int32_t waitErrno = errno;
+		__atomic_fetch_sub(&(header->readersWaiting), 1, __ATOMIC_SEQ_CST);
+
+		if (waitReturn < 0 && waitErrno == ETIMEDOUT) {
+			if (!_lofar_udp_io_SHM_alive(__atomic_load_n(&(header->writerPid), __ATOMIC_RELAXED))) {
+				fprintf(stderr, "WARNING: Writer of shared memory ring %s exited without closing the ring, treating the stream as finished.\n", ring->name);
+				return available > 0 ? available : 0;
+			}
+
+			CLICK(tock);
+			if (timeout > 0.0f && TICKTOCK(tick, tock) >= timeout) {
+				return available > 0 ? available : 0;
+			}
+		}
+	}
+}
+
+/**
+ * @brief      Copy data out of a ring for a consumer, releasing the space to the writer as it is copied
+ *
+ * @param      ring         The ring
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ * @param[in]  timeout      Seconds without new data before the stream is treated as finished (<= 0: wait for the writer)
+ *
+ * @return     >=0: Bytes read
+ */
+static int64_t _lofar_udp_io_SHM_copy(lofar_udp_io_shm_ring *ring, int8_t *targetArray, const int64_t nchars, const float timeout) {
+	lofar_udp_io_shm_consumer *consumer = &(ring->header->consumers[ring->slot]);
+	int64_t readPosition = __atomic_load_n(&(consumer->readPosition), __ATOMIC_RELAXED);
+	int64_t dataRead = 0;
+
+	while (dataRead < nchars) {
+		const int64_t available = _lofar_udp_io_SHM_wait(ring, readPosition, 1, timeout);
+		if (available < 1) {
+			break;
+		}
+
+		const int64_t readLength = (available < (nchars - dataRead)) ? available : (nchars - dataRead);
+		memcpy(&(targetArray[dataRead]), &(ring->data[readPosition % ring->dataSize]), readLength);
+		readPosition += readLength;
+		dataRead += readLength;
+		_lofar_udp_io_SHM_release(ring, readPosition);
+	}
+
+	return dataRead;
+}
+
+/**
+ * @brief      Mark consumers whose process has exited as inactive, so that they no longer hold back the writer
+ *
+ * @param      ring  The ring
+ */
+static void _lofar_udp_io_SHM_reap(lofar_udp_io_shm_ring *ring) {
+	lofar_udp_io_shm_header *header = ring->header;
+	_lofar_udp_io_SHM_lock(header);
+	for (int32_t slot = 0; slot < SHM_RING_MAX_CONSUMERS; slot++) {
+		lofar_udp_io_shm_consumer *consumer = &(header->consumers[slot]);
+		if (__atomic_load_n(&(consumer->active), __ATOMIC_ACQUIRE) && !_lofar_udp_io_SHM_alive(consumer->pid)) {
+			fprintf(stderr, "WARNING: Consumer process %d of shared memory ring %s exited without detaching, removing it.\n", consumer->pid, ring->name);
+			__atomic_store_n(&(consumer->active), 0, __ATOMIC_RELEASE);
+		}
+	}
+	_lofar_udp_io_SHM_unlock(header);
+}
+
+
+// Read interface
+
+/**
+ * @brief      Setup the read I/O struct to consume a shared memory ring
+ *
+ * @param      input          The input
+ * @param[in]  inputLocation  The ring name
+ * @param[in]  port           The index offset from the base file
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_setup_SHM(lofar_udp_io_read_config *const input, const char *inputLocation, const int8_t port) {
+	lofar_udp_io_shm_ring *ring = _lofar_udp_io_SHM_open(inputLocation);
+	if (ring == NULL) {
+		return -1;
+	}
+
+	const int32_t packetLength = ring->header->packetLength;
+	if (packetLength > 0 && input->portPacketLength[port] > 1 && packetLength != input->portPacketLength[port]) {
+		fprintf(stderr, "ERROR %s: Shared memory ring %s holds %d byte packets, but %d byte packets are expected on port %d, exiting.\n", __func__, ring->name, packetLength, input->portPacketLength[port], port);
+		_lofar_udp_io_SHM_unmap(ring);
+		return -2;
+	}
+
+	if (_lofar_udp_io_SHM_register(ring, input->portPacketLength[port]) < 0) {
+		_lofar_udp_io_SHM_unmap(ring);
+		return -3;
+	}
+
+	input->shmReader[port] = ring;
+	return 0;
+}
+
+/**
+ * @brief      Map data acquired from a ring over the head of the reader's input buffer, rather than copying it in. The
+ * 				mapping is private, so the reader's changes to the data never reach the ring.
+ *
+ * @param      input         The input
+ * @param[in]  port          The index offset from the base file
+ * @param[in]  readPosition  The ring position of the data (must start a page of the ring)
+ * @param[in]  nchars        The number of bytes to map
+ *
+ * @return     0: Success, <0: Failure (the buffer holds private memory)
+ */
+static int32_t _lofar_udp_io_read_SHM_map_window(lofar_udp_io_read_config *const input, const int8_t port, const int64_t readPosition, const int64_t nchars) {
+	lofar_udp_io_shm_ring *ring = input->shmReader[port];
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	const int64_t offset = readPosition % ring->dataSize;
+	const int64_t mapLength = ((nchars + pageSize - 1) / pageSize) * pageSize;
+	if (ring->fd < 0 || pageSize < 1 || offset % pageSize != 0 || mapLength > input->inputWindowSize[port]) {
+		return -1;
+	}
+
+	// Data that wraps around the end of the ring continues from the start of the data region
+	int8_t *window = input->inputWindow[port];
+	const int64_t firstLength = (mapLength < ring->dataSize - offset) ? mapLength : ring->dataSize - offset;
+	if (mmap(window, firstLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, ring->fd, ring->headerSize + offset) == MAP_FAILED ||
+		(mapLength > firstLength && mmap(window + firstLength, mapLength - firstLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, ring->fd, ring->headerSize) == MAP_FAILED)) {
+		VERBOSE(printf("%s: Failed to map ring data on port %d (errno %d), falling back to copies.\n", __func__, port, errno));
+		input->inputWindowMapStart[port] = window;
+		input->inputWindowMapLength[port] = mapLength;
+		_lofar_udp_io_read_window_detach(input, port, window);
+		return -1;
+	}
+	input->inputWindowMapStart[port] = window;
+	input->inputWindowMapLength[port] = mapLength;
+
+	return 0;
+}
+
+/**
+ * @brief      Perform a data read from a shared memory ring, blocking until the request is filled or the stream ends
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     >=0: bytes read, <0: Failure
+ */
+int64_t _lofar_udp_io_read_SHM(lofar_udp_io_read_config *const input, const int8_t port, int8_t *targetArray, const int64_t nchars) {
+	lofar_udp_io_shm_ring *ring = input->shmReader[port];
+	if (ring == NULL || ring->slot < 0) {
+		fprintf(stderr, "ERROR %s: Shared memory ring on port %d is not attached, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	if (ring->acquired > 0 && !ring->lent) {
+		fprintf(stderr, "ERROR %s: Data acquired in place on port %d must be released before reading, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	if (input->inputWindow[port] != NULL) {
+		// Gulps read to the head of the reader's buffer, starting on a page of the ring, are acquired and mapped over the
+		// buffer, everything else is copied
+		const int64_t pageSize = sysconf(_SC_PAGESIZE);
+		const int64_t readPosition = __atomic_load_n(&(ring->header->consumers[ring->slot].readPosition), __ATOMIC_RELAXED) + (ring->lent ? ring->acquired : 0);
+		const int8_t inPlace = targetArray == input->inputWindow[port] && nchars <= ring->dataSize && pageSize > 0 && (readPosition % pageSize) == 0;
+
+		// Keep any packets carried over from the last gulp, then hand the data lent to the buffer back to the writer
+		if (!inPlace && _lofar_udp_io_read_window_detach(input, port, targetArray) < 0) {
+			return -1;
+		}
+		if (ring->lent && _lofar_udp_io_read_release_SHM(input, port, ring->acquired) < 0) {
+			return -1;
+		}
+
+		if (inPlace) {
+			const int8_t *data = NULL;
+			const int64_t available = _lofar_udp_io_read_acquire_SHM(input, port, &data, nchars);
+			if (available < 0) {
+				return -1;
+			}
+
+			// The data is released on the next read, once the reader has processed it
+			if (available == nchars && _lofar_udp_io_read_SHM_map_window(input, port, readPosition, nchars) == 0) {
+				ring->lent = 1;
+				return nchars;
+			}
+
+			// Short reads at the end of the stream (and failed mappings) are copied out instead
+			if (_lofar_udp_io_read_window_detach(input, port, targetArray) < 0) {
+				return -1;
+			}
+			memcpy(targetArray, data, available);
+			if (_lofar_udp_io_read_release_SHM(input, port, available) < 0) {
+				return -1;
+			}
+			return available;
+		}
+	}
+
+	return _lofar_udp_io_SHM_copy(ring, targetArray, nchars, input->followTimeout);
+}
+
+/**
+ * @brief      Wait for data in a shared memory ring and return a pointer to it, without copying it out of the ring
+ *
+ * @param      input   The input
+ * @param[in]  port    The index offset from the base file
+ * @param      data    The start of the data (read-only, valid until it is released)
+ * @param[in]  nchars  The number of bytes to wait for (at most the size of the ring)
+ *
+ * @return     >=0: bytes available at data (less than nchars once the stream has ended), <0: Failure
+ */
+int64_t _lofar_udp_io_read_acquire_SHM(lofar_udp_io_read_config *const input, const int8_t port, const int8_t **data, const int64_t nchars) {
+	lofar_udp_io_shm_ring *ring = input->shmReader[port];
+	if (ring == NULL || ring->slot < 0) {
+		fprintf(stderr, "ERROR %s: Shared memory ring on port %d is not attached, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	if (nchars > ring->dataSize) {
+		fprintf(stderr, "ERROR %s: Cannot acquire %ld bytes from a %ld byte shared memory ring on port %d, exiting.\n", __func__, nchars, ring->dataSize, port);
+		return -2;
+	}
+
+	const int64_t readPosition = __atomic_load_n(&(ring->header->consumers[ring->slot].readPosition), __ATOMIC_RELAXED);
+	const int64_t available = _lofar_udp_io_SHM_wait(ring, readPosition, nchars, input->followTimeout);
+
+	*data = &(ring->data[readPosition % ring->dataSize]);
+	ring->acquired = (available < nchars) ? available : nchars;
+	return ring->acquired;
+}
+
+/**
+ * @brief      Release data acquired in place back to the writer of a shared memory ring
+ *
+ * @param      input   The input
+ * @param[in]  port    The index offset from the base file
+ * @param[in]  nchars  The number of bytes consumed (at most the length of the last acquire)
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_release_SHM(lofar_udp_io_read_config *const input, const int8_t port, const int64_t nchars) {
+	lofar_udp_io_shm_ring *ring = input->shmReader[port];
+	if (ring == NULL || ring->slot < 0) {
+		fprintf(stderr, "ERROR %s: Shared memory ring on port %d is not attached, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	if (nchars < 0 || nchars > ring->acquired) {
+		fprintf(stderr, "ERROR %s: Cannot release %ld bytes on port %d, only %ld were acquired, exiting.\n", __func__, nchars, port, ring->acquired);
+		return -2;
+	}
+
+	const int64_t readPosition = __atomic_load_n(&(ring->header->consumers[ring->slot].readPosition), __ATOMIC_RELAXED);
+	_lofar_udp_io_SHM_release(ring, readPosition + nchars);
+	ring->acquired = 0;
+	ring->lent = 0;
+
+	return 0;
+}
+
+/**
+ * @brief      Temporarily attach to a shared memory ring and read the oldest data it holds. Consumers are independent, so
+ * 				this never moves the read position of any other consumer, regardless of resetSeek.
+ *
+ * @param      outbuf         The output buffer pointer
+ * @param[in]  size           The size of each element
+ * @param[in]  num            The number of elements
+ * @param[in]  inputLocation  The ring name
+ * @param[in]  resetSeek      Unused
+ *
+ * @return     >0: bytes read, <=0: Failure
+ */
+int64_t _lofar_udp_io_read_temp_SHM(void *outbuf, const int64_t size, const int64_t num, const char inputLocation[], __attribute__((unused)) const int8_t resetSeek) {
+	lofar_udp_io_shm_ring *ring = _lofar_udp_io_SHM_open(inputLocation);
+	if (ring == NULL) {
+		return -1;
+	}
+
+	if (_lofar_udp_io_SHM_register(ring, (int32_t) size) < 0) {
+		_lofar_udp_io_SHM_unmap(ring);
+		return -1;
+	}
+
+	const int64_t readlen = _lofar_udp_io_SHM_copy(ring, outbuf, size * num, 0.0f);
+
+	_lofar_udp_io_SHM_deregister(ring);
+	_lofar_udp_io_SHM_unmap(ring);
+
+	return readlen;
+}
+
+/**
+ * @brief      Detach from a shared memory ring
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base file
+ */
+void _lofar_udp_io_read_cleanup_SHM(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input == NULL || input->shmReader[port] == NULL) {
+		return;
+	}
+
+	_lofar_udp_io_SHM_deregister(input->shmReader[port]);
+	_lofar_udp_io_SHM_unmap(input->shmReader[port]);
+	input->shmReader[port] = NULL;
+}
+
+
+// Write interface
+
+/**
+ * @brief      Setup the write I/O struct to produce a shared memory ring
+ *
+ * @param      config  The configuration
+ * @param[in]  outp    The output index
+ * @param[in]  iter    The iteration
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_write_setup_SHM(lofar_udp_io_write_config *const config, const int8_t outp, const int32_t iter) {
+	if (config->shmWriter[outp] != NULL) {
+		return 0;
+	}
+
+	char outputLocation[DEF_STR_LEN + 1];
+	if (lofar_udp_io_parse_format(outputLocation, config->outputFormat, -1, iter, outp, config->firstPacket) < 0) {
+		return -1;
+	}
+
+	// Default to the larger of the default size or two writes
+	int64_t ringSize = config->shmConfig.ringSize;
+	if (ringSize < 1) {
+		ringSize = SHM_RING_DEFAULT_SIZE;
+		if (2 * config->writeBufSize[outp] > ringSize) {
+			ringSize = 2 * config->writeBufSize[outp];
+		}
+	}
+
+	lofar_udp_io_shm_ring *ring = _lofar_udp_io_SHM_create(outputLocation, ringSize, config->shmConfig.packetLength, config->firstPacket, config->progressWithExisting);
+	if (ring == NULL) {
+		return -1;
+	}
+
+	if (strncpy(config->outputLocations[outp], outputLocation, DEF_STR_LEN) != config->outputLocations[outp]) {
+		fprintf(stderr, "ERROR: Failed to copy output ring name (%s), exiting.\n", outputLocation);
+		_lofar_udp_io_SHM_unmap(ring);
+		return -1;
+	}
+
+	config->shmWriter[outp] = ring;
+	return 0;
+}
+
+/**
+ * @brief      Write data into a shared memory ring, waiting for the slowest attached consumer to free space as needed. If no
+ * 				consumers are attached, the oldest data in the ring is overwritten.
+ *
+ * @param      config  The configuration
+ * @param[in]  outp    The output index
+ * @param[in]  src     The source buffer
+ * @param[in]  nchars  The number of bytes to write
+ *
+ * @return     >=0: bytes written, <0: Failure
+ */
+int64_t _lofar_udp_io_write_SHM(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
+	lofar_udp_io_shm_ring *ring = config->shmWriter[outp];
+	if (ring == NULL) {
+		fprintf(stderr, "ERROR %s: Shared memory ring on output %d is not initialised, exiting.\n", __func__, outp);
+		return -1;
+	}
+
+	lofar_udp_io_shm_header *header = ring->header;
+	int64_t writePosition = __atomic_load_n(&(header->writePosition), __ATOMIC_RELAXED);
+	int64_t written = 0;
+
+	while (written < nchars) {
+		const uint32_t sequence = __atomic_load_n(&(header->readSequence), __ATOMIC_SEQ_CST);
+
+		// Find the slowest consumer, and move the tail past the data that is about to be overwritten. A consumer registering
+		// meanwhile either shows up when the consumers are checked again after the tail is published, or sees the new tail
+		// and starts after it (see _lofar_udp_io_SHM_register).
+		int64_t space = ring->dataSize - (writePosition - _lofar_udp_io_SHM_oldest(header, writePosition));
+		int64_t writeLength = (space < (nchars - written)) ? space : (nchars - written);
+		if (writeLength > 0 && writePosition + writeLength - ring->dataSize > __atomic_load_n(&(header->tailPosition), __ATOMIC_RELAXED)) {
+			__atomic_store_n(&(header->tailPosition), writePosition + writeLength - ring->dataSize, __ATOMIC_SEQ_CST);
+			space = ring->dataSize - (writePosition - _lofar_udp_io_SHM_oldest(header, writePosition));
+			writeLength = (space < writeLength) ? space : writeLength;
+		}
+
+		if (writeLength < 1) {
+			__atomic_fetch_add(&(header->writerWaiting), 1, __ATOMIC_SEQ_CST);
+			const int32_t waitReturn = _lofar_udp_io_SHM_futex_wait(&(header->readSequence), sequence, SHM_RING_WAIT_MS);
+			const int32_t waitErrno = errno;
+			__atomic_fetch_sub(&(header->writerWaiting), 1, __ATOMIC_SEQ_CST);
+
+			if (waitReturn < 0 && waitErrno == ETIMEDOUT) {
+				_lofar_udp_io_SHM_reap(ring);
+			}
+			continue;
+		}
+
+		memcpy(&(ring->data[writePosition % ring->dataSize]), &(src[written]), writeLength);
+		writePosition += writeLength;
+		written += writeLength;
+
+		__atomic_store_n(&(header->writePosition), writePosition, __ATOMIC_RELEASE);
+		if (header->packetLength > 0) {
+			__atomic_store_n(&(header->packetsWritten), writePosition / header->packetLength, __ATOMIC_RELAXED);
+		}
+		__atomic_fetch_add(&(header->writeSequence), 1, __ATOMIC_SEQ_CST);
+		if (__atomic_load_n(&(header->readersWaiting), __ATOMIC_SEQ_CST)) {
+			_lofar_udp_io_SHM_futex_wake(&(header->writeSequence));
+		}
+	}
+
+	return written;
+}
+
+/**
+ * @brief      Mark a shared memory ring as finished, and on a full clean wait for the attached consumers to drain it
+ * 				before removing it
+ *
+ * @param      config     The configuration
+ * @param[in]  outp       The output index
+ * @param[in]  fullClean  bool: remove the ring
+ */
+void _lofar_udp_io_write_cleanup_SHM(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t fullClean) {
+	if (config == NULL || config->shmWriter[outp] == NULL) {
+		return;
+	}
+
+	lofar_udp_io_shm_ring *ring = config->shmWriter[outp];
+	lofar_udp_io_shm_header *header = ring->header;
+
+	__atomic_store_n(&(header->writerFinished), 1, __ATOMIC_RELEASE);
+	__atomic_fetch_add(&(header->writeSequence), 1, __ATOMIC_SEQ_CST);
+	_lofar_udp_io_SHM_futex_wake(&(header->writeSequence));
+
+	if (fullClean) {
+		const int64_t writePosition = __atomic_load_n(&(header->writePosition), __ATOMIC_RELAXED);
+		struct timespec tick, tock;
+		CLICK(tick);
+		while (1) {
+			const uint32_t sequence = __atomic_load_n(&(header->readSequence), __ATOMIC_SEQ_CST);
+			int8_t draining = 0;
+			for (int32_t slot = 0; slot < SHM_RING_MAX_CONSUMERS; slot++) {
+				if (__atomic_load_n(&(header->consumers[slot].active), __ATOMIC_ACQUIRE) &&
+					__atomic_load_n(&(header->consumers[slot].readPosition), __ATOMIC_ACQUIRE) < writePosition) {
+					draining = 1;
+				}
+			}
+
+			CLICK(tock);
+			if (!draining || TICKTOCK(tick, tock) >= config->shmConfig.cleanupTimeout) {
+				break;
+			}
+
+			__atomic_fetch_add(&(header->writerWaiting), 1, __ATOMIC_SEQ_CST);
+			if (_lofar_udp_io_SHM_futex_wait(&(header->readSequence), sequence, SHM_RING_WAIT_MS) < 0 && errno == ETIMEDOUT) {
+				_lofar_udp_io_SHM_reap(ring);
+			}
+			__atomic_fetch_sub(&(header->writerWaiting), 1, __ATOMIC_SEQ_CST);
+		}
+
+		// Attached consumers keep their mappings, the object is freed once they detach
+		shm_unlink(ring->name);
+	}
+
+	_lofar_udp_io_SHM_unmap(ring);
+	config->shmWriter[outp] = NULL;
+}
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
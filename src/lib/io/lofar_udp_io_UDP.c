@@ -0,0 +1,347 @@
+
+// UDP socket reader state for a single port
+struct lofar_udp_io_udp_reader {
+	int32_t fd;
+
+	// Length of every datagram on the socket, set from the first datagram received
+	int64_t packetLength;
+	// Datagrams dropped for not matching the packet length
+	int64_t packetsDiscarded;
+
+	// recvmmsg descriptors, pointed at consecutive packet slots in the target buffer on every read
+	struct mmsghdr msgs[UDP_BATCH_SIZE];
+	struct iovec iovecs[UDP_BATCH_SIZE];
+};
+
+// Sockets opened by temporary reads (while the reader parses the first headers), kept open with the first datagram
+// still queued so that the reader can adopt them during setup rather than missing packets while re-binding the port
+// (grown as needed, entries are never released while the process runs)
+static struct lofar_udp_io_udp_pending {
+	int8_t active;
+	int32_t fd;
+	char inputLocation[DEF_STR_LEN + 1];
+} *udpPendingSockets = NULL;
+static int32_t udpPendingCount = 0;
+
+
+/**
+ * @brief      Open and bind a socket for an input location
+ *
+ * @param[in]  inputLocation  "[host:]port", the socket is bound to every interface if no host is given
+ *
+ * @return     >=0: Socket file descriptor, <0: Failure
+ */
+int32_t _lofar_udp_io_read_UDP_open(const char inputLocation[]) {
+	char host[DEF_STR_LEN + 1] = "";
+	const char *service = inputLocation;
+	const char *separator = strrchr(inputLocation, ':');
+	if (separator != NULL) {
+		const char *hostStart = inputLocation;
+		int64_t hostLength = separator - inputLocation;
+		// Strip the brackets around IPv6 addresses
+		if (hostLength > 1 && hostStart[0] == '[' && hostStart[hostLength - 1] == ']') {
+			hostStart++;
+			hostLength -= 2;
+		}
+		if (hostLength > DEF_STR_LEN) {
+			fprintf(stderr, "ERROR %s: Host name in %s is too long, exiting.\n", __func__, inputLocation);
+			return -1;
+		}
+		memcpy(host, hostStart, hostLength);
+		host[hostLength] = '\0';
+		service = separator + 1;
+	}
+
+	struct addrinfo hints, *addresses;
+	memset(&hints, 0, sizeof(hints));
+	hints.ai_family = AF_UNSPEC;
+	hints.ai_socktype = SOCK_DGRAM;
+	hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+	const int32_t lookupReturn = getaddrinfo(strlen(host) ? host : NULL, service, &hints, &addresses);
+	if (lookupReturn != 0) {
+		fprintf(stderr, "ERROR %s: Failed to resolve UDP input %s (%s), exiting.\n", __func__, inputLocation, gai_strerror(lookupReturn));
+		return -1;
+	}
+
+	int32_t fd = -1;
+	for (const struct addrinfo *address = addresses; address != NULL; address = address->ai_next) {
+		if ((fd = socket(address->ai_family, address->ai_socktype | SOCK_CLOEXEC, address->ai_protocol)) < 0) {
+			continue;
+		}
+
+		const int32_t enable = 1;
+		setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+		// Attempt to bypass net.core.rmem_max (requires CAP_NET_ADMIN) before falling back to the capped request
+		int32_t bufferSize = UDP_RCVBUF_SIZE;
+		if (setsockopt(fd, SOL_SOCKET, SO_RCVBUFFORCE, &bufferSize, sizeof(bufferSize)) < 0) {
+			setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+		}
+		socklen_t optionLength = sizeof(bufferSize);
+		// The kernel reports double the usable size to account for its bookkeeping
+		if (getsockopt(fd, SOL_SOCKET, SO_RCVBUF, &bufferSize, &optionLength) == 0 && bufferSize / 2 < UDP_RCVBUF_SIZE) {
+			fprintf(stderr, "WARNING: Socket receive buffer for %s is limited to %d bytes (requested %d), raise net.core.rmem_max to reduce packet loss.\n", inputLocation, bufferSize / 2, UDP_RCVBUF_SIZE);
+		}
+
+		#if UDP_BUSY_POLL_USEC > 0
+		const int32_t busyPoll = UDP_BUSY_POLL_USEC;
+		if (setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busyPoll, sizeof(busyPoll)) < 0) {
+			fprintf(stderr, "WARNING: Failed to enable busy polling for %s (errno %d: %s), continuing without it.\n", inputLocation, errno, strerror(errno));
+		}
+		#endif
+
+		// Treat the stream as finished if no packets arrive within the timeout
+		const struct timeval timeout = { .tv_sec = UDP_TIMEOUT, .tv_usec = 0 };
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+		if (bind(fd, address->ai_addr, address->ai_addrlen) == 0) {
+			break;
+		}
+		close(fd);
+		fd = -1;
+	}
+	freeaddrinfo(addresses);
+
+	if (fd < 0) {
+		fprintf(stderr, "ERROR %s: Failed to bind a socket for %s (errno %d: %s), exiting.\n", __func__, inputLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	return fd;
+}
+
+/**
+ * @brief      Find the socket left open by a temporary read for an input location
+ *
+ * @param[in]  inputLocation  The input location
+ * @param[in]  take           bool: remove the socket from the pending list (the caller takes ownership)
+ *
+ * @return     >=0: Socket file descriptor, -1: No pending socket
+ */
+static int32_t _lofar_udp_io_read_UDP_pending(const char inputLocation[], const int8_t take) {
+	for (int32_t idx = 0; idx < udpPendingCount; idx++) {
+		if (udpPendingSockets[idx].active && strncmp(udpPendingSockets[idx].inputLocation, inputLocation, DEF_STR_LEN) == 0) {
+			if (take) {
+				udpPendingSockets[idx].active = 0;
+			}
+			return udpPendingSockets[idx].fd;
+		}
+	}
+
+	return -1;
+}
+
+
+// Read Interface
+
+/**
+ * @brief      Setup the read I/O struct to receive packets from a UDP socket
+ *
+ * @param      input          The input
+ * @param[in]  inputLocation  The "[host:]port" to bind to
+ * @param[in]  port           The index offset from the base port
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_setup_UDP(lofar_udp_io_read_config *const input, const char *inputLocation, const int8_t port) {
+	lofar_udp_io_udp_reader *udp = calloc(1, sizeof(lofar_udp_io_udp_reader));
+	CHECK_ALLOC_NOCLEAN(udp, -1);
+	input->udpReader[port] = udp;
+
+	// Adopt the socket from the header scan if there is one, so the first packets are not lost
+	if ((udp->fd = _lofar_udp_io_read_UDP_pending(inputLocation, 1)) < 0 && (udp->fd = _lofar_udp_io_read_UDP_open(inputLocation)) < 0) {
+		return -1;
+	}
+
+	for (int32_t msg = 0; msg < UDP_BATCH_SIZE; msg++) {
+		udp->msgs[msg].msg_hdr.msg_iov = &(udp->iovecs[msg]);
+		udp->msgs[msg].msg_hdr.msg_iovlen = 1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Receive packets from a UDP socket, batching datagrams directly into consecutive packet slots
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base port
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     <0: Failure, >=0 Characters read (less than requested if the stream has timed out)
+ */
+int64_t _lofar_udp_io_read_UDP(lofar_udp_io_read_config *const input, const int8_t port, int8_t *const targetArray, const int64_t nchars) {
+	VERBOSE(printf("reader_nchars: Entering read request (udp): %d, %ld\n", port, nchars));
+	lofar_udp_io_udp_reader *udp = input->udpReader[port];
+	if (udp == NULL) {
+		fprintf(stderr, "ERROR %s: UDP reader is null on port %d, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	// Every datagram on a port is expected to have the same length, take it from the first datagram
+	if (udp->packetLength < 1) {
+		ssize_t datagramLength;
+		while ((datagramLength = recv(udp->fd, NULL, 0, MSG_PEEK | MSG_TRUNC)) < 0 && errno == EINTR);
+		if (datagramLength < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return 0;
+			}
+			fprintf(stderr, "ERROR %s: Failed to receive from socket on port %d (errno %d: %s), exiting.\n", __func__, port, errno, strerror(errno));
+			return -1;
+		}
+		udp->packetLength = datagramLength;
+	}
+
+	// Reads shorter than a packet only take the start of the next datagram
+	if (nchars < udp->packetLength) {
+		ssize_t received;
+		while ((received = recv(udp->fd, targetArray, nchars, 0)) < 0 && errno == EINTR);
+		return (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) ? 0 : received;
+	}
+
+	const int64_t packetLength = udp->packetLength;
+	const int64_t packetsRequested = nchars / packetLength;
+	int64_t packetsRead = 0;
+	while (packetsRead < packetsRequested) {
+		const int32_t batch = (int32_t) ((packetsRequested - packetsRead) < UDP_BATCH_SIZE ? (packetsRequested - packetsRead) : UDP_BATCH_SIZE);
+		for (int32_t msg = 0; msg < batch; msg++) {
+			udp->iovecs[msg].iov_base = &(targetArray[(packetsRead + msg) * packetLength]);
+			udp->iovecs[msg].iov_len = packetLength;
+			udp->msgs[msg].msg_hdr.msg_flags = 0;
+		}
+
+		// Block until at least one datagram is available (or the timeout is reached), then take what is queued
+		const int32_t received = recvmmsg(udp->fd, udp->msgs, batch, MSG_WAITFORONE, NULL);
+		if (received < 0) {
+			if (errno == EINTR) {
+				continue;
+			} else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				VERBOSE(printf("%s: No packets received on port %d within %ds, assuming the stream has ended.\n", __func__, port, UDP_TIMEOUT));
+				break;
+			}
+			fprintf(stderr, "ERROR %s: Failed to receive from socket on port %d (errno %d: %s), exiting.\n", __func__, port, errno, strerror(errno));
+			return -1;
+		}
+
+		// Keep full-length packets, shuffling later packets over any truncated or short datagrams
+		int32_t kept = 0;
+		for (int32_t msg = 0; msg < received; msg++) {
+			if (udp->msgs[msg].msg_len != (uint32_t) packetLength || (udp->msgs[msg].msg_hdr.msg_flags & MSG_TRUNC)) {
+				udp->packetsDiscarded++;
+				continue;
+			}
+			if (kept != msg) {
+				memmove(&(targetArray[(packetsRead + kept) * packetLength]), &(targetArray[(packetsRead + msg) * packetLength]), packetLength);
+			}
+			kept++;
+		}
+		packetsRead += kept;
+	}
+
+	return packetsRead * packetLength;
+}
+
+/**
+ * @brief      Temporarily read the start of the first datagram on a UDP input. The socket is kept open for the reader to
+ *             adopt, and when resetSeek is set the datagram is only peeked, so it is still the first packet received.
+ *
+ * @param      outbuf         The output buffer
+ * @param[in]  size           The size of each element
+ * @param[in]  num            The number of elements
+ * @param[in]  inputLocation  The "[host:]port" to bind to
+ * @param[in]  resetSeek      bool: leave the datagram queued on the socket
+ *
+ * @return     >0: Success, bytes read, <=0: Failure
+ */
+int64_t _lofar_udp_io_read_temp_UDP(void *outbuf, const int64_t size, const int64_t num, const char inputLocation[], const int8_t resetSeek) {
+	if (outbuf == NULL || inputLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed nullptr (outbuf: %p, inputLocation %p), exiting.\n", __func__, outbuf, inputLocation);
+		return -1;
+	}
+
+	int32_t fd = _lofar_udp_io_read_UDP_pending(inputLocation, 0);
+	const int8_t newSocket = fd < 0;
+	if (newSocket && (fd = _lofar_udp_io_read_UDP_open(inputLocation)) < 0) {
+		return -1;
+	}
+
+	ssize_t received;
+	while ((received = recv(fd, outbuf, size * num, resetSeek ? MSG_PEEK : 0)) < 0 && errno == EINTR);
+	if (received < 0) {
+		fprintf(stderr, "ERROR %s: Failed to receive a packet from %s (errno %d: %s), exiting.\n", __func__, inputLocation, errno, strerror(errno));
+		if (newSocket) {
+			close(fd);
+		}
+		return -1;
+	}
+
+	if (newSocket) {
+		int32_t pendingIdx = -1;
+		for (int32_t idx = 0; idx < udpPendingCount && pendingIdx < 0; idx++) {
+			if (!udpPendingSockets[idx].active) {
+				pendingIdx = idx;
+			}
+		}
+		if (pendingIdx < 0) {
+			struct lofar_udp_io_udp_pending *grown = realloc(udpPendingSockets, (udpPendingCount + 1) * sizeof(struct lofar_udp_io_udp_pending));
+			if (grown != NULL) {
+				udpPendingSockets = grown;
+				pendingIdx = udpPendingCount++;
+			}
+		}
+		if (pendingIdx >= 0) {
+			udpPendingSockets[pendingIdx].active = 1;
+			udpPendingSockets[pendingIdx].fd = fd;
+			strncpy(udpPendingSockets[pendingIdx].inputLocation, inputLocation, DEF_STR_LEN);
+			udpPendingSockets[pendingIdx].inputLocation[DEF_STR_LEN] = '\0';
+		} else {
+			fprintf(stderr, "WARNING %s: Failed to track the pending UDP socket, closing %s; packets may be missed before the reader binds it again.\n", __func__, inputLocation);
+			close(fd);
+		}
+	}
+
+	return received;
+}
+
+/**
+ * @brief      Close the socket for a UDP input
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base port
+ */
+void _lofar_udp_io_read_cleanup_UDP(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input == NULL) {
+		return;
+	}
+
+	lofar_udp_io_udp_reader *udp = input->udpReader[port];
+	if (udp != NULL) {
+		if (udp->packetsDiscarded > 0) {
+			fprintf(stderr, "WARNING: Discarded %ld datagrams that did not match the packet length (%ld bytes) on port %d.\n", udp->packetsDiscarded, udp->packetLength, port);
+		}
+		if (udp->fd > -1) {
+			close(udp->fd);
+		}
+		FREE_NOT_NULL(input->udpReader[port]);
+	}
+}
+
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
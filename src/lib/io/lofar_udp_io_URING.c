@@ -0,0 +1,539 @@
+
+// io_uring reader state for a single port; the submission/completion queues are accessed directly rather than through liburing
+struct lofar_udp_io_uring_reader {
+	// Kernel ring references
+	int32_t ringFd;
+	int8_t *sqRing;
+	int8_t *cqRing;
+	int64_t sqRingSize;
+	int64_t cqRingSize;
+	struct io_uring_sqe *sqes;
+	int64_t sqesSize;
+	uint32_t *sqHead, *sqTail, *sqMask, *sqArray;
+	uint32_t *cqHead, *cqTail, *cqMask;
+	struct io_uring_cqe *cqes;
+
+	// Input file, opened with O_DIRECT where the filesystem supports it (directIO), and a page cached reference for
+	// reads that cannot meet O_DIRECT's alignment requirements
+	int32_t fd;
+	int32_t bufferedFd;
+	int8_t directIO;
+	int64_t fileSize;
+	int64_t offset; // File offset of the next byte to return
+
+	// Aligned read-ahead blocks for small reads, one per read in flight. Blocks are consumed in order, starting from headSlot,
+	// which holds the data starting at headOffset in the file. The blocks are only filled while ringActive is set.
+	int8_t ringActive;
+	int8_t *blocks;
+	int64_t blockSize;
+	int8_t registeredBlocks;
+	int64_t blockLength[URING_QUEUE_DEPTH]; // -1: read in flight, >=0: bytes available
+	int32_t headSlot;
+	int64_t headOffset;
+	int64_t headPos;
+	int32_t pending;
+};
+
+
+/**
+ * @brief      Map the submission and completion queues for a new io_uring instance
+ *
+ * @param      uring  The io_uring reader state
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_read_URING_ring_setup(lofar_udp_io_uring_reader *uring) {
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+
+	uring->ringFd = (int32_t) syscall(__NR_io_uring_setup, URING_QUEUE_DEPTH, &params);
+	if (uring->ringFd < 0) {
+		fprintf(stderr, "ERROR: Failed to create io_uring instance (errno %d: %s), exiting.\n", errno, strerror(errno));
+		return -1;
+	}
+
+	uring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+	uring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	// Newer kernels share a single mapping between both rings
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		uring->sqRingSize = uring->cqRingSize = uring->sqRingSize > uring->cqRingSize ? uring->sqRingSize : uring->cqRingSize;
+	}
+
+	uring->sqRing = mmap(NULL, uring->sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->ringFd, IORING_OFF_SQ_RING);
+	if (uring->sqRing == MAP_FAILED) {
+		uring->sqRing = NULL;
+		fprintf(stderr, "ERROR: Failed to map io_uring submission queue (errno %d: %s), exiting.\n", errno, strerror(errno));
+		return -1;
+	}
+
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		uring->cqRing = uring->sqRing;
+	} else {
+		uring->cqRing = mmap(NULL, uring->cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->ringFd, IORING_OFF_CQ_RING);
+		if (uring->cqRing == MAP_FAILED) {
+			uring->cqRing = NULL;
+			fprintf(stderr, "ERROR: Failed to map io_uring completion queue (errno %d: %s), exiting.\n", errno, strerror(errno));
+			return -1;
+		}
+	}
+
+	uring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	uring->sqes = mmap(NULL, uring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, uring->ringFd, IORING_OFF_SQES);
+	if (uring->sqes == MAP_FAILED) {
+		uring->sqes = NULL;
+		fprintf(stderr, "ERROR: Failed to map io_uring submission entries (errno %d: %s), exiting.\n", errno, strerror(errno));
+		return -1;
+	}
+
+	uring->sqHead = (uint32_t *) (uring->sqRing + params.sq_off.head);
+	uring->sqTail = (uint32_t *) (uring->sqRing + params.sq_off.tail);
+	uring->sqMask = (uint32_t *) (uring->sqRing + params.sq_off.ring_mask);
+	uring->sqArray = (uint32_t *) (uring->sqRing + params.sq_off.array);
+	uring->cqHead = (uint32_t *) (uring->cqRing + params.cq_off.head);
+	uring->cqTail = (uint32_t *) (uring->cqRing + params.cq_off.tail);
+	uring->cqMask = (uint32_t *) (uring->cqRing + params.cq_off.ring_mask);
+	uring->cqes = (struct io_uring_cqe *) (uring->cqRing + params.cq_off.cqes);
+
+	return 0;
+}
+
+/**
+ * @brief      Queue a read into a slot's completion record, to be submitted with _lofar_udp_io_read_URING_enter
+ *
+ * @param      uring   The io_uring reader state
+ * @param[in]  slot    The slot the completion is recorded in
+ * @param[in]  fd      The file descriptor to read from
+ * @param      dest    The destination buffer
+ * @param[in]  length  The number of bytes to read
+ * @param[in]  offset  The file offset to read from
+ * @param[in]  fixed   Whether dest is the slot's registered block
+ */
+static void _lofar_udp_io_read_URING_prep(lofar_udp_io_uring_reader *uring, const int32_t slot, const int32_t fd, int8_t *const dest,
+                                          const int64_t length, const int64_t offset, const int8_t fixed) {
+	const uint32_t tail = *(uring->sqTail);
+	const uint32_t index = tail & *(uring->sqMask);
+	struct io_uring_sqe *sqe = &(uring->sqes[index]);
+	memset(sqe, 0, sizeof(struct io_uring_sqe));
+
+	sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+	sqe->fd = fd;
+	sqe->off = (uint64_t) offset;
+	sqe->addr = (uint64_t) (uintptr_t) dest;
+	sqe->len = (uint32_t) length;
+	sqe->buf_index = (uint16_t) (fixed ? slot : 0);
+	sqe->user_data = (uint64_t) slot;
+
+	uring->sqArray[index] = index;
+	uring->blockLength[slot] = -1;
+	uring->pending++;
+	// The entry must be visible before the kernel sees the new tail
+	__atomic_store_n(uring->sqTail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief      Queue a read of the block at a file offset into a slot, slots past the end of the file are marked empty
+ *
+ * @param      uring   The io_uring reader state
+ * @param[in]  slot    The target slot
+ * @param[in]  offset  The file offset of the block
+ *
+ * @return     1: Read queued, 0: Nothing to read
+ */
+static int32_t _lofar_udp_io_read_URING_queue(lofar_udp_io_uring_reader *uring, const int32_t slot, const int64_t offset) {
+	if (offset >= uring->fileSize) {
+		uring->blockLength[slot] = 0;
+		return 0;
+	}
+
+	_lofar_udp_io_read_URING_prep(uring, slot, uring->fd, uring->blocks + (int64_t) slot * uring->blockSize, uring->blockSize, offset, uring->registeredBlocks);
+	return 1;
+}
+
+/**
+ * @brief      Submit queued reads to the kernel, optionally waiting on completions
+ *
+ * @param      uring        The io_uring reader state
+ * @param[in]  toSubmit     Number of queued reads
+ * @param[in]  minComplete  Number of completions to wait on
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_read_URING_enter(lofar_udp_io_uring_reader *uring, uint32_t toSubmit, const uint32_t minComplete) {
+	while (toSubmit > 0 || minComplete > 0) {
+		int32_t submitted = (int32_t) syscall(__NR_io_uring_enter, uring->ringFd, toSubmit, minComplete, minComplete > 0 ? IORING_ENTER_GETEVENTS : 0, NULL, 0);
+		if (submitted < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			fprintf(stderr, "ERROR: Failed to submit io_uring reads (errno %d: %s), exiting.\n", errno, strerror(errno));
+			return -1;
+		}
+		toSubmit -= (uint32_t) submitted;
+		if (minComplete > 0 || submitted == 0) {
+			break;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Move any completed reads into their slots
+ *
+ * @param      uring  The io_uring reader state
+ *
+ * @return     >=0: Number of reads completed, <0: Failure
+ */
+static int32_t _lofar_udp_io_read_URING_reap(lofar_udp_io_uring_reader *uring) {
+	int32_t completed = 0, returnVal = 0;
+	uint32_t head = *(uring->cqHead);
+	const uint32_t tail = __atomic_load_n(uring->cqTail, __ATOMIC_ACQUIRE);
+
+	while (head != tail) {
+		const struct io_uring_cqe *cqe = &(uring->cqes[head & *(uring->cqMask)]);
+		const int32_t slot = (int32_t) cqe->user_data;
+		if (cqe->res < 0) {
+			fprintf(stderr, "ERROR: io_uring read failed for slot %d (errno %d: %s).\n", slot, -cqe->res, strerror(-cqe->res));
+			returnVal = -1;
+			uring->blockLength[slot] = 0;
+		} else {
+			uring->blockLength[slot] = cqe->res;
+		}
+		uring->pending--;
+		completed++;
+		head++;
+	}
+	__atomic_store_n(uring->cqHead, head, __ATOMIC_RELEASE);
+
+	return returnVal < 0 ? returnVal : completed;
+}
+
+/**
+ * @brief      Wait for the read into a slot to complete (a slot of -1 waits on every read in flight)
+ *
+ * @param      uring  The io_uring reader state
+ * @param[in]  slot   The target slot, or -1
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_read_URING_wait(lofar_udp_io_uring_reader *uring, const int32_t slot) {
+	int32_t returnVal = 0;
+	while (slot < 0 ? uring->pending > 0 : uring->blockLength[slot] < 0) {
+		int32_t completed = _lofar_udp_io_read_URING_reap(uring);
+		if (completed < 0) {
+			returnVal = -1;
+		} else if (completed == 0 && _lofar_udp_io_read_URING_enter(uring, 0, 1) < 0) {
+			return -1;
+		}
+	}
+
+	return returnVal;
+}
+
+/**
+ * @brief      Fill every slot with consecutive blocks, starting from an aligned file offset
+ *
+ * @param      uring   The io_uring reader state
+ * @param[in]  offset  The aligned file offset
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_read_URING_fill(lofar_udp_io_uring_reader *uring, const int64_t offset) {
+	uint32_t queued = 0;
+	uring->ringActive = 1;
+	uring->headSlot = 0;
+	uring->headOffset = offset;
+	for (int32_t slot = 0; slot < URING_QUEUE_DEPTH; slot++) {
+		queued += _lofar_udp_io_read_URING_queue(uring, slot, offset + (int64_t) slot * uring->blockSize);
+	}
+
+	return _lofar_udp_io_read_URING_enter(uring, queued, 0);
+}
+
+
+/**
+ * @brief      Read straight into the caller's buffer, with up to URING_QUEUE_DEPTH reads in flight. O_DIRECT requires the buffer,
+ * 				offset and length to be aligned, so it is used when the buffer shares the file offset's alignment; the unaligned
+ * 				edges (or the whole read, otherwise) go through the page cache.
+ *
+ * @param      uring   The io_uring reader state
+ * @param      dest    The destination buffer
+ * @param[in]  nchars  The number of bytes to read
+ *
+ * @return     >=0: Bytes read, <0: Failure
+ */
+static int64_t _lofar_udp_io_read_URING_direct(lofar_udp_io_uring_reader *uring, int8_t *const dest, const int64_t nchars) {
+	const int64_t length = nchars < (uring->fileSize - uring->offset) ? nchars : (uring->fileSize - uring->offset);
+
+	int64_t directStart = length, directEnd = length;
+	if (uring->directIO && (int64_t) ((uintptr_t) dest % URING_ALIGNMENT) == uring->offset % URING_ALIGNMENT) {
+		directStart = (URING_ALIGNMENT - (uring->offset % URING_ALIGNMENT)) % URING_ALIGNMENT;
+		if (directStart < length) {
+			directEnd = directStart + ((length - directStart) / URING_ALIGNMENT) * URING_ALIGNMENT;
+		} else {
+			directStart = length;
+		}
+	}
+
+	int64_t requested = 0;
+	int64_t expected[URING_QUEUE_DEPTH];
+	while (requested < length) {
+		uint32_t queued = 0;
+		for (int32_t slot = 0; slot < URING_QUEUE_DEPTH && requested < length; slot++) {
+			const int8_t direct = requested >= directStart && requested < directEnd;
+			const int64_t segmentEnd = requested < directStart ? directStart : (direct ? directEnd : length);
+			expected[slot] = (segmentEnd - requested) < URING_BLOCK_SIZE ? (segmentEnd - requested) : URING_BLOCK_SIZE;
+			_lofar_udp_io_read_URING_prep(uring, slot, direct ? uring->fd : uring->bufferedFd, dest + requested, expected[slot], uring->offset + requested, 0);
+			requested += expected[slot];
+			queued++;
+		}
+
+		if (_lofar_udp_io_read_URING_enter(uring, queued, 0) < 0 || _lofar_udp_io_read_URING_wait(uring, -1) < 0) {
+			return -1;
+		}
+		for (uint32_t slot = 0; slot < queued; slot++) {
+			if (uring->blockLength[slot] != expected[slot]) {
+				fprintf(stderr, "ERROR %s: Short io_uring read (%ld of %ld bytes near offset %ld), exiting.\n", __func__, uring->blockLength[slot], expected[slot], uring->offset + requested);
+				return -1;
+			}
+		}
+	}
+
+	uring->offset += length;
+	return length;
+}
+
+
+// Read Interface
+
+/**
+ * @brief      Setup the read I/O struct to handle normal data through io_uring, bypassing the page cache where possible
+ *
+ * @param      input   The input
+ * @param[in]  inputLocation    The input file location
+ * @param[in]  port    The index offset from the base file
+ *
+ * @return     0: Success, -1: Failure, -2: io_uring is unavailable
+ */
+int32_t _lofar_udp_io_read_setup_URING(lofar_udp_io_read_config *const input, const char *inputLocation, const int8_t port) {
+	// Keep a normal file reference for size checks and indexes
+	int32_t returnVal = _lofar_udp_io_read_setup_FILE(input, inputLocation, port);
+	if (returnVal < 0) {
+		return returnVal;
+	}
+
+	lofar_udp_io_uring_reader *uring = calloc(1, sizeof(lofar_udp_io_uring_reader));
+	CHECK_ALLOC_NOCLEAN(uring, -1);
+	uring->ringFd = -1;
+	uring->fd = -1;
+	uring->bufferedFd = -1;
+	input->uringReader[port] = uring;
+
+	if ((uring->fileSize = _FILE_file_size(input->fileRef[port])) < 0) {
+		fprintf(stderr, "ERROR: Failed to get size of file at %s, exiting.\n", inputLocation);
+		return -1;
+	}
+
+	uring->fd = open(inputLocation, O_RDONLY | O_DIRECT | O_CLOEXEC);
+	uring->directIO = uring->fd > -1;
+	if (uring->fd < 0 && errno == EINVAL) {
+		fprintf(stderr, "WARNING: Filesystem does not support O_DIRECT for %s, reads will use the page cache.\n", inputLocation);
+		uring->fd = open(inputLocation, O_RDONLY | O_CLOEXEC);
+	}
+	if (uring->fd < 0) {
+		fprintf(stderr, "ERROR: Failed to open file at %s: errno %d, %s.\n", inputLocation, errno, strerror(errno));
+		return -1;
+	}
+	uring->bufferedFd = uring->directIO ? open(inputLocation, O_RDONLY | O_CLOEXEC) : uring->fd;
+	if (uring->bufferedFd < 0) {
+		fprintf(stderr, "ERROR: Failed to open file at %s: errno %d, %s.\n", inputLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	// The blocks only serve reads smaller than URING_DIRECT_MIN_READ, cap them at the (aligned) read size
+	uring->blockSize = URING_DIRECT_MIN_READ;
+	if (input->readBufSize[port] > 0 && input->readBufSize[port] < URING_DIRECT_MIN_READ) {
+		uring->blockSize = ((input->readBufSize[port] + URING_ALIGNMENT - 1) / URING_ALIGNMENT) * URING_ALIGNMENT;
+	}
+
+	if (posix_memalign((void **) &(uring->blocks), URING_ALIGNMENT, URING_QUEUE_DEPTH * uring->blockSize) != 0) {
+		uring->blocks = NULL;
+		fprintf(stderr, "ERROR: Failed to allocate io_uring read blocks on port %d, exiting.\n", port);
+		return -1;
+	}
+
+	if (_lofar_udp_io_read_URING_ring_setup(uring) < 0) {
+		return -2;
+	}
+
+	// Registered buffers avoid mapping the blocks on every read, but count against RLIMIT_MEMLOCK on older kernels
+	struct iovec blockVecs[URING_QUEUE_DEPTH];
+	for (int32_t slot = 0; slot < URING_QUEUE_DEPTH; slot++) {
+		blockVecs[slot].iov_base = uring->blocks + (int64_t) slot * uring->blockSize;
+		blockVecs[slot].iov_len = uring->blockSize;
+	}
+	uring->registeredBlocks = syscall(__NR_io_uring_register, uring->ringFd, IORING_REGISTER_BUFFERS, blockVecs, URING_QUEUE_DEPTH) == 0;
+	VERBOSE(if (!uring->registeredBlocks) { printf("%s: Failed to register io_uring buffers on port %d (errno %d), continuing without them.\n", __func__, port, errno); });
+
+	// The read-ahead blocks are filled on the first small read
+	uring->offset = 0;
+	uring->ringActive = 0;
+	return 0;
+}
+
+/**
+ * @brief      Perform a data read for a file through io_uring
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     <=0: Failure, >0 Characters read
+ */
+int64_t _lofar_udp_io_read_URING(lofar_udp_io_read_config *const input, const int8_t port, int8_t *const targetArray, const int64_t nchars) {
+	VERBOSE(printf("reader_nchars: Entering read request (io_uring): %d, %ld\n", port, nchars));
+	lofar_udp_io_uring_reader *uring = input->uringReader[port];
+	if (uring == NULL) {
+		fprintf(stderr, "ERROR %s: io_uring reader is null on port %d, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	// Large reads skip the read-ahead blocks; anything already read ahead is dropped rather than copied
+	if (nchars >= URING_DIRECT_MIN_READ) {
+		if (uring->ringActive) {
+			if (_lofar_udp_io_read_URING_wait(uring, -1) < 0) {
+				return -1;
+			}
+			uring->ringActive = 0;
+		}
+		return _lofar_udp_io_read_URING_direct(uring, targetArray, nchars);
+	}
+
+	if (!uring->ringActive) {
+		const int64_t alignedOffset = uring->offset - (uring->offset % URING_ALIGNMENT);
+		uring->headPos = uring->offset - alignedOffset;
+		if (_lofar_udp_io_read_URING_fill(uring, alignedOffset) < 0) {
+			return -1;
+		}
+	}
+
+	int64_t dataRead = 0;
+	while (dataRead < nchars) {
+		const int32_t slot = uring->headSlot;
+		if (_lofar_udp_io_read_URING_wait(uring, slot) < 0) {
+			return -1;
+		}
+
+		const int64_t available = uring->blockLength[slot] - uring->headPos;
+		const int64_t copyLength = available < (nchars - dataRead) ? available : (nchars - dataRead);
+		if (copyLength > 0) {
+			memcpy(&(targetArray[dataRead]), uring->blocks + (int64_t) slot * uring->blockSize + uring->headPos, copyLength);
+			dataRead += copyLength;
+			uring->headPos += copyLength;
+		}
+
+		if (uring->headPos < uring->blockLength[slot]) {
+			continue;
+		}
+
+		// Short blocks are only expected at the end of the file
+		if (uring->blockLength[slot] < uring->blockSize) {
+			if (uring->headOffset + uring->blockLength[slot] >= uring->fileSize) {
+				break;
+			}
+			fprintf(stderr, "ERROR %s: Short io_uring read on port %d (%ld bytes at offset %ld), exiting.\n", __func__, port, uring->blockLength[slot], uring->headOffset);
+			return -1;
+		}
+
+		// Block consumed: re-use the slot for the block after those already in flight
+		if (_lofar_udp_io_read_URING_enter(uring, _lofar_udp_io_read_URING_queue(uring, slot, uring->headOffset + URING_QUEUE_DEPTH * uring->blockSize), 0) < 0) {
+			return -1;
+		}
+		uring->headSlot = (slot + 1) % URING_QUEUE_DEPTH;
+		uring->headOffset += uring->blockSize;
+		uring->headPos = 0;
+	}
+
+	uring->offset += dataRead;
+	return dataRead;
+}
+
+/**
+ * @brief      Seek an io_uring input to a given byte offset
+ *
+ * @param      input       The input
+ * @param[in]  port        The index offset from the base file
+ * @param[in]  byteOffset  The target offset
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_seek_URING(lofar_udp_io_read_config *const input, const int8_t port, const int64_t byteOffset) {
+	lofar_udp_io_uring_reader *uring = input->uringReader[port];
+	if (uring == NULL || byteOffset < 0 || byteOffset > uring->fileSize) {
+		fprintf(stderr, "ERROR %s: Cannot seek port %d to byte %ld (reader %p), exiting.\n", __func__, port, byteOffset, uring);
+		return -1;
+	}
+
+	// Reads in flight must land before their blocks are re-used
+	if (_lofar_udp_io_read_URING_wait(uring, -1) < 0) {
+		return -1;
+	}
+
+	uring->offset = byteOffset;
+	uring->ringActive = 0;
+	return 0;
+}
+
+/**
+ * @brief      Cleanup the io_uring instance and file references for an input
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base file
+ */
+void _lofar_udp_io_read_cleanup_URING(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input == NULL) {
+		return;
+	}
+
+	lofar_udp_io_uring_reader *uring = input->uringReader[port];
+	if (uring != NULL) {
+		if (uring->ringFd > -1) {
+			// The kernel may still be writing into the blocks
+			_lofar_udp_io_read_URING_wait(uring, -1);
+			if (uring->sqes != NULL) munmap(uring->sqes, uring->sqesSize);
+			if (uring->cqRing != NULL && uring->cqRing != uring->sqRing) munmap(uring->cqRing, uring->cqRingSize);
+			if (uring->sqRing != NULL) munmap(uring->sqRing, uring->sqRingSize);
+			close(uring->ringFd);
+		}
+		if (uring->bufferedFd > -1 && uring->bufferedFd != uring->fd) {
+			close(uring->bufferedFd);
+		}
+		if (uring->fd > -1) {
+			close(uring->fd);
+		}
+		FREE_NOT_NULL(uring->blocks);
+		FREE_NOT_NULL(input->uringReader[port]);
+	}
+
+	_lofar_udp_io_read_cleanup_FILE(input, port);
+}
+
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
@@ -1,4 +1,206 @@
 
+// Filter Interface
+
+
+/**
+ * @brief      Get the size of the independently filtered blocks for a given element size
+ *
+ * @param[in]  elementSize  The number of bytes per element
+ *
+ * @return     The block size in bytes
+ */
+static int64_t _lofar_udp_io_ZSTD_filter_block_size(const int32_t elementSize) {
+	// Whole groups of 8 elements, so that bitshuffle never needs to handle a partial group inside a block
+	return ZSTD_FILTER_BLOCK_SIZE - (ZSTD_FILTER_BLOCK_SIZE % (8 * elementSize));
+}
+
+/**
+ * @brief      Apply (or revert) a filter to a block of data. Trailing bytes that do not form a whole element (or, for bitshuffle,
+ * 				a whole group of 8 elements) are copied as-is.
+ *
+ * @param[in]  filter       The filter
+ * @param[in]  elementSize  The number of bytes per element
+ * @param[in]  src          The source block
+ * @param      dst          The destination, which must not overlap the source
+ * @param[in]  nchars       The number of bytes in the block
+ * @param[in]  revert       Apply (0) / revert (1) the filter
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_ZSTD_filter_block(const zstd_filter_t filter, const int32_t elementSize, const int8_t *src, int8_t *dst, const int64_t nchars, const int8_t revert) {
+	int64_t elements = nchars / elementSize;
+
+	switch (filter) {
+		case ZSTD_FILTER_BYTESHUFFLE:
+			// Group the n-th byte of every element together, e.g. all Xr, then all Xi, all Yr and all Yi samples
+			for (int64_t element = 0; element < elements; element++) {
+				for (int32_t byte = 0; byte < elementSize; byte++) {
+					if (revert) {
+						dst[element * elementSize + byte] = src[byte * elements + element];
+					} else {
+						dst[byte * elements + element] = src[element * elementSize + byte];
+					}
+				}
+			}
+			break;
+
+		case ZSTD_FILTER_BITSHUFFLE:
+			elements -= elements % 8;
+			if (elements > 0) {
+				const int64_t returnVal = revert ? bshuf_bitunshuffle(src, dst, elements, elementSize, 0) : bshuf_bitshuffle(src, dst, elements, elementSize, 0);
+				if (returnVal < 0) {
+					fprintf(stderr, "ERROR %s: Bitshuffle failed on a %ld byte block (%ld), exiting.\n", __func__, nchars, returnVal);
+					return -1;
+				}
+			}
+			break;
+
+		default:
+			fprintf(stderr, "ERROR %s: Unknown filter %d, exiting.\n", __func__, filter);
+			return -1;
+	}
+
+	const int64_t filtered = elements * elementSize;
+	if (filtered < nchars) {
+		memcpy(&(dst[filtered]), &(src[filtered]), nchars - filtered);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Build the skippable frame that describes the filtered frame following it
+ *
+ * @param      header       The output header, ZSTD_FILTER_HEADER_SIZE bytes
+ * @param[in]  filter       The filter
+ * @param[in]  elementSize  The number of bytes per element
+ * @param[in]  blockSize    The size of the independently filtered blocks
+ * @param[in]  length       The decompressed length of the filtered frame
+ */
+static void _lofar_udp_io_ZSTD_filter_header(uint8_t header[ZSTD_FILTER_HEADER_SIZE], const zstd_filter_t filter, const int32_t elementSize, const int64_t blockSize, const int64_t length) {
+	// Skippable frame (magic, payload length), then "UPMF", version, filter, element size, block size, frame length; all little endian
+	const uint64_t fields[][2] = { { ZSTD_FILTER_MAGIC, 4 }, { ZSTD_FILTER_HEADER_SIZE - 8, 4 }, { 0x464D5055U, 4 }, { 1, 1 }, { filter, 1 },
+	                               { (uint64_t) elementSize, 2 }, { (uint64_t) blockSize, 4 }, { (uint64_t) length, 8 } };
+
+	int32_t offset = 0;
+	for (size_t field = 0; field < sizeof(fields) / sizeof(fields[0]); field++) {
+		for (uint64_t byte = 0; byte < fields[field][1]; byte++) {
+			header[offset++] = (uint8_t) ((fields[field][0] >> (8 * byte)) & 0xFF);
+		}
+	}
+}
+
+/**
+ * @brief      Read a little endian value from a filter description
+ *
+ * @param[in]  header  The description
+ * @param[in]  offset  The offset of the value
+ * @param[in]  size    The size of the value in bytes
+ *
+ * @return     The value
+ */
+static uint64_t _lofar_udp_io_ZSTD_filter_field(const uint8_t *header, const int32_t offset, const int32_t size) {
+	uint64_t value = 0;
+	for (int32_t byte = size - 1; byte >= 0; byte--) {
+		value = (value << 8) | header[offset + byte];
+	}
+	return value;
+}
+
+/**
+ * @brief      Parse the filter description at the start of a buffer, if one is present
+ *
+ * @param[in]  data    The compressed data, starting at a frame boundary
+ * @param[in]  length  The number of bytes available
+ * @param      filter  The filter state, updated to describe the following frame if a description was found
+ *
+ * @return     >0: Description length, 0: Not a filter description, -1: Incomplete description, <-1: Invalid description
+ */
+static int64_t _lofar_udp_io_ZSTD_filter_parse(const int8_t *data, const int64_t length, lofar_udp_io_zstd_filter *filter) {
+	const uint8_t *header = (const uint8_t *) data;
+
+	if (length < 4) {
+		return -1;
+	}
+	if (_lofar_udp_io_ZSTD_filter_field(header, 0, 4) != ZSTD_FILTER_MAGIC) {
+		return 0;
+	}
+	if (length < ZSTD_FILTER_HEADER_SIZE) {
+		return -1;
+	}
+
+	const uint64_t payloadLength = _lofar_udp_io_ZSTD_filter_field(header, 4, 4);
+	const uint64_t signature = _lofar_udp_io_ZSTD_filter_field(header, 8, 4);
+	const uint64_t version = _lofar_udp_io_ZSTD_filter_field(header, 12, 1);
+	const uint64_t filterType = _lofar_udp_io_ZSTD_filter_field(header, 13, 1);
+	const uint64_t elementSize = _lofar_udp_io_ZSTD_filter_field(header, 14, 2);
+	const uint64_t blockSize = _lofar_udp_io_ZSTD_filter_field(header, 16, 4);
+	const uint64_t frameLength = _lofar_udp_io_ZSTD_filter_field(header, 20, 8);
+	if (payloadLength != ZSTD_FILTER_HEADER_SIZE - 8 || signature != 0x464D5055U || version != 1
+		|| (filterType != ZSTD_FILTER_BYTESHUFFLE && filterType != ZSTD_FILTER_BITSHUFFLE) || elementSize < 1 || blockSize < 8 * elementSize
+		|| blockSize > ZSTD_FILTER_BLOCK_SIZE || blockSize % (8 * elementSize) || frameLength < 1 || frameLength > INT64_MAX) {
+		fprintf(stderr, "ERROR %s: Invalid zstandard filter description (filter %lu, element %lu, block %lu, length %lu), exiting.\n", __func__, filterType, elementSize, blockSize, frameLength);
+		return -2;
+	}
+
+	filter->filter = (zstd_filter_t) filterType;
+	filter->elementSize = (int32_t) elementSize;
+	filter->blockSize = (int64_t) blockSize;
+	filter->remaining = (int64_t) frameLength;
+	filter->pending = 0;
+
+	return ZSTD_FILTER_HEADER_SIZE;
+}
+
+/**
+ * @brief      Account for newly decompressed data of a filtered frame, then revert the filter on every block that is now complete.
+ * 				The data are handled in place, at the end of the decompressed data.
+ *
+ * @param      filter      The filter state
+ * @param      end         The end of the decompressed data
+ * @param[in]  added       The number of bytes just decompressed
+ * @param[in]  frameEnded  The frame has (1) / hasn't (0) been fully decompressed
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_ZSTD_filter_restore(lofar_udp_io_zstd_filter *filter, int8_t *end, const int64_t added, const int8_t frameEnded) {
+	if (added > filter->remaining) {
+		fprintf(stderr, "ERROR %s: Filtered zstandard frame is longer than described (%ld > %ld bytes), exiting.\n", __func__, added, filter->remaining);
+		return -1;
+	}
+	filter->remaining -= added;
+	filter->pending += added;
+
+	if (filter->scratch == NULL) {
+		filter->scratch = calloc(ZSTD_FILTER_BLOCK_SIZE, sizeof(int8_t));
+		if (filter->scratch == NULL) {
+			fprintf(stderr, "ERROR %s: Failed to allocate memory to restore filtered data, exiting.\n", __func__);
+			return -1;
+		}
+	}
+
+	// Blocks are only complete once they hold blockSize bytes, or the frame has no more data
+	while (filter->pending >= filter->blockSize || (filter->remaining == 0 && filter->pending > 0)) {
+		const int64_t blockLength = filter->pending < filter->blockSize ? filter->pending : filter->blockSize;
+		int8_t *block = end - filter->pending;
+		if (_lofar_udp_io_ZSTD_filter_block(filter->filter, filter->elementSize, block, filter->scratch, blockLength, 1) < 0) {
+			return -1;
+		}
+		memcpy(block, filter->scratch, blockLength);
+		filter->pending -= blockLength;
+	}
+
+	if (filter->remaining == 0) {
+		filter->filter = ZSTD_FILTER_NONE;
+	} else if (frameEnded) {
+		fprintf(stderr, "ERROR %s: Filtered zstandard frame ended %ld bytes early, exiting.\n", __func__, filter->remaining);
+		return -1;
+	}
+
+	return 0;
+}
+
+
 // Read Interface
 
 
@@ -31,6 +233,7 @@ _lofar_udp_io_read_setup_ZSTD(lofar_udp_io_read_config *const input, const char
 	// Setup the decompression stream
 	input->dstream[port] = ZSTD_createDStream();
 	ZSTD_initDStream(input->dstream[port]);
+	input->zstdFrameBoundary[port] = 1;
 
 	// mmap the input file for better buffered reading
 	void *tmpPtr = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fileno(input->fileRef[port]), 0);
@@ -81,6 +284,182 @@ _lofar_udp_io_read_setup_ZSTD(lofar_udp_io_read_config *const input, const char
 	return 0;
 }
 
+/**
+ * @brief      Rebase the decompression buffer onto a target within a mirrored input ring, moving any leftover data
+ *             from the previous read only if it is not already in place
+ *
+ * @param      input        The input
+ * @param[in]  port         The index offset from the base file
+ * @param      targetArray  The output array
+ * @param[in]  leftover     The number of decompressed bytes remaining from the previous read
+ * @param[in]  nchars       The number of bytes to read
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_ZSTD_ring_rebase(lofar_udp_io_read_config *const input, const int8_t port, int8_t *targetArray, const int64_t leftover, const int64_t nchars) {
+	int8_t *ring = input->inputRing[port];
+	const int64_t ringSize = input->inputRingSize[port];
+	// Limit the output to the request + one zstd block, so we can never wrap around onto data still held in the ring
+	const int64_t outputSize = (leftover > nchars ? leftover : nchars) + (int64_t) ZSTD_DStreamOutSize();
+	int64_t targetOffset = targetArray - ring;
+
+	if (targetOffset < 0 || targetOffset >= 2 * ringSize || outputSize > ringSize) {
+		fprintf(stderr, "ERROR %s: Passed buffer is not within the input ring on port %d (offset %ld, size %ld), exiting.\n", __func__, port, targetOffset, outputSize);
+		return -1;
+	}
+	// Work from the first mapping so that the full output window is always addressable
+	targetOffset %= ringSize;
+
+	if (leftover > 0) {
+		const int64_t leftoverOffset = (((int8_t *) input->decompressionTracker[port].dst + input->zstdLastRead[port]) - ring) % ringSize;
+		if (leftoverOffset != targetOffset) {
+			// Only reached after seeks or re-reads. Both regions may alias through the mirror, so copy via a temporary buffer
+			int8_t *tmpBuffer = malloc(leftover);
+			CHECK_ALLOC_NOCLEAN(tmpBuffer, -1);
+			memcpy(tmpBuffer, &(ring[leftoverOffset]), leftover);
+			memcpy(&(ring[targetOffset]), tmpBuffer, leftover);
+			free(tmpBuffer);
+		}
+	}
+
+	input->decompressionTracker[port].dst = &(ring[targetOffset]);
+	input->decompressionTracker[port].size = outputSize;
+	input->decompressionTracker[port].pos = leftover;
+	input->zstdLastRead[port] = 0;
+
+	return 0;
+}
+
+/**
+ * @brief      Decompress a complete frame, then revert its filter if it has one
+ *
+ * @param      dctx          The decompression context
+ * @param      dst           The output buffer
+ * @param[in]  dstSize       The decompressed frame length
+ * @param[in]  src           The compressed frame
+ * @param[in]  srcSize       The compressed frame length
+ * @param      filter        The frame's filter
+ * @param      filterReturn  Set to the result of reverting the filter
+ *
+ * @return     The result of ZSTD_decompressDCtx
+ */
+static size_t _lofar_udp_io_read_ZSTD_decompress_frame(ZSTD_DCtx *dctx, int8_t *dst, const int64_t dstSize, const int8_t *src, const int64_t srcSize, lofar_udp_io_zstd_filter *filter, int32_t *filterReturn) {
+	const size_t returnVal = ZSTD_decompressDCtx(dctx, dst, dstSize, src, srcSize);
+
+	*filterReturn = 0;
+	if (filter->filter != ZSTD_FILTER_NONE && !ZSTD_isError(returnVal) && (int64_t) returnVal == dstSize) {
+		*filterReturn = _lofar_udp_io_ZSTD_filter_restore(filter, &(dst[dstSize]), dstSize, 1);
+	}
+	FREE_NOT_NULL(filter->scratch);
+
+	return returnVal;
+}
+
+/**
+ * @brief      Decompress the complete frames at the read head in parallel, into consecutive regions of the decompression
+ *             buffer. Only frames that record their decompressed size and fit into the remaining buffer are considered, filtered
+ *             frames are considered together with their description.
+ *
+ * @param      input   The input
+ * @param[in]  port    The index offset from the base file
+ * @param[in]  nchars  The number of bytes still needed for the current read
+ * @param[in]  streamOffset  The decompressed stream offset of the first byte that will be decompressed
+ *
+ * @return     >0: Bytes decompressed, 0: Fewer than 2 frames available (the stream should be used), <0: Failure
+ */
+int64_t _lofar_udp_io_read_ZSTD_frames(lofar_udp_io_read_config *const input, const int8_t port, const int64_t nchars, const int64_t streamOffset) {
+	const int8_t *compressedData = (const int8_t *) input->readingTracker[port].src;
+	const int64_t compressedSize = (int64_t) input->readingTracker[port].size;
+	int8_t *outputData = &(((int8_t *) input->decompressionTracker[port].dst)[input->decompressionTracker[port].pos]);
+	const int64_t outputSpace = (int64_t) (input->decompressionTracker[port].size - input->decompressionTracker[port].pos);
+
+	int64_t frameInputOffset[ZSTD_PARALLEL_FRAMES], frameInputSize[ZSTD_PARALLEL_FRAMES];
+	int64_t frameOutputOffset[ZSTD_PARALLEL_FRAMES], frameOutputSize[ZSTD_PARALLEL_FRAMES];
+	int64_t frameAnchor[ZSTD_PARALLEL_FRAMES];
+	lofar_udp_io_zstd_filter frameFilter[ZSTD_PARALLEL_FRAMES];
+	size_t frameReturn[ZSTD_PARALLEL_FRAMES];
+	int32_t filterReturn[ZSTD_PARALLEL_FRAMES];
+
+	// Find frame boundaries until the request is met; only the headers are parsed unless the frame fits in the buffer
+	int32_t numFrames = 0;
+	int64_t compressedOffset = (int64_t) input->readingTracker[port].pos, decompressedOffset = 0;
+	while (numFrames < ZSTD_PARALLEL_FRAMES && decompressedOffset < nchars && compressedOffset < compressedSize) {
+		// Incomplete or invalid filter descriptions are left for the stream to handle
+		const int64_t frameStart = compressedOffset;
+		frameFilter[numFrames] = (lofar_udp_io_zstd_filter) { ZSTD_FILTER_NONE, 0, 0, 0, 0, 0, NULL };
+		const int64_t headerLength = _lofar_udp_io_ZSTD_filter_parse(&(compressedData[compressedOffset]), compressedSize - compressedOffset, &(frameFilter[numFrames]));
+		if (headerLength < 0 || frameStart + headerLength >= compressedSize) {
+			break;
+		}
+		compressedOffset += headerLength;
+
+		const unsigned long long contentSize = ZSTD_getFrameContentSize(&(compressedData[compressedOffset]), compressedSize - compressedOffset);
+		if (contentSize == ZSTD_CONTENTSIZE_UNKNOWN || contentSize == ZSTD_CONTENTSIZE_ERROR || (int64_t) contentSize > (outputSpace - decompressedOffset)
+			|| (frameFilter[numFrames].filter != ZSTD_FILTER_NONE && (int64_t) contentSize != frameFilter[numFrames].remaining)) {
+			compressedOffset = frameStart;
+			break;
+		}
+
+		const size_t frameSize = ZSTD_findFrameCompressedSize(&(compressedData[compressedOffset]), compressedSize - compressedOffset);
+		if (ZSTD_isError(frameSize)) {
+			compressedOffset = frameStart;
+			break;
+		}
+
+		frameAnchor[numFrames] = frameStart;
+		frameInputOffset[numFrames] = compressedOffset;
+		frameInputSize[numFrames] = (int64_t) frameSize;
+		frameOutputOffset[numFrames] = decompressedOffset;
+		frameOutputSize[numFrames] = (int64_t) contentSize;
+		compressedOffset += (int64_t) frameSize;
+		decompressedOffset += (int64_t) contentSize;
+		numFrames++;
+	}
+
+	if (numFrames < 2) {
+		return 0;
+	}
+
+	for (int32_t frame = 0; frame < numFrames; frame++) {
+		if (input->frameDCtx[port][frame] == NULL) {
+			input->frameDCtx[port][frame] = ZSTD_createDCtx();
+			CHECK_ALLOC_NOCLEAN(input->frameDCtx[port][frame], -1);
+		}
+	}
+
+	VERBOSE(printf("ZSTD Read%hhd: decompressing %d frames (%ld -> %ld bytes) in parallel\n", port, numFrames, compressedOffset - (int64_t) input->readingTracker[port].pos, decompressedOffset));
+
+	if (omp_in_parallel()) {
+		// Called from the reader's per-port loop, share the frames with the rest of the team
+		#pragma omp taskloop default(shared) grainsize(1)
+		for (int32_t frame = 0; frame < numFrames; frame++) {
+			frameReturn[frame] = _lofar_udp_io_read_ZSTD_decompress_frame(input->frameDCtx[port][frame], &(outputData[frameOutputOffset[frame]]), frameOutputSize[frame],
+			                                                              &(compressedData[frameInputOffset[frame]]), frameInputSize[frame], &(frameFilter[frame]), &(filterReturn[frame]));
+		}
+	} else {
+		#pragma omp parallel for default(shared)
+		for (int32_t frame = 0; frame < numFrames; frame++) {
+			frameReturn[frame] = _lofar_udp_io_read_ZSTD_decompress_frame(input->frameDCtx[port][frame], &(outputData[frameOutputOffset[frame]]), frameOutputSize[frame],
+			                                                              &(compressedData[frameInputOffset[frame]]), frameInputSize[frame], &(frameFilter[frame]), &(filterReturn[frame]));
+		}
+	}
+
+	for (int32_t frame = 0; frame < numFrames; frame++) {
+		if (ZSTD_isError(frameReturn[frame]) || (int64_t) frameReturn[frame] != frameOutputSize[frame] || filterReturn[frame] < 0) {
+			fprintf(stderr, "ZSTD encountered an error decompressing frame at offset %ld on port %d (%s), exiting data read early.\n",
+			        frameInputOffset[frame], port, ZSTD_isError(frameReturn[frame]) ? ZSTD_getErrorName(frameReturn[frame]) : (filterReturn[frame] < 0 ? "failed to revert filter" : "unexpected frame length"));
+			return -1;
+		}
+		// Filtered frames must be re-entered through their description
+		_lofar_udp_io_read_ZSTD_add_anchor(input, port, frameAnchor[frame], streamOffset + frameOutputOffset[frame]);
+	}
+
+	input->readingTracker[port].pos = compressedOffset;
+	input->decompressionTracker[port].pos += decompressedOffset;
+
+	return decompressedOffset;
+}
+
 /**
  * @brief      Perform a data read for a normal file
  *
@@ -117,15 +496,24 @@ int64_t _lofar_udp_io_read_ZSTD(lofar_udp_io_read_config *const input, int8_t po
 
 	if (input->readerType == ZSTDCOMPRESSED) {
 		dest = targetArray;
-		int64_t ptrByteDifference = targetArray - (int8_t *) input->decompressionTracker[port].dst;
-		if (ptrByteDifference < 0 || ptrByteDifference > (int64_t) input->decompressionTracker[port].size) {
-			fprintf(stderr, "ERROR %s: Passed buffer is not within pre-set buffer range (delta %ld), exiting.\n", __func__, ptrByteDifference);
-			return -1;
+		if (input->inputRing[port] != NULL) {
+			// Mirrored ring: decompress directly into the target, where the leftover data from the last read normally already is
+			if (_lofar_udp_io_read_ZSTD_ring_rebase(input, port, targetArray, dataRead, nchars) < 0) {
+				return -1;
+			}
+			dest = input->decompressionTracker[port].dst;
+		} else {
+			int64_t ptrByteDifference = targetArray - (int8_t *) input->decompressionTracker[port].dst;
+			if (ptrByteDifference < 0 || ptrByteDifference > (int64_t) input->decompressionTracker[port].size) {
+				fprintf(stderr, "ERROR %s: Passed buffer is not within pre-set buffer range (delta %ld), exiting.\n", __func__, ptrByteDifference);
+				return -1;
+			}
 		}
 	}
 
 	// memmove as we can't use memcpy for the ZSTANDARD moe due to potential overlapping buffer components
-	if (memmove(dest, &(((int8_t *) input->decompressionTracker[port].dst)[input->zstdLastRead[port]]), dataRead) != dest) {
+	int8_t *leftover = &(((int8_t *) input->decompressionTracker[port].dst)[input->zstdLastRead[port]]);
+	if (leftover != dest && memmove(dest, leftover, dataRead) != dest) {
 		fprintf(stderr, "ERROR: Failed to copy end of ZSTD buffer, exiting.\n");
 		return -1;
 	}
@@ -145,7 +533,44 @@ int64_t _lofar_udp_io_read_ZSTD(lofar_udp_io_read_config *const input, int8_t po
 	VERBOSE(printf("ZSTD Read%hhd: starting loop with %ld/%ld\n", port, dataRead, nchars));
 
 	// Loop across while decompressing the data (zstd decompressed in frame iterations, so it may take a few iterations)
-	while (input->readingTracker[port].pos < input->readingTracker[port].size && dataRead < nchars) {
+	// In follow mode, reaching the end of the compressed data waits for the writer to append more before continuing
+	// Data from filtered frames are only returned once their block has been restored, the rest is held as pending data
+	lofar_udp_io_zstd_filter *filter = &(input->zstdFilter[port]);
+	int8_t readFailed = 0;
+	while ((dataRead - filter->pending) < nchars && !readFailed && (input->readingTracker[port].pos < input->readingTracker[port].size || _lofar_udp_io_read_follow_ZSTD(input, port) > 0)) {
+		// Between frames, decompress as many independent frames as possible in parallel, falling back to the stream otherwise
+		// Frame starts are remembered in terms of the stream offset, which only advances once the data are returned
+		if (input->zstdFrameBoundary[port]) {
+			const int64_t framesRead = _lofar_udp_io_read_ZSTD_frames(input, port, nchars - dataRead, input->streamOffset[port] + dataRead);
+			if (framesRead < 0) {
+				readFailed = 1;
+				break;
+			} else if (framesRead > 0) {
+				dataRead += framesRead;
+				continue;
+			}
+
+			const int64_t frameStart = (int64_t) input->readingTracker[port].pos;
+			const int64_t headerLength = _lofar_udp_io_ZSTD_filter_parse(&(((const int8_t *) input->readingTracker[port].src)[frameStart]), (int64_t) input->readingTracker[port].size - frameStart, filter);
+			if (headerLength < -1) {
+				readFailed = 1;
+				break;
+			} else if (headerLength == -1) {
+				// The description has not been fully written yet
+				if (_lofar_udp_io_read_follow_ZSTD(input, port) > 0) {
+					continue;
+				}
+				break;
+			}
+			_lofar_udp_io_read_ZSTD_add_anchor(input, port, frameStart, input->streamOffset[port] + dataRead);
+			if (headerLength > 0) {
+				filter->headerOffset = frameStart;
+				input->readingTracker[port].pos += headerLength;
+				input->zstdFrameBoundary[port] = 0;
+				continue;
+			}
+		}
+
 		previousDecompressionPos = input->decompressionTracker[port].pos;
 		// zstd streaming decompression + check for errors
 		returnVal = ZSTD_decompressStream(input->dstream[port], &(input->decompressionTracker[port]),
@@ -153,16 +578,25 @@ int64_t _lofar_udp_io_read_ZSTD(lofar_udp_io_read_config *const input, int8_t po
 		if (ZSTD_isError(returnVal)) {
 			fprintf(stderr, "ZSTD encountered an error decompressing a frame (code %ld, %s), exiting data read early.\n",
 			        returnVal, ZSTD_getErrorName(returnVal));
+			readFailed = 1;
 			break;
 		}
+		// The stream only returns 0 once a frame has been fully decoded and flushed
+		input->zstdFrameBoundary[port] = (returnVal == 0);
 
 		// Determine how much data we just added to the buffer
 		byteDelta = ((int64_t) input->decompressionTracker[port].pos - (int64_t) previousDecompressionPos);
 
+		// Revert the filter on any blocks that are now complete
+		if (filter->filter != ZSTD_FILTER_NONE && _lofar_udp_io_ZSTD_filter_restore(filter, &(((int8_t *) input->decompressionTracker[port].dst)[input->decompressionTracker[port].pos]), byteDelta, input->zstdFrameBoundary[port]) < 0) {
+			readFailed = 1;
+			break;
+		}
+
 		// Update the total data read + check if we have reached our goal
 		dataRead += byteDelta;
 
-		if (dataRead >= nchars) {
+		if ((dataRead - filter->pending) >= nchars) {
 			break;
 		}
 
@@ -178,26 +612,20 @@ int64_t _lofar_udp_io_read_ZSTD(lofar_udp_io_read_config *const input, int8_t po
 		printf("Reader terminating %hhd: %ld read, %ld requested, overflow %ld\n", port, dataRead, nchars, dataRead - nchars);
 	);
 
+	// Pending filtered data stay in the buffer with the rest of the overflow
+	dataRead -= filter->pending;
 	if (nchars > dataRead) {
 		nchars = dataRead;
 	}
 
-	// Completed or EOF: unmap used memory and return everything we read
-	// TODO: MADV_DONTNEED causes significant slow down for multi-hour observations, test performance of MADV_FREE
-	// TODO Might this be because we're applying to the full range, rather than just the block we just read?
-	// TODO: Commenting out this entire block, the memory is marked as sequential, so    in theory this is not required at all
-	//if (madvise(((void *) input->readingTracker[port].src), input->readingTracker[port].pos, MADV_DONTNEED) < 0) {
-	/*
-	if (madvise(((void *) input->readingTracker[port].src), input->readingTracker[port].pos, MADV_FREE) < 0) {
-		fprintf(stderr,
-		        "ERROR: Failed to apply MADV_DONTNEED after read operation on port %d (errno %d: %s).\n", port,
-		        errno, strerror(errno));
-	}
-	 */
+	// Completed or EOF: release the compressed data behind the read head and request the data ahead of it.
+	// Releasing the full range behind the head on every read made long observations progressively slower, so this
+	// only acts on whole blocks that have not been released yet.
+	_lofar_udp_io_read_advise_FILE(input, port, (void *) input->readingTracker[port].src, (int64_t) input->readingTracker[port].pos);
 	input->zstdLastRead[port] = (dest - (int8_t*) input->decompressionTracker[port].dst) + nchars;
 
 	// Copy data for the indirect reader
-	if (input->readerType == ZSTDCOMPRESSED_INDIRECT) {
+	if (input->readerType == ZSTDCOMPRESSED_INDIRECT && targetArray != input->decompressionTracker[port].dst) {
 		if (memcpy(targetArray, input->decompressionTracker[port].dst, nchars) != targetArray) {
 			fprintf(stderr, "ERROR: Failed to copy ZSTD decompress output to array, exiting.\n");
 			return -1;
@@ -212,6 +640,116 @@ int64_t _lofar_udp_io_read_ZSTD(lofar_udp_io_read_config *const input, int8_t po
 	return dataRead;
 }
 
+/**
+ * @brief      Follow mode: wait for more compressed data to be appended to the input, and extend the mapping over it
+ *
+ * @param      input  The input
+ * @param[in]  port   The index offset from the base file
+ *
+ * @return     1: More data are available, 0: No new data before the follow timeout (or follow mode is disabled), <0: Failure
+ */
+int32_t _lofar_udp_io_read_follow_ZSTD(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input->followTimeout <= 0.0f) {
+		return 0;
+	}
+
+	const int64_t fileSize = _lofar_udp_io_read_follow_FILE(input, port, (int64_t) input->readingTracker[port].size);
+	if (fileSize <= 0) {
+		return fileSize < 0 ? -1 : 0;
+	}
+
+	void *mapping = mremap((void *) input->readingTracker[port].src, input->readingTracker[port].size, fileSize, MREMAP_MAYMOVE);
+	if (mapping == MAP_FAILED) {
+		fprintf(stderr, "ERROR %s: Failed to extend memory mapping for file on port %d. Errno: %d (%s). Exiting.\n", __func__, port,
+		        errno, strerror(errno));
+		return -1;
+	}
+	VERBOSE(printf("%s: Port %d input grew from %ld to %ld bytes\n", __func__, port, input->readingTracker[port].size, fileSize));
+
+	input->readingTracker[port].src = mapping;
+	input->readingTracker[port].size = fileSize;
+	if (madvise(mapping, fileSize, MADV_SEQUENTIAL) == -1) {
+		fprintf(stderr, "WARNING: Failed to advise the kernel on mmap read strategy on port %d (errno %d: %s), continuing.\n", port, errno, strerror(errno));
+	}
+
+	return 1;
+}
+
+/**
+ * @brief      Seek a zstandard stream to the start of a frame, then discard data until the target offset is reached
+ *
+ * @param      input         The input
+ * @param[in]  port          The index offset from the base file
+ * @param[in]  frameOffset   The compressed offset of the target frame
+ * @param[in]  discardBytes  The number of decompressed bytes to skip after the start of the frame
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_seek_ZSTD(lofar_udp_io_read_config *const input, const int8_t port, const int64_t frameOffset, int64_t discardBytes) {
+	if (input->dstream[port] == NULL || input->decompressionTracker[port].dst == NULL) {
+		fprintf(stderr, "ERROR %s: ZSTD reader on port %d has not been initialised, exiting.\n", __func__, port);
+		return -1;
+	}
+
+	if (frameOffset < 0 || frameOffset >= (int64_t) input->readingTracker[port].size || discardBytes < 0) {
+		fprintf(stderr, "ERROR %s: Invalid seek target on port %d (frame %ld, discard %ld), exiting.\n", __func__, port, frameOffset, discardBytes);
+		return -1;
+	}
+
+	// Drop any partially decoded frame and leftover data, then restart at the requested frame
+	size_t returnVal = ZSTD_DCtx_reset(input->dstream[port], ZSTD_reset_session_only);
+	if (ZSTD_isError(returnVal)) {
+		fprintf(stderr, "ERROR %s: Failed to reset decompression stream on port %d (%s), exiting.\n", __func__, port, ZSTD_getErrorName(returnVal));
+		return -1;
+	}
+	input->readingTracker[port].pos = frameOffset;
+	_lofar_udp_io_read_advise_reset_FILE(input, port, frameOffset);
+	input->decompressionTracker[port].pos = 0;
+	input->zstdLastRead[port] = 0;
+	input->zstdFrameBoundary[port] = 1;
+	// Frames are always entered at their start (or their filter description), which sets the filter again
+	input->zstdFilter[port].filter = ZSTD_FILTER_NONE;
+	input->zstdFilter[port].remaining = 0;
+	input->zstdFilter[port].pending = 0;
+
+	// Decompress until we reach the target packet; any overflow is kept for the next read
+	while (discardBytes > 0) {
+		const int64_t readSize = discardBytes < input->readBufSize[port] ? discardBytes : input->readBufSize[port];
+		const int64_t readlen = _lofar_udp_io_read_ZSTD(input, port, input->decompressionTracker[port].dst, readSize);
+		if (readlen < readSize) {
+			fprintf(stderr, "ERROR %s: Reached end of input while seeking on port %d (%ld bytes remaining), exiting.\n", __func__, port, discardBytes - (readlen > 0 ? readlen : 0));
+			return -1;
+		}
+		discardBytes -= readlen;
+		input->streamOffset[port] += readlen;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Remember the start of a frame, so that a checkpoint can later seek the input back to it
+ *
+ * @param      input            The input
+ * @param[in]  port             The index offset from the base file
+ * @param[in]  frameOffset      The compressed offset of the frame
+ * @param[in]  frameDataOffset  The decompressed stream offset of the first byte of the frame
+ */
+void _lofar_udp_io_read_ZSTD_add_anchor(lofar_udp_io_read_config *const input, const int8_t port, const int64_t frameOffset, const int64_t frameDataOffset) {
+	// The stream path can revisit a boundary without making progress, only keep each frame once
+	if (input->zstdAnchorCount[port] > 0) {
+		const lofar_udp_io_zstd_anchor *previous = &(input->zstdAnchors[port][(input->zstdAnchorCount[port] - 1) % ZSTD_CHECKPOINT_ANCHORS]);
+		if (previous->frameOffset == frameOffset) {
+			return;
+		}
+	}
+
+	lofar_udp_io_zstd_anchor *anchor = &(input->zstdAnchors[port][input->zstdAnchorCount[port] % ZSTD_CHECKPOINT_ANCHORS]);
+	anchor->frameOffset = frameOffset;
+	anchor->frameDataOffset = frameDataOffset;
+	input->zstdAnchorCount[port]++;
+}
+
 /**
  * @brief      Cleanup zstandard compressed file references for the read I/O struct
  *
@@ -232,6 +770,16 @@ void _lofar_udp_io_read_cleanup_ZSTD(lofar_udp_io_read_config *const input, cons
 		munmap((void*) input->readingTracker[port].src, input->readingTracker[port].size);
 	}
 
+	for (int32_t frame = 0; frame < ZSTD_PARALLEL_FRAMES; frame++) {
+		if (input->frameDCtx[port][frame] != NULL) {
+			ZSTD_freeDCtx(input->frameDCtx[port][frame]);
+			input->frameDCtx[port][frame] = NULL;
+		}
+	}
+	input->zstdFrameBoundary[port] = 0;
+	FREE_NOT_NULL(input->zstdFilter[port].scratch);
+	input->zstdFilter[port] = (lofar_udp_io_zstd_filter) { ZSTD_FILTER_NONE, 0, 0, 0, 0, 0, NULL };
+
 	// Cleanup the input file references
 	_lofar_udp_io_read_cleanup_FILE(input, port);
 
@@ -302,6 +850,18 @@ int64_t _lofar_udp_io_read_temp_ZSTD(void *outbuf, const int64_t size, const int
 
 	fclose(inputFilePtr);
 
+	// Skip the description of a filtered frame, the filter is reverted after decompression
+	lofar_udp_io_zstd_filter filter = { ZSTD_FILTER_NONE, 0, 0, 0, 0, 0, NULL };
+	const int64_t headerLength = _lofar_udp_io_ZSTD_filter_parse(inBuff, readlen, &filter);
+	if (headerLength < -1) {
+		ZSTD_freeDStream(dstreamTmp);
+		FREE_NOT_NULL(inBuff);
+		FREE_NOT_NULL(localOutBuff);
+		return -1;
+	} else if (headerLength > 0) {
+		tmpRead.pos = headerLength;
+	}
+
 	// Decompressed the data, check for errors
 	size_t output = ZSTD_decompressStream(dstreamTmp, &tmpDecom, &tmpRead);
 
@@ -316,8 +876,19 @@ int64_t _lofar_udp_io_read_temp_ZSTD(void *outbuf, const int64_t size, const int
 		return -1;
 	}
 
-	// Cap the return value of the data
-	readlen = (int64_t) tmpDecom.pos;
+	if (filter.filter != ZSTD_FILTER_NONE) {
+		const int32_t filterReturn = _lofar_udp_io_ZSTD_filter_restore(&filter, &(localOutBuff[tmpDecom.pos]), (int64_t) tmpDecom.pos, output == 0);
+		FREE_NOT_NULL(filter.scratch);
+		if (filterReturn < 0) {
+			ZSTD_freeDStream(dstreamTmp);
+			FREE_NOT_NULL(inBuff);
+			FREE_NOT_NULL(localOutBuff);
+			return -1;
+		}
+	}
+
+	// Cap the return value of the data, data still waiting for the rest of their filter block are not returned
+	readlen = (int64_t) tmpDecom.pos - filter.pending;
 	if (readlen > (int64_t) size * num) { readlen = size * num; }
 
 	// Copy the output and cleanup
@@ -335,6 +906,20 @@ int64_t _lofar_udp_io_read_temp_ZSTD(void *outbuf, const int64_t size, const int
 
 //Write Interface
 
+/**
+ * @brief      Get the number of bytes filtered at once for an output, a whole number of filter blocks
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ *
+ * @return     The chunk size in bytes
+ */
+static int64_t _lofar_udp_io_write_ZSTD_filter_chunk(const lofar_udp_io_write_config *const config, const int8_t outp) {
+	const int64_t blockSize = _lofar_udp_io_ZSTD_filter_block_size(config->zstdConfig.filterElementSize);
+	const int64_t bufferSize = (int64_t) config->zstdWriter[outp].compressionBuffer.size;
+	return bufferSize < blockSize ? blockSize : bufferSize - (bufferSize % blockSize);
+}
+
 /**
  * @brief      Setup the write I/O struct to handle normal data
  *
@@ -408,13 +993,138 @@ int32_t _lofar_udp_io_write_setup_ZSTD(lofar_udp_io_write_config *const config,
 		return -1;
 	}
 
+	if (config->zstdConfig.adaptive) {
+		if (config->zstdConfig.minLevel < 1 || config->zstdConfig.maxLevel > ZSTD_ADAPT_MAX_LEVEL || config->zstdConfig.maxLevel > ZSTD_maxCLevel() || config->zstdConfig.minLevel > config->zstdConfig.maxLevel || config->zstdConfig.frameSize < 1) {
+			fprintf(stderr, "ERROR: Invalid adaptive compression configuration (levels %d to %d, %ld byte frames), exiting.\n", config->zstdConfig.minLevel, config->zstdConfig.maxLevel, config->zstdConfig.frameSize);
+			return -1;
+		}
+
+		// Start from the configured level, then keep the adapted level across new files for split outputs
+		if (config->zstdWriter[outp].level == 0) {
+			config->zstdWriter[outp].level = config->zstdConfig.compressionLevel;
+		}
+		config->zstdWriter[outp].level = config->zstdWriter[outp].level < config->zstdConfig.minLevel ? config->zstdConfig.minLevel : config->zstdWriter[outp].level;
+		config->zstdWriter[outp].level = config->zstdWriter[outp].level > config->zstdConfig.maxLevel ? config->zstdConfig.maxLevel : config->zstdWriter[outp].level;
+		if (ZSTD_isError(ZSTD_CCtx_setParameter(config->zstdWriter[outp].cstream, ZSTD_c_compressionLevel, config->zstdWriter[outp].level))) {
+			fprintf(stderr, "ERROR: Failed to set compression level %d on output %d, exiting.\n", config->zstdWriter[outp].level, outp);
+			return -1;
+		}
+
+		config->zstdWriter[outp].frameBytes = 0;
+		config->zstdWriter[outp].frameBusy = 0.0;
+		CLICK(config->zstdWriter[outp].frameStart);
+	}
+
+	if (config->zstdConfig.filter != ZSTD_FILTER_NONE) {
+		const int32_t elementSize = config->zstdConfig.filterElementSize;
+		if ((config->zstdConfig.filter != ZSTD_FILTER_BYTESHUFFLE && config->zstdConfig.filter != ZSTD_FILTER_BITSHUFFLE) || elementSize < 1 || 8 * elementSize > ZSTD_FILTER_BLOCK_SIZE) {
+			fprintf(stderr, "ERROR: Invalid zstandard filter configuration (filter %d, %d byte elements), exiting.\n", config->zstdConfig.filter, elementSize);
+			return -1;
+		}
+
+		// Every filtered write is described as its own frame, so frames cannot be extended to frameSize to adapt the level between them
+		if (config->zstdConfig.adaptive) {
+			fprintf(stderr, "ERROR: Adaptive compression levels cannot be combined with a zstandard filter (every filtered write ends its frame), exiting.\n");
+			return -1;
+		}
+
+		if (config->zstdWriter[outp].filterBuffer == NULL) {
+			config->zstdWriter[outp].filterBuffer = calloc(_lofar_udp_io_write_ZSTD_filter_chunk(config, outp), sizeof(int8_t));
+			if (config->zstdWriter[outp].filterBuffer == NULL) {
+				fprintf(stderr, "ERROR: Failed to allocate memory for zstandard filter on output %d, exiting.\n", outp);
+				return -1;
+			}
+		}
+	}
+
 	return 0;
 }
 
+/**
+ * @brief      Pass data through an output's compression stream, writing the compressed data to disk whenever the compression buffer
+ * 				fills. ZSTD_e_continue returns once the input is consumed, ZSTD_e_flush / ZSTD_e_end once the stream is drained.
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ * @param      input   The input data
+ * @param[in]  mode    The zstandard end directive
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_write_ZSTD_stream(lofar_udp_io_write_config *const config, const int8_t outp, ZSTD_inBuffer *input, const ZSTD_EndDirective mode) {
+	ZSTD_outBuffer output = { config->zstdWriter[outp].compressionBuffer.dst, config->zstdWriter[outp].compressionBuffer.size, 0 };
+
+	while (1) {
+		const size_t returnVal = ZSTD_compressStream2(config->zstdWriter[outp].cstream, &output, input, mode);
+		if (ZSTD_isError(returnVal)) {
+			fprintf(stderr, "ERROR: Failed to compress data with ZSTD (%ld, %s)\n", returnVal, ZSTD_getErrorName(returnVal));
+			return -1;
+		}
 
+		const int8_t finished = (mode == ZSTD_e_continue) ? (input->pos == input->size) : (returnVal == 0);
+		if (output.pos == output.size || (finished && output.pos > 0)) {
+			if (_lofar_udp_io_write_FILE(config, outp, output.dst, (int64_t) output.pos) < 0) {
+				return -1;
+			}
+			output.pos = 0;
+		}
+
+		if (finished) {
+			return 0;
+		}
+	}
+}
 
 /**
- * @brief      Perform a data write for a zstdcompressed file
+ * @brief      End an adaptive output's current frame, then move the compression level for the next frame towards what the output can
+ * 				sustain: down a level if compression took most of the time since the previous frame ended or the output has writes
+ * 				queued behind it, up a level if it was mostly idle.
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_io_write_ZSTD_end_frame(lofar_udp_io_write_config *const config, const int8_t outp) {
+	struct timespec tick, tock;
+	ZSTD_inBuffer input = { NULL, 0, 0 };
+
+	CLICK(tick);
+	if (_lofar_udp_io_write_ZSTD_stream(config, outp, &input, ZSTD_e_end) < 0) {
+		return -1;
+	}
+	CLICK(tock);
+
+	const double busy = config->zstdWriter[outp].frameBusy + TICKTOCK(tick, tock);
+	const double elapsed = TICKTOCK(config->zstdWriter[outp].frameStart, tock);
+	int32_t level = config->zstdWriter[outp].level;
+	if (_lofar_udp_io_write_async_pending(config, outp) > 0 || busy > ZSTD_ADAPT_BUSY_HIGH * elapsed) {
+		level = level > config->zstdConfig.minLevel ? level - 1 : level;
+	} else if (busy < ZSTD_ADAPT_BUSY_LOW * elapsed) {
+		level = level < config->zstdConfig.maxLevel ? level + 1 : level;
+	}
+
+	if (level != config->zstdWriter[outp].level) {
+		if (ZSTD_isError(ZSTD_CCtx_setParameter(config->zstdWriter[outp].cstream, ZSTD_c_compressionLevel, level))) {
+			fprintf(stderr, "ERROR: Failed to change compression level to %d on output %d, exiting.\n", level, outp);
+			return -1;
+		}
+		VERBOSE(printf("%s: Output %d compression level %d -> %d (%.02lf of %.02lf seconds compressing)\n", __func__, outp, config->zstdWriter[outp].level, level, busy, elapsed));
+		config->zstdWriter[outp].level = level;
+	}
+
+	config->zstdWriter[outp].frames++;
+	config->zstdWriter[outp].frameBytes = 0;
+	config->zstdWriter[outp].frameBusy = 0.0;
+	config->zstdWriter[outp].frameStart = tock;
+
+	return 0;
+}
+
+
+
+/**
+ * @brief      Write data through an output's filter as a single frame, preceded by the filter's description
  *
  * @param[in]  config  The configuration
  * @param[in]  outp    The outp
@@ -423,35 +1133,117 @@ int32_t _lofar_udp_io_write_setup_ZSTD(lofar_udp_io_write_config *const config,
  *
  * @return  >=0: Number of bytes written, <0: Failure
  */
-int64_t
-_lofar_udp_io_write_ZSTD(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
+static int64_t _lofar_udp_io_write_ZSTD_filtered(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
+	const int32_t elementSize = config->zstdConfig.filterElementSize;
+	const int64_t blockSize = _lofar_udp_io_ZSTD_filter_block_size(elementSize);
+	const int64_t chunkSize = _lofar_udp_io_write_ZSTD_filter_chunk(config, outp);
+	int8_t *filtered = config->zstdWriter[outp].filterBuffer;
+
+	uint8_t header[ZSTD_FILTER_HEADER_SIZE];
+	_lofar_udp_io_ZSTD_filter_header(header, config->zstdConfig.filter, elementSize, blockSize, nchars);
+	if (_lofar_udp_io_write_FILE(config, outp, (const int8_t *) header, ZSTD_FILTER_HEADER_SIZE) < 0) {
+		return -1;
+	}
 
-	ZSTD_inBuffer input = { src, nchars, 0 };
-	ZSTD_outBuffer output = { config->zstdWriter[outp].compressionBuffer.dst, config->zstdWriter[outp].compressionBuffer.size, 0 };
-	// Write the block of data
-	size_t returnVal;
-	while (!(input.size == input.pos)) {
-		while((returnVal = ZSTD_compressStream2(config->zstdWriter[outp].cstream, &output, &input, ZSTD_e_continue))) {
-			if (ZSTD_isError(returnVal)) {
-				fprintf(stderr, "ERROR: Failed to compressed data with ZSTD (%ld, %s)\n", returnVal,
-				        ZSTD_getErrorName(returnVal));
+	// Record the length in the frame, so that readers can decompress frames in parallel
+	const size_t returnVal = ZSTD_CCtx_setPledgedSrcSize(config->zstdWriter[outp].cstream, nchars);
+	if (ZSTD_isError(returnVal)) {
+		fprintf(stderr, "ERROR: Failed to set zstandard frame length on output %d (%s), exiting.\n", outp, ZSTD_getErrorName(returnVal));
+		return -1;
+	}
+
+	for (int64_t offset = 0; offset < nchars; offset += chunkSize) {
+		const int64_t chunkLength = (nchars - offset) < chunkSize ? (nchars - offset) : chunkSize;
+		for (int64_t block = 0; block < chunkLength; block += blockSize) {
+			const int64_t blockLength = (chunkLength - block) < blockSize ? (chunkLength - block) : blockSize;
+			if (_lofar_udp_io_ZSTD_filter_block(config->zstdConfig.filter, elementSize, &(src[offset + block]), &(filtered[block]), blockLength, 0) < 0) {
 				return -1;
 			}
 		}
+
+		ZSTD_inBuffer input = { filtered, chunkLength, 0 };
+		if (_lofar_udp_io_write_ZSTD_stream(config, outp, &input, ZSTD_e_continue) < 0) {
+			return -1;
+		}
 	}
 
-	// Flush the frame
-	while((returnVal = ZSTD_compressStream2(config->zstdWriter[outp].cstream, &output, &input, ZSTD_e_flush))) {
-		if (ZSTD_isError(returnVal)) {
-			fprintf(stderr, "ERROR: Failed to finish frame for ZSTD (%ld, %s)\n", returnVal,
-			        ZSTD_getErrorName(returnVal));
+	// The description covers exactly one frame, so every filtered write ends its frame
+	ZSTD_inBuffer input = { NULL, 0, 0 };
+	if (_lofar_udp_io_write_ZSTD_stream(config, outp, &input, ZSTD_e_end) < 0) {
+		return -1;
+	}
+
+	return nchars;
+}
+
+/**
+ * @brief      Perform a data write for a zstdcompressed file
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ * @param[in]  src     The source
+ * @param[in]  nchars  The nchars
+ *
+ * @return  >=0: Number of bytes written, <0: Failure
+ */
+int64_t
+_lofar_udp_io_write_ZSTD(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
+
+	if (config->zstdConfig.filter != ZSTD_FILTER_NONE) {
+		return _lofar_udp_io_write_ZSTD_filtered(config, outp, src, nchars);
+	}
+
+	ZSTD_inBuffer input = { src, nchars, 0 };
+
+	// Fixed levels flush every write, so readers always have the complete output
+	if (!config->zstdConfig.adaptive) {
+		if (_lofar_udp_io_write_ZSTD_stream(config, outp, &input, ZSTD_e_continue) < 0 || _lofar_udp_io_write_ZSTD_stream(config, outp, &input, ZSTD_e_flush) < 0) {
 			return -1;
 		}
+		return nchars;
 	}
 
-	config->zstdWriter[outp].compressionBuffer.pos = output.pos;
+	// Adaptive levels keep the frame open until it holds frameSize bytes, the level can only be changed between frames
+	struct timespec tick, tock;
+	CLICK(tick);
+	if (_lofar_udp_io_write_ZSTD_stream(config, outp, &input, ZSTD_e_continue) < 0) {
+		return -1;
+	}
+	CLICK(tock);
+	config->zstdWriter[outp].frameBusy += TICKTOCK(tick, tock);
+	config->zstdWriter[outp].frameBytes += nchars;
+	config->zstdWriter[outp].levelBytes[config->zstdWriter[outp].level] += nchars;
 
-	if (_lofar_udp_io_write_FILE(config, outp, config->zstdWriter[outp].compressionBuffer.dst, (int64_t) output.pos) < 0) {
+	if (config->zstdWriter[outp].frameBytes >= config->zstdConfig.frameSize && _lofar_udp_io_write_ZSTD_end_frame(config, outp) < 0) {
+		return -1;
+	}
+
+	return nchars;
+}
+
+/**
+ * @brief      Write metadata to a zstdcompressed file. Filtered outputs write the metadata as its own, unfiltered, frame.
+ *
+ * @param[in]  config  The configuration
+ * @param[in]  outp    The outp
+ * @param[in]  src     The metadata
+ * @param[in]  nchars  The metadata length
+ *
+ * @return  >=0: Number of bytes written, <0: Failure
+ */
+int64_t _lofar_udp_io_write_metadata_ZSTD(lofar_udp_io_write_config *const config, const int8_t outp, const int8_t *src, const int64_t nchars) {
+	if (config->zstdConfig.filter == ZSTD_FILTER_NONE) {
+		return _lofar_udp_io_write_ZSTD(config, outp, src, nchars);
+	}
+
+	// Filtered writes always end their frame, so the metadata start a new frame
+	ZSTD_inBuffer input = { src, nchars, 0 };
+	const size_t returnVal = ZSTD_CCtx_setPledgedSrcSize(config->zstdWriter[outp].cstream, nchars);
+	if (ZSTD_isError(returnVal)) {
+		fprintf(stderr, "ERROR: Failed to set zstandard frame length on output %d (%s), exiting.\n", outp, ZSTD_getErrorName(returnVal));
+		return -1;
+	}
+	if (_lofar_udp_io_write_ZSTD_stream(config, outp, &input, ZSTD_e_continue) < 0 || _lofar_udp_io_write_ZSTD_stream(config, outp, &input, ZSTD_e_end) < 0) {
 		return -1;
 	}
 
@@ -470,6 +1262,13 @@ void _lofar_udp_io_write_cleanup_ZSTD(lofar_udp_io_write_config *const config, c
 		return;
 	}
 
+	// Adaptive outputs leave their frame open between writes, it must be ended before the file is closed
+	if (config->zstdConfig.adaptive && config->zstdWriter[outp].cstream != NULL && config->outputFiles[outp] != NULL && config->zstdWriter[outp].frameBytes > 0) {
+		if (_lofar_udp_io_write_ZSTD_end_frame(config, outp) < 0) {
+			fprintf(stderr, "WARNING %s: Failed to end the final frame on output %d, the output may be truncated.\n", __func__, outp);
+		}
+	}
+
 	// Cleanup output file references
 	_lofar_udp_io_write_cleanup_FILE(config, outp);
 
@@ -482,6 +1281,9 @@ void _lofar_udp_io_write_cleanup_ZSTD(lofar_udp_io_write_config *const config, c
 			FREE_NOT_NULL(config->zstdWriter[outp].compressionBuffer.dst);
 		}
 	}
+	if (fullClean) {
+		FREE_NOT_NULL(config->zstdWriter[outp].filterBuffer);
+	}
 
 	// Cleanup the compression configuration
 	if (fullClean && config->cparams != NULL) {
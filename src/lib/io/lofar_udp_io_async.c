@@ -0,0 +1,454 @@
+// Background writer: data handed over through lofar_udp_io_write_async_submit() is passed to lofar_udp_io_write() on a separate
+//  thread for each output, in submission order, so that the caller can process the next gulp while the previous one drains,
+//  and a slow output (e.g. one that is being compressed) does not hold back the others.
+
+// A write waiting for (or being handled by) an output's writer thread
+typedef struct lofar_udp_io_async_job {
+	int8_t *buffer;
+	int64_t nchars;
+	lofar_udp_io_write_callback callback;
+	void *userData;
+} lofar_udp_io_async_job;
+
+// Queue, buffer pool and thread for a single output
+typedef struct lofar_udp_io_async_lane {
+	lofar_udp_io_async_writer *writer;
+	int8_t outp;
+	pthread_t thread;
+	int8_t threadStarted;
+	pthread_mutex_t lock;
+	// Signalled when a job is queued / shutdown is requested, and when a job completes
+	pthread_cond_t work;
+	pthread_cond_t done;
+
+	// Recycled output buffers
+	int8_t **buffers;
+	int8_t *bufferFree;
+
+	// Ring of queued jobs (numBuffers long), the head is only removed once its write has completed
+	lofar_udp_io_async_job *queue;
+	int32_t queueHead;
+	int32_t queueLength;
+
+	int8_t shutdown;
+} lofar_udp_io_async_lane;
+
+struct lofar_udp_io_async_writer {
+	lofar_udp_io_write_config *config;
+	int32_t numBuffers;
+	int8_t numLanes;
+	lofar_udp_io_async_lane *lanes;
+
+	// The first failure on any output, shared so that every output stops once one of them fails (atomic)
+	int32_t error;
+};
+
+
+/**
+ * @brief      Get the first failure reported by any output's writer thread
+ *
+ * @param      writer  The writer
+ *
+ * @return     0: No failures, <0: Failure
+ */
+static inline int32_t _lofar_udp_io_async_error(lofar_udp_io_async_writer *writer) {
+	return __atomic_load_n(&(writer->error), __ATOMIC_ACQUIRE);
+}
+
+/**
+ * @brief      Return a buffer to the pool if it was allocated by the writer. Must be called with the lane's lock held.
+ *
+ * @param      lane    The output's lane
+ * @param      buffer  The buffer
+ */
+static void _lofar_udp_io_async_return_buffer(lofar_udp_io_async_lane *lane, const int8_t *buffer) {
+	for (int32_t idx = 0; idx < lane->writer->numBuffers; idx++) {
+		if (lane->buffers[idx] == buffer) {
+			lane->bufferFree[idx] = 1;
+			return;
+		}
+	}
+}
+
+/**
+ * @brief      Writer thread main loop, perform an output's queued writes until shutdown is requested and the queue is empty
+ *
+ * @param      arg   The output's lane
+ *
+ * @return     NULL
+ */
+static void* _lofar_udp_io_async_loop(void *arg) {
+	lofar_udp_io_async_lane *lane = (lofar_udp_io_async_lane *) arg;
+	lofar_udp_io_async_writer *writer = lane->writer;
+
+	pthread_mutex_lock(&(lane->lock));
+	while (1) {
+		while (lane->queueLength == 0 && !lane->shutdown) {
+			pthread_cond_wait(&(lane->work), &(lane->lock));
+		}
+
+		if (lane->queueLength == 0) {
+			break;
+		}
+
+		const lofar_udp_io_async_job job = lane->queue[lane->queueHead];
+		pthread_mutex_unlock(&(lane->lock));
+
+		// Writes after a failure are dropped, the caller will be told about the failure on their next call
+		int64_t written = -1;
+		if (_lofar_udp_io_async_error(writer) == 0) {
+			written = lofar_udp_io_write(writer->config, lane->outp, job.buffer, job.nchars);
+			if (written != job.nchars) {
+				fprintf(stderr, "ERROR: Background write failed on output %d (%ld / %ld bytes written).\n", lane->outp, written, job.nchars);
+			}
+		}
+
+		if (job.callback != NULL) {
+			job.callback(writer->config, lane->outp, job.buffer, written, job.userData);
+		}
+
+		if (written != job.nchars) {
+			int32_t expected = 0;
+			__atomic_compare_exchange_n(&(writer->error), &expected, -1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+		}
+
+		pthread_mutex_lock(&(lane->lock));
+		_lofar_udp_io_async_return_buffer(lane, job.buffer);
+		lane->queueHead = (lane->queueHead + 1) % writer->numBuffers;
+		lane->queueLength--;
+		pthread_cond_broadcast(&(lane->done));
+	}
+	pthread_mutex_unlock(&(lane->lock));
+
+	return NULL;
+}
+
+/**
+ * @brief      Stop the writer threads, once they have drained their queues
+ *
+ * @param      writer  The writer
+ */
+static void _lofar_udp_io_async_stop(lofar_udp_io_async_writer *writer) {
+	if (writer->lanes == NULL) {
+		return;
+	}
+
+	for (int8_t outp = 0; outp < writer->numLanes; outp++) {
+		lofar_udp_io_async_lane *lane = &(writer->lanes[outp]);
+		if (!lane->threadStarted) {
+			continue;
+		}
+
+		pthread_mutex_lock(&(lane->lock));
+		lane->shutdown = 1;
+		pthread_cond_signal(&(lane->work));
+		pthread_mutex_unlock(&(lane->lock));
+		pthread_join(lane->thread, NULL);
+
+		pthread_cond_destroy(&(lane->work));
+		pthread_cond_destroy(&(lane->done));
+		pthread_mutex_destroy(&(lane->lock));
+		lane->threadStarted = 0;
+	}
+}
+
+/**
+ * @brief      Stop the writer threads, and free a writer's allocations
+ *
+ * @param      writer  The writer
+ */
+static void _lofar_udp_io_async_free(lofar_udp_io_async_writer *writer) {
+	_lofar_udp_io_async_stop(writer);
+	if (writer->lanes != NULL) {
+		for (int8_t outp = 0; outp < writer->numLanes; outp++) {
+			lofar_udp_io_async_lane *lane = &(writer->lanes[outp]);
+			if (lane->buffers != NULL) {
+				for (int32_t idx = 0; idx < writer->numBuffers; idx++) {
+					FREE_NOT_NULL(lane->buffers[idx]);
+				}
+			}
+			FREE_NOT_NULL(lane->buffers);
+			FREE_NOT_NULL(lane->bufferFree);
+			FREE_NOT_NULL(lane->queue);
+		}
+	}
+	FREE_NOT_NULL(writer->lanes);
+	free(writer);
+}
+
+/**
+ * @brief      Start a background writer for an output configuration, with a thread and a pool of buffers for each output. The
+ * 				outputs must already be setup, as each buffer holds writeBufSize[outp] bytes.
+ *
+ * @param      config      The output configuration
+ * @param[in]  numBuffers  The number of buffers to allocate for each output
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_io_write_async_setup(lofar_udp_io_write_config *const config, const int32_t numBuffers) {
+	if (config == NULL) {
+		fprintf(stderr, "ERROR %s: passed null output configuration, exiting.\n", __func__);
+		return -1;
+	}
+
+	if (config->asyncWriter != NULL) {
+		fprintf(stderr, "ERROR %s: A background writer is already running, exiting.\n", __func__);
+		return -1;
+	}
+
+	if (numBuffers < 1 || config->numOutputs < 1 || config->numOutputs > config->allocatedOutputs) {
+		fprintf(stderr, "ERROR %s: Invalid number of buffers (%d) or outputs (%d), exiting.\n", __func__, numBuffers, config->numOutputs);
+		return -1;
+	}
+
+	for (int8_t outp = 0; outp < config->numOutputs; outp++) {
+		if (config->writeBufSize[outp] < 1) {
+			fprintf(stderr, "ERROR %s: Output %d has not been setup (write size %ld), exiting.\n", __func__, outp, config->writeBufSize[outp]);
+			return -1;
+		}
+	}
+
+	lofar_udp_io_async_writer *writer = calloc(1, sizeof(lofar_udp_io_async_writer));
+	if (writer == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to allocate background writer, exiting.\n", __func__);
+		return -1;
+	}
+	writer->config = config;
+	writer->numBuffers = numBuffers;
+	writer->lanes = calloc(config->numOutputs, sizeof(lofar_udp_io_async_lane));
+	if (writer->lanes == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to allocate background writer queues, exiting.\n", __func__);
+		_lofar_udp_io_async_free(writer);
+		return -1;
+	}
+	writer->numLanes = config->numOutputs;
+
+	for (int8_t outp = 0; outp < config->numOutputs; outp++) {
+		lofar_udp_io_async_lane *lane = &(writer->lanes[outp]);
+		lane->writer = writer;
+		lane->outp = outp;
+		lane->buffers = calloc(numBuffers, sizeof(int8_t *));
+		lane->bufferFree = calloc(numBuffers, sizeof(int8_t));
+		lane->queue = calloc(numBuffers, sizeof(lofar_udp_io_async_job));
+		if (lane->buffers == NULL || lane->bufferFree == NULL || lane->queue == NULL) {
+			fprintf(stderr, "ERROR %s: Failed to allocate background writer queue for output %d, exiting.\n", __func__, outp);
+			_lofar_udp_io_async_free(writer);
+			return -1;
+		}
+
+		for (int32_t buffer = 0; buffer < numBuffers; buffer++) {
+			lane->buffers[buffer] = calloc(config->writeBufSize[outp], sizeof(int8_t));
+			if (lane->buffers[buffer] == NULL) {
+				fprintf(stderr, "ERROR %s: Failed to allocate %ld byte buffer for output %d, exiting.\n", __func__, config->writeBufSize[outp], outp);
+				_lofar_udp_io_async_free(writer);
+				return -1;
+			}
+			lane->bufferFree[buffer] = 1;
+		}
+
+		if (pthread_mutex_init(&(lane->lock), NULL) != 0) {
+			_lofar_udp_io_async_free(writer);
+			return -1;
+		}
+		if (pthread_cond_init(&(lane->work), NULL) != 0 || pthread_cond_init(&(lane->done), NULL) != 0) {
+			pthread_mutex_destroy(&(lane->lock));
+			_lofar_udp_io_async_free(writer);
+			return -1;
+		}
+
+		if (pthread_create(&(lane->thread), NULL, _lofar_udp_io_async_loop, lane) != 0) {
+			fprintf(stderr, "ERROR %s: Failed to start background writer thread for output %d (errno %d: %s), exiting.\n", __func__, outp, errno, strerror(errno));
+			pthread_cond_destroy(&(lane->work));
+			pthread_cond_destroy(&(lane->done));
+			pthread_mutex_destroy(&(lane->lock));
+			_lofar_udp_io_async_free(writer);
+			return -1;
+		}
+		lane->threadStarted = 1;
+	}
+
+	config->asyncWriter = writer;
+	return 0;
+}
+
+/**
+ * @brief      Take a buffer from an output's pool, waiting for a queued write to complete if none are available. The buffer
+ * 				is returned to the pool once it has been submitted and written (submit 0 bytes to return it unused).
+ *
+ * @param      config  The output configuration
+ * @param[in]  outp    The output index
+ *
+ * @return     A buffer holding writeBufSize[outp] bytes, NULL: Failure
+ */
+int8_t* lofar_udp_io_write_async_buffer(lofar_udp_io_write_config *const config, const int8_t outp) {
+	if (config == NULL || config->asyncWriter == NULL || outp < 0 || outp >= config->numOutputs) {
+		fprintf(stderr, "ERROR %s: Background writer not setup, or invalid output %d, exiting.\n", __func__, outp);
+		return NULL;
+	}
+
+	lofar_udp_io_async_writer *writer = config->asyncWriter;
+	lofar_udp_io_async_lane *lane = &(writer->lanes[outp]);
+	int8_t *buffer = NULL;
+	pthread_mutex_lock(&(lane->lock));
+	while (buffer == NULL && _lofar_udp_io_async_error(writer) == 0) {
+		for (int32_t idx = 0; idx < writer->numBuffers; idx++) {
+			if (lane->bufferFree[idx]) {
+				lane->bufferFree[idx] = 0;
+				buffer = lane->buffers[idx];
+				break;
+			}
+		}
+
+		if (buffer == NULL) {
+			// Every buffer is held by the caller rather than the queue, waiting would never return
+			if (lane->queueLength == 0) {
+				fprintf(stderr, "ERROR %s: All %d buffers for output %d are in use, exiting.\n", __func__, writer->numBuffers, outp);
+				break;
+			}
+			pthread_cond_wait(&(lane->done), &(lane->lock));
+		}
+	}
+	pthread_mutex_unlock(&(lane->lock));
+
+	return buffer;
+}
+
+/**
+ * @brief      Hand a buffer over to an output's background writer. The buffer must not be modified until the callback has
+ * 				been called, or lofar_udp_io_write_async_wait() has returned; buffers from lofar_udp_io_write_async_buffer()
+ * 				are then returned to the pool. The callback is called from the output's writer thread, with the number of
+ * 				bytes written (<0 on failure).
+ *
+ * @param      config    The output configuration
+ * @param[in]  outp      The output index
+ * @param      buffer    The data to write
+ * @param[in]  nchars    The number of bytes to write
+ * @param[in]  callback  Called once the write has completed (optional)
+ * @param      userData  Passed to the callback
+ *
+ * @return     0: Success, <0: Failure (including an earlier background write failing)
+ */
+int32_t lofar_udp_io_write_async_submit(lofar_udp_io_write_config *const config, const int8_t outp, int8_t *buffer, const int64_t nchars, lofar_udp_io_write_callback callback, void *userData) {
+	if (config == NULL || config->asyncWriter == NULL || outp < 0 || outp >= config->numOutputs) {
+		fprintf(stderr, "ERROR %s: Background writer not setup, or invalid output %d, exiting.\n", __func__, outp);
+		return -1;
+	}
+
+	if (buffer == NULL || nchars < 0 || nchars > config->writeBufSize[outp]) {
+		fprintf(stderr, "ERROR %s: Invalid write of %ld bytes from %p on output %d, exiting.\n", __func__, nchars, buffer, outp);
+		return -1;
+	}
+
+	lofar_udp_io_async_writer *writer = config->asyncWriter;
+	lofar_udp_io_async_lane *lane = &(writer->lanes[outp]);
+	pthread_mutex_lock(&(lane->lock));
+	// Apply back pressure once the queue is full
+	while (lane->queueLength == writer->numBuffers && _lofar_udp_io_async_error(writer) == 0) {
+		pthread_cond_wait(&(lane->done), &(lane->lock));
+	}
+
+	const int32_t error = _lofar_udp_io_async_error(writer);
+	if (error != 0) {
+		_lofar_udp_io_async_return_buffer(lane, buffer);
+		pthread_mutex_unlock(&(lane->lock));
+		return error;
+	}
+
+	lane->queue[(lane->queueHead + lane->queueLength) % writer->numBuffers] = (lofar_udp_io_async_job) {
+		.buffer = buffer, .nchars = nchars, .callback = callback, .userData = userData
+	};
+	lane->queueLength++;
+	pthread_cond_signal(&(lane->work));
+	pthread_mutex_unlock(&(lane->lock));
+
+	return 0;
+}
+
+/**
+ * @brief      Wait for every submitted write, on every output, to complete
+ *
+ * @param      config  The output configuration
+ *
+ * @return     0: Success, <0: Failure (a background write failed)
+ */
+int32_t lofar_udp_io_write_async_wait(lofar_udp_io_write_config *const config) {
+	if (config == NULL || config->asyncWriter == NULL) {
+		fprintf(stderr, "ERROR %s: Background writer not setup, exiting.\n", __func__);
+		return -1;
+	}
+
+	lofar_udp_io_async_writer *writer = config->asyncWriter;
+	for (int8_t outp = 0; outp < writer->numLanes; outp++) {
+		lofar_udp_io_async_lane *lane = &(writer->lanes[outp]);
+		pthread_mutex_lock(&(lane->lock));
+		while (lane->queueLength != 0) {
+			pthread_cond_wait(&(lane->done), &(lane->lock));
+		}
+		pthread_mutex_unlock(&(lane->lock));
+	}
+
+	return _lofar_udp_io_async_error(writer);
+}
+
+/**
+ * @brief      Count the writes queued for an output behind the one currently being performed, a backlog means the writer is not
+ * 				keeping up with the incoming data
+ *
+ * @param      config  The output configuration
+ * @param[in]  outp    The output index
+ *
+ * @return     The number of queued writes (0 without a background writer)
+ */
+int32_t _lofar_udp_io_write_async_pending(lofar_udp_io_write_config *const config, const int8_t outp) {
+	if (config == NULL || config->asyncWriter == NULL || outp < 0 || outp >= config->asyncWriter->numLanes) {
+		return 0;
+	}
+
+	lofar_udp_io_async_lane *lane = &(config->asyncWriter->lanes[outp]);
+	pthread_mutex_lock(&(lane->lock));
+	// The head of the queue is the write in progress
+	const int32_t pending = (lane->queueLength > 1) ? lane->queueLength - 1 : 0;
+	pthread_mutex_unlock(&(lane->lock));
+
+	return pending;
+}
+
+/**
+ * @brief      Finish any submitted writes, stop the background writer threads and free their buffers
+ *
+ * @param      config  The output configuration
+ *
+ * @return     0: Success, <0: Failure (a background write failed)
+ */
+int32_t lofar_udp_io_write_async_cleanup(lofar_udp_io_write_config *const config) {
+	if (config == NULL || config->asyncWriter == NULL) {
+		return 0;
+	}
+
+	lofar_udp_io_async_writer *writer = config->asyncWriter;
+	_lofar_udp_io_async_stop(writer);
+
+	const int32_t returnVal = _lofar_udp_io_async_error(writer);
+	_lofar_udp_io_async_free(writer);
+	config->asyncWriter = NULL;
+
+	return returnVal;
+}
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
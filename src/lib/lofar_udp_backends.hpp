@@ -961,6 +961,7 @@ int32_t lofar_udp_raw_loop(lofar_udp_obs_meta *meta) {
 
 		// Reset last packet, reference data on the current port
 		lastPortPacket = meta->lastPacket;
+		const int8_t contiguousGulp = meta->gulpSummary[port].contiguous;
 		int8_t *inputPortData = meta->inputData[port];
 		O **outputData = (O **) meta->outputData;
 
@@ -997,6 +998,10 @@ int32_t lofar_udp_raw_loop(lofar_udp_obs_meta *meta) {
 								portPacketLength;    // We request at least 2 packets are malloc'd before the array head pointer, so no SEGFAULTs here
 		// -2 * PPL = 0s -1 * PPL = last processed packet -- used for calculating offset in dropped case if
 		// 	we have packet loss on the boundary.
+		// Outside of PACKET_FULL_COPY, the offset points at the packet payload rather than the header
+		if constexpr (state != PACKET_FULL_COPY) {
+			lastInputPacketOffset += UDPHDRLEN;
+		}
 		VERBOSE(if (verbose) {
 			printf("LPP: %ld, PPL: %d, LIPO: %ld\n", lastPortPacket, portPacketLength, lastInputPacketOffset);
 		});
@@ -1022,16 +1027,9 @@ int32_t lofar_udp_raw_loop(lofar_udp_obs_meta *meta) {
 					   currentPortPacket, lastPortPacket + 1);
 			});
 
-			// If we are not using packet replays, reload the lastInputPacketOffset after a dropped packet
-			if (!replayDroppedPackets) {
-				if (inputPacketOffset < 0 && iLoop > 0) {
-					if constexpr (state == PACKET_FULL_COPY) {
-						inputPacketOffset = iWork * portPacketLength;
-					} else {
-						inputPacketOffset = iWork * portPacketLength + UDPHDRLEN;
-					}
-				}
-			}
+			// Reload the inputPacketOffset after a dropped packet pointed it at the padding / replayed packet,
+			// 	it always points at the header of the next input packet, the payload offset is derived from it
+			inputPacketOffset = iWork * portPacketLength;
 
 
 			// Check for packet loss by ensuring we have sequential packet numbers
@@ -1080,7 +1078,11 @@ int32_t lofar_udp_raw_loop(lofar_udp_obs_meta *meta) {
 
 				if (replayDroppedPackets) {
 					// If we are replaying the last packet, change the array index to the last good packet index
-					inputPacketOffset = lastInputPacketOffset;
+					if constexpr (state == PACKET_FULL_COPY) {
+						inputPacketOffset = lastInputPacketOffset;
+					} else {
+						inputPacketOffset = lastInputPacketOffset - UDPHDRLEN;
+					}
 				} else {
 					// Array should be 0 padded at the start; copy data from there.
 					inputPacketOffset = -2 * portPacketLength;
@@ -1128,17 +1130,22 @@ int32_t lofar_udp_raw_loop(lofar_udp_obs_meta *meta) {
 
 				// Ensure we don't attempt to access unallocated memory
 				if (iLoop != packetsPerIteration - 1) {
-					// Speedup: add 16 to the sequence, check if accurate. Doesn't work at rollover.
-					if constexpr (state == PACKET_FULL_COPY) {
-						nextSequence = (*((uint32_t *) &(inputPortData[lastInputPacketOffset + CEP_HDR_SEQ_OFFSET]))) + UDPNTIMESLICE;
-					} else {
-						nextSequence = (*((uint32_t *) &(inputPortData[lastInputPacketOffset - (UDPHDRLEN - CEP_HDR_SEQ_OFFSET)]))) + UDPNTIMESLICE;
-					}
-
-					if (*((uint32_t *) &(inputPortData[inputPacketOffset + CEP_HDR_SEQ_OFFSET])) == nextSequence) {
+					// The header census found every packet in order, so the next packet is always the following one
+					if (contiguousGulp) {
 						currentPortPacket += 1;
 					} else {
-						currentPortPacket = lofar_udp_time_get_packet_number(&(inputPortData[inputPacketOffset]));
+						// Speedup: add 16 to the sequence, check if accurate. Doesn't work at rollover.
+						if constexpr (state == PACKET_FULL_COPY) {
+							nextSequence = (*((uint32_t *) &(inputPortData[lastInputPacketOffset + CEP_HDR_SEQ_OFFSET]))) + UDPNTIMESLICE;
+						} else {
+							nextSequence = (*((uint32_t *) &(inputPortData[lastInputPacketOffset - (UDPHDRLEN - CEP_HDR_SEQ_OFFSET)]))) + UDPNTIMESLICE;
+						}
+
+						if (*((uint32_t *) &(inputPortData[inputPacketOffset + CEP_HDR_SEQ_OFFSET])) == nextSequence) {
+							currentPortPacket += 1;
+						} else {
+							currentPortPacket = lofar_udp_time_get_packet_number(&(inputPortData[inputPacketOffset]));
+						}
 					}
 				}
 
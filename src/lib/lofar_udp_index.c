@@ -0,0 +1,591 @@
+#include "lofar_udp_index.h"
+#include "lofar_udp_reader.h"
+
+// Working state while scanning an input to build an index
+typedef struct _lofar_udp_index_scan {
+	lofar_udp_index *packetIndex;
+	int64_t entryCapacity;
+
+	// Highest packet number seen so far, used to determine packet loss
+	int64_t lastPacketNumber;
+	// Packet loss/disorder accumulated since the last entry
+	int64_t droppedAccum;
+	int64_t outOfOrderAccum;
+} _lofar_udp_index_scan;
+
+// Number of packets to read per iteration when scanning uncompressed inputs
+#define UPM_INDEX_FILE_READ_PACKETS 8192
+// Multiple of the ZSTD recommended output size to decompress per iteration
+#define UPM_INDEX_ZSTD_READ_FACTOR 64
+
+/**
+ * @brief      Determine the packet length of a stream from its first header
+ *
+ * @param[in]  header  The 16-byte CEP header
+ *
+ * @return     >0: Packet length in bytes, <0: Failure
+ */
+static int32_t _lofar_udp_index_packet_length(const int8_t header[UDPHDRLEN]) {
+	if (_lofar_udp_reader_malformed_header_checks(header) < 0) {
+		fprintf(stderr, "ERROR %s: First header of input failed checks, exiting.\n", __func__);
+		return -1;
+	}
+
+	const lofar_source_bytes *source = (const lofar_source_bytes *) &(header[CEP_HDR_SRC_OFFSET]);
+	// 4-bit: half the size per sample, 16-bit: 2x the size per sample
+	const float bitMul = 1.0f + (-0.5f * (float) (source->bitMode == 2)) + (float) (source->bitMode == 0);
+	const int32_t packetLength = UDPHDRLEN + (int32_t) ((uint8_t) header[CEP_HDR_NBEAM_OFFSET]) * ((int32_t) (bitMul * UDPNTIMESLICE * UDPNPOL));
+
+	if (packetLength > MAXPKTLEN) {
+		fprintf(stderr, "ERROR %s: Packet length %d is longer than maximum packet length %d, exiting.\n", __func__, packetLength, MAXPKTLEN);
+		return -1;
+	}
+
+	return packetLength;
+}
+
+/**
+ * @brief      Account for a single packet in the index, adding an entry every stride packets
+ *
+ * @param      scan             The scan state
+ * @param[in]  packet           The packet (header)
+ * @param[in]  byteOffset       The (decompressed) byte offset of the packet
+ * @param[in]  frameOffset      The compressed offset of the frame containing the start of the packet
+ * @param[in]  frameDataOffset  The decompressed offset of the start of that frame
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_index_process_packet(_lofar_udp_index_scan *scan, const int8_t *packet, const int64_t byteOffset,
+                                               const int64_t frameOffset, const int64_t frameDataOffset) {
+	lofar_udp_index *packetIndex = scan->packetIndex;
+	const int64_t packetNumber = lofar_udp_time_get_packet_number(packet);
+
+	if (packetIndex->totalPackets == 0) {
+		packetIndex->firstPacket = packetNumber;
+		scan->lastPacketNumber = packetNumber;
+	} else {
+		const int64_t packetDelta = packetNumber - scan->lastPacketNumber;
+		if (packetDelta > 1) {
+			scan->droppedAccum += packetDelta - 1;
+			packetIndex->totalDropped += packetDelta - 1;
+		} else if (packetDelta < 1) {
+			scan->outOfOrderAccum += 1;
+		}
+
+		if (packetNumber > scan->lastPacketNumber) {
+			scan->lastPacketNumber = packetNumber;
+		}
+	}
+
+	if (!(packetIndex->totalPackets % packetIndex->stride)) {
+		if (packetIndex->numEntries == scan->entryCapacity) {
+			const int64_t newCapacity = scan->entryCapacity > 0 ? 2 * scan->entryCapacity : 1024;
+			lofar_udp_index_entry *tmpPtr = realloc(packetIndex->entries, newCapacity * sizeof(lofar_udp_index_entry));
+			CHECK_ALLOC_NOCLEAN(tmpPtr, -1);
+			packetIndex->entries = tmpPtr;
+			scan->entryCapacity = newCapacity;
+		}
+
+		packetIndex->entries[packetIndex->numEntries] = (lofar_udp_index_entry) {
+			.packetNumber = packetNumber,
+			.byteOffset = byteOffset,
+			.frameOffset = frameOffset,
+			.frameDataOffset = frameDataOffset,
+			.droppedSinceLast = scan->droppedAccum,
+			.outOfOrderSinceLast = scan->outOfOrderAccum
+		};
+		packetIndex->numEntries++;
+		scan->droppedAccum = 0;
+		scan->outOfOrderAccum = 0;
+	}
+
+	packetIndex->lastPacket = scan->lastPacketNumber;
+	packetIndex->totalPackets++;
+
+	return 0;
+}
+
+/**
+ * @brief      Scan an uncompressed input file to build an index
+ *
+ * @param      scan           The scan state
+ * @param[in]  inputLocation  The input file location
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_index_scan_FILE(_lofar_udp_index_scan *scan, const char inputLocation[]) {
+	FILE *inputFile = fopen(inputLocation, "rb");
+	if (inputFile == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to open file at %s (errno %d: %s), exiting.\n", __func__, inputLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	scan->packetIndex->inputSize = _FILE_file_size(inputFile);
+	int8_t header[UDPHDRLEN];
+	if (scan->packetIndex->inputSize < 0 || fread(header, sizeof(int8_t), UDPHDRLEN, inputFile) != UDPHDRLEN) {
+		fprintf(stderr, "ERROR %s: Failed to read first header from %s, exiting.\n", __func__, inputLocation);
+		fclose(inputFile);
+		return -1;
+	}
+	if ((scan->packetIndex->packetLength = _lofar_udp_index_packet_length(header)) < 0 || fseek(inputFile, 0, SEEK_SET) != 0) {
+		fclose(inputFile);
+		return -1;
+	}
+
+	const int64_t packetLength = scan->packetIndex->packetLength;
+	const int64_t readSize = packetLength * UPM_INDEX_FILE_READ_PACKETS;
+	int8_t *buffer = calloc(readSize, sizeof(int8_t));
+	CHECK_ALLOC(buffer, -1, fclose(inputFile););
+
+	int64_t readlen, byteOffset = 0;
+	while ((readlen = (int64_t) fread(buffer, sizeof(int8_t), readSize, inputFile)) >= packetLength) {
+		const int64_t packets = readlen / packetLength;
+		for (int64_t packet = 0; packet < packets; packet++) {
+			if (_lofar_udp_index_process_packet(scan, &(buffer[packet * packetLength]), byteOffset + packet * packetLength, 0, 0) < 0) {
+				FREE_NOT_NULL(buffer);
+				fclose(inputFile);
+				return -1;
+			}
+		}
+		byteOffset += packets * packetLength;
+
+		if (readlen % packetLength) {
+			fprintf(stderr, "WARNING %s: Input %s ends with a partial packet (%ld bytes), ignoring it.\n", __func__, inputLocation, readlen % packetLength);
+			break;
+		}
+	}
+
+	FREE_NOT_NULL(buffer);
+	fclose(inputFile);
+	return 0;
+}
+
+/**
+ * @brief      Scan a zstandard compressed input file to build an index, noting the frame that contains each indexed packet
+ *
+ * @param      scan           The scan state
+ * @param[in]  inputLocation  The input file location
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_index_scan_ZSTD(_lofar_udp_index_scan *scan, const char inputLocation[]) {
+	FILE *inputFile = fopen(inputLocation, "rb");
+	if (inputFile == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to open file at %s (errno %d: %s), exiting.\n", __func__, inputLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	const int64_t fileSize = _FILE_file_size(inputFile);
+	scan->packetIndex->inputSize = fileSize;
+	if (fileSize < 1) {
+		fprintf(stderr, "ERROR %s: Input %s is empty or could not be inspected, exiting.\n", __func__, inputLocation);
+		fclose(inputFile);
+		return -1;
+	}
+
+	const int8_t *compressedData = mmap(NULL, fileSize, PROT_READ, MAP_PRIVATE, fileno(inputFile), 0);
+	fclose(inputFile);
+	if (compressedData == MAP_FAILED) {
+		fprintf(stderr, "ERROR %s: Failed to mmap %s (errno %d: %s), exiting.\n", __func__, inputLocation, errno, strerror(errno));
+		return -1;
+	}
+	if (madvise((void *) compressedData, fileSize, MADV_SEQUENTIAL) == -1) {
+		fprintf(stderr, "WARNING %s: Failed to advise the kernel on mmap read strategy (errno %d: %s), continuing.\n", __func__, errno, strerror(errno));
+	}
+
+	const int64_t bufferSize = UPM_INDEX_ZSTD_READ_FACTOR * (int64_t) ZSTD_DStreamOutSize();
+	int8_t *buffer = calloc(bufferSize, sizeof(int8_t));
+	ZSTD_DStream *dstream = ZSTD_createDStream();
+	// Frame start offsets (compressed, decompressed), kept so that packets straddling frames map to the frame they start in
+	int64_t numFrames = 0, frameCapacity = 0, frameCursor = 0;
+	int64_t (*frames)[2] = NULL;
+	if (buffer == NULL || dstream == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to allocate decompression buffers, exiting.\n", __func__);
+		FREE_NOT_NULL(buffer);
+		ZSTD_freeDStream(dstream);
+		munmap((void *) compressedData, fileSize);
+		return -1;
+	}
+
+	int32_t returnVal = 0;
+	int64_t compressedOffset = 0, bufferFill = 0, bufferDataOffset = 0, decompressedOffset = 0;
+	while (compressedOffset < fileSize && returnVal == 0) {
+		size_t frameSize = ZSTD_findFrameCompressedSize(&(compressedData[compressedOffset]), fileSize - compressedOffset);
+		if (ZSTD_isError(frameSize)) {
+			fprintf(stderr, "WARNING %s: Final frame of %s appears truncated (%s), indexing as much as possible.\n", __func__, inputLocation, ZSTD_getErrorName(frameSize));
+			frameSize = fileSize - compressedOffset;
+		}
+
+		if (numFrames == frameCapacity) {
+			frameCapacity = frameCapacity > 0 ? 2 * frameCapacity : 64;
+			void *tmpPtr = realloc(frames, frameCapacity * sizeof(*frames));
+			if (tmpPtr == NULL) {
+				fprintf(stderr, "ERROR %s: Failed to allocate frame table, exiting.\n", __func__);
+				returnVal = -1;
+				break;
+			}
+			frames = tmpPtr;
+		}
+		frames[numFrames][0] = compressedOffset;
+		frames[numFrames][1] = decompressedOffset;
+		numFrames++;
+
+		ZSTD_DCtx_reset(dstream, ZSTD_reset_session_only);
+		ZSTD_inBuffer readingTracker = { &(compressedData[compressedOffset]), frameSize, 0 };
+		while (readingTracker.pos < readingTracker.size) {
+			ZSTD_outBuffer decompressionTracker = { &(buffer[bufferFill]), bufferSize - bufferFill, 0 };
+			const size_t previousPos = readingTracker.pos;
+			const size_t zstdReturn = ZSTD_decompressStream(dstream, &decompressionTracker, &readingTracker);
+			if (ZSTD_isError(zstdReturn)) {
+				fprintf(stderr, "WARNING %s: ZSTD encountered an error decompressing %s (%s), stopping index early.\n", __func__, inputLocation, ZSTD_getErrorName(zstdReturn));
+				returnVal = 1;
+				break;
+			}
+			bufferFill += (int64_t) decompressionTracker.pos;
+			decompressedOffset += (int64_t) decompressionTracker.pos;
+
+			if (scan->packetIndex->packetLength < 1 && bufferFill >= UDPHDRLEN) {
+				if ((scan->packetIndex->packetLength = _lofar_udp_index_packet_length(buffer)) < 0) {
+					returnVal = -1;
+					break;
+				}
+			}
+
+			// Consume all complete packets in the buffer
+			const int64_t packetLength = scan->packetIndex->packetLength;
+			int64_t consumed = 0;
+			while (packetLength > 0 && (bufferFill - consumed) >= packetLength) {
+				const int64_t byteOffset = bufferDataOffset + consumed;
+				while ((frameCursor + 1) < numFrames && frames[frameCursor + 1][1] <= byteOffset) {
+					frameCursor++;
+				}
+				if (_lofar_udp_index_process_packet(scan, &(buffer[consumed]), byteOffset, frames[frameCursor][0], frames[frameCursor][1]) < 0) {
+					returnVal = -1;
+					break;
+				}
+				consumed += packetLength;
+			}
+			if (consumed > 0) {
+				memmove(buffer, &(buffer[consumed]), bufferFill - consumed);
+				bufferFill -= consumed;
+				bufferDataOffset += consumed;
+			}
+
+			// Frame completed, or no forward progress possible
+			if (returnVal != 0 || zstdReturn == 0 || (decompressionTracker.pos == 0 && readingTracker.pos == previousPos)) {
+				break;
+			}
+		}
+
+		compressedOffset += (int64_t) frameSize;
+	}
+
+	if (bufferFill > 0 && returnVal == 0) {
+		fprintf(stderr, "WARNING %s: Input %s ends with a partial packet (%ld bytes), ignoring it.\n", __func__, inputLocation, bufferFill);
+	}
+
+	FREE_NOT_NULL(frames);
+	FREE_NOT_NULL(buffer);
+	ZSTD_freeDStream(dstream);
+	munmap((void *) compressedData, fileSize);
+	return returnVal < 0 ? returnVal : 0;
+}
+
+/**
+ * @brief      Scan an input file and build an index of packet locations / packet loss
+ *
+ * @param[in]  inputLocation  The input file location
+ * @param[in]  readerType     The input type (NORMAL(_MMAP)/URING or ZSTDCOMPRESSED(_INDIRECT))
+ * @param[in]  stride         Number of packets between index entries (<1: use UPM_INDEX_DEFAULT_STRIDE)
+ *
+ * @return     ptr: Success, NULL: Failure
+ */
+lofar_udp_index* lofar_udp_index_generate(const char inputLocation[], reader_t readerType, int32_t stride) {
+	if (inputLocation == NULL || !strnlen(inputLocation, DEF_STR_LEN)) {
+		fprintf(stderr, "ERROR %s: Passed null or empty input location, exiting.\n", __func__);
+		return NULL;
+	}
+
+	if (stride < 1) {
+		stride = UPM_INDEX_DEFAULT_STRIDE;
+	}
+
+	lofar_udp_index *packetIndex = lofar_udp_index_alloc();
+	CHECK_ALLOC_NOCLEAN(packetIndex, NULL);
+	packetIndex->version = UPM_INDEX_VERSION;
+	packetIndex->stride = stride;
+
+	_lofar_udp_index_scan scan = {
+		.packetIndex = packetIndex,
+		.entryCapacity = 0,
+		.lastPacketNumber = -1,
+		.droppedAccum = 0,
+		.outOfOrderAccum = 0
+	};
+
+	int32_t returnVal;
+	switch (readerType) {
+		case NORMAL:
+		case NORMAL_MMAP:
+		case URING:
+			packetIndex->readerType = NORMAL;
+			returnVal = _lofar_udp_index_scan_FILE(&scan, inputLocation);
+			break;
+
+		case ZSTDCOMPRESSED:
+		case ZSTDCOMPRESSED_INDIRECT:
+			packetIndex->readerType = ZSTDCOMPRESSED;
+			returnVal = _lofar_udp_index_scan_ZSTD(&scan, inputLocation);
+			break;
+
+		default:
+			fprintf(stderr, "ERROR %s: Packet indexes are only supported for normal and zstandard compressed files (reader %d), exiting.\n", __func__, readerType);
+			returnVal = -1;
+			break;
+	}
+
+	if (returnVal < 0 || packetIndex->numEntries < 1) {
+		if (returnVal == 0) {
+			fprintf(stderr, "ERROR %s: No packets found in %s, exiting.\n", __func__, inputLocation);
+		}
+		lofar_udp_index_cleanup(packetIndex);
+		return NULL;
+	}
+
+	return packetIndex;
+}
+
+/**
+ * @brief      Write an index to a sidecar file (via a temporary file, so readers never see a partial index)
+ *
+ * @param[in]  packetIndex    The packet index
+ * @param[in]  indexLocation  The output location
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_index_write(const lofar_udp_index *packetIndex, const char indexLocation[]) {
+	if (packetIndex == NULL || indexLocation == NULL || packetIndex->entries == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (packetIndex: %p, indexLocation: %p), exiting.\n", __func__, packetIndex, indexLocation);
+		return -1;
+	}
+
+	char tmpLocation[DEF_STR_LEN + 8];
+	if (snprintf(tmpLocation, DEF_STR_LEN + 8, "%s.tmp", indexLocation) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to build temporary index location, exiting.\n", __func__);
+		return -1;
+	}
+
+	FILE *indexFile = fopen(tmpLocation, "wb");
+	if (indexFile == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to open %s for writing (errno %d: %s), exiting.\n", __func__, tmpLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	const char magic[UPM_INDEX_MAGIC_LEN] = UPM_INDEX_MAGIC;
+	if (fwrite(magic, sizeof(char), UPM_INDEX_MAGIC_LEN, indexFile) != UPM_INDEX_MAGIC_LEN
+		|| fwrite(packetIndex, offsetof(lofar_udp_index, entries), 1, indexFile) != 1
+		|| (int64_t) fwrite(packetIndex->entries, sizeof(lofar_udp_index_entry), packetIndex->numEntries, indexFile) != packetIndex->numEntries) {
+		fprintf(stderr, "ERROR %s: Failed to write index to %s, exiting.\n", __func__, tmpLocation);
+		fclose(indexFile);
+		remove(tmpLocation);
+		return -1;
+	}
+
+	if (fclose(indexFile) || rename(tmpLocation, indexLocation)) {
+		fprintf(stderr, "ERROR %s: Failed to finalise index at %s (errno %d: %s), exiting.\n", __func__, indexLocation, errno, strerror(errno));
+		remove(tmpLocation);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Load an index from a sidecar file
+ *
+ * @param[in]  indexLocation  The sidecar location
+ *
+ * @return     ptr: Success, NULL: Failure
+ */
+lofar_udp_index* lofar_udp_index_load(const char indexLocation[]) {
+	if (indexLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null index location, exiting.\n", __func__);
+		return NULL;
+	}
+
+	FILE *indexFile = fopen(indexLocation, "rb");
+	if (indexFile == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to open index at %s (errno %d: %s), exiting.\n", __func__, indexLocation, errno, strerror(errno));
+		return NULL;
+	}
+
+	lofar_udp_index *packetIndex = lofar_udp_index_alloc();
+	CHECK_ALLOC(packetIndex, NULL, fclose(indexFile););
+
+	const int64_t indexSize = _FILE_file_size(indexFile);
+	const int64_t headerSize = UPM_INDEX_MAGIC_LEN + (int64_t) offsetof(lofar_udp_index, entries);
+	char magic[UPM_INDEX_MAGIC_LEN];
+	if (indexSize < headerSize
+		|| fread(magic, sizeof(char), UPM_INDEX_MAGIC_LEN, indexFile) != UPM_INDEX_MAGIC_LEN
+		|| strncmp(magic, UPM_INDEX_MAGIC, UPM_INDEX_MAGIC_LEN) != 0
+		|| fread(packetIndex, offsetof(lofar_udp_index, entries), 1, indexFile) != 1) {
+		fprintf(stderr, "ERROR %s: %s does not appear to be a packet index, exiting.\n", __func__, indexLocation);
+		fclose(indexFile);
+		lofar_udp_index_cleanup(packetIndex);
+		return NULL;
+	}
+	packetIndex->entries = NULL;
+
+	if (packetIndex->version != UPM_INDEX_VERSION || packetIndex->numEntries < 1 || packetIndex->stride < 1
+		|| (indexSize - headerSize) != packetIndex->numEntries * (int64_t) sizeof(lofar_udp_index_entry)) {
+		fprintf(stderr, "ERROR %s: Index at %s is an unsupported version (%d) or corrupted, exiting.\n", __func__, indexLocation, packetIndex->version);
+		fclose(indexFile);
+		lofar_udp_index_cleanup(packetIndex);
+		return NULL;
+	}
+
+	packetIndex->entries = calloc(packetIndex->numEntries, sizeof(lofar_udp_index_entry));
+	if (packetIndex->entries == NULL
+		|| (int64_t) fread(packetIndex->entries, sizeof(lofar_udp_index_entry), packetIndex->numEntries, indexFile) != packetIndex->numEntries) {
+		fprintf(stderr, "ERROR %s: Failed to read %ld entries from %s, exiting.\n", __func__, packetIndex->numEntries, indexLocation);
+		fclose(indexFile);
+		lofar_udp_index_cleanup(packetIndex);
+		return NULL;
+	}
+
+	fclose(indexFile);
+	return packetIndex;
+}
+
+/**
+ * @brief      Free an index and its entries
+ *
+ * @param      packetIndex  The packet index
+ */
+void lofar_udp_index_cleanup(lofar_udp_index *packetIndex) {
+	if (packetIndex == NULL) {
+		return;
+	}
+
+	FREE_NOT_NULL(packetIndex->entries);
+	FREE_NOT_NULL(packetIndex);
+}
+
+/**
+ * @brief      Build the sidecar location for a given input file
+ *
+ * @param      dest           The output buffer (DEF_STR_LEN long)
+ * @param[in]  inputLocation  The input file location
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_index_get_location(char *dest, const char inputLocation[]) {
+	if (dest == NULL || inputLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (dest: %p, inputLocation: %p), exiting.\n", __func__, dest, inputLocation);
+		return -1;
+	}
+
+	const int32_t written = snprintf(dest, DEF_STR_LEN, "%s%s", inputLocation, UPM_INDEX_SUFFIX);
+	if (written < 0 || written >= DEF_STR_LEN) {
+		fprintf(stderr, "ERROR %s: Index location for %s is too long, exiting.\n", __func__, inputLocation);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Find the last index entry at or before a given packet number
+ *
+ * @param[in]  packetIndex   The packet index
+ * @param[in]  targetPacket  The target packet number
+ *
+ * @return     >=0: Entry index, -1: No suitable entry
+ */
+int64_t lofar_udp_index_find_entry(const lofar_udp_index *packetIndex, int64_t targetPacket) {
+	if (packetIndex == NULL || packetIndex->numEntries < 1 || targetPacket < packetIndex->entries[0].packetNumber) {
+		return -1;
+	}
+
+	// Binary search for the first entry past the target
+	int64_t lower = 0, upper = packetIndex->numEntries;
+	while (lower < upper) {
+		const int64_t mid = lower + (upper - lower) / 2;
+		if (packetIndex->entries[mid].packetNumber <= targetPacket) {
+			lower = mid + 1;
+		} else {
+			upper = mid;
+		}
+	}
+
+	// Out of order entries can break monotonicity, step back until we are before the target
+	int64_t entry = lower - 1;
+	while (entry > 0 && packetIndex->entries[entry].packetNumber > targetPacket) {
+		entry--;
+	}
+
+	return entry;
+}
+
+/**
+ * @brief      Check that an index describes the given input
+ *
+ * @param[in]  packetIndex   The packet index
+ * @param[in]  readerType    The input reader type
+ * @param[in]  inputSize     The input file size
+ * @param[in]  packetLength  The expected packet length (<1 to skip the check)
+ *
+ * @return     0: Index matches, <0: Mismatch
+ */
+int32_t lofar_udp_index_check_input(const lofar_udp_index *packetIndex, reader_t readerType, int64_t inputSize, int32_t packetLength) {
+	if (packetIndex == NULL) {
+		return -1;
+	}
+
+	// Alternative readers of the same data share indexes
+	reader_t baseType = readerType;
+	switch (readerType) {
+		case NORMAL_MMAP:
+		case URING:
+			baseType = NORMAL;
+			break;
+
+		case ZSTDCOMPRESSED_INDIRECT:
+			baseType = ZSTDCOMPRESSED;
+			break;
+
+		default:
+			break;
+	}
+	if (packetIndex->readerType != baseType) {
+		return -2;
+	}
+
+	if (packetIndex->inputSize != inputSize) {
+		return -3;
+	}
+
+	if (packetLength > 0 && packetIndex->packetLength != packetLength) {
+		return -4;
+	}
+
+	return 0;
+}
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
@@ -0,0 +1,56 @@
+#ifndef LOFAR_UDP_INDEX_H
+#define LOFAR_UDP_INDEX_H
+
+#include "lofar_udp_structs.h"
+#include "lofar_udp_time.h"
+
+#include <stddef.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Sidecar file parameters
+#define UPM_INDEX_SUFFIX ".upmidx"
+#define UPM_INDEX_MAGIC "UPMIDX"
+#define UPM_INDEX_MAGIC_LEN 8
+#define UPM_INDEX_VERSION 1
+#define UPM_INDEX_DEFAULT_STRIDE 4096
+
+// Allow C++ imports too
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Index generation / storage
+lofar_udp_index* lofar_udp_index_generate(const char inputLocation[], reader_t readerType, int32_t stride);
+int32_t lofar_udp_index_write(const lofar_udp_index *packetIndex, const char indexLocation[]);
+lofar_udp_index* lofar_udp_index_load(const char indexLocation[]);
+void lofar_udp_index_cleanup(lofar_udp_index *packetIndex);
+
+// Index usage
+int32_t lofar_udp_index_get_location(char *dest, const char inputLocation[]);
+int64_t lofar_udp_index_find_entry(const lofar_udp_index *packetIndex, int64_t targetPacket);
+int32_t lofar_udp_index_check_input(const lofar_udp_index *packetIndex, reader_t readerType, int64_t inputSize, int32_t packetLength);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOFAR_UDP_INDEX_H
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
@@ -17,8 +17,8 @@ int32_t lofar_udp_io_read_setup(lofar_udp_io_read_config *input, int8_t port) {
 		return -1;
 	}
 
-	if (port < 0 || port >= MAX_NUM_PORTS) {
-		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d), exiting.\n", __func__, port, MAX_NUM_PORTS);
+	if (port < 0 || port >= input->allocatedPorts) {
+		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d), exiting.\n", __func__, port, input->allocatedPorts);
 		return -2;
 	}
 
@@ -29,6 +29,22 @@ int32_t lofar_udp_io_read_setup(lofar_udp_io_read_config *input, int8_t port) {
 			input->numInputs++;
 			return _lofar_udp_io_read_setup_FILE(input, input->inputLocations[port], port);
 
+		case NORMAL_MMAP:
+			input->numInputs++;
+			return _lofar_udp_io_read_setup_MMAP(input, input->inputLocations[port], port);
+
+		case URING:
+			input->numInputs++;
+			return _lofar_udp_io_read_setup_URING(input, input->inputLocations[port], port);
+
+		case UDP:
+			input->numInputs++;
+			return _lofar_udp_io_read_setup_UDP(input, input->inputLocations[port], port);
+
+		case PCAP:
+			input->numInputs++;
+			return _lofar_udp_io_read_setup_PCAP(input, input->inputLocations[port], port);
+
 		case ZSTDCOMPRESSED:
 		case ZSTDCOMPRESSED_INDIRECT:
 			input->numInputs++;
@@ -39,8 +55,12 @@ int32_t lofar_udp_io_read_setup(lofar_udp_io_read_config *input, int8_t port) {
 			return _lofar_udp_io_read_setup_DADA(input, input->inputDadaKeys[port], port);
 
 		case HDF5:
-			fprintf(stderr, "ERROR: Reading from HDF5 files is currently not supported, exiting.\n");
-			return -1;
+			input->numInputs++;
+			return _lofar_udp_io_read_setup_HDF5(input, input->inputLocations[port], port);
+
+		case SHM:
+			input->numInputs++;
+			return _lofar_udp_io_read_setup_SHM(input, input->inputLocations[port], port);
 
 		default:
 			fprintf(stderr, "ERROR: Unknown reader (%d) provided, exiting.\n", input->readerType);
@@ -70,16 +90,31 @@ int32_t lofar_udp_io_write_setup(lofar_udp_io_write_config *config, int32_t iter
 		return -2;
 	}
 
-	if (config->numOutputs < 1 || config->numOutputs > MAX_OUTPUT_DIMS) {
-		fprintf(stderr, "ERROR %s: Invalid number of output writers (0 > %d > %d), exiting.\n", __func__, config->numOutputs, MAX_OUTPUT_DIMS);
+	if (config->numOutputs < 1) {
+		fprintf(stderr, "ERROR %s: Invalid number of output writers (%d < 1), exiting.\n", __func__, config->numOutputs);
+		return -3;
+	}
+
+	if (lofar_udp_io_write_alloc_outputs(config, config->numOutputs) < 0) {
 		return -3;
 	}
 
-	if (config->readerType == DADA_ACTIVE && iter > 0) {
-		fprintf(stderr, "ERROR %s: DADA writer does not support multiple iterations, exiting.\n", __func__);
+	if ((config->readerType == DADA_ACTIVE || config->readerType == SHM) && iter > 0) {
+		fprintf(stderr, "ERROR %s: %s writer does not support multiple iterations, exiting.\n", __func__, config->readerType == SHM ? "SHM" : "DADA");
 		return -4;
 	}
 
+	// Only plain files can be truncated back to a checkpoint and extended
+	if (config->resumeCheckpoint != NULL) {
+		if (config->readerType != NORMAL) {
+			fprintf(stderr, "ERROR %s: Writer %d cannot resume from a checkpoint, only normal files are supported, exiting.\n", __func__, config->readerType);
+			return -6;
+		}
+		if (config->resumeCheckpoint->outputFirstPacket >= 0) {
+			config->firstPacket = config->resumeCheckpoint->outputFirstPacket;
+		}
+	}
+
 	int returnVal = 0;
 	for (int8_t outp = 0; outp < config->numOutputs; outp++) {
 		switch (config->readerType) {
@@ -102,6 +137,10 @@ int32_t lofar_udp_io_write_setup(lofar_udp_io_write_config *config, int32_t iter
 				returnVal = _lofar_udp_io_write_setup_HDF5(config, outp, iter);
 				break;
 
+			case SHM:
+				returnVal = _lofar_udp_io_write_setup_SHM(config, outp, iter);
+				break;
+
 			default:
 				fprintf(stderr, "ERROR: Unknown reader (%d) provided, exiting.\n", config->readerType);
 				return -1;
@@ -130,8 +169,12 @@ int32_t _lofar_udp_io_read_setup_internal_lib_helper(lofar_udp_io_read_config *c
 		return -1;
 	}
 
-	if (port < 0 || port >= MAX_NUM_PORTS) {
-		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d), exiting.\n", __func__, port, MAX_NUM_PORTS);
+	if (port < 0 || port >= config->allocatedPorts || port >= meta->allocatedPorts) {
+		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d), exiting.\n", __func__, port, config->allocatedPorts);
+		return -1;
+	}
+
+	if (lofar_udp_io_read_alloc_ports(input, (int8_t) (port + 1)) < 0) {
 		return -1;
 	}
 
@@ -157,6 +200,7 @@ int32_t _lofar_udp_io_read_setup_internal_lib_helper(lofar_udp_io_read_config *c
 	input->basePort = config->basePort;
 	input->stepSizePort = config->stepSizePort;
 	input->offsetPortCount = config->offsetPortCount;
+	input->followTimeout = config->followTimeout;
 
 	if (input->readerType == DADA_ACTIVE) {
 		input->inputDadaKeys[port] = config->inputDadaKeys[port];
@@ -168,6 +212,28 @@ int32_t _lofar_udp_io_read_setup_internal_lib_helper(lofar_udp_io_read_config *c
 		return -1;
 	}
 
+	// Initialise these arrays while we're looping
+	meta->inputDataOffset[port] = 0;
+	meta->portLastDroppedPackets[port] = 0;
+	meta->portTotalDroppedPackets[port] = 0;
+
+	// Memory mapped inputs are processed in place, the mapping (and the zeroed pages before it) acts as the input buffer
+	if (input->readerType == NORMAL_MMAP) {
+		if (port != input->numInputs) {
+			fprintf(stderr, "ERROR %s: Input port/array is invalid (%d != %d), exiting.\n", __func__, port, input->numInputs);
+			return -1;
+		}
+
+		input->readBufSize[port] = meta->portPacketLength[port] * meta->packetsPerIteration;
+		input->preBufferSpace[port] = PREBUFLEN;
+		if (lofar_udp_io_read_setup(input, port) < 0) {
+			return -1;
+		}
+
+		meta->inputData[port] = (int8_t *) input->readingTracker[port].src;
+		return 0;
+	}
+
 	// Allocate the memory needed to store the raw data, initialise some variables along the way
 
 	// The input buffer is extended by 2 packets to allow for both a reference packet from a previous iteration
@@ -178,7 +244,19 @@ int32_t _lofar_udp_io_read_setup_internal_lib_helper(lofar_udp_io_read_config *c
 	size_t inputBufferSize = meta->portPacketLength[port] * (meta->packetsPerIteration) +
 							 PREBUFLEN + // << 2 buffer packets mentioned above, use fixed size encase of unexpected packet sizes
 	                         additionalBufferSize * (config->readerType == ZSTDCOMPRESSED);
-	meta->inputData[port] = calloc(inputBufferSize, sizeof(int8_t));
+	// Shared memory inputs prefer a page aligned buffer that their data can be mapped over, other inputs prefer a mirrored ring,
+	// so that leftover packets can be kept by advancing the buffer rather than copying them
+	if (config->readerType == DADA_ACTIVE || config->readerType == SHM) {
+		meta->inputData[port] = _lofar_udp_io_read_window_alloc(input, port, inputBufferSize - PREBUFLEN);
+		if (meta->inputData[port] != NULL) {
+			meta->inputData[port] -= PREBUFLEN;
+		}
+	} else {
+		meta->inputData[port] = _lofar_udp_io_read_ring_alloc(input, port, inputBufferSize);
+	}
+	if (meta->inputData[port] == NULL) {
+		meta->inputData[port] = calloc(inputBufferSize, sizeof(int8_t));
+	}
 	CHECK_ALLOC(meta->inputData[port], -1,
 	            for (int8_t i = 0; i < port; i++) { free(meta->inputData[i]); }
 	);
@@ -197,11 +275,6 @@ int32_t _lofar_udp_io_read_setup_internal_lib_helper(lofar_udp_io_read_config *c
 	meta->inputData[port] += PREBUFLEN;
 	input->preBufferSpace[port] = PREBUFLEN;
 
-	// Initialise these arrays while we're looping
-	meta->inputDataOffset[port] = 0;
-	meta->portLastDroppedPackets[port] = 0;
-	meta->portTotalDroppedPackets[port] = 0;
-
 	return lofar_udp_io_read_setup_helper(input, (int8_t**) meta->inputData, input->readBufSize[port], port);
 }
 
@@ -216,13 +289,13 @@ int32_t _lofar_udp_io_read_setup_internal_lib_helper(lofar_udp_io_read_config *c
  * @return 0: Success, -1: Failure
  */
 int32_t lofar_udp_io_read_setup_helper(lofar_udp_io_read_config *input, int8_t **outputArr, int64_t maxReadSize, int8_t port) {
-	if (port < 0 || port >= MAX_NUM_PORTS) {
-		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d), exiting.\n", __func__, port, MAX_NUM_PORTS);
+	if (input == NULL || outputArr == NULL) {
+		fprintf(stderr, "ERROR %s: Input pointer is null (%p, %p), exiting.\n", __func__, input, outputArr);
 		return -1;
 	}
 
-	if (input == NULL || outputArr == NULL) {
-		fprintf(stderr, "ERROR %s: Input pointer is null (%p, %p), exiting.\n", __func__, input, outputArr);
+	if (port < 0 || port >= input->allocatedPorts) {
+		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d), exiting.\n", __func__, port, input->allocatedPorts);
 		return -1;
 	}
 
@@ -246,8 +319,11 @@ int32_t lofar_udp_io_read_setup_helper(lofar_udp_io_read_config *input, int8_t *
 		return -1;
 	}
 
-	// PSRDADA needs port packet length to do corrections if we reconnect to a partially processed ringbuffer
-	input->portPacketLength[port] = 1;
+	// PSRDADA needs port packet length to do corrections if we reconnect to a partially processed ringbuffer, and
+	// file lists only use whole packets from each file; keep the length provided by the library setup if present
+	if (input->portPacketLength[port] < 1) {
+		input->portPacketLength[port] = 1;
+	}
 	// Set the maximum length read buffer
 	input->readBufSize[port] = maxReadSize;
 
@@ -255,6 +331,10 @@ int32_t lofar_udp_io_read_setup_helper(lofar_udp_io_read_config *input, int8_t *
 	if (input->readerType == ZSTDCOMPRESSED) {
 		if (maxReadSize % ZSTD_DStreamOutSize()) {
 			if (input->decompressionTracker[port].size < 1 || input->decompressionTracker[port].size % ZSTD_DStreamOutSize()) {
+				if (input->inputRing[port] != NULL) {
+					fprintf(stderr, "ERROR %s: Cannot resize the mirrored input buffer on port %d, exiting.\n", __func__, port);
+					return -1;
+				}
 				int64_t trueBufferLength = input->readBufSize[port] + input->preBufferSpace[port];
 				int64_t additionalBufferLength = _lofar_udp_io_read_ZSTD_fix_buffer_size(input->readBufSize[port], 1);
 				fprintf(stderr, "WARNING: Resizing ZSTD buffer from %ld bytes to %ld(+%ld) bytes.\n", trueBufferLength,
@@ -291,8 +371,12 @@ int32_t lofar_udp_io_write_setup_helper(lofar_udp_io_write_config *config, int64
 		return -1;
 	}
 
-	if (numOutputs > MAX_OUTPUT_DIMS || numOutputs < 1) {
-		fprintf(stderr, "ERROR %s: Requested more output dimensions that allowed (%d vs %d), exiting.\n", __func__, numOutputs, MAX_OUTPUT_DIMS);
+	if (numOutputs < 1) {
+		fprintf(stderr, "ERROR %s: Requested an invalid number of outputs (%d), exiting.\n", __func__, numOutputs);
+		return -2;
+	}
+
+	if (lofar_udp_io_write_alloc_outputs(config, numOutputs) < 0) {
 		return -2;
 	}
 
@@ -364,6 +448,22 @@ void lofar_udp_io_read_cleanup(lofar_udp_io_read_config *input) {
 				_lofar_udp_io_read_cleanup_FILE(input, port);
 				break;
 
+			case NORMAL_MMAP:
+				_lofar_udp_io_read_cleanup_MMAP(input, port);
+				break;
+
+			case URING:
+				_lofar_udp_io_read_cleanup_URING(input, port);
+				break;
+
+			case UDP:
+				_lofar_udp_io_read_cleanup_UDP(input, port);
+				break;
+
+			case PCAP:
+				_lofar_udp_io_read_cleanup_PCAP(input, port);
+				break;
+
 			case ZSTDCOMPRESSED:
 			case ZSTDCOMPRESSED_INDIRECT:
 				_lofar_udp_io_read_cleanup_ZSTD(input, port);
@@ -377,12 +477,22 @@ void lofar_udp_io_read_cleanup(lofar_udp_io_read_config *input) {
 				_lofar_udp_io_read_cleanup_HDF5(input, port);
 				break;
 
+			case SHM:
+				_lofar_udp_io_read_cleanup_SHM(input, port);
+				break;
+
 			default:
 				fprintf(stderr, "ERROR: Unknown reader (%d) provided, exiting.\n", input->readerType);
 				break;
 		}
 	}
 
+	for (int8_t port = 0; port < input->allocatedPorts; port++) {
+		lofar_udp_index_cleanup(input->packetIndex[port]);
+		input->packetIndex[port] = NULL;
+	}
+
+	_lofar_udp_io_read_free_ports(input);
 	FREE_NOT_NULL(input);
 }
 
@@ -397,6 +507,15 @@ void lofar_udp_io_write_cleanup(lofar_udp_io_write_config *config, int8_t fullCl
 		return;
 	}
 
+	// Outputs can only be closed once any background writes have finished
+	if (config->asyncWriter != NULL) {
+		if (fullClean) {
+			lofar_udp_io_write_async_cleanup(config);
+		} else {
+			lofar_udp_io_write_async_wait(config);
+		}
+	}
+
 	const int8_t numOutputs = config->numOutputs;
 	for (int8_t outp = 0; outp < numOutputs; outp++) {
 		switch (config->readerType) {
@@ -419,6 +538,10 @@ void lofar_udp_io_write_cleanup(lofar_udp_io_write_config *config, int8_t fullCl
 				_lofar_udp_io_write_cleanup_HDF5(config, outp, fullClean);
 				break;
 
+			case SHM:
+				_lofar_udp_io_write_cleanup_SHM(config, outp, fullClean);
+				break;
+
 			default:
 				fprintf(stderr, "ERROR: Unknown type (%d) provided, exiting.\n", config->readerType);
 				return;
@@ -426,6 +549,7 @@ void lofar_udp_io_write_cleanup(lofar_udp_io_write_config *config, int8_t fullCl
 	}
 
 	if (fullClean) {
+		_lofar_udp_io_write_free_outputs(config);
 		FREE_NOT_NULL(config);
 	}
 }
@@ -458,8 +582,10 @@ reader_t lofar_udp_io_parse_type_optarg(const char *optargc, char *fileFormat, i
 	}
 
 	VERBOSE(printf("a: %s: %d, %d, %d\n", __func__, *baseVal, *stepSize, *offsetVal));
-	// Check if we have a prefix name
-	if (optargc[4] == ':') {
+	// Check if we have a prefix name (3 to 5 characters)
+	const char *prefixEnd = strchr(optargc, ':');
+	const ptrdiff_t prefixLength = (prefixEnd != NULL) ? (prefixEnd - optargc) : -1;
+	if (prefixLength >= 3 && prefixLength <= 5) {
 		sscanf(optargc, "%*[^:]:%[^,],%d,%hd,%hhd", fileFormat, baseVal, stepSize, offsetVal);
 		VERBOSE(printf("b: %s: %d, %d, %d\n", __func__, *baseVal, *stepSize, *offsetVal));
 
@@ -468,12 +594,22 @@ reader_t lofar_udp_io_parse_type_optarg(const char *optargc, char *fileFormat, i
 			reader = NORMAL;
 		} else if (strstr(optargc, "FIFO:") != NULL) {
 			reader = FIFO;
+		} else if (strstr(optargc, "MMAP:") != NULL) {
+			reader = NORMAL_MMAP;
+		} else if (strstr(optargc, "URING:") != NULL) {
+			reader = URING;
+		} else if (strstr(optargc, "UDP:") != NULL) {
+			reader = UDP;
+		} else if (strstr(optargc, "PCAP:") != NULL) {
+			reader = PCAP;
 		} else if (strstr(optargc, "ZSTD:") != NULL) {
 			reader = ZSTDCOMPRESSED;
 		} else if (strstr(optargc, "DADA:") != NULL) {
 			reader = DADA_ACTIVE;
 		} else if (strstr(optargc, "HDF5:") != NULL) {
 			reader = HDF5;
+		} else if (strstr(optargc, "SHM:") != NULL) {
+			reader = SHM;
 		} else {
 			// Unknown prefix
 			reader = NO_ACTION;
@@ -487,6 +623,9 @@ reader_t lofar_udp_io_parse_type_optarg(const char *optargc, char *fileFormat, i
 		} else if (strstr(optargc, ".hdf5") != NULL || strstr(optargc, ".h5") != NULL) {
 			VERBOSE(printf("%s, HDF5\n", optargc));
 			reader = HDF5;
+		} else if (strstr(optargc, ".pcap") != NULL) {
+			VERBOSE(printf("%s, PCAP\n", optargc));
+			reader = PCAP;
 		} else {
 			fprintf(stderr, "WARNING %s: No filename hints found, assuming input is a normal file.\n", __func__);
 			reader = NORMAL;
@@ -678,13 +817,23 @@ int32_t lofar_udp_io_read_parse_optarg(lofar_udp_config *config, const char opta
 		return -2;
 	}
 
+	// Every allocated port is populated, so a numPorts set before parsing needs its entries allocated first
+	if (lofar_udp_config_alloc_ports(config, config->numPorts) < 0) {
+		return -2;
+	}
+
 	switch (config->readerType) {
 		case NORMAL:
 		case FIFO:
+		case NORMAL_MMAP:
+		case URING:
+		case UDP:
+		case PCAP:
 		case ZSTDCOMPRESSED:
 		case ZSTDCOMPRESSED_INDIRECT:
 		case HDF5:
-			for (int8_t i = 0; i < (MAX_NUM_PORTS - config->offsetPortCount); i++) {
+		case SHM:
+			for (int8_t i = 0; i < config->allocatedPorts; i++) {
 				int32_t port = (config->basePort + config->offsetPortCount * config->stepSizePort) + i * config->stepSizePort;
 
 				if (lofar_udp_io_parse_format(config->inputLocations[i], fileFormat, port, -1, i, -1) < 0) {
@@ -720,7 +869,7 @@ int32_t lofar_udp_io_read_parse_optarg(lofar_udp_config *config, const char opta
 			}
 
 			// Populate the dada keys
-			for (int8_t i = 0; i < (MAX_NUM_PORTS - config->offsetPortCount); i++) {
+			for (int8_t i = 0; i < config->allocatedPorts; i++) {
 				config->inputDadaKeys[i] = (config->basePort + config->offsetPortCount * config->stepSizePort) + i * config->stepSizePort;
 			}
 			break;
@@ -764,6 +913,7 @@ int32_t lofar_udp_io_write_parse_optarg(lofar_udp_io_write_config *config, const
 		case ZSTDCOMPRESSED:
 		case ZSTDCOMPRESSED_INDIRECT:
 		case HDF5:
+		case SHM:
 			// Nothing needs to be done for normal files here
 			break;
 
@@ -822,7 +972,7 @@ int64_t lofar_udp_io_read(lofar_udp_io_read_config *const input, int8_t port, in
 		return 0;
 	}
 
-	if (port < 0 || port >= MAX_NUM_PORTS) {
+	if (port < 0 || port >= input->allocatedPorts) {
 		fprintf(stderr, "ERROR: Invalid port index (%d)\n, exiting.", port);
 		return -1;
 	}
@@ -837,26 +987,149 @@ int64_t lofar_udp_io_read(lofar_udp_io_read_config *const input, int8_t port, in
 		return -1;
 	}
 
+	int64_t readlen;
+	input->lastReadOffset[port] = input->streamOffset[port];
 	switch (input->readerType) {
 		case NORMAL:
 		case FIFO:
-			return _lofar_udp_io_read_FILE(input, port, targetArray, nchars);
+			readlen = _lofar_udp_io_read_FILE(input, port, targetArray, nchars);
+			break;
+
+		case NORMAL_MMAP:
+			readlen = _lofar_udp_io_read_MMAP(input, port, targetArray, nchars);
+			break;
+
+		case URING:
+			readlen = _lofar_udp_io_read_URING(input, port, targetArray, nchars);
+			break;
+
+		case UDP:
+			readlen = _lofar_udp_io_read_UDP(input, port, targetArray, nchars);
+			break;
 
+		case PCAP:
+			readlen = _lofar_udp_io_read_PCAP(input, port, targetArray, nchars);
+			break;
 
 		case ZSTDCOMPRESSED:
 		case ZSTDCOMPRESSED_INDIRECT:
-			return _lofar_udp_io_read_ZSTD(input, port, targetArray, nchars);
+			readlen = _lofar_udp_io_read_ZSTD(input, port, targetArray, nchars);
+			break;
 
 
 		case DADA_ACTIVE:
-			return _lofar_udp_io_read_DADA(input, port, targetArray, nchars);
+			readlen = _lofar_udp_io_read_DADA(input, port, targetArray, nchars);
+			break;
 
 		case HDF5:
+			readlen = _lofar_udp_io_read_HDF5(input, port, targetArray, nchars);
+			break;
+
+		case SHM:
+			readlen = _lofar_udp_io_read_SHM(input, port, targetArray, nchars);
+			break;
+
 		default:
 			fprintf(stderr, "ERROR: Unknown reader %d, exiting.\n", input->readerType);
 			return -1;
 
 	}
+
+	// Track the position in the stream so that the reader's progress can be checkpointed
+	if (readlen > 0) {
+		input->streamOffset[port] += readlen;
+	}
+	return readlen;
+}
+
+/**
+ * @brief Wait for data on an input and return a pointer to it in place, rather than copying it into a buffer. The data is
+ * 			read-only, and remains valid until it is passed to lofar_udp_io_read_release().
+ *
+ * 			In-place reads are supported by shared memory ring inputs (SHM) and PSRDADA ringbuffers (DADA_ACTIVE). For
+ * 			PSRDADA, requests that fit in the current data block point straight into the block, while requests that span
+ * 			blocks are assembled in a carry-over buffer. Whole blocks are only attached to a reader's input buffer when we
+ * 			are the ringbuffer's single reader and the gulp is exactly one page aligned data block.
+ *
+ * 			Any other input returns an error, and must be read through the copying lofar_udp_io_read() instead.
+ *
+ * @param input Input configuration
+ * @param port Input port of data
+ * @param data Output pointer to the start of the data
+ * @param nchars Number of characters to wait for
+ *
+ * @return >0: Success, bytes available, <=0: Failure/no more data
+ */
+int64_t lofar_udp_io_read_acquire(lofar_udp_io_read_config *const input, int8_t port, const int8_t **data, int64_t nchars) {
+	if (input == NULL || data == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null ptr (input: %p, data: %p), exiting.\n", __func__, input, data);
+		return -1;
+	}
+
+	if (port < 0 || port >= input->allocatedPorts) {
+		fprintf(stderr, "ERROR: Invalid port index (%d)\n, exiting.", port);
+		return -1;
+	}
+
+	if (nchars < 1) {
+		fprintf(stderr, "ERROR: Requested non-positive acquire size %ld on port %d, exiting.\n", nchars, port);
+		return -1;
+	}
+
+	switch (input->readerType) {
+		case SHM:
+			input->lastReadOffset[port] = input->streamOffset[port];
+			return _lofar_udp_io_read_acquire_SHM(input, port, data, nchars);
+
+		case DADA_ACTIVE:
+			input->lastReadOffset[port] = input->streamOffset[port];
+			return _lofar_udp_io_read_acquire_DADA(input, port, data, nchars);
+
+		default:
+			fprintf(stderr, "ERROR %s: Reader %d does not support in-place reads, exiting.\n", __func__, input->readerType);
+			return -1;
+	}
+}
+
+/**
+ * @brief Release data returned by lofar_udp_io_read_acquire() after it has been processed
+ *
+ * @param input Input configuration
+ * @param port Input port of data
+ * @param nchars Number of characters consumed (at most the length returned by the last acquire)
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t lofar_udp_io_read_release(lofar_udp_io_read_config *const input, int8_t port, int64_t nchars) {
+	if (input == NULL) {
+		fprintf(stderr, "ERROR %s: passed null input configuration, exiting.\n", __func__);
+		return -1;
+	}
+
+	if (port < 0 || port >= input->allocatedPorts) {
+		fprintf(stderr, "ERROR: Invalid port index (%d)\n, exiting.", port);
+		return -1;
+	}
+
+	int32_t returnVal;
+	switch (input->readerType) {
+		case SHM:
+			returnVal = _lofar_udp_io_read_release_SHM(input, port, nchars);
+			break;
+
+		case DADA_ACTIVE:
+			returnVal = _lofar_udp_io_read_release_DADA(input, port, nchars);
+			break;
+
+		default:
+			fprintf(stderr, "ERROR %s: Reader %d does not support in-place reads, exiting.\n", __func__, input->readerType);
+			return -1;
+	}
+
+	if (returnVal == 0) {
+		input->streamOffset[port] += nchars;
+	}
+	return returnVal;
 }
 
 
@@ -883,7 +1156,7 @@ int64_t lofar_udp_io_write(lofar_udp_io_write_config *const config, int8_t outp,
 		return 0;
 	}
 
-	if (outp < 0 || outp >= MAX_OUTPUT_DIMS) {
+	if (outp < 0 || outp >= config->allocatedOutputs) {
 		fprintf(stderr, "ERROR: Invalid port index (%d)\n, exiting.", outp);
 		return -1;
 	}
@@ -910,6 +1183,9 @@ int64_t lofar_udp_io_write(lofar_udp_io_write_config *const config, int8_t outp,
 		case HDF5:
 			return _lofar_udp_io_write_HDF5(config, outp, src, nchars);
 
+		case SHM:
+			return _lofar_udp_io_write_SHM(config, outp, src, nchars);
+
 		default:
 			fprintf(stderr, "ERROR %s: Unknown writer %d, exiting.\n", __func__, config->readerType);
 			return -1;
@@ -917,6 +1193,125 @@ int64_t lofar_udp_io_write(lofar_udp_io_write_config *const config, int8_t outp,
 	}
 }
 
+/**
+ * @brief Write a buffer to each output at the same time, using a thread per output, so that slow (e.g. compressed) outputs are
+ * 			not handled one after another
+ *
+ * @param config Output configuration
+ * @param src Data for each output
+ * @param nchars Number of characters to write to each output
+ * @param timing Time spent writing each output, in seconds (optional)
+ *
+ * @return >=0: Success, total bytes written, <0: Failure (at least one output was not fully written)
+ */
+int64_t lofar_udp_io_write_all(lofar_udp_io_write_config *const config, int8_t *const src[], const int64_t nchars[], double timing[]) {
+	if (config == NULL || src == NULL || nchars == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (config: %p, src: %p, nchars: %p), exiting.\n", __func__, config, src, nchars);
+		return -1;
+	}
+
+	if (config->numOutputs < 1 || config->numOutputs > config->allocatedOutputs) {
+		fprintf(stderr, "ERROR %s: Invalid number of outputs (%d), exiting.\n", __func__, config->numOutputs);
+		return -1;
+	}
+
+	int64_t totalWritten = 0;
+	int32_t failed = 0;
+	#pragma omp parallel for default(shared) num_threads(config->numOutputs) schedule(static, 1) reduction(+:totalWritten) reduction(|:failed)
+	for (int8_t outp = 0; outp < config->numOutputs; outp++) {
+		struct timespec tick, tock;
+		CLICK(tick);
+		const int64_t written = lofar_udp_io_write(config, outp, src[outp], nchars[outp]);
+		CLICK(tock);
+
+		if (timing != NULL) {
+			timing[outp] = TICKTOCK(tick, tock);
+		}
+
+		if (written < 0 || written != nchars[outp]) {
+			fprintf(stderr, "ERROR: Failed to write data to output %d (%ld / %ld bytes written).\n", outp, written, nchars[outp]);
+			failed = 1;
+		} else {
+			totalWritten += written;
+		}
+	}
+
+	return failed ? -1 : totalWritten;
+}
+
+/**
+ * @brief Get a buffer in the output itself that data can be generated in, avoiding the copy performed by lofar_udp_io_write()
+ *
+ * Only supported by PSRDADA outputs. The buffer is held until lofar_udp_io_write_commit() is called, or the output is cleaned up.
+ *
+ * @param config Output configuration
+ * @param outp Output index
+ * @param data Pointer to the output buffer
+ * @param nchars Number of characters that will be written
+ *
+ * @return >=nchars: Success, size of the buffer at data, <0: Failure
+ */
+int64_t lofar_udp_io_write_acquire(lofar_udp_io_write_config *const config, int8_t outp, int8_t **data, int64_t nchars) {
+	if (config == NULL || data == NULL) {
+		fprintf(stderr, "ERROR %s: passed null output configuration (%p) or data pointer (%p), exiting.\n", __func__, config, data);
+		return -1;
+	}
+
+	if (outp < 0 || outp >= config->allocatedOutputs) {
+		fprintf(stderr, "ERROR: Invalid port index (%d)\n, exiting.", outp);
+		return -1;
+	}
+
+	if (nchars < 1) {
+		fprintf(stderr, "ERROR: Requested non-positive acquire size %ld on output %d, exiting.\n", nchars, outp);
+		return -1;
+	}
+
+	switch (config->readerType) {
+		case DADA_ACTIVE:
+			return _lofar_udp_io_write_acquire_DADA(config, outp, data, nchars);
+
+		default:
+			fprintf(stderr, "ERROR %s: Writer %d does not support in-place writes, exiting.\n", __func__, config->readerType);
+			return -1;
+	}
+}
+
+/**
+ * @brief Pass data generated in the buffer from lofar_udp_io_write_acquire() on to the output
+ *
+ * @param config Output configuration
+ * @param outp Output index
+ * @param nchars Number of characters written to the buffer (0 to discard it)
+ *
+ * @return >=0: Success, bytes written, <0: Failure
+ */
+int64_t lofar_udp_io_write_commit(lofar_udp_io_write_config *const config, int8_t outp, int64_t nchars) {
+	if (config == NULL) {
+		fprintf(stderr, "ERROR %s: passed null output configuration, exiting.\n", __func__);
+		return -1;
+	}
+
+	if (outp < 0 || outp >= config->allocatedOutputs) {
+		fprintf(stderr, "ERROR: Invalid port index (%d)\n, exiting.", outp);
+		return -1;
+	}
+
+	if (nchars < 0) {
+		fprintf(stderr, "ERROR: Requested negative commit size %ld on output %d, exiting.\n", nchars, outp);
+		return -1;
+	}
+
+	switch (config->readerType) {
+		case DADA_ACTIVE:
+			return _lofar_udp_io_write_commit_DADA(config, outp, nchars);
+
+		default:
+			fprintf(stderr, "ERROR %s: Writer %d does not support in-place writes, exiting.\n", __func__, config->readerType);
+			return -1;
+	}
+}
+
 /**
  * @brief Write a metadata buffer to a specified output file
  *
@@ -934,7 +1329,7 @@ int64_t lofar_udp_io_write_metadata(lofar_udp_io_write_config *const outConfig,
 		return -1;
 	}
 
-	if (outp < 0 || outp >= MAX_OUTPUT_DIMS) {
+	if (outp < 0 || outp >= outConfig->allocatedOutputs) {
 		fprintf(stderr, "ERROR: Invalid port index (%d)\n, exiting.", outp);
 		return -2;
 	}
@@ -952,12 +1347,16 @@ int64_t lofar_udp_io_write_metadata(lofar_udp_io_write_config *const outConfig,
 
 
 	switch (outConfig->readerType) {
-		// Normal file writes
+		// Normal file writes, shared memory rings carry the header in the stream as FIFOs do
 		case NORMAL:
 		case FIFO:
+		case SHM:
+			return lofar_udp_io_write(outConfig, outp, headerBuffer, headerLength);
+
+		// Filtered zstandard outputs keep the metadata unfiltered
 		case ZSTDCOMPRESSED:
 		case ZSTDCOMPRESSED_INDIRECT:
-			return lofar_udp_io_write(outConfig, outp, headerBuffer, headerLength);
+			return _lofar_udp_io_write_metadata_ZSTD(outConfig, outp, headerBuffer, headerLength);
 
 		// Ringbuffer is offset by 1 from normal writes
 		case DADA_ACTIVE:
@@ -973,6 +1372,207 @@ int64_t lofar_udp_io_write_metadata(lofar_udp_io_write_config *const outConfig,
 	}
 }
 
+/**
+ * @brief Attempt to load a packet index sidecar for an input, indexes that do not match the input are ignored
+ *
+ * @param input Input configuration (post-setup)
+ * @param port Input port
+ * @param packetLength Expected packet length on the port
+ *
+ * @return 1: Index loaded, 0: No usable index, <0: Failure
+ */
+int32_t lofar_udp_io_read_index_load(lofar_udp_io_read_config *input, int8_t port, int32_t packetLength) {
+	if (input == NULL) {
+		fprintf(stderr, "ERROR %s: passed null input configuration, exiting.\n", __func__);
+		return -1;
+	}
+
+	if (port < 0 || port >= input->allocatedPorts) {
+		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d), exiting.\n", __func__, port, input->allocatedPorts);
+		return -2;
+	}
+
+	switch (input->readerType) {
+		// Indexes only make sense for seekable inputs
+		case NORMAL:
+		case NORMAL_MMAP:
+		case URING:
+		case ZSTDCOMPRESSED:
+		case ZSTDCOMPRESSED_INDIRECT:
+			break;
+
+		default:
+			return 0;
+	}
+
+	// Sidecars describe a single file, they cannot be used for file lists
+	if (input->fileRef[port] == NULL || input->fileList[port] != NULL) {
+		return 0;
+	}
+
+	char indexLocation[DEF_STR_LEN];
+	if (lofar_udp_index_get_location(indexLocation, input->inputLocations[port]) < 0) {
+		return -3;
+	}
+
+	if (access(indexLocation, R_OK) != 0) {
+		return 0;
+	}
+
+	lofar_udp_index *packetIndex = lofar_udp_index_load(indexLocation);
+	if (packetIndex == NULL) {
+		fprintf(stderr, "WARNING %s: Failed to load packet index for port %d, continuing without it.\n", __func__, port);
+		return 0;
+	}
+
+	if (lofar_udp_index_check_input(packetIndex, input->readerType, _FILE_file_size(input->fileRef[port]), packetLength) < 0) {
+		fprintf(stderr, "WARNING %s: Packet index at %s does not match the input (stale or for another file), ignoring it.\n", __func__, indexLocation);
+		lofar_udp_index_cleanup(packetIndex);
+		return 0;
+	}
+
+	lofar_udp_index_cleanup(input->packetIndex[port]);
+	input->packetIndex[port] = packetIndex;
+	VERBOSE(printf("%s: Loaded %ld index entries for port %d\n", __func__, packetIndex->numEntries, port));
+
+	return 1;
+}
+
+/**
+ * @brief Seek an input to the last indexed packet at or before a target packet
+ *
+ * @param input Input configuration
+ * @param port Input port
+ * @param targetPacket Target packet number
+ *
+ * @return 1: Input seeked, 0: No usable index/entry (input untouched), <0: Failure
+ */
+int32_t lofar_udp_io_read_seek_index(lofar_udp_io_read_config *input, int8_t port, int64_t targetPacket) {
+	if (input == NULL) {
+		fprintf(stderr, "ERROR %s: passed null input configuration, exiting.\n", __func__);
+		return -1;
+	}
+
+	if (port < 0 || port >= input->allocatedPorts) {
+		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d), exiting.\n", __func__, port, input->allocatedPorts);
+		return -2;
+	}
+
+	const lofar_udp_index *packetIndex = input->packetIndex[port];
+	const int64_t entryIdx = lofar_udp_index_find_entry(packetIndex, targetPacket);
+	if (entryIdx < 0) {
+		return 0;
+	}
+	const lofar_udp_index_entry *entry = &(packetIndex->entries[entryIdx]);
+
+	VERBOSE(printf("%s: Port %d seeking to packet %ld (target %ld) at byte %ld\n", __func__, port, entry->packetNumber, targetPacket, entry->byteOffset));
+
+	switch (input->readerType) {
+		case NORMAL:
+		case NORMAL_MMAP:
+		case URING:
+		case ZSTDCOMPRESSED:
+		case ZSTDCOMPRESSED_INDIRECT:
+			return lofar_udp_io_read_seek(input, port, entry->byteOffset, entry->frameOffset, entry->frameDataOffset) < 0 ? -3 : 1;
+
+		default:
+			return 0;
+	}
+}
+
+/**
+ * @brief Seek a (seekable) input to a byte offset, the next read will start at the given offset
+ *
+ * @param input Input configuration
+ * @param port Input port
+ * @param byteOffset Target offset (of the decompressed stream for zstandard inputs)
+ * @param frameOffset zstandard inputs: compressed offset of a frame starting at or before the target
+ * @param frameDataOffset zstandard inputs: offset of the first byte of that frame in the decompressed stream
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t lofar_udp_io_read_seek(lofar_udp_io_read_config *input, int8_t port, int64_t byteOffset, int64_t frameOffset, int64_t frameDataOffset) {
+	if (input == NULL) {
+		fprintf(stderr, "ERROR %s: passed null input configuration, exiting.\n", __func__);
+		return -1;
+	}
+
+	if (port < 0 || port >= input->allocatedPorts || byteOffset < 0) {
+		fprintf(stderr, "ERROR %s: Invalid port %d (>=%d) or offset %ld, exiting.\n", __func__, port, input->allocatedPorts, byteOffset);
+		return -2;
+	}
+
+	int32_t returnVal;
+	switch (input->readerType) {
+		case NORMAL:
+			returnVal = _lofar_udp_io_read_seek_FILE(input, port, byteOffset);
+			break;
+
+		case NORMAL_MMAP:
+			returnVal = _lofar_udp_io_read_seek_MMAP(input, port, byteOffset);
+			break;
+
+		case URING:
+			returnVal = _lofar_udp_io_read_seek_URING(input, port, byteOffset);
+			break;
+
+		case ZSTDCOMPRESSED:
+		case ZSTDCOMPRESSED_INDIRECT:
+			if (frameOffset < 0 || frameDataOffset < 0 || frameDataOffset > byteOffset) {
+				fprintf(stderr, "ERROR %s: Invalid frame (%ld, %ld) for offset %ld on port %d, exiting.\n", __func__, frameOffset, frameDataOffset, byteOffset, port);
+				return -3;
+			}
+			// The seek discards data up to the target through the normal read, which advances the stream offset
+			input->streamOffset[port] = frameDataOffset;
+			returnVal = _lofar_udp_io_read_seek_ZSTD(input, port, frameOffset, byteOffset - frameDataOffset);
+			break;
+
+		default:
+			fprintf(stderr, "ERROR %s: Reader %d on port %d cannot be seeked, exiting.\n", __func__, input->readerType, port);
+			return -4;
+	}
+
+	if (returnVal < 0) {
+		return -5;
+	}
+
+	input->streamOffset[port] = byteOffset;
+	input->lastReadOffset[port] = byteOffset;
+	return 0;
+}
+
+/**
+ * @brief Find the most recently decompressed zstandard frame that starts at or before an offset in the stream
+ *
+ * @param input Input configuration
+ * @param port Input port
+ * @param byteOffset Target offset in the decompressed stream
+ * @param anchor Output frame start, the start of the stream if no frame has been recorded
+ *
+ * @return 1: Frame found, 0: Falling back to the start of the stream, <0: Failure
+ */
+int32_t _lofar_udp_io_read_ZSTD_find_anchor(const lofar_udp_io_read_config *input, int8_t port, int64_t byteOffset, lofar_udp_io_zstd_anchor *anchor) {
+	if (input == NULL || anchor == NULL || port < 0 || port >= input->allocatedPorts) {
+		fprintf(stderr, "ERROR %s: Invalid inputs (input: %p, anchor: %p, port: %d), exiting.\n", __func__, input, anchor, port);
+		return -1;
+	}
+
+	anchor->frameOffset = 0;
+	anchor->frameDataOffset = 0;
+	int32_t found = 0;
+
+	const int64_t numAnchors = input->zstdAnchorCount[port] < ZSTD_CHECKPOINT_ANCHORS ? input->zstdAnchorCount[port] : ZSTD_CHECKPOINT_ANCHORS;
+	for (int64_t idx = 0; idx < numAnchors; idx++) {
+		const lofar_udp_io_zstd_anchor *candidate = &(input->zstdAnchors[port][idx]);
+		if (candidate->frameDataOffset <= byteOffset && candidate->frameDataOffset >= anchor->frameDataOffset) {
+			*anchor = *candidate;
+			found = 1;
+		}
+	}
+
+	return found;
+}
+
 /**
  * @brief  Temp read functions (shortcuts to read + reverse read head/requested struct allocation afterwards)
  *
@@ -993,7 +1593,7 @@ lofar_udp_io_read_temp(const lofar_udp_config *config, int8_t port, int8_t *outb
 		return -1;
 	}
 
-	if (port < 0 || port >= MAX_NUM_PORTS) {
+	if (port < 0 || port >= config->allocatedPorts) {
 		fprintf(stderr, "ERROR: Invalid port index (%d)\n, exiting.", port);
 		return -2;
 	}
@@ -1004,7 +1604,15 @@ lofar_udp_io_read_temp(const lofar_udp_config *config, int8_t port, int8_t *outb
 		return -3;
 	}
 
+	char inputFile[DEF_STR_LEN + 1];
 	switch (config->readerType) {
+		case NORMAL:
+			// File lists start from their first file
+			if (_lofar_udp_io_read_FILE_list_first(inputFile, config->inputLocations[port], config->readerType) < 0) {
+				return -1;
+			}
+			return _lofar_udp_io_read_temp_FILE(outbuf, size, num, inputFile, resetSeek);
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wimplicit-fallthrough"
 #pragma GCC diagnostic push
@@ -1013,10 +1621,16 @@ lofar_udp_io_read_temp(const lofar_udp_config *config, int8_t port, int8_t *outb
 				fprintf(stderr, "ERROR %s: Cannot perform a temporary read on a FIFO and reset the pointer location, exiting.\n", __func__);
 				return -1;
 			}
-		case NORMAL:
+		case NORMAL_MMAP:
+		case URING:
 #pragma GCC diagnostic pop
 			return _lofar_udp_io_read_temp_FILE(outbuf, size, num, config->inputLocations[port], resetSeek);
 
+		case UDP:
+			return _lofar_udp_io_read_temp_UDP(outbuf, size, num, config->inputLocations[port], resetSeek);
+
+		case PCAP:
+			return _lofar_udp_io_read_temp_PCAP(outbuf, size, num, config->inputLocations[port], resetSeek);
 
 		case ZSTDCOMPRESSED:
 		case ZSTDCOMPRESSED_INDIRECT:
@@ -1027,8 +1641,10 @@ lofar_udp_io_read_temp(const lofar_udp_config *config, int8_t port, int8_t *outb
 			return _lofar_udp_io_read_temp_DADA(outbuf, size, num, config->inputDadaKeys[port], resetSeek);
 
 		case HDF5:
-			fprintf(stderr, "ERROR: Reading from HDF5 files is not currently supported, exiting.\n");
-			return -1;
+			return _lofar_udp_io_read_temp_HDF5(outbuf, size, num, config->inputLocations[port], port, resetSeek);
+
+		case SHM:
+			return _lofar_udp_io_read_temp_SHM(outbuf, size, num, config->inputLocations[port], resetSeek);
 
 		case NO_ACTION:
 			return 0;
@@ -1066,6 +1682,222 @@ int64_t _lofar_udp_io_read_ZSTD_fix_buffer_size(int64_t bufferSize, int8_t delta
 	return newBufferSize;
 }
 
+/**
+ * @brief	Allocate a mirrored ring buffer for an input port: the same physical pages are mapped twice, back to back,
+ * 			so that any window of up to the ring size that starts in the first mapping is contiguous in memory
+ *
+ * @param input			The input reader struct
+ * @param port			The port the buffer will be used for
+ * @param bufferSize	Minimum size of the ring (rounded up to the page size)
+ *
+ * @return	ptr: Start of the ring, NULL: Failure / unsupported, the caller should fall back to a flat buffer
+ */
+int8_t* _lofar_udp_io_read_ring_alloc(lofar_udp_io_read_config *const input, const int8_t port, const int64_t bufferSize) {
+	if (input == NULL || port < 0 || port >= input->allocatedPorts || bufferSize < 1) {
+		return NULL;
+	}
+
+#ifdef MFD_CLOEXEC
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	if (pageSize < 1) {
+		return NULL;
+	}
+	const int64_t ringSize = ((bufferSize + pageSize - 1) / pageSize) * pageSize;
+
+	int32_t ringFd = memfd_create("upm_input_ring", MFD_CLOEXEC);
+	if (ringFd < 0) {
+		return NULL;
+	}
+
+	if (ftruncate(ringFd, ringSize) < 0) {
+		close(ringFd);
+		return NULL;
+	}
+
+	// Reserve the full address range first, then place both views of the file over it
+	int8_t *ring = mmap(NULL, 2 * ringSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ring == MAP_FAILED) {
+		close(ringFd);
+		return NULL;
+	}
+
+	if (mmap(ring, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, ringFd, 0) == MAP_FAILED ||
+		mmap(ring + ringSize, ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, ringFd, 0) == MAP_FAILED) {
+		munmap(ring, 2 * ringSize);
+		close(ringFd);
+		return NULL;
+	}
+
+	// The mappings hold their own reference to the file
+	close(ringFd);
+
+	input->inputRing[port] = ring;
+	input->inputRingSize[port] = ringSize;
+	return ring;
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * @brief	Advance the head of a mirrored input ring, wrapping it back into the first mapping as needed
+ *
+ * @param input		The input reader struct
+ * @param port		The port of the ring
+ * @param head		The current head of the buffer
+ * @param advance	Number of bytes to advance the head by
+ *
+ * @return	The new head of the buffer
+ */
+int8_t* _lofar_udp_io_read_ring_advance(const lofar_udp_io_read_config *input, const int8_t port, int8_t *head, const int64_t advance) {
+	int64_t offset = (head - input->inputRing[port]) + advance;
+
+	// Keep the head in the first mapping, while leaving room behind it for the pre-buffer packets
+	while (offset >= input->inputRingSize[port] + input->preBufferSpace[port]) {
+		offset -= input->inputRingSize[port];
+	}
+
+	return input->inputRing[port] + offset;
+}
+
+/**
+ * @brief	Prepare a mirrored input ring for the next read, moving any data the reader has already buffered (zstd
+ * 			leftovers) to the target if it is not already in place, so it cannot be overwritten by later buffer updates
+ *
+ * @param input			The input reader struct
+ * @param port			The port of the ring
+ * @param nextTarget	The target of the next read on the port
+ *
+ * @return	0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_ring_prepare(lofar_udp_io_read_config *const input, const int8_t port, int8_t *nextTarget) {
+	if (input->readerType != ZSTDCOMPRESSED || input->decompressionTracker[port].dst == NULL) {
+		return 0;
+	}
+
+	return _lofar_udp_io_read_ZSTD_ring_rebase(input, port, nextTarget, (int64_t) input->decompressionTracker[port].pos - input->zstdLastRead[port], 0);
+}
+
+/**
+ * @brief	Unmap a mirrored input ring
+ *
+ * @param input	The input reader struct
+ * @param port	The port of the ring
+ */
+void _lofar_udp_io_read_ring_free(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input == NULL || input->inputRing[port] == NULL) {
+		return;
+	}
+
+	munmap(input->inputRing[port], 2 * input->inputRingSize[port]);
+	input->inputRing[port] = NULL;
+	input->inputRingSize[port] = 0;
+}
+
+/**
+ * @brief	Allocate a page aligned input buffer, which shared memory (PSRDADA blocks, SHM ring data) can later be mapped over
+ * 			instead of being copied in. A spare page is left after the buffer so that mappings need not end on a page boundary.
+ *
+ * @param input			The input reader struct
+ * @param port			The port of the buffer
+ * @param bufferSize	The length of the buffer, excluding the pre-buffer space
+ *
+ * @return	The head of the buffer (after the pre-buffer space), or NULL if the caller should fall back to a normal buffer
+ */
+int8_t* _lofar_udp_io_read_window_alloc(lofar_udp_io_read_config *const input, const int8_t port, const int64_t bufferSize) {
+	if (input == NULL || port < 0 || port >= input->allocatedPorts || bufferSize < 1) {
+		return NULL;
+	}
+
+	const int64_t pageSize = sysconf(_SC_PAGESIZE);
+	if (pageSize < 1) {
+		return NULL;
+	}
+
+	// The pre-buffer packets get pages of their own, so that mappings over the buffer leave them in place
+	const int64_t prefixSize = ((PREBUFLEN + pageSize - 1) / pageSize) * pageSize;
+	const int64_t windowSize = ((bufferSize + pageSize - 1) / pageSize) * pageSize + pageSize;
+	int8_t *region = mmap(NULL, prefixSize + windowSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (region == MAP_FAILED) {
+		return NULL;
+	}
+
+	input->inputWindow[port] = region + prefixSize;
+	input->inputWindowSize[port] = windowSize;
+	input->inputWindowPrefix[port] = prefixSize;
+	input->inputWindowMapStart[port] = NULL;
+	input->inputWindowMapLength[port] = 0;
+	return input->inputWindow[port];
+}
+
+/**
+ * @brief	Replace shared memory mapped over an input buffer with private memory, keeping the pre-buffer space and the data
+ * 			before keepEnd (packets carried over from the last iteration)
+ *
+ * @param input		The input reader struct
+ * @param port		The port of the buffer
+ * @param keepEnd	The end of the data to keep (anything outside of the buffer keeps only the pre-buffer space)
+ *
+ * @return	0: Success, <0: Failure
+ */
+int32_t _lofar_udp_io_read_window_detach(lofar_udp_io_read_config *const input, const int8_t port, const int8_t *keepEnd) {
+	if (input->inputWindowMapLength[port] < 1) {
+		return 0;
+	}
+
+	// The kept data may live in the shared memory, so it has to be moved aside before the mapping is replaced
+	int8_t *keepStart = input->inputWindow[port] - input->preBufferSpace[port];
+	int64_t keepLength = input->preBufferSpace[port];
+	if (keepEnd > input->inputWindow[port] && keepEnd <= input->inputWindow[port] + input->inputWindowSize[port]) {
+		keepLength += keepEnd - input->inputWindow[port];
+	}
+
+	int8_t *keep = NULL;
+	if (keepLength > 0) {
+		keep = malloc(keepLength);
+		if (keep == NULL) {
+			fprintf(stderr, "ERROR %s: Failed to allocate %ld bytes to preserve data on port %d, exiting.\n", __func__, keepLength, port);
+			return -1;
+		}
+		memcpy(keep, keepStart, keepLength);
+	}
+
+	// Mapping over the shared memory also detaches it
+	if (mmap(input->inputWindowMapStart[port], input->inputWindowMapLength[port], PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+		fprintf(stderr, "ERROR %s: Failed to replace shared memory in the input buffer on port %d (errno %d: %s), exiting.\n", __func__, port, errno, strerror(errno));
+		FREE_NOT_NULL(keep);
+		return -1;
+	}
+	input->inputWindowMapStart[port] = NULL;
+	input->inputWindowMapLength[port] = 0;
+
+	if (keep != NULL) {
+		memcpy(keepStart, keep, keepLength);
+		free(keep);
+	}
+
+	return 0;
+}
+
+/**
+ * @brief	Free a page aligned input buffer, detaching any shared memory mapped over it
+ *
+ * @param input	The input reader struct
+ * @param port	The port of the buffer
+ */
+void _lofar_udp_io_read_window_free(lofar_udp_io_read_config *const input, const int8_t port) {
+	if (input == NULL || input->inputWindow[port] == NULL) {
+		return;
+	}
+
+	munmap(input->inputWindow[port] - input->inputWindowPrefix[port], input->inputWindowPrefix[port] + input->inputWindowSize[port]);
+	input->inputWindow[port] = NULL;
+	input->inputWindowSize[port] = 0;
+	input->inputWindowPrefix[port] = 0;
+	input->inputWindowMapStart[port] = NULL;
+	input->inputWindowMapLength[port] = 0;
+}
+
 /**
  * @brief Swap the values of two character pointers
  *
@@ -1109,9 +1941,14 @@ int64_t _fd_file_size(int32_t fd) {
 }
 
 #include "./io/lofar_udp_io_FILE.c" // NOLINT(bugprone-suspicious-include)
+#include "./io/lofar_udp_io_URING.c" // NOLINT(bugprone-suspicious-include)
+#include "./io/lofar_udp_io_UDP.c" // NOLINT(bugprone-suspicious-include)
+#include "./io/lofar_udp_io_PCAP.c" // NOLINT(bugprone-suspicious-include)
 #include "./io/lofar_udp_io_ZSTD.c" // NOLINT(bugprone-suspicious-include)
 #include "./io/lofar_udp_io_DADA.c" // NOLINT(bugprone-suspicious-include)
 #include "./io/lofar_udp_io_HDF5.c" // NOLINT(bugprone-suspicious-include)
+#include "./io/lofar_udp_io_SHM.c" // NOLINT(bugprone-suspicious-include)
+#include "./io/lofar_udp_io_async.c" // NOLINT(bugprone-suspicious-include)
 
 /**
  * Copyright (C) 2023 David McKenna
@@ -2,17 +2,35 @@
 #define LOFAR_UDP_IO
 
 #include "lofar_udp_structs.h"
+#include "lofar_udp_index.h"
 
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <glob.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <sched.h>
+#include <pthread.h>
+#include <signal.h>
+#include <limits.h>
 #include <sys/ipc.h>
-
-// BitShuffle header for HDF5 filter
+#include <sys/shm.h>
+#include <sys/uio.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <sys/socket.h>
+#include <netdb.h>
+#include <linux/io_uring.h>
+#include <omp.h>
+
+// BitShuffle headers for the HDF5 filter and the zstandard pre-filter
 #include "bshuf_h5filter.h"
+#include "bitshuffle.h"
 
 
 // Allow C++ imports too
@@ -33,8 +51,26 @@ int32_t lofar_udp_io_write_setup_helper(lofar_udp_io_write_config *config, int64
 int64_t lofar_udp_io_read(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
 int64_t lofar_udp_io_read_temp(const lofar_udp_config *config, int8_t port, int8_t *outbuf, int64_t size, int64_t num, int8_t resetSeek);
 int64_t lofar_udp_io_write(lofar_udp_io_write_config *const config, int8_t outp, const int8_t *src, int64_t nchars);
+int64_t lofar_udp_io_write_all(lofar_udp_io_write_config *const config, int8_t *const src[], const int64_t nchars[], double timing[]);
+int64_t lofar_udp_io_write_acquire(lofar_udp_io_write_config *const config, int8_t outp, int8_t **data, int64_t nchars);
+int64_t lofar_udp_io_write_commit(lofar_udp_io_write_config *const config, int8_t outp, int64_t nchars);
+// Background writes
+int32_t lofar_udp_io_write_async_setup(lofar_udp_io_write_config *const config, int32_t numBuffers);
+int8_t* lofar_udp_io_write_async_buffer(lofar_udp_io_write_config *const config, int8_t outp);
+int32_t lofar_udp_io_write_async_submit(lofar_udp_io_write_config *const config, int8_t outp, int8_t *buffer, int64_t nchars, lofar_udp_io_write_callback callback, void *userData);
+int32_t lofar_udp_io_write_async_wait(lofar_udp_io_write_config *const config);
+int32_t lofar_udp_io_write_async_cleanup(lofar_udp_io_write_config *const config);
 int64_t lofar_udp_io_write_metadata(lofar_udp_io_write_config *const outConfig, int8_t outp, const lofar_udp_metadata *metadata, const int8_t *headerBuffer, int64_t headerLength);
 
+// In-place (zero-copy) read functions
+int64_t lofar_udp_io_read_acquire(lofar_udp_io_read_config *const input, int8_t port, const int8_t **data, int64_t nchars);
+int32_t lofar_udp_io_read_release(lofar_udp_io_read_config *const input, int8_t port, int64_t nchars);
+
+// Packet index functions
+int32_t lofar_udp_io_read_index_load(lofar_udp_io_read_config *input, int8_t port, int32_t packetLength);
+int32_t lofar_udp_io_read_seek_index(lofar_udp_io_read_config *input, int8_t port, int64_t targetPacket);
+int32_t lofar_udp_io_read_seek(lofar_udp_io_read_config *input, int8_t port, int64_t byteOffset, int64_t frameOffset, int64_t frameDataOffset);
+
 // More generic setup functions
 int32_t lofar_udp_io_read_setup(lofar_udp_io_read_config *input, int8_t port);
 int32_t lofar_udp_io_write_setup(lofar_udp_io_write_config *config, int32_t iter);
@@ -52,49 +88,127 @@ int32_t _lofar_udp_io_read_setup_internal_lib_helper(lofar_udp_io_read_config *c
 int32_t _lofar_udp_io_write_internal_lib_setup_helper(lofar_udp_io_write_config *config, lofar_udp_reader *reader, int32_t iter);
 
 int32_t _lofar_udp_io_read_setup_FILE(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
+int32_t _lofar_udp_io_read_setup_MMAP(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
+int32_t _lofar_udp_io_read_setup_URING(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
+int32_t _lofar_udp_io_read_setup_UDP(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
+int32_t _lofar_udp_io_read_setup_PCAP(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
 int32_t
 _lofar_udp_io_read_setup_ZSTD(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
 int32_t
 _lofar_udp_io_read_setup_DADA(lofar_udp_io_read_config *const input, key_t dadaKey, int8_t port);
-__attribute__((unused)) int32_t _lofar_udp_io_read_setup_HDF5(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
+int32_t _lofar_udp_io_read_setup_HDF5(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
+int32_t _lofar_udp_io_read_setup_SHM(lofar_udp_io_read_config *const input, const char *inputLocation, int8_t port);
 
 int32_t _lofar_udp_io_write_setup_FILE(lofar_udp_io_write_config *const config, int8_t outp, int32_t iter);
+int32_t _lofar_udp_io_write_setup_FILE_resume(lofar_udp_io_write_config *const config, int8_t outp, const char outputLocation[], int64_t outputOffset);
 int32_t _lofar_udp_io_write_setup_ZSTD(lofar_udp_io_write_config *const config, int8_t outp, int32_t iter);
 int32_t _lofar_udp_io_write_setup_DADA(lofar_udp_io_write_config *const config, int8_t outp);
 int32_t _lofar_udp_io_write_setup_HDF5(lofar_udp_io_write_config *const config, int8_t outp, int32_t iter);
+int32_t _lofar_udp_io_write_setup_SHM(lofar_udp_io_write_config *const config, int8_t outp, int32_t iter);
 
 
 // Operate functions
 int64_t _lofar_udp_io_read_FILE(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
+int64_t _lofar_udp_io_read_MMAP(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
+int64_t _lofar_udp_io_read_URING(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
+int64_t _lofar_udp_io_read_UDP(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
+int64_t _lofar_udp_io_read_PCAP(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
 int64_t _lofar_udp_io_read_ZSTD(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
 int64_t _lofar_udp_io_read_DADA(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
-__attribute__((unused)) int64_t _lofar_udp_io_read_HDF5(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
+int64_t _lofar_udp_io_read_HDF5(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
+int64_t _lofar_udp_io_read_SHM(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
+
+int32_t _lofar_udp_io_read_seek_FILE(lofar_udp_io_read_config *const input, int8_t port, int64_t byteOffset);
+int32_t _lofar_udp_io_read_seek_MMAP(lofar_udp_io_read_config *const input, int8_t port, int64_t byteOffset);
+int32_t _lofar_udp_io_read_seek_URING(lofar_udp_io_read_config *const input, int8_t port, int64_t byteOffset);
+int32_t _lofar_udp_io_read_seek_ZSTD(lofar_udp_io_read_config *const input, int8_t port, int64_t frameOffset, int64_t discardBytes);
+
+// Follow mode
+int64_t _lofar_udp_io_read_follow_FILE(lofar_udp_io_read_config *const input, int8_t port, int64_t knownSize);
+int32_t _lofar_udp_io_read_follow_ZSTD(lofar_udp_io_read_config *const input, int8_t port);
+
+// Multi-file inputs
+int32_t _lofar_udp_io_read_FILE_is_list(const char inputLocation[]);
+int32_t _lofar_udp_io_read_FILE_glob(const char inputLocation[], glob_t *matches);
+int32_t _lofar_udp_io_read_FILE_list_first(char *dest, const char inputLocation[], reader_t readerType);
+int32_t _lofar_udp_io_read_setup_FILE_list(lofar_udp_io_read_config *const input, const char inputLocation[], int8_t port);
+FILE* _lofar_udp_io_read_FILE_list_open(lofar_udp_io_read_config *const input, int8_t port, int32_t file);
+int32_t _lofar_udp_io_read_FILE_list_switch(lofar_udp_io_read_config *const input, int8_t port, int32_t file);
+int64_t _lofar_udp_io_read_FILE_list(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t nchars);
+int32_t _lofar_udp_io_read_seek_FILE_list(lofar_udp_io_read_config *const input, int8_t port, int64_t byteOffset);
+
+// Page cache management
+void _lofar_udp_io_read_advise_FILE(lofar_udp_io_read_config *const input, int8_t port, void *mapping, int64_t position);
+void _lofar_udp_io_read_advise_reset_FILE(lofar_udp_io_read_config *const input, int8_t port, int64_t position);
 
 // ZSTD fixup
 int64_t _lofar_udp_io_read_ZSTD_fix_buffer_size(int64_t bufferSize, int8_t deltaOnly);
+int32_t _lofar_udp_io_read_ZSTD_ring_rebase(lofar_udp_io_read_config *const input, int8_t port, int8_t *targetArray, int64_t leftover, int64_t nchars);
+int64_t _lofar_udp_io_read_ZSTD_frames(lofar_udp_io_read_config *const input, int8_t port, int64_t nchars, int64_t streamOffset);
+void _lofar_udp_io_read_ZSTD_add_anchor(lofar_udp_io_read_config *const input, int8_t port, int64_t frameOffset, int64_t frameDataOffset);
+int32_t _lofar_udp_io_read_ZSTD_find_anchor(const lofar_udp_io_read_config *input, int8_t port, int64_t byteOffset, lofar_udp_io_zstd_anchor *anchor);
+
+// Mirrored input ring buffers
+int8_t* _lofar_udp_io_read_ring_alloc(lofar_udp_io_read_config *const input, int8_t port, int64_t bufferSize);
+int8_t* _lofar_udp_io_read_ring_advance(const lofar_udp_io_read_config *input, int8_t port, int8_t *head, int64_t advance);
+int32_t _lofar_udp_io_read_ring_prepare(lofar_udp_io_read_config *const input, int8_t port, int8_t *nextTarget);
+void _lofar_udp_io_read_ring_free(lofar_udp_io_read_config *const input, int8_t port);
+int8_t* _lofar_udp_io_read_window_alloc(lofar_udp_io_read_config *const input, int8_t port, int64_t bufferSize);
+int32_t _lofar_udp_io_read_window_detach(lofar_udp_io_read_config *const input, int8_t port, const int8_t *keepEnd);
+void _lofar_udp_io_read_window_free(lofar_udp_io_read_config *const input, int8_t port);
+
+// UDP sockets
+int32_t _lofar_udp_io_read_UDP_open(const char inputLocation[]);
+
+// Shared memory rings
+int32_t _lofar_udp_io_SHM_name(char *dest, const char location[]);
+lofar_udp_io_shm_ring* _lofar_udp_io_SHM_open(const char location[]);
+lofar_udp_io_shm_ring* _lofar_udp_io_SHM_create(const char location[], int64_t dataSize, int32_t packetLength, int64_t firstPacket, int8_t reuseExisting);
+int64_t _lofar_udp_io_read_acquire_SHM(lofar_udp_io_read_config *const input, int8_t port, const int8_t **data, int64_t nchars);
+int32_t _lofar_udp_io_read_release_SHM(lofar_udp_io_read_config *const input, int8_t port, int64_t nchars);
+int64_t _lofar_udp_io_read_acquire_DADA(lofar_udp_io_read_config *const input, int8_t port, const int8_t **data, int64_t nchars);
+int32_t _lofar_udp_io_read_release_DADA(lofar_udp_io_read_config *const input, int8_t port, int64_t nchars);
+
+// Memory mapped inputs
+int8_t* _lofar_udp_io_read_MMAP_rebase(lofar_udp_io_read_config *const input, int8_t port, int8_t *head, int64_t keepOffset, int64_t keepLength);
 
 int64_t _lofar_udp_io_write_FILE(lofar_udp_io_write_config *const config, int8_t outp, const int8_t *src, int64_t nchars);
 int64_t _lofar_udp_io_write_FIFO(lofar_udp_io_write_config *const config, int8_t outp, const int8_t *src, int64_t nchars);
 int64_t _lofar_udp_io_write_ZSTD(lofar_udp_io_write_config *const config, int8_t outp, const int8_t *src, int64_t nchars);
 int64_t _lofar_udp_io_write_DADA(ipcio_t *const ringbuffer, const int8_t *src, int64_t nchars, int8_t ipcbuf);
 int64_t _lofar_udp_io_write_HDF5(lofar_udp_io_write_config *const config, int8_t outp, const int8_t *src, int64_t nchars);
+int64_t _lofar_udp_io_write_acquire_DADA(lofar_udp_io_write_config *const config, int8_t outp, int8_t **data, int64_t nchars);
+int64_t _lofar_udp_io_write_commit_DADA(lofar_udp_io_write_config *const config, int8_t outp, int64_t nchars);
+int64_t _lofar_udp_io_write_SHM(lofar_udp_io_write_config *const config, int8_t outp, const int8_t *src, int64_t nchars);
+int64_t _lofar_udp_io_write_metadata_ZSTD(lofar_udp_io_write_config *const config, int8_t outp, const int8_t *src, int64_t nchars);
+int32_t _lofar_udp_io_write_HDF5_direct_setup(lofar_udp_io_write_config *const config, int8_t outp);
 int64_t _lofar_udp_io_write_metadata_HDF5(lofar_udp_io_write_config *const config, const lofar_udp_metadata *metadata);
+int32_t _lofar_udp_io_write_async_pending(lofar_udp_io_write_config *const config, int8_t outp);
 
 int64_t _lofar_udp_io_read_temp_FILE(void *outbuf, int64_t size, int64_t num, const char inputFile[], int8_t resetSeek);
 int64_t _lofar_udp_io_read_temp_ZSTD(void *outbuf, int64_t size, int64_t num, const char inputFile[], int8_t resetSeek);
+int64_t _lofar_udp_io_read_temp_UDP(void *outbuf, int64_t size, int64_t num, const char inputLocation[], int8_t resetSeek);
+int64_t _lofar_udp_io_read_temp_PCAP(void *outbuf, int64_t size, int64_t num, const char inputLocation[], int8_t resetSeek);
 int64_t _lofar_udp_io_read_temp_DADA(void *outbuf, int64_t size, int64_t num, key_t dadaKey, int8_t resetSeek);
-int64_t _lofar_udp_io_read_temp_HDF5(void *outbuf, int64_t size, int8_t num, const char inputFile[], int8_t resetSeek);
+int64_t _lofar_udp_io_read_temp_HDF5(void *outbuf, int64_t size, int64_t num, const char inputFile[], int8_t port, int8_t resetSeek);
+int64_t _lofar_udp_io_read_temp_SHM(void *outbuf, int64_t size, int64_t num, const char inputLocation[], int8_t resetSeek);
 
 // Cleanup functions
 void _lofar_udp_io_read_cleanup_FILE(lofar_udp_io_read_config *const input, int8_t port);
+void _lofar_udp_io_read_cleanup_MMAP(lofar_udp_io_read_config *const input, int8_t port);
+void _lofar_udp_io_read_cleanup_URING(lofar_udp_io_read_config *const input, int8_t port);
+void _lofar_udp_io_read_cleanup_UDP(lofar_udp_io_read_config *const input, int8_t port);
+void _lofar_udp_io_read_cleanup_PCAP(lofar_udp_io_read_config *const input, int8_t port);
 void _lofar_udp_io_read_cleanup_ZSTD(lofar_udp_io_read_config *const input, int8_t port);
 void _lofar_udp_io_read_cleanup_DADA(lofar_udp_io_read_config *const input, int8_t port);
-__attribute__((unused)) void _lofar_udp_io_read_cleanup_HDF5(lofar_udp_io_read_config *const input, int8_t port);
+void _lofar_udp_io_read_cleanup_HDF5(lofar_udp_io_read_config *const input, int8_t port);
+void _lofar_udp_io_read_cleanup_SHM(lofar_udp_io_read_config *const input, int8_t port);
 
 void _lofar_udp_io_write_cleanup_FILE(lofar_udp_io_write_config *const config, int8_t outp);
 void _lofar_udp_io_write_cleanup_ZSTD(lofar_udp_io_write_config *const config, int8_t outp, int8_t fullClean);
 void _lofar_udp_io_write_cleanup_DADA(lofar_udp_io_write_config *const config, int8_t outp, int8_t fullClean);
 void _lofar_udp_io_write_cleanup_HDF5(lofar_udp_io_write_config *const config, int8_t outp, int8_t fullClean);
+void _lofar_udp_io_write_cleanup_SHM(lofar_udp_io_write_config *const config, int8_t outp, int8_t fullClean);
 
 // Other functions
 void _swapCharPtr(char **a, char **b);
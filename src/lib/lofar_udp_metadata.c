@@ -70,6 +70,20 @@ int32_t lofar_udp_metadata_setup(lofar_udp_metadata *const metadata, const lofar
 			return -1;
 	}
 
+	// Size the per-port and per-output arrays for the reader (beamlets are indexed from the first port of the station)
+	int8_t allocPorts = DEFAULT_NUM_PORTS, allocOutputs = DEFAULT_NUM_OUTPUTS;
+	if (reader != NULL) {
+		if ((reader->input->offsetPortCount + reader->meta->numPorts) > allocPorts) {
+			allocPorts = (int8_t) (reader->input->offsetPortCount + reader->meta->numPorts);
+		}
+		if (reader->meta->numOutputs > allocOutputs) {
+			allocOutputs = reader->meta->numOutputs;
+		}
+	}
+	if (_lofar_udp_metadata_alloc_arrays(metadata, allocPorts, allocOutputs) < 0) {
+		return -1;
+	}
+
 	// Setup defaults
 	if (_lofar_udp_metdata_setup_BASE(metadata) < 0) {
 		fprintf(stderr, "ERROR %s: Failed to set default on metadata struct, exiting.\n", __func__);
@@ -326,6 +340,24 @@ lofar_udp_metadata_write_file(const lofar_udp_reader *reader, lofar_udp_io_write
 	return _lofar_udp_metadata_write_file_force(reader, outConfig, outp, metadata, headerBuffer, headerBufferSize, newObs, 0);
 }
 
+/**
+ * @brief Check if lofar_udp_metadata_write_file will write a header for this iteration, so that callers writing data in the
+ * 			background only need to flush their outputs before a header is written
+ *
+ * @param[in] metadata	The metadata struct
+ * @param[in] newObs	Handle update for a new observation / output
+ *
+ * @return 1: a header will be written, 0: no header will be written
+ */
+int8_t lofar_udp_metadata_write_pending(const lofar_udp_metadata *metadata, const int8_t newObs) {
+	if (metadata == NULL || metadata->type <= DEFAULT_META) {
+		return 0;
+	}
+
+	// GUPPI headers are written for every block, other headers only at the start of a file
+	return (int8_t) (metadata->type == GUPPI || newObs);
+}
+
 /**
  * @brief Perform a (optionally) forced header write, to an intermediate buffer than then an output file
  *
@@ -371,9 +403,9 @@ int32_t _lofar_udp_metdata_setup_BASE(lofar_udp_metadata *const metadata) {
 	}
 
 	// Reset all arrays
-	ARR_INIT(metadata->subbands, MAX_NUM_PORTS * UDPMAXBEAM, -1);
-	STR_INIT(metadata->rawfile, MAX_NUM_PORTS);
-	STR_INIT(metadata->upm_outputfmt, MAX_NUM_PORTS);
+	ARR_INIT(metadata->subbands, metadata->allocatedPorts * UDPMAXBEAM, -1);
+	STR_INIT(metadata->rawfile, metadata->allocatedPorts);
+	STR_INIT(metadata->upm_outputfmt, metadata->allocatedOutputs);
 
 	// Minimum samples that can be parsed by DSPSR per operation
 	// Not 100% sure what this is controlling, may need to vary based on processing mode
@@ -1082,10 +1114,12 @@ int32_t _lofar_udp_metadata_parse_subbands(lofar_udp_metadata *const metadata, c
 			return -1;
 	}
 
-	int16_t subbands[MAX_NUM_PORTS * UDPMAXBEAM] = { 0 };
-	int16_t beamlets[MAX_NUM_PORTS * UDPMAXBEAM] = { 0 };
-	ARR_INIT(subbands, MAX_NUM_PORTS * UDPMAXBEAM, -1);
-	ARR_INIT(beamlets, MAX_NUM_PORTS * UDPMAXBEAM, -1);
+	// The beamlet table scales with the number of allocated ports, keep it off the stack
+	const int32_t maxBeamlets = metadata->allocatedPorts * UDPMAXBEAM;
+	int16_t *subbands = calloc(2 * maxBeamlets, sizeof(int16_t));
+	CHECK_ALLOC_NOCLEAN(subbands, -1);
+	int16_t *beamlets = &(subbands[maxBeamlets]);
+	ARR_INIT(subbands, 2 * maxBeamlets, -1);
 
 	char *workingPtr = (char*) &(inputLine[0]), *tokenPtr;
 	char token[2] = " ";
@@ -1096,6 +1130,7 @@ int32_t _lofar_udp_metadata_parse_subbands(lofar_udp_metadata *const metadata, c
 	if (inputPtr == NULL) {
 		//__builtin_unreachable();
 		fprintf(stderr, "ERROR: Failed to find space in beamctl command, exiting.\n");
+		free(subbands);
 		return -1;
 	}
 
@@ -1106,6 +1141,7 @@ int32_t _lofar_udp_metadata_parse_subbands(lofar_udp_metadata *const metadata, c
 		if ((workingPtr = strstr(inputPtr, "--subbands=")) != NULL) {
 			VERBOSE(printf("Subbands detected\n"));
 			if ((subbandCount = _lofar_udp_metadata_parse_csv(workingPtr + strlen("--subbands="), subbands, &(results[1]), subbandOffset)) < 0) {
+				free(subbands);
 				return -1;
 			}
 
@@ -1113,6 +1149,7 @@ int32_t _lofar_udp_metadata_parse_subbands(lofar_udp_metadata *const metadata, c
 		} else if ((workingPtr = strstr(inputPtr, "--beamlets=")) != NULL) {
 			VERBOSE(printf("Beamlets detected\n"));
 			if ((beamletCount = _lofar_udp_metadata_parse_csv(workingPtr + strlen("--beamlets="), beamlets, &(results[5]), 0)) < 0) {
+				free(subbands);
 				return -1;
 			}
 
@@ -1124,11 +1161,12 @@ int32_t _lofar_udp_metadata_parse_subbands(lofar_udp_metadata *const metadata, c
 	// Sanity check parsed values
 	if (subbandCount != beamletCount) {
 		fprintf(stderr, "ERROR: Failed to parse matching numbers of both subbands and beamlets (%d/%d), exiting.\n", subbandCount, beamletCount);
+		free(subbands);
 		return -1;
 	}
 
-	if (subbandCount == 0 || subbandCount > MAX_NUM_PORTS * UDPMAXBEAM) {
-		fprintf(stderr, "WARNING: Failed to parse sane amount of beams (expected between 1 and %d, got %d).\n", MAX_NUM_PORTS * UDPMAXBEAM, subbandCount);
+	if (subbandCount == 0 || subbandCount > maxBeamlets) {
+		fprintf(stderr, "WARNING: Failed to parse sane amount of beams (expected between 1 and %d, got %d).\n", maxBeamlets, subbandCount);
 	}
 
 	// Add the parsed beams to the running total
@@ -1138,11 +1176,12 @@ int32_t _lofar_udp_metadata_parse_subbands(lofar_udp_metadata *const metadata, c
 	// Similarly no offset for mode 3, double the offset for mode 7, etc.
 	// This is why I raise an error when mixing mode 6 (160MHz clock) and anything else (all on the 200MHz clock)
 	for (int i = 0; i < metadata->upm_rawbeamlets; i++) {
-		if (beamlets[i] != -1) {
+		if (beamlets[i] > -1 && beamlets[i] < maxBeamlets) {
 			metadata->subbands[beamlets[i]] = (int16_t) (subbandOffset + subbands[i]);
 		}
 	}
 
+	free(subbands);
 	return 0;
 }
 
@@ -1563,7 +1602,7 @@ int32_t _lofar_udp_metadata_processing_mode_metadata(lofar_udp_metadata *const m
 	metadata->tsamp_raw = samplingTime;
 
 
-	for (int8_t i = 0; i < MAX_OUTPUT_DIMS; i++) {
+	for (int8_t i = 0; i < metadata->allocatedOutputs; i++) {
 		if (strncpy(metadata->upm_outputfmt[i], "", META_STR_LEN) != metadata->upm_outputfmt[i]) {
 			fprintf(stderr, "ERROR: Failed to reset upm_outputfmt_comment field %d, exiting.\n", i);
 			return -1;
@@ -1812,7 +1851,7 @@ int32_t _lofar_udp_metadata_processing_mode_metadata(lofar_udp_metadata *const m
 		case STOKES_U_TIME ... STOKES_U_DS16_TIME:
 		case STOKES_V_TIME ... STOKES_V_DS16_TIME:
 			metadata->upm_rel_outputs[0] = 1;
-			for (int8_t i = 1; i < MAX_OUTPUT_DIMS; i++) {
+			for (int8_t i = 1; i < metadata->allocatedOutputs; i++) {
 				metadata->upm_rel_outputs[i] = 0;
 			}
 			break;
@@ -1826,7 +1865,7 @@ int32_t _lofar_udp_metadata_processing_mode_metadata(lofar_udp_metadata *const m
 		case STOKES_IQUV ... STOKES_IQUV_DS16:
 		case STOKES_IQUV_REV ... STOKES_IQUV_DS16_REV:
 		case STOKES_IQUV_TIME ... STOKES_IQUV_DS16_TIME:
-			for (int8_t i = 0; i < MAX_OUTPUT_DIMS; i++) {
+			for (int8_t i = 0; i < metadata->allocatedOutputs; i++) {
 				metadata->upm_rel_outputs[i] = 1;
 			}
 			break;
@@ -1834,7 +1873,7 @@ int32_t _lofar_udp_metadata_processing_mode_metadata(lofar_udp_metadata *const m
 		// Split by antenna polarisation, but not real/complex
 		case TIME_MAJOR_ANT_POL:
 		case TIME_MAJOR_ANT_POL_FLOAT:
-			for (int8_t i = 0; i < MAX_OUTPUT_DIMS; i++) {
+			for (int8_t i = 0; i < metadata->allocatedOutputs; i++) {
 				if (i < 2) {
 					metadata->upm_rel_outputs[i] = 1;
 				} else {
@@ -1847,7 +1886,7 @@ int32_t _lofar_udp_metadata_processing_mode_metadata(lofar_udp_metadata *const m
 		case STOKES_IV ... STOKES_IV_DS16:
 		case STOKES_IV_REV ... STOKES_IV_DS16_REV:
 		case STOKES_IV_TIME ... STOKES_IV_DS16_TIME:
-			for (int8_t i = 0; i < MAX_OUTPUT_DIMS; i++) {
+			for (int8_t i = 0; i < metadata->allocatedOutputs; i++) {
 				if (i == 0 || i == 3) {
 					metadata->upm_rel_outputs[i] = 1;
 				} else {
@@ -167,7 +167,7 @@ void _lofar_udp_parse_header_extract_metadata(const int8_t port, lofar_udp_obs_m
  *
  * @return     0: Success, -1: Fatal error
  */
-int32_t _lofar_udp_parse_header_buffers(lofar_udp_obs_meta *meta, const int8_t header[4][16], const int16_t beamletLimits[2]) {
+int32_t _lofar_udp_parse_header_buffers(lofar_udp_obs_meta *meta, const int8_t header[][UDPHDRLEN], const int16_t beamletLimits[2]) {
 
 	float bitMul;
 	int8_t cacheBitMode = 0, cacheClockBit = 0;
@@ -249,7 +249,7 @@ int32_t _lofar_udp_parse_header_buffers(lofar_udp_obs_meta *meta, const int8_t h
  *
  * @return 0: Success, other: fatal error
  */
-int32_t _lofar_udp_setup_parse_headers(lofar_udp_config *config, lofar_udp_obs_meta *meta, int8_t inputHeaders[MAX_NUM_PORTS][UDPHDRLEN]) {
+int32_t _lofar_udp_setup_parse_headers(lofar_udp_config *config, lofar_udp_obs_meta *meta, int8_t inputHeaders[][UDPHDRLEN]) {
 	// This loop with be performed multiple times if the selected beamlets cause us to drop a port of data
 	int8_t updateBeamlets = (config->beamletLimits[0] > 0 || config->beamletLimits[1] > 0);
 	int16_t beamletLimits[2] = { 0, 0 };
@@ -368,16 +368,16 @@ int32_t _lofar_udp_setup_parse_headers(lofar_udp_config *config, lofar_udp_obs_m
 
 
 /**
- * @brief      If a target packet is set, search for it and align each port with
- *             the target packet as the first packet in the inputData arrays
+ * @brief      Search for the target packet and align each port with it, see _lofar_udp_skip_to_packet
  *
- * @param      reader  The lofar_udp_reader to process
+ * @param      reader       The lofar_udp_reader to process
+ * @param      packetShift  Working space for the shift needed on each port (numPorts entries)
  *
  * @return     0: Success, -1: Fatal error
  */
-int32_t _lofar_udp_skip_to_packet(lofar_udp_reader *reader) {
+static int32_t _lofar_udp_skip_to_packet_shift(lofar_udp_reader *reader, int64_t *packetShift) {
 	// This is going to be fun to document...
-	int64_t currentPacket, lastPacketOffset = 0, guessPacket = LONG_MAX, packetDelta, startOff, nextOff, endOff, packetShift[MAX_NUM_PORTS], nchars, returnLen;
+	int64_t currentPacket, lastPacketOffset = 0, guessPacket = LONG_MAX, packetDelta, startOff, nextOff, endOff, nchars, returnLen;
 	int32_t returnVal = 0;
 	int8_t scanning = 0;
 
@@ -521,7 +521,7 @@ int32_t _lofar_udp_skip_to_packet(lofar_udp_reader *reader) {
 
 		// Memory check: avoid segfaults during heavy packet loss, reset the currentPacket to be
 		//  the equivalent of the first packet for a perfect read with no loss
-		if ((reader->meta->lastPacket - currentPacket) > reader->meta->packetsPerIteration ||
+		if ((reader->meta->lastPacket - currentPacket) >= reader->meta->packetsPerIteration ||
 			(reader->meta->lastPacket - currentPacket) < 0) {
 			fprintf(stderr,
 					"WARNING: _lofar_udp_skip_to_packet just attempted to do an illegal memory access, resetting target packet to prevent it (%ld, %ld -> %ld).\n",
@@ -596,7 +596,7 @@ int32_t _lofar_udp_skip_to_packet(lofar_udp_reader *reader) {
 				nextOff = (startOff + endOff) / 2;
 
 				// Catch a weird edge case (I have no idea how this was happening, or how to reproduce it anymore)
-				if (nextOff > reader->meta->packetsPerIteration) {
+				if (nextOff >= reader->meta->packetsPerIteration) {
 					fprintf(stderr, "Error: Unable to converge on solution for first packet on port %d, exiting.\n",
 							port);
 					return -1;
@@ -645,6 +645,9 @@ int32_t _lofar_udp_skip_to_packet(lofar_udp_reader *reader) {
 				fprintf(stderr, "Unable to read enough data to fill first buffer (%ld/%ld), exiting.\n", returnLen, nchars);
 				return -1;
 			}
+		} else {
+			// Nothing was read, the shifted data ends at the current input offset
+			reader->input->lastReadOffset[port] = reader->input->streamOffset[port];
 		}
 
 
@@ -656,6 +659,364 @@ int32_t _lofar_udp_skip_to_packet(lofar_udp_reader *reader) {
 	return returnVal;
 }
 
+/**
+ * @brief      If a target packet is set, search for it and align each port with
+ *             the target packet as the first packet in the inputData arrays
+ *
+ * @param      reader  The lofar_udp_reader to process
+ *
+ * @return     0: Success, -1: Fatal error
+ */
+int32_t _lofar_udp_skip_to_packet(lofar_udp_reader *reader) {
+	// The number of ports is only known at runtime, so the per-port shifts are kept off the stack
+	int64_t *packetShift = calloc(reader->meta->numPorts, sizeof(int64_t));
+	CHECK_ALLOC_NOCLEAN(packetShift, -1);
+
+	const int32_t returnVal = _lofar_udp_skip_to_packet_shift(reader, packetShift);
+	free(packetShift);
+	return returnVal;
+}
+
+
+/**
+ * @brief      Use the packet index sidecars (if present on every port) to seek each input to the
+ *             last indexed packet at or before the target packet
+ *
+ * @param      reader        The lofar_udp_reader to seek
+ * @param[in]  targetPacket  The target packet number
+ *
+ * @return     1: Inputs seeked, 0: No usable index (inputs untouched), <0: Failure
+ */
+int32_t _lofar_udp_reader_index_seek(lofar_udp_reader *reader, const int64_t targetPacket) {
+	// Only seek if every port can be seeked, otherwise the ports will desynchronise
+	for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+		if (lofar_udp_index_find_entry(reader->input->packetIndex[port], targetPacket) < 0) {
+			return 0;
+		}
+	}
+
+	for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+		if (lofar_udp_io_read_seek_index(reader->input, port, targetPacket) != 1) {
+			fprintf(stderr, "ERROR %s: Failed to seek port %d to indexed packet near %ld, exiting.\n", __func__, port, targetPacket);
+			return -1;
+		}
+	}
+
+	VERBOSE(if (reader->meta->VERBOSE) { printf("%s: Seeked all ports to indexed packets near %ld\n", __func__, targetPacket); });
+	return 1;
+}
+
+
+/**
+ * @brief      Validate a checkpoint against a new reader, then seek each input back to the recorded offsets so that
+ *             the normal start-up scan finds the packet after the last processed packet
+ *
+ * @param      reader      The lofar_udp_reader to seek
+ * @param[in]  checkpoint  The checkpoint to resume from
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_reader_checkpoint_seek(lofar_udp_reader *reader, const lofar_udp_checkpoint *checkpoint) {
+	if (reader == NULL || checkpoint == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (reader: %p, checkpoint: %p), exiting.\n", __func__, reader, checkpoint);
+		return -1;
+	}
+
+	if (checkpoint->version != UPM_CHECKPOINT_VERSION || checkpoint->readerType != reader->input->readerType
+		|| checkpoint->numPorts != reader->meta->numPorts || checkpoint->processingMode != reader->meta->processingMode
+		|| checkpoint->replayDroppedPackets != reader->meta->replayDroppedPackets) {
+		fprintf(stderr, "ERROR %s: Checkpoint does not match the reader (version %d, reader %d/%d, ports %d/%d, mode %d/%d, replay %d/%d), exiting.\n", __func__,
+		        checkpoint->version, checkpoint->readerType, reader->input->readerType, checkpoint->numPorts, reader->meta->numPorts,
+		        checkpoint->processingMode, reader->meta->processingMode, checkpoint->replayDroppedPackets, reader->meta->replayDroppedPackets);
+		return -1;
+	}
+
+	if (checkpoint->lastPacket < LFREPOCH || checkpoint->packetsRead >= checkpoint->packetsReadMax) {
+		fprintf(stderr, "ERROR %s: Checkpoint has no data left to process (last packet %ld, %ld/%ld packets read), exiting.\n", __func__,
+		        checkpoint->lastPacket, checkpoint->packetsRead, checkpoint->packetsReadMax);
+		return -1;
+	}
+
+	for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+		const lofar_udp_checkpoint_port *portCheckpoint = &(checkpoint->ports[port]);
+		if (lofar_udp_io_read_seek(reader->input, port, portCheckpoint->byteOffset, portCheckpoint->frameOffset, portCheckpoint->frameDataOffset) < 0) {
+			fprintf(stderr, "ERROR %s: Failed to seek port %d to the checkpoint (byte %ld), exiting.\n", __func__, port, portCheckpoint->byteOffset);
+			return -1;
+		}
+	}
+
+	// Search for the packet after the last processed packet; the packet cap is restored once the buffers are aligned
+	reader->meta->lastPacket = checkpoint->lastPacket + 1;
+	reader->meta->packetsRead = 0;
+	reader->meta->packetsReadMax = LONG_MAX;
+
+	VERBOSE(if (reader->meta->VERBOSE) { printf("%s: Seeked all ports to the checkpoint, resuming at %ld\n", __func__, reader->meta->lastPacket); });
+	return 0;
+}
+
+/**
+ * @brief      Restore the counters of a checkpoint once a resumed reader has been aligned
+ *
+ * @param      reader      The lofar_udp_reader to update
+ * @param[in]  checkpoint  The checkpoint to resume from
+ */
+static void _lofar_udp_reader_checkpoint_restore(lofar_udp_reader *reader, const lofar_udp_checkpoint *checkpoint) {
+	reader->meta->packetsRead = checkpoint->packetsRead;
+	reader->meta->packetsReadMax = checkpoint->packetsReadMax;
+
+	// The first gulp is read during setup, shorten it if the job was about to finish
+	if ((checkpoint->packetsReadMax - checkpoint->packetsRead) < reader->meta->packetsPerIteration) {
+		reader->meta->packetsPerIteration = checkpoint->packetsReadMax - checkpoint->packetsRead;
+	}
+
+	for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+		reader->meta->portTotalDroppedPackets[port] = checkpoint->ports[port].totalDroppedPackets;
+	}
+	// The calibration step is not restored, Jones matrices are generated from the resumed packet during setup
+}
+
+/**
+ * @brief      Reset a checkpoint to the default, keeping any per-port / per-output arrays it already holds
+ *
+ * @param      checkpoint  The checkpoint to reset
+ */
+static void _lofar_udp_checkpoint_reset(lofar_udp_checkpoint *checkpoint) {
+	const lofar_udp_checkpoint arrays = *checkpoint;
+
+	// Copy the default with its padding, as the fixed fields are written to disk as-is
+	memcpy(checkpoint, &lofar_udp_checkpoint_default, sizeof(lofar_udp_checkpoint));
+	checkpoint->ports = arrays.ports;
+	checkpoint->outputOffset = arrays.outputOffset;
+	checkpoint->allocatedPorts = arrays.allocatedPorts;
+	checkpoint->allocatedOutputs = arrays.allocatedOutputs;
+}
+
+/**
+ * @brief      Record the progress of a reader (and optionally its writer) so that processing can be resumed from
+ *             the next packet with a new reader, see lofar_udp_config.resumeCheckpoint
+ *
+ * @param[in]  reader      The lofar_udp_reader to checkpoint, after a step has completed
+ * @param      outConfig   The writer used for the reader's output (NORMAL outputs are flushed), or NULL
+ * @param      checkpoint  The output checkpoint, initialised from lofar_udp_checkpoint_default (its arrays are grown as
+ *                         needed, and freed with lofar_udp_checkpoint_free_arrays)
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_reader_checkpoint(const lofar_udp_reader *reader, lofar_udp_io_write_config *outConfig, lofar_udp_checkpoint *checkpoint) {
+	if (reader == NULL || reader->input == NULL || reader->meta == NULL || checkpoint == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (reader: %p, checkpoint: %p), exiting.\n", __func__, reader, checkpoint);
+		return -1;
+	}
+
+	switch (reader->input->readerType) {
+		case NORMAL:
+		case NORMAL_MMAP:
+		case URING:
+		case ZSTDCOMPRESSED:
+		case ZSTDCOMPRESSED_INDIRECT:
+			break;
+
+		default:
+			fprintf(stderr, "ERROR %s: Reader %d cannot be seeked, so cannot be resumed from a checkpoint, exiting.\n", __func__, reader->input->readerType);
+			return -1;
+	}
+
+	_lofar_udp_checkpoint_reset(checkpoint);
+	checkpoint->version = UPM_CHECKPOINT_VERSION;
+	checkpoint->readerType = reader->input->readerType;
+	checkpoint->processingMode = reader->meta->processingMode;
+	checkpoint->numPorts = reader->meta->numPorts;
+	checkpoint->numOutputs = reader->meta->numOutputs;
+	checkpoint->replayDroppedPackets = reader->meta->replayDroppedPackets;
+
+	checkpoint->calibrationStep = reader->meta->calibrationStep;
+	checkpoint->packetsPerIteration = reader->packetsPerIteration;
+	checkpoint->lastPacket = reader->meta->lastPacket;
+	checkpoint->packetsRead = reader->meta->packetsRead;
+	checkpoint->packetsReadMax = reader->meta->packetsReadMax;
+
+	if (lofar_udp_checkpoint_alloc_ports(checkpoint, checkpoint->numPorts) < 0 || lofar_udp_checkpoint_alloc_outputs(checkpoint, checkpoint->numOutputs) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to allocate checkpoint for %d ports / %d outputs, exiting.\n", __func__, checkpoint->numPorts, checkpoint->numOutputs);
+		return -1;
+	}
+
+	for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+		lofar_udp_checkpoint_port *portCheckpoint = &(checkpoint->ports[port]);
+		portCheckpoint->frameOffset = -1;
+		portCheckpoint->frameDataOffset = -1;
+
+		// The last read filled the buffer after the packets carried over from the previous gulp, so the start of the
+		// buffer is always at or before the next packet to process
+		portCheckpoint->byteOffset = reader->input->lastReadOffset[port] - reader->meta->inputDataOffset[port];
+		portCheckpoint->totalDroppedPackets = reader->meta->portTotalDroppedPackets[port];
+		if (portCheckpoint->byteOffset < 0) {
+			fprintf(stderr, "ERROR %s: Failed to determine the input offset on port %d (%ld), exiting.\n", __func__, port, portCheckpoint->byteOffset);
+			return -1;
+		}
+
+		if (reader->input->readerType == ZSTDCOMPRESSED || reader->input->readerType == ZSTDCOMPRESSED_INDIRECT) {
+			lofar_udp_io_zstd_anchor anchor;
+			const int32_t anchorFound = _lofar_udp_io_read_ZSTD_find_anchor(reader->input, port, portCheckpoint->byteOffset, &anchor);
+			if (anchorFound < 0) {
+				return -1;
+			} else if (anchorFound == 0) {
+				fprintf(stderr, "WARNING %s: No recent frame found for port %d, resuming will decompress from the start of the input.\n", __func__, port);
+			}
+			portCheckpoint->frameOffset = anchor.frameOffset;
+			portCheckpoint->frameDataOffset = anchor.frameDataOffset;
+		}
+	}
+
+	ARR_INIT(checkpoint->outputOffset, checkpoint->allocatedOutputs, -1);
+
+	if (outConfig != NULL) {
+		checkpoint->outputFirstPacket = outConfig->firstPacket;
+
+		// Only plain files can be truncated back to the checkpoint, other outputs are left as not resumable
+		if (outConfig->readerType == NORMAL) {
+			for (int8_t outp = 0; outp < outConfig->numOutputs; outp++) {
+				if (outConfig->outputFiles[outp] == NULL) {
+					continue;
+				}
+
+				if (fflush(outConfig->outputFiles[outp]) != 0 || (checkpoint->outputOffset[outp] = ftello(outConfig->outputFiles[outp])) < 0) {
+					fprintf(stderr, "ERROR %s: Failed to determine the length of output %d (errno %d: %s), exiting.\n", __func__, outp, errno, strerror(errno));
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Checkpoint a reader (and optionally its writer) to a file
+ *
+ * @param[in]  reader              The lofar_udp_reader to checkpoint
+ * @param      outConfig           The writer used for the reader's output, or NULL
+ * @param[in]  checkpointLocation  The checkpoint file location
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_reader_checkpoint_write(const lofar_udp_reader *reader, lofar_udp_io_write_config *outConfig, const char checkpointLocation[]) {
+	lofar_udp_checkpoint checkpoint = lofar_udp_checkpoint_default;
+	int32_t returnVal = lofar_udp_reader_checkpoint(reader, outConfig, &checkpoint);
+	if (returnVal == 0) {
+		returnVal = lofar_udp_checkpoint_write(&checkpoint, checkpointLocation);
+	}
+
+	lofar_udp_checkpoint_free_arrays(&checkpoint);
+	return returnVal;
+}
+
+/**
+ * @brief      Write a checkpoint to disk, replacing any previous checkpoint at the location in a single step
+ *
+ * @param[in]  checkpoint          The checkpoint
+ * @param[in]  checkpointLocation  The checkpoint file location
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_checkpoint_write(const lofar_udp_checkpoint *checkpoint, const char checkpointLocation[]) {
+	if (checkpoint == NULL || checkpointLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (checkpoint: %p, checkpointLocation: %p), exiting.\n", __func__, checkpoint, checkpointLocation);
+		return -1;
+	}
+
+	char tmpLocation[DEF_STR_LEN + 8];
+	if (snprintf(tmpLocation, DEF_STR_LEN + 8, "%s.tmp", checkpointLocation) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to build temporary checkpoint location, exiting.\n", __func__);
+		return -1;
+	}
+
+	FILE *checkpointFile = fopen(tmpLocation, "wb");
+	if (checkpointFile == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to open %s for writing (errno %d: %s), exiting.\n", __func__, tmpLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	// The fixed fields are stored as-is, followed by the entries for the ports and outputs in use
+	const char magic[UPM_CHECKPOINT_MAGIC_LEN] = UPM_CHECKPOINT_MAGIC;
+	if (checkpoint->numPorts < 1 || checkpoint->numOutputs < 0
+		|| fwrite(magic, sizeof(char), UPM_CHECKPOINT_MAGIC_LEN, checkpointFile) != UPM_CHECKPOINT_MAGIC_LEN
+		|| fwrite(checkpoint, offsetof(lofar_udp_checkpoint, ports), 1, checkpointFile) != 1
+		|| fwrite(checkpoint->ports, sizeof(lofar_udp_checkpoint_port), checkpoint->numPorts, checkpointFile) != (size_t) checkpoint->numPorts
+		|| fwrite(checkpoint->outputOffset, sizeof(int64_t), checkpoint->numOutputs, checkpointFile) != (size_t) checkpoint->numOutputs) {
+		fprintf(stderr, "ERROR %s: Failed to write checkpoint to %s, exiting.\n", __func__, tmpLocation);
+		fclose(checkpointFile);
+		remove(tmpLocation);
+		return -1;
+	}
+
+	// The previous checkpoint must remain valid until the new one is on disk
+	if (fflush(checkpointFile) || fsync(fileno(checkpointFile)) || fclose(checkpointFile) || rename(tmpLocation, checkpointLocation)) {
+		fprintf(stderr, "ERROR %s: Failed to finalise checkpoint at %s (errno %d: %s), exiting.\n", __func__, checkpointLocation, errno, strerror(errno));
+		remove(tmpLocation);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Load a checkpoint from disk
+ *
+ * @param      checkpoint          The output checkpoint, initialised from lofar_udp_checkpoint_default (its arrays are
+ *                                 grown as needed, and freed with lofar_udp_checkpoint_free_arrays)
+ * @param[in]  checkpointLocation  The checkpoint file location
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_checkpoint_load(lofar_udp_checkpoint *checkpoint, const char checkpointLocation[]) {
+	if (checkpoint == NULL || checkpointLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (checkpoint: %p, checkpointLocation: %p), exiting.\n", __func__, checkpoint, checkpointLocation);
+		return -1;
+	}
+
+	FILE *checkpointFile = fopen(checkpointLocation, "rb");
+	if (checkpointFile == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to open checkpoint at %s (errno %d: %s), exiting.\n", __func__, checkpointLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	// Only the entries for the ports and outputs in use are stored after the fixed fields
+	_lofar_udp_checkpoint_reset(checkpoint);
+	const int64_t checkpointSize = _FILE_file_size(checkpointFile);
+	char magic[UPM_CHECKPOINT_MAGIC_LEN];
+	if (fread(magic, sizeof(char), UPM_CHECKPOINT_MAGIC_LEN, checkpointFile) != UPM_CHECKPOINT_MAGIC_LEN
+		|| strncmp(magic, UPM_CHECKPOINT_MAGIC, UPM_CHECKPOINT_MAGIC_LEN) != 0
+		|| fread(checkpoint, offsetof(lofar_udp_checkpoint, ports), 1, checkpointFile) != 1) {
+		fprintf(stderr, "ERROR %s: %s does not appear to be a checkpoint for this build, exiting.\n", __func__, checkpointLocation);
+		fclose(checkpointFile);
+		return -1;
+	}
+
+	if (checkpoint->version != UPM_CHECKPOINT_VERSION || checkpoint->numPorts < 1 || checkpoint->numOutputs < 0
+		|| checkpointSize != (int64_t) (UPM_CHECKPOINT_MAGIC_LEN + offsetof(lofar_udp_checkpoint, ports)
+		                                 + checkpoint->numPorts * sizeof(lofar_udp_checkpoint_port) + checkpoint->numOutputs * sizeof(int64_t))) {
+		fprintf(stderr, "ERROR %s: Checkpoint at %s is an unsupported version (%d) or corrupted, exiting.\n", __func__, checkpointLocation, checkpoint->version);
+		fclose(checkpointFile);
+		return -1;
+	}
+
+	if (lofar_udp_checkpoint_alloc_ports(checkpoint, checkpoint->numPorts) < 0 || lofar_udp_checkpoint_alloc_outputs(checkpoint, checkpoint->numOutputs) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to allocate checkpoint for %d ports / %d outputs, exiting.\n", __func__, checkpoint->numPorts, checkpoint->numOutputs);
+		fclose(checkpointFile);
+		return -1;
+	}
+
+	if (fread(checkpoint->ports, sizeof(lofar_udp_checkpoint_port), checkpoint->numPorts, checkpointFile) != (size_t) checkpoint->numPorts
+		|| fread(checkpoint->outputOffset, sizeof(int64_t), checkpoint->numOutputs, checkpointFile) != (size_t) checkpoint->numOutputs) {
+		fprintf(stderr, "ERROR %s: Failed to read checkpoint entries from %s, exiting.\n", __func__, checkpointLocation);
+		fclose(checkpointFile);
+		return -1;
+	}
+	fclose(checkpointFile);
+
+	return 0;
+}
+
 
 /**
  * @brief      Re-use a reader on the same input files but targeting a later
@@ -688,7 +1049,9 @@ int32_t lofar_udp_file_reader_reuse(lofar_udp_reader *reader, const int64_t star
 	reader->meta->packetsReadMax = startingPacket - reader->meta->lastPacket + 2 * reader->packetsPerIteration;
 	reader->meta->lastPacket = startingPacket;
 	// Ensure we are always recalculating the Jones matrix on reader re-use
-	reader->meta->calibrationStep = reader->calibration->calibrationStepsGenerated + 1;
+	if (reader->calibration != NULL) {
+		reader->meta->calibrationStep = reader->calibration->calibrationStepsGenerated + 1;
+	}
 
 	for (int8_t port = 0; port < reader->meta->numPorts; port++) {
 		reader->meta->inputDataOffset[port] = 0;
@@ -705,6 +1068,19 @@ int32_t lofar_udp_file_reader_reuse(lofar_udp_reader *reader, const int64_t star
 	// Setup to search for the next starting packet
 	reader->meta->inputDataReady = 0;
 	if (reader->meta->lastPacket > LFREPOCH) {
+		// If every port is indexed, jump close to the target and refill the buffers from there rather than scanning
+		returnVal = _lofar_udp_reader_index_seek(reader, reader->meta->lastPacket);
+		if (returnVal < 0) {
+			return returnVal;
+		} else if (returnVal == 1) {
+			reader->meta->packetsReadMax = LONG_MAX;
+			returnVal = _lofar_udp_reader_internal_read_step(reader);
+			if (returnVal == -1 || returnVal == 1) {
+				fprintf(stderr, "ERROR %s: Failed to read data after seeking to indexed packet, exiting.\n", __func__);
+				return -1;
+			}
+		}
+
 		returnVal = _lofar_udp_skip_to_packet(reader);
 		if (returnVal < 0) {
 			return -1 * returnVal;
@@ -724,6 +1100,220 @@ int32_t lofar_udp_file_reader_reuse(lofar_udp_reader *reader, const int64_t star
 	return returnVal;
 }
 
+/**
+ * @brief      Order event rows ({start, end, index}) by their start, then end packets
+ */
+static int _lofar_udp_reader_events_compare(const void *a, const void *b) {
+	const int64_t *eventA = (const int64_t *) a, *eventB = (const int64_t *) b;
+	for (int8_t field = 0; field < 3; field++) {
+		if (eventA[field] != eventB[field]) {
+			return eventA[field] < eventB[field] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief      Sort a list of events by their starting packet, and merge overlapping or touching events into spans that
+ *             can each be processed in a single pass of the reader
+ *
+ * @param[in]  events          The requested events
+ * @param[in]  numEvents       The number of events
+ * @param[out] order           [numEvents] The event indices, sorted by starting packet
+ * @param[out] spans           [numEvents] The merged windows to process
+ * @param[out] spanFirstEvent  [numEvents + 1] The offset in order of the first event in each span (and a terminating offset)
+ *
+ * @return     >0: Number of spans, <0: Failure
+ */
+int64_t _lofar_udp_reader_events_schedule(const lofar_udp_event events[], const int64_t numEvents, int64_t order[], lofar_udp_event spans[], int64_t spanFirstEvent[]) {
+	if (events == NULL || order == NULL || spans == NULL || spanFirstEvent == NULL || numEvents < 1) {
+		fprintf(stderr, "ERROR %s: Invalid inputs (events %p, order %p, spans %p, firsts %p, count %ld), exiting.\n", __func__, events, order, spans, spanFirstEvent, numEvents);
+		return -1;
+	}
+
+	int64_t (*rows)[3] = calloc(numEvents, sizeof(int64_t[3]));
+	CHECK_ALLOC_NOCLEAN(rows, -1);
+	for (int64_t event = 0; event < numEvents; event++) {
+		if (events[event].startingPacket < 0 || events[event].packetsReadMax < 1 || events[event].startingPacket > (LONG_MAX - events[event].packetsReadMax)) {
+			fprintf(stderr, "ERROR %s: Event %ld has an invalid window (start %ld, length %ld), exiting.\n", __func__, event, events[event].startingPacket, events[event].packetsReadMax);
+			free(rows);
+			return -1;
+		}
+		rows[event][0] = events[event].startingPacket;
+		rows[event][1] = events[event].startingPacket + events[event].packetsReadMax;
+		rows[event][2] = event;
+	}
+	qsort(rows, numEvents, sizeof(int64_t[3]), _lofar_udp_reader_events_compare);
+
+	int64_t numSpans = 0, spanEnd = LONG_MIN;
+	for (int64_t event = 0; event < numEvents; event++) {
+		order[event] = rows[event][2];
+		// Start a new span if the event does not overlap the current one
+		if (rows[event][0] > spanEnd) {
+			spans[numSpans].startingPacket = rows[event][0];
+			spanFirstEvent[numSpans] = event;
+			numSpans++;
+			spanEnd = rows[event][1];
+		} else if (rows[event][1] > spanEnd) {
+			spanEnd = rows[event][1];
+		}
+		spans[numSpans - 1].packetsReadMax = spanEnd - spans[numSpans - 1].startingPacket;
+	}
+	spanFirstEvent[numSpans] = numEvents;
+
+	free(rows);
+	return numSpans;
+}
+
+/**
+ * @brief      Extract a batch of events in a single pass over the input. Events are sorted and merged, the reader seeks
+ *             forwards to each merged window in turn, and only processes the packets within the windows. After each step,
+ *             the callback is given the slice of every event that is held in the output buffers.
+ *
+ *             Slices are given in packets; the data of a slice is contiguous in the output buffers for packet and
+ *             frequency-major processing modes.
+ *
+ * @param      reader     The lofar_udp_reader to process with
+ * @param[in]  events     The events to extract, in any order
+ * @param[in]  numEvents  The number of events
+ * @param[in]  callback   Function called for each event slice, a negative return stops processing
+ * @param      userData   Passed through to the callback
+ *
+ * @return     >=0: Number of events fully processed, <0: Failure
+ */
+int64_t lofar_udp_reader_events_process(lofar_udp_reader *reader, const lofar_udp_event events[], const int64_t numEvents, lofar_udp_event_callback callback, void *userData) {
+	if (reader == NULL || reader->meta == NULL || callback == NULL) {
+		fprintf(stderr, "ERROR %s: Invalid inputs (reader %p, callback %p), exiting.\n", __func__, reader, callback);
+		return -1;
+	}
+
+	if (reader->meta->dataOrder == TIME_MAJOR) {
+		fprintf(stderr, "ERROR %s: Events cannot be extracted from time-major processing modes (%d), as packets are not contiguous in the output, exiting.\n", __func__, reader->meta->processingMode);
+		return -1;
+	}
+
+	if (numEvents < 1) {
+		return 0;
+	}
+
+	// Single workspace for the sorted order, spans, span offsets and event states (0: pending, 1: started, 2: finished)
+	int64_t *order = calloc((4 * numEvents + 1) * sizeof(int64_t) + numEvents * sizeof(int8_t), 1);
+	CHECK_ALLOC_NOCLEAN(order, -1);
+	lofar_udp_event *spans = (lofar_udp_event *) &(order[numEvents]);
+	int64_t *spanFirstEvent = &(order[3 * numEvents]);
+	int8_t *eventState = (int8_t *) &(order[4 * numEvents + 1]);
+	int64_t returnVal = 0;
+
+	const int64_t numSpans = _lofar_udp_reader_events_schedule(events, numEvents, order, spans, spanFirstEvent);
+	if (numSpans < 0) {
+		free(order);
+		return -1;
+	}
+
+	// Events are handed out from the earliest unfinished event, as the last gulp of a window may also hold the start of the next
+	int64_t firstPending = 0;
+	int8_t endOfData = 0;
+	for (int64_t span = 0; span < numSpans && !endOfData; span++) {
+		// Windows that start before the current position (earlier than the input, or already processed) are trimmed
+		int64_t spanStart = spans[span].startingPacket;
+		const int64_t spanEnd = spans[span].startingPacket + spans[span].packetsReadMax;
+		const int64_t nextPacket = reader->meta->lastPacket + 1;
+		if (spanEnd <= nextPacket) {
+			continue;
+		} else if (spanStart < nextPacket) {
+			spanStart = nextPacket;
+		}
+
+		VERBOSE(if (reader->meta->VERBOSE) { printf("%s: processing window %ld/%ld (%ld -> %ld, %ld events)\n", __func__, span, numSpans, spanStart, spanEnd, spanFirstEvent[span + 1] - spanFirstEvent[span]); });
+
+		// Seek forwards to the window, this only reads the data between windows. The window end is handled here rather than
+		// through packetsReadMax, so that every gulp is full and the buffers remain valid for the next seek.
+		const int32_t reuseReturn = lofar_udp_file_reader_reuse(reader, spanStart, LONG_MAX);
+		if (reuseReturn < 0) {
+			free(order);
+			return -1;
+		} else if (reuseReturn > 0) {
+			fprintf(stderr, "WARNING %s: Failed to seek to packet %ld (%d), stopping event processing.\n", __func__, spanStart, reuseReturn);
+			break;
+		}
+
+		int32_t stepReturn;
+		int64_t gulpEnd;
+		do {
+			const int64_t gulpStart = reader->meta->lastPacket + 1;
+			if ((stepReturn = lofar_udp_reader_step(reader)) > 0) {
+				endOfData = 1;
+				break;
+			}
+			gulpEnd = gulpStart + reader->meta->packetsPerIteration;
+
+			for (int64_t idx = firstPending; idx < numEvents && events[order[idx]].startingPacket < gulpEnd; idx++) {
+				const int64_t event = order[idx];
+				const int64_t eventEnd = events[event].startingPacket + events[event].packetsReadMax;
+				if (eventState[event] == 2 || eventEnd <= gulpStart) {
+					if (idx == firstPending) {
+						firstPending++;
+					}
+					continue;
+				}
+
+				const int64_t sliceStart = events[event].startingPacket > gulpStart ? events[event].startingPacket : gulpStart;
+				const int64_t sliceEnd = eventEnd < gulpEnd ? eventEnd : gulpEnd;
+				const lofar_udp_event_slice slice = {
+					.eventIdx = event,
+					.packetNumber = sliceStart,
+					.outputPacketOffset = sliceStart - gulpStart,
+					.numPackets = sliceEnd - sliceStart,
+					.firstSlice = eventState[event] == 0,
+					.lastSlice = sliceEnd == eventEnd
+				};
+				if (callback(reader, &slice, userData) < 0) {
+					fprintf(stderr, "ERROR %s: Event callback failed for event %ld, exiting.\n", __func__, event);
+					free(order);
+					return -1;
+				}
+
+				eventState[event] = slice.lastSlice ? 2 : 1;
+				returnVal += slice.lastSlice;
+			}
+
+		// Values below -1 indicate the end of the input
+		} while (stepReturn > -2 && gulpEnd < spanEnd);
+
+		if (stepReturn < -1) {
+			endOfData = 1;
+		}
+	}
+
+	// Close out any events that were interrupted by the end of the input
+	int64_t missedEvents = 0;
+	for (int64_t event = 0; event < numEvents; event++) {
+		missedEvents += (eventState[event] == 0);
+		if (eventState[event] == 1) {
+			const lofar_udp_event_slice slice = {
+				.eventIdx = event,
+				.packetNumber = reader->meta->lastPacket + 1,
+				.outputPacketOffset = 0,
+				.numPackets = 0,
+				.firstSlice = 0,
+				.lastSlice = 1
+			};
+			if (callback(reader, &slice, userData) < 0) {
+				fprintf(stderr, "ERROR %s: Event callback failed for event %ld, exiting.\n", __func__, event);
+				free(order);
+				return -1;
+			}
+		}
+	}
+
+	if (missedEvents) {
+		fprintf(stderr, "WARNING %s: %ld events were outside of the input data and have been skipped.\n", __func__, missedEvents);
+	}
+
+	free(order);
+	return returnVal;
+}
+
 
 /**
  * @brief      Set the processing function. output length per packet based on
@@ -892,6 +1482,11 @@ int32_t _lofar_udp_setup_processing(lofar_udp_obs_meta *meta) {
 			return -1;
 	}
 
+	// Size the per-output arrays for the processing mode
+	if (_lofar_udp_obs_meta_alloc_outputs(meta, meta->numOutputs) < 0) {
+		return -1;
+	}
+
 	// If we are calibrating the data, the output bit mode is always 32, for floats.
 	if (meta->calibrateData == APPLY_CALIBRATION) {
 		meta->outputBitMode = 32;
@@ -933,8 +1528,9 @@ int32_t _lofar_udp_setup_processing_output_buffers(lofar_udp_obs_meta *meta) {
 
 		meta->outputData[out] = calloc((int64_t) meta->packetOutputLength[out] * meta->packetsPerIteration, sizeof(int8_t));
 		CHECK_ALLOC(meta->outputData[out], -1,
-		            for (int8_t i = 0; i < out; i++) {free(meta->outputData[i]); }
+		            for (int8_t i = 0; i < out; i++) {free(meta->outputData[i]); meta->outputDataBuffers[i] = NULL; }
 		);
+		meta->outputDataBuffers[out] = meta->outputData[out];
 
 		VERBOSE(if (meta->VERBOSE) {
 			printf("calloc at %p for %ld bytes\n", meta->outputData[out],
@@ -954,17 +1550,30 @@ int32_t _lofar_udp_setup_processing_output_buffers(lofar_udp_obs_meta *meta) {
  */
 int32_t _lofar_udp_reader_config_check(const lofar_udp_config *config) {
 
-	if (config->numPorts > MAX_NUM_PORTS || config->numPorts < 1) {
-		fprintf(stderr, "ERROR: You requested %d ports, but LOFAR can only produce between 1 and %d, exiting.\n", config->numPorts,
-				MAX_NUM_PORTS);
+	if (config->numPorts < 1 || (config->numPorts + config->offsetPortCount) > INT8_MAX) {
+		fprintf(stderr, "ERROR: You requested %d ports after an offset of %d, but only ports 1 to %d can be indexed, exiting.\n", config->numPorts,
+				config->offsetPortCount, INT8_MAX);
 		return -1;
 	}
 
+	if (config->numPorts > config->allocatedPorts) {
+		fprintf(stderr, "ERROR: You requested %d ports, but the configuration only holds %d (see lofar_udp_config_alloc_ports), exiting.\n", config->numPorts,
+				config->allocatedPorts);
+		return -1;
+	}
+
+	if (config->readerType == HDF5) {
+		fprintf(stderr, "ERROR: HDF5 inputs contain processed data rather than raw packets, read them with lofar_udp_io_read instead, exiting.\n");
+		return -1;
+	}
+
+	char inputFile[DEF_STR_LEN + 1];
 	for (int8_t port = 0; port < config->numPorts; port++) {
 		if (!strlen(config->inputLocations[port])) {
 			fprintf(stderr, "ERROR: You requested %d ports, but port %d is an empty string, exiting.\n", config->numPorts, port);
 			return -1;
-		} else if (access(config->inputLocations[port], F_OK) != 0) {
+		} else if (config->readerType != UDP && config->readerType != PCAP && config->readerType != SHM &&
+		           (_lofar_udp_io_read_FILE_list_first(inputFile, config->inputLocations[port], config->readerType) < 0 || access(inputFile, F_OK) != 0)) {
 			fprintf(stderr, "ERROR: Failed to open file at %s (port %d), exiting.\n", config->inputLocations[port], port);
 			return -1;
 		}
@@ -1018,6 +1627,11 @@ int32_t _lofar_udp_reader_config_check(const lofar_udp_config *config) {
 		return -1;
 	}
 
+	if (config->endPacket > 0 && config->endPacket <= config->startingPacket) {
+		fprintf(stderr, "ERROR: End packet is not after the start packet (%ld vs %ld), exiting.\n", config->endPacket, config->startingPacket);
+		return -1;
+	}
+
 	if ((2 * config->ompThreads) < config->numPorts) {
 		if (config->ompThreads > 1) {
 			fprintf(stderr, "WARNING: You have requested less threads than advised (2* number of ports), this might be a slow run (%d threads, %d ports).\n", config->ompThreads, config->numPorts);
@@ -1076,6 +1690,11 @@ lofar_udp_obs_meta* _lofar_udp_configure_obs_meta(const lofar_udp_config *config
 	lofar_udp_obs_meta *meta = _lofar_udp_obs_meta_alloc();
 	CHECK_ALLOC_NOCLEAN(meta, NULL);
 
+	if (_lofar_udp_obs_meta_alloc_ports(meta, config->numPorts) < 0) {
+		_lofar_udp_obs_meta_cleanup(meta);
+		return NULL;
+	}
+
 	// Set the simple metadata defaults
 	meta->numPorts = config->numPorts;
 	meta->replayDroppedPackets = config->replayDroppedPackets;
@@ -1119,13 +1738,15 @@ lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config) {
 	#endif
 
 	// Scan in the first header on each port
-	int8_t inputHeaders[MAX_NUM_PORTS][UDPHDRLEN];
+	int8_t (*inputHeaders)[UDPHDRLEN] = calloc(meta->numPorts, sizeof(*inputHeaders));
+	CHECK_ALLOC(inputHeaders, NULL, _lofar_udp_obs_meta_cleanup(meta););
 	int64_t readlen;
 	for (int8_t port = 0; port < meta->numPorts; port++) {
 		readlen = lofar_udp_io_read_temp(config, port, &(inputHeaders[port][0]), sizeof(int8_t), UDPHDRLEN, 1);
 		if (readlen != UDPHDRLEN) {
 			fprintf(stderr, "Unable to read header on port %d, exiting.\n", port);
-			FREE_NOT_NULL(meta);
+			free(inputHeaders);
+			_lofar_udp_obs_meta_cleanup(meta);
 			return NULL;
 		}
 	}
@@ -1133,19 +1754,21 @@ lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config) {
 	// Parse the input file headers to get packet metadata on each port
 	if (_lofar_udp_setup_parse_headers(config, meta, inputHeaders) < 0) {
 		fprintf(stderr, "Unable to parse input headers, exiting.\n");
-		FREE_NOT_NULL(meta);
+		free(inputHeaders);
+		_lofar_udp_obs_meta_cleanup(meta);
 		return NULL;
 	}
+	free(inputHeaders);
 
 	if (_lofar_udp_setup_processing(meta)) {
 		fprintf(stderr, "Unable to setup processing mode %d, exiting.\n", config->processingMode);
-		FREE_NOT_NULL(meta);
+		_lofar_udp_obs_meta_cleanup(meta);
 		return NULL;
 	}
 
 	if (_lofar_udp_setup_processing_output_buffers(meta) < 0) {
 		fprintf(stderr, "Unable to setup processing buffers, exiting.\n");
-		FREE_NOT_NULL(meta);
+		_lofar_udp_obs_meta_cleanup(meta);
 		return NULL;
 	}
 
@@ -1173,7 +1796,7 @@ lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config) {
 
 	// Allocate the structs and configure them
 	lofar_udp_reader *reader = _lofar_udp_reader_alloc(meta);
-	CHECK_ALLOC(reader, NULL, FREE_NOT_NULL(meta););
+	CHECK_ALLOC(reader, NULL, _lofar_udp_obs_meta_cleanup(meta););
 
 	// Initialise the reader struct from config
 	reader->input->readerType = config->readerType;
@@ -1182,8 +1805,13 @@ lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config) {
 	reader->ompThreads = config->ompThreads;
 	omp_set_num_threads(reader->ompThreads);
 
-	if ((meta->numPorts + config->offsetPortCount) > 4) {
-		fprintf(stderr, "ERROR: Requested data beyond the 4th port. Either your offset (%d) or number of ports requested (%d) was too high, exiting.\n", config->offsetPortCount, meta->numPorts);
+	if ((meta->numPorts + config->offsetPortCount) > INT8_MAX) {
+		fprintf(stderr, "ERROR: Requested data beyond port %d. Either your offset (%d) or number of ports requested (%d) was too high, exiting.\n", INT8_MAX, config->offsetPortCount, meta->numPorts);
+		lofar_udp_reader_cleanup(reader);
+		return NULL;
+	}
+
+	if (lofar_udp_io_read_alloc_ports(reader->input, meta->numPorts) < 0) {
 		lofar_udp_reader_cleanup(reader);
 		return NULL;
 	}
@@ -1194,6 +1822,12 @@ lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config) {
 			lofar_udp_reader_cleanup(reader);
 			return NULL;
 		}
+
+		// Attach a packet index if one was generated for the input
+		if (lofar_udp_io_read_index_load(reader->input, port, meta->portPacketLength[port]) < 0) {
+			lofar_udp_reader_cleanup(reader);
+			return NULL;
+		}
 	}
 
 	if (config->metadata_config.metadataType != NO_META) {
@@ -1211,6 +1845,24 @@ lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config) {
 		}
 	}
 
+	// If we are resuming from a checkpoint, seek back to it. Otherwise, if we have been given a starting packet and
+	// every port is indexed, jump close to it before the first read
+	if (config->resumeCheckpoint != NULL) {
+		if (_lofar_udp_reader_checkpoint_seek(reader, config->resumeCheckpoint) < 0) {
+			lofar_udp_reader_cleanup(reader);
+			return NULL;
+		}
+	} else if (reader->meta->lastPacket > LFREPOCH && _lofar_udp_reader_index_seek(reader, reader->meta->lastPacket) < 0) {
+		lofar_udp_reader_cleanup(reader);
+		return NULL;
+	}
+
+	// Apply the packet cap once the first gulp is aligned, otherwise caps of a single gulp stop the initial read and search early
+	const int64_t packetsReadMax = reader->meta->packetsReadMax;
+	if (config->resumeCheckpoint == NULL) {
+		reader->meta->packetsReadMax = LONG_MAX;
+	}
+
 	// Gulp the first set of raw data
 	if (_lofar_udp_reader_internal_read_step(reader) < 0) {
 		lofar_udp_reader_cleanup(reader);
@@ -1262,6 +1914,27 @@ lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config) {
 		return NULL;
 	}
 
+	if (config->resumeCheckpoint != NULL) {
+		_lofar_udp_reader_checkpoint_restore(reader, config->resumeCheckpoint);
+	} else {
+		reader->meta->packetsReadMax = packetsReadMax;
+
+		// If the start packet was lost, the search above moves the start later; an end packet stops us reading past the requested range
+		if (config->endPacket > 0) {
+			const int64_t packetsToEnd = config->endPacket - (reader->meta->lastPacket + 1);
+			if (packetsToEnd < 1) {
+				fprintf(stderr, "ERROR: First packet found (%ld) is beyond the requested end packet (%ld), exiting.\n", reader->meta->lastPacket + 1, config->endPacket);
+				lofar_udp_reader_cleanup(reader);
+				return NULL;
+			}
+			reader->meta->packetsReadMax = packetsToEnd < reader->meta->packetsReadMax ? packetsToEnd : reader->meta->packetsReadMax;
+		}
+
+		if (reader->meta->packetsReadMax < reader->meta->packetsPerIteration) {
+			reader->meta->packetsPerIteration = reader->meta->packetsReadMax;
+		}
+	}
+
 	if (config->calibrateData > NO_CALIBRATION) {
 		reader->calibration = _lofar_udp_calibration_alloc();
 		reader->calibration->calibrationDuration = config->calibrationDuration;
@@ -1277,6 +1950,110 @@ lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config) {
 }
 
 
+/**
+ * @brief      Validate every header in the current gulp and count the lost and out-of-order packets on each port in
+ *             a single sweep. Headers that fail validation are moved before the gulp so that the kernels drop them and pad
+ *             their slot. Packet numbers that jump forward while the next packet follows on from the previous one are only
+ *             counted as suspect, as reordered packets produce the same sequence.
+ *
+ * @param      meta  The meta
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t _lofar_udp_reader_header_census(lofar_udp_obs_meta *meta) {
+	if (meta == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null meta, exiting.\n", __func__);
+		return -1;
+	}
+
+	const int64_t packets = meta->packetsPerIteration;
+	const uint32_t expectedBitMode = (meta->inputBitMode == 16) ? 0 : ((meta->inputBitMode == 8) ? 1 : 2);
+	const uint32_t expectedClock = meta->clockBit;
+
+	#pragma omp parallel for default(shared)
+	for (int8_t port = 0; port < meta->numPorts; port++) {
+		lofar_udp_gulp_summary summary = { .packetsChecked = packets, .firstPacket = -1, .lastPacket = meta->lastPacket };
+		int8_t *inputPortData = meta->inputData[port];
+		const int64_t portPacketLength = meta->portPacketLength[port];
+		const uint8_t expectedBeamlets = (uint8_t) meta->portRawBeamlets[port];
+
+		// One extra entry is gathered past each block, so the last packet of a block can be compared to the next
+		int64_t packetNumbers[HEADER_CENSUS_BLOCK + 1];
+		int8_t malformed[HEADER_CENSUS_BLOCK + 1];
+		int64_t lastPortPacket = meta->lastPacket;
+
+		for (int64_t base = 0; base < packets; base += HEADER_CENSUS_BLOCK) {
+			const int64_t blockLength = (packets - base) < HEADER_CENSUS_BLOCK ? (packets - base) : HEADER_CENSUS_BLOCK;
+			const int64_t gatherLength = blockLength + ((base + blockLength) < packets);
+			int64_t errorBits = 0;
+
+			// Gather the header fields across the block, without branches so the checks vectorise
+			#pragma omp simd reduction(+:errorBits)
+			for (int64_t idx = 0; idx < gatherLength; idx++) {
+				const int8_t *header = &(inputPortData[(base + idx) * portPacketLength]);
+				const lofar_source_bytes *source = (const lofar_source_bytes *) &(header[CEP_HDR_SRC_OFFSET]);
+				const int32_t timestamp = *((const int32_t *) &(header[CEP_HDR_TIME_OFFSET]));
+				const int32_t sequence = *((const int32_t *) &(header[CEP_HDR_SEQ_OFFSET]));
+
+				malformed[idx] = (int8_t) (((uint8_t) header[CEP_HDR_RSP_VER_OFFSET] < UDPCURVER)
+				                           | (timestamp < LFREPOCH) | (sequence < 0) | (sequence > RSPMAXSEQ)
+				                           | ((uint8_t) header[CEP_HDR_NBEAM_OFFSET] != expectedBeamlets)
+				                           | ((uint8_t) header[CEP_HDR_NTIMESLICE_OFFSET] != UDPNTIMESLICE)
+				                           | (source->padding0 != 0) | (source->padding1 > 1)
+				                           | (source->bitMode != expectedBitMode) | (source->clockBit != expectedClock));
+				packetNumbers[idx] = lofar_udp_time_beamformed_packno(timestamp, sequence, (uint8_t) expectedClock);
+				errorBits += (idx < blockLength) & source->errorBit;
+			}
+			summary.errorBitPackets += errorBits;
+
+			// Walk the packet numbers for the loss/ordering census
+			for (int64_t idx = 0; idx < blockLength; idx++) {
+				const int64_t packet = packetNumbers[idx];
+
+				// A forward jump followed by the packet that should come after the previous one may be a corrupt packet number,
+				// but is indistinguishable from reordered packets, so it is only flagged
+				if (!malformed[idx] && packet > (lastPortPacket + 1) && (idx + 1) < gatherLength && !malformed[idx + 1] && packetNumbers[idx + 1] == (lastPortPacket + 2)) {
+					summary.suspectPackets++;
+				}
+
+				if (malformed[idx]) {
+					summary.malformedPackets++;
+					int8_t *header = &(inputPortData[(base + idx) * portPacketLength]);
+					*((int32_t *) &(header[CEP_HDR_TIME_OFFSET])) = 0;
+					*((int32_t *) &(header[CEP_HDR_SEQ_OFFSET])) = 0;
+					continue;
+				}
+
+				if (summary.firstPacket < 0) {
+					summary.firstPacket = packet;
+				}
+
+				if (packet <= lastPortPacket) {
+					summary.outOfOrderPackets++;
+					continue;
+				}
+
+				summary.droppedPackets += packet - lastPortPacket - 1;
+				lastPortPacket = packet;
+			}
+		}
+
+		summary.lastPacket = lastPortPacket;
+		summary.contiguous = (int8_t) (summary.malformedPackets == 0 && summary.droppedPackets == 0 && summary.outOfOrderPackets == 0
+		                               && lastPortPacket == (meta->lastPacket + packets));
+		meta->gulpSummary[port] = summary;
+
+		if (summary.malformedPackets > 0) {
+			fprintf(stderr, "WARNING (Port %d): %ld packets had malformed headers and will be treated as lost.\n", port, summary.malformedPackets);
+		}
+		VERBOSE(if (meta->VERBOSE && summary.suspectPackets > 0) {
+			printf("Port %d: %ld packets jumped ahead of their neighbours (reordered or corrupt packet numbers).\n", port, summary.suspectPackets);
+		});
+	}
+
+	return 0;
+}
+
 /**
  * @brief      Attempt to fill the reader->meta->inputData buffers with new
  *             data. Performs a shift on the last N packets of a given port if
@@ -1324,6 +2101,7 @@ int32_t _lofar_udp_reader_internal_read_step(lofar_udp_reader *reader) {
 		// Determine how much data is needed and read-in to the offset after any leftover packets
 		if (reader->meta->portLastDroppedPackets[port] > charsToRead) {
 			fprintf(stderr, "\nWARNING: Port %d not performing read due to excessive packet loss.\n", port);
+			reader->input->lastReadOffset[port] = reader->input->streamOffset[port];
 			continue;
 		} else {
 			charsToRead = (charsToRead - reader->meta->portLastDroppedPackets[port]) *
@@ -1449,6 +2227,10 @@ int32_t lofar_udp_reader_step_timed(lofar_udp_reader *reader, double timing[2])
 	// Make sure there is a new input data set before running
 	// On the setup iteration, the output data is marked as ready to prevent this occurring until the first read step is called
 	if (reader->meta->outputDataReady != 1 && reader->meta->packetsPerIteration > 0) {
+		if (_lofar_udp_reader_header_census(reader->meta) < 0) {
+			return 1;
+		}
+
 		if ((stepReturnVal = lofar_udp_cpp_loop_interface(reader->meta)) > 0) {
 			// outputDataReady is negative -> out of order packets -> need to re-run for time-major modes
 			if (reader->meta->outputDataReady < 0 && reader->meta->dataOrder == TIME_MAJOR) {
@@ -1492,6 +2274,193 @@ int32_t lofar_udp_reader_step(lofar_udp_reader *reader) {
 	return lofar_udp_reader_step_timed(reader, fakeTiming);
 }
 
+/**
+ * @brief      Process the next steps of an output into a caller-provided buffer rather than the library's own buffer,
+ * 				such as a block of shared memory from lofar_udp_io_write_acquire(), so that the output does not need to be
+ * 				copied afterwards. The buffer must hold at least packetsPerIteration * packetOutputLength[outp] bytes, and
+ * 				remain valid until the next step has completed.
+ *
+ * @param      reader  The lofar_udp_reader struct
+ * @param[in]  outp    The output index
+ * @param      target  The buffer to process into (NULL: return to the library's buffer)
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_reader_output_redirect(lofar_udp_reader *reader, int8_t outp, int8_t *target) {
+	if (reader == NULL || reader->meta == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null reader, exiting.\n", __func__);
+		return -1;
+	}
+
+	if (outp < 0 || outp >= reader->meta->numOutputs) {
+		fprintf(stderr, "ERROR %s: Invalid output index %d (%d outputs), exiting.\n", __func__, outp, reader->meta->numOutputs);
+		return -1;
+	}
+
+	reader->meta->outputData[outp] = (target != NULL) ? target : reader->meta->outputDataBuffers[outp];
+	return 0;
+}
+
+
+/**
+ * @brief      Time the I/O and processing of a few gulps of the input at a given packetsPerIteration
+ *
+ * @param      config               The (tuning) configuration, packetsPerIteration/packetsReadMax are modified
+ * @param[in]  packetsPerIteration  The candidate number of packets per iteration
+ *
+ * @return     >0: Seconds per packet, <0: Failure (including inputs too short to time the candidate)
+ */
+double _lofar_udp_reader_tune_time_candidate(lofar_udp_config *config, const int64_t packetsPerIteration) {
+	config->packetsPerIteration = packetsPerIteration;
+	// One gulp is read during setup, then a warm-up and the timed gulps, with a spare gulp so the final read is not truncated
+	config->packetsReadMax = packetsPerIteration * (AUTOTUNE_STEPS + 2);
+
+	lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+	if (reader == NULL) {
+		return -1.0;
+	}
+
+	double totalTime = -1.0;
+	if (reader->meta->packetsPerIteration == packetsPerIteration && lofar_udp_reader_step(reader) <= 0) {
+		totalTime = 0.0;
+		for (int32_t step = 0; step < AUTOTUNE_STEPS; step++) {
+			double timing[2] = { 0.0, 0.0 };
+			const int32_t returnVal = lofar_udp_reader_step_timed(reader, timing);
+			if (returnVal > 0 || reader->meta->packetsPerIteration != packetsPerIteration) {
+				totalTime = -1.0;
+				break;
+			}
+			totalTime += timing[0] + timing[1];
+		}
+	}
+
+	lofar_udp_reader_cleanup(reader);
+	return totalTime > 0.0 ? totalTime / (double) (packetsPerIteration * AUTOTUNE_STEPS) : -1.0;
+}
+
+/**
+ * @brief      Choose packetsPerIteration for a configuration by timing a few gulps of the input at candidate sizes. The
+ *             candidates are powers of two, from the size where a gulp outgrows the last level cache to the largest
+ *             size that fits comfortably in the available memory. The smallest candidate within AUTOTUNE_TOLERANCE of
+ *             the fastest time per packet is chosen.
+ *
+ * @param[in]  config  The reader configuration, inputs must be files that can be re-read from the start
+ *
+ * @return     >0: Chosen packets per iteration, <0: Failure
+ */
+int64_t lofar_udp_reader_tune_packets_per_iteration(const lofar_udp_config *config) {
+	if (config == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null config, exiting.\n", __func__);
+		return -1;
+	}
+
+	switch (config->readerType) {
+		case NORMAL:
+		case NORMAL_MMAP:
+		case URING:
+		case ZSTDCOMPRESSED:
+		case ZSTDCOMPRESSED_INDIRECT:
+			break;
+
+		default:
+			fprintf(stderr, "ERROR %s: Tuning requires inputs that can be re-read from the start (reader %d), exiting.\n", __func__, config->readerType);
+			return -1;
+	}
+
+	// Tune on the raw processing cost, without calibration or metadata generation
+	lofar_udp_config tuneConfig = *config;
+	tuneConfig.calibrateData = NO_CALIBRATION;
+	tuneConfig.metadata_config.metadataType = NO_META;
+	tuneConfig.metadata_config.metadataLocation[0] = '\0';
+
+	// Setup can shift the input locations (beamlet limits), so the tuning readers get their own copies of the per-port arrays
+	tuneConfig.inputLocations = NULL;
+	tuneConfig.inputDadaKeys = NULL;
+	tuneConfig.allocatedPorts = 0;
+	if (lofar_udp_config_alloc_ports(&tuneConfig, config->allocatedPorts) < 0) {
+		FREE_NOT_NULL(tuneConfig.inputLocations);
+		FREE_NOT_NULL(tuneConfig.inputDadaKeys);
+		return -1;
+	}
+	memcpy(tuneConfig.inputLocations, config->inputLocations, config->allocatedPorts * sizeof(*(config->inputLocations)));
+	memcpy(tuneConfig.inputDadaKeys, config->inputDadaKeys, config->allocatedPorts * sizeof(*(config->inputDadaKeys)));
+
+	// Determine the memory used per packet (input and output buffers) with a small reader
+	tuneConfig.packetsPerIteration = AUTOTUNE_MIN_PACKETS;
+	tuneConfig.packetsReadMax = 2 * AUTOTUNE_MIN_PACKETS;
+	lofar_udp_reader *reader = lofar_udp_reader_setup(&tuneConfig);
+	if (reader == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to setup a reader for tuning, exiting.\n", __func__);
+		FREE_NOT_NULL(tuneConfig.inputLocations);
+		FREE_NOT_NULL(tuneConfig.inputDadaKeys);
+		return -1;
+	}
+	int64_t bytesPerPacket = 0;
+	for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+		bytesPerPacket += reader->meta->portPacketLength[port];
+	}
+	for (int8_t out = 0; out < reader->meta->numOutputs; out++) {
+		bytesPerPacket += reader->meta->packetOutputLength[out];
+	}
+	lofar_udp_reader_cleanup(reader);
+
+	int64_t cacheSize = sysconf(_SC_LEVEL3_CACHE_SIZE);
+	if (cacheSize < 1) cacheSize = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	if (cacheSize < 1) cacheSize = 32 * 1024 * 1024;
+	const int64_t availableMemory = sysconf(_SC_AVPHYS_PAGES) * sysconf(_SC_PAGESIZE);
+
+	int64_t minPackets = AUTOTUNE_MIN_PACKETS, maxPackets;
+	while (minPackets < AUTOTUNE_MAX_PACKETS && (minPackets * 2 * bytesPerPacket) <= cacheSize) {
+		minPackets *= 2;
+	}
+	maxPackets = minPackets;
+	while (maxPackets < AUTOTUNE_MAX_PACKETS && (maxPackets * 2 * bytesPerPacket) <= (availableMemory / 4)
+	       && (config->packetsReadMax < 1 || (maxPackets * 2) <= config->packetsReadMax)) {
+		maxPackets *= 2;
+	}
+	VERBOSE(printf("%s: %ld bytes per packet, LLC %ld bytes, %ld bytes available, candidates %ld -> %ld\n", __func__, bytesPerPacket, cacheSize, availableMemory, minPackets, maxPackets));
+
+	// Run the largest candidate once before timing, so the data read by every candidate is equally cached
+	if (_lofar_udp_reader_tune_time_candidate(&tuneConfig, maxPackets) < 0.0) {
+		VERBOSE(printf("%s: input too short to prime %ld packets per iteration\n", __func__, maxPackets));
+	}
+
+	int64_t candidates[64];
+	double timePerPacket[64];
+	int32_t numCandidates = 0;
+	double bestTime = -1.0;
+	for (int64_t candidate = maxPackets; candidate >= minPackets && numCandidates < 64; candidate /= 2) {
+		const double candidateTime = _lofar_udp_reader_tune_time_candidate(&tuneConfig, candidate);
+		VERBOSE(printf("%s: %ld packets per iteration, %.3lf ns per packet\n", __func__, candidate, candidateTime * 1e9));
+		if (candidateTime <= 0.0) {
+			continue;
+		}
+		candidates[numCandidates] = candidate;
+		timePerPacket[numCandidates] = candidateTime;
+		numCandidates++;
+		if (bestTime < 0.0 || candidateTime < bestTime) {
+			bestTime = candidateTime;
+		}
+	}
+	FREE_NOT_NULL(tuneConfig.inputLocations);
+	FREE_NOT_NULL(tuneConfig.inputDadaKeys);
+
+	if (numCandidates == 0) {
+		fprintf(stderr, "ERROR %s: Input is too short to time any candidates (minimum %ld packets per iteration), exiting.\n", __func__, minPackets);
+		return -1;
+	}
+
+	// Candidates are in descending order, prefer the smallest that is close to the best time
+	int64_t chosen = candidates[0];
+	for (int32_t idx = 0; idx < numCandidates; idx++) {
+		if (timePerPacket[idx] <= bestTime * (1.0 + AUTOTUNE_TOLERANCE)) {
+			chosen = candidates[idx];
+		}
+	}
+
+	return chosen;
+}
+
 
 /**
  * @brief      Align each of the ports so that they start on the same packet
@@ -1531,6 +2500,10 @@ int32_t _lofar_udp_get_first_packet_alignment(lofar_udp_reader *reader) {
  *             the start; mainly used to handle the case of packet loss without
  *             re-reading the data (read: zstd streaming is hell)
  *
+ *             Mirrored ring and memory mapped input buffers are advanced rather than
+ *             copied, so they are shifted on every padded call to keep buffered data
+ *             in place.
+ *
  * @param      reader         The udp reader struct
  * @param[in]  shiftPackets   [PORTS] int array of number of packets to shift
  *                            from the tail of each port by
@@ -1545,7 +2518,7 @@ int32_t _lofar_udp_shift_remainder_packets(lofar_udp_reader *reader, const int64
 	int64_t destOffset, portPacketLength, byteShift, sourceOffset;
 	int64_t totalShift = 0, packetShift;
 	int32_t returnVal = 0;
-	int8_t fixBuffer = 0;
+	int8_t fixBuffer = 0, ringBuffer = 0;
 	int8_t *inputData;
 
 
@@ -1553,10 +2526,11 @@ int32_t _lofar_udp_shift_remainder_packets(lofar_udp_reader *reader, const int64
 	for (int8_t port = 0; port < reader->meta->numPorts; port++) {
 		reader->meta->inputDataOffset[port] = 0;
 		totalShift += shiftPackets[port];
+		ringBuffer |= (reader->input->inputRing[port] != NULL || reader->input->inputMap[port] != NULL);
 	}
 
-	// No work to perform
-	if (totalShift < 1 && fixBuffer == 0) { return 0; }
+	// No work to perform (rings are always advanced on new reads to keep the buffered data in place)
+	if (totalShift < 1 && fixBuffer == 0 && (ringBuffer == 0 || handlePadding == 0)) { return 0; }
 
 
 	// Shift the data on each port
@@ -1610,8 +2584,20 @@ int32_t _lofar_udp_shift_remainder_packets(lofar_udp_reader *reader, const int64
 			});
 
 
-			// Memmove the data as needed (memcpy can't act on the same array)
-			if (destOffset != sourceOffset) {
+			if (reader->input->inputRing[port] != NULL) {
+				// Advance the ring so that the retained packets sit just before the new head
+				reader->meta->inputData[port] = _lofar_udp_io_read_ring_advance(reader->input, port, inputData, sourceOffset - destOffset);
+				inputData = reader->meta->inputData[port];
+				// Buffered input must be in place before the padding packet is reset
+				if (_lofar_udp_io_read_ring_prepare(reader->input, port, &(inputData[destOffset + byteShift])) < 0) {
+					returnVal = -1;
+				}
+			} else if (reader->input->inputMap[port] != NULL) {
+				// Advance through the mapping, re-aligning with the file's read cursor if the last read was not in place
+				inputData = _lofar_udp_io_read_MMAP_rebase(reader->input, port, inputData + sourceOffset - destOffset, destOffset, byteShift);
+				reader->meta->inputData[port] = inputData;
+			} else if (destOffset != sourceOffset) {
+				// Memmove the data as needed (memcpy can't act on the same array)
 				memmove(&(inputData[destOffset]), &(inputData[sourceOffset]), byteShift);
 			}
 
@@ -1652,6 +2638,11 @@ void lofar_udp_reader_cleanup(lofar_udp_reader *reader) {
 	if (reader->meta != NULL) {
 		// Cleanup the malloc/calloc'd memory addresses, close the input files.
 		for (int8_t i = 0; i < reader->meta->numOutputs; i++) {
+			// Outputs may have been redirected to buffers we do not own
+			if (reader->meta->outputDataBuffers[i] != NULL) {
+				reader->meta->outputData[i] = reader->meta->outputDataBuffers[i];
+				reader->meta->outputDataBuffers[i] = NULL;
+			}
 			FREE_NOT_NULL(reader->meta->outputData[i]);
 		}
 
@@ -1664,8 +2655,16 @@ void lofar_udp_reader_cleanup(lofar_udp_reader *reader) {
 						PREBUFLEN);
 				});
 
-				int8_t *tmpPtr = (reader->meta->inputData[i] - PREBUFLEN);
-				FREE_NOT_NULL(tmpPtr);
+				if (reader->input != NULL && reader->input->inputRing[i] != NULL) {
+					_lofar_udp_io_read_ring_free(reader->input, i);
+				} else if (reader->input != NULL && reader->input->inputWindow[i] != NULL) {
+					_lofar_udp_io_read_window_free(reader->input, i);
+				} else if (reader->input != NULL && reader->input->inputMap[i] != NULL) {
+					// Memory mapped inputs are unmapped by lofar_udp_io_read_cleanup
+				} else {
+					int8_t *tmpPtr = (reader->meta->inputData[i] - PREBUFLEN);
+					FREE_NOT_NULL(tmpPtr);
+				}
 				reader->meta->inputData[i] = NULL;
 			}
 		}
@@ -1684,7 +2683,8 @@ void lofar_udp_reader_cleanup(lofar_udp_reader *reader) {
 	}
 
 	// Free the reader
-	FREE_NOT_NULL(reader->meta);
+	_lofar_udp_obs_meta_cleanup(reader->meta);
+	reader->meta = NULL;
 	lofar_udp_io_read_cleanup(reader->input);
 	reader->input = NULL;
 	FREE_NOT_NULL(reader->calibration);
@@ -12,8 +12,14 @@
 #include <limits.h>
 #include <time.h>
 #include <fcntl.h>
+#include <stddef.h>
 
 
+// Checkpoint file parameters
+#define UPM_CHECKPOINT_MAGIC "UPMCKPT"
+#define UPM_CHECKPOINT_MAGIC_LEN 8
+#define UPM_CHECKPOINT_VERSION 2
+
 
 // Function Prototypes
 
@@ -25,9 +31,18 @@ extern "C" {
 // Reader/meta struct initialisation
 lofar_udp_reader *lofar_udp_reader_setup(lofar_udp_config *config);
 int32_t lofar_udp_file_reader_reuse(lofar_udp_reader *reader, int64_t startingPacket, int64_t packetsReadMax);
+int64_t lofar_udp_reader_events_process(lofar_udp_reader *reader, const lofar_udp_event events[], int64_t numEvents, lofar_udp_event_callback callback, void *userData);
 // Iteration handlers
 int32_t lofar_udp_reader_step(lofar_udp_reader *reader);
 int32_t lofar_udp_reader_step_timed(lofar_udp_reader *reader, double timing[2]);
+int32_t lofar_udp_reader_output_redirect(lofar_udp_reader *reader, int8_t outp, int8_t *target);
+// Gulp size tuning
+int64_t lofar_udp_reader_tune_packets_per_iteration(const lofar_udp_config *config);
+// Checkpoint / resume
+int32_t lofar_udp_reader_checkpoint(const lofar_udp_reader *reader, lofar_udp_io_write_config *outConfig, lofar_udp_checkpoint *checkpoint);
+int32_t lofar_udp_reader_checkpoint_write(const lofar_udp_reader *reader, lofar_udp_io_write_config *outConfig, const char checkpointLocation[]);
+int32_t lofar_udp_checkpoint_write(const lofar_udp_checkpoint *checkpoint, const char checkpointLocation[]);
+int32_t lofar_udp_checkpoint_load(lofar_udp_checkpoint *checkpoint, const char checkpointLocation[]);
 // Reader struct cleanup
 void lofar_udp_reader_cleanup(lofar_udp_reader *reader);
 
@@ -35,15 +50,20 @@ void lofar_udp_reader_cleanup(lofar_udp_reader *reader);
 void _lofar_udp_parse_header_extract_metadata(int8_t port, lofar_udp_obs_meta *meta, const int8_t header[16], const int16_t beamletLimits[2]);
 void _lofar_udp_reader_config_patch(lofar_udp_config *config);
 int32_t _lofar_udp_reader_malformed_header_checks(const int8_t header[16]);
-int32_t _lofar_udp_parse_header_buffers(lofar_udp_obs_meta *meta, const int8_t header[4][16], const int16_t beamletLimits[2]);
-int32_t _lofar_udp_setup_parse_headers(lofar_udp_config *config, lofar_udp_obs_meta *meta, int8_t inputHeaders[MAX_NUM_PORTS][UDPHDRLEN]);
+int32_t _lofar_udp_parse_header_buffers(lofar_udp_obs_meta *meta, const int8_t header[][UDPHDRLEN], const int16_t beamletLimits[2]);
+int32_t _lofar_udp_setup_parse_headers(lofar_udp_config *config, lofar_udp_obs_meta *meta, int8_t inputHeaders[][UDPHDRLEN]);
 int32_t _lofar_udp_skip_to_packet(lofar_udp_reader *reader);
+int32_t _lofar_udp_reader_index_seek(lofar_udp_reader *reader, int64_t targetPacket);
+int32_t _lofar_udp_reader_checkpoint_seek(lofar_udp_reader *reader, const lofar_udp_checkpoint *checkpoint);
+int64_t _lofar_udp_reader_events_schedule(const lofar_udp_event events[], int64_t numEvents, int64_t order[], lofar_udp_event spans[], int64_t spanFirstEvent[]);
 int32_t _lofar_udp_setup_processing(lofar_udp_obs_meta *meta);
 int32_t _lofar_udp_setup_processing_output_buffers(lofar_udp_obs_meta *meta);
 int32_t _lofar_udp_get_first_packet_alignment(lofar_udp_reader *reader);
 int32_t _lofar_udp_shift_remainder_packets(lofar_udp_reader *reader, const int64_t shiftPackets[], int8_t handlePadding);
 int32_t _lofar_udp_reader_config_check(const lofar_udp_config *config);
 int32_t _lofar_udp_reader_internal_read_step(lofar_udp_reader *reader);
+int32_t _lofar_udp_reader_header_census(lofar_udp_obs_meta *meta);
+double _lofar_udp_reader_tune_time_candidate(lofar_udp_config *config, int64_t packetsPerIteration);
 lofar_udp_obs_meta* _lofar_udp_configure_obs_meta(const lofar_udp_config *config);
 //int _lofar_udp_realign_data(lofar_udp_reader *reader);
 
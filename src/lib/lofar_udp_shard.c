@@ -0,0 +1,917 @@
+#include "lofar_udp_shard.h"
+
+// GUPPI headers are built from fixed-length cards, terminated by an "END" card
+#define GUPPI_CARD_LEN 80
+
+/**
+ * @brief      Determine the packet range processed by one shard of an observation
+ *
+ * @param[in]  startingPacket       The first packet of the observation
+ * @param[in]  packets              The number of packets (per port) in the observation
+ * @param[in]  packetsPerIteration  The number of packets processed per iteration
+ * @param[in]  shard                The shard index (0 to numShards - 1)
+ * @param[in]  numShards            The number of shards the observation is split into
+ * @param[out] shardStart           The first packet of the shard
+ * @param[out] shardPackets         The number of packets in the shard
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_shard_range(const int64_t startingPacket, const int64_t packets, const int64_t packetsPerIteration, const int32_t shard, const int32_t numShards,
+                              int64_t *shardStart, int64_t *shardPackets) {
+	if (shardStart == NULL || shardPackets == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null output (shardStart: %p, shardPackets: %p), exiting.\n", __func__, shardStart, shardPackets);
+		return -1;
+	}
+
+	if (startingPacket < 0 || packets < 1 || packets == LONG_MAX || packetsPerIteration < 1 || numShards < 1 || shard < 0 || shard >= numShards) {
+		fprintf(stderr, "ERROR %s: Invalid shard request (start: %ld, packets: %ld, packets/iteration: %ld, shard %d of %d), exiting.\n", __func__,
+		        startingPacket, packets, packetsPerIteration, shard, numShards);
+		return -2;
+	}
+
+	// Shards are a whole number of iterations long, so every gulp covers the same packets as in an unsharded run
+	int64_t shardLength = (packets + numShards - 1) / numShards;
+	shardLength = ((shardLength + packetsPerIteration - 1) / packetsPerIteration) * packetsPerIteration;
+
+	const int64_t shardOffset = shardLength * shard;
+	if (shardOffset >= packets) {
+		fprintf(stderr, "ERROR %s: Shard %d of %d would be empty (%ld packets, %ld packets per shard), use fewer shards, exiting.\n", __func__, shard, numShards, packets, shardLength);
+		return -3;
+	}
+
+	*shardStart = startingPacket + shardOffset;
+	*shardPackets = (packets - shardOffset) < shardLength ? (packets - shardOffset) : shardLength;
+
+	return 0;
+}
+
+/**
+ * @brief      Modify an output format so that it writes part files for a shard
+ *
+ * @param      outConfig  The output configuration (post-parse, pre-setup)
+ * @param[in]  shard      The shard index
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_shard_output_format(lofar_udp_io_write_config *outConfig, const int32_t shard) {
+	if (outConfig == NULL || shard < 0) {
+		fprintf(stderr, "ERROR %s: Invalid input (outConfig: %p, shard: %d), exiting.\n", __func__, outConfig, shard);
+		return -1;
+	}
+
+	char partSuffix[32];
+	if (snprintf(partSuffix, 32, UPM_SHARD_PART_FMT, shard) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to build part file suffix, exiting.\n", __func__);
+		return -1;
+	}
+
+	const size_t formatLength = strnlen(outConfig->outputFormat, DEF_STR_LEN);
+	if (formatLength + strlen(partSuffix) >= DEF_STR_LEN) {
+		fprintf(stderr, "ERROR %s: Output format is too long to append a part suffix (%s%s), exiting.\n", __func__, outConfig->outputFormat, partSuffix);
+		return -2;
+	}
+	strcat(outConfig->outputFormat, partSuffix);
+
+	return 0;
+}
+
+/**
+ * @brief      Reset a shard description to the default, keeping any per-output arrays it already holds
+ *
+ * @param      shard  The shard description to reset
+ */
+static void _lofar_udp_shard_reset(lofar_udp_shard *shard) {
+	const lofar_udp_shard arrays = *shard;
+
+	// Copy the default with its padding, as the fixed fields are written to disk as-is
+	memcpy(shard, &lofar_udp_shard_default, sizeof(lofar_udp_shard));
+	shard->outputBytes = arrays.outputBytes;
+	shard->packetOutputLength = arrays.packetOutputLength;
+	shard->outputLocations = arrays.outputLocations;
+	shard->allocatedOutputs = arrays.allocatedOutputs;
+}
+
+/**
+ * @brief      Initialise a shard description from a reader and its (opened) outputs
+ *
+ * @param[out] shard       The shard description, initialised from lofar_udp_shard_default (its arrays are grown as
+ *                         needed, and freed with lofar_udp_shard_free_outputs)
+ * @param[in]  reader      The reader, after setup
+ * @param[in]  outConfig   The output configuration, after setup
+ * @param[in]  shardIdx    The shard index
+ * @param[in]  numShards   The number of shards
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_shard_setup(lofar_udp_shard *shard, const lofar_udp_reader *reader, const lofar_udp_io_write_config *outConfig, const int32_t shardIdx,
+                              const int32_t numShards) {
+	if (shard == NULL || reader == NULL || reader->meta == NULL || outConfig == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (shard: %p, reader: %p, outConfig: %p), exiting.\n", __func__, shard, reader, outConfig);
+		return -1;
+	}
+
+	if (shardIdx < 0 || shardIdx >= numShards || outConfig->numOutputs < 1) {
+		fprintf(stderr, "ERROR %s: Invalid shard %d of %d (%d outputs), exiting.\n", __func__, shardIdx, numShards, outConfig->numOutputs);
+		return -2;
+	}
+
+	_lofar_udp_shard_reset(shard);
+	if (lofar_udp_shard_alloc_outputs(shard, outConfig->numOutputs) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to allocate shard description for %d outputs, exiting.\n", __func__, outConfig->numOutputs);
+		return -1;
+	}
+	shard->version = UPM_SHARD_VERSION;
+	shard->shard = shardIdx;
+	shard->numShards = numShards;
+
+	shard->numPorts = reader->meta->numPorts;
+	shard->numOutputs = outConfig->numOutputs;
+	shard->metadataType = reader->metadata != NULL ? reader->metadata->type : NO_META;
+	shard->replayDroppedPackets = reader->meta->replayDroppedPackets;
+	// leadingPacket is only set once the reader steps, the first gulp starts after the last packet seen during setup
+	shard->firstPacket = reader->meta->lastPacket + 1;
+
+	for (int8_t out = 0; out < shard->numOutputs; out++) {
+		shard->outputBytes[out] = 0;
+		shard->packetOutputLength[out] = reader->meta->packetOutputLength[out];
+		if (strncpy(shard->outputLocations[out], outConfig->outputLocations[out], DEF_STR_LEN) != shard->outputLocations[out]) {
+			fprintf(stderr, "ERROR %s: Failed to copy output location %d, exiting.\n", __func__, out);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Get the manifest location for a shard
+ *
+ * @param[out] dest            The output location (DEF_STR_LEN long)
+ * @param[in]  outputLocation  The shard's first part file
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_shard_get_location(char *dest, const char outputLocation[]) {
+	if (dest == NULL || outputLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (dest: %p, outputLocation: %p), exiting.\n", __func__, dest, outputLocation);
+		return -1;
+	}
+
+	const int32_t written = snprintf(dest, DEF_STR_LEN, "%s%s", outputLocation, UPM_SHARD_SUFFIX);
+	if (written < 0 || written >= DEF_STR_LEN) {
+		fprintf(stderr, "ERROR %s: Shard manifest location for %s is too long, exiting.\n", __func__, outputLocation);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Write a shard manifest to disk
+ *
+ * @param[in]  shard          The shard description
+ * @param[in]  shardLocation  The manifest location
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_shard_write(const lofar_udp_shard *shard, const char shardLocation[]) {
+	if (shard == NULL || shardLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (shard: %p, shardLocation: %p), exiting.\n", __func__, shard, shardLocation);
+		return -1;
+	}
+
+	FILE *shardFile = fopen(shardLocation, "wb");
+	if (shardFile == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to open %s for writing (errno %d: %s), exiting.\n", __func__, shardLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	// The fixed fields are stored as-is, followed by the entries for the outputs in use
+	const char magic[UPM_SHARD_MAGIC_LEN] = UPM_SHARD_MAGIC;
+	const size_t numOutputs = shard->numOutputs > 0 ? (size_t) shard->numOutputs : 0;
+	if (fwrite(magic, sizeof(char), UPM_SHARD_MAGIC_LEN, shardFile) != UPM_SHARD_MAGIC_LEN
+		|| fwrite(shard, offsetof(lofar_udp_shard, outputBytes), 1, shardFile) != 1
+		|| fwrite(shard->outputBytes, sizeof(int64_t), numOutputs, shardFile) != numOutputs
+		|| fwrite(shard->packetOutputLength, sizeof(int64_t), numOutputs, shardFile) != numOutputs
+		|| fwrite(shard->outputLocations, sizeof(shard->outputLocations[0]), numOutputs, shardFile) != numOutputs) {
+		fprintf(stderr, "ERROR %s: Failed to write shard manifest to %s, exiting.\n", __func__, shardLocation);
+		fclose(shardFile);
+		remove(shardLocation);
+		return -1;
+	}
+
+	if (fclose(shardFile)) {
+		fprintf(stderr, "ERROR %s: Failed to close shard manifest %s (errno %d: %s), exiting.\n", __func__, shardLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Load a shard manifest from disk
+ *
+ * @param[out] shard          The shard description, initialised from lofar_udp_shard_default (its arrays are grown as
+ *                            needed, and freed with lofar_udp_shard_free_outputs)
+ * @param[in]  shardLocation  The manifest location
+ *
+ * @return     0: Success, <0: Failure
+ */
+int32_t lofar_udp_shard_load(lofar_udp_shard *shard, const char shardLocation[]) {
+	if (shard == NULL || shardLocation == NULL) {
+		fprintf(stderr, "ERROR %s: Passed null input (shard: %p, shardLocation: %p), exiting.\n", __func__, shard, shardLocation);
+		return -1;
+	}
+
+	FILE *shardFile = fopen(shardLocation, "rb");
+	if (shardFile == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to open shard manifest at %s (errno %d: %s), exiting.\n", __func__, shardLocation, errno, strerror(errno));
+		return -1;
+	}
+
+	// As with checkpoints, only the entries for the outputs in use are stored after the fixed fields
+	_lofar_udp_shard_reset(shard);
+	const int64_t shardSize = _FILE_file_size(shardFile);
+	char magic[UPM_SHARD_MAGIC_LEN];
+	if (fread(magic, sizeof(char), UPM_SHARD_MAGIC_LEN, shardFile) != UPM_SHARD_MAGIC_LEN
+		|| strncmp(magic, UPM_SHARD_MAGIC, UPM_SHARD_MAGIC_LEN) != 0
+		|| fread(shard, offsetof(lofar_udp_shard, outputBytes), 1, shardFile) != 1) {
+		fprintf(stderr, "ERROR %s: %s does not appear to be a shard manifest for this build, exiting.\n", __func__, shardLocation);
+		fclose(shardFile);
+		return -1;
+	}
+
+	if (shard->version != UPM_SHARD_VERSION || shard->shard < 0 || shard->shard >= shard->numShards || shard->numOutputs < 1
+		|| shardSize != (int64_t) (UPM_SHARD_MAGIC_LEN + offsetof(lofar_udp_shard, outputBytes)
+		                           + shard->numOutputs * (2 * sizeof(int64_t) + sizeof(shard->outputLocations[0])))) {
+		fprintf(stderr, "ERROR %s: Shard manifest at %s is an unsupported version (%d) or corrupted, exiting.\n", __func__, shardLocation, shard->version);
+		fclose(shardFile);
+		return -1;
+	}
+
+	if (lofar_udp_shard_alloc_outputs(shard, shard->numOutputs) < 0) {
+		fprintf(stderr, "ERROR %s: Failed to allocate shard description for %d outputs, exiting.\n", __func__, shard->numOutputs);
+		fclose(shardFile);
+		return -1;
+	}
+
+	if (fread(shard->outputBytes, sizeof(int64_t), shard->numOutputs, shardFile) != (size_t) shard->numOutputs
+		|| fread(shard->packetOutputLength, sizeof(int64_t), shard->numOutputs, shardFile) != (size_t) shard->numOutputs
+		|| fread(shard->outputLocations, sizeof(shard->outputLocations[0]), shard->numOutputs, shardFile) != (size_t) shard->numOutputs) {
+		fprintf(stderr, "ERROR %s: Failed to read shard manifest entries from %s, exiting.\n", __func__, shardLocation);
+		fclose(shardFile);
+		return -1;
+	}
+	fclose(shardFile);
+
+	return 0;
+}
+
+
+/**
+ * @brief      Copy data from a part file to an output
+ *
+ * @param      partFile   The part file, at the start of the data to copy
+ * @param      outConfig  The output configuration
+ * @param[in]  out        The output index
+ * @param[in]  bytes      The number of bytes to copy
+ * @param      buffer     A UPM_SHARD_COPY_LENGTH long working buffer
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_shard_copy(FILE *partFile, lofar_udp_io_write_config *outConfig, const int8_t out, int64_t bytes, int8_t *buffer) {
+	while (bytes > 0) {
+		const int64_t chunk = bytes < UPM_SHARD_COPY_LENGTH ? bytes : UPM_SHARD_COPY_LENGTH;
+		if ((int64_t) fread(buffer, sizeof(int8_t), chunk, partFile) != chunk) {
+			fprintf(stderr, "ERROR %s: Part file ended early (%ld bytes remaining), exiting.\n", __func__, bytes);
+			return -1;
+		}
+		if (lofar_udp_io_write(outConfig, out, buffer, chunk) != chunk) {
+			fprintf(stderr, "ERROR %s: Failed to write %ld bytes to output %d, exiting.\n", __func__, chunk, out);
+			return -1;
+		}
+		bytes -= chunk;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Get the number of packets missing between the end of the previous shard and the start of a shard
+ *
+ * @param[in]  shards  The (sorted) shards
+ * @param[in]  shard   The shard index
+ *
+ * @return     Packets (per port) missing before the shard, negative if the shards overlap
+ */
+static int64_t _lofar_udp_shard_edge_gap(const lofar_udp_shard shards[], const int32_t shard) {
+	if (shard < 1) {
+		return 0;
+	}
+
+	return shards[shard].firstPacket - (shards[shard - 1].firstPacket + shards[shard - 1].packetsWritten);
+}
+
+/**
+ * @brief      Write the output for packets missing between the previous shard and a shard, following the reader's
+ * 				policy for dropped packets (zeros, or a replay of the last packet written)
+ *
+ * @param[in]  shards     The (sorted) shards
+ * @param[in]  shard      The shard after the gap
+ * @param      outConfig  The output configuration
+ * @param[in]  out        The output index
+ * @param      buffer     A UPM_SHARD_COPY_LENGTH long working buffer
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_shard_pad(const lofar_udp_shard shards[], const int32_t shard, lofar_udp_io_write_config *outConfig, const int8_t out, int8_t *buffer) {
+	const int64_t edgeGap = _lofar_udp_shard_edge_gap(shards, shard);
+	const int64_t packetLength = shards[shard].packetOutputLength[out];
+	if (edgeGap < 1) {
+		return 0;
+	}
+
+	if (packetLength < 1 || packetLength > UPM_SHARD_COPY_LENGTH) {
+		fprintf(stderr, "ERROR %s: Cannot pad output %d with packets of %ld bytes, exiting.\n", __func__, out, packetLength);
+		return -1;
+	}
+
+	// The last packet of the previous shard is at the end of its part file for every supported format
+	if (shards[shard].replayDroppedPackets && shards[shard - 1].outputBytes[out] >= packetLength) {
+		FILE *partFile = fopen(shards[shard - 1].outputLocations[out], "rb");
+		if (partFile == NULL) {
+			fprintf(stderr, "ERROR %s: Failed to open part file %s (errno %d: %s), exiting.\n", __func__, shards[shard - 1].outputLocations[out], errno, strerror(errno));
+			return -1;
+		}
+		const int8_t readFailed = fseeko(partFile, -1 * packetLength, SEEK_END) != 0 || (int64_t) fread(buffer, sizeof(int8_t), packetLength, partFile) != packetLength;
+		fclose(partFile);
+		if (readFailed) {
+			fprintf(stderr, "ERROR %s: Failed to read the last packet of %s, exiting.\n", __func__, shards[shard - 1].outputLocations[out]);
+			return -1;
+		}
+	} else {
+		memset(buffer, 0, packetLength);
+	}
+
+	int64_t chunkPackets = UPM_SHARD_COPY_LENGTH / packetLength;
+	chunkPackets = chunkPackets < edgeGap ? chunkPackets : edgeGap;
+	for (int64_t packet = 1; packet < chunkPackets; packet++) {
+		memcpy(&(buffer[packet * packetLength]), buffer, packetLength);
+	}
+
+	for (int64_t packetsRemaining = edgeGap; packetsRemaining > 0; packetsRemaining -= chunkPackets) {
+		const int64_t chunk = (packetsRemaining < chunkPackets ? packetsRemaining : chunkPackets) * packetLength;
+		if (lofar_udp_io_write(outConfig, out, buffer, chunk) != chunk) {
+			fprintf(stderr, "ERROR %s: Failed to write %ld bytes of padding to output %d, exiting.\n", __func__, chunk, out);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Find a key in a sigproc header
+ *
+ * @param[in]  header        The header
+ * @param[in]  headerLength  The header length
+ * @param[in]  key           The key
+ *
+ * @return     >=0: Offset of the key's length prefix, <0: Key not found
+ */
+static int64_t _lofar_udp_shard_find_SIGPROC(const int8_t *header, const int64_t headerLength, const char key[]) {
+	const int32_t keyLength = (int32_t) strlen(key);
+	const int64_t entryLength = (int64_t) sizeof(int32_t) + keyLength;
+
+	for (int64_t offset = 0; offset + entryLength <= headerLength; offset++) {
+		if (memcmp(&(header[offset]), &keyLength, sizeof(int32_t)) == 0 && memcmp(&(header[offset + sizeof(int32_t)]), key, keyLength) == 0) {
+			return offset;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * @brief      Add the number of samples in the stitched output to a sigproc header
+ *
+ * @param      header        The header (DEF_HDR_LEN long)
+ * @param      headerLength  The header length, updated if the header grows
+ * @param[in]  dataBytes     The stitched data length
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_shard_fix_SIGPROC(int8_t *header, int64_t *headerLength, const int64_t dataBytes) {
+	const char *sampleKeys[3] = { "nbits", "nchans", "nifs" };
+	int32_t sampleValues[3];
+	for (int8_t key = 0; key < 3; key++) {
+		const int64_t offset = _lofar_udp_shard_find_SIGPROC(header, *headerLength, sampleKeys[key]);
+		const int64_t valueOffset = offset + (int64_t) (sizeof(int32_t) + strlen(sampleKeys[key]));
+		if (offset < 0 || valueOffset + (int64_t) sizeof(int32_t) > *headerLength) {
+			fprintf(stderr, "ERROR %s: Failed to find %s in sigproc header, exiting.\n", __func__, sampleKeys[key]);
+			return -1;
+		}
+		memcpy(&(sampleValues[key]), &(header[valueOffset]), sizeof(int32_t));
+		if (sampleValues[key] < 1) {
+			fprintf(stderr, "ERROR %s: Invalid %s in sigproc header (%d), exiting.\n", __func__, sampleKeys[key], sampleValues[key]);
+			return -1;
+		}
+	}
+
+	const int64_t nsamples = dataBytes * 8 / ((int64_t) sampleValues[0] * sampleValues[1] * sampleValues[2]);
+	if (nsamples > INT32_MAX) {
+		fprintf(stderr, "WARNING %s: Stitched output has too many samples for a sigproc header (%ld), nsamples will not be set.\n", __func__, nsamples);
+		return 0;
+	}
+
+	const int64_t existingOffset = _lofar_udp_shard_find_SIGPROC(header, *headerLength, "nsamples");
+	if (existingOffset >= 0) {
+		const int32_t value = (int32_t) nsamples;
+		memcpy(&(header[existingOffset + sizeof(int32_t) + strlen("nsamples")]), &value, sizeof(int32_t));
+		return 0;
+	}
+
+	// Otherwise, insert the value before the end of the header
+	const int64_t endOffset = _lofar_udp_shard_find_SIGPROC(header, *headerLength, "HEADER_END");
+	if (endOffset < 0) {
+		fprintf(stderr, "ERROR %s: Failed to find the end of the sigproc header, exiting.\n", __func__);
+		return -1;
+	}
+
+	char *workingBuffer = (char *) &(header[endOffset]);
+	int64_t workingBufferLen = DEF_HDR_LEN - endOffset;
+	workingBuffer = _writeInt_SIGPROC(workingBuffer, workingBufferLen, "nsamples", (int32_t) nsamples);
+	workingBufferLen = DEF_HDR_LEN - (workingBuffer - (char *) header);
+	workingBuffer = _writeKey_SIGPROC(workingBuffer, &workingBufferLen, "HEADER_END");
+	if (workingBuffer == NULL) {
+		fprintf(stderr, "ERROR %s: Failed to add nsamples to sigproc header, exiting.\n", __func__);
+		return -1;
+	}
+	*headerLength = workingBuffer - (char *) header;
+
+	return 0;
+}
+
+/**
+ * @brief      Update the packet totals of a DADA header to cover the stitched output
+ *
+ * @param      header            The header (DEF_HDR_LEN long, NULL terminated)
+ * @param      headerLength      The header length, updated if the header grows
+ * @param[in]  processedPackets  Packets (all ports) covered by the stitched output
+ * @param[in]  droppedPackets    Packets (all ports) lost in the stitched output
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_shard_fix_DADA(int8_t *header, int64_t *headerLength, const int64_t processedPackets, const int64_t droppedPackets) {
+	char *workingBuffer = (char *) header;
+	int32_t returnVal = 0;
+	returnVal += _writeLong_DADA(workingBuffer, "UPM_PROCPKT", processedPackets);
+	returnVal += _writeLong_DADA(workingBuffer, "UPM_DRPPKT", droppedPackets);
+	// Match the writer, the size is measured before the size key is updated
+	returnVal += _writeLong_DADA(workingBuffer, "HDR_SIZE", (int64_t) strnlen(workingBuffer, DEF_HDR_LEN));
+
+	if (returnVal < 0) {
+		fprintf(stderr, "ERROR %s: Failed to update DADA header packet totals, exiting.\n", __func__);
+		return -1;
+	}
+	*headerLength = (int64_t) strnlen(workingBuffer, DEF_HDR_LEN);
+
+	return 0;
+}
+
+/**
+ * @brief      Stitch an output where a single header is written at the start of each part file (DADA, sigproc)
+ *
+ * @param[in]  shards            The (sorted) shards
+ * @param[in]  numShards         The number of shards
+ * @param      outConfig         The output configuration
+ * @param[in]  out               The output index
+ * @param[in]  processedPackets  Packets (all ports) covered by the stitched output
+ * @param[in]  droppedPackets    Packets (all ports) lost in the stitched output
+ * @param      buffer            A UPM_SHARD_COPY_LENGTH long working buffer
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_shard_stitch_single_header(const lofar_udp_shard shards[], const int32_t numShards, lofar_udp_io_write_config *outConfig, const int8_t out,
+                                                     const int64_t processedPackets, const int64_t droppedPackets, int8_t *buffer) {
+	int64_t dataBytes = 0;
+	for (int32_t shard = 0; shard < numShards; shard++) {
+		dataBytes += shards[shard].outputBytes[out] + _lofar_udp_shard_edge_gap(shards, shard) * shards[shard].packetOutputLength[out];
+	}
+
+	int8_t *header = calloc(DEF_HDR_LEN + 1, sizeof(int8_t));
+	CHECK_ALLOC_NOCLEAN(header, -1);
+
+	int32_t returnVal = 0;
+	for (int32_t shard = 0; shard < numShards && returnVal == 0; shard++) {
+		FILE *partFile = fopen(shards[shard].outputLocations[out], "rb");
+		if (partFile == NULL) {
+			fprintf(stderr, "ERROR %s: Failed to open part file %s (errno %d: %s), exiting.\n", __func__, shards[shard].outputLocations[out], errno, strerror(errno));
+			returnVal = -1;
+			break;
+		}
+
+		int64_t headerLength = _FILE_file_size(partFile) - shards[shard].outputBytes[out];
+		if (headerLength < 1 || headerLength > DEF_HDR_LEN) {
+			fprintf(stderr, "ERROR %s: Part file %s does not match its manifest (%ld header bytes), exiting.\n", __func__, shards[shard].outputLocations[out], headerLength);
+			returnVal = -1;
+		} else if (shard == 0) {
+			// Only the first header is kept, it already describes the start of the observation
+			if ((int64_t) fread(header, sizeof(int8_t), headerLength, partFile) != headerLength) {
+				fprintf(stderr, "ERROR %s: Failed to read header from %s, exiting.\n", __func__, shards[shard].outputLocations[out]);
+				returnVal = -1;
+			} else if (shards[0].metadataType == DADA && _lofar_udp_shard_fix_DADA(header, &headerLength, processedPackets, droppedPackets) < 0) {
+				returnVal = -1;
+			} else if (shards[0].metadataType == SIGPROC && _lofar_udp_shard_fix_SIGPROC(header, &headerLength, dataBytes) < 0) {
+				returnVal = -1;
+			} else if (lofar_udp_io_write(outConfig, out, header, headerLength) != headerLength) {
+				fprintf(stderr, "ERROR %s: Failed to write header to output %d, exiting.\n", __func__, out);
+				returnVal = -1;
+			}
+		} else if (fseeko(partFile, headerLength, SEEK_SET) != 0) {
+			fprintf(stderr, "ERROR %s: Failed to skip header of %s (errno %d: %s), exiting.\n", __func__, shards[shard].outputLocations[out], errno, strerror(errno));
+			returnVal = -1;
+		}
+
+		if (returnVal == 0) {
+			returnVal = _lofar_udp_shard_pad(shards, shard, outConfig, out, buffer);
+		}
+		if (returnVal == 0) {
+			returnVal = _lofar_udp_shard_copy(partFile, outConfig, out, shards[shard].outputBytes[out], buffer);
+		}
+		fclose(partFile);
+	}
+
+	free(header);
+	return returnVal;
+}
+
+/**
+ * @brief      Parse the value of a GUPPI header card
+ *
+ * @param[in]  card   The card
+ * @param[out] value  The parsed value
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_shard_card_value_GUPPI(const char *card, double *value) {
+	char cardStr[GUPPI_CARD_LEN + 1];
+	memcpy(cardStr, card, GUPPI_CARD_LEN);
+	cardStr[GUPPI_CARD_LEN] = '\0';
+
+	char *endPtr;
+	*value = strtod(&(cardStr[10]), &endPtr);
+	if (endPtr == &(cardStr[10])) {
+		fprintf(stderr, "ERROR %s: Failed to parse GUPPI card (%s), exiting.\n", __func__, cardStr);
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Convert the header of the last block written before a gap between shards into the header of a block
+ * 				covering the gap
+ *
+ * @param      header        The header
+ * @param[in]  headerLength  The header length
+ * @param[in]  blockSize     BLOCSIZE of the gap block
+ * @param[in]  pktidx        PKTIDX of the gap block
+ * @param[in]  droptot       DROPTOT after the gap block
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_shard_gap_header_GUPPI(char *header, const int64_t headerLength, const int64_t blockSize, const int64_t pktidx, const double droptot) {
+	const char *keys[4] = { "BLOCSIZE", "PKTIDX", "DROPBLK", "DROPTOT" };
+	char newCard[GUPPI_CARD_LEN + 1];
+
+	for (int8_t key = 0; key < 4; key++) {
+		char *cardEnd;
+		if (key < 2) {
+			cardEnd = _writeLong_GUPPI(newCard, GUPPI_CARD_LEN + 1, keys[key], key == 0 ? blockSize : pktidx);
+		} else {
+			// The entire block was lost
+			cardEnd = _writeDouble_GUPPI(newCard, GUPPI_CARD_LEN + 1, keys[key], key == 2 ? 1.0 : droptot, 0);
+		}
+		if (cardEnd != &(newCard[GUPPI_CARD_LEN])) {
+			return -1;
+		}
+
+		// Cards start with the padded key and '=', match on that prefix
+		int64_t cardOffset = 0;
+		while (cardOffset < headerLength && strncmp(&(header[cardOffset]), newCard, 9) != 0) {
+			cardOffset += GUPPI_CARD_LEN;
+		}
+		if (cardOffset < headerLength) {
+			memcpy(&(header[cardOffset]), newCard, GUPPI_CARD_LEN);
+		} else if (key < 2) {
+			fprintf(stderr, "ERROR %s: GUPPI header is missing %s, exiting.\n", __func__, keys[key]);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * @brief      Stitch an output where a GUPPI header is written for every block
+ *
+ * @param[in]  shards     The (sorted) shards
+ * @param[in]  numShards  The number of shards
+ * @param      outConfig  The output configuration
+ * @param[in]  out        The output index
+ * @param      buffer     A UPM_SHARD_COPY_LENGTH long working buffer
+ *
+ * @return     0: Success, <0: Failure
+ */
+static int32_t _lofar_udp_shard_stitch_GUPPI(const lofar_udp_shard shards[], const int32_t numShards, lofar_udp_io_write_config *outConfig, const int8_t out, int8_t *buffer) {
+	const char *startKeys[3] = { "STT_IMJD", "STT_SMJD", "STT_OFFS" };
+	char startCards[3][GUPPI_CARD_LEN];
+	int8_t startCardsSet[3] = { 0, 0, 0 };
+	char newCard[GUPPI_CARD_LEN + 1];
+
+	// Dropped data is accumulated in bytes so that blocks of different lengths are weighted correctly
+	double droppedBytes = 0.0, totalBytes = 0.0;
+
+	char *header = calloc(DEF_HDR_LEN + 1, sizeof(char));
+	CHECK_ALLOC_NOCLEAN(header, -1);
+
+	int32_t returnVal = 0;
+	int64_t lastHeaderLength = 0;
+	for (int32_t shard = 0; shard < numShards && returnVal == 0; shard++) {
+		FILE *partFile = fopen(shards[shard].outputLocations[out], "rb");
+		if (partFile == NULL) {
+			fprintf(stderr, "ERROR %s: Failed to open part file %s (errno %d: %s), exiting.\n", __func__, shards[shard].outputLocations[out], errno, strerror(errno));
+			returnVal = -1;
+			break;
+		}
+
+		// Packets missing between shards are written as a dropped block, described by the header of the block before them
+		const int64_t edgeGap = _lofar_udp_shard_edge_gap(shards, shard);
+		if (edgeGap > 0) {
+			const int64_t gapStart = shards[shard - 1].firstPacket + shards[shard - 1].packetsWritten - shards[0].firstPacket;
+			droppedBytes += (double) (edgeGap * shards[shard].packetOutputLength[out]);
+			totalBytes += (double) (edgeGap * shards[shard].packetOutputLength[out]);
+
+			if (lastHeaderLength < 1) {
+				fprintf(stderr, "ERROR %s: Shard %d has no blocks to describe the following gap, exiting.\n", __func__, shard - 1);
+				returnVal = -1;
+			} else if (_lofar_udp_shard_gap_header_GUPPI(header, lastHeaderLength, edgeGap * shards[shard].packetOutputLength[0], gapStart, droppedBytes / totalBytes) < 0) {
+				returnVal = -1;
+			} else if (lofar_udp_io_write(outConfig, out, (int8_t *) header, lastHeaderLength) != lastHeaderLength) {
+				fprintf(stderr, "ERROR %s: Failed to write header to output %d, exiting.\n", __func__, out);
+				returnVal = -1;
+			} else {
+				returnVal = _lofar_udp_shard_pad(shards, shard, outConfig, out, buffer);
+			}
+
+			if (returnVal < 0) {
+				fclose(partFile);
+				break;
+			}
+		}
+
+		const int64_t packetOffset = shards[shard].firstPacket - shards[0].firstPacket;
+		int64_t dataRemaining = shards[shard].outputBytes[out];
+		while (returnVal == 0 && dataRemaining > 0) {
+			// Read the header, one card at a time
+			int64_t headerLength = 0;
+			int64_t blockSize = -1, pktidxCard = -1, dropblkCard = -1, droptotCard = -1;
+			double dropblk = 0.0;
+			int8_t endFound = 0;
+			while (!endFound) {
+				if (headerLength + GUPPI_CARD_LEN > DEF_HDR_LEN || fread(&(header[headerLength]), sizeof(char), GUPPI_CARD_LEN, partFile) != GUPPI_CARD_LEN) {
+					fprintf(stderr, "ERROR %s: Failed to read a GUPPI header from %s, exiting.\n", __func__, shards[shard].outputLocations[out]);
+					returnVal = -1;
+					break;
+				}
+
+				const char *card = &(header[headerLength]);
+				double value;
+				if (strncmp(card, "END ", 4) == 0) {
+					endFound = 1;
+				} else if (strncmp(card, "BLOCSIZE=", 9) == 0) {
+					returnVal = _lofar_udp_shard_card_value_GUPPI(card, &value);
+					blockSize = (int64_t) value;
+				} else if (strncmp(card, "PKTIDX  =", 9) == 0) {
+					pktidxCard = headerLength;
+				} else if (strncmp(card, "DROPBLK =", 9) == 0) {
+					returnVal = _lofar_udp_shard_card_value_GUPPI(card, &dropblk);
+					dropblkCard = headerLength;
+				} else if (strncmp(card, "DROPTOT =", 9) == 0) {
+					droptotCard = headerLength;
+				} else {
+					for (int8_t key = 0; key < 3; key++) {
+						if (strncmp(card, startKeys[key], strlen(startKeys[key])) == 0) {
+							// Every block takes the start time of the first shard
+							if (!startCardsSet[key]) {
+								memcpy(startCards[key], card, GUPPI_CARD_LEN);
+								startCardsSet[key] = 1;
+							} else {
+								memcpy(&(header[headerLength]), startCards[key], GUPPI_CARD_LEN);
+							}
+						}
+					}
+				}
+				headerLength += GUPPI_CARD_LEN;
+
+				if (returnVal < 0) {
+					break;
+				}
+			}
+			if (returnVal < 0) {
+				break;
+			}
+
+			if (blockSize < 1 || pktidxCard < 0 || shards[shard].packetOutputLength[0] < 1) {
+				fprintf(stderr, "ERROR %s: GUPPI header in %s is missing BLOCSIZE or PKTIDX, exiting.\n", __func__, shards[shard].outputLocations[out]);
+				returnVal = -1;
+				break;
+			}
+
+			// BLOCSIZE describes the first output, scale it for the others
+			int64_t blockBytes = blockSize / shards[shard].packetOutputLength[0] * shards[shard].packetOutputLength[out];
+			blockBytes = blockBytes < dataRemaining ? blockBytes : dataRemaining;
+
+			// PKTIDX is relative to the start of the shard, offset it to the start of the first shard
+			double pktidx;
+			if (_lofar_udp_shard_card_value_GUPPI(&(header[pktidxCard]), &pktidx) < 0
+				|| _writeLong_GUPPI(newCard, GUPPI_CARD_LEN + 1, "PKTIDX", (int64_t) pktidx + packetOffset) != &(newCard[GUPPI_CARD_LEN])) {
+				returnVal = -1;
+				break;
+			}
+			memcpy(&(header[pktidxCard]), newCard, GUPPI_CARD_LEN);
+
+			// DROPTOT covers every block written so far
+			if (dropblkCard >= 0) {
+				droppedBytes += dropblk * (double) blockBytes;
+			}
+			totalBytes += (double) blockBytes;
+			if (droptotCard >= 0) {
+				if (_writeDouble_GUPPI(newCard, GUPPI_CARD_LEN + 1, "DROPTOT", droppedBytes / totalBytes, 0) != &(newCard[GUPPI_CARD_LEN])) {
+					returnVal = -1;
+					break;
+				}
+				memcpy(&(header[droptotCard]), newCard, GUPPI_CARD_LEN);
+			}
+
+			if (lofar_udp_io_write(outConfig, out, (int8_t *) header, headerLength) != headerLength) {
+				fprintf(stderr, "ERROR %s: Failed to write header to output %d, exiting.\n", __func__, out);
+				returnVal = -1;
+				break;
+			}
+			returnVal = _lofar_udp_shard_copy(partFile, outConfig, out, blockBytes, buffer);
+			dataRemaining -= blockBytes;
+			lastHeaderLength = headerLength;
+		}
+
+		fclose(partFile);
+	}
+
+	free(header);
+	return returnVal;
+}
+
+static int _lofar_udp_shard_compare(const void *a, const void *b) {
+	const int32_t shardA = ((const lofar_udp_shard *) a)->shard;
+	const int32_t shardB = ((const lofar_udp_shard *) b)->shard;
+	return (shardA > shardB) - (shardA < shardB);
+}
+
+/**
+ * @brief      Concatenate the part files of a set of shards into a single set of outputs, correcting the metadata to describe the full observation
+ *
+ * @param      shards     The shard descriptions (sorted in place)
+ * @param[in]  numShards  The number of shards
+ * @param      outConfig  The output configuration (parsed, not set up), the outputs are left open for the caller to clean up
+ *
+ * @return     >=0: Total packets lost in the stitched observation, <0: Failure
+ */
+int64_t lofar_udp_shard_stitch(lofar_udp_shard shards[], const int32_t numShards, lofar_udp_io_write_config *outConfig) {
+	if (shards == NULL || outConfig == NULL || numShards < 1) {
+		fprintf(stderr, "ERROR %s: Invalid input (shards: %p, numShards: %d, outConfig: %p), exiting.\n", __func__, shards, numShards, outConfig);
+		return -1;
+	}
+
+	qsort(shards, numShards, sizeof(lofar_udp_shard), _lofar_udp_shard_compare);
+
+	for (int32_t shard = 0; shard < numShards; shard++) {
+		if (shards[shard].shard != shard || shards[shard].numShards != numShards) {
+			fprintf(stderr, "ERROR %s: Expected shard %d of %d, but found shard %d of %d, exiting.\n", __func__, shard, numShards, shards[shard].shard, shards[shard].numShards);
+			return -2;
+		}
+
+		int8_t mismatch = shards[shard].numPorts != shards[0].numPorts || shards[shard].numOutputs != shards[0].numOutputs
+			|| shards[shard].metadataType != shards[0].metadataType || shards[shard].replayDroppedPackets != shards[0].replayDroppedPackets;
+		for (int8_t out = 0; !mismatch && out < shards[0].numOutputs; out++) {
+			mismatch |= shards[shard].packetOutputLength[out] != shards[0].packetOutputLength[out];
+		}
+		if (mismatch) {
+			fprintf(stderr, "ERROR %s: Shard %d was processed with a different configuration to shard 0, exiting.\n", __func__, shard);
+			return -2;
+		}
+	}
+
+	if (shards[0].metadataType == HDF5_META) {
+		fprintf(stderr, "ERROR %s: HDF5 outputs cannot be stitched, exiting.\n", __func__);
+		return -3;
+	}
+
+	switch (outConfig->readerType) {
+		case NORMAL:
+		case FIFO:
+		case ZSTDCOMPRESSED:
+		case ZSTDCOMPRESSED_INDIRECT:
+			break;
+
+		default:
+			fprintf(stderr, "ERROR %s: Stitched outputs can only be written to files, FIFOs or zstandard compressed files (%d), exiting.\n", __func__, outConfig->readerType);
+			return -3;
+	}
+
+	// Packets missing between the end of a shard and the start of the next are counted as dropped on every port
+	int64_t droppedPackets = shards[0].droppedPackets;
+	for (int32_t shard = 1; shard < numShards; shard++) {
+		const int64_t edgeGap = _lofar_udp_shard_edge_gap(shards, shard);
+		if (edgeGap < 0) {
+			fprintf(stderr, "ERROR %s: Shard %d overlaps shard %d by %ld packets, exiting.\n", __func__, shard, shard - 1, -1 * edgeGap);
+			return -4;
+		} else if (edgeGap > 0) {
+			fprintf(stderr, "WARNING %s: %ld packets are missing between shards %d and %d, they will be %s.\n", __func__, edgeGap, shard - 1, shard,
+			        shards[shard].replayDroppedPackets ? "replayed" : "zero-padded");
+		}
+		droppedPackets += edgeGap * shards[shard].numPorts + shards[shard].droppedPackets;
+	}
+	const int64_t processedPackets = (shards[numShards - 1].firstPacket + shards[numShards - 1].packetsWritten - shards[0].firstPacket) * shards[0].numPorts;
+
+	int64_t *outputLength = calloc(shards[0].numOutputs, sizeof(int64_t));
+	CHECK_ALLOC_NOCLEAN(outputLength, -1);
+	for (int8_t out = 0; out < shards[0].numOutputs; out++) {
+		outputLength[out] = UPM_SHARD_COPY_LENGTH;
+	}
+	const int32_t setupReturn = lofar_udp_io_write_setup_helper(outConfig, outputLength, shards[0].numOutputs, 0, shards[0].firstPacket);
+	free(outputLength);
+	if (setupReturn < 0) {
+		fprintf(stderr, "ERROR %s: Failed to open stitched outputs, exiting.\n", __func__);
+		return -5;
+	}
+
+	int8_t *buffer = calloc(UPM_SHARD_COPY_LENGTH, sizeof(int8_t));
+	CHECK_ALLOC_NOCLEAN(buffer, -1);
+
+	int32_t returnVal = 0;
+	for (int8_t out = 0; out < shards[0].numOutputs && returnVal == 0; out++) {
+		switch (shards[0].metadataType) {
+			case GUPPI:
+				returnVal = _lofar_udp_shard_stitch_GUPPI(shards, numShards, outConfig, out, buffer);
+				break;
+
+			case DADA:
+			case SIGPROC:
+				returnVal = _lofar_udp_shard_stitch_single_header(shards, numShards, outConfig, out, processedPackets, droppedPackets, buffer);
+				break;
+
+			// No metadata, the part files are plain data
+			default:
+				for (int32_t shard = 0; shard < numShards && returnVal == 0; shard++) {
+					FILE *partFile = fopen(shards[shard].outputLocations[out], "rb");
+					if (partFile == NULL) {
+						fprintf(stderr, "ERROR %s: Failed to open part file %s (errno %d: %s), exiting.\n", __func__, shards[shard].outputLocations[out], errno, strerror(errno));
+						returnVal = -1;
+						break;
+					}
+					returnVal = _lofar_udp_shard_pad(shards, shard, outConfig, out, buffer);
+					if (returnVal == 0) {
+						returnVal = _lofar_udp_shard_copy(partFile, outConfig, out, shards[shard].outputBytes[out], buffer);
+					}
+					fclose(partFile);
+				}
+				break;
+		}
+	}
+	free(buffer);
+
+	if (returnVal < 0) {
+		return -6;
+	}
+
+	return droppedPackets;
+}
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
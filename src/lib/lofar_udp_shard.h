@@ -0,0 +1,56 @@
+#ifndef LOFAR_UDP_SHARD_H
+#define LOFAR_UDP_SHARD_H
+
+#include "lofar_udp_reader.h"
+
+// Part file / manifest parameters
+#define UPM_SHARD_PART_FMT ".part%d"
+#define UPM_SHARD_SUFFIX ".upmshard"
+#define UPM_SHARD_MAGIC "UPMSHRD"
+#define UPM_SHARD_MAGIC_LEN 8
+#define UPM_SHARD_VERSION 3
+
+// Bytes copied from a part file per write when stitching
+#define UPM_SHARD_COPY_LENGTH (16 * 1024 * 1024)
+
+// Allow C++ imports too
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shard processing
+int32_t lofar_udp_shard_range(int64_t startingPacket, int64_t packets, int64_t packetsPerIteration, int32_t shard, int32_t numShards, int64_t *shardStart, int64_t *shardPackets);
+int32_t lofar_udp_shard_output_format(lofar_udp_io_write_config *outConfig, int32_t shard);
+int32_t lofar_udp_shard_setup(lofar_udp_shard *shard, const lofar_udp_reader *reader, const lofar_udp_io_write_config *outConfig, int32_t shardIdx, int32_t numShards);
+
+// Manifest storage
+int32_t lofar_udp_shard_get_location(char *dest, const char outputLocation[]);
+int32_t lofar_udp_shard_write(const lofar_udp_shard *shard, const char shardLocation[]);
+int32_t lofar_udp_shard_load(lofar_udp_shard *shard, const char shardLocation[]);
+
+// Stitching
+int64_t lofar_udp_shard_stitch(lofar_udp_shard shards[], int32_t numShards, lofar_udp_io_write_config *outConfig);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LOFAR_UDP_SHARD_H
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
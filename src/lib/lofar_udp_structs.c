@@ -6,54 +6,115 @@
 // Reader struct default
 const lofar_udp_io_read_config lofar_udp_io_read_config_default = {
 	.readerType = NO_ACTION,
-	.readBufSize = { -1 }, // NEEDS FULL RUNTIME INITIALISATION
-	.portPacketLength = { -1 }, // NEEDS FULL RUNTIME INITIALISATION
+	.readBufSize = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.portPacketLength = NULL, // NEEDS FULL RUNTIME INITIALISATION
 	.numInputs = 0,
+	.allocatedPorts = 0,
 
 	// Reader requires space before the buffer, note for any reallocs
-	.preBufferSpace = { 0 }, // NEEDS FULL RUNTIME INITIALISATION
+	.preBufferSpace = NULL, // NEEDS FULL RUNTIME INITIALISATION
 							 // Set to 0 to assume no use as default
+	.inputRing = NULL,
+	.inputRingSize = NULL,
+	.inputMap = NULL,
+	.inputMapSize = NULL,
+	.inputMapReleased = NULL,
+	.inputWindow = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.inputWindowSize = NULL,
+	.inputWindowPrefix = NULL,
+	.inputWindowMapStart = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.inputWindowMapLength = NULL,
+	.inputAdvised = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.inputEvicted = NULL,
+	.followTimeout = 0.0f,
+	.followNotify = NULL, // NEEDS FULL RUNTIME INITIALISATION
 
 	// Inputs pre- and post-formatting
-	.inputLocations = { "" }, // NEEDS FULL RUNTIME INITIALISATION
-	.inputDadaKeys = { -1 }, // NEEDS FULL RUNTIME INITIALISATION
+	.inputLocations = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.inputDadaKeys = NULL, // NEEDS FULL RUNTIME INITIALISATION
 	.basePort = 0,
 	.offsetPortCount = 0,
 	.stepSizePort = 1,
 
-	.dstream = { NULL }, // NEEDS FULL RUNTIME INITIALISATION
-	.dadaReader = { NULL }, // NEEDS FULL RUNTIME INITIALISATION
+	.fileRef = NULL,
+	.fileList = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.dstream = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.dadaReader = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.uringReader = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.udpReader = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.pcapReader = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.hdf5Reader = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.shmReader = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.streamOffset = NULL,
+	.lastReadOffset = NULL,
 
 	// Associated objects
-	.readingTracker = { { NULL, 0, 0 } }, // NEEDS FULL RUNTIME INITIALISATION
-	.decompressionTracker = { { NULL, 0, 0 } }, // NEEDS FULL RUNTIME INITIALISATION
-	.zstdLastRead = { 0 }, // NEEDS FULL RUNTIME INITIALISATION
-	.multilog = { NULL }, // NEEDS FULL RUNTIME INITIALISATION
-	.dadaPageSize = { -1 } // NEEDS FULL RUNTIME INITIALISATION
+	.readingTracker = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.decompressionTracker = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.zstdLastRead = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.zstdFrameBoundary = NULL,
+	.frameDCtx = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.zstdAnchors = NULL,
+	.zstdAnchorCount = NULL,
+	.zstdFilter = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.multilog = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.dadaPageSize = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.dadaBlock = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.dadaBlockSize = NULL,
+	.dadaBlockOffset = NULL,
+	.dadaCarry = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.dadaCarrySize = NULL,
+	.dadaCarryOffset = NULL,
+	.dadaCarryLength = NULL,
+
+	// Optional packet index
+	.packetIndex = NULL // NEEDS FULL RUNTIME INITIALISATION
+};
+
+// Packet index default
+const lofar_udp_index lofar_udp_index_default = {
+	.version = 0,
+	.readerType = NO_ACTION,
+	.packetLength = -1,
+	.stride = -1,
+
+	.inputSize = -1,
+	.firstPacket = -1,
+	.lastPacket = -1,
+	.totalPackets = 0,
+	.totalDropped = 0,
+
+	.numEntries = 0,
+	.entries = NULL
 };
 
 // Writer struct default
 const lofar_udp_io_write_config lofar_udp_io_write_config_default = {
 	// Control options
 	.readerType = NO_ACTION,
-	.writeBufSize = { -1 }, // NEEDS FULL RUNTIME INITIALISATION
+	.writeBufSize = NULL, // NEEDS FULL RUNTIME INITIALISATION
 	.progressWithExisting = 0,
 	.numOutputs = 0,
+	.allocatedOutputs = 0,
 
 	// Outputs pre- and post-formatting
 	.outputFormat = "",
-	.outputLocations = { "" },
-	.outputDadaKeys = { -1, }, // NEEDS FULL RUNTIME INITIALISATION
+	.outputLocations = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.outputDadaKeys = NULL, // NEEDS FULL RUNTIME INITIALISATION
 	.baseVal = 0,
 	.stepSize = 1,
 	.firstPacket = 0,
+	.resumeCheckpoint = NULL,
 
 	// Main writing objects
-	.outputFiles = { NULL, },
-	.zstdWriter = { { NULL, { NULL, 0, 0 } } },
-	.dadaWriter = { { NULL, NULL } },
+	.outputFiles = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.zstdWriter = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.dadaWriter = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.shmWriter = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.asyncWriter = NULL,
 	.hdf5Writer = { 0,
-	               .hdf5DSetWriter = {{ 0, { 0, 0 }}}
+	               .directChunks = 0,
+	               .hdf5DSetWriter = NULL // NEEDS FULL RUNTIME INITIALISATION
 	},
 
 
@@ -63,6 +124,12 @@ const lofar_udp_io_write_config lofar_udp_io_write_config_default = {
 		.compressionLevel = 3,
 		.numThreads = 2,
 		.enableSeek = -1, // Not implemented
+		.adaptive = 0,
+		.minLevel = 1,
+		.maxLevel = 19,
+		.frameSize = ZSTD_ADAPT_FRAME_SIZE,
+		.filter = ZSTD_FILTER_NONE,
+		.filterElementSize = ZSTD_FILTER_ELEMENT_SIZE,
 	},
 
 	// PSRDADA configuration
@@ -75,6 +142,13 @@ const lofar_udp_io_write_config lofar_udp_io_write_config_default = {
 		.cleanup_timeout = 30.0f
 	},
 
+	// Shared memory ring configuration
+	.shmConfig = {
+		.ringSize = -1,
+		.packetLength = 0,
+		.cleanupTimeout = 30.0f
+	},
+
 	// Misc options
 	.cparams = NULL, // ZSTD configuration
 	.externalChannelisation = 1,
@@ -92,8 +166,9 @@ const lofar_udp_calibration lofar_udp_calibration_default = {
 // Configuration default
 const lofar_udp_config lofar_udp_config_default = {
 	.readerType = NO_ACTION,
-	.inputLocations = { "" },
-	.inputDadaKeys = { -1 }, // NEEDS FULL RUNTIME INITIALISATION
+	.inputLocations = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.inputDadaKeys = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.allocatedPorts = 0,
 	.metadata_config = {
 		// Initialised by alloc func
 	},
@@ -104,15 +179,62 @@ const lofar_udp_config lofar_udp_config_default = {
 	.packetsPerIteration = 65536,
 	.startingPacket = -1,
 	.packetsReadMax = LONG_MAX,
+	.endPacket = -1,
 	.beamletLimits = { 0, 0 },
 	.calibrateData = NO_CALIBRATION,
 	.calibrationDuration = 3600.0f,
 	.ompThreads = OMP_THREADS,
-
+	.followTimeout = 0.0f,
 
 	.basePort = 0,
 	.offsetPortCount = 0,
-	.stepSizePort = 1
+	.stepSizePort = 1,
+
+	.resumeCheckpoint = NULL
+};
+
+// Checkpoint default
+const lofar_udp_checkpoint lofar_udp_checkpoint_default = {
+	.version = 0,
+	.readerType = NO_ACTION,
+	.processingMode = UNSET_MODE,
+	.numPorts = 0,
+	.numOutputs = 0,
+	.replayDroppedPackets = 0,
+
+	.calibrationStep = 0,
+	.packetsPerIteration = -1,
+	.lastPacket = -1,
+	.packetsRead = 0,
+	.packetsReadMax = LONG_MAX,
+
+	.outputFirstPacket = -1,
+
+	.ports = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.outputOffset = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.allocatedPorts = 0,
+	.allocatedOutputs = 0
+};
+
+// Shard default
+const lofar_udp_shard lofar_udp_shard_default = {
+	.version = 0,
+	.shard = -1,
+	.numShards = 0,
+
+	.numPorts = 0,
+	.numOutputs = 0,
+	.metadataType = NO_META,
+	.replayDroppedPackets = 0,
+
+	.firstPacket = -1,
+	.packetsWritten = 0,
+	.droppedPackets = 0,
+
+	.outputBytes = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.packetOutputLength = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.outputLocations = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.allocatedOutputs = 0
 };
 
 // Reader / meta with NULL-initialised values to help the cleanup function
@@ -128,15 +250,19 @@ const lofar_udp_reader lofar_udp_reader_default = {
 
 // meta with NULL-initialised values to help the cleanup function
 const lofar_udp_obs_meta lofar_udp_obs_meta_default = {
-	.inputData = { NULL },
-	.outputData = { NULL },
+	.allocatedPorts = 0,
+	.allocatedOutputs = 0,
+	.inputData = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.outputData = NULL, // NEEDS FULL RUNTIME INITIALISATION
+	.outputDataBuffers = NULL, // NEEDS FULL RUNTIME INITIALISATION
 	.packetsRead = 0,
 	.processingMode = UNSET_MODE,
 	.dataOrder = UNKNOWN,
 	.inputDataReady = 0,
 	.outputDataReady = 0,
 	.jonesMatrices = NULL,
-	.calibrationStep = 0
+	.calibrationStep = 0,
+	.gulpSummary = NULL // NEEDS FULL RUNTIME INITIALISATION
 };
 
 const metadata_config metadata_config_default = {
@@ -150,22 +276,101 @@ const metadata_config metadata_config_default = {
 lofar_udp_obs_meta *_lofar_udp_obs_meta_alloc() {
 	DEFAULT_STRUCT_ALLOC(lofar_udp_obs_meta, meta, lofar_udp_obs_meta_default, ;, NULL);
 
-	ARR_INIT(meta->inputData, MAX_NUM_PORTS, NULL);
-	ARR_INIT(meta->outputData, MAX_NUM_PORTS, NULL);
-	ARR_INIT(meta->inputDataOffset, MAX_NUM_PORTS, 0);
+	if (_lofar_udp_obs_meta_alloc_ports(meta, DEFAULT_NUM_PORTS) < 0 || _lofar_udp_obs_meta_alloc_outputs(meta, DEFAULT_NUM_OUTPUTS) < 0) {
+		_lofar_udp_obs_meta_cleanup(meta);
+		return NULL;
+	}
 
-	ARR_INIT(meta->portRawBeamlets, MAX_NUM_PORTS, -1);
-	ARR_INIT(meta->portRawCumulativeBeamlets, MAX_NUM_PORTS, -1);
+	return meta;
+}
 
-	ARR_INIT(meta->baseBeamlets, MAX_NUM_PORTS, 0);
-	ARR_INIT(meta->upperBeamlets, MAX_NUM_PORTS, -1);
-	ARR_INIT(meta->portCumulativeBeamlets, MAX_NUM_PORTS, -1);
-	ARR_INIT(meta->portPacketLength, MAX_NUM_PORTS, -1);
-	ARR_INIT(meta->packetOutputLength, MAX_NUM_PORTS, -1);
-	ARR_INIT(meta->portLastDroppedPackets, MAX_NUM_PORTS, 0);
-	ARR_INIT(meta->portTotalDroppedPackets, MAX_NUM_PORTS, 0);
+/**
+ * @brief Grow the per-port arrays of a meta struct to hold (at least) numPorts entries
+ *
+ * @param meta		The struct to update
+ * @param numPorts	The number of ports
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t _lofar_udp_obs_meta_alloc_ports(lofar_udp_obs_meta *meta, int8_t numPorts) {
+	CHECK_ALLOC_NOCLEAN(meta, -1);
+	const int8_t oldPorts = meta->allocatedPorts;
+	if (numPorts <= oldPorts) {
+		return 0;
+	}
 
-	return meta;
+	ARR_GROW(meta->inputData, oldPorts, numPorts);
+	ARR_GROW(meta->inputDataOffset, oldPorts, numPorts);
+	ARR_GROW(meta->portRawBeamlets, oldPorts, numPorts);
+	ARR_GROW(meta->portRawCumulativeBeamlets, oldPorts, numPorts);
+	ARR_GROW(meta->baseBeamlets, oldPorts, numPorts);
+	ARR_GROW(meta->upperBeamlets, oldPorts, numPorts);
+	ARR_GROW(meta->portCumulativeBeamlets, oldPorts, numPorts);
+	ARR_GROW(meta->portPacketLength, oldPorts, numPorts);
+	ARR_GROW(meta->portLastDroppedPackets, oldPorts, numPorts);
+	ARR_GROW(meta->portTotalDroppedPackets, oldPorts, numPorts);
+	ARR_GROW(meta->gulpSummary, oldPorts, numPorts);
+	meta->allocatedPorts = numPorts;
+
+	ARR_INIT(&(meta->portRawBeamlets[oldPorts]), numPorts - oldPorts, -1);
+	ARR_INIT(&(meta->portRawCumulativeBeamlets[oldPorts]), numPorts - oldPorts, -1);
+	ARR_INIT(&(meta->upperBeamlets[oldPorts]), numPorts - oldPorts, -1);
+	ARR_INIT(&(meta->portCumulativeBeamlets[oldPorts]), numPorts - oldPorts, -1);
+	ARR_INIT(&(meta->portPacketLength[oldPorts]), numPorts - oldPorts, -1);
+
+	return 0;
+}
+
+/**
+ * @brief Grow the per-output arrays of a meta struct to hold (at least) numOutputs entries
+ *
+ * @param meta			The struct to update
+ * @param numOutputs	The number of outputs
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t _lofar_udp_obs_meta_alloc_outputs(lofar_udp_obs_meta *meta, int8_t numOutputs) {
+	CHECK_ALLOC_NOCLEAN(meta, -1);
+	const int8_t oldOutputs = meta->allocatedOutputs;
+	if (numOutputs <= oldOutputs) {
+		return 0;
+	}
+
+	ARR_GROW(meta->outputData, oldOutputs, numOutputs);
+	ARR_GROW(meta->outputDataBuffers, oldOutputs, numOutputs);
+	ARR_GROW(meta->packetOutputLength, oldOutputs, numOutputs);
+	meta->allocatedOutputs = numOutputs;
+
+	ARR_INIT(&(meta->packetOutputLength[oldOutputs]), numOutputs - oldOutputs, -1);
+
+	return 0;
+}
+
+/**
+ * @brief Free a meta struct and its per-port / per-output arrays (the data buffers are not freed)
+ *
+ * @param meta	The struct to free
+ */
+void _lofar_udp_obs_meta_cleanup(lofar_udp_obs_meta *meta) {
+	if (meta == NULL) {
+		return;
+	}
+
+	FREE_NOT_NULL(meta->inputData);
+	FREE_NOT_NULL(meta->outputData);
+	FREE_NOT_NULL(meta->outputDataBuffers);
+	FREE_NOT_NULL(meta->inputDataOffset);
+	FREE_NOT_NULL(meta->portRawBeamlets);
+	FREE_NOT_NULL(meta->portRawCumulativeBeamlets);
+	FREE_NOT_NULL(meta->baseBeamlets);
+	FREE_NOT_NULL(meta->upperBeamlets);
+	FREE_NOT_NULL(meta->portCumulativeBeamlets);
+	FREE_NOT_NULL(meta->portPacketLength);
+	FREE_NOT_NULL(meta->packetOutputLength);
+	FREE_NOT_NULL(meta->portLastDroppedPackets);
+	FREE_NOT_NULL(meta->portTotalDroppedPackets);
+	FREE_NOT_NULL(meta->gulpSummary);
+	free(meta);
 }
 
 /**
@@ -195,65 +400,411 @@ lofar_udp_config* lofar_udp_config_alloc() {
 	DEFAULT_STRUCT_ALLOC(lofar_udp_config, config, lofar_udp_config_default, ;, NULL);
 	STRUCT_COPY_INIT(metadata_config, &(config->metadata_config), metadata_config_default);
 
-	STR_INIT(config->inputLocations, MAX_NUM_PORTS);
-	ARR_INIT(config->inputDadaKeys, MAX_NUM_PORTS, -1);
+	if (lofar_udp_config_alloc_ports(config, DEFAULT_NUM_PORTS) < 0) {
+		lofar_udp_config_cleanup(config);
+		return NULL;
+	}
 
 	return config;
 }
 
+/**
+ * @brief Grow the input arrays of a configuration to hold (at least) numPorts entries, needed before more than
+ * 			DEFAULT_NUM_PORTS inputs are described
+ *
+ * @param config	The configuration
+ * @param numPorts	The number of ports
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t lofar_udp_config_alloc_ports(lofar_udp_config *config, int8_t numPorts) {
+	CHECK_ALLOC_NOCLEAN(config, -1);
+	const int8_t oldPorts = config->allocatedPorts;
+	if (numPorts <= oldPorts) {
+		return 0;
+	}
+
+	ARR_GROW(config->inputLocations, oldPorts, numPorts);
+	ARR_GROW(config->inputDadaKeys, oldPorts, numPorts);
+	config->allocatedPorts = numPorts;
+
+	ARR_INIT(&(config->inputDadaKeys[oldPorts]), numPorts - oldPorts, -1);
+
+	return 0;
+}
+
 lofar_udp_io_read_config* lofar_udp_io_read_alloc() {
 	DEFAULT_STRUCT_ALLOC(lofar_udp_io_read_config, input, lofar_udp_io_read_config_default, ;, NULL);
 
-	ARR_INIT(input->readBufSize, MAX_NUM_PORTS, -1);
-	ARR_INIT(input->portPacketLength, MAX_NUM_PORTS, -1);
-	ARR_INIT(input->preBufferSpace, MAX_NUM_PORTS, 0); // Init as 0 default-value, only update on use
-	STR_INIT(input->inputLocations, MAX_NUM_PORTS);
-	ARR_INIT(input->inputDadaKeys, MAX_NUM_PORTS, -1);
-	ARR_INIT(input->fileRef, MAX_NUM_PORTS, NULL);
-	ARR_INIT(input->dstream, MAX_NUM_PORTS, NULL);
-	ARR_INIT(input->dadaReader, MAX_NUM_PORTS, NULL);
-	ARR_INIT(input->multilog, MAX_NUM_PORTS, NULL);
-	ARR_INIT(input->zstdLastRead, MAX_NUM_PORTS, 0);
-	ARR_INIT(input->dadaPageSize, MAX_NUM_PORTS, -1);
-
-	for (int8_t port = 0; port < MAX_NUM_PORTS; port++) {
-		input->readingTracker[port].src = NULL;
-		input->readingTracker[port].size = 0;
-		input->readingTracker[port].pos = 0;
-		input->decompressionTracker[port].dst = NULL;
-		input->decompressionTracker[port].size = 0;
-		input->decompressionTracker[port].pos = 0;
+	if (lofar_udp_io_read_alloc_ports(input, DEFAULT_NUM_PORTS) < 0) {
+		_lofar_udp_io_read_free_ports(input);
+		free(input);
+		return NULL;
 	}
 
 	return input;
 }
 
+/**
+ * @brief Grow the per-port arrays of a reader config to hold (at least) numPorts entries
+ *
+ * @param input		The reader config
+ * @param numPorts	The number of ports
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t lofar_udp_io_read_alloc_ports(lofar_udp_io_read_config *input, int8_t numPorts) {
+	CHECK_ALLOC_NOCLEAN(input, -1);
+	const int8_t oldPorts = input->allocatedPorts;
+	if (numPorts <= oldPorts) {
+		return 0;
+	}
+
+	// New entries are zeroed (NULL pointers, empty strings), only the -1 defaults need to be set afterwards
+	ARR_GROW(input->readBufSize, oldPorts, numPorts);
+	ARR_GROW(input->portPacketLength, oldPorts, numPorts);
+	ARR_GROW(input->preBufferSpace, oldPorts, numPorts);
+	ARR_GROW(input->inputRing, oldPorts, numPorts);
+	ARR_GROW(input->inputRingSize, oldPorts, numPorts);
+	ARR_GROW(input->inputWindow, oldPorts, numPorts);
+	ARR_GROW(input->inputWindowSize, oldPorts, numPorts);
+	ARR_GROW(input->inputWindowPrefix, oldPorts, numPorts);
+	ARR_GROW(input->inputWindowMapStart, oldPorts, numPorts);
+	ARR_GROW(input->inputWindowMapLength, oldPorts, numPorts);
+	ARR_GROW(input->inputMap, oldPorts, numPorts);
+	ARR_GROW(input->inputMapSize, oldPorts, numPorts);
+	ARR_GROW(input->inputMapReleased, oldPorts, numPorts);
+	ARR_GROW(input->inputAdvised, oldPorts, numPorts);
+	ARR_GROW(input->inputEvicted, oldPorts, numPorts);
+	ARR_GROW(input->followNotify, oldPorts, numPorts);
+	ARR_GROW(input->inputLocations, oldPorts, numPorts);
+	ARR_GROW(input->inputDadaKeys, oldPorts, numPorts);
+	ARR_GROW(input->fileRef, oldPorts, numPorts);
+	ARR_GROW(input->fileList, oldPorts, numPorts);
+	ARR_GROW(input->dstream, oldPorts, numPorts);
+	ARR_GROW(input->dadaReader, oldPorts, numPorts);
+	ARR_GROW(input->uringReader, oldPorts, numPorts);
+	ARR_GROW(input->udpReader, oldPorts, numPorts);
+	ARR_GROW(input->pcapReader, oldPorts, numPorts);
+	ARR_GROW(input->hdf5Reader, oldPorts, numPorts);
+	ARR_GROW(input->shmReader, oldPorts, numPorts);
+	ARR_GROW(input->streamOffset, oldPorts, numPorts);
+	ARR_GROW(input->lastReadOffset, oldPorts, numPorts);
+	ARR_GROW(input->readingTracker, oldPorts, numPorts);
+	ARR_GROW(input->decompressionTracker, oldPorts, numPorts);
+	ARR_GROW(input->zstdLastRead, oldPorts, numPorts);
+	ARR_GROW(input->zstdFrameBoundary, oldPorts, numPorts);
+	ARR_GROW(input->frameDCtx, oldPorts, numPorts);
+	ARR_GROW(input->zstdAnchors, oldPorts, numPorts);
+	ARR_GROW(input->zstdAnchorCount, oldPorts, numPorts);
+	ARR_GROW(input->zstdFilter, oldPorts, numPorts);
+	ARR_GROW(input->multilog, oldPorts, numPorts);
+	ARR_GROW(input->dadaPageSize, oldPorts, numPorts);
+	ARR_GROW(input->dadaBlock, oldPorts, numPorts);
+	ARR_GROW(input->dadaBlockSize, oldPorts, numPorts);
+	ARR_GROW(input->dadaBlockOffset, oldPorts, numPorts);
+	ARR_GROW(input->dadaCarry, oldPorts, numPorts);
+	ARR_GROW(input->dadaCarrySize, oldPorts, numPorts);
+	ARR_GROW(input->dadaCarryOffset, oldPorts, numPorts);
+	ARR_GROW(input->dadaCarryLength, oldPorts, numPorts);
+	ARR_GROW(input->packetIndex, oldPorts, numPorts);
+	input->allocatedPorts = numPorts;
+
+	const int8_t newPorts = (int8_t) (numPorts - oldPorts);
+	ARR_INIT(&(input->readBufSize[oldPorts]), newPorts, -1);
+	ARR_INIT(&(input->portPacketLength[oldPorts]), newPorts, -1);
+	ARR_INIT(&(input->inputAdvised[oldPorts]), newPorts, -1);
+	ARR_INIT(&(input->followNotify[oldPorts]), newPorts, -1);
+	ARR_INIT(&(input->inputDadaKeys[oldPorts]), newPorts, -1);
+	ARR_INIT(&(input->dadaPageSize[oldPorts]), newPorts, -1);
+	for (int8_t port = oldPorts; port < numPorts; port++) {
+		input->zstdFilter[port].filter = ZSTD_FILTER_NONE;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Free the per-port arrays of a reader config (the ports must already have been cleaned up)
+ *
+ * @param input	The reader config
+ */
+void _lofar_udp_io_read_free_ports(lofar_udp_io_read_config *input) {
+	if (input == NULL) {
+		return;
+	}
+
+	FREE_NOT_NULL(input->readBufSize);
+	FREE_NOT_NULL(input->portPacketLength);
+	FREE_NOT_NULL(input->preBufferSpace);
+	FREE_NOT_NULL(input->inputRing);
+	FREE_NOT_NULL(input->inputRingSize);
+	FREE_NOT_NULL(input->inputWindow);
+	FREE_NOT_NULL(input->inputWindowSize);
+	FREE_NOT_NULL(input->inputWindowPrefix);
+	FREE_NOT_NULL(input->inputWindowMapStart);
+	FREE_NOT_NULL(input->inputWindowMapLength);
+	FREE_NOT_NULL(input->inputMap);
+	FREE_NOT_NULL(input->inputMapSize);
+	FREE_NOT_NULL(input->inputMapReleased);
+	FREE_NOT_NULL(input->inputAdvised);
+	FREE_NOT_NULL(input->inputEvicted);
+	FREE_NOT_NULL(input->followNotify);
+	FREE_NOT_NULL(input->inputLocations);
+	FREE_NOT_NULL(input->inputDadaKeys);
+	FREE_NOT_NULL(input->fileRef);
+	FREE_NOT_NULL(input->fileList);
+	FREE_NOT_NULL(input->dstream);
+	FREE_NOT_NULL(input->dadaReader);
+	FREE_NOT_NULL(input->uringReader);
+	FREE_NOT_NULL(input->udpReader);
+	FREE_NOT_NULL(input->pcapReader);
+	FREE_NOT_NULL(input->hdf5Reader);
+	FREE_NOT_NULL(input->shmReader);
+	FREE_NOT_NULL(input->streamOffset);
+	FREE_NOT_NULL(input->lastReadOffset);
+	FREE_NOT_NULL(input->readingTracker);
+	FREE_NOT_NULL(input->decompressionTracker);
+	FREE_NOT_NULL(input->zstdLastRead);
+	FREE_NOT_NULL(input->zstdFrameBoundary);
+	FREE_NOT_NULL(input->frameDCtx);
+	FREE_NOT_NULL(input->zstdAnchors);
+	FREE_NOT_NULL(input->zstdAnchorCount);
+	FREE_NOT_NULL(input->zstdFilter);
+	FREE_NOT_NULL(input->multilog);
+	FREE_NOT_NULL(input->dadaPageSize);
+	FREE_NOT_NULL(input->dadaBlock);
+	FREE_NOT_NULL(input->dadaBlockSize);
+	FREE_NOT_NULL(input->dadaBlockOffset);
+	FREE_NOT_NULL(input->dadaCarry);
+	FREE_NOT_NULL(input->dadaCarrySize);
+	FREE_NOT_NULL(input->dadaCarryOffset);
+	FREE_NOT_NULL(input->dadaCarryLength);
+	FREE_NOT_NULL(input->packetIndex);
+	input->allocatedPorts = 0;
+}
+
 lofar_udp_io_write_config* lofar_udp_io_write_alloc() {
 	DEFAULT_STRUCT_ALLOC(lofar_udp_io_write_config, output, lofar_udp_io_write_config_default, ;, NULL);
 
-	ARR_INIT(output->writeBufSize, MAX_OUTPUT_DIMS, -1);
-	STR_INIT(output->outputLocations, MAX_OUTPUT_DIMS);
-	ARR_INIT(output->outputDadaKeys, MAX_OUTPUT_DIMS, -1);
-	ARR_INIT(output->outputFiles, MAX_OUTPUT_DIMS, NULL);
+	if (lofar_udp_io_write_alloc_outputs(output, DEFAULT_NUM_OUTPUTS) < 0) {
+		_lofar_udp_io_write_free_outputs(output);
+		free(output);
+		return NULL;
+	}
+
+	return output;
+}
+
+/**
+ * @brief Allocate a writer config with the settings of another (not yet set up) writer config, but its own per-output arrays
+ *
+ * @param base	The writer config to copy
+ *
+ * @return ptr: success, NULL: failure
+ */
+lofar_udp_io_write_config* lofar_udp_io_write_alloc_copy(const lofar_udp_io_write_config *base) {
+	CHECK_ALLOC_NOCLEAN(base, NULL);
+	lofar_udp_io_write_config *output = lofar_udp_io_write_alloc();
+	CHECK_ALLOC_NOCLEAN(output, NULL);
+
+	if (lofar_udp_io_write_alloc_outputs(output, base->allocatedOutputs) < 0) {
+		_lofar_udp_io_write_free_outputs(output);
+		free(output);
+		return NULL;
+	}
+
+	const lofar_udp_io_write_config arrays = *output;
+	*output = *base;
+	output->allocatedOutputs = arrays.allocatedOutputs;
+	output->writeBufSize = arrays.writeBufSize;
+	output->outputLocations = arrays.outputLocations;
+	output->outputDadaKeys = arrays.outputDadaKeys;
+	output->outputFiles = arrays.outputFiles;
+	output->zstdWriter = arrays.zstdWriter;
+	output->dadaWriter = arrays.dadaWriter;
+	output->shmWriter = arrays.shmWriter;
+	output->hdf5Writer.hdf5DSetWriter = arrays.hdf5Writer.hdf5DSetWriter;
+
+	memcpy(output->writeBufSize, base->writeBufSize, base->allocatedOutputs * sizeof(*(base->writeBufSize)));
+	memcpy(output->outputLocations, base->outputLocations, base->allocatedOutputs * sizeof(*(base->outputLocations)));
+	memcpy(output->outputDadaKeys, base->outputDadaKeys, base->allocatedOutputs * sizeof(*(base->outputDadaKeys)));
 
-	for (int8_t outp = 0; outp < MAX_OUTPUT_DIMS; outp++) {
-		output->zstdWriter[outp].cstream = NULL;
-		output->zstdWriter[outp].compressionBuffer.dst = NULL;
-		output->zstdWriter[outp].compressionBuffer.size = 0;
-		output->zstdWriter[outp].compressionBuffer.pos = 0;
+	return output;
+}
 
-		output->dadaWriter[outp].hdu = NULL;
-		output->dadaWriter[outp].multilog = NULL;
+/**
+ * @brief Grow the per-output arrays of a writer config to hold (at least) numOutputs entries
+ *
+ * @param output		The writer config
+ * @param numOutputs	The number of outputs
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t lofar_udp_io_write_alloc_outputs(lofar_udp_io_write_config *output, int8_t numOutputs) {
+	CHECK_ALLOC_NOCLEAN(output, -1);
+	const int8_t oldOutputs = output->allocatedOutputs;
+	if (numOutputs <= oldOutputs) {
+		return 0;
+	}
 
-		output->hdf5Writer.hdf5DSetWriter[outp].dset = 0;
+	ARR_GROW(output->writeBufSize, oldOutputs, numOutputs);
+	ARR_GROW(output->outputLocations, oldOutputs, numOutputs);
+	ARR_GROW(output->outputDadaKeys, oldOutputs, numOutputs);
+	ARR_GROW(output->outputFiles, oldOutputs, numOutputs);
+	ARR_GROW(output->zstdWriter, oldOutputs, numOutputs);
+	ARR_GROW(output->dadaWriter, oldOutputs, numOutputs);
+	ARR_GROW(output->shmWriter, oldOutputs, numOutputs);
+	ARR_GROW(output->hdf5Writer.hdf5DSetWriter, oldOutputs, numOutputs);
+	output->allocatedOutputs = numOutputs;
+
+	ARR_INIT(&(output->writeBufSize[oldOutputs]), numOutputs - oldOutputs, -1);
+	ARR_INIT(&(output->outputDadaKeys[oldOutputs]), numOutputs - oldOutputs, -1);
+	for (int8_t outp = oldOutputs; outp < numOutputs; outp++) {
 		output->hdf5Writer.hdf5DSetWriter[outp].dims[0] = -1;
 		output->hdf5Writer.hdf5DSetWriter[outp].dims[1] = -1;
 	}
 
-	return output;
+	return 0;
+}
+
+/**
+ * @brief Free the per-output arrays of a writer config (the outputs must already have been cleaned up)
+ *
+ * @param output	The writer config
+ */
+void _lofar_udp_io_write_free_outputs(lofar_udp_io_write_config *output) {
+	if (output == NULL) {
+		return;
+	}
+
+	FREE_NOT_NULL(output->writeBufSize);
+	FREE_NOT_NULL(output->outputLocations);
+	FREE_NOT_NULL(output->outputDadaKeys);
+	FREE_NOT_NULL(output->outputFiles);
+	FREE_NOT_NULL(output->zstdWriter);
+	FREE_NOT_NULL(output->dadaWriter);
+	FREE_NOT_NULL(output->shmWriter);
+	FREE_NOT_NULL(output->hdf5Writer.hdf5DSetWriter);
+	output->allocatedOutputs = 0;
+}
+
+lofar_udp_index* lofar_udp_index_alloc() {
+	DEFAULT_STRUCT_ALLOC(lofar_udp_index, packetIndex, lofar_udp_index_default, ;, NULL);
+
+	return packetIndex;
+}
+
+/**
+ * @brief Grow the per-port array of a checkpoint to hold (at least) numPorts entries
+ *
+ * @param checkpoint	The checkpoint, initialised from lofar_udp_checkpoint_default
+ * @param numPorts		The number of ports
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t lofar_udp_checkpoint_alloc_ports(lofar_udp_checkpoint *checkpoint, int8_t numPorts) {
+	CHECK_ALLOC_NOCLEAN(checkpoint, -1);
+	const int8_t oldPorts = checkpoint->allocatedPorts;
+	if (numPorts <= oldPorts) {
+		return 0;
+	}
+
+	ARR_GROW(checkpoint->ports, oldPorts, numPorts);
+	checkpoint->allocatedPorts = numPorts;
+
+	for (int8_t port = oldPorts; port < numPorts; port++) {
+		checkpoint->ports[port].byteOffset = -1;
+		checkpoint->ports[port].frameOffset = -1;
+		checkpoint->ports[port].frameDataOffset = -1;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Grow the per-output array of a checkpoint to hold (at least) numOutputs entries
+ *
+ * @param checkpoint	The checkpoint, initialised from lofar_udp_checkpoint_default
+ * @param numOutputs	The number of outputs
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t lofar_udp_checkpoint_alloc_outputs(lofar_udp_checkpoint *checkpoint, int8_t numOutputs) {
+	CHECK_ALLOC_NOCLEAN(checkpoint, -1);
+	const int8_t oldOutputs = checkpoint->allocatedOutputs;
+	if (numOutputs <= oldOutputs) {
+		return 0;
+	}
+
+	ARR_GROW(checkpoint->outputOffset, oldOutputs, numOutputs);
+	checkpoint->allocatedOutputs = numOutputs;
+
+	ARR_INIT(&(checkpoint->outputOffset[oldOutputs]), numOutputs - oldOutputs, -1);
+
+	return 0;
+}
+
+/**
+ * @brief Free the per-port and per-output arrays of a checkpoint (the struct itself is not freed)
+ *
+ * @param checkpoint	The checkpoint
+ */
+void lofar_udp_checkpoint_free_arrays(lofar_udp_checkpoint *checkpoint) {
+	if (checkpoint == NULL) {
+		return;
+	}
+
+	FREE_NOT_NULL(checkpoint->ports);
+	FREE_NOT_NULL(checkpoint->outputOffset);
+	checkpoint->allocatedPorts = 0;
+	checkpoint->allocatedOutputs = 0;
+}
+
+/**
+ * @brief Grow the per-output arrays of a shard description to hold (at least) numOutputs entries
+ *
+ * @param shard			The shard description, initialised from lofar_udp_shard_default
+ * @param numOutputs	The number of outputs
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t lofar_udp_shard_alloc_outputs(lofar_udp_shard *shard, int8_t numOutputs) {
+	CHECK_ALLOC_NOCLEAN(shard, -1);
+	const int8_t oldOutputs = shard->allocatedOutputs;
+	if (numOutputs <= oldOutputs) {
+		return 0;
+	}
+
+	ARR_GROW(shard->outputBytes, oldOutputs, numOutputs);
+	ARR_GROW(shard->packetOutputLength, oldOutputs, numOutputs);
+	ARR_GROW(shard->outputLocations, oldOutputs, numOutputs);
+	shard->allocatedOutputs = numOutputs;
+
+	return 0;
+}
+
+/**
+ * @brief Free the per-output arrays of a shard description (the struct itself is not freed)
+ *
+ * @param shard	The shard description
+ */
+void lofar_udp_shard_free_outputs(lofar_udp_shard *shard) {
+	if (shard == NULL) {
+		return;
+	}
+
+	FREE_NOT_NULL(shard->outputBytes);
+	FREE_NOT_NULL(shard->packetOutputLength);
+	FREE_NOT_NULL(shard->outputLocations);
+	shard->allocatedOutputs = 0;
 }
 
 void lofar_udp_config_cleanup(lofar_udp_config *config) {
+	if (config != NULL) {
+		FREE_NOT_NULL(config->inputLocations);
+		FREE_NOT_NULL(config->inputDadaKeys);
+	}
 	FREE_NOT_NULL(config);
 }
 
@@ -8,6 +8,7 @@
 #define ZSTD_STATIC_LINKING_ONLY 1
 
 #include <stdio.h>
+#include <time.h>
 #include <zstd.h>
 #include <hdf5.h>
 
@@ -41,46 +42,194 @@ typedef struct lofar_udp_calibration {
 } lofar_udp_calibration;
 extern const lofar_udp_calibration lofar_udp_calibration_default;
 
+// Packet index sidecar structs
+typedef struct lofar_udp_index_entry {
+	// Packet number of the indexed packet
+	int64_t packetNumber;
+	// Byte offset of the packet in the (decompressed) data stream
+	int64_t byteOffset;
+	// Compressed offset of the ZSTD frame holding the packet, and the decompressed offset of the start of that frame
+	int64_t frameOffset;
+	int64_t frameDataOffset;
+	// Packet loss/disorder counts since the previous entry
+	int64_t droppedSinceLast;
+	int64_t outOfOrderSinceLast;
+} lofar_udp_index_entry;
+
+typedef struct lofar_udp_index {
+	// Sidecar parameters
+	int32_t version;
+	reader_t readerType;
+	int32_t packetLength;
+	int32_t stride;
+
+	// Input description, used to validate the sidecar against the input
+	int64_t inputSize;
+	int64_t firstPacket;
+	int64_t lastPacket;
+	int64_t totalPackets;
+	int64_t totalDropped;
+
+	// Index entries, one every stride packets
+	int64_t numEntries;
+	lofar_udp_index_entry *entries;
+} lofar_udp_index;
+extern const lofar_udp_index lofar_udp_index_default;
+
+// io_uring reader state (defined by the io_uring backend)
+typedef struct lofar_udp_io_uring_reader lofar_udp_io_uring_reader;
+// UDP socket reader state (defined by the UDP backend)
+typedef struct lofar_udp_io_udp_reader lofar_udp_io_udp_reader;
+// pcap/pcapng reader state (defined by the PCAP backend)
+typedef struct lofar_udp_io_pcap_reader lofar_udp_io_pcap_reader;
+// HDF5 dataset reader state (defined by the HDF5 backend)
+typedef struct lofar_udp_io_hdf5_reader lofar_udp_io_hdf5_reader;
+// List of files read back to back as a single input (defined by the FILE backend)
+typedef struct lofar_udp_io_file_list lofar_udp_io_file_list;
+// Process-local view of a shared memory ring (defined by the SHM backend)
+typedef struct lofar_udp_io_shm_ring lofar_udp_io_shm_ring;
+// Background writer thread and its buffer pool (defined by the async writer)
+typedef struct lofar_udp_io_async_writer lofar_udp_io_async_writer;
+
+// Compressed offset of a zstandard frame, and the offset of its first byte in the decompressed stream
+typedef struct lofar_udp_io_zstd_anchor {
+	int64_t frameOffset;
+	int64_t frameDataOffset;
+} lofar_udp_io_zstd_anchor;
+
+// Description of a filtered zstandard frame (see lofar_udp_io_write_config.zstdConfig.filter), and the reader's progress through it
+typedef struct lofar_udp_io_zstd_filter {
+	zstd_filter_t filter;
+	int32_t elementSize;
+	int64_t blockSize;
+	int64_t headerOffset; // Compressed offset of the description, seeks must restart from here to keep the filter
+	int64_t remaining; // Decompressed bytes of the frame that have not been restored yet
+	int64_t pending; // Decompressed bytes at the end of the buffer waiting for the rest of their block
+	int8_t *scratch;
+} lofar_udp_io_zstd_filter;
+
 typedef struct lofar_udp_io_read_config {
 	// Reader configuration, these must be set prior to calling read_setup
 	reader_t readerType;
-	int64_t readBufSize[MAX_NUM_PORTS];
-	int32_t portPacketLength[MAX_NUM_PORTS];
+	int64_t *readBufSize;
+	int32_t *portPacketLength;
 	int8_t numInputs;
+	// Entries allocated for each per-port array, see lofar_udp_io_read_alloc_ports
+	int8_t allocatedPorts;
 
 	// Reader requires space before the buffer, note for any reallocs
-	int32_t preBufferSpace[MAX_NUM_PORTS];
+	int32_t *preBufferSpace;
+
+	// Mirrored ring buffers backing the library input arrays (NULL/0 when a flat buffer is used)
+	int8_t **inputRing;
+	int64_t *inputRingSize;
+
+	// Page aligned input buffers (DADA_ACTIVE/SHM) that shared memory can be mapped over rather than copied into: the head of the
+	// buffer, its length, the pages reserved before it, and the range currently mapped from shared memory (0 length: none)
+	int8_t **inputWindow;
+	int64_t *inputWindowSize;
+	int64_t *inputWindowPrefix;
+	int8_t **inputWindowMapStart;
+	int64_t *inputWindowMapLength;
+
+	// Memory mapped inputs (NORMAL_MMAP), the mapping includes zeroed pages either side of the file
+	int8_t **inputMap;
+	int64_t *inputMapSize;
+	int64_t *inputMapReleased;
+
+	// Page cache management for NORMAL/ZSTD inputs: the end of the range requested ahead of the reader (-1 when disabled,
+	// e.g. for pipes), and the start of the range that has not yet been evicted behind it
+	int64_t *inputAdvised;
+	int64_t *inputEvicted;
+
+	// Follow mode for NORMAL/ZSTD inputs that are still being written: seconds without new data before the input is
+	// treated as finished (<= 0: disabled), and the inotify descriptors used to wait for data (-1 when not open)
+	float followTimeout;
+	int32_t *followNotify;
 
 	// Inputs post-formatting
-	char inputLocations[MAX_NUM_PORTS][DEF_STR_LEN + 1];
-	key_t inputDadaKeys[MAX_NUM_PORTS];
+	char (*inputLocations)[DEF_STR_LEN + 1];
+	key_t *inputDadaKeys;
 	int32_t basePort;
 	int16_t offsetPortCount;
 	int16_t stepSizePort;
 
 	// Main reading objects
-	FILE *fileRef[MAX_NUM_PORTS];
-	ZSTD_DStream *dstream[MAX_NUM_PORTS];
-	dada_hdu_t *dadaReader[MAX_NUM_PORTS];
+	FILE **fileRef;
+	lofar_udp_io_file_list **fileList;
+	ZSTD_DStream **dstream;
+	dada_hdu_t **dadaReader;
+	lofar_udp_io_uring_reader **uringReader;
+	lofar_udp_io_udp_reader **udpReader;
+	lofar_udp_io_pcap_reader **pcapReader;
+	lofar_udp_io_hdf5_reader **hdf5Reader;
+	lofar_udp_io_shm_ring **shmReader;
+
+	// Stream offset (decompressed, for compressed inputs) of the next byte returned, and of the start of the last read
+	int64_t *streamOffset;
+	int64_t *lastReadOffset;
 
 	// ZSTD requirements
-	ZSTD_inBuffer readingTracker[MAX_NUM_PORTS];
-	ZSTD_outBuffer decompressionTracker[MAX_NUM_PORTS];
-	int64_t zstdLastRead[MAX_NUM_PORTS];
+	ZSTD_inBuffer *readingTracker;
+	ZSTD_outBuffer *decompressionTracker;
+	int64_t *zstdLastRead;
+	// Multi-frame inputs: whether the stream is between frames, and the contexts used to decompress frames in parallel
+	int8_t *zstdFrameBoundary;
+	ZSTD_DCtx *(*frameDCtx)[ZSTD_PARALLEL_FRAMES];
+	// Ring of the most recent frame starts, so that a checkpoint can seek a compressed input back to a frame
+	lofar_udp_io_zstd_anchor (*zstdAnchors)[ZSTD_CHECKPOINT_ANCHORS];
+	int64_t *zstdAnchorCount;
+	// Filtered frame currently being decompressed
+	lofar_udp_io_zstd_filter *zstdFilter;
 
 	// PSRDADA requirements
-	multilog_t *multilog[MAX_NUM_PORTS];
-	int64_t dadaPageSize[MAX_NUM_PORTS];
+	multilog_t **multilog;
+	int64_t *dadaPageSize;
+	// Data block currently held open by the reader, its length and the bytes already consumed from it
+	int8_t **dadaBlock;
+	int64_t *dadaBlockSize;
+	int64_t *dadaBlockOffset;
+	// Carry-over buffer for in-place reads spanning the edge of a block, holding data already taken from the ringbuffer
+	int8_t **dadaCarry;
+	int64_t *dadaCarrySize;
+	int64_t *dadaCarryOffset;
+	int64_t *dadaCarryLength;
+
+	// Optional packet index sidecars (NORMAL/ZSTD inputs)
+	lofar_udp_index **packetIndex;
 
 } lofar_udp_io_read_config;
 extern const lofar_udp_io_read_config lofar_udp_io_read_config_default;
 
+// Header census of a single gulp on a port, generated before each gulp is processed
+typedef struct lofar_udp_gulp_summary {
+	int64_t packetsChecked;
+	// Headers that failed validation; these are treated as lost
+	int64_t malformedPackets;
+	// Packet numbers that jumped forward while the next packet followed on from the one before (reordered or corrupt, kept as-is)
+	int64_t suspectPackets;
+	// Headers with the RSP error bit set (kept, as the data may still be usable)
+	int64_t errorBitPackets;
+	// Gaps in the packet numbers, and packets at or before a packet already seen in the gulp
+	int64_t droppedPackets;
+	int64_t outOfOrderPackets;
+	int64_t firstPacket;
+	int64_t lastPacket;
+	// Every packet follows on from the previous gulp without loss or reordering
+	int8_t contiguous;
+} lofar_udp_gulp_summary;
+
 // Metadata struct
 typedef struct lofar_udp_obs_meta {
+	// Entries allocated for each per-port / per-output array, see _lofar_udp_obs_meta_alloc_ports / _lofar_udp_obs_meta_alloc_outputs
+	int8_t allocatedPorts;
+	int8_t allocatedOutputs;
+
 	// Input/Output data storage
-	int8_t *inputData[MAX_NUM_PORTS];
-	int8_t *outputData[MAX_OUTPUT_DIMS];
-	int64_t inputDataOffset[MAX_NUM_PORTS]; // Account for data shifts
+	int8_t **inputData;
+	int8_t **outputData;
+	int8_t **outputDataBuffers; // Library-owned output buffers, outputData may be redirected elsewhere
+	int64_t *inputDataOffset; // Account for data shifts
 
 	// Checks for data quality (reset on steps)
 	int8_t inputDataReady;
@@ -88,19 +237,19 @@ typedef struct lofar_udp_obs_meta {
 
 
 	// Track the packets, logging the beamlet counts and their metadata
-	int16_t portRawBeamlets[MAX_NUM_PORTS];
-	int16_t portRawCumulativeBeamlets[MAX_NUM_PORTS];
+	int16_t *portRawBeamlets;
+	int16_t *portRawCumulativeBeamlets;
 	int16_t totalRawBeamlets;
 
 	// Tracking beamlets with respect to the processing strategy
-	int16_t baseBeamlets[MAX_NUM_PORTS];
-	int16_t upperBeamlets[MAX_NUM_PORTS];
-	int16_t portCumulativeBeamlets[MAX_NUM_PORTS];
+	int16_t *baseBeamlets;
+	int16_t *upperBeamlets;
+	int16_t *portCumulativeBeamlets;
 	int16_t totalProcBeamlets;
 
 	// Input characteristics
 	int8_t inputBitMode;
-	int16_t portPacketLength[MAX_NUM_PORTS];
+	int16_t *portPacketLength;
 	int8_t clockBit;
 
 	// Calibration data
@@ -112,13 +261,14 @@ typedef struct lofar_udp_obs_meta {
 	// Track the output metadata
 	int8_t numOutputs;
 	int8_t outputBitMode;
-	int32_t packetOutputLength[MAX_OUTPUT_DIMS];
+	int32_t *packetOutputLength;
 
 
 	// Track the number of ports to process and the packet loss on each
 	int8_t numPorts;
-	int64_t portLastDroppedPackets[MAX_NUM_PORTS];
-	int64_t portTotalDroppedPackets[MAX_NUM_PORTS];
+	int64_t *portLastDroppedPackets;
+	int64_t *portTotalDroppedPackets;
+	lofar_udp_gulp_summary *gulpSummary;
 
 	// Configuration: replay last packet or copy a 0 packed file, set the processing mode, and it's related processing function
 	int8_t replayDroppedPackets;
@@ -166,6 +316,27 @@ typedef struct lofar_udp_reader {
 } lofar_udp_reader;
 extern const lofar_udp_reader lofar_udp_reader_default;
 
+// Batch event extraction: a requested window of packets
+typedef struct lofar_udp_event {
+	int64_t startingPacket;
+	int64_t packetsReadMax;
+} lofar_udp_event;
+
+// The part of an event held in the reader's output buffers after a step
+typedef struct lofar_udp_event_slice {
+	// Index of the event in the caller's list
+	int64_t eventIdx;
+	// Packet number of the first packet in the slice, and the packet offset of it in the output buffers
+	int64_t packetNumber;
+	int64_t outputPacketOffset;
+	int64_t numPackets;
+	// First/last slice for the event; a zero-length last slice is given if the input ends during an event
+	int8_t firstSlice;
+	int8_t lastSlice;
+} lofar_udp_event_slice;
+
+typedef int32_t (*lofar_udp_event_callback)(lofar_udp_reader *reader, const lofar_udp_event_slice *slice, void *userData);
+
 typedef struct metadata_config {
 	// Define the output metadata type (see metadata_t enums)
 	metadata_t metadataType;
@@ -179,6 +350,72 @@ typedef struct metadata_config {
 } metadata_config;
 extern const metadata_config metadata_config_default;
 
+// Checkpoint of a reader's progress (and optionally a writer's), used to resume a long job where it stopped
+typedef struct lofar_udp_checkpoint_port {
+	// Input offset (decompressed for zstandard inputs) at or before the next packet to process
+	int64_t byteOffset;
+	// zstandard inputs: compressed offset / input offset of a frame start at or before byteOffset, otherwise -1
+	int64_t frameOffset;
+	int64_t frameDataOffset;
+	int64_t totalDroppedPackets;
+} lofar_udp_checkpoint_port;
+
+typedef struct lofar_udp_checkpoint {
+	int32_t version;
+
+	// Reader configuration, must match on resume
+	reader_t readerType;
+	int32_t processingMode;
+	int8_t numPorts;
+	int8_t numOutputs;
+	int8_t replayDroppedPackets;
+
+	// Reader progress
+	int32_t calibrationStep;
+	int64_t packetsPerIteration;
+	int64_t lastPacket;
+	int64_t packetsRead;
+	int64_t packetsReadMax;
+
+	// Writer progress: the packet used for [[pack]]
+	int64_t outputFirstPacket;
+
+	// Progress of each port, and the length of each output (-1: not resumable), only the first numPorts / numOutputs
+	// entries are stored in a checkpoint file. Entries allocated for each array, see lofar_udp_checkpoint_alloc_ports /
+	// lofar_udp_checkpoint_alloc_outputs
+	lofar_udp_checkpoint_port *ports;
+	int64_t *outputOffset;
+	int8_t allocatedPorts;
+	int8_t allocatedOutputs;
+} lofar_udp_checkpoint;
+extern const lofar_udp_checkpoint lofar_udp_checkpoint_default;
+
+// Description of one time shard of an observation, written next to its part files for the stitch step
+typedef struct lofar_udp_shard {
+	int32_t version;
+	int32_t shard;
+	int32_t numShards;
+
+	// Processing configuration, must match between shards
+	int8_t numPorts;
+	int8_t numOutputs;
+	metadata_t metadataType;
+	int8_t replayDroppedPackets;
+
+	// First packet (per port) processed, packets written and packets lost by the shard
+	int64_t firstPacket;
+	int64_t packetsWritten;
+	int64_t droppedPackets;
+
+	// Part files, their data length (excluding headers) and the output length of a packet; as with checkpoints, only the
+	// first numOutputs entries are stored in a manifest. Entries allocated for each array, see lofar_udp_shard_alloc_outputs
+	int64_t *outputBytes;
+	int64_t *packetOutputLength;
+	char (*outputLocations)[DEF_STR_LEN + 1];
+	int8_t allocatedOutputs;
+} lofar_udp_shard;
+extern const lofar_udp_shard lofar_udp_shard_default;
+
 // Configuration struct
 typedef struct lofar_udp_config {
 
@@ -186,19 +423,23 @@ typedef struct lofar_udp_config {
 	reader_t readerType;
 
 	// Points to input files, compressed or uncompressed
-	char inputLocations[MAX_NUM_PORTS][DEF_STR_LEN + 1];
+	char (*inputLocations)[DEF_STR_LEN + 1];
 
 	// Input PSRDADA ringbuffer keys
-	key_t inputDadaKeys[MAX_NUM_PORTS];
+	key_t *inputDadaKeys;
+
+	// Entries allocated for inputLocations / inputDadaKeys, see lofar_udp_config_alloc_ports
+	int8_t allocatedPorts;
 
 	struct metadata_config metadata_config;
 
 	// Number of valid ports of raw data being provided in inputLocations / dadaKeys
 	//
 	// basePort - the base port number, i.e. 0 or 16130
-	// offsetPortCount - the number of ports away from the base number, [0-3]
+	// offsetPortCount - the number of ports away from the base number, [0, INT8_MAX - 1]
 	// stepSizePort - the number to add to basePort for each port (any non-zero number)
-	// numPorts - the number of ports to process, [1, 4 - offsetPortCount]
+	// numPorts - the number of ports to process, [1, INT8_MAX - offsetPortCount]
+	//  (set numPorts before parsing the input, more than DEFAULT_NUM_PORTS ports need lofar_udp_config_alloc_ports)
 	// basePort must ALWAYS be the absolute base value if you want to parse metadata, i.e.
 	//  if you want to parse just ports 2 and 3, set the baseVal to 0, offsetPortCount to 2
 	//  and numPorts to 2. Otherwise, we can't parse the beamctl command correctly.
@@ -221,6 +462,9 @@ typedef struct lofar_udp_config {
 	// Packet number / offset from base of the last packet to process
 	int64_t packetsReadMax;
 
+	// Packet number to stop before, regardless of where the first packet was found (<= 0: disabled, use packetsReadMax)
+	int64_t endPacket;
+
 	// Configure whether to path with 0's (0) or replay last packet (1) when we
 	// encounter a dropped/missed packet
 	int8_t replayDroppedPackets;
@@ -238,9 +482,16 @@ typedef struct lofar_udp_config {
 	// Minimum advised is 2 times the number of ports being processed, so typically 8.
 	int32_t ompThreads;
 
+	// Follow NORMAL / ZSTD inputs that are still being written, waiting up to this many seconds for new data before
+	// treating the input as finished (<= 0: disabled, the current end of the file ends the input)
+	float followTimeout;
+
 	// Enable verbose mode when the library is compiled with -DALLOW_VERBOSE
 	int32_t verbose;
 
+	// Resume from a checkpoint rather than startingPacket (NULL: disabled), see lofar_udp_reader_checkpoint
+	const lofar_udp_checkpoint *resumeCheckpoint;
+
 } lofar_udp_config;
 extern const lofar_udp_config lofar_udp_config_default;
 
@@ -248,38 +499,67 @@ extern const lofar_udp_config lofar_udp_config_default;
 typedef struct lofar_udp_io_write_config {
 	// Writer configuration, these must be set prior to calling write_setup
 	reader_t readerType;
-	int64_t writeBufSize[MAX_OUTPUT_DIMS];
+	int64_t *writeBufSize;
 	int8_t progressWithExisting;
 	int8_t numOutputs;
+	// Entries allocated for each per-output array, see lofar_udp_io_write_alloc_outputs
+	int8_t allocatedOutputs;
 
 	// Outputs pre- and post-formatting
 	char outputFormat[DEF_STR_LEN + 1];
-	char outputLocations[MAX_OUTPUT_DIMS][DEF_STR_LEN + 1];
-	key_t outputDadaKeys[MAX_OUTPUT_DIMS];
+	char (*outputLocations)[DEF_STR_LEN + 1];
+	key_t *outputDadaKeys;
 	int32_t baseVal;
 	int16_t stepSize;
 	int64_t firstPacket;
 
+	// Continue the outputs described by a checkpoint rather than replacing them (NULL: disabled, NORMAL writers only)
+	const lofar_udp_checkpoint *resumeCheckpoint;
+
 	// Main writer objects
-	FILE *outputFiles[MAX_OUTPUT_DIMS];
+	FILE **outputFiles;
 	struct {
 		ZSTD_CStream *cstream;
 		ZSTD_outBuffer compressionBuffer;
-	} zstdWriter[MAX_OUTPUT_DIMS];
+		// Adaptive compression state, see zstdConfig.adaptive
+		int32_t level; // Level used for the current frame
+		int64_t frameBytes; // Input bytes in the current frame
+		double frameBusy; // Time spent compressing the current frame (seconds)
+		struct timespec frameStart; // End of the previous frame
+		// Statistics: frames ended and input bytes compressed at each level (adaptive writes only)
+		int64_t frames;
+		int64_t levelBytes[ZSTD_ADAPT_MAX_LEVEL + 1];
+		int8_t *filterBuffer; // Filtered copy of the data being written, see zstdConfig.filter
+	} *zstdWriter;
 	struct {
 		dada_hdu_t *hdu;
 		multilog_t *multilog;
-	} dadaWriter[MAX_OUTPUT_DIMS];
+		int8_t *block; // Data block currently held open by lofar_udp_io_write_acquire()
+		int64_t blockSize;
+	} *dadaWriter;
+	lofar_udp_io_shm_ring **shmWriter;
+	// Background writer, see lofar_udp_io_write_async_setup (NULL: writes are synchronous)
+	lofar_udp_io_async_writer *asyncWriter;
 	struct {
 		int8_t initialised;
 		int8_t metadataInitialised;
 		hid_t file;
 		hid_t dtype;
 		size_t elementSize;
+		// Compress whole chunks in parallel and commit them with H5Dwrite_chunk, rather than through the filter pipeline
+		// (enabled when the bitshuffle filter is applied)
+		int8_t directChunks;
 		struct {
 			hid_t dset;
 			hsize_t dims[2];
-		} hdf5DSetWriter[MAX_OUTPUT_DIMS];
+			// Direct chunk writer: rows held until they fill a chunk row, rows committed as chunks, and per-batch buffers
+			int8_t *staging;
+			hsize_t stagedRows;
+			hsize_t writtenRows;
+			int8_t *chunkBuffer;
+			int8_t *compressedBuffer;
+			int64_t *compressedSizes;
+		} *hdf5DSetWriter;
 	} hdf5Writer;
 
 
@@ -287,6 +567,14 @@ typedef struct lofar_udp_io_write_config {
 		int32_t compressionLevel;
 		int32_t numThreads;
 		int8_t enableSeek; // Not implemented
+		// Adapt the level between frames to keep up with the incoming data (0: fixed level, every write is flushed)
+		int8_t adaptive;
+		int32_t minLevel;
+		int32_t maxLevel;
+		int64_t frameSize; // Input bytes per frame for adaptive writes, the level is only changed once a frame is ended
+		// Filter each write before it is compressed, each write then becomes its own frame
+		zstd_filter_t filter;
+		int32_t filterElementSize; // Bytes per element (sample) of the data
 	} zstdConfig;
 	struct {
 		uint64_t nbufs;
@@ -296,6 +584,11 @@ typedef struct lofar_udp_io_write_config {
 		char programName[64];
 		float cleanup_timeout;
 	} dadaConfig;
+	struct {
+		int64_t ringSize; // <1: larger of SHM_RING_DEFAULT_SIZE or two writes
+		int32_t packetLength; // Recorded in the ring header for consumers, 0: unknown
+		float cleanupTimeout;
+	} shmConfig;
 
 
 	// ZSTD requirements
@@ -308,6 +601,9 @@ typedef struct lofar_udp_io_write_config {
 } lofar_udp_io_write_config;
 extern const lofar_udp_io_write_config lofar_udp_io_write_config_default;
 
+// Called by the background writer once a submitted buffer has been written (written < 0 on failure)
+typedef void (*lofar_udp_io_write_callback)(lofar_udp_io_write_config *config, int8_t outp, int8_t *buffer, int64_t written, void *userData);
+
 
 
 #ifdef __cplusplus
@@ -317,13 +613,28 @@ extern "C" {
 // Helper functions to allocate and initialised structs
 // External
 lofar_udp_config *lofar_udp_config_alloc(void);
+int32_t lofar_udp_config_alloc_ports(lofar_udp_config *config, int8_t numPorts);
 void lofar_udp_config_cleanup(lofar_udp_config *config);
 lofar_udp_io_read_config *lofar_udp_io_read_alloc(void);
+int32_t lofar_udp_io_read_alloc_ports(lofar_udp_io_read_config *input, int8_t numPorts);
 lofar_udp_io_write_config *lofar_udp_io_write_alloc(void);
+lofar_udp_io_write_config *lofar_udp_io_write_alloc_copy(const lofar_udp_io_write_config *base);
+int32_t lofar_udp_io_write_alloc_outputs(lofar_udp_io_write_config *output, int8_t numOutputs);
+lofar_udp_index *lofar_udp_index_alloc(void);
+int32_t lofar_udp_checkpoint_alloc_ports(lofar_udp_checkpoint *checkpoint, int8_t numPorts);
+int32_t lofar_udp_checkpoint_alloc_outputs(lofar_udp_checkpoint *checkpoint, int8_t numOutputs);
+void lofar_udp_checkpoint_free_arrays(lofar_udp_checkpoint *checkpoint);
+int32_t lofar_udp_shard_alloc_outputs(lofar_udp_shard *shard, int8_t numOutputs);
+void lofar_udp_shard_free_outputs(lofar_udp_shard *shard);
 
 // Internal
 lofar_udp_calibration *_lofar_udp_calibration_alloc(void);
 lofar_udp_obs_meta *_lofar_udp_obs_meta_alloc(void);
+int32_t _lofar_udp_obs_meta_alloc_ports(lofar_udp_obs_meta *meta, int8_t numPorts);
+int32_t _lofar_udp_obs_meta_alloc_outputs(lofar_udp_obs_meta *meta, int8_t numOutputs);
+void _lofar_udp_obs_meta_cleanup(lofar_udp_obs_meta *meta);
+void _lofar_udp_io_read_free_ports(lofar_udp_io_read_config *input);
+void _lofar_udp_io_write_free_outputs(lofar_udp_io_write_config *output);
 lofar_udp_reader *_lofar_udp_reader_alloc(lofar_udp_obs_meta *meta); // Reminder that reader is always built AFTER meta parsing
 
 
@@ -5,6 +5,8 @@ const lofar_udp_metadata lofar_udp_metadata_default = {
 
 	.type = NO_META,
 	.headerBuffer = NULL,
+	.allocatedPorts = 0,
+	.allocatedOutputs = 0,
 
 	.hdr_version = 1.0,
 
@@ -15,7 +17,7 @@ const lofar_udp_metadata lofar_udp_metadata_default = {
 	.observer = "",
 	.hostname = "",
 	.baseport = -1,
-	.rawfile = {""}, // NEEDS FULL RUNTIME INITIALISATION
+	.rawfile = NULL, // NEEDS FULL RUNTIME INITIALISATION
 	.output_file_number = -1,
 
 
@@ -48,7 +50,7 @@ const lofar_udp_metadata lofar_udp_metadata_default = {
 	.ftop_raw = -1.0,
 	.fbottom = -1.0,
 	.fbottom_raw = -1.0,
-	.subbands = { -1 }, // NEEDS FULL RUNTIME INITIALISATION
+	.subbands = NULL, // NEEDS FULL RUNTIME INITIALISATION
 	.lowerBeamlet = -1,
 	.upperBeamlet = -1,
 	.nsubband = -1,
@@ -67,7 +69,7 @@ const lofar_udp_metadata lofar_udp_metadata_default = {
 	.rec_version = "",
 	.upm_daq = "",
 	.upm_beamctl = "",
-	.upm_outputfmt = {""}, // NEEDS FULL RUNTIME INITIALISATION
+	.upm_outputfmt = NULL, // NEEDS FULL RUNTIME INITIALISATION
 	.upm_outputfmt_comment = "",
 	.upm_num_inputs = -1,
 	.upm_num_outputs = -1,
@@ -176,13 +178,45 @@ const sigproc_hdr sigproc_hdr_default = {
  */
 lofar_udp_metadata* lofar_udp_metadata_alloc() {
 	DEFAULT_STRUCT_ALLOC(lofar_udp_metadata, meta, lofar_udp_metadata_default, ;, NULL);
-	ARR_INIT(meta->subbands, MAX_NUM_PORTS * UDPMAXBEAM, -1);
-	STR_INIT(meta->rawfile, MAX_NUM_PORTS);
-	STR_INIT(meta->upm_outputfmt, MAX_NUM_PORTS);
+	if (_lofar_udp_metadata_alloc_arrays(meta, DEFAULT_NUM_PORTS, DEFAULT_NUM_OUTPUTS) < 0) {
+		lofar_udp_metadata_cleanup(meta);
+		return NULL;
+	}
 
 	return meta;
 }
 
+/**
+ * @brief Grow the per-port and per-output arrays of a metadata struct to hold (at least) the given number of entries
+ *
+ * @param meta			The struct to update
+ * @param numPorts		Number of ports, including any offset from the first port of the station
+ * @param numOutputs	Number of outputs
+ *
+ * @return 0: Success, <0: Failure
+ */
+int32_t _lofar_udp_metadata_alloc_arrays(lofar_udp_metadata *meta, int8_t numPorts, int8_t numOutputs) {
+	if (meta == NULL || numPorts < 0 || numOutputs < 0) {
+		fprintf(stderr, "ERROR %s: Invalid input (meta: %p, ports: %d, outputs: %d), exiting.\n", __func__, meta, numPorts, numOutputs);
+		return -1;
+	}
+
+	if (numPorts > meta->allocatedPorts) {
+		ARR_GROW(meta->rawfile, meta->allocatedPorts, numPorts);
+		ARR_GROW(meta->subbands, meta->allocatedPorts * UDPMAXBEAM, numPorts * UDPMAXBEAM);
+		ARR_INIT(&(meta->subbands[meta->allocatedPorts * UDPMAXBEAM]), (numPorts - meta->allocatedPorts) * UDPMAXBEAM, -1);
+		meta->allocatedPorts = numPorts;
+	}
+
+	if (numOutputs > meta->allocatedOutputs) {
+		ARR_GROW(meta->upm_outputfmt, meta->allocatedOutputs, numOutputs);
+		ARR_GROW(meta->upm_rel_outputs, meta->allocatedOutputs, numOutputs);
+		meta->allocatedOutputs = numOutputs;
+	}
+
+	return 0;
+}
+
 /**
  * @brief Cleanup a metadata struct
  *
@@ -194,6 +228,10 @@ void lofar_udp_metadata_cleanup(lofar_udp_metadata *meta) {
 			sigproc_hdr_cleanup(meta->output.sigproc);
 		}
 		FREE_NOT_NULL(meta->output.guppi);
+		FREE_NOT_NULL(meta->rawfile);
+		FREE_NOT_NULL(meta->subbands);
+		FREE_NOT_NULL(meta->upm_outputfmt);
+		FREE_NOT_NULL(meta->upm_rel_outputs);
 	}
 	FREE_NOT_NULL(meta);
 }
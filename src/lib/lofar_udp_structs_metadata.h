@@ -117,6 +117,10 @@ typedef struct lofar_udp_metadata {
 
 	metadata_t type;
 	int8_t *headerBuffer;
+	// Entries allocated for the per-port (rawfile, subbands) and per-output (upm_outputfmt, upm_rel_outputs) arrays,
+	// see _lofar_udp_metadata_alloc_arrays
+	int8_t allocatedPorts;
+	int8_t allocatedOutputs;
 
 	// DADA + DSPSR Defined header values
 	double hdr_version; // Lib
@@ -128,7 +132,7 @@ typedef struct lofar_udp_metadata {
 	char observer[META_STR_LEN + 1]; // External
 	char hostname[META_STR_LEN + 1]; // Lib
 	int32_t baseport; // Lib
-	char rawfile[MAX_NUM_PORTS][DEF_STR_LEN];
+	char (*rawfile)[DEF_STR_LEN];
 	int32_t output_file_number; // Lib
 
 
@@ -161,7 +165,7 @@ typedef struct lofar_udp_metadata {
 	double ftop; // beamctl
 	double fbottom_raw; // beamctl
 	double fbottom; // beamctl
-	int16_t subbands[MAX_NUM_PORTS * UDPMAXBEAM];
+	int16_t *subbands; // allocatedPorts * UDPMAXBEAM entries, indexed by beamlet
 	int16_t lowerBeamlet;
 	int16_t upperBeamlet;
 	int16_t nsubband; // beamctl
@@ -181,7 +185,7 @@ typedef struct lofar_udp_metadata {
 	char rec_version[META_STR_LEN + 1]; // Currently unused
 	char upm_daq[META_STR_LEN + 1];
 	char upm_beamctl[2 * DEF_STR_LEN + 1]; // beamctl command(s) can be long, DADA headers are capped at 4096 per entry including the key
-	char upm_outputfmt[MAX_OUTPUT_DIMS][META_STR_LEN + 1];
+	char (*upm_outputfmt)[META_STR_LEN + 1];
 	char upm_outputfmt_comment[DEF_STR_LEN + 1];
 
 	int8_t upm_num_inputs;
@@ -196,7 +200,7 @@ typedef struct lofar_udp_metadata {
 	int64_t upm_dropped_packets;
 	int64_t upm_last_dropped_packets;
 
-	char upm_rel_outputs[MAX_OUTPUT_DIMS];
+	char *upm_rel_outputs;
 	int8_t upm_bandflip;
 	int32_t upm_output_voltages;
 
@@ -224,6 +228,7 @@ extern "C" {
 #endif
 
 lofar_udp_metadata* lofar_udp_metadata_alloc(void);
+int32_t _lofar_udp_metadata_alloc_arrays(lofar_udp_metadata *meta, int8_t numPorts, int8_t numOutputs);
 sigproc_hdr* sigproc_hdr_alloc(int32_t fchannels);
 guppi_hdr* guppi_hdr_alloc(void);
 
@@ -45,8 +45,8 @@ int64_t _lofar_udp_metadata_write_DADA(const lofar_udp_metadata *hdr, int8_t *co
 	int32_t returnVal = 0;
 
 	// At time of initial implementation the approx. maximum input size here is
-	// (2 + MAX_NUM_PORTS) * DEF_STR_LEN -- beamctl, rawdatafiles
-	// (20 + MAX_OUTPUT_DIMS) * META_STR_LEN -- everything str-based
+	// (2 + ports) * DEF_STR_LEN -- beamctl, rawdatafiles
+	// (20 + outputs) * META_STR_LEN -- everything str-based
 	// 40 * (64/entry on the worst end) -- everything non-str
 	// Approximate our warning as 16,000 characters
 
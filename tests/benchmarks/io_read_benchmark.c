@@ -0,0 +1,104 @@
+#include "lofar_udp_io.h"
+
+#include <time.h>
+
+// Compare the read throughput of the file-backed input readers on a single input
+// Usage: io_read_benchmark <input file> [read size (MB), default 64] [repeats, default 3]
+
+static double benchmarkTime(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (double) now.tv_sec + (double) now.tv_nsec * 1e-9;
+}
+
+// Drop the input from the page cache so each run starts cold (best effort)
+static void benchmarkDropCache(const char inputLocation[]) {
+	int32_t fd = open(inputLocation, O_RDONLY);
+	if (fd > -1) {
+		posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+		close(fd);
+	}
+}
+
+static int32_t benchmarkReader(reader_t readerType, const char inputLocation[], int8_t *buffer, int64_t readSize, double *seconds, int64_t *bytesRead) {
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	if (input == NULL) {
+		return -1;
+	}
+
+	input->readerType = readerType;
+	strncpy(input->inputLocations[0], inputLocation, DEF_STR_LEN);
+
+	benchmarkDropCache(inputLocation);
+	const double start = benchmarkTime();
+	if (lofar_udp_io_read_setup_helper(input, &buffer, readSize, 0) < 0) {
+		lofar_udp_io_read_cleanup(input);
+		return -1;
+	}
+
+	int64_t lastRead;
+	*bytesRead = 0;
+	while ((lastRead = lofar_udp_io_read(input, 0, buffer, readSize)) > 0) {
+		*bytesRead += lastRead;
+	}
+	*seconds = benchmarkTime() - start;
+
+	lofar_udp_io_read_cleanup(input);
+	return lastRead < 0 ? -1 : 0;
+}
+
+int main(int argc, char *argv[]) {
+	if (argc < 2) {
+		fprintf(stderr, "Usage: %s <input file> [read size (MB), default 64] [repeats, default 3]\n", argv[0]);
+		return 1;
+	}
+
+	const int64_t readSize = (argc > 2 ? strtol(argv[2], NULL, 10) : 64) * 1024 * 1024;
+	const int32_t repeats = argc > 3 ? (int32_t) strtol(argv[3], NULL, 10) : 3;
+	if (readSize < 1 || repeats < 1) {
+		fprintf(stderr, "ERROR: Invalid read size or repeat count, exiting.\n");
+		return 1;
+	}
+
+	int8_t *buffer = calloc(readSize, sizeof(int8_t));
+	if (buffer == NULL) {
+		return 1;
+	}
+
+	const reader_t readers[] = { NORMAL, NORMAL_MMAP, URING };
+	const char *readerNames[] = { "FILE", "MMAP", "URING" };
+	printf("Reader\tRun\tBytes\t\tSeconds\tMB/s\n");
+	for (size_t reader = 0; reader < sizeof(readers) / sizeof(readers[0]); reader++) {
+		for (int32_t run = 0; run < repeats; run++) {
+			double seconds;
+			int64_t bytesRead;
+			if (benchmarkReader(readers[reader], argv[1], buffer, readSize, &seconds, &bytesRead) < 0) {
+				fprintf(stderr, "ERROR: %s reader failed, skipping.\n", readerNames[reader]);
+				break;
+			}
+			printf("%s\t%d\t%ld\t%.3f\t%.1f\n", readerNames[reader], run, bytesRead, seconds, (double) bytesRead / seconds / 1024. / 1024.);
+		}
+	}
+
+	free(buffer);
+	return 0;
+}
+
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
@@ -0,0 +1,199 @@
+#include "gtest/gtest.h"
+#include "lofar_udp_reader.h"
+#include "lofar_udp_index.h"
+#include "lib_reference_files.hpp"
+
+#include <cstdio>
+#include <regex>
+#include <string>
+#include <vector>
+
+static std::string index_test_input(int32_t testNumber, int32_t port) {
+	return std::regex_replace(inputLocations[testNumber], std::regex("portnum"), std::to_string(port));
+}
+
+static void index_test_remove_sidecars(int32_t testNumber) {
+	char indexLocation[DEF_STR_LEN];
+	for (int32_t port = 0; port < numPorts; port++) {
+		ASSERT_EQ(0, lofar_udp_index_get_location(indexLocation, index_test_input(testNumber, port).c_str()));
+		std::remove(indexLocation);
+	}
+}
+
+static lofar_udp_reader* index_test_reader(int32_t testNumber, int64_t startingPacket) {
+	lofar_udp_config *config = lofar_udp_config_alloc();
+	EXPECT_NE(nullptr, config);
+
+	for (int32_t port = 0; port < numPorts; port++) {
+		strncpy(config->inputLocations[port], index_test_input(testNumber, port).c_str(), DEF_STR_LEN);
+	}
+	config->readerType = strstr(config->inputLocations[0], ".zst") ? ZSTDCOMPRESSED : NORMAL;
+	config->numPorts = numPorts;
+	config->packetsPerIteration = 16;
+	config->packetsReadMax = 32;
+	config->processingMode = PACKET_FULL_COPY;
+	config->startingPacket = startingPacket;
+
+	lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+	FREE_NOT_NULL(config);
+	return reader;
+}
+
+TEST(LibIndexTests, GenerateWriteLoad) {
+	const int32_t stride = 16;
+	// NORMAL and ZSTD inputs must produce identical indexes of the same data
+	lofar_udp_index *normalIndex = lofar_udp_index_generate(index_test_input(1, 0).c_str(), NORMAL, stride);
+	lofar_udp_index *zstdIndex = lofar_udp_index_generate(index_test_input(2, 0).c_str(), ZSTDCOMPRESSED, stride);
+	ASSERT_NE(nullptr, normalIndex);
+	ASSERT_NE(nullptr, zstdIndex);
+
+	{
+		SCOPED_TRACE("lofar_udp_index_generate");
+		EXPECT_EQ(nullptr, lofar_udp_index_generate(index_test_input(1, 0).c_str(), DADA_ACTIVE, stride));
+		EXPECT_EQ(nullptr, lofar_udp_index_generate("./this_file_does_not_exist", NORMAL, stride));
+
+		EXPECT_EQ(NORMAL, normalIndex->readerType);
+		EXPECT_EQ(ZSTDCOMPRESSED, zstdIndex->readerType);
+		EXPECT_EQ(stride, normalIndex->stride);
+		EXPECT_EQ(7824, normalIndex->packetLength);
+		EXPECT_EQ(normalIndex->packetLength, zstdIndex->packetLength);
+		EXPECT_EQ(normalIndex->totalPackets, zstdIndex->totalPackets);
+		EXPECT_EQ(normalIndex->totalDropped, zstdIndex->totalDropped);
+		EXPECT_EQ(normalIndex->firstPacket, zstdIndex->firstPacket);
+		EXPECT_EQ(normalIndex->lastPacket, zstdIndex->lastPacket);
+		EXPECT_EQ((normalIndex->totalPackets + stride - 1) / stride, normalIndex->numEntries);
+		ASSERT_EQ(normalIndex->numEntries, zstdIndex->numEntries);
+
+		int64_t totalDropped = 0;
+		for (int64_t entry = 0; entry < normalIndex->numEntries; entry++) {
+			EXPECT_EQ(normalIndex->entries[entry].packetNumber, zstdIndex->entries[entry].packetNumber);
+			EXPECT_EQ(normalIndex->entries[entry].byteOffset, zstdIndex->entries[entry].byteOffset);
+			EXPECT_EQ(entry * stride * normalIndex->packetLength, normalIndex->entries[entry].byteOffset);
+			EXPECT_LE(zstdIndex->entries[entry].frameDataOffset, zstdIndex->entries[entry].byteOffset);
+			totalDropped += normalIndex->entries[entry].droppedSinceLast;
+		}
+		EXPECT_LE(totalDropped, normalIndex->totalDropped);
+	}
+
+	{
+		SCOPED_TRACE("lofar_udp_index_find_entry");
+		EXPECT_EQ(-1, lofar_udp_index_find_entry(nullptr, normalIndex->firstPacket));
+		EXPECT_EQ(-1, lofar_udp_index_find_entry(normalIndex, normalIndex->firstPacket - 1));
+		EXPECT_EQ(0, lofar_udp_index_find_entry(normalIndex, normalIndex->firstPacket));
+		EXPECT_EQ(normalIndex->numEntries - 1, lofar_udp_index_find_entry(normalIndex, LONG_MAX));
+		for (int64_t entry = 0; entry < normalIndex->numEntries; entry++) {
+			const int64_t found = lofar_udp_index_find_entry(normalIndex, normalIndex->entries[entry].packetNumber + 1);
+			EXPECT_LE(normalIndex->entries[found].packetNumber, normalIndex->entries[entry].packetNumber + 1);
+		}
+	}
+
+	{
+		SCOPED_TRACE("lofar_udp_index_write_load");
+		char indexLocation[DEF_STR_LEN];
+		EXPECT_EQ(-1, lofar_udp_index_get_location(nullptr, "test"));
+		ASSERT_EQ(0, lofar_udp_index_get_location(indexLocation, "./index_test_file"));
+		EXPECT_STREQ("./index_test_file" UPM_INDEX_SUFFIX, indexLocation);
+
+		EXPECT_EQ(-1, lofar_udp_index_write(nullptr, indexLocation));
+		ASSERT_EQ(0, lofar_udp_index_write(zstdIndex, indexLocation));
+		lofar_udp_index *loadedIndex = lofar_udp_index_load(indexLocation);
+		ASSERT_NE(nullptr, loadedIndex);
+
+		EXPECT_EQ(UPM_INDEX_VERSION, loadedIndex->version);
+		EXPECT_EQ(zstdIndex->readerType, loadedIndex->readerType);
+		EXPECT_EQ(zstdIndex->inputSize, loadedIndex->inputSize);
+		EXPECT_EQ(zstdIndex->totalPackets, loadedIndex->totalPackets);
+		ASSERT_EQ(zstdIndex->numEntries, loadedIndex->numEntries);
+		EXPECT_EQ(0, memcmp(zstdIndex->entries, loadedIndex->entries, zstdIndex->numEntries * sizeof(lofar_udp_index_entry)));
+
+		EXPECT_EQ(0, lofar_udp_index_check_input(loadedIndex, ZSTDCOMPRESSED_INDIRECT, zstdIndex->inputSize, zstdIndex->packetLength));
+		EXPECT_GT(0, lofar_udp_index_check_input(loadedIndex, NORMAL, zstdIndex->inputSize, zstdIndex->packetLength));
+		EXPECT_GT(0, lofar_udp_index_check_input(loadedIndex, ZSTDCOMPRESSED, zstdIndex->inputSize + 1, zstdIndex->packetLength));
+		EXPECT_GT(0, lofar_udp_index_check_input(loadedIndex, ZSTDCOMPRESSED, zstdIndex->inputSize, zstdIndex->packetLength + 1));
+		lofar_udp_index_cleanup(loadedIndex);
+
+		// Truncated index files must be rejected
+		FILE *indexFile = fopen(indexLocation, "r+b");
+		ASSERT_NE(nullptr, indexFile);
+		ASSERT_EQ(0, ftruncate(fileno(indexFile), 24));
+		fclose(indexFile);
+		EXPECT_EQ(nullptr, lofar_udp_index_load(indexLocation));
+		EXPECT_EQ(nullptr, lofar_udp_index_load("./this_file_does_not_exist"));
+		std::remove(indexLocation);
+	}
+
+	lofar_udp_index_cleanup(normalIndex);
+	lofar_udp_index_cleanup(zstdIndex);
+}
+
+TEST(LibIndexTests, ReaderSeek) {
+	for (int32_t testNumber : std::vector<int32_t>{ 1, 2 }) {
+		SCOPED_TRACE("Test case " + std::to_string(testNumber));
+		index_test_remove_sidecars(testNumber);
+
+		const reader_t readerType = testNumber == 2 ? ZSTDCOMPRESSED : NORMAL;
+		lofar_udp_index *packetIndex = lofar_udp_index_generate(index_test_input(testNumber, 0).c_str(), readerType, 8);
+		ASSERT_NE(nullptr, packetIndex);
+		const int64_t startingPacket = packetIndex->firstPacket + 150;
+		const int64_t reusePacket = packetIndex->firstPacket + 60;
+		lofar_udp_index_cleanup(packetIndex);
+
+		// Reference: scan to the starting packet without an index
+		lofar_udp_reader *reference = index_test_reader(testNumber, startingPacket);
+		ASSERT_NE(nullptr, reference);
+		for (int32_t port = 0; port < numPorts; port++) {
+			EXPECT_EQ(nullptr, reference->input->packetIndex[port]);
+		}
+
+		char indexLocation[DEF_STR_LEN];
+		for (int32_t port = 0; port < numPorts; port++) {
+			std::string inputLocation = index_test_input(testNumber, port);
+			packetIndex = lofar_udp_index_generate(inputLocation.c_str(), readerType, 8);
+			ASSERT_NE(nullptr, packetIndex);
+			ASSERT_EQ(0, lofar_udp_index_get_location(indexLocation, inputLocation.c_str()));
+			ASSERT_EQ(0, lofar_udp_index_write(packetIndex, indexLocation));
+			lofar_udp_index_cleanup(packetIndex);
+		}
+
+		lofar_udp_reader *indexed = index_test_reader(testNumber, startingPacket);
+		ASSERT_NE(nullptr, indexed);
+		EXPECT_EQ(reference->meta->lastPacket, indexed->meta->lastPacket);
+		for (int32_t port = 0; port < numPorts; port++) {
+			ASSERT_NE(nullptr, indexed->input->packetIndex[port]);
+			EXPECT_EQ(lofar_udp_time_get_packet_number(reference->meta->inputData[port]), lofar_udp_time_get_packet_number(indexed->meta->inputData[port]));
+			EXPECT_EQ(0, memcmp(reference->meta->inputData[port], indexed->meta->inputData[port], reference->packetsPerIteration * reference->meta->portPacketLength[port]));
+		}
+
+		// Indexed readers can also be re-used on earlier packets
+		lofar_udp_reader_cleanup(reference);
+		reference = index_test_reader(testNumber, reusePacket);
+		ASSERT_NE(nullptr, reference);
+		EXPECT_LE(0, lofar_udp_file_reader_reuse(indexed, reusePacket, 32));
+		EXPECT_EQ(reference->meta->lastPacket, indexed->meta->lastPacket);
+		for (int32_t port = 0; port < numPorts; port++) {
+			EXPECT_EQ(0, memcmp(reference->meta->inputData[port], indexed->meta->inputData[port], reference->packetsPerIteration * reference->meta->portPacketLength[port]));
+		}
+
+		lofar_udp_reader_cleanup(reference);
+		lofar_udp_reader_cleanup(indexed);
+		index_test_remove_sidecars(testNumber);
+	}
+}
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/
@@ -1,8 +1,14 @@
 #include "gtest/gtest.h"
 #include "gtest/gtest-spi.h"
 #include "lofar_udp_io.h"
+#include "lofar_udp_reader.h"
 #include <cstdio>
 #include <iostream>
+#include <thread>
+#include <atomic>
+#include <numeric>
+#include <algorithm>
+#include <arpa/inet.h>
 
 TEST(LibIoTests, SetupUseCleanup) {
 
@@ -258,6 +264,1348 @@ TEST(LibIoTests, ZSTDBufferExpansion) {
 };
 #undef ZSTDBUFLEN
 
+TEST(LibIoTests, InputRing) {
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	ASSERT_NE(nullptr, input);
+
+	{
+		SCOPED_TRACE("SanityChecks");
+		EXPECT_EQ(nullptr, _lofar_udp_io_read_ring_alloc(nullptr, 0, 4096));
+		EXPECT_EQ(nullptr, _lofar_udp_io_read_ring_alloc(input, -1, 4096));
+		EXPECT_EQ(nullptr, _lofar_udp_io_read_ring_alloc(input, input->allocatedPorts, 4096));
+		EXPECT_EQ(nullptr, _lofar_udp_io_read_ring_alloc(input, 0, 0));
+		_lofar_udp_io_read_ring_free(nullptr, 0);
+	}
+
+	{
+		SCOPED_TRACE("MirroredMapping");
+		const int64_t requestedSize = 3 * sysconf(_SC_PAGESIZE) + 1;
+		int8_t *ring = _lofar_udp_io_read_ring_alloc(input, 0, requestedSize);
+		ASSERT_NE(nullptr, ring);
+		EXPECT_EQ(ring, input->inputRing[0]);
+		EXPECT_EQ(4 * sysconf(_SC_PAGESIZE), input->inputRingSize[0]);
+		const int64_t ringSize = input->inputRingSize[0];
+
+		// Writes across the end of the first mapping must appear at the start of the ring
+		for (int32_t i = -16; i < 16; i++) {
+			ring[ringSize + i] = (int8_t) i;
+		}
+		for (int32_t i = 0; i < 16; i++) {
+			EXPECT_EQ((int8_t) i, ring[i]);
+			EXPECT_EQ((int8_t) (i - 16), ring[2 * ringSize - 16 + i]);
+		}
+
+		// Advancing wraps back into the first mapping, while leaving space for the pre-buffer
+		input->preBufferSpace[0] = 64;
+		EXPECT_EQ(&(ring[128]), _lofar_udp_io_read_ring_advance(input, 0, &(ring[64]), 64));
+		EXPECT_EQ(&(ring[ringSize]), _lofar_udp_io_read_ring_advance(input, 0, &(ring[64]), ringSize - 64));
+		EXPECT_EQ(&(ring[64]), _lofar_udp_io_read_ring_advance(input, 0, &(ring[64]), ringSize));
+		EXPECT_EQ(&(ring[128]), _lofar_udp_io_read_ring_advance(input, 0, &(ring[ringSize]), 128));
+
+		_lofar_udp_io_read_ring_free(input, 0);
+		EXPECT_EQ(nullptr, input->inputRing[0]);
+		EXPECT_EQ(0, input->inputRingSize[0]);
+	}
+
+	FREE_NOT_NULL(input);
+}
+
+TEST(LibIoTests, UringReader) {
+	const char inputLocation[] = "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000";
+	lofar_udp_config *config = lofar_udp_config_alloc();
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	ASSERT_NE(nullptr, config);
+	ASSERT_NE(nullptr, input);
+
+	ASSERT_EQ(0, lofar_udp_io_read_parse_optarg(config, (std::string("URING:") + inputLocation).c_str()));
+	EXPECT_EQ(URING, config->readerType);
+	EXPECT_STREQ(inputLocation, config->inputLocations[0]);
+
+	// Reads are sized to cross the io_uring block boundaries at different offsets, and re-use each block several times
+	const int64_t readSize = 100 * 1000 + 3;
+	// Large reads are submitted directly into the buffer
+	const int64_t directReadSize = 3 * URING_DIRECT_MIN_READ + 5;
+	input->readerType = URING;
+	strncpy(input->inputLocations[0], inputLocation, DEF_STR_LEN);
+	std::vector<int8_t> buffer(directReadSize + 1);
+	int8_t *bufferPtr = buffer.data();
+	const int32_t setupReturn = lofar_udp_io_read_setup_helper(input, &bufferPtr, directReadSize, 0);
+	if (setupReturn == -2) {
+		lofar_udp_io_read_cleanup(input);
+		free(config);
+		GTEST_SKIP() << "io_uring is not available on this system";
+	}
+	ASSERT_EQ(0, setupReturn);
+
+	FILE *reference = fopen(inputLocation, "rb");
+	ASSERT_NE(nullptr, reference);
+	std::vector<int8_t> referenceBuffer(readSize);
+
+	{
+		SCOPED_TRACE("SequentialReads");
+		int64_t referenceRead, totalRead = 0;
+		do {
+			referenceRead = (int64_t) fread(referenceBuffer.data(), sizeof(int8_t), readSize, reference);
+			ASSERT_EQ(referenceRead, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+			ASSERT_EQ(0, memcmp(referenceBuffer.data(), bufferPtr, referenceRead));
+			totalRead += referenceRead;
+		} while (referenceRead == readSize);
+		EXPECT_EQ(_FILE_file_size(reference), totalRead);
+		EXPECT_EQ(0, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+	}
+
+	{
+		SCOPED_TRACE("Seeks");
+		for (int64_t offset : std::vector<int64_t>{ 7824 * 101, 12 * 102400 - 3, 0 }) {
+			ASSERT_EQ(0, _lofar_udp_io_read_seek_URING(input, 0, offset));
+			ASSERT_EQ(0, fseeko(reference, offset, SEEK_SET));
+			const int64_t referenceRead = (int64_t) fread(referenceBuffer.data(), sizeof(int8_t), readSize, reference);
+			EXPECT_EQ(referenceRead, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+			EXPECT_EQ(0, memcmp(referenceBuffer.data(), bufferPtr, referenceRead));
+		}
+		EXPECT_GT(0, _lofar_udp_io_read_seek_URING(input, 0, -1));
+		EXPECT_GT(0, _lofar_udp_io_read_seek_URING(input, 0, _FILE_file_size(reference) + 1));
+	}
+
+	{
+		SCOPED_TRACE("DirectReads");
+		// Alternate between buffers that share the file offset's alignment (O_DIRECT), buffers that do not (page cache), and
+		// small reads through the read-ahead blocks
+		int8_t *alignedBuffer = nullptr;
+		ASSERT_EQ(0, posix_memalign((void **) &alignedBuffer, URING_ALIGNMENT, directReadSize + URING_ALIGNMENT));
+		std::vector<int8_t> directReference(directReadSize);
+		const int64_t startOffset = 7824 * 3;
+		ASSERT_EQ(0, _lofar_udp_io_read_seek_URING(input, 0, startOffset));
+		ASSERT_EQ(0, fseeko(reference, startOffset, SEEK_SET));
+		int64_t offset = startOffset, referenceRead;
+		int32_t iteration = 0;
+		do {
+			const int64_t size = (iteration % 3 == 2) ? readSize : directReadSize;
+			int8_t *target = (iteration % 3 == 0) ? &(alignedBuffer[offset % URING_ALIGNMENT]) : &(buffer[1]);
+			referenceRead = (int64_t) fread(directReference.data(), sizeof(int8_t), size, reference);
+			ASSERT_EQ(referenceRead, lofar_udp_io_read(input, 0, target, size));
+			ASSERT_EQ(0, memcmp(directReference.data(), target, referenceRead));
+			offset += referenceRead;
+			iteration++;
+		} while (referenceRead == ((iteration % 3 == 0) ? readSize : directReadSize));
+		EXPECT_EQ(_FILE_file_size(reference), offset);
+		free(alignedBuffer);
+	}
+
+	fclose(reference);
+	lofar_udp_io_read_cleanup(input);
+	free(config);
+}
+
+TEST(LibIoTests, UdpReader) {
+	const char inputLocation[] = "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000";
+	const int64_t packetLength = 7824, packetsPerRead = 16, numPackets = 128;
+	const int32_t udpPort = 46130;
+	lofar_udp_config *config = lofar_udp_config_alloc();
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	ASSERT_NE(nullptr, config);
+	ASSERT_NE(nullptr, input);
+
+	ASSERT_EQ(0, lofar_udp_io_read_parse_optarg(config, "UDP:127.0.0.1:[[port]],46130"));
+	EXPECT_EQ(UDP, config->readerType);
+	EXPECT_STREQ("127.0.0.1:46130", config->inputLocations[0]);
+
+	FILE *reference = fopen(inputLocation, "rb");
+	ASSERT_NE(nullptr, reference);
+	std::vector<int8_t> referenceData(numPackets * packetLength);
+	ASSERT_EQ(referenceData.size(), fread(referenceData.data(), sizeof(int8_t), referenceData.size(), reference));
+	fclose(reference);
+
+	// Replay the packets over loopback once the header scan has bound the socket, with a runt datagram the reader should drop
+	std::thread sender([&]() {
+		const int32_t fd = socket(AF_INET, SOCK_DGRAM, 0);
+		sockaddr_in destination {};
+		destination.sin_family = AF_INET;
+		destination.sin_port = htons(udpPort);
+		inet_pton(AF_INET, "127.0.0.1", &(destination.sin_addr));
+		usleep(100000);
+		for (int64_t packet = 0; packet < numPackets; packet++) {
+			sendto(fd, &(referenceData[packet * packetLength]), packetLength, 0, (sockaddr *) &destination, sizeof(destination));
+			if (packet == 20) {
+				sendto(fd, referenceData.data(), 100, 0, (sockaddr *) &destination, sizeof(destination));
+			}
+			if (packet % packetsPerRead == packetsPerRead - 1) {
+				usleep(1000);
+			}
+		}
+		close(fd);
+	});
+
+	// The header scan only peeks at the first datagram, the reader adopts the socket and receives it as its first packet
+	int8_t header[UDPHDRLEN];
+	EXPECT_EQ(UDPHDRLEN, lofar_udp_io_read_temp(config, 0, header, 1, UDPHDRLEN, 1));
+	EXPECT_EQ(0, memcmp(referenceData.data(), header, UDPHDRLEN));
+
+	input->readerType = UDP;
+	strncpy(input->inputLocations[0], config->inputLocations[0], DEF_STR_LEN);
+	std::vector<int8_t> buffer(packetsPerRead * packetLength);
+	int8_t *bufferPtr = buffer.data();
+	EXPECT_EQ(0, lofar_udp_io_read_setup_helper(input, &bufferPtr, (int64_t) buffer.size(), 0));
+
+	for (int64_t packet = 0; packet < numPackets; packet += packetsPerRead) {
+		const int64_t readReturn = lofar_udp_io_read(input, 0, bufferPtr, packetsPerRead * packetLength);
+		EXPECT_EQ(packetsPerRead * packetLength, readReturn);
+		if (readReturn != packetsPerRead * packetLength) {
+			break;
+		}
+		EXPECT_EQ(0, memcmp(&(referenceData[packet * packetLength]), bufferPtr, packetsPerRead * packetLength));
+	}
+
+	sender.join();
+	lofar_udp_io_read_cleanup(input);
+	free(config);
+}
+
+TEST(LibIoTests, PcapFifoReader) {
+	const char inputLocation[] = "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000";
+	const char fifoLocation[] = "./pcap_fifo_test.pcap";
+	const int64_t packetLength = 7824, packetsPerRead = 16, numPackets = 64;
+	lofar_udp_config *config = lofar_udp_config_alloc();
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	ASSERT_NE(nullptr, config);
+	ASSERT_NE(nullptr, input);
+
+	ASSERT_EQ(0, lofar_udp_io_read_parse_optarg(config, (std::string("PCAP:") + fifoLocation + "@[[port]],16130").c_str()));
+	EXPECT_EQ(PCAP, config->readerType);
+	EXPECT_STREQ((std::string(fifoLocation) + "@16130").c_str(), config->inputLocations[0]);
+
+	FILE *reference = fopen(inputLocation, "rb");
+	ASSERT_NE(nullptr, reference);
+	std::vector<int8_t> referenceData(numPackets * packetLength);
+	ASSERT_EQ(referenceData.size(), fread(referenceData.data(), sizeof(int8_t), referenceData.size(), reference));
+	fclose(reference);
+
+	// Stream a raw IP capture through a FIFO, with datagrams for another port between the packets
+	remove(fifoLocation);
+	ASSERT_EQ(0, mkfifo(fifoLocation, 0600));
+	std::thread writer([&]() {
+		FILE *fifo = fopen(fifoLocation, "wb");
+		if (fifo == nullptr) {
+			return;
+		}
+		const uint32_t globalHeader[6] = { 0xa1b2c3d4, 0x00040002, 0, 0, 65535, 101 };
+		fwrite(globalHeader, sizeof(globalHeader), 1, fifo);
+		for (int64_t packet = 0; packet < 2 * numPackets; packet++) {
+			const int64_t payloadLength = (packet % 2) ? packetLength : 100;
+			const uint16_t destPort = (packet % 2) ? 16130 : 16131;
+			const uint8_t headers[28] = {
+				0x45, 0x00, (uint8_t) ((payloadLength + 28) >> 8), (uint8_t) ((payloadLength + 28) & 0xff), 0, 0, 0x40, 0x00, 64, 17, 0, 0,
+				10, 0, 0, 1, 10, 0, 0, 2,
+				0x10, 0xfa, (uint8_t) (destPort >> 8), (uint8_t) (destPort & 0xff), (uint8_t) ((payloadLength + 8) >> 8), (uint8_t) ((payloadLength + 8) & 0xff), 0, 0
+			};
+			const uint32_t recordHeader[4] = { 0, 0, (uint32_t) (payloadLength + 28), (uint32_t) (payloadLength + 28) };
+			fwrite(recordHeader, sizeof(recordHeader), 1, fifo);
+			fwrite(headers, sizeof(headers), 1, fifo);
+			fwrite(&(referenceData[(packet / 2) * packetLength]), sizeof(int8_t), payloadLength, fifo);
+		}
+		fclose(fifo);
+	});
+
+	// The header scan leaves the stream open with the header unconsumed for the reader to adopt
+	int8_t header[UDPHDRLEN];
+	EXPECT_EQ(UDPHDRLEN, lofar_udp_io_read_temp(config, 0, header, 1, UDPHDRLEN, 1));
+	EXPECT_EQ(0, memcmp(referenceData.data(), header, UDPHDRLEN));
+
+	input->readerType = PCAP;
+	strncpy(input->inputLocations[0], config->inputLocations[0], DEF_STR_LEN);
+	std::vector<int8_t> buffer(packetsPerRead * packetLength);
+	int8_t *bufferPtr = buffer.data();
+	EXPECT_EQ(0, lofar_udp_io_read_setup_helper(input, &bufferPtr, (int64_t) buffer.size(), 0));
+
+	for (int64_t packet = 0; packet < numPackets; packet += packetsPerRead) {
+		const int64_t readReturn = lofar_udp_io_read(input, 0, bufferPtr, packetsPerRead * packetLength);
+		EXPECT_EQ(packetsPerRead * packetLength, readReturn);
+		if (readReturn != packetsPerRead * packetLength) {
+			break;
+		}
+		EXPECT_EQ(0, memcmp(&(referenceData[packet * packetLength]), bufferPtr, packetsPerRead * packetLength));
+	}
+	EXPECT_EQ(0, lofar_udp_io_read(input, 0, bufferPtr, packetsPerRead * packetLength));
+
+	writer.join();
+	lofar_udp_io_read_cleanup(input);
+	remove(fifoLocation);
+	free(config);
+}
+
+TEST(LibIoTests, ZSTDMultiFrameReader) {
+	const char inputLocation[] = "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000";
+	const char compressedLocation[] = "./zstd_multiframe_test.zst";
+
+	FILE *reference = fopen(inputLocation, "rb");
+	ASSERT_NE(nullptr, reference);
+	const int64_t inputSize = _FILE_file_size(reference);
+	std::vector<int8_t> rawData(inputSize);
+	ASSERT_EQ(inputSize, (int64_t) fread(rawData.data(), sizeof(int8_t), inputSize, reference));
+	fclose(reference);
+
+	// Build an input of independent frames of varying lengths, including a skippable frame and a frame without a recorded size
+	FILE *compressed = fopen(compressedLocation, "wb");
+	ASSERT_NE(nullptr, compressed);
+	ZSTD_CCtx *cctx = ZSTD_createCCtx();
+	ASSERT_NE(nullptr, cctx);
+	std::vector<int8_t> frameBuffer(ZSTD_compressBound(inputSize));
+	std::vector<std::pair<int64_t, int64_t>> frameOffsets;
+	int64_t rawOffset = 0, compressedOffset = 0;
+	for (int32_t frame = 0; rawOffset < inputSize; frame++) {
+		const int64_t frameLength = std::min(inputSize - rawOffset, (int64_t) 7824 * (5 + 3 * (frame % 4)));
+		if (frame == 3) {
+			const uint32_t skippableHeader[3] = { ZSTD_MAGIC_SKIPPABLE_START, 4, 0 };
+			ASSERT_EQ(3, fwrite(skippableHeader, sizeof(uint32_t), 3, compressed));
+			compressedOffset += 3 * sizeof(uint32_t);
+		}
+		ASSERT_EQ(0, ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_contentSizeFlag, frame != 10)));
+		const size_t frameSize = ZSTD_compress2(cctx, frameBuffer.data(), frameBuffer.size(), &(rawData[rawOffset]), frameLength);
+		ASSERT_EQ(0, ZSTD_isError(frameSize));
+		ASSERT_EQ(frameSize, fwrite(frameBuffer.data(), sizeof(int8_t), frameSize, compressed));
+		frameOffsets.emplace_back(compressedOffset, rawOffset);
+		compressedOffset += (int64_t) frameSize;
+		rawOffset += frameLength;
+	}
+	ZSTD_freeCCtx(cctx);
+	fclose(compressed);
+	ASSERT_GT(frameOffsets.size(), 8);
+
+	// Reads are sized to span several frames while ending part way through one
+	const int64_t readSize = 7824 * 30 + 5;
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	ASSERT_NE(nullptr, input);
+	input->readerType = ZSTDCOMPRESSED_INDIRECT;
+	strncpy(input->inputLocations[0], compressedLocation, DEF_STR_LEN);
+	std::vector<int8_t> buffer(readSize);
+	int8_t *bufferPtr = buffer.data();
+	ASSERT_EQ(0, lofar_udp_io_read_setup_helper(input, &bufferPtr, readSize, 0));
+
+	{
+		SCOPED_TRACE("SequentialReads");
+		int64_t totalRead = 0, lastRead;
+		while ((lastRead = lofar_udp_io_read(input, 0, bufferPtr, readSize)) > 0) {
+			ASSERT_EQ(std::min(readSize, inputSize - totalRead), lastRead);
+			ASSERT_EQ(0, memcmp(&(rawData[totalRead]), bufferPtr, lastRead));
+			totalRead += lastRead;
+		}
+		EXPECT_EQ(inputSize, totalRead);
+		// Frames were decompressed in parallel rather than only through the stream
+		EXPECT_NE(nullptr, input->frameDCtx[0][1]);
+	}
+
+	{
+		SCOPED_TRACE("Seeks");
+		for (size_t frame : std::vector<size_t>{ 7, 2, 11, 0 }) {
+			const int64_t discard = 7824 * 3 + 1;
+			ASSERT_EQ(0, _lofar_udp_io_read_seek_ZSTD(input, 0, frameOffsets[frame].first, discard));
+			const int64_t expectedRead = std::min(readSize, inputSize - frameOffsets[frame].second - discard);
+			EXPECT_EQ(expectedRead, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+			EXPECT_EQ(0, memcmp(&(rawData[frameOffsets[frame].second + discard]), bufferPtr, expectedRead));
+		}
+	}
+
+	lofar_udp_io_read_cleanup(input);
+	remove(compressedLocation);
+}
+
+TEST(LibIoTests, PageCacheAdvice) {
+	const char inputLocation[] = "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000";
+	const int64_t blockSize = FILE_EVICT_BLOCK_SIZE;
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	ASSERT_NE(nullptr, input);
+	EXPECT_EQ(-1, input->inputAdvised[0]);
+
+	{
+		SCOPED_TRACE("NormalFile");
+		input->readerType = NORMAL;
+		ASSERT_EQ(0, _lofar_udp_io_read_setup_FILE(input, inputLocation, 0));
+		EXPECT_EQ(0, input->inputAdvised[0]);
+		EXPECT_EQ(0, input->inputEvicted[0]);
+
+		// The first read requests the window ahead of the read head
+		std::vector<int8_t> buffer(7824 * 16);
+		ASSERT_EQ((int64_t) buffer.size(), _lofar_udp_io_read_FILE(input, 0, buffer.data(), (int64_t) buffer.size()));
+		EXPECT_EQ((int64_t) buffer.size() + FILE_READ_AHEAD_SIZE, input->inputAdvised[0]);
+		EXPECT_EQ(0, input->inputEvicted[0]);
+
+		// Advice is only updated once the read head has moved a full block, and a block is kept behind the read head
+		const int64_t advised = input->inputAdvised[0];
+		_lofar_udp_io_read_advise_FILE(input, 0, nullptr, blockSize);
+		EXPECT_EQ(advised, input->inputAdvised[0]);
+		EXPECT_EQ(0, input->inputEvicted[0]);
+
+		_lofar_udp_io_read_advise_FILE(input, 0, nullptr, 2 * blockSize + 1);
+		EXPECT_EQ(2 * blockSize + 1 + FILE_READ_AHEAD_SIZE, input->inputAdvised[0]);
+		EXPECT_EQ(blockSize, input->inputEvicted[0]);
+
+		_lofar_udp_io_read_advise_FILE(input, 0, nullptr, 3 * blockSize - 1);
+		EXPECT_EQ(2 * blockSize + 1 + FILE_READ_AHEAD_SIZE, input->inputAdvised[0]);
+		EXPECT_EQ(blockSize, input->inputEvicted[0]);
+
+		_lofar_udp_io_read_advise_FILE(input, 0, nullptr, 3 * blockSize);
+		EXPECT_EQ(2 * blockSize, input->inputEvicted[0]);
+
+		// Seeks restart the window from the new position
+		ASSERT_EQ(0, _lofar_udp_io_read_seek_FILE(input, 0, 7824));
+		EXPECT_EQ(7824, input->inputAdvised[0]);
+		EXPECT_EQ(0, input->inputEvicted[0]);
+		ASSERT_EQ((int64_t) buffer.size(), _lofar_udp_io_read_FILE(input, 0, buffer.data(), (int64_t) buffer.size()));
+		EXPECT_EQ(7824 + (int64_t) buffer.size() + FILE_READ_AHEAD_SIZE, input->inputAdvised[0]);
+		_lofar_udp_io_read_cleanup_FILE(input, 0);
+	}
+
+	{
+		SCOPED_TRACE("Fifo");
+		// Pipes are left to the kernel
+		input->readerType = FIFO;
+		ASSERT_EQ(0, _lofar_udp_io_read_setup_FILE(input, inputLocation, 0));
+		EXPECT_EQ(-1, input->inputAdvised[0]);
+		int8_t buffer[16];
+		ASSERT_EQ(16, _lofar_udp_io_read_FILE(input, 0, buffer, 16));
+		_lofar_udp_io_read_advise_FILE(input, 0, nullptr, 3 * blockSize);
+		EXPECT_EQ(-1, input->inputAdvised[0]);
+		EXPECT_EQ(0, input->inputEvicted[0]);
+		_lofar_udp_io_read_cleanup_FILE(input, 0);
+	}
+
+	FREE_NOT_NULL(input);
+}
+
+TEST(LibIoTests, MultiFileInput) {
+	const char inputLocation[] = "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000";
+	const char listPattern[] = "./multi_file_test.2022-06-29T01:3*";
+	const char joinedLocation[] = "./multi_file_test_joined";
+	const int64_t packetLength = 7824;
+
+	std::vector<int8_t> source(packetLength * 256);
+	{
+		FILE *sourceFile = fopen(inputLocation, "rb");
+		ASSERT_NE(nullptr, sourceFile);
+		ASSERT_EQ(source.size(), fread(source.data(), sizeof(int8_t), source.size(), sourceFile));
+		fclose(sourceFile);
+	}
+
+	// Rotated capture files: 5 packets are lost between the first two files, and the second file ends on a partial packet
+	struct { const char *location; int64_t startPacket; int64_t packets; int64_t extraBytes; } parts[3] = {
+		{ "./multi_file_test.2022-06-29T01:30:00.000", 0, 90, 0 },
+		{ "./multi_file_test.2022-06-29T01:31:00.000", 95, 60, 100 },
+		{ "./multi_file_test.2022-06-29T01:32:00.000", 155, 101, 0 },
+	};
+	std::vector<int8_t> expected;
+	for (const auto &part : parts) {
+		FILE *partFile = fopen(part.location, "wb");
+		ASSERT_NE(nullptr, partFile);
+		const int64_t partLength = part.packets * packetLength + part.extraBytes;
+		ASSERT_EQ(partLength, (int64_t) fwrite(&(source[part.startPacket * packetLength]), sizeof(int8_t), partLength, partFile));
+		fclose(partFile);
+		expected.insert(expected.end(), source.begin() + part.startPacket * packetLength, source.begin() + (part.startPacket + part.packets) * packetLength);
+	}
+	{
+		FILE *joinedFile = fopen(joinedLocation, "wb");
+		ASSERT_NE(nullptr, joinedFile);
+		ASSERT_EQ(expected.size(), fwrite(expected.data(), sizeof(int8_t), expected.size(), joinedFile));
+		fclose(joinedFile);
+	}
+
+	{
+		SCOPED_TRACE("FirstFile");
+		char firstFile[DEF_STR_LEN + 1];
+		EXPECT_EQ(0, _lofar_udp_io_read_FILE_list_first(firstFile, listPattern, NORMAL));
+		EXPECT_STREQ(parts[0].location, firstFile);
+		// Only NORMAL inputs are expanded
+		EXPECT_EQ(0, _lofar_udp_io_read_FILE_list_first(firstFile, listPattern, ZSTDCOMPRESSED));
+		EXPECT_STREQ(listPattern, firstFile);
+		EXPECT_EQ(-1, _lofar_udp_io_read_FILE_list_first(firstFile, "./multi_file_test_missing.*", NORMAL));
+	}
+
+	{
+		SCOPED_TRACE("ReadAndSeek");
+		lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+		ASSERT_NE(nullptr, input);
+		input->readerType = NORMAL;
+		input->portPacketLength[0] = packetLength;
+		ASSERT_EQ(0, _lofar_udp_io_read_setup_FILE(input, listPattern, 0));
+		ASSERT_NE(nullptr, input->fileList[0]);
+
+		// Reads continue across the file boundaries, the partial packet is skipped and only the final file ends the stream
+		const int64_t readLength = 32 * packetLength;
+		std::vector<int8_t> stream(expected.size() + readLength);
+		int64_t totalRead = 0, charsRead;
+		while ((charsRead = _lofar_udp_io_read_FILE(input, 0, &(stream[totalRead]), readLength)) == readLength) {
+			totalRead += charsRead;
+		}
+		ASSERT_GE(charsRead, 0);
+		totalRead += charsRead;
+		ASSERT_EQ((int64_t) expected.size(), totalRead);
+		EXPECT_EQ(0, memcmp(expected.data(), stream.data(), expected.size()));
+		EXPECT_EQ(0, _lofar_udp_io_read_FILE(input, 0, stream.data(), readLength));
+
+		// Seeks map the stream offset back onto the files
+		for (const int64_t packet : { 10l, 89l, 100l, 150l, 0l }) {
+			ASSERT_EQ(0, _lofar_udp_io_read_seek_FILE(input, 0, packet * packetLength));
+			ASSERT_EQ(readLength, _lofar_udp_io_read_FILE(input, 0, stream.data(), readLength));
+			EXPECT_EQ(0, memcmp(&(expected[packet * packetLength]), stream.data(), readLength));
+		}
+		EXPECT_EQ(-1, _lofar_udp_io_read_seek_FILE(input, 0, (int64_t) expected.size() + 1));
+
+		_lofar_udp_io_read_cleanup_FILE(input, 0);
+		EXPECT_EQ(nullptr, input->fileList[0]);
+		FREE_NOT_NULL(input);
+	}
+
+	{
+		SCOPED_TRACE("Reader");
+		// The reader sees the gap between files as packet loss, matching a single file holding the same packets
+		auto processInput = [&](const char location[], std::vector<int8_t> &output, int64_t &dropped) {
+			lofar_udp_config *config = lofar_udp_config_alloc();
+			ASSERT_NE(nullptr, config);
+			strncpy(config->inputLocations[0], location, DEF_STR_LEN);
+			config->readerType = NORMAL;
+			config->numPorts = 1;
+			config->packetsPerIteration = 32;
+			config->processingMode = PACKET_FULL_COPY;
+			lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+			FREE_NOT_NULL(config);
+			ASSERT_NE(nullptr, reader);
+
+			while (lofar_udp_reader_step(reader) < 1) {
+				const int64_t outputLength = reader->meta->packetsPerIteration * reader->meta->packetOutputLength[0];
+				output.insert(output.end(), reader->meta->outputData[0], reader->meta->outputData[0] + outputLength);
+			}
+			dropped = reader->meta->portTotalDroppedPackets[0];
+			lofar_udp_reader_cleanup(reader);
+		};
+
+		std::vector<int8_t> listOutput, joinedOutput;
+		int64_t listDropped = -1, joinedDropped = -2;
+		processInput(listPattern, listOutput, listDropped);
+		processInput(joinedLocation, joinedOutput, joinedDropped);
+		EXPECT_EQ(5, listDropped);
+		EXPECT_EQ(joinedDropped, listDropped);
+		ASSERT_EQ(joinedOutput.size(), listOutput.size());
+		EXPECT_EQ(0, memcmp(joinedOutput.data(), listOutput.data(), listOutput.size()));
+	}
+
+	for (const auto &part : parts) {
+		remove(part.location);
+	}
+	remove(joinedLocation);
+}
+
+TEST(LibIoTests, FollowMode) {
+	const char inputLocation[] = "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000";
+	const char followLocation[] = "./follow_test.raw";
+	const char compressedLocation[] = "./follow_test.zst";
+
+	FILE *reference = fopen(inputLocation, "rb");
+	ASSERT_NE(nullptr, reference);
+	const int64_t inputSize = _FILE_file_size(reference);
+	std::vector<int8_t> rawData(inputSize);
+	ASSERT_EQ(inputSize, (int64_t) fread(rawData.data(), sizeof(int8_t), inputSize, reference));
+	fclose(reference);
+
+	// Simulate a capture process: write the start of the data, then append the rest in steps while the reader waits
+	auto appendData = [](const char location[], const int8_t *data, std::vector<int64_t> steps) {
+		FILE *output = fopen(location, "ab");
+		if (output == nullptr) {
+			return;
+		}
+		int64_t offset = 0;
+		for (const int64_t step : steps) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(150));
+			fwrite(&(data[offset]), sizeof(int8_t), step, output);
+			fflush(output);
+			offset += step;
+		}
+		fclose(output);
+	};
+	auto writeStart = [](const char location[], const int8_t *data, int64_t length) {
+		FILE *output = fopen(location, "wb");
+		ASSERT_NE(nullptr, output);
+		ASSERT_EQ(length, (int64_t) fwrite(data, sizeof(int8_t), length, output));
+		fclose(output);
+	};
+
+	{
+		SCOPED_TRACE("Normal");
+		const int64_t startLength = 7824 * 40 + 100;
+		writeStart(followLocation, rawData.data(), startLength);
+
+		lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+		ASSERT_NE(nullptr, input);
+		input->readerType = NORMAL;
+		input->followTimeout = 5.0f;
+		strncpy(input->inputLocations[0], followLocation, DEF_STR_LEN);
+		std::vector<int8_t> buffer(inputSize);
+		int8_t *bufferPtr = buffer.data();
+		ASSERT_EQ(0, lofar_udp_io_read_setup_helper(input, &bufferPtr, inputSize, 0));
+
+		const int64_t remaining = inputSize - startLength;
+		std::thread writer(appendData, followLocation, &(rawData[startLength]), std::vector<int64_t>{ remaining / 3, remaining / 3, remaining - 2 * (remaining / 3) });
+		EXPECT_EQ(inputSize, lofar_udp_io_read(input, 0, bufferPtr, inputSize));
+		writer.join();
+		EXPECT_EQ(0, memcmp(rawData.data(), bufferPtr, inputSize));
+		EXPECT_GE(input->followNotify[0], 0);
+
+		// Once the writer stops, the idle timeout ends the input
+		input->followTimeout = 0.2f;
+		struct timespec tick, tock;
+		CLICK(tick);
+		EXPECT_EQ(0, lofar_udp_io_read(input, 0, bufferPtr, 7824));
+		CLICK(tock);
+		EXPECT_GE(TICKTOCK(tick, tock), 0.15);
+		lofar_udp_io_read_cleanup(input);
+	}
+
+	{
+		SCOPED_TRACE("Zstandard");
+		ZSTD_CCtx *cctx = ZSTD_createCCtx();
+		ASSERT_NE(nullptr, cctx);
+		std::vector<int8_t> compressedData;
+		std::vector<int8_t> frameBuffer(ZSTD_compressBound(inputSize));
+		for (int64_t rawOffset = 0; rawOffset < inputSize; rawOffset += 7824 * 16) {
+			const int64_t frameLength = std::min(inputSize - rawOffset, (int64_t) 7824 * 16);
+			const size_t frameSize = ZSTD_compress2(cctx, frameBuffer.data(), frameBuffer.size(), &(rawData[rawOffset]), frameLength);
+			ASSERT_EQ(0, ZSTD_isError(frameSize));
+			compressedData.insert(compressedData.end(), frameBuffer.begin(), frameBuffer.begin() + (int64_t) frameSize);
+		}
+		ZSTD_freeCCtx(cctx);
+
+		// Stop part way through a frame, as a writer would
+		const int64_t compressedSize = (int64_t) compressedData.size();
+		const int64_t startLength = compressedSize / 3 + 17;
+		writeStart(compressedLocation, compressedData.data(), startLength);
+
+		lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+		ASSERT_NE(nullptr, input);
+		input->readerType = ZSTDCOMPRESSED_INDIRECT;
+		input->followTimeout = 5.0f;
+		strncpy(input->inputLocations[0], compressedLocation, DEF_STR_LEN);
+		const int64_t readSize = 7824 * 64;
+		std::vector<int8_t> buffer(readSize);
+		int8_t *bufferPtr = buffer.data();
+		ASSERT_EQ(0, lofar_udp_io_read_setup_helper(input, &bufferPtr, readSize, 0));
+
+		const int64_t remaining = compressedSize - startLength;
+		std::thread writer(appendData, compressedLocation, &(compressedData[startLength]), std::vector<int64_t>{ remaining / 2, remaining - remaining / 2 });
+		int64_t totalRead = 0, lastRead;
+		while (totalRead < inputSize && (lastRead = lofar_udp_io_read(input, 0, bufferPtr, readSize)) > 0) {
+			ASSERT_EQ(std::min(readSize, inputSize - totalRead), lastRead);
+			ASSERT_EQ(0, memcmp(&(rawData[totalRead]), bufferPtr, lastRead));
+			totalRead += lastRead;
+		}
+		writer.join();
+		EXPECT_EQ(inputSize, totalRead);
+		EXPECT_EQ(compressedSize, (int64_t) input->readingTracker[0].size);
+
+		input->followTimeout = 0.2f;
+		EXPECT_EQ(0, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+		lofar_udp_io_read_cleanup(input);
+	}
+
+	remove(followLocation);
+	remove(compressedLocation);
+}
+
+TEST(LibIoTests, SharedMemoryRing) {
+	const char inputLocation[] = "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000";
+	const int32_t packetLength = 7824;
+
+	FILE *reference = fopen(inputLocation, "rb");
+	ASSERT_NE(nullptr, reference);
+	const int64_t inputSize = _FILE_file_size(reference);
+	std::vector<int8_t> rawData(inputSize);
+	ASSERT_EQ(inputSize, (int64_t) fread(rawData.data(), sizeof(int8_t), inputSize, reference));
+	fclose(reference);
+
+	// Invalid ring names
+	char name[DEF_STR_LEN + 1];
+	EXPECT_EQ(0, _lofar_udp_io_SHM_name(name, "upm_ring"));
+	EXPECT_EQ(std::string("/upm_ring"), std::string(name));
+	EXPECT_EQ(0, _lofar_udp_io_SHM_name(name, "/upm_ring"));
+	EXPECT_EQ(std::string("/upm_ring"), std::string(name));
+	EXPECT_GT(0, _lofar_udp_io_SHM_name(name, "/"));
+	EXPECT_GT(0, _lofar_udp_io_SHM_name(name, "upm/ring"));
+
+	// Use a ring far smaller than the data, so that the writer wraps around and waits on the consumers
+	shm_unlink("/upm_test_ring_0");
+	lofar_udp_io_write_config *output = lofar_udp_io_write_alloc();
+	ASSERT_NE(nullptr, output);
+	ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(output, "SHM:upm_test_ring_[[idx]]"));
+	EXPECT_EQ(SHM, output->readerType);
+	output->shmConfig.ringSize = packetLength * 16;
+	output->shmConfig.packetLength = packetLength;
+	output->shmConfig.cleanupTimeout = 5.0f;
+	int64_t outputLength[1] = { packetLength * 16 };
+	ASSERT_EQ(0, lofar_udp_io_write_setup_helper(output, outputLength, 1, 0, 0));
+	EXPECT_EQ(std::string("upm_test_ring_0"), std::string(output->outputLocations[0]));
+
+	// Existing rings are only continued when requested
+	EXPECT_EQ(nullptr, _lofar_udp_io_SHM_create("upm_test_ring_0", packetLength * 16, packetLength, 0, 0));
+	EXPECT_GT(0, lofar_udp_io_write_setup_helper(output, outputLength, 1, 1, 0));
+
+	auto attach = [&](int32_t expectedPacketLength) {
+		lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+		input->readerType = SHM;
+		input->portPacketLength[0] = expectedPacketLength;
+		strncpy(input->inputLocations[0], "upm_test_ring_0", DEF_STR_LEN);
+		return input;
+	};
+
+	std::vector<int8_t> copyBuffer(inputSize), inPlaceBuffer(inputSize);
+	int8_t *copyPtr = copyBuffer.data();
+	lofar_udp_io_read_config *copyInput = attach(packetLength);
+	ASSERT_EQ(0, lofar_udp_io_read_setup_helper(copyInput, &copyPtr, inputSize, 0));
+	lofar_udp_io_read_config *inPlaceInput = attach(packetLength);
+	int8_t *inPlacePtr = inPlaceBuffer.data();
+	ASSERT_EQ(0, lofar_udp_io_read_setup_helper(inPlaceInput, &inPlacePtr, inputSize, 0));
+
+	// The packet length recorded by the writer is checked against the reader's
+	lofar_udp_io_read_config *mismatchInput = attach(1000);
+	int8_t *mismatchPtr = copyBuffer.data();
+	EXPECT_GT(0, lofar_udp_io_read_setup_helper(mismatchInput, &mismatchPtr, packetLength, 0));
+	lofar_udp_io_read_cleanup(mismatchInput);
+
+	// Only rings and ringbuffers support in-place reads
+	const int8_t *inPlaceData = nullptr;
+	lofar_udp_io_read_config *fileInput = lofar_udp_io_read_alloc();
+	fileInput->readerType = NORMAL;
+	EXPECT_EQ(-1, lofar_udp_io_read_acquire(fileInput, 0, &inPlaceData, packetLength));
+	EXPECT_EQ(-1, lofar_udp_io_read_release(fileInput, 0, packetLength));
+	// Ringbuffers support them, but only once they have been attached
+	fileInput->readerType = DADA_ACTIVE;
+	EXPECT_EQ(-1, lofar_udp_io_read_acquire(fileInput, 0, &inPlaceData, packetLength));
+	EXPECT_EQ(-1, lofar_udp_io_read_release(fileInput, 0, packetLength));
+	free(fileInput);
+
+	// Temporary reads start from the oldest data in the ring, without moving the attached consumers
+	ASSERT_EQ(packetLength * 4, lofar_udp_io_write(output, 0, rawData.data(), packetLength * 4));
+	lofar_udp_config *config = lofar_udp_config_alloc();
+	config->readerType = SHM;
+	strncpy(config->inputLocations[0], "upm_test_ring_0", DEF_STR_LEN);
+	std::vector<int8_t> tempBuffer(packetLength);
+	EXPECT_EQ(packetLength, lofar_udp_io_read_temp(config, 0, tempBuffer.data(), packetLength, 1, 1));
+	EXPECT_EQ(0, memcmp(rawData.data(), tempBuffer.data(), packetLength));
+	lofar_udp_config_cleanup(config);
+
+	// Write the rest in uneven steps, then finish the ring once the consumers have drained it
+	std::thread writer([&]() {
+		int64_t offset = packetLength * 4;
+		while (offset < inputSize) {
+			const int64_t step = std::min(inputSize - offset, (int64_t) packetLength * 5 + 17);
+			if (lofar_udp_io_write(output, 0, &(rawData[offset]), step) != step) {
+				break;
+			}
+			offset += step;
+		}
+		lofar_udp_io_write_cleanup(output, 1);
+	});
+
+	std::thread inPlaceReader([&]() {
+		int64_t totalRead = 0, available;
+		while ((available = lofar_udp_io_read_acquire(inPlaceInput, 0, &inPlaceData, packetLength * 8)) > 0) {
+			memcpy(&(inPlaceBuffer[totalRead]), inPlaceData, available);
+			totalRead += available;
+			if (lofar_udp_io_read_release(inPlaceInput, 0, available) < 0) {
+				break;
+			}
+		}
+		EXPECT_EQ(inputSize, totalRead);
+	});
+
+	EXPECT_EQ(inputSize, lofar_udp_io_read(copyInput, 0, copyPtr, inputSize));
+	writer.join();
+	inPlaceReader.join();
+	EXPECT_EQ(0, memcmp(rawData.data(), copyBuffer.data(), inputSize));
+	EXPECT_EQ(0, memcmp(rawData.data(), inPlaceBuffer.data(), inputSize));
+	EXPECT_EQ(inputSize, copyInput->streamOffset[0]);
+	EXPECT_EQ(inputSize, inPlaceInput->streamOffset[0]);
+
+	// The end of the stream produces a short read, and the ring is removed once the writer is cleaned up
+	EXPECT_EQ(0, lofar_udp_io_read(copyInput, 0, copyPtr, packetLength));
+	lofar_udp_io_read_cleanup(copyInput);
+	lofar_udp_io_read_cleanup(inPlaceInput);
+	EXPECT_EQ(nullptr, _lofar_udp_io_SHM_open("upm_test_ring_0"));
+
+	{
+		SCOPED_TRACE("Reader");
+		// The reader consumes a ring as it would the file the data came from
+		auto processInput = [&](const char location[], reader_t readerType, const int64_t packetsPerIteration, std::vector<int8_t> &outputData) {
+			lofar_udp_config *config = lofar_udp_config_alloc();
+			ASSERT_NE(nullptr, config);
+			strncpy(config->inputLocations[0], location, DEF_STR_LEN);
+			config->readerType = readerType;
+			config->numPorts = 1;
+			config->packetsPerIteration = packetsPerIteration;
+			config->processingMode = PACKET_FULL_COPY;
+			lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+			FREE_NOT_NULL(config);
+			ASSERT_NE(nullptr, reader);
+
+			while (lofar_udp_reader_step(reader) < 1) {
+				const int64_t outputLength = reader->meta->packetsPerIteration * reader->meta->packetOutputLength[0];
+				outputData.insert(outputData.end(), reader->meta->outputData[0], reader->meta->outputData[0] + outputLength);
+			}
+			lofar_udp_reader_cleanup(reader);
+		};
+
+		// Gulps that start on a page of the ring (256 * 7824 bytes) are mapped into the reader's buffer, others are copied
+		for (const int64_t packetsPerIteration : { 32, 256 }) {
+			SCOPED_TRACE(packetsPerIteration);
+			// Hold the full input, the temporary reads made during setup are not registered while the data is written
+			lofar_udp_io_write_config *ringOutput = lofar_udp_io_write_alloc();
+			ASSERT_NE(nullptr, ringOutput);
+			ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(ringOutput, "SHM:upm_test_ring_[[idx]]"));
+			ringOutput->shmConfig.ringSize = inputSize;
+			ringOutput->shmConfig.packetLength = packetLength;
+			ringOutput->shmConfig.cleanupTimeout = 5.0f;
+			ASSERT_EQ(0, lofar_udp_io_write_setup_helper(ringOutput, outputLength, 1, 0, 0));
+			std::thread ringWriter([&]() {
+				for (int64_t offset = 0; offset < inputSize; offset += packetLength * 10) {
+					std::this_thread::sleep_for(std::chrono::milliseconds(5));
+					lofar_udp_io_write(ringOutput, 0, &(rawData[offset]), std::min(inputSize - offset, (int64_t) packetLength * 10));
+				}
+				lofar_udp_io_write_cleanup(ringOutput, 1);
+			});
+
+			std::vector<int8_t> ringOutputData, fileOutputData;
+			processInput("upm_test_ring_0", SHM, packetsPerIteration, ringOutputData);
+			ringWriter.join();
+			processInput(inputLocation, NORMAL, packetsPerIteration, fileOutputData);
+			ASSERT_EQ(fileOutputData.size(), ringOutputData.size());
+			EXPECT_EQ(0, memcmp(fileOutputData.data(), ringOutputData.data(), ringOutputData.size()));
+		}
+	}
+}
+
+TEST(LibIoTests, AsyncWriter) {
+	const int64_t gulpLength = 4096;
+	const int32_t gulps = 24;
+	const int8_t numOutputs = 2;
+
+	lofar_udp_io_write_config *output = lofar_udp_io_write_alloc();
+	ASSERT_NE(nullptr, output);
+	EXPECT_EQ(-1, lofar_udp_io_write_async_setup(nullptr, ASYNC_WRITE_BUFFERS));
+	EXPECT_EQ(nullptr, lofar_udp_io_write_async_buffer(output, 0));
+	EXPECT_EQ(-1, lofar_udp_io_write_async_submit(output, 0, nullptr, 0, nullptr, nullptr));
+	EXPECT_EQ(-1, lofar_udp_io_write_async_wait(output));
+	EXPECT_EQ(0, lofar_udp_io_write_async_cleanup(output));
+
+	ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(output, "./async_write_test_[[idx]]"));
+	output->progressWithExisting = 1;
+	output->numOutputs = numOutputs;
+	// The buffers are sized by the outputs, so they must be setup first
+	EXPECT_EQ(-1, lofar_udp_io_write_async_setup(output, ASYNC_WRITE_BUFFERS));
+	int64_t outputLength[numOutputs] = { gulpLength, gulpLength };
+	ASSERT_EQ(0, lofar_udp_io_write_setup_helper(output, outputLength, numOutputs, 0, 0));
+	EXPECT_EQ(-1, lofar_udp_io_write_async_setup(output, 0));
+	ASSERT_EQ(0, lofar_udp_io_write_async_setup(output, ASYNC_WRITE_BUFFERS));
+	EXPECT_EQ(-1, lofar_udp_io_write_async_setup(output, ASYNC_WRITE_BUFFERS));
+	EXPECT_EQ(nullptr, lofar_udp_io_write_async_buffer(output, numOutputs));
+
+	// Every pool buffer can be held at once, but asking for more than the pool holds fails rather than waiting forever
+	{
+		std::vector<int8_t *> held;
+		for (int32_t buffer = 0; buffer < ASYNC_WRITE_BUFFERS; buffer++) {
+			held.push_back(lofar_udp_io_write_async_buffer(output, 0));
+			ASSERT_NE(nullptr, held.back());
+		}
+		EXPECT_EQ(nullptr, lofar_udp_io_write_async_buffer(output, 0));
+		EXPECT_EQ(-1, lofar_udp_io_write_async_submit(output, 0, held[0], gulpLength + 1, nullptr, nullptr));
+		// Empty submissions return the buffers without writing anything
+		for (int8_t *buffer : held) {
+			EXPECT_EQ(0, lofar_udp_io_write_async_submit(output, 0, buffer, 0, nullptr, nullptr));
+		}
+		EXPECT_EQ(0, lofar_udp_io_write_async_wait(output));
+	}
+
+	// Fill each gulp while the previous ones are written, recording the completions
+	struct completions {
+		std::atomic<int32_t> count{ 0 };
+		std::atomic<int64_t> written{ 0 };
+	} done;
+	std::vector<int8_t> expected[numOutputs];
+	for (int32_t gulp = 0; gulp < gulps; gulp++) {
+		for (int8_t outp = 0; outp < numOutputs; outp++) {
+			int8_t *buffer = lofar_udp_io_write_async_buffer(output, outp);
+			ASSERT_NE(nullptr, buffer);
+			for (int64_t i = 0; i < gulpLength; i++) {
+				buffer[i] = (int8_t) ((gulp * 7 + outp * 13 + i) % 127);
+			}
+			// Shorter writes than the buffer size, as for the final gulp of an observation
+			const int64_t length = gulpLength - gulp;
+			expected[outp].insert(expected[outp].end(), buffer, buffer + length);
+			ASSERT_EQ(0, lofar_udp_io_write_async_submit(output, outp, buffer, length, [](lofar_udp_io_write_config *, int8_t, int8_t *, int64_t written, void *userData) {
+				completions *state = (completions *) userData;
+				state->count++;
+				state->written += written;
+			}, &done));
+		}
+	}
+	EXPECT_EQ(0, lofar_udp_io_write_async_wait(output));
+	EXPECT_EQ(gulps * numOutputs, done.count.load());
+	EXPECT_EQ((int64_t) (expected[0].size() + expected[1].size()), done.written.load());
+
+	// Caller-owned buffers may also be handed over, they are not added to the pool
+	std::vector<int8_t> external(gulpLength, 3);
+	ASSERT_EQ(0, lofar_udp_io_write_async_submit(output, 1, external.data(), gulpLength, nullptr, nullptr));
+	expected[1].insert(expected[1].end(), external.begin(), external.end());
+
+	// A cleanup finishes the outstanding writes before closing the outputs
+	lofar_udp_io_write_cleanup(output, 0);
+	EXPECT_NE(nullptr, output->asyncWriter);
+	for (int8_t outp = 0; outp < numOutputs; outp++) {
+		const std::string location = "./async_write_test_" + std::to_string(outp);
+		FILE *outputFile = fopen(location.c_str(), "rb");
+		ASSERT_NE(nullptr, outputFile);
+		std::vector<int8_t> written(expected[outp].size() + 1);
+		EXPECT_EQ(expected[outp].size(), fread(written.data(), sizeof(int8_t), written.size(), outputFile));
+		fclose(outputFile);
+		written.resize(expected[outp].size());
+		EXPECT_EQ(expected[outp], written);
+		remove(location.c_str());
+	}
+
+	EXPECT_EQ(0, lofar_udp_io_write_async_cleanup(output));
+	EXPECT_EQ(nullptr, output->asyncWriter);
+	ASSERT_EQ(0, lofar_udp_io_write_async_setup(output, 1));
+	lofar_udp_io_write_cleanup(output, 1);
+}
+
+TEST(LibIoTests, WriteAll) {
+	const int64_t gulpLength = 65536;
+	// More outputs than are allocated by default, so the writer has to grow its arrays
+	const int8_t numOutputs = DEFAULT_NUM_OUTPUTS + 2;
+
+	lofar_udp_io_write_config *output = lofar_udp_io_write_alloc();
+	ASSERT_NE(nullptr, output);
+
+	std::vector<int8_t> data[numOutputs];
+	int8_t *src[numOutputs];
+	int64_t nchars[numOutputs], outputLength[numOutputs];
+	double timing[numOutputs];
+	for (int8_t outp = 0; outp < numOutputs; outp++) {
+		// Different lengths per output, as for mixed-resolution outputs
+		data[outp].resize(gulpLength - outp * 1024);
+		for (size_t i = 0; i < data[outp].size(); i++) {
+			data[outp][i] = (int8_t) ((outp * 31 + i) % 113);
+		}
+		src[outp] = data[outp].data();
+		nchars[outp] = (int64_t) data[outp].size();
+		outputLength[outp] = gulpLength;
+		timing[outp] = -1.;
+	}
+
+	EXPECT_EQ(-1, lofar_udp_io_write_all(nullptr, src, nchars, timing));
+	EXPECT_EQ(-1, lofar_udp_io_write_all(output, nullptr, nchars, timing));
+	EXPECT_EQ(-1, lofar_udp_io_write_all(output, src, nullptr, timing));
+	// No outputs have been configured yet
+	EXPECT_EQ(-1, lofar_udp_io_write_all(output, src, nchars, timing));
+
+	for (const std::string format : { "./write_all_test_[[idx]]", "ZSTD:./write_all_test_[[idx]].zst" }) {
+		ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(output, format.c_str()));
+		output->progressWithExisting = 1;
+		output->numOutputs = numOutputs;
+		ASSERT_EQ(0, lofar_udp_io_write_setup_helper(output, outputLength, numOutputs, 0, 0));
+
+		const int64_t expected = std::accumulate(std::begin(nchars), std::end(nchars), (int64_t) 0);
+		EXPECT_EQ(expected, lofar_udp_io_write_all(output, src, nchars, timing));
+		EXPECT_EQ(expected, lofar_udp_io_write_all(output, src, nchars, nullptr));
+		for (int8_t outp = 0; outp < numOutputs; outp++) {
+			EXPECT_GE(timing[outp], 0.);
+			timing[outp] = -1.;
+		}
+
+		// A negative length fails its own output, but the others are still written
+		int64_t badChars[numOutputs];
+		std::copy(std::begin(nchars), std::end(nchars), badChars);
+		badChars[1] = -1;
+		EXPECT_EQ(-1, lofar_udp_io_write_all(output, src, badChars, timing));
+
+		// The configuration is freed by a full cleanup
+		const reader_t type = output->readerType;
+		std::vector<std::string> locations(output->outputLocations, output->outputLocations + numOutputs);
+		lofar_udp_io_write_cleanup(output, 1);
+
+		for (int8_t outp = 0; outp < numOutputs; outp++) {
+			const std::string &location = locations[outp];
+			if (type == NORMAL) {
+				// Each output received its own data, twice from the successful calls and once more from the partial failure
+				FILE *outputFile = fopen(location.c_str(), "rb");
+				ASSERT_NE(nullptr, outputFile);
+				std::vector<int8_t> written(3 * data[outp].size() + 1);
+				const size_t expectedLength = (outp == 1 ? 2 : 3) * data[outp].size();
+				EXPECT_EQ(expectedLength, fread(written.data(), sizeof(int8_t), written.size(), outputFile));
+				fclose(outputFile);
+				for (size_t i = 0; i < expectedLength; i++) {
+					ASSERT_EQ(data[outp][i % data[outp].size()], written[i]);
+				}
+			}
+			remove(location.c_str());
+		}
+
+		output = lofar_udp_io_write_alloc();
+		ASSERT_NE(nullptr, output);
+	}
+
+	lofar_udp_io_write_cleanup(output, 1);
+}
+
+TEST(LibIoTests, ZstdAdaptiveWriter) {
+	const int64_t gulpLength = 256 * 1024;
+	const int32_t gulps = 8;
+	const int32_t startLevel = 3, maxLevel = 6;
+
+	lofar_udp_io_write_config *output = lofar_udp_io_write_alloc();
+	ASSERT_NE(nullptr, output);
+	ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(output, "ZSTD:./zstd_adapt_test_[[idx]].zst"));
+	output->progressWithExisting = 1;
+	output->numOutputs = 1;
+	output->zstdConfig.compressionLevel = startLevel;
+	output->zstdConfig.adaptive = 1;
+	output->zstdConfig.frameSize = gulpLength;
+	int64_t outputLength[1] = { gulpLength };
+
+	// Invalid level ranges are rejected at setup
+	output->zstdConfig.minLevel = 4;
+	output->zstdConfig.maxLevel = 2;
+	EXPECT_EQ(-1, lofar_udp_io_write_setup_helper(output, outputLength, 1, 0, 0));
+	output->zstdConfig.maxLevel = ZSTD_ADAPT_MAX_LEVEL + 1;
+	EXPECT_EQ(-1, lofar_udp_io_write_setup_helper(output, outputLength, 1, 0, 0));
+	output->zstdConfig.minLevel = 1;
+	output->zstdConfig.maxLevel = maxLevel;
+	ASSERT_EQ(0, lofar_udp_io_write_setup_helper(output, outputLength, 1, 0, 0));
+	EXPECT_EQ(startLevel, output->zstdWriter[0].level);
+
+	// Noisy, but compressible, data so that compression takes longer than the bookkeeping around it
+	std::vector<int8_t> data(gulpLength);
+	uint32_t state = 12345;
+	for (int64_t i = 0; i < gulpLength; i++) {
+		state = state * 1103515245u + 12345u;
+		data[i] = (int8_t) ((state >> 16) & 0x1F);
+	}
+	std::vector<int8_t> expected;
+	expected.reserve((2 * gulps + 1) * gulpLength);
+
+	// An output that is mostly idle between frames moves up to the highest level
+	for (int32_t gulp = 0; gulp < gulps; gulp++) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		ASSERT_EQ(gulpLength, lofar_udp_io_write(output, 0, data.data(), gulpLength));
+		expected.insert(expected.end(), data.begin(), data.end());
+	}
+	EXPECT_EQ(maxLevel, output->zstdWriter[0].level);
+	EXPECT_EQ(gulps, output->zstdWriter[0].frames);
+	EXPECT_EQ(gulpLength, output->zstdWriter[0].levelBytes[startLevel]);
+	EXPECT_EQ(gulpLength * (gulps - (maxLevel - startLevel)), output->zstdWriter[0].levelBytes[maxLevel]);
+
+	// An output that is always compressing moves back down
+	for (int32_t gulp = 0; gulp < gulps; gulp++) {
+		ASSERT_EQ(gulpLength, lofar_udp_io_write(output, 0, data.data(), gulpLength));
+		expected.insert(expected.end(), data.begin(), data.end());
+	}
+	EXPECT_LT(output->zstdWriter[0].level, maxLevel);
+
+	// Data left in an open frame is written out when the output is closed
+	ASSERT_EQ(gulpLength / 2, lofar_udp_io_write(output, 0, data.data(), gulpLength / 2));
+	expected.insert(expected.end(), data.begin(), data.begin() + gulpLength / 2);
+	int64_t recorded = 0;
+	for (int32_t level = 0; level <= ZSTD_ADAPT_MAX_LEVEL; level++) {
+		recorded += output->zstdWriter[0].levelBytes[level];
+	}
+	EXPECT_EQ((int64_t) expected.size(), recorded);
+	const std::string location = output->outputLocations[0];
+	lofar_udp_io_write_cleanup(output, 1);
+
+	FILE *outputFile = fopen(location.c_str(), "rb");
+	ASSERT_NE(nullptr, outputFile);
+	const int64_t compressedLength = _FILE_file_size(outputFile);
+	std::vector<int8_t> compressed(compressedLength);
+	ASSERT_EQ((size_t) compressedLength, fread(compressed.data(), sizeof(int8_t), compressedLength, outputFile));
+	fclose(outputFile);
+	remove(location.c_str());
+
+	std::vector<int8_t> decompressed(expected.size() + 1);
+	EXPECT_EQ(expected.size(), ZSTD_decompress(decompressed.data(), decompressed.size(), compressed.data(), compressed.size()));
+	decompressed.resize(expected.size());
+	EXPECT_EQ(expected, decompressed);
+}
+
+TEST(LibIoTests, ZstdFilteredWriter) {
+	const int64_t gulpLengths[3] = { 7824 * 16 + 3, 7824 * 9, 7824 * 12 + 1 };
+	const char header[] = "HEADER_START filtered zstandard test HEADER_END";
+
+	// 8-bit Xr, Xi, Yr, Yi samples, with components that vary at different rates
+	std::vector<int8_t> data(gulpLengths[0]);
+	uint32_t state = 54321;
+	for (int64_t i = 0; i < gulpLengths[0]; i++) {
+		state = state * 1103515245u + 12345u;
+		data[i] = (int8_t) ((i % 4) < 2 ? ((state >> 16) & 0x7F) : ((state >> 16) & 0x03));
+	}
+
+	for (const std::pair<zstd_filter_t, int32_t> filter : std::vector<std::pair<zstd_filter_t, int32_t>>{ { ZSTD_FILTER_BYTESHUFFLE, 4 }, { ZSTD_FILTER_BITSHUFFLE, 4 }, { ZSTD_FILTER_BYTESHUFFLE, 3 } }) {
+		SCOPED_TRACE(std::to_string(filter.first) + "," + std::to_string(filter.second));
+		lofar_udp_io_write_config *output = lofar_udp_io_write_alloc();
+		ASSERT_NE(nullptr, output);
+		ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(output, "ZSTD:./zstd_filter_test_[[idx]].zst"));
+		output->progressWithExisting = 1;
+		output->numOutputs = 1;
+		int64_t outputLength[1] = { gulpLengths[0] };
+
+		// Invalid filters are rejected at setup
+		output->zstdConfig.filter = filter.first;
+		output->zstdConfig.filterElementSize = 0;
+		EXPECT_EQ(-1, lofar_udp_io_write_setup_helper(output, outputLength, 1, 0, 0));
+		output->zstdConfig.filterElementSize = filter.second;
+		// As are adaptive levels, as every filtered write is its own frame
+		output->zstdConfig.adaptive = 1;
+		EXPECT_EQ(-1, lofar_udp_io_write_setup_helper(output, outputLength, 1, 0, 0));
+		output->zstdConfig.adaptive = 0;
+		ASSERT_EQ(0, lofar_udp_io_write_setup_helper(output, outputLength, 1, 0, 0));
+
+		// Data frames around an unfiltered metadata frame
+		lofar_udp_metadata *metadata = lofar_udp_metadata_alloc();
+		ASSERT_NE(nullptr, metadata);
+		metadata->type = SIGPROC;
+		std::vector<int8_t> expected;
+		for (int32_t gulp = 0; gulp < 3; gulp++) {
+			if (gulp == 1) {
+				ASSERT_EQ((int64_t) sizeof(header), lofar_udp_io_write_metadata(output, 0, metadata, (const int8_t *) header, sizeof(header)));
+				expected.insert(expected.end(), header, header + sizeof(header));
+			}
+			ASSERT_EQ(gulpLengths[gulp], lofar_udp_io_write(output, 0, data.data(), gulpLengths[gulp]));
+			expected.insert(expected.end(), data.begin(), data.begin() + gulpLengths[gulp]);
+		}
+		free(metadata);
+		const std::string location = output->outputLocations[0];
+		lofar_udp_io_write_cleanup(output, 1);
+
+		// Plain decompression skips the descriptions, returning the filtered data
+		FILE *outputFile = fopen(location.c_str(), "rb");
+		ASSERT_NE(nullptr, outputFile);
+		const int64_t compressedLength = _FILE_file_size(outputFile);
+		std::vector<int8_t> compressed(compressedLength);
+		ASSERT_EQ((size_t) compressedLength, fread(compressed.data(), sizeof(int8_t), compressedLength, outputFile));
+		fclose(outputFile);
+		std::vector<int8_t> decompressed(expected.size() + 1);
+		ASSERT_EQ(expected.size(), ZSTD_decompress(decompressed.data(), decompressed.size(), compressed.data(), compressed.size()));
+		decompressed.resize(expected.size());
+		EXPECT_NE(expected, decompressed);
+		EXPECT_EQ(ZSTD_FILTER_MAGIC, *((uint32_t *) compressed.data()));
+
+		// The filter is reverted by temporary reads
+		std::vector<int8_t> tempBuffer(4096);
+		EXPECT_EQ((int64_t) tempBuffer.size(), _lofar_udp_io_read_temp_ZSTD(tempBuffer.data(), 1, (int64_t) tempBuffer.size(), location.c_str(), 0));
+		EXPECT_EQ(0, memcmp(expected.data(), tempBuffer.data(), tempBuffer.size()));
+
+		// Reads through the stream (short reads) and parallel frames (long reads) revert the filter, as do seeks to a description
+		for (const int64_t readSize : std::vector<int64_t>{ 7824 * 5 + 7, (int64_t) expected.size() }) {
+			SCOPED_TRACE(readSize);
+			lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+			ASSERT_NE(nullptr, input);
+			input->readerType = ZSTDCOMPRESSED_INDIRECT;
+			strncpy(input->inputLocations[0], location.c_str(), DEF_STR_LEN);
+			std::vector<int8_t> buffer(readSize);
+			int8_t *bufferPtr = buffer.data();
+			ASSERT_EQ(0, lofar_udp_io_read_setup_helper(input, &bufferPtr, readSize, 0));
+
+			int64_t totalRead = 0, lastRead;
+			while ((lastRead = lofar_udp_io_read(input, 0, bufferPtr, readSize)) > 0) {
+				ASSERT_EQ(std::min(readSize, (int64_t) expected.size() - totalRead), lastRead);
+				ASSERT_EQ(0, memcmp(&(expected[totalRead]), bufferPtr, lastRead));
+				totalRead += lastRead;
+			}
+			EXPECT_EQ((int64_t) expected.size(), totalRead);
+			if (readSize == (int64_t) expected.size()) {
+				EXPECT_NE(nullptr, input->frameDCtx[0][1]);
+			}
+
+			// Anchors: first data frame, metadata, second data frame, third data frame
+			ASSERT_EQ(4, input->zstdAnchorCount[0]);
+			const lofar_udp_io_zstd_anchor anchor = input->zstdAnchors[0][2];
+			EXPECT_EQ(ZSTD_FILTER_MAGIC, *((uint32_t *) &(compressed[anchor.frameOffset])));
+			const int64_t discard = 7824 + 5;
+			ASSERT_EQ(0, _lofar_udp_io_read_seek_ZSTD(input, 0, anchor.frameOffset, discard));
+			const int64_t expectedRead = std::min(readSize, (int64_t) expected.size() - anchor.frameDataOffset - discard);
+			EXPECT_EQ(expectedRead, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+			EXPECT_EQ(0, memcmp(&(expected[anchor.frameDataOffset + discard]), bufferPtr, expectedRead));
+
+			lofar_udp_io_read_cleanup(input);
+		}
+		remove(location.c_str());
+	}
+}
+
+TEST(LibIoTests, Hdf5Reader) {
+	const char inputLocation[] = "./hdf5_reader_test.h5";
+	const hsize_t dims[2] = { 1000, 20 };
+	const hsize_t chunkDims[2] = { 64, 8 };
+
+	// Build a file with the writer's layout, with a gap in the STOKES_* numbering and chunks that do not divide the shape
+	std::vector<std::vector<float>> data(2, std::vector<float>(dims[0] * dims[1]));
+	for (size_t idx = 0; idx < data[0].size(); idx++) {
+		data[0][idx] = (float) idx;
+		data[1][idx] = -0.5f * (float) idx;
+	}
+	{
+		hid_t file = H5Fcreate(inputLocation, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT);
+		ASSERT_GT(file, 0);
+		for (const char *groupName : { "/SUB_ARRAY_POINTING_000", "/SUB_ARRAY_POINTING_000/BEAM_000" }) {
+			hid_t group = H5Gcreate(file, groupName, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+			ASSERT_GT(group, 0);
+			H5Gclose(group);
+		}
+		hid_t prop = H5Pcreate(H5P_DATASET_CREATE);
+		ASSERT_LE(0, H5Pset_chunk(prop, 2, chunkDims));
+		const hsize_t maxDims[2] = { H5S_UNLIMITED, H5S_UNLIMITED };
+		hid_t space = H5Screate_simple(2, dims, maxDims);
+		int32_t dsetIdx = 0;
+		for (const char *dsetName : { "/SUB_ARRAY_POINTING_000/BEAM_000/STOKES_0", "/SUB_ARRAY_POINTING_000/BEAM_000/STOKES_2" }) {
+			hid_t dset = H5Dcreate(file, dsetName, H5T_NATIVE_FLOAT, space, H5P_DEFAULT, prop, H5P_DEFAULT);
+			ASSERT_GT(dset, 0);
+			ASSERT_LE(0, H5Dwrite(dset, H5T_NATIVE_FLOAT, H5S_ALL, H5S_ALL, H5P_DEFAULT, data[dsetIdx++].data()));
+			H5Dclose(dset);
+		}
+		H5Sclose(space);
+		H5Pclose(prop);
+		H5Fclose(file);
+	}
+	const int64_t datasetBytes = (int64_t) (dims[0] * dims[1] * sizeof(float));
+
+	{
+		SCOPED_TRACE("ReadTemp");
+		lofar_udp_config *config = lofar_udp_config_alloc();
+		ASSERT_EQ(0, lofar_udp_io_read_parse_optarg(config, (std::string("HDF5:") + inputLocation).c_str()));
+		EXPECT_EQ(HDF5, config->readerType);
+		float values[5];
+		EXPECT_EQ((int64_t) sizeof(values), lofar_udp_io_read_temp(config, 1, (int8_t *) values, sizeof(float), 5, 1));
+		EXPECT_EQ(0, memcmp(data[1].data(), values, sizeof(values)));
+		EXPECT_GT(0, lofar_udp_io_read_temp(config, 2, (int8_t *) values, sizeof(float), 5, 1));
+		free(config);
+	}
+
+	{
+		SCOPED_TRACE("Reads");
+		// Mix reads smaller than a sample, spanning chunk rows, and covering several whole chunk rows
+		const int64_t maxReadSize = (int64_t) (chunkDims[0] * 5 * dims[1] * sizeof(float)) + 12;
+		lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+		ASSERT_NE(nullptr, input);
+		input->readerType = HDF5;
+		std::vector<std::vector<int8_t>> buffers(2, std::vector<int8_t>(maxReadSize));
+		int8_t *bufferPtrs[2] = { buffers[0].data(), buffers[1].data() };
+		for (int8_t port = 0; port < 2; port++) {
+			strncpy(input->inputLocations[port], inputLocation, DEF_STR_LEN);
+			ASSERT_EQ(0, lofar_udp_io_read_setup_helper(input, bufferPtrs, maxReadSize, port));
+		}
+
+		for (int8_t port = 0; port < 2; port++) {
+			int64_t totalRead = 0, lastRead;
+			int32_t iteration = 0;
+			const int64_t readSizes[4] = { 7, 1000, maxReadSize, 4 * 64 * 20 * 4 - 3 };
+			while ((lastRead = lofar_udp_io_read(input, port, bufferPtrs[port], readSizes[iteration++ % 4])) > 0) {
+				ASSERT_EQ(0, memcmp(&(((int8_t *) data[port].data())[totalRead]), bufferPtrs[port], lastRead));
+				totalRead += lastRead;
+			}
+			EXPECT_EQ(0, lastRead);
+			EXPECT_EQ(datasetBytes, totalRead);
+		}
+
+		lofar_udp_io_read_cleanup(input);
+	}
+
+	{
+		SCOPED_TRACE("MissingDataset");
+		lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+		input->readerType = HDF5;
+		strncpy(input->inputLocations[0], "./referenceFiles/udp_16130.ucc1.2022-06-29T01:30:00.000", DEF_STR_LEN);
+		EXPECT_GT(0, lofar_udp_io_read_setup(input, 0));
+		lofar_udp_io_read_cleanup(input);
+	}
+
+	remove(inputLocation);
+}
+
+TEST(LibIoTests, Hdf5DirectChunkWriter) {
+	const char outputLocation[] = "./hdf5_direct_chunk_test.h5";
+	const int32_t nchan = 40;
+	// Writes that fill part of a chunk row, span several chunk rows, and cover whole chunk rows exactly
+	const std::vector<int64_t> gulpRows = { 1000, 9000, 2 * HDF5_WRITE_CHUNK_ROWS, 7 };
+	const int64_t totalRows = std::accumulate(gulpRows.begin(), gulpRows.end(), (int64_t) 0);
+	const int64_t maxGulpLength = *std::max_element(gulpRows.begin(), gulpRows.end()) * nchan * (int64_t) sizeof(float);
+
+	std::vector<std::vector<float>> data(2, std::vector<float>(totalRows * nchan));
+	for (size_t idx = 0; idx < data[0].size(); idx++) {
+		data[0][idx] = (float) (idx % 977);
+		data[1][idx] = -0.25f * (float) (idx % 313);
+	}
+
+	lofar_udp_io_write_config *output = lofar_udp_io_write_alloc();
+	ASSERT_NE(nullptr, output);
+	ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(output, (std::string("HDF5:") + outputLocation).c_str()));
+	output->numOutputs = 2;
+	int64_t outputLength[2] = { maxGulpLength, maxGulpLength };
+	ASSERT_EQ(0, lofar_udp_io_write_setup_helper(output, outputLength, 2, 0, 0));
+
+	// Attach bitshuffle datasets with the writer's chunk shape, as the metadata writer would
+	ASSERT_LE(0, bshuf_register_h5filter());
+	hid_t prop = H5Pcreate(H5P_DATASET_CREATE);
+	const hsize_t chunkDims[2] = { HDF5_WRITE_CHUNK_ROWS, HDF5_WRITE_CHUNK_CHANNELS };
+	const uint32_t bitshuffleFlags[] = { 0, BSHUF_H5_COMPRESS_ZSTD, (uint32_t) output->zstdConfig.compressionLevel };
+	ASSERT_LE(0, H5Pset_chunk(prop, 2, chunkDims));
+	ASSERT_LE(0, H5Pset_filter(prop, BSHUF_H5FILTER, H5Z_FLAG_OPTIONAL, 3, bitshuffleFlags));
+	output->hdf5Writer.dtype = H5Tcopy(H5T_NATIVE_FLOAT);
+	output->hdf5Writer.elementSize = sizeof(float);
+	output->hdf5Writer.directChunks = 1;
+	const hsize_t maxDims[2] = { H5S_UNLIMITED, H5S_UNLIMITED };
+	for (int8_t outp = 0; outp < 2; outp++) {
+		output->hdf5Writer.hdf5DSetWriter[outp].dims[0] = 0;
+		output->hdf5Writer.hdf5DSetWriter[outp].dims[1] = nchan;
+		hid_t space = H5Screate_simple(2, output->hdf5Writer.hdf5DSetWriter[outp].dims, maxDims);
+		const std::string dsetName = "/SUB_ARRAY_POINTING_000/BEAM_000/STOKES_" + std::to_string(outp);
+		output->hdf5Writer.hdf5DSetWriter[outp].dset = H5Dcreate(output->hdf5Writer.file, dsetName.c_str(), output->hdf5Writer.dtype, space, H5P_DEFAULT, prop, H5P_DEFAULT);
+		ASSERT_GT(output->hdf5Writer.hdf5DSetWriter[outp].dset, 0);
+		H5Sclose(space);
+		ASSERT_EQ(0, _lofar_udp_io_write_HDF5_direct_setup(output, outp));
+	}
+	H5Pclose(prop);
+	output->hdf5Writer.metadataInitialised = 1;
+
+	int64_t row = 0;
+	for (const int64_t rows : gulpRows) {
+		for (int8_t outp = 0; outp < 2; outp++) {
+			ASSERT_EQ(rows * nchan * (int64_t) sizeof(float), lofar_udp_io_write(output, outp, (int8_t *) &(data[outp][row * nchan]), rows * nchan * (int64_t) sizeof(float)));
+		}
+		row += rows;
+		EXPECT_EQ((hsize_t) (row % HDF5_WRITE_CHUNK_ROWS), output->hdf5Writer.hdf5DSetWriter[0].stagedRows);
+	}
+	// Partial rows cannot be written, and are reported as a short write
+	EXPECT_EQ(0, lofar_udp_io_write(output, 0, (int8_t *) data[0].data(), 3));
+	EXPECT_EQ((hsize_t) (row % HDF5_WRITE_CHUNK_ROWS), output->hdf5Writer.hdf5DSetWriter[0].stagedRows);
+	lofar_udp_io_write_cleanup(output, 1);
+
+	// The output is read back through the standard filter
+	lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+	ASSERT_NE(nullptr, input);
+	input->readerType = HDF5;
+	const int64_t readSize = 3 * HDF5_WRITE_CHUNK_ROWS * nchan * (int64_t) sizeof(float) + 20;
+	std::vector<std::vector<int8_t>> buffers(2, std::vector<int8_t>(readSize));
+	int8_t *bufferPtrs[2] = { buffers[0].data(), buffers[1].data() };
+	for (int8_t port = 0; port < 2; port++) {
+		strncpy(input->inputLocations[port], outputLocation, DEF_STR_LEN);
+		ASSERT_EQ(0, lofar_udp_io_read_setup_helper(input, bufferPtrs, readSize, port));
+	}
+	for (int8_t port = 0; port < 2; port++) {
+		int64_t totalRead = 0, lastRead;
+		while ((lastRead = lofar_udp_io_read(input, port, bufferPtrs[port], readSize)) > 0) {
+			ASSERT_EQ(0, memcmp(&(((int8_t *) data[port].data())[totalRead]), bufferPtrs[port], lastRead));
+			totalRead += lastRead;
+		}
+		EXPECT_EQ(totalRows * nchan * (int64_t) sizeof(float), totalRead);
+	}
+	lofar_udp_io_read_cleanup(input);
+
+	remove(outputLocation);
+}
 
 TEST(LibIoTests, ConfigReadSetupHelper) {
 	//int lofar_udp_io_read_setup_helper(lofar_udp_io_read_config *input, const lofar_udp_config *config, const lofar_udp_obs_meta *meta,
@@ -312,11 +1660,14 @@ TEST(LibIoTests, ConfigWriteSetupHelper) {
 	EXPECT_EQ(-2, lofar_udp_io_write_setup(output, -1));
 	output->numOutputs = 0;
 	EXPECT_EQ(-3, lofar_udp_io_write_setup(output, 0));
-	output->numOutputs = MAX_OUTPUT_DIMS + 1;
+	output->numOutputs = -1;
 	EXPECT_EQ(-3, lofar_udp_io_write_setup(output, 0));
-	output->numOutputs = 4;
+	output->numOutputs = DEFAULT_NUM_OUTPUTS + 2;
 	output->readerType = DADA_ACTIVE;
 	EXPECT_EQ(-4, lofar_udp_io_write_setup(output, 1));
+	EXPECT_EQ(DEFAULT_NUM_OUTPUTS + 2, output->allocatedOutputs);
+	EXPECT_EQ(-1, output->writeBufSize[DEFAULT_NUM_OUTPUTS + 1]);
+	output->numOutputs = 4;
 
 
 	EXPECT_EQ(-1, _lofar_udp_io_write_internal_lib_setup_helper(nullptr, nullptr, -1));
@@ -356,7 +1707,7 @@ TEST(LibIoTests, ReadSanityChecks) {
 	EXPECT_EQ(-1, lofar_udp_io_read(input, 0, nullptr, 3));
 	EXPECT_EQ(-1, lofar_udp_io_read(input, 0, nullptr, 2));
 	EXPECT_EQ(-1, lofar_udp_io_read(input, -1, nullptr, 2));
-	EXPECT_EQ(-1, lofar_udp_io_read(input, MAX_NUM_PORTS + 1, nullptr, 2));
+	EXPECT_EQ(-1, lofar_udp_io_read(input, input->allocatedPorts, nullptr, 2));
 
 	free(input);
 };
@@ -369,7 +1720,7 @@ TEST(LibIoTests, ReadTempSanityChecks) {
 	lofar_udp_config *config = lofar_udp_config_alloc();
 	EXPECT_EQ(-1, lofar_udp_io_read_temp(nullptr, -1, nullptr, -1, -1, 0));
 	EXPECT_EQ(-2, lofar_udp_io_read_temp(config, -1, tmp, -1, -1, 0));
-	EXPECT_EQ(-2, lofar_udp_io_read_temp(config, MAX_NUM_PORTS + 1, tmp, -1, -1, 0));
+	EXPECT_EQ(-2, lofar_udp_io_read_temp(config, config->allocatedPorts, tmp, -1, -1, 0));
 	EXPECT_EQ(0, lofar_udp_io_read_temp(config, 0, tmp, -1, 0, 0));
 	EXPECT_EQ(-3, lofar_udp_io_read_temp(config, 0, tmp, -1, -1, 0));
 
@@ -397,7 +1748,7 @@ TEST(LibIoTests, WriteMetaanityChecks) {
 	EXPECT_EQ(-1, lofar_udp_io_write_metadata(nullptr, 0, nullptr, nullptr, -1));
 	EXPECT_EQ(-1, lofar_udp_io_write_metadata(nullptr, 0, nullptr, nullptr, -1));
 	EXPECT_EQ(-2, lofar_udp_io_write_metadata(output, -1, metadata, nullptr, -1));
-	EXPECT_EQ(-2, lofar_udp_io_write_metadata(output, MAX_OUTPUT_DIMS + 1, metadata, nullptr, -1));
+	EXPECT_EQ(-2, lofar_udp_io_write_metadata(output, output->allocatedOutputs, metadata, nullptr, -1));
 	output->readerType = HDF5;
 	metadata->type = SIGPROC;
 	EXPECT_EQ(-3, lofar_udp_io_write_metadata(output, 1, metadata, nullptr, -1));
@@ -438,6 +1789,10 @@ TEST(LibIoTests, OptargGeneralParser) {
 		{ZSTDCOMPRESSED, "ZSTD:CFile,1,1,1", "CFile"},
 		{ZSTDCOMPRESSED, "AFile.zst,1,1,1", "AFile.zst"},
 		{DADA_ACTIVE, "DADA:1000,1,1,1", "1000"},
+		{UDP, "UDP:127.0.0.1:16130,1,1,1", "127.0.0.1:16130"},
+		{PCAP, "PCAP:capture.pcap@16130,1,1,1", "capture.pcap@16130"},
+		{PCAP, "capture.pcapng,1,1,1", "capture.pcapng"},
+		{SHM, "SHM:upm_ring,1,1,1", "upm_ring"},
 		{HDF5, "HDF5:File,22", "File"},
 		{HDF5, "AFile.h5,22", "AFile.h5"},
 		{HDF5, "AFile.hdf5,22", "AFile.hdf5"},
@@ -130,7 +130,7 @@ TEST(LibMetadataTests, HelperFunctions) {
 
 	// int lofar_udp_metdata_set_default(lofar_udp_metadata *metadata)
 	const int32_t flagIdx = 64;
-	static_assert(flagIdx < MAX_NUM_PORTS * UDPMAXBEAM);
+	static_assert(flagIdx < DEFAULT_NUM_PORTS * UDPMAXBEAM);
 	EXPECT_EQ(-1, _lofar_udp_metdata_setup_BASE(nullptr));
 	for (metadata_t mode : std::vector<metadata_t>{NO_META, GUPPI, DADA, SIGPROC, HDF5_META}) {
 		metadata->type = mode;
@@ -141,11 +141,13 @@ TEST(LibMetadataTests, HelperFunctions) {
 			EXPECT_NE(nullptr, metadata->headerBuffer);
 		}
 
-		for (size_t idx = 0; idx < MAX_NUM_PORTS * UDPMAXBEAM; idx++) EXPECT_EQ(-1, metadata->subbands[idx]);
+		for (size_t idx = 0; idx < metadata->allocatedPorts * UDPMAXBEAM; idx++) EXPECT_EQ(-1, metadata->subbands[idx]);
 
-		for (int32_t port = 0; port < MAX_NUM_PORTS; port++) {
+		for (int32_t port = 0; port < metadata->allocatedPorts; port++) {
 			EXPECT_EQ(0, strnlen(metadata->rawfile[port], META_STR_LEN));
-			EXPECT_EQ(0, strnlen(metadata->upm_outputfmt[port], META_STR_LEN));
+		}
+		for (int32_t out = 0; out < metadata->allocatedOutputs; out++) {
+			EXPECT_EQ(0, strnlen(metadata->upm_outputfmt[out], META_STR_LEN));
 		}
 
 		EXPECT_EQ(1, metadata->resolution);
@@ -501,7 +503,8 @@ TEST(LibMetadataTests, StructHandlers) {
 		EXPECT_FLOAT_EQ(refBw, metadata->bw);
 
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[1].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		EXPECT_EQ(0, lofar_udp_metadata_setup(metadata, nullptr, config));
@@ -510,7 +513,8 @@ TEST(LibMetadataTests, StructHandlers) {
 		EXPECT_FLOAT_EQ(refTopFreq, metadata->ftop);
 		EXPECT_FLOAT_EQ(refBw, metadata->bw);
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[3].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		EXPECT_EQ(0, lofar_udp_metadata_setup(metadata, nullptr, config));
@@ -519,7 +523,8 @@ TEST(LibMetadataTests, StructHandlers) {
 		EXPECT_FLOAT_EQ(160.0 + 11.5 * 80 / 512.0, metadata->ftop);
 		EXPECT_FLOAT_EQ(488.0 * 80.0 / 512.0, metadata->bw);
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[4].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		EXPECT_EQ(0, lofar_udp_metadata_setup(metadata, nullptr, config));
@@ -528,7 +533,8 @@ TEST(LibMetadataTests, StructHandlers) {
 		EXPECT_FLOAT_EQ(refTopFreq + 200, metadata->ftop);
 		EXPECT_FLOAT_EQ(refBw, metadata->bw);
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[5].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		EXPECT_EQ(0, lofar_udp_metadata_setup(metadata, nullptr, config));
@@ -539,25 +545,29 @@ TEST(LibMetadataTests, StructHandlers) {
 		EXPECT_FLOAT_EQ((228.5 - 53.5) * 100.0 / 512.0 + 200.0, metadata->bw);
 
 		std::cout << "Mark\n";
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[7].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		EXPECT_EQ(-1, lofar_udp_metadata_setup(metadata, nullptr, config));
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[8].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		EXPECT_EQ(-1, lofar_udp_metadata_setup(metadata, nullptr, config));
 
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[9].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		EXPECT_EQ(-1, lofar_udp_metadata_setup(metadata, nullptr, config));
 
 
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[1].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		reader->meta->clockBit = 1;
@@ -569,15 +579,15 @@ TEST(LibMetadataTests, StructHandlers) {
 		reader->meta->packetOutputLength[0] = 7824;
 		reader->meta->processingMode = STOKES_I_REV;
 		reader->meta->calibrateData = APPLY_CALIBRATION;
-		reader->input->numInputs = MAX_NUM_PORTS;
-		reader->meta->numPorts = MAX_NUM_PORTS;
+		reader->input->numInputs = DEFAULT_NUM_PORTS;
+		reader->meta->numPorts = DEFAULT_NUM_PORTS;
 		reader->meta->numOutputs = 1;
 		reader->input->offsetPortCount = 0;
 		reader->meta->baseBeamlets[0] = 0;
-		ARR_INIT(reader->meta->upperBeamlets, MAX_NUM_PORTS, UDPMAXBEAM / 2);
+		ARR_INIT(reader->meta->upperBeamlets, DEFAULT_NUM_PORTS, UDPMAXBEAM / 2);
 		reader->meta->totalProcBeamlets = 488;
 		reader->meta->inputData[0] = (int8_t*) calloc(16 + PREBUFLEN, sizeof(int8_t)) + PREBUFLEN;
-		*((uint32_t *) &(reader->meta->inputData[CEP_HDR_TIME_OFFSET])) = (uint32_t) rand();
+		*((uint32_t *) &(reader->meta->inputData[0][CEP_HDR_TIME_OFFSET])) = (uint32_t) rand();
 		for (int i = 0; i < reader->input->numInputs; i++) {
 			std::string tmp = std::to_string(i);
 			strncpy(reader->input->inputLocations[i], tmp.c_str(), tmp.length());
@@ -594,7 +604,8 @@ TEST(LibMetadataTests, StructHandlers) {
 		EXPECT_FLOAT_EQ(refTopFreq, metadata->fbottom);
 		EXPECT_FLOAT_EQ(refTopFreq, metadata->ftop_raw);
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[1].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		config->externalChannelisation = 8;
@@ -610,7 +621,8 @@ TEST(LibMetadataTests, StructHandlers) {
 		EXPECT_FLOAT_EQ(refTopFreq - metadata->channel_bw * 0.5, metadata->fbottom);
 		EXPECT_FLOAT_EQ(refTopFreq, metadata->ftop_raw);
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[1].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		config->externalChannelisation = 9;
@@ -626,7 +638,8 @@ TEST(LibMetadataTests, StructHandlers) {
 		EXPECT_FLOAT_EQ(refTopFreq, metadata->fbottom);
 		EXPECT_FLOAT_EQ(refTopFreq, metadata->ftop_raw);
 
-		*(metadata) = lofar_udp_metadata_default;
+		lofar_udp_metadata_cleanup(metadata);
+		metadata = lofar_udp_metadata_alloc();
 		strncpy(config->metadataLocation, metadataLocation[2].c_str(), DEF_STR_LEN);
 		metadata->type = DADA;
 		config->externalChannelisation = 9;
@@ -20,7 +20,7 @@
 lofar_udp_config* config_setup(int32_t sampleMeta = 0, int32_t testNumber = 0, int32_t testPorts = 4, int32_t packetsReadMax = 32, calibrate_t calibration = NO_CALIBRATION) {
 	lofar_udp_config *config = lofar_udp_config_alloc();
 	EXPECT_NE(nullptr, config);
-	assert(numPorts <= MAX_NUM_PORTS);
+	assert(numPorts <= config->allocatedPorts && testPorts <= config->allocatedPorts);
 	config->calibrationDuration = 1.2;
 
 	for (int32_t port = 0; port < testPorts; port++) {
@@ -75,8 +75,8 @@ TEST(LibReaderTests, SetupReader) {
 		SCOPED_TRACE("_lofar_udp_reader_config_check");
 		EXPECT_EQ(0, _lofar_udp_reader_config_check(config));
 
-		// (config->numPorts > MAX_NUM_PORTS || config->numPorts < 1)
-		MODIFY_AND_RESET(config->numPorts, tmpVal, MAX_NUM_PORTS + 1, EXPECT_EQ(-1, _lofar_udp_reader_config_check(config)););
+		// (config->numPorts > config->allocatedPorts || config->numPorts < 1)
+		MODIFY_AND_RESET(config->numPorts, tmpVal, config->allocatedPorts + 1, EXPECT_EQ(-1, _lofar_udp_reader_config_check(config)););
 		MODIFY_AND_RESET(config->numPorts, tmpVal, -1, EXPECT_EQ(-1, _lofar_udp_reader_config_check(config)););
 
 		// (!strlen(config->inputLocations[port]))
@@ -219,7 +219,7 @@ TEST(LibReaderTests, PreprocessingRawData) {
 		EXPECT_EQ(0, _lofar_udp_reader_malformed_header_checks(header));
 	}
 
-	//int lofar_udp_parse_headers(lofar_udp_obs_meta *meta, const int8_t header[MAX_NUM_PORTS][UDPHDRLEN], const int16_t beamletLimits[2])
+	//int lofar_udp_parse_headers(lofar_udp_obs_meta *meta, const int8_t header[][UDPHDRLEN], const int16_t beamletLimits[2])
 	//void _lofar_udp_parse_header_extract_metadata(int port, lofar_udp_obs_meta *meta, const int8_t header[UDPHDRLEN], const int16_t beamletLimits[2])
 	{
 		SCOPED_TRACE("_lofar_udp_parse_header_buffers");
@@ -237,14 +237,14 @@ TEST(LibReaderTests, PreprocessingRawData) {
 		*((uint8_t *) &(header[CEP_HDR_NBEAM_OFFSET])) = 244;
 		source->bitMode = 2;
 
-		int8_t headers[MAX_NUM_PORTS][UDPHDRLEN];
-		for (size_t port = 0; port < MAX_NUM_PORTS; port++) {
+		int8_t headers[DEFAULT_NUM_PORTS][UDPHDRLEN];
+		for (size_t port = 0; port < DEFAULT_NUM_PORTS; port++) {
 			memcpy(&(headers[port][0]), &(header[0]), UDPHDRLEN);
 		}
 
 
 		int16_t beamletLimits[2] = {0, 0};
-		meta->numPorts = MAX_NUM_PORTS;
+		meta->numPorts = DEFAULT_NUM_PORTS;
 		EXPECT_EQ(0, _lofar_udp_parse_header_buffers(meta, headers, beamletLimits));
 
 		*((uint8_t *) &(headers[0][CEP_HDR_NBEAM_OFFSET])) -= 122;
@@ -277,10 +277,11 @@ TEST(LibReaderTests, PreprocessingRawData) {
 		// meta->portRawBeamlets[port] = (int32_t) ((uint8_t) header[CEP_HDR_NBEAM_OFFSET]);
 		// Varying beamlet limits will change the fraction of data processed, and possibly number of
 		//  ports processed in total
+		// Beamlet 733 is on the 4th port, parsing stops there regardless of the number of ports
 		beamletLimits[0] = 1; beamletLimits[1] = 733;
 		EXPECT_EQ(0, _lofar_udp_parse_header_buffers(meta, headers, beamletLimits));
-		EXPECT_EQ(MAX_NUM_PORTS * UDPMAXBEAM, meta->totalRawBeamlets);
-		FREE_NOT_NULL(meta);
+		EXPECT_EQ(4 * UDPMAXBEAM, meta->totalRawBeamlets);
+		_lofar_udp_obs_meta_cleanup(meta);
 		meta = _lofar_udp_configure_obs_meta(config);
 		ASSERT_NE(nullptr, meta);
 
@@ -316,7 +317,7 @@ TEST(LibReaderTests, PreprocessingRawData) {
 
 		// meta->stationID = *((int16_t *) &(header[CEP_HDR_STN_ID_OFFSET])) / 32;
 		EXPECT_EQ(333, meta->stationID);
-		free(meta);
+		_lofar_udp_obs_meta_cleanup(meta);
 		free(config);
 	}
 
@@ -431,7 +432,7 @@ TEST(LibReaderTests, PreprocessingReader) {
 			}
 		}
 
-		FREE_NOT_NULL(meta);
+		_lofar_udp_obs_meta_cleanup(meta);
 
 
 	}
@@ -926,7 +927,7 @@ TEST_P(LibReaderTestsParam, ProcessingData) {
 
 		int returnv, iters = 0;
 		double timing[2];
-		int8_t *buffers[MAX_OUTPUT_DIMS];
+		int8_t *buffers[INT8_MAX];
 		for (int8_t outp = 0; outp < reader->meta->numOutputs; outp++)
 			buffers[outp] = (int8_t*) calloc(reader->packetsPerIteration * reader->meta->packetOutputLength[outp], sizeof(int8_t));
 
@@ -1033,6 +1034,800 @@ TEST(LibReaderTests, ReaderSupportFuncs) {
 };
 
 
+TEST(LibReaderTests, OutputRedirect) {
+	EXPECT_EQ(-1, lofar_udp_reader_output_redirect(nullptr, 0, nullptr));
+
+	lofar_udp_config *config = config_setup(0, 1, 4, 512);
+	config->processingMode = PACKET_SPLIT_POL;
+	lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+	ASSERT_NE(nullptr, reader);
+	lofar_udp_config *referenceConfig = config_setup(0, 1, 4, 512);
+	referenceConfig->processingMode = PACKET_SPLIT_POL;
+	lofar_udp_reader *referenceReader = lofar_udp_reader_setup(referenceConfig);
+	ASSERT_NE(nullptr, referenceReader);
+
+	EXPECT_EQ(-1, lofar_udp_reader_output_redirect(reader, -1, nullptr));
+	EXPECT_EQ(-1, lofar_udp_reader_output_redirect(reader, reader->meta->numOutputs, nullptr));
+
+	// Alternate between two sets of buffers, as an output cycling through ringbuffer blocks would
+	const int8_t numOutputs = reader->meta->numOutputs;
+	std::vector<int8_t> targets[2][INT8_MAX];
+	int8_t *internalBuffers[INT8_MAX];
+	for (int8_t out = 0; out < numOutputs; out++) {
+		internalBuffers[out] = reader->meta->outputData[out];
+		for (auto &target : targets) {
+			target[out].resize(reader->meta->packetsPerIteration * reader->meta->packetOutputLength[out]);
+		}
+	}
+
+	int32_t stepReturn, referenceReturn;
+	int64_t steps = 0;
+	while (true) {
+		for (int8_t out = 0; out < numOutputs; out++) {
+			ASSERT_EQ(0, lofar_udp_reader_output_redirect(reader, out, targets[steps % 2][out].data()));
+		}
+		stepReturn = lofar_udp_reader_step(reader);
+		referenceReturn = lofar_udp_reader_step(referenceReader);
+		ASSERT_EQ(referenceReturn, stepReturn);
+		if (stepReturn > 0) {
+			break;
+		}
+
+		for (int8_t out = 0; out < numOutputs; out++) {
+			const int64_t outputLength = reader->meta->packetsPerIteration * reader->meta->packetOutputLength[out];
+			EXPECT_EQ(targets[steps % 2][out].data(), reader->meta->outputData[out]);
+			EXPECT_EQ(0, memcmp(referenceReader->meta->outputData[out], targets[steps % 2][out].data(), outputLength));
+		}
+		steps++;
+		if (stepReturn < -1) {
+			break;
+		}
+	}
+	EXPECT_LT(1, steps);
+
+	// Outputs can be returned to the library's buffers, which are the only ones released on cleanup
+	for (int8_t out = 0; out < numOutputs; out++) {
+		EXPECT_EQ(0, lofar_udp_reader_output_redirect(reader, out, nullptr));
+		EXPECT_EQ(internalBuffers[out], reader->meta->outputData[out]);
+		EXPECT_EQ(0, lofar_udp_reader_output_redirect(reader, out, targets[0][out].data()));
+	}
+	lofar_udp_reader_cleanup(reader);
+	lofar_udp_reader_cleanup(referenceReader);
+	lofar_udp_config_cleanup(config);
+	lofar_udp_config_cleanup(referenceConfig);
+}
+
+
+TEST(LibReaderTests, HeaderCensus) {
+	EXPECT_EQ(-1, _lofar_udp_reader_header_census(nullptr));
+
+	lofar_udp_config *config = config_setup(0, 1, 4, 64);
+	config->processingMode = PACKET_NOHDR_COPY;
+	lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+	ASSERT_NE(nullptr, reader);
+	lofar_udp_obs_meta *meta = reader->meta;
+	const int64_t packets = meta->packetsPerIteration;
+
+	{
+		SCOPED_TRACE("CleanGulp");
+		ASSERT_EQ(0, _lofar_udp_reader_header_census(meta));
+		for (int8_t port = 0; port < meta->numPorts; port++) {
+			EXPECT_EQ(packets, meta->gulpSummary[port].packetsChecked);
+			EXPECT_EQ(1, meta->gulpSummary[port].contiguous);
+			EXPECT_EQ(0, meta->gulpSummary[port].malformedPackets);
+			EXPECT_EQ(0, meta->gulpSummary[port].droppedPackets);
+			EXPECT_EQ(0, meta->gulpSummary[port].outOfOrderPackets);
+			EXPECT_EQ(meta->lastPacket + 1, meta->gulpSummary[port].firstPacket);
+			EXPECT_EQ(meta->lastPacket + packets, meta->gulpSummary[port].lastPacket);
+		}
+	}
+
+	{
+		SCOPED_TRACE("CorruptHeaders");
+		const int32_t portPacketLength = meta->portPacketLength[0];
+		const int64_t gulpBytes = packets * portPacketLength;
+
+		// Port 0: a timestamp that still passes validation, but would place the packet (and pad everything after it) in the future
+		*((int32_t *) &(meta->inputData[0][5 * portPacketLength + CEP_HDR_TIME_OFFSET])) += 10;
+		// Port 1: a beamlet count that does not match the port
+		meta->inputData[1][3 * portPacketLength + CEP_HDR_NBEAM_OFFSET] ^= 1;
+		// Port 2: an out of order packet, swapped with its neighbour
+		std::vector<int8_t> swapBuffer(portPacketLength);
+		memcpy(swapBuffer.data(), &(meta->inputData[2][8 * portPacketLength]), UDPHDRLEN);
+		memcpy(&(meta->inputData[2][8 * portPacketLength]), &(meta->inputData[2][9 * portPacketLength]), UDPHDRLEN);
+		memcpy(&(meta->inputData[2][9 * portPacketLength]), swapBuffer.data(), UDPHDRLEN);
+		// Port 3: a reordered pair of packets (5 and 7 exchanged), which looks like a forward jump followed by the next packet
+		memcpy(swapBuffer.data(), &(meta->inputData[3][5 * portPacketLength]), portPacketLength);
+		memcpy(&(meta->inputData[3][5 * portPacketLength]), &(meta->inputData[3][7 * portPacketLength]), portPacketLength);
+		memcpy(&(meta->inputData[3][7 * portPacketLength]), swapBuffer.data(), portPacketLength);
+
+		// Only headers that fail validation are modified by the census, the reordered and suspect packets are left intact
+		std::vector<std::vector<int8_t>> inputCopies;
+		for (int8_t port = 0; port < meta->numPorts; port++) {
+			inputCopies.emplace_back(meta->inputData[port], &(meta->inputData[port][gulpBytes]));
+		}
+		ASSERT_EQ(0, _lofar_udp_reader_header_census(meta));
+		for (int8_t port = 0; port < meta->numPorts; port++) {
+			EXPECT_EQ(port == 1, memcmp(inputCopies[port].data(), meta->inputData[port], gulpBytes) != 0);
+		}
+
+		EXPECT_GE(0, lofar_udp_reader_step(reader));
+
+		EXPECT_EQ(0, meta->gulpSummary[0].contiguous);
+		EXPECT_EQ(0, meta->gulpSummary[0].malformedPackets);
+		EXPECT_EQ(1, meta->gulpSummary[0].suspectPackets);
+		EXPECT_EQ(packets - 6, meta->gulpSummary[0].outOfOrderPackets);
+
+		EXPECT_EQ(0, meta->gulpSummary[1].contiguous);
+		EXPECT_EQ(1, meta->gulpSummary[1].malformedPackets);
+		EXPECT_EQ(0, meta->gulpSummary[1].suspectPackets);
+		EXPECT_EQ(1, meta->gulpSummary[1].droppedPackets);
+		EXPECT_EQ(0, meta->gulpSummary[1].outOfOrderPackets);
+
+		EXPECT_EQ(0, meta->gulpSummary[2].contiguous);
+		EXPECT_EQ(0, meta->gulpSummary[2].malformedPackets);
+		EXPECT_EQ(0, meta->gulpSummary[2].suspectPackets);
+		EXPECT_EQ(1, meta->gulpSummary[2].droppedPackets);
+		EXPECT_EQ(1, meta->gulpSummary[2].outOfOrderPackets);
+
+		EXPECT_EQ(0, meta->gulpSummary[3].contiguous);
+		EXPECT_EQ(0, meta->gulpSummary[3].malformedPackets);
+		EXPECT_EQ(1, meta->gulpSummary[3].suspectPackets);
+		EXPECT_EQ(2, meta->gulpSummary[3].droppedPackets);
+		EXPECT_EQ(2, meta->gulpSummary[3].outOfOrderPackets);
+	}
+
+	lofar_udp_reader_cleanup(reader);
+	lofar_udp_config_cleanup(config);
+}
+
+
+TEST(LibReaderTests, TunePacketsPerIteration) {
+	{
+		SCOPED_TRACE("_lofar_udp_reader_tune_time_candidate");
+		lofar_udp_config *config = config_setup(0, 1, 4, 32);
+		EXPECT_LT(0.0, _lofar_udp_reader_tune_time_candidate(config, 32));
+		EXPECT_EQ(32, config->packetsPerIteration);
+
+		// Not enough packets in the input for the timed steps
+		EXPECT_GT(0.0, _lofar_udp_reader_tune_time_candidate(config, 128));
+		lofar_udp_config_cleanup(config);
+	}
+
+	{
+		SCOPED_TRACE("lofar_udp_reader_tune_packets_per_iteration");
+		EXPECT_GT(0, lofar_udp_reader_tune_packets_per_iteration(nullptr));
+
+		lofar_udp_config *config = config_setup(0, 1, 4, 32);
+		config->readerType = FIFO;
+		EXPECT_GT(0, lofar_udp_reader_tune_packets_per_iteration(config));
+
+		// The test inputs are shorter than the smallest candidate
+		config->readerType = NORMAL;
+		config->packetsReadMax = LONG_MAX;
+		EXPECT_GT(0, lofar_udp_reader_tune_packets_per_iteration(config));
+		EXPECT_EQ(16, config->packetsPerIteration);
+		lofar_udp_config_cleanup(config);
+	}
+}
+
+
+TEST(LibReaderTests, AlternativeFileReaders) {
+	// Memory mapped and io_uring inputs must produce the same output as buffered reads, memory mapped inputs process packets in place
+	for (reader_t readerType : std::vector<reader_t>{ NORMAL_MMAP, URING }) {
+		for (int32_t testNum : std::vector<int32_t>{ 1, 7, 8, 9 }) {
+			for (int32_t replay : std::vector<int32_t>{ 0, 1 }) {
+				for (int64_t packetOffset : std::vector<int64_t>{ -1, 150 }) {
+					SCOPED_TRACE("Reader " + std::to_string(readerType) + ", test case " + std::to_string(testNum) + ", replay " + std::to_string(replay) + ", offset " + std::to_string(packetOffset));
+					lofar_udp_config *config = config_setup(0, testNum, 4, 512);
+					config->processingMode = PACKET_FULL_COPY;
+					config->replayDroppedPackets = replay;
+					if (packetOffset > 0) {
+						int8_t header[UDPHDRLEN];
+						ASSERT_EQ(UDPHDRLEN, lofar_udp_io_read_temp(config, 0, header, 1, UDPHDRLEN, 1));
+						config->startingPacket = lofar_udp_time_get_packet_number(header) + packetOffset;
+					}
+
+					lofar_udp_reader *reference = lofar_udp_reader_setup(config);
+					ASSERT_NE(nullptr, reference);
+					config->readerType = readerType;
+					lofar_udp_reader *alternative = lofar_udp_reader_setup(config);
+					ASSERT_NE(nullptr, alternative);
+					EXPECT_EQ(reference->meta->lastPacket, alternative->meta->lastPacket);
+
+					int32_t referenceReturn, alternativeReturn;
+					do {
+						referenceReturn = lofar_udp_reader_step(reference);
+						alternativeReturn = lofar_udp_reader_step(alternative);
+						ASSERT_EQ(referenceReturn, alternativeReturn);
+						ASSERT_EQ(reference->meta->packetsPerIteration, alternative->meta->packetsPerIteration);
+						for (int8_t port = 0; port < numPorts; port++) {
+							// Packets are processed directly from the mapping
+							if (readerType == NORMAL_MMAP) {
+								EXPECT_LE((void *) alternative->input->inputMap[port], (void *) alternative->meta->inputData[port]);
+								EXPECT_GT((void *) (alternative->input->inputMap[port] + alternative->input->inputMapSize[port]), (void *) alternative->meta->inputData[port]);
+							}
+							EXPECT_EQ(reference->meta->portLastDroppedPackets[port], alternative->meta->portLastDroppedPackets[port]);
+							EXPECT_EQ(0, memcmp(reference->meta->outputData[port], alternative->meta->outputData[port], reference->meta->packetsPerIteration * reference->meta->packetOutputLength[port]));
+						}
+					} while (referenceReturn < 1);
+
+					for (int8_t port = 0; port < numPorts; port++) {
+						EXPECT_EQ(reference->meta->portTotalDroppedPackets[port], alternative->meta->portTotalDroppedPackets[port]);
+					}
+
+					lofar_udp_reader_cleanup(reference);
+					lofar_udp_reader_cleanup(alternative);
+					lofar_udp_config_cleanup(config);
+				}
+			}
+		}
+	}
+
+	{
+		SCOPED_TRACE("lofar_udp_io_read (MMAP)");
+		lofar_udp_config *config = config_setup(0, 1);
+		lofar_udp_io_read_config *input = lofar_udp_io_read_alloc();
+		ASSERT_NE(nullptr, input);
+		const std::string inputLocation = config->inputLocations[0];
+		ASSERT_EQ(0, lofar_udp_io_read_parse_optarg(config, ("MMAP:" + inputLocation).c_str()));
+		EXPECT_EQ(NORMAL_MMAP, config->readerType);
+		input->readerType = NORMAL_MMAP;
+		strncpy(input->inputLocations[0], config->inputLocations[0], DEF_STR_LEN);
+
+		const int64_t readSize = 16 * 7824;
+		std::vector<int8_t> buffer(readSize), referenceBuffer(readSize);
+		int8_t *bufferPtr = buffer.data();
+		ASSERT_EQ(0, lofar_udp_io_read_setup_helper(input, &bufferPtr, readSize, 0));
+		ASSERT_EQ(readSize, lofar_udp_io_read_temp(config, 0, referenceBuffer.data(), 1, readSize, 1));
+
+		// Reads outside of the mapping are copied out
+		EXPECT_EQ(readSize, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+		EXPECT_EQ(0, memcmp(referenceBuffer.data(), bufferPtr, readSize));
+		EXPECT_EQ(readSize, (int64_t) input->readingTracker[0].pos);
+
+		// Reads at the cursor are not
+		int8_t *cursor = (int8_t *) input->readingTracker[0].src + input->readingTracker[0].pos;
+		EXPECT_EQ(readSize, lofar_udp_io_read(input, 0, cursor, readSize));
+		EXPECT_EQ(2 * readSize, (int64_t) input->readingTracker[0].pos);
+
+		// Reads are capped at the end of the file
+		EXPECT_EQ(0, _lofar_udp_io_read_seek_MMAP(input, 0, (int64_t) input->readingTracker[0].size - 10));
+		EXPECT_EQ(10, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+		EXPECT_GT(0, _lofar_udp_io_read_seek_MMAP(input, 0, (int64_t) input->readingTracker[0].size + 1));
+		EXPECT_EQ(0, _lofar_udp_io_read_seek_MMAP(input, 0, 0));
+		EXPECT_EQ(readSize, lofar_udp_io_read(input, 0, bufferPtr, readSize));
+		EXPECT_EQ(0, memcmp(referenceBuffer.data(), bufferPtr, readSize));
+
+		lofar_udp_io_read_cleanup(input);
+		lofar_udp_config_cleanup(config);
+	}
+}
+
+TEST(LibReaderTests, PcapInput) {
+	// Captures holding every port with link/network/transport framing must produce the same output as the raw files
+	const std::string captureLocation = "./pcap_reader_test.pcap";
+	const int64_t packetLength = 7824;
+
+	auto append = [](std::vector<uint8_t> &dest, const void *src, int64_t len) {
+		dest.insert(dest.end(), (const uint8_t *) src, (const uint8_t *) src + len);
+	};
+	auto appendBE16 = [](std::vector<uint8_t> &dest, uint16_t val) {
+		dest.push_back(val >> 8);
+		dest.push_back(val & 0xff);
+	};
+	// Build an IPv4/UDP datagram, optionally behind an Ethernet (VLAN tagged) or Linux cooked capture header
+	auto frame = [&](const int8_t *payload, int64_t len, uint16_t destPort, uint16_t etherType, int32_t linkType) {
+		std::vector<uint8_t> out;
+		if (linkType == 1) {
+			const uint8_t macs[12] = { 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88, 0x99, 0xaa, 0xbb };
+			append(out, macs, 12);
+			appendBE16(out, 0x8100);
+			appendBE16(out, 0x0001);
+		} else {
+			const uint8_t cooked[14] = { 0, 0, 0, 1, 0, 6, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0, 0 };
+			append(out, cooked, 14);
+		}
+		appendBE16(out, etherType);
+		if (etherType != 0x0800) {
+			append(out, payload, 28);
+			return out;
+		}
+		const uint8_t ipv4[12] = { 0x45, 0x00, 0, 0, 0x12, 0x34, 0x40, 0x00, 64, 17, 0, 0 };
+		append(out, ipv4, 12);
+		out[out.size() - 10] = (uint8_t) ((len + 28) >> 8);
+		out[out.size() - 9] = (uint8_t) ((len + 28) & 0xff);
+		const uint8_t addresses[8] = { 10, 0, 0, 1, 10, 0, 0, 2 };
+		append(out, addresses, 8);
+		appendBE16(out, 4346);
+		appendBE16(out, destPort);
+		appendBE16(out, (uint16_t) (len + 8));
+		appendBE16(out, 0);
+		append(out, payload, len);
+		return out;
+	};
+
+	for (int32_t testNum : std::vector<int32_t>{ 1, 7 }) {
+		lofar_udp_config *config = config_setup(0, testNum, 4, 512);
+		std::vector<std::vector<int8_t>> portData(numPorts);
+		int64_t maxPackets = 0;
+		for (int8_t port = 0; port < numPorts; port++) {
+			FILE *inputFile = fopen(config->inputLocations[port], "rb");
+			ASSERT_NE(nullptr, inputFile);
+			portData[port].resize(_FILE_file_size(inputFile));
+			ASSERT_EQ(portData[port].size(), fread(portData[port].data(), sizeof(int8_t), portData[port].size(), inputFile));
+			fclose(inputFile);
+			maxPackets = std::max(maxPackets, (int64_t) portData[port].size() / packetLength);
+		}
+
+		for (int8_t pcapng : std::vector<int8_t>{ 0, 1 }) {
+			SCOPED_TRACE("Test case " + std::to_string(testNum) + ", pcapng " + std::to_string(pcapng));
+			const int32_t linkType = pcapng ? 113 : 1;
+			std::vector<uint8_t> capture;
+			auto record = [&](const std::vector<uint8_t> &data) {
+				const uint32_t capLen = (uint32_t) data.size();
+				if (pcapng) {
+					const uint32_t padded = (capLen + 3) & ~3u;
+					const uint32_t epb[7] = { 6, 32 + padded, 0, 0, 0, capLen, capLen };
+					append(capture, epb, sizeof(epb));
+					append(capture, data.data(), capLen);
+					capture.resize(capture.size() + (padded - capLen), 0);
+					append(capture, &(epb[1]), 4);
+				} else {
+					const uint32_t hdr[4] = { 0, 0, capLen, capLen };
+					append(capture, hdr, sizeof(hdr));
+					append(capture, data.data(), capLen);
+				}
+			};
+
+			if (pcapng) {
+				const uint32_t shb[7] = { 0x0a0d0d0a, 28, 0x1a2b3c4d, 0x00000001, 0xffffffff, 0xffffffff, 28 };
+				append(capture, shb, sizeof(shb));
+				const uint32_t idb[5] = { 1, 20, (uint32_t) linkType, 65535, 20 };
+				append(capture, idb, sizeof(idb));
+			} else {
+				const uint32_t hdr[6] = { 0xa1b2c3d4, 0x00040002, 0, 0, 65535, (uint32_t) linkType };
+				append(capture, hdr, sizeof(hdr));
+			}
+
+			// Interleave the ports, with ARP and unrelated UDP traffic between the packets
+			for (int64_t packet = 0; packet < maxPackets; packet++) {
+				record(frame(portData[0].data(), 64, 9999, 0x0800, linkType));
+				record(frame(portData[0].data(), 28, 0, 0x0806, linkType));
+				for (int8_t port = 0; port < numPorts; port++) {
+					if ((packet + 1) * packetLength <= (int64_t) portData[port].size()) {
+						record(frame(&(portData[port][packet * packetLength]), packetLength, 16130 + port, 0x0800, linkType));
+					}
+				}
+			}
+
+			FILE *captureFile = fopen(captureLocation.c_str(), "wb");
+			ASSERT_NE(nullptr, captureFile);
+			ASSERT_EQ(capture.size(), fwrite(capture.data(), sizeof(uint8_t), capture.size(), captureFile));
+			fclose(captureFile);
+
+			config->readerType = NORMAL;
+			config->processingMode = PACKET_FULL_COPY;
+			lofar_udp_reader *reference = lofar_udp_reader_setup(config);
+			ASSERT_NE(nullptr, reference);
+
+			lofar_udp_config *pcapConfig = config_setup(0, testNum, 4, 512);
+			pcapConfig->processingMode = PACKET_FULL_COPY;
+			ASSERT_EQ(0, lofar_udp_io_read_parse_optarg(pcapConfig, ("PCAP:" + captureLocation + "@[[port]],16130").c_str()));
+			EXPECT_EQ(PCAP, pcapConfig->readerType);
+			EXPECT_STREQ((captureLocation + "@16131").c_str(), pcapConfig->inputLocations[1]);
+			lofar_udp_reader *alternative = lofar_udp_reader_setup(pcapConfig);
+			ASSERT_NE(nullptr, alternative);
+			EXPECT_EQ(reference->meta->lastPacket, alternative->meta->lastPacket);
+
+			int32_t referenceReturn, alternativeReturn;
+			do {
+				referenceReturn = lofar_udp_reader_step(reference);
+				alternativeReturn = lofar_udp_reader_step(alternative);
+				ASSERT_EQ(referenceReturn, alternativeReturn);
+				ASSERT_EQ(reference->meta->packetsPerIteration, alternative->meta->packetsPerIteration);
+				for (int8_t port = 0; port < numPorts; port++) {
+					EXPECT_EQ(reference->meta->portLastDroppedPackets[port], alternative->meta->portLastDroppedPackets[port]);
+					EXPECT_EQ(0, memcmp(reference->meta->outputData[port], alternative->meta->outputData[port], reference->meta->packetsPerIteration * reference->meta->packetOutputLength[port]));
+				}
+			} while (referenceReturn < 1);
+
+			lofar_udp_reader_cleanup(reference);
+			lofar_udp_reader_cleanup(alternative);
+			lofar_udp_config_cleanup(pcapConfig);
+		}
+		lofar_udp_config_cleanup(config);
+	}
+	remove(captureLocation.c_str());
+}
+
+TEST(LibReaderTests, ZstdMultiFrameInput) {
+	// Inputs made of many independent frames are decompressed in parallel, and must match the uncompressed data
+	for (int32_t testNum : std::vector<int32_t>{ 1, 8 }) {
+		SCOPED_TRACE("Test case " + std::to_string(testNum));
+		lofar_udp_config *config = config_setup(0, testNum, 4, 512);
+		config->processingMode = PACKET_FULL_COPY;
+		config->packetsPerIteration = 64;
+
+		lofar_udp_config *multiFrameConfig = config_setup(0, testNum, 4, 512);
+		multiFrameConfig->processingMode = PACKET_FULL_COPY;
+		multiFrameConfig->packetsPerIteration = 64;
+		multiFrameConfig->readerType = ZSTDCOMPRESSED;
+
+		ZSTD_CCtx *cctx = ZSTD_createCCtx();
+		ASSERT_NE(nullptr, cctx);
+		for (int8_t port = 0; port < numPorts; port++) {
+			FILE *inputFile = fopen(config->inputLocations[port], "rb");
+			ASSERT_NE(nullptr, inputFile);
+			const int64_t inputSize = _FILE_file_size(inputFile);
+			std::vector<int8_t> rawData(inputSize), frameBuffer(ZSTD_compressBound(inputSize));
+			ASSERT_EQ(inputSize, (int64_t) fread(rawData.data(), sizeof(int8_t), inputSize, inputFile));
+			fclose(inputFile);
+
+			snprintf(multiFrameConfig->inputLocations[port], DEF_STR_LEN, "./zstd_multiframe_reader_%d.zst", port);
+			FILE *outputFile = fopen(multiFrameConfig->inputLocations[port], "wb");
+			ASSERT_NE(nullptr, outputFile);
+			for (int64_t offset = 0; offset < inputSize; offset += 7824 * 7) {
+				const size_t frameSize = ZSTD_compress2(cctx, frameBuffer.data(), frameBuffer.size(), &(rawData[offset]), std::min(inputSize - offset, (int64_t) 7824 * 7));
+				ASSERT_EQ(0, ZSTD_isError(frameSize));
+				ASSERT_EQ(frameSize, fwrite(frameBuffer.data(), sizeof(int8_t), frameSize, outputFile));
+			}
+			fclose(outputFile);
+		}
+		ZSTD_freeCCtx(cctx);
+
+		lofar_udp_reader *reference = lofar_udp_reader_setup(config);
+		lofar_udp_reader *multiFrame = lofar_udp_reader_setup(multiFrameConfig);
+		ASSERT_NE(nullptr, reference);
+		ASSERT_NE(nullptr, multiFrame);
+
+		int32_t referenceReturn, multiFrameReturn;
+		do {
+			referenceReturn = lofar_udp_reader_step(reference);
+			multiFrameReturn = lofar_udp_reader_step(multiFrame);
+			ASSERT_EQ(referenceReturn, multiFrameReturn);
+			ASSERT_EQ(reference->meta->packetsPerIteration, multiFrame->meta->packetsPerIteration);
+			for (int8_t port = 0; port < numPorts; port++) {
+				EXPECT_EQ(0, memcmp(reference->meta->outputData[port], multiFrame->meta->outputData[port], reference->meta->packetsPerIteration * reference->meta->packetOutputLength[port]));
+			}
+		} while (referenceReturn < 1);
+
+		for (int8_t port = 0; port < numPorts; port++) {
+			EXPECT_NE(nullptr, multiFrame->input->frameDCtx[port][1]);
+			remove(multiFrameConfig->inputLocations[port]);
+		}
+
+		lofar_udp_reader_cleanup(reference);
+		lofar_udp_reader_cleanup(multiFrame);
+		lofar_udp_config_cleanup(config);
+		lofar_udp_config_cleanup(multiFrameConfig);
+	}
+}
+
+TEST(LibReaderTests, CheckpointResume) {
+	// A reader resumed from a checkpoint must produce the same gulps as a reader that was never stopped
+	for (const std::tuple<reader_t, int32_t, int32_t> &testCase : std::vector<std::tuple<reader_t, int32_t, int32_t>>{ { NORMAL, 1, 0 }, { NORMAL, 8, 1 }, { NORMAL_MMAP, 7, 0 }, { ZSTDCOMPRESSED, 2, 0 }, { ZSTDCOMPRESSED, 1, 1 } }) {
+		const reader_t readerType = std::get<0>(testCase);
+		const int32_t testNum = std::get<1>(testCase);
+		SCOPED_TRACE("Reader " + std::to_string(readerType) + ", test case " + std::to_string(testNum) + ", replay " + std::to_string(std::get<2>(testCase)));
+		lofar_udp_config *config = config_setup(0, testNum, 4, 512);
+		config->processingMode = PACKET_FULL_COPY;
+		config->replayDroppedPackets = std::get<2>(testCase);
+		config->packetsPerIteration = 48;
+
+		// Re-compress the raw input as many small frames, so that the checkpoint lands after the first frame
+		if (readerType == ZSTDCOMPRESSED && config->readerType == NORMAL) {
+			ZSTD_CCtx *cctx = ZSTD_createCCtx();
+			ASSERT_NE(nullptr, cctx);
+			for (int8_t port = 0; port < numPorts; port++) {
+				FILE *inputFile = fopen(config->inputLocations[port], "rb");
+				ASSERT_NE(nullptr, inputFile);
+				const int64_t inputSize = _FILE_file_size(inputFile);
+				std::vector<int8_t> rawData(inputSize), frameBuffer(ZSTD_compressBound(inputSize));
+				ASSERT_EQ(inputSize, (int64_t) fread(rawData.data(), sizeof(int8_t), inputSize, inputFile));
+				fclose(inputFile);
+
+				snprintf(config->inputLocations[port], DEF_STR_LEN, "./zstd_checkpoint_reader_%d.zst", port);
+				FILE *outputFile = fopen(config->inputLocations[port], "wb");
+				ASSERT_NE(nullptr, outputFile);
+				for (int64_t offset = 0; offset < inputSize; offset += 7824 * 5) {
+					const size_t frameSize = ZSTD_compress2(cctx, frameBuffer.data(), frameBuffer.size(), &(rawData[offset]), std::min(inputSize - offset, (int64_t) 7824 * 5));
+					ASSERT_EQ(0, ZSTD_isError(frameSize));
+					ASSERT_EQ(frameSize, fwrite(frameBuffer.data(), sizeof(int8_t), frameSize, outputFile));
+				}
+				fclose(outputFile);
+			}
+			ZSTD_freeCCtx(cctx);
+		}
+		config->readerType = readerType;
+
+		lofar_udp_reader *reference = lofar_udp_reader_setup(config);
+		lofar_udp_reader *stopped = lofar_udp_reader_setup(config);
+		ASSERT_NE(nullptr, reference);
+		ASSERT_NE(nullptr, stopped);
+
+		const int32_t stepsBeforeCheckpoint = 3;
+		for (int32_t step = 0; step < stepsBeforeCheckpoint; step++) {
+			ASSERT_GE(0, lofar_udp_reader_step(reference));
+			ASSERT_GE(0, lofar_udp_reader_step(stopped));
+		}
+
+		lofar_udp_checkpoint checkpoint = lofar_udp_checkpoint_default, loaded = lofar_udp_checkpoint_default;
+		ASSERT_EQ(0, lofar_udp_reader_checkpoint(stopped, nullptr, &checkpoint));
+		EXPECT_LE(numPorts, checkpoint.allocatedPorts);
+		EXPECT_EQ(stopped->meta->lastPacket, checkpoint.lastPacket);
+		EXPECT_EQ(stepsBeforeCheckpoint * config->packetsPerIteration, checkpoint.packetsRead);
+		for (int8_t port = 0; port < numPorts; port++) {
+			EXPECT_LT(0, checkpoint.ports[port].byteOffset);
+			if (readerType == ZSTDCOMPRESSED) {
+				EXPECT_LE(checkpoint.ports[port].frameDataOffset, checkpoint.ports[port].byteOffset);
+				if (testNum == 1) {
+					EXPECT_LT(0, checkpoint.ports[port].frameOffset);
+				}
+			} else {
+				EXPECT_EQ(-1, checkpoint.ports[port].frameOffset);
+			}
+		}
+		EXPECT_EQ(-1, checkpoint.outputOffset[0]);
+		ASSERT_EQ(0, lofar_udp_reader_checkpoint_write(stopped, nullptr, "./reader_checkpoint.upmckpt"));
+		ASSERT_EQ(0, lofar_udp_checkpoint_load(&loaded, "./reader_checkpoint.upmckpt"));
+		EXPECT_EQ(0, memcmp(&checkpoint, &loaded, offsetof(lofar_udp_checkpoint, ports)));
+		EXPECT_EQ(0, memcmp(checkpoint.ports, loaded.ports, checkpoint.numPorts * sizeof(lofar_udp_checkpoint_port)));
+		EXPECT_EQ(0, memcmp(checkpoint.outputOffset, loaded.outputOffset, checkpoint.numOutputs * sizeof(int64_t)));
+		lofar_udp_reader_cleanup(stopped);
+
+		config->resumeCheckpoint = &loaded;
+		lofar_udp_reader *resumed = lofar_udp_reader_setup(config);
+		ASSERT_NE(nullptr, resumed);
+		EXPECT_EQ(checkpoint.lastPacket, resumed->meta->lastPacket);
+
+		int32_t referenceReturn, resumedReturn;
+		do {
+			referenceReturn = lofar_udp_reader_step(reference);
+			resumedReturn = lofar_udp_reader_step(resumed);
+			ASSERT_EQ(referenceReturn, resumedReturn);
+			ASSERT_EQ(reference->meta->packetsPerIteration, resumed->meta->packetsPerIteration);
+			ASSERT_EQ(reference->meta->lastPacket, resumed->meta->lastPacket);
+			for (int8_t port = 0; port < numPorts; port++) {
+				EXPECT_EQ(0, memcmp(reference->meta->outputData[port], resumed->meta->outputData[port], reference->meta->packetsPerIteration * reference->meta->packetOutputLength[port]));
+			}
+		} while (referenceReturn < 1);
+
+		// Checkpoints only apply to the reader configuration they were taken from
+		config->processingMode = TIME_MAJOR_FULL;
+		EXPECT_EQ(nullptr, lofar_udp_reader_setup(config));
+
+		for (int8_t port = 0; port < numPorts; port++) {
+			EXPECT_EQ(reference->meta->portTotalDroppedPackets[port], resumed->meta->portTotalDroppedPackets[port]);
+			if (strstr(config->inputLocations[port], "zstd_checkpoint_reader")) {
+				remove(config->inputLocations[port]);
+			}
+		}
+
+		lofar_udp_reader_cleanup(reference);
+		lofar_udp_reader_cleanup(resumed);
+		lofar_udp_config_cleanup(config);
+		lofar_udp_checkpoint_free_arrays(&checkpoint);
+		lofar_udp_checkpoint_free_arrays(&loaded);
+		remove("./reader_checkpoint.upmckpt");
+	}
+
+	{
+		SCOPED_TRACE("Writer resume");
+		lofar_udp_config *config = config_setup(0, 1, 4, 512);
+		config->processingMode = PACKET_FULL_COPY;
+		lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+		ASSERT_NE(nullptr, reader);
+
+		lofar_udp_io_write_config *outConfig = lofar_udp_io_write_alloc();
+		ASSERT_NE(nullptr, outConfig);
+		outConfig->readerType = NORMAL;
+		strncpy(outConfig->outputFormat, "./checkpoint_output_[[idx]]_[[pack]].raw", DEF_STR_LEN);
+		outConfig->numOutputs = reader->meta->numOutputs;
+		ASSERT_EQ(0, _lofar_udp_io_write_internal_lib_setup_helper(outConfig, reader, 0));
+		const int64_t firstPacket = outConfig->firstPacket;
+		const std::string outputLocation = outConfig->outputLocations[0];
+
+		const std::vector<int8_t> before(1000, 1), after(500, 2), replaced(700, 3);
+		ASSERT_EQ((int64_t) before.size(), lofar_udp_io_write(outConfig, 0, before.data(), (int64_t) before.size()));
+		lofar_udp_checkpoint checkpoint = lofar_udp_checkpoint_default;
+		ASSERT_EQ(0, lofar_udp_reader_checkpoint(reader, outConfig, &checkpoint));
+		EXPECT_EQ((int64_t) before.size(), checkpoint.outputOffset[0]);
+		EXPECT_EQ(firstPacket, checkpoint.outputFirstPacket);
+		ASSERT_EQ((int64_t) after.size(), lofar_udp_io_write(outConfig, 0, after.data(), (int64_t) after.size()));
+		lofar_udp_io_write_cleanup(outConfig, 1);
+
+		// Data written after the checkpoint is dropped, and the original name is kept even if the writer's first packet changes
+		outConfig = lofar_udp_io_write_alloc();
+		ASSERT_NE(nullptr, outConfig);
+		outConfig->readerType = NORMAL;
+		strncpy(outConfig->outputFormat, "./checkpoint_output_[[idx]]_[[pack]].raw", DEF_STR_LEN);
+		outConfig->numOutputs = reader->meta->numOutputs;
+		outConfig->resumeCheckpoint = &checkpoint;
+		ASSERT_EQ(0, lofar_udp_reader_step(reader));
+		ASSERT_EQ(0, _lofar_udp_io_write_internal_lib_setup_helper(outConfig, reader, 0));
+		EXPECT_EQ(outputLocation, std::string(outConfig->outputLocations[0]));
+		ASSERT_EQ((int64_t) replaced.size(), lofar_udp_io_write(outConfig, 0, replaced.data(), (int64_t) replaced.size()));
+		lofar_udp_io_write_cleanup(outConfig, 1);
+
+		FILE *outputFile = fopen(outputLocation.c_str(), "rb");
+		ASSERT_NE(nullptr, outputFile);
+		std::vector<int8_t> expected(before), written(before.size() + replaced.size() + 1);
+		expected.insert(expected.end(), replaced.begin(), replaced.end());
+		ASSERT_EQ(expected.size(), fread(written.data(), sizeof(int8_t), written.size(), outputFile));
+		fclose(outputFile);
+		EXPECT_EQ(0, memcmp(expected.data(), written.data(), expected.size()));
+
+		// Only plain files can be resumed
+		outConfig = lofar_udp_io_write_alloc();
+		ASSERT_NE(nullptr, outConfig);
+		outConfig->readerType = ZSTDCOMPRESSED;
+		strncpy(outConfig->outputFormat, "./checkpoint_output_[[idx]]_[[pack]].zst", DEF_STR_LEN);
+		outConfig->resumeCheckpoint = &checkpoint;
+		outConfig->numOutputs = reader->meta->numOutputs;
+		EXPECT_GT(0, _lofar_udp_io_write_internal_lib_setup_helper(outConfig, reader, 0));
+		lofar_udp_io_write_cleanup(outConfig, 1);
+
+		for (int8_t outp = 0; outp < reader->meta->numOutputs; outp++) {
+			char location[DEF_STR_LEN];
+			ASSERT_EQ(0, lofar_udp_io_parse_format(location, "./checkpoint_output_[[idx]]_[[pack]].raw", -1, 0, outp, firstPacket));
+			remove(location);
+		}
+		lofar_udp_reader_cleanup(reader);
+		lofar_udp_config_cleanup(config);
+		lofar_udp_checkpoint_free_arrays(&checkpoint);
+	}
+
+	{
+		SCOPED_TRACE("lofar_udp_checkpoint_load");
+		lofar_udp_checkpoint checkpoint = lofar_udp_checkpoint_default;
+		EXPECT_GT(0, lofar_udp_checkpoint_load(&checkpoint, "./missing_checkpoint.upmckpt"));
+		EXPECT_GT(0, lofar_udp_checkpoint_load(nullptr, "./missing_checkpoint.upmckpt"));
+		EXPECT_GT(0, lofar_udp_checkpoint_write(nullptr, "./missing_checkpoint.upmckpt"));
+
+		FILE *invalid = fopen("./invalid_checkpoint.upmckpt", "wb");
+		ASSERT_NE(nullptr, invalid);
+		fprintf(invalid, "Not a checkpoint");
+		fclose(invalid);
+		EXPECT_GT(0, lofar_udp_checkpoint_load(&checkpoint, "./invalid_checkpoint.upmckpt"));
+		remove("./invalid_checkpoint.upmckpt");
+		lofar_udp_checkpoint_free_arrays(&checkpoint);
+	}
+}
+
+// Collected output for each event in LibReaderTests.BatchEvents
+struct batch_event_output {
+	std::vector<std::vector<int8_t>> data[INT8_MAX];
+	std::vector<int64_t> firstPacket, slices, lastSlices;
+};
+
+TEST(LibReaderTests, BatchEvents) {
+	{
+		SCOPED_TRACE("_lofar_udp_reader_events_schedule");
+		const std::vector<lofar_udp_event> events{ { 100, 10 }, { 105, 10 }, { 200, 5 }, { 115, 1 }, { 50, 5 } };
+		std::vector<int64_t> order(events.size()), spanFirstEvent(events.size() + 1);
+		std::vector<lofar_udp_event> spans(events.size());
+		ASSERT_EQ(3, _lofar_udp_reader_events_schedule(events.data(), (int64_t) events.size(), order.data(), spans.data(), spanFirstEvent.data()));
+		EXPECT_EQ((std::vector<int64_t>{ 4, 0, 1, 3, 2 }), order);
+		EXPECT_EQ(50, spans[0].startingPacket);
+		EXPECT_EQ(5, spans[0].packetsReadMax);
+		EXPECT_EQ(100, spans[1].startingPacket);
+		EXPECT_EQ(16, spans[1].packetsReadMax);
+		EXPECT_EQ(200, spans[2].startingPacket);
+		EXPECT_EQ(5, spans[2].packetsReadMax);
+		EXPECT_EQ((std::vector<int64_t>{ 0, 1, 4, 5, 0, 0 }), spanFirstEvent);
+
+		const std::vector<lofar_udp_event> badEvents{ { 100, 10 }, { 105, 0 } };
+		EXPECT_EQ(-1, _lofar_udp_reader_events_schedule(badEvents.data(), (int64_t) badEvents.size(), order.data(), spans.data(), spanFirstEvent.data()));
+		EXPECT_EQ(-1, _lofar_udp_reader_events_schedule(nullptr, 1, order.data(), spans.data(), spanFirstEvent.data()));
+	}
+
+	for (int32_t testNum : std::vector<int32_t>{ 1, 7, 8 }) {
+		SCOPED_TRACE("lofar_udp_reader_events_process, test case " + std::to_string(testNum));
+		lofar_udp_config *config = config_setup(0, testNum, 4, 512);
+		config->processingMode = PACKET_FULL_COPY;
+		config->packetsReadMax = LONG_MAX;
+		int8_t header[UDPHDRLEN];
+		ASSERT_EQ(UDPHDRLEN, lofar_udp_io_read_temp(config, 0, header, 1, UDPHDRLEN, 1));
+		const int64_t firstPacket = lofar_udp_time_get_packet_number(header);
+
+		// Overlapping events, events closer than a gulp, an event before the input and an event running past the end of it
+		const std::vector<lofar_udp_event> events{
+			{ firstPacket + 25, 30 }, { firstPacket + 20, 10 }, { firstPacket + 60, 3 }, { firstPacket + 64, 40 },
+			{ firstPacket + 200, 100 }, { firstPacket - 50, 10 }, { firstPacket + 130, 1 }
+		};
+		const int64_t numEvents = (int64_t) events.size();
+
+		lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+		ASSERT_NE(nullptr, reader);
+		batch_event_output output;
+		for (int8_t port = 0; port < numPorts; port++) {
+			output.data[port].resize(numEvents);
+		}
+		output.firstPacket.resize(numEvents, -1);
+		output.slices.resize(numEvents, 0);
+		output.lastSlices.resize(numEvents, 0);
+
+		EXPECT_EQ(-1, lofar_udp_reader_events_process(nullptr, events.data(), numEvents, nullptr, nullptr));
+		dataOrder_t tmpOrder;
+		MODIFY_AND_RESET(reader->meta->dataOrder, tmpOrder, TIME_MAJOR, EXPECT_EQ(-1, lofar_udp_reader_events_process(reader, events.data(), numEvents, [](lofar_udp_reader *, const lofar_udp_event_slice *, void *) -> int32_t { return 0; }, nullptr)););
+		const int64_t processed = lofar_udp_reader_events_process(reader, events.data(), numEvents, [](lofar_udp_reader *eventReader, const lofar_udp_event_slice *slice, void *userData) -> int32_t {
+			batch_event_output *eventOutput = (batch_event_output *) userData;
+			if (slice->firstSlice) {
+				eventOutput->firstPacket[slice->eventIdx] = slice->packetNumber;
+			}
+			eventOutput->slices[slice->eventIdx]++;
+			eventOutput->lastSlices[slice->eventIdx] += slice->lastSlice;
+			for (int8_t port = 0; port < eventReader->meta->numOutputs; port++) {
+				const int8_t *sliceData = &(eventReader->meta->outputData[port][slice->outputPacketOffset * eventReader->meta->packetOutputLength[port]]);
+				eventOutput->data[port][slice->eventIdx].insert(eventOutput->data[port][slice->eventIdx].end(), sliceData, sliceData + slice->numPackets * eventReader->meta->packetOutputLength[port]);
+			}
+			return 0;
+		}, &output);
+		// The final event is interrupted by the end of the input, the event before the input is skipped
+		EXPECT_EQ(numEvents - 2, processed);
+		EXPECT_EQ(0, output.slices[5]);
+		lofar_udp_reader_cleanup(reader);
+
+		// Each event must match the same packets from a reader stepping through the full input, including any padding for packet loss
+		lofar_udp_config *streamConfig = config_setup(0, testNum, 4, 512);
+		streamConfig->processingMode = PACKET_FULL_COPY;
+		streamConfig->startingPacket = firstPacket;
+		streamConfig->packetsReadMax = LONG_MAX;
+		lofar_udp_reader *streamReader = lofar_udp_reader_setup(streamConfig);
+		ASSERT_NE(nullptr, streamReader);
+		std::vector<int8_t> reference[INT8_MAX];
+		int32_t stepReturn;
+		while ((stepReturn = lofar_udp_reader_step(streamReader)) < 1) {
+			for (int8_t port = 0; port < streamReader->meta->numOutputs; port++) {
+				reference[port].insert(reference[port].end(), streamReader->meta->outputData[port], streamReader->meta->outputData[port] + streamReader->meta->packetsPerIteration * streamReader->meta->packetOutputLength[port]);
+			}
+			if (stepReturn < -1) {
+				break;
+			}
+		}
+
+		for (int64_t event = 0; event < numEvents; event++) {
+			SCOPED_TRACE("Event " + std::to_string(event));
+			if (event == 5) {
+				continue;
+			}
+			EXPECT_EQ(events[event].startingPacket, output.firstPacket[event]);
+			EXPECT_EQ(1, output.lastSlices[event]);
+
+			for (int8_t port = 0; port < streamReader->meta->numOutputs; port++) {
+				const size_t packetLength = streamReader->meta->packetOutputLength[port];
+				const size_t eventOffset = (events[event].startingPacket - firstPacket) * packetLength;
+				const size_t eventLength = events[event].packetsReadMax * packetLength;
+				ASSERT_LT(eventOffset, reference[port].size());
+				if (event == 4) {
+					// Interrupted by the end of the input
+					EXPECT_EQ(reference[port].size() - eventOffset, output.data[port][event].size());
+					EXPECT_LT(output.data[port][event].size(), eventLength);
+				} else {
+					ASSERT_EQ(eventLength, output.data[port][event].size());
+					ASSERT_LE(eventOffset + eventLength, reference[port].size());
+				}
+				// Packet loss handling depends on gulp alignment, so only compare packets that are present in both outputs
+				for (size_t packet = 0; packet < output.data[port][event].size() / packetLength; packet++) {
+					const int64_t expectedPacket = events[event].startingPacket + (int64_t) packet;
+					const int64_t eventPacket = lofar_udp_time_get_packet_number(&(output.data[port][event][packet * packetLength]));
+					const int64_t referencePacket = lofar_udp_time_get_packet_number(&(reference[port][eventOffset + packet * packetLength]));
+					if (eventPacket == expectedPacket && referencePacket == expectedPacket) {
+						ASSERT_EQ(0, memcmp(&(reference[port][eventOffset + packet * packetLength]), &(output.data[port][event][packet * packetLength]), packetLength));
+					} else if (testNum == 1) {
+						FAIL() << "Packet " << expectedPacket << " was not found in the output for a lossless input.";
+					}
+				}
+			}
+		}
+
+		lofar_udp_reader_cleanup(streamReader);
+		lofar_udp_config_cleanup(streamConfig);
+		lofar_udp_config_cleanup(config);
+	}
+}
+
 TEST(LibReaderTests, ProcessingModes) {
 	{
 		SCOPED_TRACE("4bit_LUT_validation");
@@ -0,0 +1,538 @@
+#include "gtest/gtest.h"
+#include "lofar_udp_reader.h"
+#include "lofar_udp_metadata.h"
+#include "lofar_udp_shard.h"
+#include "lib_reference_files.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <string>
+#include <tuple>
+#include <vector>
+
+static std::vector<int8_t> shard_test_read_file(const std::string &location) {
+	std::ifstream file(location, std::ios::binary);
+	return std::vector<int8_t>((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+}
+
+static void shard_test_write_file(const std::string &location, const std::vector<int8_t> &header, const std::vector<int8_t> &data) {
+	FILE *file = fopen(location.c_str(), "wb");
+	ASSERT_NE(nullptr, file);
+	if (!header.empty()) {
+		ASSERT_EQ(header.size(), fwrite(header.data(), sizeof(int8_t), header.size(), file));
+	}
+	ASSERT_EQ(data.size(), fwrite(data.data(), sizeof(int8_t), data.size(), file));
+	fclose(file);
+}
+
+static std::vector<int8_t> shard_test_data(int64_t length, int8_t seed) {
+	std::vector<int8_t> data(length);
+	for (int64_t idx = 0; idx < length; idx++) {
+		data[idx] = (int8_t) (seed + idx);
+	}
+	return data;
+}
+
+static lofar_udp_shard shard_test_synthetic(int32_t shardIdx, int32_t numShards, metadata_t metadataType, int64_t firstPacket, int64_t packets, int64_t packetOutputLength) {
+	lofar_udp_shard shard = lofar_udp_shard_default;
+	EXPECT_EQ(0, lofar_udp_shard_alloc_outputs(&shard, 1));
+	shard.version = UPM_SHARD_VERSION;
+	shard.shard = shardIdx;
+	shard.numShards = numShards;
+	shard.numPorts = 2;
+	shard.numOutputs = 1;
+	shard.metadataType = metadataType;
+	shard.firstPacket = firstPacket;
+	shard.packetsWritten = packets;
+	shard.outputBytes[0] = packets * packetOutputLength;
+	shard.packetOutputLength[0] = packetOutputLength;
+	snprintf(shard.outputLocations[0], DEF_STR_LEN, "./shard_test_synthetic.part%d", shardIdx);
+	return shard;
+}
+
+// Stitch a set of shards to a single output, returning the stitcher's return value
+static int64_t shard_test_stitch(lofar_udp_shard shards[], int32_t numShards, const char outputFormat[]) {
+	lofar_udp_io_write_config *outConfig = lofar_udp_io_write_alloc();
+	EXPECT_NE(nullptr, outConfig);
+	EXPECT_EQ(0, lofar_udp_io_write_parse_optarg(outConfig, outputFormat));
+	outConfig->progressWithExisting = 1;
+	const int64_t returnVal = lofar_udp_shard_stitch(shards, numShards, outConfig);
+	lofar_udp_io_write_cleanup(outConfig, 1);
+	return returnVal;
+}
+
+static double shard_test_guppi_value(const int8_t *header, const char key[]) {
+	for (int64_t offset = 0; strncmp((const char *) &(header[offset]), "END ", 4) != 0; offset += 80) {
+		if (strncmp((const char *) &(header[offset]), key, strlen(key)) == 0) {
+			return std::stod(std::string((const char *) &(header[offset + 10]), 70));
+		}
+	}
+	return -1.0;
+}
+
+static int64_t shard_test_guppi_length(const int8_t *header) {
+	int64_t offset = 0;
+	while (strncmp((const char *) &(header[offset]), "END ", 4) != 0) {
+		offset += 80;
+	}
+	return offset + 80;
+}
+
+TEST(LibShardTests, RangeAndManifest) {
+	{
+		SCOPED_TRACE("lofar_udp_shard_range");
+		int64_t shardStart, shardPackets;
+		EXPECT_EQ(-1, lofar_udp_shard_range(1000, 1000, 64, 0, 3, nullptr, &shardPackets));
+		EXPECT_EQ(-1, lofar_udp_shard_range(1000, 1000, 64, 0, 3, &shardStart, nullptr));
+		EXPECT_EQ(-2, lofar_udp_shard_range(-1, 1000, 64, 0, 3, &shardStart, &shardPackets));
+		EXPECT_EQ(-2, lofar_udp_shard_range(1000, LONG_MAX, 64, 0, 3, &shardStart, &shardPackets));
+		EXPECT_EQ(-2, lofar_udp_shard_range(1000, 1000, 0, 0, 3, &shardStart, &shardPackets));
+		EXPECT_EQ(-2, lofar_udp_shard_range(1000, 1000, 64, 3, 3, &shardStart, &shardPackets));
+		EXPECT_EQ(-2, lofar_udp_shard_range(1000, 1000, 64, -1, 3, &shardStart, &shardPackets));
+
+		// Shards are rounded up to a whole number of iterations, the last shard takes the remainder
+		const std::vector<std::pair<int64_t, int64_t>> expected { { 1000, 384 }, { 1384, 384 }, { 1768, 232 } };
+		int64_t totalPackets = 0;
+		for (int32_t shard = 0; shard < 3; shard++) {
+			ASSERT_EQ(0, lofar_udp_shard_range(1000, 1000, 64, shard, 3, &shardStart, &shardPackets));
+			EXPECT_EQ(expected[shard].first, shardStart);
+			EXPECT_EQ(expected[shard].second, shardPackets);
+			totalPackets += shardPackets;
+		}
+		EXPECT_EQ(1000, totalPackets);
+
+		// Too many shards for the requested range
+		EXPECT_EQ(-3, lofar_udp_shard_range(1000, 100, 64, 2, 3, &shardStart, &shardPackets));
+		EXPECT_EQ(0, lofar_udp_shard_range(1000, 100, 64, 1, 3, &shardStart, &shardPackets));
+		EXPECT_EQ(1064, shardStart);
+		EXPECT_EQ(36, shardPackets);
+	}
+
+	{
+		SCOPED_TRACE("lofar_udp_shard_output_format");
+		lofar_udp_io_write_config *outConfig = lofar_udp_io_write_alloc();
+		ASSERT_NE(nullptr, outConfig);
+		EXPECT_EQ(-1, lofar_udp_shard_output_format(nullptr, 0));
+		EXPECT_EQ(-1, lofar_udp_shard_output_format(outConfig, -1));
+
+		ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(outConfig, "./shard_test_[[idx]]"));
+		EXPECT_EQ(0, lofar_udp_shard_output_format(outConfig, 12));
+		EXPECT_STREQ("./shard_test_[[idx]].part12", outConfig->outputFormat);
+
+		memset(outConfig->outputFormat, 'a', DEF_STR_LEN - 2);
+		outConfig->outputFormat[DEF_STR_LEN - 2] = '\0';
+		EXPECT_EQ(-2, lofar_udp_shard_output_format(outConfig, 0));
+		FREE_NOT_NULL(outConfig);
+	}
+
+	{
+		SCOPED_TRACE("lofar_udp_shard_write_load");
+		char shardLocation[DEF_STR_LEN];
+		EXPECT_EQ(-1, lofar_udp_shard_get_location(nullptr, "test"));
+		ASSERT_EQ(0, lofar_udp_shard_get_location(shardLocation, "./shard_test_file"));
+		EXPECT_STREQ("./shard_test_file" UPM_SHARD_SUFFIX, shardLocation);
+
+		lofar_udp_shard shard = shard_test_synthetic(1, 3, GUPPI, 12345, 678, 7808);
+		shard.droppedPackets = 9;
+		EXPECT_EQ(-1, lofar_udp_shard_write(nullptr, shardLocation));
+		ASSERT_EQ(0, lofar_udp_shard_write(&shard, shardLocation));
+
+		lofar_udp_shard loaded = lofar_udp_shard_default;
+		EXPECT_EQ(-1, lofar_udp_shard_load(nullptr, shardLocation));
+		ASSERT_EQ(0, lofar_udp_shard_load(&loaded, shardLocation));
+		EXPECT_EQ(0, memcmp(&shard, &loaded, offsetof(lofar_udp_shard, outputBytes)));
+		EXPECT_EQ(loaded.outputBytes[0], shard.outputBytes[0]);
+		EXPECT_EQ(loaded.packetOutputLength[0], shard.packetOutputLength[0]);
+		EXPECT_STREQ(loaded.outputLocations[0], shard.outputLocations[0]);
+
+		// Manifests for an invalid shard index must be rejected
+		shard.shard = 3;
+		ASSERT_EQ(0, lofar_udp_shard_write(&shard, shardLocation));
+		EXPECT_EQ(-1, lofar_udp_shard_load(&loaded, shardLocation));
+
+		// Truncated manifests must be rejected
+		FILE *shardFile = fopen(shardLocation, "r+b");
+		ASSERT_NE(nullptr, shardFile);
+		ASSERT_EQ(0, ftruncate(fileno(shardFile), 24));
+		fclose(shardFile);
+		EXPECT_EQ(-1, lofar_udp_shard_load(&loaded, shardLocation));
+		EXPECT_EQ(-1, lofar_udp_shard_load(&loaded, "./this_file_does_not_exist"));
+		std::remove(shardLocation);
+		lofar_udp_shard_free_outputs(&shard);
+		lofar_udp_shard_free_outputs(&loaded);
+	}
+}
+
+TEST(LibShardTests, StitchReaderShards) {
+	const int32_t testNumber = 1;
+	const int32_t numShards = 3;
+	const int64_t packets = 100;
+	const int64_t gapPackets = 5;
+
+	std::string inputPattern = inputLocations[testNumber];
+	int8_t replayDroppedPackets = 0;
+	auto shardReader = [&](int64_t startingPacket, int64_t packetsReadMax, int64_t endPacket) -> lofar_udp_reader* {
+		lofar_udp_config *config = lofar_udp_config_alloc();
+		EXPECT_NE(nullptr, config);
+		for (int32_t port = 0; port < numPorts; port++) {
+			strncpy(config->inputLocations[port], std::regex_replace(inputPattern, std::regex("portnum"), std::to_string(port)).c_str(), DEF_STR_LEN);
+		}
+		config->readerType = NORMAL;
+		config->numPorts = numPorts;
+		// As in the extractor, short ranges lower the iteration size
+		config->packetsPerIteration = packetsReadMax < 16 ? packetsReadMax : 16;
+		config->packetsReadMax = packetsReadMax;
+		config->endPacket = endPacket;
+		config->replayDroppedPackets = replayDroppedPackets;
+		config->processingMode = PACKET_SPLIT_POL;
+		config->startingPacket = startingPacket;
+		lofar_udp_reader *reader = lofar_udp_reader_setup(config);
+		FREE_NOT_NULL(config);
+		return reader;
+	};
+
+	// Process a range of packets, writing every iteration to disk as the extractor does
+	auto processRange = [&](lofar_udp_reader *reader, const char outputFormat[], lofar_udp_shard *shard, int32_t shardIdx) {
+		lofar_udp_io_write_config *outConfig = lofar_udp_io_write_alloc();
+		ASSERT_NE(nullptr, outConfig);
+		ASSERT_EQ(0, lofar_udp_io_write_parse_optarg(outConfig, outputFormat));
+		outConfig->progressWithExisting = 1;
+		if (shard != nullptr) {
+			ASSERT_EQ(0, lofar_udp_shard_output_format(outConfig, shardIdx));
+		}
+		ASSERT_EQ(0, _lofar_udp_io_write_internal_lib_setup_helper(outConfig, reader, 0));
+		if (shard != nullptr) {
+			ASSERT_EQ(0, lofar_udp_shard_setup(shard, reader, outConfig, shardIdx, numShards));
+		}
+
+		int64_t packetsWritten = 0;
+		while (lofar_udp_reader_step(reader) < 1) {
+			for (int8_t out = 0; out < reader->meta->numOutputs; out++) {
+				const int64_t outputLength = reader->meta->packetsPerIteration * reader->meta->packetOutputLength[out];
+				ASSERT_EQ(outputLength, lofar_udp_io_write(outConfig, out, reader->meta->outputData[out], outputLength));
+				if (shard != nullptr) {
+					shard->outputBytes[out] += outputLength;
+				}
+			}
+			packetsWritten += reader->meta->packetsPerIteration;
+		}
+
+		if (shard != nullptr) {
+			shard->packetsWritten = packetsWritten;
+			for (int8_t port = 0; port < reader->meta->numPorts; port++) {
+				shard->droppedPackets += reader->meta->portTotalDroppedPackets[port];
+			}
+		}
+		lofar_udp_io_write_cleanup(outConfig, 1);
+	};
+
+	lofar_udp_reader *reader = shardReader(-1, 64, -1);
+	ASSERT_NE(nullptr, reader);
+	const int64_t startingPacket = reader->meta->lastPacket + 1 + 10;
+	std::vector<int64_t> portPacketLength(reader->meta->portPacketLength, reader->meta->portPacketLength + numPorts);
+	lofar_udp_reader_cleanup(reader);
+
+	// Remove the first packets of the second shard from a copy of the input, so that its reader starts late
+	int64_t gapStart, shardPackets;
+	ASSERT_EQ(0, lofar_udp_shard_range(startingPacket, packets, 16, 1, numShards, &gapStart, &shardPackets));
+	const std::string gapPattern = "./shard_test_gap_input_portnum";
+	for (int32_t port = 0; port < numPorts; port++) {
+		const std::vector<int8_t> input = shard_test_read_file(std::regex_replace(inputLocations[testNumber], std::regex("portnum"), std::to_string(port)));
+		ASSERT_EQ(0, (int64_t) input.size() % portPacketLength[port]);
+		std::vector<int8_t> gapInput;
+		for (int64_t offset = 0; offset < (int64_t) input.size(); offset += portPacketLength[port]) {
+			const int64_t packet = lofar_udp_time_get_packet_number(&(input[offset]));
+			if (packet < gapStart || packet >= gapStart + gapPackets) {
+				gapInput.insert(gapInput.end(), input.begin() + offset, input.begin() + offset + portPacketLength[port]);
+			}
+		}
+		ASSERT_EQ(input.size() - gapPackets * portPacketLength[port], gapInput.size());
+		shard_test_write_file(std::regex_replace(gapPattern, std::regex("portnum"), std::to_string(port)), {}, gapInput);
+	}
+
+	// Packets lost at the start of a shard must be padded by the stitch exactly as an unsharded reader pads them
+	const std::vector<std::tuple<std::string, int8_t, int64_t>> cases { { inputLocations[testNumber], 0, 0 }, { gapPattern, 0, gapPackets }, { gapPattern, 1, gapPackets } };
+	for (const auto &testCase : cases) {
+		inputPattern = std::get<0>(testCase);
+		replayDroppedPackets = std::get<1>(testCase);
+		const int64_t gap = std::get<2>(testCase);
+		SCOPED_TRACE("Gap " + std::to_string(gap) + ", replay " + std::to_string(replayDroppedPackets));
+
+		// Reference: a single, unsharded pass over the range
+		reader = shardReader(startingPacket, packets, -1);
+		ASSERT_NE(nullptr, reader);
+		const int8_t numOutputs = reader->meta->numOutputs;
+		processRange(reader, "./shard_test_reference_[[idx]]", nullptr, 0);
+		lofar_udp_reader_cleanup(reader);
+
+		std::vector<lofar_udp_shard> shards(numShards, lofar_udp_shard_default);
+		for (int32_t shard = numShards - 1; shard >= 0; shard--) {
+			SCOPED_TRACE("Shard " + std::to_string(shard));
+			int64_t shardStart;
+			ASSERT_EQ(0, lofar_udp_shard_range(startingPacket, packets, 16, shard, numShards, &shardStart, &shardPackets));
+			reader = shardReader(shardStart, shardPackets, shardStart + shardPackets);
+			ASSERT_NE(nullptr, reader);
+			processRange(reader, "./shard_test_[[idx]]", &(shards[shard]), shard);
+			lofar_udp_reader_cleanup(reader);
+
+			// The late start must not push the shard into the range of the next shard
+			const int64_t shardGap = shard == 1 ? gap : 0;
+			EXPECT_EQ(shardStart + shardGap, shards[shard].firstPacket);
+			EXPECT_EQ(shardPackets - shardGap, shards[shard].packetsWritten);
+			EXPECT_EQ(NO_META, shards[shard].metadataType);
+			EXPECT_EQ(replayDroppedPackets, shards[shard].replayDroppedPackets);
+
+			// Round trip the manifests, as the stitch CLI would
+			char shardLocation[DEF_STR_LEN];
+			ASSERT_EQ(0, lofar_udp_shard_get_location(shardLocation, shards[shard].outputLocations[0]));
+			ASSERT_EQ(0, lofar_udp_shard_write(&(shards[shard]), shardLocation));
+			ASSERT_EQ(0, lofar_udp_shard_load(&(shards[shard]), shardLocation));
+			std::remove(shardLocation);
+		}
+
+		// Shards are sorted before stitching, the order on the command line does not matter
+		std::swap(shards[0], shards[2]);
+		EXPECT_LE(gap * numPorts, shard_test_stitch(shards.data(), numShards, "./shard_test_stitched_[[idx]]"));
+
+		for (int8_t out = 0; out < numOutputs; out++) {
+			SCOPED_TRACE("Output " + std::to_string(out));
+			const std::string idx = std::to_string(out);
+			const std::vector<int8_t> reference = shard_test_read_file("./shard_test_reference_" + idx);
+			const std::vector<int8_t> stitched = shard_test_read_file("./shard_test_stitched_" + idx);
+			EXPECT_EQ(packets * shards[0].packetOutputLength[out], (int64_t) reference.size());
+			EXPECT_TRUE(reference == stitched);
+
+			std::remove(("./shard_test_reference_" + idx).c_str());
+			std::remove(("./shard_test_stitched_" + idx).c_str());
+			for (int32_t shard = 0; shard < numShards; shard++) {
+				std::remove(shards[shard].outputLocations[out]);
+			}
+		}
+		for (auto &shard : shards) {
+			lofar_udp_shard_free_outputs(&shard);
+		}
+	}
+
+	for (int32_t port = 0; port < numPorts; port++) {
+		std::remove(std::regex_replace(gapPattern, std::regex("portnum"), std::to_string(port)).c_str());
+	}
+}
+
+TEST(LibShardTests, StitchMetadata) {
+	// 2 shards of 8 packets, 4 packets per block, 16 bytes per packet, optionally with a block of packets lost between them
+	const int64_t guppiPacketLength = 16, blockPackets = 4;
+	for (const int64_t gap : { (int64_t) 0, blockPackets }) {
+		SCOPED_TRACE("GUPPI, gap " + std::to_string(gap));
+		const int64_t packetLength = guppiPacketLength;
+		lofar_udp_shard shards[2] = { shard_test_synthetic(0, 2, GUPPI, 1000, 8, packetLength),
+		                              shard_test_synthetic(1, 2, GUPPI, 1008 + gap, 8, packetLength) };
+		guppi_hdr *hdr = guppi_hdr_alloc();
+		ASSERT_NE(nullptr, hdr);
+		std::vector<int8_t> headerBuffer(DEF_HDR_LEN);
+		std::vector<int8_t> expectedData;
+
+		for (int32_t shard = 0; shard < 2; shard++) {
+			std::vector<int8_t> partFile;
+			hdr->stt_imjd = 60000 + shard;
+			hdr->stt_smjd = 100 + shard;
+			hdr->stt_offs = 0.25 * (shard + 1);
+			hdr->blocsize = blockPackets * packetLength;
+			if (shard == 1) {
+				expectedData.insert(expectedData.end(), gap * packetLength, 0);
+			}
+			for (int32_t block = 0; block < 2; block++) {
+				hdr->pktidx = block * blockPackets;
+				hdr->dropblk = (shard == 0 && block == 1) ? 0.5 : 0.0;
+				const int64_t headerLength = _lofar_udp_metadata_write_GUPPI(hdr, headerBuffer.data(), DEF_HDR_LEN);
+				ASSERT_LT(0, headerLength);
+				std::vector<int8_t> data = shard_test_data(blockPackets * packetLength, (int8_t) (shard * 64 + block * 16));
+				partFile.insert(partFile.end(), headerBuffer.begin(), headerBuffer.begin() + headerLength);
+				partFile.insert(partFile.end(), data.begin(), data.end());
+				expectedData.insert(expectedData.end(), data.begin(), data.end());
+			}
+			shard_test_write_file(shards[shard].outputLocations[0], {}, partFile);
+		}
+		free(hdr);
+
+		EXPECT_EQ(gap * 2, shard_test_stitch(shards, 2, "./shard_test_stitched"));
+		const std::vector<int8_t> stitched = shard_test_read_file("./shard_test_stitched");
+
+		// The gap is written as a fully dropped block between the shards
+		const int32_t numBlocks = gap > 0 ? 5 : 4;
+		int64_t offset = 0;
+		double droppedBlocks = 0.0;
+		std::vector<int8_t> stitchedData;
+		for (int32_t block = 0; block < numBlocks; block++) {
+			SCOPED_TRACE("Block " + std::to_string(block));
+			ASSERT_LT(offset, (int64_t) stitched.size());
+			const int8_t *header = &(stitched[offset]);
+			const int8_t gapBlock = gap > 0 && block == 2;
+			EXPECT_EQ(block * blockPackets, (int64_t) shard_test_guppi_value(header, "PKTIDX"));
+			EXPECT_EQ(blockPackets * packetLength, (int64_t) shard_test_guppi_value(header, "BLOCSIZE"));
+			EXPECT_EQ(60000, (int32_t) shard_test_guppi_value(header, "STT_IMJD"));
+			EXPECT_EQ(100, (int32_t) shard_test_guppi_value(header, "STT_SMJD"));
+			EXPECT_DOUBLE_EQ(0.25, shard_test_guppi_value(header, "STT_OFFS"));
+			// Half of the second block was dropped
+			droppedBlocks += block == 1 ? 0.5 : gapBlock;
+			EXPECT_DOUBLE_EQ(gapBlock ? 1.0 : (block == 1 ? 0.5 : 0.0), shard_test_guppi_value(header, "DROPBLK"));
+			EXPECT_NEAR(droppedBlocks / (block + 1), shard_test_guppi_value(header, "DROPTOT"), 1e-6);
+
+			offset += shard_test_guppi_length(header);
+			stitchedData.insert(stitchedData.end(), stitched.begin() + offset, stitched.begin() + offset + blockPackets * packetLength);
+			offset += blockPackets * packetLength;
+		}
+		EXPECT_EQ((int64_t) stitched.size(), offset);
+		EXPECT_TRUE(expectedData == stitchedData);
+		std::remove("./shard_test_stitched");
+		for (auto &shard : shards) {
+			std::remove(shard.outputLocations[0]);
+			lofar_udp_shard_free_outputs(&shard);
+		}
+	}
+
+	{
+		SCOPED_TRACE("SIGPROC");
+		// 32-bit, 4 channel samples, 16 samples per packet
+		const int64_t packetLength = 16 * 4 * sizeof(float);
+		lofar_udp_shard shards[2] = { shard_test_synthetic(0, 2, SIGPROC, 1000, 2, packetLength),
+		                              shard_test_synthetic(1, 2, SIGPROC, 1002, 3, packetLength) };
+		sigproc_hdr *hdr = sigproc_hdr_alloc(0);
+		ASSERT_NE(nullptr, hdr);
+		hdr->nbits = 32;
+		hdr->nchans = 4;
+		hdr->nifs = 1;
+		std::vector<int8_t> headerBuffer(DEF_HDR_LEN);
+		std::vector<int8_t> expectedData;
+
+		for (int32_t shard = 0; shard < 2; shard++) {
+			hdr->tstart = 60000.5 + shard;
+			const int64_t headerLength = _lofar_udp_metadata_write_SIGPROC(hdr, headerBuffer.data(), DEF_HDR_LEN);
+			ASSERT_LT(0, headerLength);
+			std::vector<int8_t> data = shard_test_data(shards[shard].outputBytes[0], (int8_t) (shard * 32));
+			shard_test_write_file(shards[shard].outputLocations[0], std::vector<int8_t>(headerBuffer.begin(), headerBuffer.begin() + headerLength), data);
+			expectedData.insert(expectedData.end(), data.begin(), data.end());
+		}
+		sigproc_hdr_cleanup(hdr);
+
+		EXPECT_EQ(0, shard_test_stitch(shards, 2, "./shard_test_stitched"));
+		const std::vector<int8_t> stitched = shard_test_read_file("./shard_test_stitched");
+		ASSERT_LT(expectedData.size(), stitched.size());
+		const std::string header((const char *) stitched.data(), stitched.size() - expectedData.size());
+
+		const size_t nsamplesOffset = header.find("nsamples");
+		ASSERT_NE(std::string::npos, nsamplesOffset);
+		int32_t nsamples;
+		memcpy(&nsamples, &(header[nsamplesOffset + strlen("nsamples")]), sizeof(int32_t));
+		EXPECT_EQ(5 * 16, nsamples);
+
+		const size_t tstartOffset = header.find("tstart");
+		ASSERT_NE(std::string::npos, tstartOffset);
+		double tstart;
+		memcpy(&tstart, &(header[tstartOffset + strlen("tstart")]), sizeof(double));
+		EXPECT_DOUBLE_EQ(60000.5, tstart);
+		EXPECT_EQ(header.size() - strlen("HEADER_END"), header.find("HEADER_END"));
+
+		EXPECT_TRUE(std::equal(expectedData.begin(), expectedData.end(), stitched.begin() + (int64_t) header.size()));
+		std::remove("./shard_test_stitched");
+		for (auto &shard : shards) {
+			std::remove(shard.outputLocations[0]);
+			lofar_udp_shard_free_outputs(&shard);
+		}
+	}
+
+	{
+		SCOPED_TRACE("DADA");
+		const int64_t packetLength = 32;
+		// Packets 1004 and 1005 were not written by either shard
+		lofar_udp_shard shards[2] = { shard_test_synthetic(0, 2, DADA, 1000, 4, packetLength),
+		                              shard_test_synthetic(1, 2, DADA, 1006, 4, packetLength) };
+		shards[0].droppedPackets = 1;
+		shards[1].droppedPackets = 2;
+
+		std::vector<int8_t> expectedData;
+		for (int32_t shard = 0; shard < 2; shard++) {
+			const std::string header = "HDR_VERSION 1.0\nUPM_PROCPKT 8\nUPM_DRPPKT " + std::to_string(shards[shard].droppedPackets) + "\nHDR_SIZE 48\n";
+			std::vector<int8_t> data = shard_test_data(shards[shard].outputBytes[0], (int8_t) (shard * 32));
+			// The missing packets are zero-padded between the shards
+			if (shard == 1) {
+				expectedData.insert(expectedData.end(), 2 * packetLength, 0);
+			}
+			shard_test_write_file(shards[shard].outputLocations[0], std::vector<int8_t>(header.begin(), header.end()), data);
+			expectedData.insert(expectedData.end(), data.begin(), data.end());
+		}
+
+		EXPECT_EQ(1 + 2 * 2 + 2, shard_test_stitch(shards, 2, "./shard_test_stitched"));
+		const std::vector<int8_t> stitched = shard_test_read_file("./shard_test_stitched");
+		ASSERT_LT(expectedData.size(), stitched.size());
+		const std::string header((const char *) stitched.data(), stitched.size() - expectedData.size());
+		EXPECT_NE(std::string::npos, header.find("UPM_PROCPKT 20\n"));
+		EXPECT_NE(std::string::npos, header.find("UPM_DRPPKT 7\n"));
+		EXPECT_TRUE(std::equal(expectedData.begin(), expectedData.end(), stitched.begin() + (int64_t) header.size()));
+		std::remove("./shard_test_stitched");
+
+		// Or replay the last packet of the previous shard
+		shards[0].replayDroppedPackets = shards[1].replayDroppedPackets = 1;
+		std::copy(expectedData.begin() + 3 * packetLength, expectedData.begin() + 4 * packetLength, expectedData.begin() + 4 * packetLength);
+		std::copy(expectedData.begin() + 3 * packetLength, expectedData.begin() + 4 * packetLength, expectedData.begin() + 5 * packetLength);
+		EXPECT_EQ(1 + 2 * 2 + 2, shard_test_stitch(shards, 2, "./shard_test_stitched"));
+		EXPECT_TRUE(std::equal(expectedData.begin(), expectedData.end(), shard_test_read_file("./shard_test_stitched").begin() + (int64_t) header.size()));
+		shards[0].replayDroppedPackets = shards[1].replayDroppedPackets = 0;
+		std::remove("./shard_test_stitched");
+
+		// Invalid shard sets, the copies share their per-output arrays with the originals
+		lofar_udp_shard shardCopies[2] = { shards[0], shards[1] };
+		EXPECT_EQ(-1, shard_test_stitch(nullptr, 2, "./shard_test_stitched"));
+		EXPECT_EQ(-2, shard_test_stitch(shardCopies, 1, "./shard_test_stitched"));
+
+		shardCopies[1].firstPacket = 1003;
+		EXPECT_EQ(-4, shard_test_stitch(shardCopies, 2, "./shard_test_stitched"));
+		shardCopies[1] = shards[1];
+
+		shardCopies[1].numPorts = 4;
+		EXPECT_EQ(-2, shard_test_stitch(shardCopies, 2, "./shard_test_stitched"));
+		shardCopies[1] = shards[1];
+
+		shardCopies[1].replayDroppedPackets = 1;
+		EXPECT_EQ(-2, shard_test_stitch(shardCopies, 2, "./shard_test_stitched"));
+		shardCopies[1] = shards[1];
+
+		shardCopies[1].shard = 0;
+		EXPECT_EQ(-2, shard_test_stitch(shardCopies, 2, "./shard_test_stitched"));
+		shardCopies[1] = shards[1];
+
+		shardCopies[0].metadataType = shardCopies[1].metadataType = HDF5_META;
+		EXPECT_EQ(-3, shard_test_stitch(shardCopies, 2, "./shard_test_stitched"));
+		shardCopies[0] = shards[0];
+		shardCopies[1] = shards[1];
+
+		// Part files that do not match their manifest
+		shardCopies[1].outputBytes[0] += 4096;
+		EXPECT_EQ(-6, shard_test_stitch(shardCopies, 2, "./shard_test_stitched"));
+
+		std::remove("./shard_test_stitched");
+		for (auto &shard : shards) {
+			std::remove(shard.outputLocations[0]);
+			lofar_udp_shard_free_outputs(&shard);
+		}
+	}
+}
+
+/**
+ * Copyright (C) 2023 David McKenna
+ * This file is part of udpPacketManager <https://github.com/David-McKenna/udpPacketManager>.
+ *
+ * udpPacketManager is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * udpPacketManager is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with udpPacketManager.  If not, see <http://www.gnu.org/licenses/>.
+ **/